@@ -106,6 +106,13 @@ namespace SteerLib
 		void getItemsInRange(std::set<SpatialDatabaseItemPtr> & neighborList, float xmin, float xmax, float zmin, float zmax, SpatialDatabaseItemPtr exclude);
 		/// Returns an STL set of objects found in the specified range of GridCells.
 		void getItemsInRange(std::set<SpatialDatabaseItemPtr> & neighborList, unsigned int xMinIndex, unsigned int xMaxIndex, unsigned int zMinIndex, unsigned int zMaxIndex, SpatialDatabaseItemPtr exclude) {}
+		/// Clears neighborList and fills it with the objects found in the specified spatial range, sorted by address and without duplicates.
+		void getItemsInRange(std::vector<SpatialDatabaseItemPtr> & neighborList, float xmin, float xmax, float zmin, float zmax, SpatialDatabaseItemPtr exclude)
+		{
+			std::set<SpatialDatabaseItemPtr> neighbors;
+			getItemsInRange(neighbors, xmin, xmax, zmin, zmax, exclude);
+			neighborList.assign(neighbors.begin(), neighbors.end());
+		}
 		/**
 		 * \brief   Computes the agent neighbors of the specified agent.
 		 * \param   agent    A pointer to the agent for which agent neighbors are to be computed.
@@ -400,14 +400,14 @@ KdTree::ObstacleInterfaceTreeNode *KdTree::buildObstacleTreeRecursive(const std:
 
 void KdTree::computeAgentNeighbors(SpatialDatabaseItemPtr agent, float rangeSq) const
 {
-	queryAgentTreeRecursive(dynamic_cast<AgentInterface*>(agent), rangeSq, 0);
+	queryAgentTreeRecursive(asAgent(agent), rangeSq, 0);
 }
 
 void KdTree::computeObstacleNeighbors(SpatialDatabaseItemPtr agent, float rangeSq) const
 {
-	dynamic_cast<AgentInterface*>(agent)->obstacleNeighbors_.clear();
+	asAgent(agent)->obstacleNeighbors_.clear();
 	// std::cout << " computing agent neighbours " << std::endl;
-	queryObstacleTreeRecursive(dynamic_cast<AgentInterface*>(agent), rangeSq, obstacleTree_);
+	queryObstacleTreeRecursive(asAgent(agent), rangeSq, obstacleTree_);
 	// std::cout << "found " << dynamic_cast<AgentInterface*>(agent)->obstacleNeighbors_.size() <<
 		// 	" obstacle neighbours" << std::endl;
 }
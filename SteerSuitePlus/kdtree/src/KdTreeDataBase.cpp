@@ -52,13 +52,13 @@ void KdTreeDataBase::getItemsInRange(std::set<SpatialDatabaseItemPtr> & neighbor
 {
 	neighborList.clear();
 	// std::cout << "kdtree update agent neighbours" <<  " pointer " << this << std::endl;
-	AgentInterface * agent = dynamic_cast<AgentInterface*>(exclude);
+	AgentInterface * agent = asAgent(exclude);
 	if ( agent == NULL )
 	{
 		std::cout << "agent pointer is null for get neighbours" << std::endl;
 	}
 	// std::cout << "agent id:" << agent->id() << std::endl;
-	this->_spatialDatabase->computeAgentNeighbors(dynamic_cast<AgentInterface*>(exclude), 10.0f );
+	this->_spatialDatabase->computeAgentNeighbors(agent, 10.0f );
 	for (size_t a=0; a < agent->agentNeighbors_.size(); a++)
 	{
 		if (const_cast<AgentInterface*>(agent->agentNeighbors_.at(a).second)->enabled())
@@ -68,7 +68,7 @@ void KdTreeDataBase::getItemsInRange(std::set<SpatialDatabaseItemPtr> & neighbor
 		// agent->agentNeighbors_.at(a).second;
 	}
 
-	this->_spatialDatabase->computeObstacleNeighbors(dynamic_cast<AgentInterface*>(exclude), 10.0f );
+	this->_spatialDatabase->computeObstacleNeighbors(agent, 10.0f );
 	for (size_t a=0; a < agent->obstacleNeighbors_.size(); a++)
 	{
 		neighborList.insert(const_cast<ObstacleInterface*>(agent->obstacleNeighbors_.at(a).second));
@@ -137,8 +137,7 @@ Util::Point KdTreeDataBase::randomPositionWithoutCollisions(float radius, bool e
 		// std::set<SteerLib::SpatialDatabaseItemPtr> _neighbors;
 		for (std::set<SteerLib::ObstacleInterface*>::iterator neighbor = this->_engine->getObstacles().begin();  neighbor != this->_engine->getObstacles().end();  neighbor++)
 		{
-			SteerLib::ObstacleInterface * obstacle;
-			obstacle = dynamic_cast<SteerLib::ObstacleInterface *>(*neighbor);
+			SteerLib::ObstacleInterface * obstacle = *neighbor;
 			if(obstacle->overlaps(Util::Point(rx,0,rz), radius) == true)
 			{
 				found_hit = true;
@@ -209,8 +208,7 @@ Util::Point KdTreeDataBase::randomPositionInRegionWithoutCollisions(const Util::
 		// std::set<SteerLib::SpatialDatabaseItemPtr> _neighbors;
 		for (std::set<SteerLib::ObstacleInterface*>::iterator neighbor = this->_engine->getObstacles().begin();  neighbor != this->_engine->getObstacles().end();  neighbor++)
 		{
-			SteerLib::ObstacleInterface * obstacle;
-			obstacle = dynamic_cast<SteerLib::ObstacleInterface *>(*neighbor);
+			SteerLib::ObstacleInterface * obstacle = *neighbor;
 			if(obstacle->overlaps(Util::Point(rx,0,rz), radius) == true)
 			{
 				found_hit = true;
@@ -281,7 +279,7 @@ void KdTreeDataBase::addObject( SpatialDatabaseItemPtr item, const Util::AxisAli
 {
 	if ( item->isAgent())
 	{
-		this->_spatialDatabase->agents_.push_back(dynamic_cast<AgentInterface *>(item));
+		this->_spatialDatabase->agents_.push_back(asAgent(item));
 	}
 	else
 	{
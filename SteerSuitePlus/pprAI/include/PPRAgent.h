@@ -15,7 +15,7 @@
 
 // #define USE_ANNOTATIONS
 
-#define AGENT_PTR(agent) (dynamic_cast<AgentInterface*>(agent))
+#define AGENT_PTR(agent) (SteerLib::asAgent(agent))
 
 
 //======================================================================================
@@ -23,6 +23,7 @@
 //======================================================================================
 
 class PPRAgent;
+class PPRAIModule;
 
 namespace PPRGlobals {
 	// NOTE this is forward declared for an inline function defined below
@@ -168,6 +169,8 @@ protected:
 	bool threatListContainsAgent(SteerLib::AgentInterface * agent, unsigned int &index);
 	inline bool threatListContainsAgent(SteerLib::AgentInterface * agent) { unsigned int dummy; return threatListContainsAgent(agent, dummy); }
 	void disable();
+	void saveState(SteerLib::CheckpointWriter & out);
+	void restoreState(SteerLib::CheckpointReader & in);
 	void drawPlannedPath();
 
 	virtual SteerLib::EngineInterface * getSimulationEngine();
@@ -229,6 +232,9 @@ protected:
 	unsigned int _framesToNextPredictivePhase;
 	unsigned int _framesToNextReactivePhase;
 
+	// this agent's client in the module's phase scheduler, or -1 if it is not registered.
+	int _phaseSchedulerClient;
+
 
 	// GEOMETRY STATE of the agent (can potentially change per frame)
 	Util::Vector _rightSide;
@@ -250,6 +256,8 @@ protected:
 	SteerLib::AgentGoalInfo _currentGoal;
 
 	SteerLib::EngineInterface * _gEngine;
+	/// The module that created this agent; its phase intervals and profilers are shared by all of its agents.
+	PPRAIModule * _aiModule;
 
 	// Adding a bunch of
 
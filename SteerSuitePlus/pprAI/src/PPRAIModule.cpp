@@ -28,72 +28,21 @@ using namespace SteerLib;
 #include "LogObject.h"
 #include "LogManager.h"
 
-// todo: make these static?
-namespace PPRGlobals {
-	// SteerLib::EngineInterface * gEngine;
-	// SteerLib::SpatialDataBaseInterface * gSpatialDatabase;
-	unsigned int gLongTermPlanningPhaseInterval;
-	unsigned int gMidTermPlanningPhaseInterval;
-	unsigned int gShortTermPlanningPhaseInterval;
-	unsigned int gPredictivePhaseInterval;
-	unsigned int gReactivePhaseInterval;
-	unsigned int gPerceptivePhaseInterval;
-
-	bool gUseDynamicPhaseScheduling;
-	bool gShowStats;
-	bool logStats;
-	bool gShowAllStats;
-	bool dont_plan;
-	
-	// Adding a bunch of parameters so they can be changed via input
-	float ped_max_speed;
-	float ped_typical_speed ;
-	float ped_max_force  ;
-	float ped_max_speed_factor  ;
-	float ped_faster_speed_factor ;
-	float ped_slightly_faster_speed_factor;
-	float ped_typical_speed_factor   ;
-	float ped_slightly_slower_speed_factor;
-	float ped_slower_speed_factor;
-	float ped_cornering_turn_rate;
-	float ped_adjustment_turn_rate;
-	float ped_faster_avoidance_turn_rate;
-	float ped_typical_avoidance_turn_rate;
-	float ped_braking_rate ;
-	float ped_comfort_zone   ;
-	float ped_query_radius  ;
-	float ped_similar_direction_dot_product_threshold;
-	float ped_same_direction_dot_product_threshold;
-	float ped_oncoming_prediction_threshold;
-	float ped_oncoming_reaction_threshold;
-	float ped_wrong_direction_dot_product_threshold;
-	float ped_threat_distance_threshold;
-	float ped_threat_min_time_threshold;
-	float ped_threat_max_time_threshold;
-	float ped_predictive_anticipation_factor ;
-	float ped_reactive_anticipation_factor;
-	float ped_crowd_influence_factor;
-	float ped_facing_static_object_threshold;
-	float ped_ordinary_steering_strength;
-	float ped_oncoming_threat_avoidance_strength;
-	float ped_cross_threat_avoidance_strength;
-	float ped_max_turning_rate;
-	int ped_feeling_crowded_threshold;
-	float ped_scoot_rate ;
-	float ped_reached_target_distance_threshold ;
-	float ped_dynamic_collision_padding;
-	int ped_furthest_local_target_distance;
-	int ped_next_waypoint_distance;
-	int ped_max_num_waypoints;
-
-	PhaseProfilers * gPhaseProfilers;
-}
-
 using namespace PPRGlobals;
 
 //
 // 
 //
+PPRAIModule::PPRAIModule()
+{
+	_pprLogger = NULL;
+}
+
+PPRAIModule::~PPRAIModule()
+{
+	LogManager::getInstance()->destroyLogger(_pprLogger);
+}
+
 void PPRAIModule::init( const SteerLib::OptionDictionary & options, SteerLib::EngineInterface * engineInfo )
 {
 	// gSpatialDatabase = engineInfo->getSpatialDatabase();
@@ -101,247 +50,252 @@ void PPRAIModule::init( const SteerLib::OptionDictionary & options, SteerLib::En
 	_gEngine = engineInfo;
 
 
-	gLongTermPlanningPhaseInterval = LONG_TERM_PLANNING_INTERVAL;
-	gMidTermPlanningPhaseInterval = MID_TERM_PLANNING_INTERVAL;
-	gShortTermPlanningPhaseInterval = SHORT_TERM_PLANNING_INTERVAL;
-	gPerceptivePhaseInterval = PERCEPTIVE_PHASE_INTERVAL;
-	gPredictivePhaseInterval = PREDICTIVE_PHASE_INTERVAL;
-	gReactivePhaseInterval = REACTIVE_PHASE_INTERVAL;
-	gUseDynamicPhaseScheduling = false;
-	gShowStats = false;
+	_gLongTermPlanningPhaseInterval = LONG_TERM_PLANNING_INTERVAL;
+	_gMidTermPlanningPhaseInterval = MID_TERM_PLANNING_INTERVAL;
+	_gShortTermPlanningPhaseInterval = SHORT_TERM_PLANNING_INTERVAL;
+	_gPerceptivePhaseInterval = PERCEPTIVE_PHASE_INTERVAL;
+	_gPredictivePhaseInterval = PREDICTIVE_PHASE_INTERVAL;
+	_gReactivePhaseInterval = REACTIVE_PHASE_INTERVAL;
+	_gUseDynamicPhaseScheduling = false;
+	_gStaggerPhases = false;
+	_gShowStats = false;
 	logStats = false;
-	gShowAllStats = false;
+	_gShowAllStats = false;
 	logFilename = "pprAI.log";
-	dont_plan = false;
-
-
-	ped_max_speed = PED_MAX_SPEED;
-	ped_typical_speed  = PED_TYPICAL_SPEED ;
-	ped_max_force   = PED_MAX_FORCE  ;
-	ped_max_speed_factor   = PED_MAX_SPEED_FACTOR  ;
-	ped_faster_speed_factor  = PED_FASTER_SPEED_FACTOR ;
-	ped_slightly_faster_speed_factor = PED_SLIGHTLY_FASTER_SPEED_FACTOR;
-	ped_typical_speed_factor    = PED_TYPICAL_SPEED_FACTOR   ;
-	ped_slightly_slower_speed_factor = PED_SLIGHTLY_SLOWER_SPEED_FACTOR;
-	ped_slower_speed_factor = PED_SLOWER_SPEED_FACTOR;
-	ped_cornering_turn_rate = PED_CORNERING_TURN_RATE;
-	ped_adjustment_turn_rate = PED_ADJUSTMENT_TURN_RATE;
-	ped_faster_avoidance_turn_rate = PED_FASTER_AVOIDANCE_TURN_RATE;
-	ped_typical_avoidance_turn_rate = PED_TYPICAL_AVOIDANCE_TURN_RATE;
-	ped_braking_rate  = PED_BRAKING_RATE ;
-	ped_comfort_zone    = PED_COMFORT_ZONE   ;
-	ped_query_radius   = PED_QUERY_RADIUS  ;
-	ped_similar_direction_dot_product_threshold = PED_SIMILAR_DIRECTION_DOT_PRODUCT_THRESHOLD;
-	ped_same_direction_dot_product_threshold = PED_SAME_DIRECTION_DOT_PRODUCT_THRESHOLD;
-	ped_oncoming_prediction_threshold = PED_ONCOMING_PREDICTION_THRESHOLD;
-	ped_oncoming_reaction_threshold = PED_ONCOMING_REACTION_THRESHOLD;
-	ped_wrong_direction_dot_product_threshold = PED_WRONG_DIRECTION_DOT_PRODUCT_THRESHOLD;
-	ped_threat_distance_threshold = PED_THREAT_DISTANCE_THRESHOLD;
-	ped_threat_min_time_threshold = PED_THREAT_MIN_TIME_THRESHOLD;
-	ped_threat_max_time_threshold = PED_THREAT_MAX_TIME_THRESHOLD;
-	ped_predictive_anticipation_factor  = PED_PREDICTIVE_ANTICIPATION_FACTOR ;
-	ped_reactive_anticipation_factor = PED_REACTIVE_ANTICIPATION_FACTOR;
-	ped_crowd_influence_factor = PED_CROWD_INFLUENCE_FACTOR;
-	ped_facing_static_object_threshold = PED_FACING_STATIC_OBJECT_THRESHOLD;
-	ped_ordinary_steering_strength = PED_ORDINARY_STEERING_STRENGTH;
-	ped_oncoming_threat_avoidance_strength = PED_ONCOMING_THREAT_AVOIDANCE_STRENGTH;
-	ped_cross_threat_avoidance_strength = PED_CROSS_THREAT_AVOIDANCE_STRENGTH;
-	ped_max_turning_rate = PED_MAX_TURNING_RATE;
-	ped_feeling_crowded_threshold = PED_FEELING_CROWDED_THRESHOLD;
-	ped_scoot_rate  = PED_SCOOT_RATE ;
-	ped_reached_target_distance_threshold  = PED_REACHED_TARGET_DISTANCE_THRESHOLD ;
-	ped_dynamic_collision_padding = PED_DYNAMIC_COLLISION_PADDING;
-	ped_furthest_local_target_distance = PED_FURTHEST_LOCAL_TARGET_DISTANCE;
-	ped_next_waypoint_distance = PED_NEXT_WAYPOINT_DISTANCE;
-	ped_max_num_waypoints = PED_MAX_NUM_WAYPOINTS;
+	_dontPlan = false;
+
+
+	_PPRParams.ped_max_speed = PED_MAX_SPEED;
+	_PPRParams.ped_typical_speed  = PED_TYPICAL_SPEED ;
+	_PPRParams.ped_max_force   = PED_MAX_FORCE  ;
+	_PPRParams.ped_max_speed_factor   = PED_MAX_SPEED_FACTOR  ;
+	_PPRParams.ped_faster_speed_factor  = PED_FASTER_SPEED_FACTOR ;
+	_PPRParams.ped_slightly_faster_speed_factor = PED_SLIGHTLY_FASTER_SPEED_FACTOR;
+	_PPRParams.ped_typical_speed_factor    = PED_TYPICAL_SPEED_FACTOR   ;
+	_PPRParams.ped_slightly_slower_speed_factor = PED_SLIGHTLY_SLOWER_SPEED_FACTOR;
+	_PPRParams.ped_slower_speed_factor = PED_SLOWER_SPEED_FACTOR;
+	_PPRParams.ped_cornering_turn_rate = PED_CORNERING_TURN_RATE;
+	_PPRParams.ped_adjustment_turn_rate = PED_ADJUSTMENT_TURN_RATE;
+	_PPRParams.ped_faster_avoidance_turn_rate = PED_FASTER_AVOIDANCE_TURN_RATE;
+	_PPRParams.ped_typical_avoidance_turn_rate = PED_TYPICAL_AVOIDANCE_TURN_RATE;
+	_PPRParams.ped_braking_rate  = PED_BRAKING_RATE ;
+	_PPRParams.ped_comfort_zone    = PED_COMFORT_ZONE   ;
+	_PPRParams.ped_query_radius   = PED_QUERY_RADIUS  ;
+	_PPRParams.ped_similar_direction_dot_product_threshold = PED_SIMILAR_DIRECTION_DOT_PRODUCT_THRESHOLD;
+	_PPRParams.ped_same_direction_dot_product_threshold = PED_SAME_DIRECTION_DOT_PRODUCT_THRESHOLD;
+	_PPRParams.ped_oncoming_prediction_threshold = PED_ONCOMING_PREDICTION_THRESHOLD;
+	_PPRParams.ped_oncoming_reaction_threshold = PED_ONCOMING_REACTION_THRESHOLD;
+	_PPRParams.ped_wrong_direction_dot_product_threshold = PED_WRONG_DIRECTION_DOT_PRODUCT_THRESHOLD;
+	_PPRParams.ped_threat_distance_threshold = PED_THREAT_DISTANCE_THRESHOLD;
+	_PPRParams.ped_threat_min_time_threshold = PED_THREAT_MIN_TIME_THRESHOLD;
+	_PPRParams.ped_threat_max_time_threshold = PED_THREAT_MAX_TIME_THRESHOLD;
+	_PPRParams.ped_predictive_anticipation_factor  = PED_PREDICTIVE_ANTICIPATION_FACTOR ;
+	_PPRParams.ped_reactive_anticipation_factor = PED_REACTIVE_ANTICIPATION_FACTOR;
+	_PPRParams.ped_crowd_influence_factor = PED_CROWD_INFLUENCE_FACTOR;
+	_PPRParams.ped_facing_static_object_threshold = PED_FACING_STATIC_OBJECT_THRESHOLD;
+	_PPRParams.ped_ordinary_steering_strength = PED_ORDINARY_STEERING_STRENGTH;
+	_PPRParams.ped_oncoming_threat_avoidance_strength = PED_ONCOMING_THREAT_AVOIDANCE_STRENGTH;
+	_PPRParams.ped_cross_threat_avoidance_strength = PED_CROSS_THREAT_AVOIDANCE_STRENGTH;
+	_PPRParams.ped_max_turning_rate = PED_MAX_TURNING_RATE;
+	_PPRParams.ped_feeling_crowded_threshold = PED_FEELING_CROWDED_THRESHOLD;
+	_PPRParams.ped_scoot_rate  = PED_SCOOT_RATE ;
+	_PPRParams.ped_reached_target_distance_threshold  = PED_REACHED_TARGET_DISTANCE_THRESHOLD ;
+	_PPRParams.ped_dynamic_collision_padding = PED_DYNAMIC_COLLISION_PADDING;
+	_PPRParams.ped_furthest_local_target_distance = PED_FURTHEST_LOCAL_TARGET_DISTANCE;
+	_PPRParams.ped_next_waypoint_distance = PED_NEXT_WAYPOINT_DISTANCE;
+	_PPRParams.ped_max_num_waypoints = PED_MAX_NUM_WAYPOINTS;
 
 	SteerLib::OptionDictionary::const_iterator optionIter;
 	for (optionIter = options.begin(); optionIter != options.end(); ++optionIter) {
 		std::stringstream value((*optionIter).second);
 		if ((*optionIter).first == "longplan") {
-			value >> gLongTermPlanningPhaseInterval;
+			value >> _gLongTermPlanningPhaseInterval;
 		}
 		else if ((*optionIter).first == "midplan")
 		{
-			value >> gMidTermPlanningPhaseInterval;
+			value >> _gMidTermPlanningPhaseInterval;
 		}
 		else if ((*optionIter).first == "shortplan")
 		{
-			value >> gShortTermPlanningPhaseInterval;
+			value >> _gShortTermPlanningPhaseInterval;
 		}
 		else if ((*optionIter).first == "perceptive")
 		{
-			value >> gPerceptivePhaseInterval;
+			value >> _gPerceptivePhaseInterval;
 		}
 		else if ((*optionIter).first == "predictive")
 		{
-			value >> gPredictivePhaseInterval;
+			value >> _gPredictivePhaseInterval;
 		}
 		else if ((*optionIter).first == "reactive")
 		{
-			value >> gReactivePhaseInterval;
+			value >> _gReactivePhaseInterval;
 		}
 		else if ((*optionIter).first == "dynamic")
 		{
-			gUseDynamicPhaseScheduling = Util::getBoolFromString(value.str());
+			_gUseDynamicPhaseScheduling = Util::getBoolFromString(value.str());
+		}
+		else if ((*optionIter).first == "stagger")
+		{
+			_gStaggerPhases = Util::getBoolFromString(value.str());
 		}
 		else if ((*optionIter).first == "ped_max_speed")
 		{
-			value >> ped_max_speed;
+			value >> _PPRParams.ped_max_speed;
 		}
 		else if ((*optionIter).first == "ped_typical_speed")
 		{
-			value >> ped_typical_speed;
+			value >> _PPRParams.ped_typical_speed;
 		}
 		else if ((*optionIter).first == "ped_max_force")
 		{
 			std::cout << "Setting max_force to: " << value.str();
-			value >> ped_max_force;
+			value >> _PPRParams.ped_max_force;
 		}
 
 		else if ((*optionIter).first == "ped_max_speed_factor")
 		{
-			value >> ped_max_speed_factor;
+			value >> _PPRParams.ped_max_speed_factor;
 		}
 		else if ((*optionIter).first == "ped_faster_speed_factor")
 		{
-			value >> ped_faster_speed_factor;
+			value >> _PPRParams.ped_faster_speed_factor;
 		}
 		else if ((*optionIter).first == "ped_slightly_faster_speed_factor")
 		{
-			value >> ped_slightly_faster_speed_factor;
+			value >> _PPRParams.ped_slightly_faster_speed_factor;
 		}
 		else if ((*optionIter).first == "ped_typical_speed_factor")
 		{
-			value >> ped_typical_speed_factor;
+			value >> _PPRParams.ped_typical_speed_factor;
 		}
 		else if ((*optionIter).first == "ped_slightly_slower_speed_factor")
 		{
-			value >> ped_slightly_slower_speed_factor;
+			value >> _PPRParams.ped_slightly_slower_speed_factor;
 		}
 		else if ((*optionIter).first == "ped_slower_speed_factor")
 		{
-			value >> ped_slower_speed_factor;
+			value >> _PPRParams.ped_slower_speed_factor;
 		}
 		else if ((*optionIter).first == "ped_cornering_turn_rate")
 		{
-			value >> ped_cornering_turn_rate;
+			value >> _PPRParams.ped_cornering_turn_rate;
 		}
 		else if ((*optionIter).first == "ped_adjustment_turn_rate")
 		{
-			value >> ped_adjustment_turn_rate;
+			value >> _PPRParams.ped_adjustment_turn_rate;
 		}
 		else if ((*optionIter).first == "ped_faster_avoidance_turn_rate")
 		{
-			value >> ped_faster_avoidance_turn_rate;
+			value >> _PPRParams.ped_faster_avoidance_turn_rate;
 		}
 		else if ((*optionIter).first == "ped_typical_avoidance_turn_rate")
 		{
-			value >> ped_typical_avoidance_turn_rate;
+			value >> _PPRParams.ped_typical_avoidance_turn_rate;
 		}
 		else if ((*optionIter).first == "ped_braking_rate")
 		{
-			value >> ped_braking_rate;
+			value >> _PPRParams.ped_braking_rate;
 		}
 		else if ((*optionIter).first == "ped_comfort_zone")
 		{
-			value >> ped_comfort_zone;
+			value >> _PPRParams.ped_comfort_zone;
 		}
 		else if ((*optionIter).first == "ped_query_radius")
 		{
-			value >> ped_query_radius;
+			value >> _PPRParams.ped_query_radius;
 		}
 		else if ((*optionIter).first == "ped_similar_direction_dot_product_threshold")
 		{
-			value >> ped_similar_direction_dot_product_threshold;
+			value >> _PPRParams.ped_similar_direction_dot_product_threshold;
 		}
 		else if ((*optionIter).first == "ped_same_direction_dot_product_threshold")
 		{
-			value >> ped_same_direction_dot_product_threshold;
+			value >> _PPRParams.ped_same_direction_dot_product_threshold;
 		}
 		else if ((*optionIter).first == "ped_oncoming_prediction_threshold")
 		{
-			value >> ped_oncoming_prediction_threshold;
+			value >> _PPRParams.ped_oncoming_prediction_threshold;
 		}
 		else if ((*optionIter).first == "ped_oncoming_reaction_threshold")
 		{
-			value >> ped_oncoming_reaction_threshold;
+			value >> _PPRParams.ped_oncoming_reaction_threshold;
 		}
 		else if ((*optionIter).first == "ped_wrong_direction_dot_product_threshold")
 		{
-			value >> ped_wrong_direction_dot_product_threshold;
+			value >> _PPRParams.ped_wrong_direction_dot_product_threshold;
 		}
 		else if ((*optionIter).first == "ped_threat_distance_threshold")
 		{
-			value >> ped_threat_distance_threshold;
+			value >> _PPRParams.ped_threat_distance_threshold;
 		}
 		else if ((*optionIter).first == "ped_threat_min_time_threshold")
 		{
-			value >> ped_threat_min_time_threshold;
+			value >> _PPRParams.ped_threat_min_time_threshold;
 		}
 		else if ((*optionIter).first == "ped_threat_max_time_threshold")
 		{
-			value >> ped_threat_max_time_threshold;
+			value >> _PPRParams.ped_threat_max_time_threshold;
 		}
 		else if ((*optionIter).first == "ped_predictive_anticipation_factor")
 		{
-			value >> ped_predictive_anticipation_factor;
+			value >> _PPRParams.ped_predictive_anticipation_factor;
 		}
 		else if ((*optionIter).first == "ped_reactive_anticipation_factor")
 		{
-			value >> ped_reactive_anticipation_factor;
+			value >> _PPRParams.ped_reactive_anticipation_factor;
 		}
 		else if ((*optionIter).first == "ped_crowd_influence_factor")
 		{
-			value >> ped_crowd_influence_factor;
+			value >> _PPRParams.ped_crowd_influence_factor;
 		}
 		else if ((*optionIter).first == "ped_facing_static_object_threshold")
 		{
-			value >> ped_facing_static_object_threshold;
+			value >> _PPRParams.ped_facing_static_object_threshold;
 		}
 		else if ((*optionIter).first == "ped_ordinary_steering_strength")
 		{
-			value >> ped_ordinary_steering_strength;
+			value >> _PPRParams.ped_ordinary_steering_strength;
 		}
 		else if ((*optionIter).first == "ped_oncoming_threat_avoidance_strength")
 		{
-			value >> ped_oncoming_threat_avoidance_strength;
+			value >> _PPRParams.ped_oncoming_threat_avoidance_strength;
 		}
 		else if ((*optionIter).first == "ped_cross_threat_avoidance_strength")
 		{
-			value >> ped_cross_threat_avoidance_strength;
+			value >> _PPRParams.ped_cross_threat_avoidance_strength;
 		}
 		else if ((*optionIter).first == "ped_max_turning_rate")
 		{
-			value >> ped_max_turning_rate;
+			value >> _PPRParams.ped_max_turning_rate;
 		}
 		else if ((*optionIter).first == "ped_feeling_crowded_threshold")
 		{
-			value >> ped_feeling_crowded_threshold;
+			value >> _PPRParams.ped_feeling_crowded_threshold;
 		}
 		else if ((*optionIter).first == "ped_scoot_rate")
 		{
-			value >> ped_scoot_rate;
+			value >> _PPRParams.ped_scoot_rate;
 		}
 		else if ((*optionIter).first == "ped_reached_target_distance_threshold")
 		{
-			value >> ped_reached_target_distance_threshold;
+			value >> _PPRParams.ped_reached_target_distance_threshold;
 		}
 		else if ((*optionIter).first == "ped_dynamic_collision_padding")
 		{
-			value >> ped_dynamic_collision_padding;
+			value >> _PPRParams.ped_dynamic_collision_padding;
 		}
 		else if ((*optionIter).first == "ped_furthest_local_target_distance")
 		{
-			value >> ped_furthest_local_target_distance;
+			value >> _PPRParams.ped_furthest_local_target_distance;
 		}
 		else if ((*optionIter).first == "ped_next_waypoint_distance")
 		{
-			value >> ped_next_waypoint_distance;
+			value >> _PPRParams.ped_next_waypoint_distance;
 		}
 		else if ((*optionIter).first == "ped_max_num_waypoints")
 		{
-			value >> ped_max_num_waypoints;
+			value >> _PPRParams.ped_max_num_waypoints;
 		}
 		else if ((*optionIter).first == "ailogFileName")
 		{
@@ -350,16 +304,16 @@ void PPRAIModule::init( const SteerLib::OptionDictionary & options, SteerLib::En
 		}
 		else if ((*optionIter).first == "stats")
 		{
-			gShowStats = Util::getBoolFromString(value.str());
+			_gShowStats = Util::getBoolFromString(value.str());
 		}
 		else if ((*optionIter).first == "allstats")
 		{
-			gShowAllStats = Util::getBoolFromString(value.str());
+			_gShowAllStats = Util::getBoolFromString(value.str());
 			logStats = true;
 		}
 		else if ((*optionIter).first == "dont_plan")
 		{
-			dont_plan = Util::getBoolFromString(value.str());
+			_dontPlan = Util::getBoolFromString(value.str());
 		}
 		else
 		{
@@ -368,17 +322,29 @@ void PPRAIModule::init( const SteerLib::OptionDictionary & options, SteerLib::En
 	}
 
 
-	if (gShowStats)
+	// the scheduler always counts the phases run on every frame, but agents only take slots from it if the phases are staggered.
+	_phaseScheduler.init(NUM_PHASES);
+	if (!_gUseDynamicPhaseScheduling) {
+		_phaseScheduler.setInterval(LONG_TERM_PLANNING_PHASE, _gLongTermPlanningPhaseInterval);
+		_phaseScheduler.setInterval(MID_TERM_PLANNING_PHASE, _gMidTermPlanningPhaseInterval);
+		_phaseScheduler.setInterval(SHORT_TERM_PLANNING_PHASE, _gShortTermPlanningPhaseInterval);
+		_phaseScheduler.setInterval(PERCEPTIVE_PHASE, _gPerceptivePhaseInterval);
+		_phaseScheduler.setInterval(PREDICTIVE_PHASE, _gPredictivePhaseInterval);
+		_phaseScheduler.setInterval(REACTIVE_PHASE, _gReactivePhaseInterval);
+	}
+
+	if (_gShowStats)
 	{
 		std::cout << std::endl;
-		if (!gUseDynamicPhaseScheduling) {
+		if (!_gUseDynamicPhaseScheduling) {
 			std::cout << " PHASE INTERVALS (in frames):\n";
-			std::cout << "   longplan: " << gLongTermPlanningPhaseInterval << "\n";
-			std::cout << "    midplan: " << gMidTermPlanningPhaseInterval << "\n";
-			std::cout << "  shortplan: " << gShortTermPlanningPhaseInterval << "\n";
-			std::cout << " perceptive: " << gPerceptivePhaseInterval << "\n";
-			std::cout << " predictive: " << gPredictivePhaseInterval << "\n";
-			std::cout << "   reactive: " << gReactivePhaseInterval << "\n";
+			std::cout << "   longplan: " << _gLongTermPlanningPhaseInterval << "\n";
+			std::cout << "    midplan: " << _gMidTermPlanningPhaseInterval << "\n";
+			std::cout << "  shortplan: " << _gShortTermPlanningPhaseInterval << "\n";
+			std::cout << " perceptive: " << _gPerceptivePhaseInterval << "\n";
+			std::cout << " predictive: " << _gPredictivePhaseInterval << "\n";
+			std::cout << "   reactive: " << _gReactivePhaseInterval << "\n";
+			std::cout << "  staggered: " << (_gStaggerPhases ? "yes" : "no") << "\n";
 		}
 		else {
 			std::cout << " PHASE INTERVALS (in frames):\n";
@@ -403,6 +369,8 @@ void PPRAIModule::init( const SteerLib::OptionDictionary & options, SteerLib::En
 
 	if ( logStats )
 	{
+	// a module that is initialized again starts a new log under the same name.
+	LogManager::getInstance()->destroyLogger(_pprLogger);
 	_pprLogger = LogManager::getInstance()->createLogger(logFilename,LoggerType::BASIC_WRITE);
 
 	_pprLogger->addDataField("longplan",DataType::LongLong );
@@ -538,16 +506,15 @@ void PPRAIModule::initializeSimulation()
 	//
 	// initialize the performance profilers
 	//
-	gPhaseProfilers = new PhaseProfilers;
-	gPhaseProfilers->aiProfiler.reset();
-	gPhaseProfilers->longTermPhaseProfiler.reset();
-	gPhaseProfilers->midTermPhaseProfiler.reset();
-	gPhaseProfilers->shortTermPhaseProfiler.reset();
-	gPhaseProfilers->perceptivePhaseProfiler.reset();
-	gPhaseProfilers->predictivePhaseProfiler.reset();
-	gPhaseProfilers->reactivePhaseProfiler.reset();
-	gPhaseProfilers->steeringPhaseProfiler.reset();
-	
+	_phaseProfilers.aiProfiler.reset();
+	_phaseProfilers.longTermPhaseProfiler.reset();
+	_phaseProfilers.midTermPhaseProfiler.reset();
+	_phaseProfilers.shortTermPhaseProfiler.reset();
+	_phaseProfilers.perceptivePhaseProfiler.reset();
+	_phaseProfilers.predictivePhaseProfiler.reset();
+	_phaseProfilers.reactivePhaseProfiler.reset();
+	_phaseProfilers.steeringPhaseProfiler.reset();
+	_phaseScheduler.clear();
 }
 
 
@@ -560,13 +527,13 @@ void PPRAIModule::cleanupSimulation()
 	if ( logStats )
 	{
 		LogObject pprLogObject;
-		pprLogObject.addLogData((long long) gLongTermPlanningPhaseInterval);
-		pprLogObject.addLogData((long long) gMidTermPlanningPhaseInterval);
-		pprLogObject.addLogData((long long) gShortTermPlanningPhaseInterval);
-		pprLogObject.addLogData((long long) gPerceptivePhaseInterval);
-		pprLogObject.addLogData((long long) gPredictivePhaseInterval);
-		pprLogObject.addLogData((long long) gReactivePhaseInterval);
-		if (gShowAllStats)
+		pprLogObject.addLogData((long long) _gLongTermPlanningPhaseInterval);
+		pprLogObject.addLogData((long long) _gMidTermPlanningPhaseInterval);
+		pprLogObject.addLogData((long long) _gShortTermPlanningPhaseInterval);
+		pprLogObject.addLogData((long long) _gPerceptivePhaseInterval);
+		pprLogObject.addLogData((long long) _gPredictivePhaseInterval);
+		pprLogObject.addLogData((long long) _gReactivePhaseInterval);
+		if (_gShowAllStats)
 		{
 			std::cout << "===================================================\n";
 			std::cout << "PROFILE RESULTS  " << std::endl;
@@ -574,131 +541,131 @@ void PPRAIModule::cleanupSimulation()
 
 			std::cout << "--- Long-term planning ---\n";
 			std::cout << std::endl;
-			gPhaseProfilers->longTermPhaseProfiler.displayStatistics(std::cout);
-		}
-			pprLogObject.addLogData(gPhaseProfilers->longTermPhaseProfiler.getNumTimesExecuted());
-			pprLogObject.addLogData(gPhaseProfilers->longTermPhaseProfiler.getTotalTicksAccumulated());
-			pprLogObject.addLogData(gPhaseProfilers->longTermPhaseProfiler.getMinTicks());
-			pprLogObject.addLogData(gPhaseProfilers->longTermPhaseProfiler.getMaxTicks());
-			pprLogObject.addLogData(gPhaseProfilers->longTermPhaseProfiler.getMinExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->longTermPhaseProfiler.getMaxExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->longTermPhaseProfiler.getAverageExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->longTermPhaseProfiler.getTotalTime());
-			pprLogObject.addLogData(gPhaseProfilers->longTermPhaseProfiler.getTickFrequency());
-
-			if (gShowAllStats)
+			_phaseProfilers.longTermPhaseProfiler.displayStatistics(std::cout);
+		}
+			pprLogObject.addLogData(_phaseProfilers.longTermPhaseProfiler.getNumTimesExecuted());
+			pprLogObject.addLogData(_phaseProfilers.longTermPhaseProfiler.getTotalTicksAccumulated());
+			pprLogObject.addLogData(_phaseProfilers.longTermPhaseProfiler.getMinTicks());
+			pprLogObject.addLogData(_phaseProfilers.longTermPhaseProfiler.getMaxTicks());
+			pprLogObject.addLogData(_phaseProfilers.longTermPhaseProfiler.getMinExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.longTermPhaseProfiler.getMaxExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.longTermPhaseProfiler.getAverageExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.longTermPhaseProfiler.getTotalTime());
+			pprLogObject.addLogData(_phaseProfilers.longTermPhaseProfiler.getTickFrequency());
+
+			if (_gShowAllStats)
 			{
 				std::cout << "--- Mid-term planning ---\n";
-				gPhaseProfilers->midTermPhaseProfiler.displayStatistics(std::cout);
+				_phaseProfilers.midTermPhaseProfiler.displayStatistics(std::cout);
 				std::cout << std::endl;
 			}
-			pprLogObject.addLogData(gPhaseProfilers->midTermPhaseProfiler.getNumTimesExecuted());
-			pprLogObject.addLogData(gPhaseProfilers->midTermPhaseProfiler.getTotalTicksAccumulated());
-			pprLogObject.addLogData(gPhaseProfilers->midTermPhaseProfiler.getMinTicks());
-			pprLogObject.addLogData(gPhaseProfilers->midTermPhaseProfiler.getMaxTicks());
-			pprLogObject.addLogData(gPhaseProfilers->midTermPhaseProfiler.getMinExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->midTermPhaseProfiler.getMaxExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->midTermPhaseProfiler.getAverageExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->midTermPhaseProfiler.getTotalTime());
-			pprLogObject.addLogData(gPhaseProfilers->midTermPhaseProfiler.getTickFrequency());
-
-			if (gShowAllStats)
+			pprLogObject.addLogData(_phaseProfilers.midTermPhaseProfiler.getNumTimesExecuted());
+			pprLogObject.addLogData(_phaseProfilers.midTermPhaseProfiler.getTotalTicksAccumulated());
+			pprLogObject.addLogData(_phaseProfilers.midTermPhaseProfiler.getMinTicks());
+			pprLogObject.addLogData(_phaseProfilers.midTermPhaseProfiler.getMaxTicks());
+			pprLogObject.addLogData(_phaseProfilers.midTermPhaseProfiler.getMinExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.midTermPhaseProfiler.getMaxExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.midTermPhaseProfiler.getAverageExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.midTermPhaseProfiler.getTotalTime());
+			pprLogObject.addLogData(_phaseProfilers.midTermPhaseProfiler.getTickFrequency());
+
+			if (_gShowAllStats)
 			{
 				std::cout << "--- Short-term planning ---\n";
-				gPhaseProfilers->shortTermPhaseProfiler.displayStatistics(std::cout);
+				_phaseProfilers.shortTermPhaseProfiler.displayStatistics(std::cout);
 				std::cout << std::endl;
 			}
-			pprLogObject.addLogData(gPhaseProfilers->shortTermPhaseProfiler.getNumTimesExecuted());
-			pprLogObject.addLogData(gPhaseProfilers->shortTermPhaseProfiler.getTotalTicksAccumulated());
-			pprLogObject.addLogData(gPhaseProfilers->shortTermPhaseProfiler.getMinTicks());
-			pprLogObject.addLogData(gPhaseProfilers->shortTermPhaseProfiler.getMaxTicks());
-			pprLogObject.addLogData(gPhaseProfilers->shortTermPhaseProfiler.getMinExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->shortTermPhaseProfiler.getMaxExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->shortTermPhaseProfiler.getAverageExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->shortTermPhaseProfiler.getTotalTime());
-			pprLogObject.addLogData(gPhaseProfilers->shortTermPhaseProfiler.getTickFrequency());
-
-			if (gShowAllStats)
+			pprLogObject.addLogData(_phaseProfilers.shortTermPhaseProfiler.getNumTimesExecuted());
+			pprLogObject.addLogData(_phaseProfilers.shortTermPhaseProfiler.getTotalTicksAccumulated());
+			pprLogObject.addLogData(_phaseProfilers.shortTermPhaseProfiler.getMinTicks());
+			pprLogObject.addLogData(_phaseProfilers.shortTermPhaseProfiler.getMaxTicks());
+			pprLogObject.addLogData(_phaseProfilers.shortTermPhaseProfiler.getMinExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.shortTermPhaseProfiler.getMaxExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.shortTermPhaseProfiler.getAverageExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.shortTermPhaseProfiler.getTotalTime());
+			pprLogObject.addLogData(_phaseProfilers.shortTermPhaseProfiler.getTickFrequency());
+
+			if (_gShowAllStats)
 			{
 				std::cout << "--- Perceptive phase ---\n";
-				gPhaseProfilers->perceptivePhaseProfiler.displayStatistics(std::cout);
+				_phaseProfilers.perceptivePhaseProfiler.displayStatistics(std::cout);
 				std::cout << std::endl;
 			}
-			pprLogObject.addLogData(gPhaseProfilers->perceptivePhaseProfiler.getNumTimesExecuted());
-			pprLogObject.addLogData(gPhaseProfilers->perceptivePhaseProfiler.getTotalTicksAccumulated());
-			pprLogObject.addLogData(gPhaseProfilers->perceptivePhaseProfiler.getMinTicks());
-			pprLogObject.addLogData(gPhaseProfilers->perceptivePhaseProfiler.getMaxTicks());
-			pprLogObject.addLogData(gPhaseProfilers->perceptivePhaseProfiler.getMinExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->perceptivePhaseProfiler.getMaxExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->perceptivePhaseProfiler.getAverageExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->perceptivePhaseProfiler.getTotalTime());
-			pprLogObject.addLogData(gPhaseProfilers->perceptivePhaseProfiler.getTickFrequency());
-
-			if (gShowAllStats)
+			pprLogObject.addLogData(_phaseProfilers.perceptivePhaseProfiler.getNumTimesExecuted());
+			pprLogObject.addLogData(_phaseProfilers.perceptivePhaseProfiler.getTotalTicksAccumulated());
+			pprLogObject.addLogData(_phaseProfilers.perceptivePhaseProfiler.getMinTicks());
+			pprLogObject.addLogData(_phaseProfilers.perceptivePhaseProfiler.getMaxTicks());
+			pprLogObject.addLogData(_phaseProfilers.perceptivePhaseProfiler.getMinExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.perceptivePhaseProfiler.getMaxExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.perceptivePhaseProfiler.getAverageExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.perceptivePhaseProfiler.getTotalTime());
+			pprLogObject.addLogData(_phaseProfilers.perceptivePhaseProfiler.getTickFrequency());
+
+			if (_gShowAllStats)
 			{
 				std::cout << "--- Predictive phase ---\n";
-				gPhaseProfilers->predictivePhaseProfiler.displayStatistics(std::cout);
+				_phaseProfilers.predictivePhaseProfiler.displayStatistics(std::cout);
 				std::cout << std::endl;
 			}
-			pprLogObject.addLogData(gPhaseProfilers->predictivePhaseProfiler.getNumTimesExecuted());
-			pprLogObject.addLogData(gPhaseProfilers->predictivePhaseProfiler.getTotalTicksAccumulated());
-			pprLogObject.addLogData(gPhaseProfilers->predictivePhaseProfiler.getMinTicks());
-			pprLogObject.addLogData(gPhaseProfilers->predictivePhaseProfiler.getMaxTicks());
-			pprLogObject.addLogData(gPhaseProfilers->predictivePhaseProfiler.getMinExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->predictivePhaseProfiler.getMaxExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->predictivePhaseProfiler.getAverageExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->predictivePhaseProfiler.getTotalTime());
-			pprLogObject.addLogData(gPhaseProfilers->predictivePhaseProfiler.getTickFrequency());
-
-			if (gShowAllStats)
+			pprLogObject.addLogData(_phaseProfilers.predictivePhaseProfiler.getNumTimesExecuted());
+			pprLogObject.addLogData(_phaseProfilers.predictivePhaseProfiler.getTotalTicksAccumulated());
+			pprLogObject.addLogData(_phaseProfilers.predictivePhaseProfiler.getMinTicks());
+			pprLogObject.addLogData(_phaseProfilers.predictivePhaseProfiler.getMaxTicks());
+			pprLogObject.addLogData(_phaseProfilers.predictivePhaseProfiler.getMinExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.predictivePhaseProfiler.getMaxExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.predictivePhaseProfiler.getAverageExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.predictivePhaseProfiler.getTotalTime());
+			pprLogObject.addLogData(_phaseProfilers.predictivePhaseProfiler.getTickFrequency());
+
+			if (_gShowAllStats)
 			{
 				std::cout << "--- Reactive phase ---\n";
-				gPhaseProfilers->reactivePhaseProfiler.displayStatistics(std::cout);
+				_phaseProfilers.reactivePhaseProfiler.displayStatistics(std::cout);
 				std::cout << std::endl;
 			}
-			pprLogObject.addLogData(gPhaseProfilers->reactivePhaseProfiler.getNumTimesExecuted());
-			pprLogObject.addLogData(gPhaseProfilers->reactivePhaseProfiler.getTotalTicksAccumulated());
-			pprLogObject.addLogData(gPhaseProfilers->reactivePhaseProfiler.getMinTicks());
-			pprLogObject.addLogData(gPhaseProfilers->reactivePhaseProfiler.getMaxTicks());
-			pprLogObject.addLogData(gPhaseProfilers->reactivePhaseProfiler.getMinExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->reactivePhaseProfiler.getMaxExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->reactivePhaseProfiler.getAverageExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->reactivePhaseProfiler.getTotalTime());
-			pprLogObject.addLogData(gPhaseProfilers->reactivePhaseProfiler.getTickFrequency());
-
-			if (gShowAllStats)
+			pprLogObject.addLogData(_phaseProfilers.reactivePhaseProfiler.getNumTimesExecuted());
+			pprLogObject.addLogData(_phaseProfilers.reactivePhaseProfiler.getTotalTicksAccumulated());
+			pprLogObject.addLogData(_phaseProfilers.reactivePhaseProfiler.getMinTicks());
+			pprLogObject.addLogData(_phaseProfilers.reactivePhaseProfiler.getMaxTicks());
+			pprLogObject.addLogData(_phaseProfilers.reactivePhaseProfiler.getMinExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.reactivePhaseProfiler.getMaxExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.reactivePhaseProfiler.getAverageExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.reactivePhaseProfiler.getTotalTime());
+			pprLogObject.addLogData(_phaseProfilers.reactivePhaseProfiler.getTickFrequency());
+
+			if (_gShowAllStats)
 			{
 				std::cout << "--- Steering phase ---\n";
-				gPhaseProfilers->steeringPhaseProfiler.displayStatistics(std::cout);
+				_phaseProfilers.steeringPhaseProfiler.displayStatistics(std::cout);
 				std::cout << std::endl;
 			}
-			pprLogObject.addLogData(gPhaseProfilers->steeringPhaseProfiler.getNumTimesExecuted());
-			pprLogObject.addLogData(gPhaseProfilers->steeringPhaseProfiler.getTotalTicksAccumulated());
-			pprLogObject.addLogData(gPhaseProfilers->steeringPhaseProfiler.getMinTicks());
-			pprLogObject.addLogData(gPhaseProfilers->steeringPhaseProfiler.getMaxTicks());
-			pprLogObject.addLogData(gPhaseProfilers->steeringPhaseProfiler.getMinExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->steeringPhaseProfiler.getMaxExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->steeringPhaseProfiler.getAverageExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->steeringPhaseProfiler.getTotalTime());
-			pprLogObject.addLogData(gPhaseProfilers->steeringPhaseProfiler.getTickFrequency());
-
-			if (gShowAllStats)
+			pprLogObject.addLogData(_phaseProfilers.steeringPhaseProfiler.getNumTimesExecuted());
+			pprLogObject.addLogData(_phaseProfilers.steeringPhaseProfiler.getTotalTicksAccumulated());
+			pprLogObject.addLogData(_phaseProfilers.steeringPhaseProfiler.getMinTicks());
+			pprLogObject.addLogData(_phaseProfilers.steeringPhaseProfiler.getMaxTicks());
+			pprLogObject.addLogData(_phaseProfilers.steeringPhaseProfiler.getMinExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.steeringPhaseProfiler.getMaxExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.steeringPhaseProfiler.getAverageExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.steeringPhaseProfiler.getTotalTime());
+			pprLogObject.addLogData(_phaseProfilers.steeringPhaseProfiler.getTickFrequency());
+
+			if (_gShowAllStats)
 			{
 				std::cout << "--- TOTAL AI ---\n";
-				gPhaseProfilers->aiProfiler.displayStatistics(std::cout);
+				_phaseProfilers.aiProfiler.displayStatistics(std::cout);
 				std::cout << std::endl;
 			}
-			pprLogObject.addLogData(gPhaseProfilers->aiProfiler.getNumTimesExecuted());
-			pprLogObject.addLogData(gPhaseProfilers->aiProfiler.getTotalTicksAccumulated());
-			pprLogObject.addLogData(gPhaseProfilers->aiProfiler.getMinTicks());
-			pprLogObject.addLogData(gPhaseProfilers->aiProfiler.getMaxTicks());
-			pprLogObject.addLogData(gPhaseProfilers->aiProfiler.getMinExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->aiProfiler.getMaxExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->aiProfiler.getAverageExecutionTimeMills());
-			pprLogObject.addLogData(gPhaseProfilers->aiProfiler.getTotalTime());
-			pprLogObject.addLogData(gPhaseProfilers->aiProfiler.getTickFrequency());
-
-			if (gShowAllStats)
+			pprLogObject.addLogData(_phaseProfilers.aiProfiler.getNumTimesExecuted());
+			pprLogObject.addLogData(_phaseProfilers.aiProfiler.getTotalTicksAccumulated());
+			pprLogObject.addLogData(_phaseProfilers.aiProfiler.getMinTicks());
+			pprLogObject.addLogData(_phaseProfilers.aiProfiler.getMaxTicks());
+			pprLogObject.addLogData(_phaseProfilers.aiProfiler.getMinExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.aiProfiler.getMaxExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.aiProfiler.getAverageExecutionTimeMills());
+			pprLogObject.addLogData(_phaseProfilers.aiProfiler.getTotalTime());
+			pprLogObject.addLogData(_phaseProfilers.aiProfiler.getTickFrequency());
+
+			if (_gShowAllStats)
 			{
 				std::cout << std::endl;
 
@@ -708,35 +675,35 @@ void PPRAIModule::cleanupSimulation()
 				std::cout << "         because it excludes space-time planning)\n\n";
 			}
 			float totalAgentTime =
-				gPhaseProfilers->midTermPhaseProfiler.getAverageExecutionTime() + 
-				gPhaseProfilers->shortTermPhaseProfiler.getAverageExecutionTime() +
-				gPhaseProfilers->perceptivePhaseProfiler.getAverageExecutionTime() +
-				gPhaseProfilers->predictivePhaseProfiler.getAverageExecutionTime() +
-				gPhaseProfilers->reactivePhaseProfiler.getAverageExecutionTime() +
-				gPhaseProfilers->steeringPhaseProfiler.getAverageExecutionTime();
+				_phaseProfilers.midTermPhaseProfiler.getAverageExecutionTime() + 
+				_phaseProfilers.shortTermPhaseProfiler.getAverageExecutionTime() +
+				_phaseProfilers.perceptivePhaseProfiler.getAverageExecutionTime() +
+				_phaseProfilers.predictivePhaseProfiler.getAverageExecutionTime() +
+				_phaseProfilers.reactivePhaseProfiler.getAverageExecutionTime() +
+				_phaseProfilers.steeringPhaseProfiler.getAverageExecutionTime();
 			float totalAgentTime_5Hz_amortized =   // 5 Hz skips every 4 frames, so scale by 0.25
-				gPhaseProfilers->midTermPhaseProfiler.getAverageExecutionTime() * 0.25f + 
-				gPhaseProfilers->shortTermPhaseProfiler.getAverageExecutionTime() * 0.25f +
-				gPhaseProfilers->perceptivePhaseProfiler.getAverageExecutionTime() * 0.25f +
-				gPhaseProfilers->predictivePhaseProfiler.getAverageExecutionTime() * 0.25f +
-				gPhaseProfilers->reactivePhaseProfiler.getAverageExecutionTime() +  // reactive and steering phases still execute 20 Hz.
-				gPhaseProfilers->steeringPhaseProfiler.getAverageExecutionTime();
+				_phaseProfilers.midTermPhaseProfiler.getAverageExecutionTime() * 0.25f + 
+				_phaseProfilers.shortTermPhaseProfiler.getAverageExecutionTime() * 0.25f +
+				_phaseProfilers.perceptivePhaseProfiler.getAverageExecutionTime() * 0.25f +
+				_phaseProfilers.predictivePhaseProfiler.getAverageExecutionTime() * 0.25f +
+				_phaseProfilers.reactivePhaseProfiler.getAverageExecutionTime() +  // reactive and steering phases still execute 20 Hz.
+				_phaseProfilers.steeringPhaseProfiler.getAverageExecutionTime();
 			float totalAgentTime_4Hz_amortized =    // 4 Hz skips every 5 frames, so scale by 0.2
-				gPhaseProfilers->midTermPhaseProfiler.getAverageExecutionTime() * 0.2f + 
-				gPhaseProfilers->shortTermPhaseProfiler.getAverageExecutionTime() * 0.2f +
-				gPhaseProfilers->perceptivePhaseProfiler.getAverageExecutionTime() * 0.2f +
-				gPhaseProfilers->predictivePhaseProfiler.getAverageExecutionTime() * 0.2f +
-				gPhaseProfilers->reactivePhaseProfiler.getAverageExecutionTime() +  // reactive and steering phases still execute 20 Hz.
-				gPhaseProfilers->steeringPhaseProfiler.getAverageExecutionTime();
-
-			if (gShowAllStats)
+				_phaseProfilers.midTermPhaseProfiler.getAverageExecutionTime() * 0.2f + 
+				_phaseProfilers.shortTermPhaseProfiler.getAverageExecutionTime() * 0.2f +
+				_phaseProfilers.perceptivePhaseProfiler.getAverageExecutionTime() * 0.2f +
+				_phaseProfilers.predictivePhaseProfiler.getAverageExecutionTime() * 0.2f +
+				_phaseProfilers.reactivePhaseProfiler.getAverageExecutionTime() +  // reactive and steering phases still execute 20 Hz.
+				_phaseProfilers.steeringPhaseProfiler.getAverageExecutionTime();
+
+			if (_gShowAllStats)
 			{
-				std::cout << " percent mid-term:   " << gPhaseProfilers->midTermPhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT<< "\n";
-				std::cout << " percent short-term: " << gPhaseProfilers->shortTermPhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT<< "\n";
-				std::cout << " percent perceptive: " << gPhaseProfilers->perceptivePhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT << "\n";
-				std::cout << " percent predictive: " << gPhaseProfilers->predictivePhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT << "\n";
-				std::cout << " percent reactive:   " << gPhaseProfilers->reactivePhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT << "\n";
-				std::cout << " percent steering:   " << gPhaseProfilers->steeringPhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT << "\n";
+				std::cout << " percent mid-term:   " << _phaseProfilers.midTermPhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT<< "\n";
+				std::cout << " percent short-term: " << _phaseProfilers.shortTermPhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT<< "\n";
+				std::cout << " percent perceptive: " << _phaseProfilers.perceptivePhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT << "\n";
+				std::cout << " percent predictive: " << _phaseProfilers.predictivePhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT << "\n";
+				std::cout << " percent reactive:   " << _phaseProfilers.reactivePhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT << "\n";
+				std::cout << " percent steering:   " << _phaseProfilers.steeringPhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT << "\n";
 				std::cout << "\n";
 				std::cout << " Average per agent, no amortization: " << totalAgentTime * 1000.0 << " milliseconds\n";
 				std::cout << " Average per agent, 5Hz (skip 4 frames): " << totalAgentTime_5Hz_amortized * 1000.0 << " milliseconds\n";
@@ -745,55 +712,55 @@ void PPRAIModule::cleanupSimulation()
 			}
 
 
-			pprLogObject.addLogData(gPhaseProfilers->midTermPhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT);
-			pprLogObject.addLogData(gPhaseProfilers->shortTermPhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT);
-			pprLogObject.addLogData(gPhaseProfilers->perceptivePhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT);
-			pprLogObject.addLogData(gPhaseProfilers->predictivePhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT);
-			pprLogObject.addLogData(gPhaseProfilers->reactivePhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT);
-			pprLogObject.addLogData(gPhaseProfilers->steeringPhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT);
+			pprLogObject.addLogData(_phaseProfilers.midTermPhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT);
+			pprLogObject.addLogData(_phaseProfilers.shortTermPhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT);
+			pprLogObject.addLogData(_phaseProfilers.perceptivePhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT);
+			pprLogObject.addLogData(_phaseProfilers.predictivePhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT);
+			pprLogObject.addLogData(_phaseProfilers.reactivePhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT);
+			pprLogObject.addLogData(_phaseProfilers.steeringPhaseProfiler.getAverageExecutionTime()/totalAgentTime * PERCENT);
 			pprLogObject.addLogData(totalAgentTime * TO_MILLISECONDS);
 			pprLogObject.addLogData(totalAgentTime_5Hz_amortized * TO_MILLISECONDS);
 			pprLogObject.addLogData(totalAgentTime_4Hz_amortized * TO_MILLISECONDS);
 
 
 
-		if (gShowStats || gShowAllStats)
+		if (_gShowStats || _gShowAllStats)
 		{
 			std::cout << "--- PROFILE RESULTS (excluding long-term planning) ---\n\n";
 		}
 		float totalTimeForAllAgents =
-			gPhaseProfilers->midTermPhaseProfiler.getTotalTime()+
-			gPhaseProfilers->shortTermPhaseProfiler.getTotalTime() +
-			gPhaseProfilers->perceptivePhaseProfiler.getTotalTime() +
-			gPhaseProfilers->predictivePhaseProfiler.getTotalTime() +
-			gPhaseProfilers->reactivePhaseProfiler.getTotalTime() +
-			gPhaseProfilers->steeringPhaseProfiler.getTotalTime();
+			_phaseProfilers.midTermPhaseProfiler.getTotalTime()+
+			_phaseProfilers.shortTermPhaseProfiler.getTotalTime() +
+			_phaseProfilers.perceptivePhaseProfiler.getTotalTime() +
+			_phaseProfilers.predictivePhaseProfiler.getTotalTime() +
+			_phaseProfilers.reactivePhaseProfiler.getTotalTime() +
+			_phaseProfilers.steeringPhaseProfiler.getTotalTime();
 
 		// TODO: right now this is hacked, later on need to add an arg or access to the engine to get this value correctly:
-		if (gShowStats || gShowAllStats)
+		if (_gShowStats || _gShowAllStats)
 		{
 			std::cerr << " TODO: 20 frames per second is a hard-coded assumption in the following calculations\n";
 		}
 		float baseFrequency = 20.0f;
-		float totalNumberOfFrames = (float)gPhaseProfilers->steeringPhaseProfiler.getNumTimesExecuted();
+		float totalNumberOfFrames = (float)_phaseProfilers.steeringPhaseProfiler.getNumTimesExecuted();
 
-		float average_frequency_mid_term = gPhaseProfilers->midTermPhaseProfiler.getNumTimesExecuted()/totalNumberOfFrames * baseFrequency; // << " Hz (skipping " << totalNumberOfFrames/((float)gPhaseProfilers->midTermPhaseProfiler.getNumTimesExecuted()) << " frames)\n";
-		float average_frequency_short_term = gPhaseProfilers->shortTermPhaseProfiler.getNumTimesExecuted()/totalNumberOfFrames * baseFrequency; //  << " Hz (skipping " << totalNumberOfFrames/((float)gPhaseProfilers->shortTermPhaseProfiler.getNumTimesExecuted()) << " frames)\n";
-		float average_frequency_perceptive = gPhaseProfilers->perceptivePhaseProfiler.getNumTimesExecuted()/totalNumberOfFrames * baseFrequency; // << " Hz (skipping " << totalNumberOfFrames/((float)gPhaseProfilers->perceptivePhaseProfiler.getNumTimesExecuted()) << " frames)\n";
-		float average_frequency_predictive = gPhaseProfilers->predictivePhaseProfiler.getNumTimesExecuted()/totalNumberOfFrames * baseFrequency; // << " Hz (skipping " << totalNumberOfFrames/((float)gPhaseProfilers->predictivePhaseProfiler.getNumTimesExecuted()) << " frames)\n";
-		float average_frequency_reactive = gPhaseProfilers->reactivePhaseProfiler.getNumTimesExecuted()/totalNumberOfFrames * baseFrequency; // << " Hz (skipping " << totalNumberOfFrames/((float)gPhaseProfilers->reactivePhaseProfiler.getNumTimesExecuted()) << " frames)\n";
-		float average_frequency_steering = gPhaseProfilers->steeringPhaseProfiler.getNumTimesExecuted()/totalNumberOfFrames * baseFrequency; // << " Hz (skipping " << totalNumberOfFrames/((float)gPhaseProfilers->steeringPhaseProfiler.getNumTimesExecuted()) << " frames)\n";
+		float average_frequency_mid_term = _phaseProfilers.midTermPhaseProfiler.getNumTimesExecuted()/totalNumberOfFrames * baseFrequency; // << " Hz (skipping " << totalNumberOfFrames/((float)_phaseProfilers.midTermPhaseProfiler.getNumTimesExecuted()) << " frames)\n";
+		float average_frequency_short_term = _phaseProfilers.shortTermPhaseProfiler.getNumTimesExecuted()/totalNumberOfFrames * baseFrequency; //  << " Hz (skipping " << totalNumberOfFrames/((float)_phaseProfilers.shortTermPhaseProfiler.getNumTimesExecuted()) << " frames)\n";
+		float average_frequency_perceptive = _phaseProfilers.perceptivePhaseProfiler.getNumTimesExecuted()/totalNumberOfFrames * baseFrequency; // << " Hz (skipping " << totalNumberOfFrames/((float)_phaseProfilers.perceptivePhaseProfiler.getNumTimesExecuted()) << " frames)\n";
+		float average_frequency_predictive = _phaseProfilers.predictivePhaseProfiler.getNumTimesExecuted()/totalNumberOfFrames * baseFrequency; // << " Hz (skipping " << totalNumberOfFrames/((float)_phaseProfilers.predictivePhaseProfiler.getNumTimesExecuted()) << " frames)\n";
+		float average_frequency_reactive = _phaseProfilers.reactivePhaseProfiler.getNumTimesExecuted()/totalNumberOfFrames * baseFrequency; // << " Hz (skipping " << totalNumberOfFrames/((float)_phaseProfilers.reactivePhaseProfiler.getNumTimesExecuted()) << " frames)\n";
+		float average_frequency_steering = _phaseProfilers.steeringPhaseProfiler.getNumTimesExecuted()/totalNumberOfFrames * baseFrequency; // << " Hz (skipping " << totalNumberOfFrames/((float)_phaseProfilers.steeringPhaseProfiler.getNumTimesExecuted()) << " frames)\n";
 
-		if (gShowStats || gShowAllStats)
+		if (_gShowStats || _gShowAllStats)
 		{
 			std::cout << "\n";
 
-			std::cout << " average frequency mid-term:   " << average_frequency_mid_term << " Hz (skipping " << totalNumberOfFrames/((float)gPhaseProfilers->midTermPhaseProfiler.getNumTimesExecuted()) << " frames)\n";
-			std::cout << " average frequency short-term: " << average_frequency_short_term << " Hz (skipping " << totalNumberOfFrames/((float)gPhaseProfilers->shortTermPhaseProfiler.getNumTimesExecuted()) << " frames)\n";
-			std::cout << " average frequency perceptive: " << average_frequency_perceptive << " Hz (skipping " << totalNumberOfFrames/((float)gPhaseProfilers->perceptivePhaseProfiler.getNumTimesExecuted()) << " frames)\n";
-			std::cout << " average frequency predictive: " << average_frequency_predictive << " Hz (skipping " << totalNumberOfFrames/((float)gPhaseProfilers->predictivePhaseProfiler.getNumTimesExecuted()) << " frames)\n";
-			std::cout << " average frequency reactive:   " << average_frequency_reactive << " Hz (skipping " << totalNumberOfFrames/((float)gPhaseProfilers->reactivePhaseProfiler.getNumTimesExecuted()) << " frames)\n";
-			std::cout << " average frequency steering:   " << average_frequency_steering << " Hz (skipping " << totalNumberOfFrames/((float)gPhaseProfilers->steeringPhaseProfiler.getNumTimesExecuted()) << " frames)\n";
+			std::cout << " average frequency mid-term:   " << average_frequency_mid_term << " Hz (skipping " << totalNumberOfFrames/((float)_phaseProfilers.midTermPhaseProfiler.getNumTimesExecuted()) << " frames)\n";
+			std::cout << " average frequency short-term: " << average_frequency_short_term << " Hz (skipping " << totalNumberOfFrames/((float)_phaseProfilers.shortTermPhaseProfiler.getNumTimesExecuted()) << " frames)\n";
+			std::cout << " average frequency perceptive: " << average_frequency_perceptive << " Hz (skipping " << totalNumberOfFrames/((float)_phaseProfilers.perceptivePhaseProfiler.getNumTimesExecuted()) << " frames)\n";
+			std::cout << " average frequency predictive: " << average_frequency_predictive << " Hz (skipping " << totalNumberOfFrames/((float)_phaseProfilers.predictivePhaseProfiler.getNumTimesExecuted()) << " frames)\n";
+			std::cout << " average frequency reactive:   " << average_frequency_reactive << " Hz (skipping " << totalNumberOfFrames/((float)_phaseProfilers.reactivePhaseProfiler.getNumTimesExecuted()) << " frames)\n";
+			std::cout << " average frequency steering:   " << average_frequency_steering << " Hz (skipping " << totalNumberOfFrames/((float)_phaseProfilers.steeringPhaseProfiler.getNumTimesExecuted()) << " frames)\n";
 			std::cout << "\n";
 		}
 
@@ -805,15 +772,15 @@ void PPRAIModule::cleanupSimulation()
 		pprLogObject.addLogData(average_frequency_steering);
 
 
-		float amortized_percent_mid_term = gPhaseProfilers->midTermPhaseProfiler.getTotalTime()/totalTimeForAllAgents * PERCENT;
-		float amortized_percent_short_term = gPhaseProfilers->shortTermPhaseProfiler.getTotalTime()/totalTimeForAllAgents * PERCENT;
-		float amortized_percent_perceptive = gPhaseProfilers->perceptivePhaseProfiler.getTotalTime()/totalTimeForAllAgents * PERCENT;
-		float amortized_percent_predictive = gPhaseProfilers->predictivePhaseProfiler.getTotalTime()/totalTimeForAllAgents * PERCENT;
-		float amortized_percent_reactive = gPhaseProfilers->reactivePhaseProfiler.getTotalTime()/totalTimeForAllAgents * PERCENT;
-		float amortized_percent_steering = gPhaseProfilers->steeringPhaseProfiler.getTotalTime()/totalTimeForAllAgents * PERCENT;
-		float AVERAGE_PER_AGENT_PER_UPDATE = totalTimeForAllAgents / ((float)gPhaseProfilers->steeringPhaseProfiler.getNumTimesExecuted()) * TO_MILLISECONDS;
+		float amortized_percent_mid_term = _phaseProfilers.midTermPhaseProfiler.getTotalTime()/totalTimeForAllAgents * PERCENT;
+		float amortized_percent_short_term = _phaseProfilers.shortTermPhaseProfiler.getTotalTime()/totalTimeForAllAgents * PERCENT;
+		float amortized_percent_perceptive = _phaseProfilers.perceptivePhaseProfiler.getTotalTime()/totalTimeForAllAgents * PERCENT;
+		float amortized_percent_predictive = _phaseProfilers.predictivePhaseProfiler.getTotalTime()/totalTimeForAllAgents * PERCENT;
+		float amortized_percent_reactive = _phaseProfilers.reactivePhaseProfiler.getTotalTime()/totalTimeForAllAgents * PERCENT;
+		float amortized_percent_steering = _phaseProfilers.steeringPhaseProfiler.getTotalTime()/totalTimeForAllAgents * PERCENT;
+		float AVERAGE_PER_AGENT_PER_UPDATE = totalTimeForAllAgents / ((float)_phaseProfilers.steeringPhaseProfiler.getNumTimesExecuted()) * TO_MILLISECONDS;
 
-		if (gShowStats || gShowAllStats)
+		if (_gShowStats || _gShowAllStats)
 		{
 			std::cout << " amortized percent mid-term:   " << amortized_percent_mid_term << "\n";
 			std::cout << " amortized percent short-term: " << amortized_percent_short_term << "\n";
@@ -838,14 +805,33 @@ void PPRAIModule::cleanupSimulation()
 
 	}
 
-	gPhaseProfilers->aiProfiler.reset();
-	gPhaseProfilers->longTermPhaseProfiler.reset();
-	gPhaseProfilers->midTermPhaseProfiler.reset();
-	gPhaseProfilers->shortTermPhaseProfiler.reset();
-	gPhaseProfilers->perceptivePhaseProfiler.reset();
-	gPhaseProfilers->predictivePhaseProfiler.reset();
-	gPhaseProfilers->reactivePhaseProfiler.reset();
-	gPhaseProfilers->steeringPhaseProfiler.reset();
+	_phaseProfilers.aiProfiler.reset();
+	_phaseProfilers.longTermPhaseProfiler.reset();
+	_phaseProfilers.midTermPhaseProfiler.reset();
+	_phaseProfilers.shortTermPhaseProfiler.reset();
+	_phaseProfilers.perceptivePhaseProfiler.reset();
+	_phaseProfilers.predictivePhaseProfiler.reset();
+	_phaseProfilers.reactivePhaseProfiler.reset();
+	_phaseProfilers.steeringPhaseProfiler.reset();
+
+	if (_gShowStats || _gShowAllStats) {
+		static const std::string phaseNames[NUM_PHASES] = { "longplan", "midplan", "shortplan", "perceptive", "predictive", "reactive" };
+		_phaseScheduler.printStatistics(std::cout, phaseNames);
+	}
+}
+
+
+//
+// saveState() and restoreState()
+//
+void PPRAIModule::saveState(SteerLib::CheckpointWriter & out)
+{
+	_phaseScheduler.saveState(out);
+}
+
+void PPRAIModule::restoreState(SteerLib::CheckpointReader & in)
+{
+	_phaseScheduler.restoreState(in);
 }
 
 void PPRAIModule::finish()
@@ -857,6 +843,8 @@ SteerLib::AgentInterface * PPRAIModule::createAgent()
 {
 	PPRAgent * agent = new PPRAgent;
 	agent->_gEngine = this->_gEngine;
+	agent->_aiModule = this;
+	agent->_PPRParams = _PPRParams;
 	agent->_id = _gEngine->getAgents().size();	
 	return agent;
 }
@@ -33,51 +33,13 @@ using std::min;
 //
 PPRAgent::PPRAgent()
 {
-	_PPRParams.ped_max_speed = ped_max_speed;
-	_PPRParams.ped_typical_speed   = ped_typical_speed  ;
-	_PPRParams.ped_max_force    = ped_max_force   ;
-	_PPRParams.ped_max_speed_factor    = ped_max_speed_factor   ;
-	_PPRParams.ped_faster_speed_factor   = ped_faster_speed_factor  ;
-	_PPRParams.ped_slightly_faster_speed_factor  = ped_slightly_faster_speed_factor ;
-	_PPRParams.ped_typical_speed_factor     = ped_typical_speed_factor    ;
-	_PPRParams.ped_slightly_slower_speed_factor  = ped_slightly_slower_speed_factor ;
-	_PPRParams.ped_slower_speed_factor  = ped_slower_speed_factor ;
-	_PPRParams.ped_cornering_turn_rate  = ped_cornering_turn_rate ;
-	_PPRParams.ped_adjustment_turn_rate  = ped_adjustment_turn_rate ;
-	_PPRParams.ped_faster_avoidance_turn_rate  = ped_faster_avoidance_turn_rate ;
-	_PPRParams.ped_typical_avoidance_turn_rate  = ped_typical_avoidance_turn_rate ;
-	_PPRParams.ped_braking_rate   = ped_braking_rate  ;
-	_PPRParams.ped_comfort_zone     = ped_comfort_zone    ;
-	_PPRParams.ped_query_radius    = ped_query_radius   ;
-	_PPRParams.ped_similar_direction_dot_product_threshold  = ped_similar_direction_dot_product_threshold ;
-	_PPRParams.ped_same_direction_dot_product_threshold  = ped_same_direction_dot_product_threshold ;
-	_PPRParams.ped_oncoming_prediction_threshold  = ped_oncoming_prediction_threshold ;
-	_PPRParams.ped_oncoming_reaction_threshold  = ped_oncoming_reaction_threshold ;
-	_PPRParams.ped_wrong_direction_dot_product_threshold  = ped_wrong_direction_dot_product_threshold ;
-	_PPRParams.ped_threat_distance_threshold  = ped_threat_distance_threshold ;
-	_PPRParams.ped_threat_min_time_threshold  = ped_threat_min_time_threshold ;
-	_PPRParams.ped_threat_max_time_threshold  = ped_threat_max_time_threshold ;
-	_PPRParams.ped_predictive_anticipation_factor   = ped_predictive_anticipation_factor  ;
-	_PPRParams.ped_reactive_anticipation_factor  = ped_reactive_anticipation_factor ;
-	_PPRParams.ped_crowd_influence_factor  = ped_crowd_influence_factor ;
-	_PPRParams.ped_facing_static_object_threshold  = ped_facing_static_object_threshold ;
-	_PPRParams.ped_ordinary_steering_strength  = ped_ordinary_steering_strength ;
-	_PPRParams.ped_oncoming_threat_avoidance_strength  = ped_oncoming_threat_avoidance_strength ;
-	_PPRParams.ped_cross_threat_avoidance_strength  = ped_cross_threat_avoidance_strength ;
-	_PPRParams.ped_max_turning_rate  = ped_max_turning_rate ;
-	_PPRParams.ped_feeling_crowded_threshold  = ped_feeling_crowded_threshold ;
-	_PPRParams.ped_scoot_rate   = ped_scoot_rate  ;
-	_PPRParams.ped_reached_target_distance_threshold   = ped_reached_target_distance_threshold  ;
-	_PPRParams.ped_dynamic_collision_padding  = ped_dynamic_collision_padding ;
-	_PPRParams.ped_furthest_local_target_distance  = ped_furthest_local_target_distance ;
-	_PPRParams.ped_next_waypoint_distance  = ped_next_waypoint_distance ;
-	_PPRParams.ped_max_num_waypoints  = ped_max_num_waypoints ;
-
-
 	// std::cout << "next waypoint dist = " << _PPRParams.ped_next_waypoint_distance << std::endl;
 	_midTermPath.clear();//  = new int[_PPRParams.ped_next_waypoint_distance+2];
 	_enabled = false;
 	_id=0;
+	_gEngine = NULL;
+	_aiModule = NULL;
+	_phaseSchedulerClient = -1;
 }
 
 //
@@ -89,6 +51,9 @@ PPRAgent::~PPRAgent()
 		Util::AxisAlignedBox bounds(_position.x-_radius, _position.x+_radius, 0.0f, 0.0f, _position.z-_radius, _position.z+_radius);
 		getSimulationEngine()->getSpatialDatabase()->removeObject( this, bounds);
 	}
+	if (_phaseSchedulerClient >= 0) {
+		_aiModule->_phaseScheduler.removeClient((unsigned int)_phaseSchedulerClient);
+	}
 }
 
 SteerLib::EngineInterface * PPRAgent::getSimulationEngine()
@@ -122,7 +87,7 @@ void PPRAgent::reset(const SteerLib::AgentInitialConditions & initialConditions,
 	AxisAlignedBox oldBounds(_position.x-_radius, _position.x+_radius, 0.0f, 0.0f, _position.z-_radius, _position.z+_radius);
 	_position = initialConditions.position;
 	_positionList.clear();
-	_positionList.push_back(std::pair<int, Util::Point>(getSimulationEngine()->getNumFramesSimulated(), _position));
+	_recordPosition(getSimulationEngine(), (float)getSimulationEngine()->getNumFramesSimulated(), _position);
 	_forward  = initialConditions.direction;
 	_radius   = initialConditions.radius;
 	_currentSpeed = initialConditions.speed;
@@ -202,6 +167,15 @@ void PPRAgent::reset(const SteerLib::AgentInitialConditions & initialConditions,
 	_framesToNextPredictivePhase = 1;
 	_framesToNextReactivePhase = 1;
 
+	// staggered agents get their own slot of every phase, which they keep until they are disabled.
+	if (_phaseSchedulerClient >= 0) {
+		_aiModule->_phaseScheduler.removeClient((unsigned int)_phaseSchedulerClient);
+		_phaseSchedulerClient = -1;
+	}
+	if (_aiModule->_gStaggerPhases && !_aiModule->_gUseDynamicPhaseScheduling) {
+		_phaseSchedulerClient = (int)_aiModule->_phaseScheduler.addClient();
+	}
+
 	// GEOMETRY STATE
 	// other geometry state was initialized above using the given initial conditions.
 	_rightSide = rightSideInXZPlane(_forward);
@@ -272,7 +246,7 @@ void PPRAgent::updateAI(float timeStamp, float dt, unsigned int frameNumber)
 	// std::cout << "updating PPR Agent" << std::endl;
 	if (!_enabled) return;
 
-	AutomaticFunctionProfiler profileThisFunction( &PPRGlobals::gPhaseProfilers->aiProfiler );
+	AutomaticFunctionProfiler profileThisFunction( &_aiModule->_phaseProfilers.aiProfiler, "pprAI::updateAI" );
 
 	// initialize some vars for this update step
 	// todo, this should eventually be removed after addressing the small issue with _currentFrameNumber.
@@ -286,24 +260,28 @@ void PPRAgent::updateAI(float timeStamp, float dt, unsigned int frameNumber)
 
 	if (_currentFrameNumber >= _nextFrameToRunLongTermPlanningPhase) {
 		runLongTermPlanningPhase();
+		_aiModule->_phaseScheduler.countPhase(LONG_TERM_PLANNING_PHASE, _currentFrameNumber);
 		_lastFrameLongTermWasCalled = _currentFrameNumber;
 	}
 
 
 	if (_currentFrameNumber >= _nextFrameToRunMidTermPlanningPhase) {
 		runMidTermPlanningPhase();
+		_aiModule->_phaseScheduler.countPhase(MID_TERM_PLANNING_PHASE, _currentFrameNumber);
 		_lastFrameMidTermWasCalled = _currentFrameNumber;
 	}
 
 
 	if (_currentFrameNumber >= _nextFrameToRunShortTermPlanningPhase) {
 		runShortTermPlanningPhase();
+		_aiModule->_phaseScheduler.countPhase(SHORT_TERM_PLANNING_PHASE, _currentFrameNumber);
 		_lastFrameShortTermWasCalled = _currentFrameNumber;
 	}
 
 
 	if (_currentFrameNumber >= _nextFrameToRunPerceptivePhase) {
 		runPerceptivePhase();
+		_aiModule->_phaseScheduler.countPhase(PERCEPTIVE_PHASE, _currentFrameNumber);
 		_lastFramePerceptiveWasCalled = _currentFrameNumber;
 	}
 
@@ -313,6 +291,7 @@ void PPRAgent::updateAI(float timeStamp, float dt, unsigned int frameNumber)
 		runPredictivePhase();
 
 
+		_aiModule->_phaseScheduler.countPhase(PREDICTIVE_PHASE, _currentFrameNumber);
 		_lastFramePredictiveWasCalled = _currentFrameNumber;
 	}
 
@@ -323,11 +302,12 @@ void PPRAgent::updateAI(float timeStamp, float dt, unsigned int frameNumber)
 		_finalSteeringCommand.clear();
 
 		runReactivePhase();
+		_aiModule->_phaseScheduler.countPhase(REACTIVE_PHASE, _currentFrameNumber);
 		_lastFrameReactiveWasCalled = _currentFrameNumber;
 	}
 
 		
-	if (gUseDynamicPhaseScheduling) {
+	if (_aiModule->_gUseDynamicPhaseScheduling) {
 		_nextFrameToRunLongTermPlanningPhase = _lastFrameLongTermWasCalled + _framesToNextLongTermPlanning;
 		_nextFrameToRunMidTermPlanningPhase = _lastFrameMidTermWasCalled + _framesToNextMidTermPlanning;
 		_nextFrameToRunShortTermPlanningPhase = _lastFrameShortTermWasCalled + _framesToNextShortTermPlanning;
@@ -335,13 +315,23 @@ void PPRAgent::updateAI(float timeStamp, float dt, unsigned int frameNumber)
 		_nextFrameToRunPredictivePhase = _lastFramePredictiveWasCalled + _framesToNextPredictivePhase;
 		_nextFrameToRunReactivePhase = _lastFrameReactiveWasCalled + _framesToNextReactivePhase;
 	}
+	else if (_phaseSchedulerClient >= 0) {
+		PhaseScheduler & scheduler = _aiModule->_phaseScheduler;
+		unsigned int client = (unsigned int)_phaseSchedulerClient;
+		_nextFrameToRunLongTermPlanningPhase = scheduler.getNextFrame(client, LONG_TERM_PLANNING_PHASE, _lastFrameLongTermWasCalled);
+		_nextFrameToRunMidTermPlanningPhase = scheduler.getNextFrame(client, MID_TERM_PLANNING_PHASE, _lastFrameMidTermWasCalled);
+		_nextFrameToRunShortTermPlanningPhase = scheduler.getNextFrame(client, SHORT_TERM_PLANNING_PHASE, _lastFrameShortTermWasCalled);
+		_nextFrameToRunPerceptivePhase = scheduler.getNextFrame(client, PERCEPTIVE_PHASE, _lastFramePerceptiveWasCalled);
+		_nextFrameToRunPredictivePhase = scheduler.getNextFrame(client, PREDICTIVE_PHASE, _lastFramePredictiveWasCalled);
+		_nextFrameToRunReactivePhase = scheduler.getNextFrame(client, REACTIVE_PHASE, _lastFrameReactiveWasCalled);
+	}
 	else {
-		_nextFrameToRunLongTermPlanningPhase = _lastFrameLongTermWasCalled + gLongTermPlanningPhaseInterval;
-		_nextFrameToRunMidTermPlanningPhase = _lastFrameMidTermWasCalled + gMidTermPlanningPhaseInterval;
-		_nextFrameToRunShortTermPlanningPhase = _lastFrameShortTermWasCalled + gShortTermPlanningPhaseInterval;
-		_nextFrameToRunPerceptivePhase = _lastFramePerceptiveWasCalled + gPerceptivePhaseInterval;
-		_nextFrameToRunPredictivePhase = _lastFramePredictiveWasCalled + gPredictivePhaseInterval;
-		_nextFrameToRunReactivePhase = _lastFrameReactiveWasCalled + gReactivePhaseInterval;
+		_nextFrameToRunLongTermPlanningPhase = _lastFrameLongTermWasCalled + _aiModule->_gLongTermPlanningPhaseInterval;
+		_nextFrameToRunMidTermPlanningPhase = _lastFrameMidTermWasCalled + _aiModule->_gMidTermPlanningPhaseInterval;
+		_nextFrameToRunShortTermPlanningPhase = _lastFrameShortTermWasCalled + _aiModule->_gShortTermPlanningPhaseInterval;
+		_nextFrameToRunPerceptivePhase = _lastFramePerceptiveWasCalled + _aiModule->_gPerceptivePhaseInterval;
+		_nextFrameToRunPredictivePhase = _lastFramePredictiveWasCalled + _aiModule->_gPredictivePhaseInterval;
+		_nextFrameToRunReactivePhase = _lastFrameReactiveWasCalled + _aiModule->_gReactivePhaseInterval;
 	}
 
 
@@ -349,8 +339,8 @@ void PPRAgent::updateAI(float timeStamp, float dt, unsigned int frameNumber)
 	doSteering();
 
 	// If output results, save position
-	if (_gEngine->getOptions().engineOptions.outputResults) {
-		_positionList.push_back(std::pair<float, Util::Point>(getSimulationEngine()->getClock().getCurrentSimulationTime(), _position));
+	if (_gEngine->getOptions().engineOptions.outputResults || _gEngine->getTrajectorySink()->isOpen()) {
+		_recordPosition(_gEngine, getSimulationEngine()->getClock().getCurrentSimulationTime(), _position);
 	}
 	// DrawLib::drawLine(position(), oldPosition);
 }
@@ -396,7 +386,7 @@ void PPRAgent::runLongTermPlanningPhase()
 	std::vector<Util::Point> longTermPath;
 #endif
 
-	if ( dont_plan )
+	if ( _aiModule->_dontPlan )
 	{
 		return;
 	}
@@ -410,7 +400,7 @@ void PPRAgent::runLongTermPlanningPhase()
 		if (!_enabled) return;
 	}
 
-	AutomaticFunctionProfiler profileThisFunction( &PPRGlobals::gPhaseProfilers->longTermPhaseProfiler );
+	AutomaticFunctionProfiler profileThisFunction( &_aiModule->_phaseProfilers.longTermPhaseProfiler, "pprAI::longTermPlanning" );
 
 	//==========================================================================
 
@@ -482,7 +472,7 @@ void PPRAgent::runMidTermPlanningPhase()
 {
 
 	std::vector<Util::Point> midTermPath;
-	if ( dont_plan )
+	if ( _aiModule->_dontPlan )
 	{
 		return;
 	}
@@ -496,7 +486,7 @@ void PPRAgent::runMidTermPlanningPhase()
 		if (!_enabled) return;
 	}
 
-	AutomaticFunctionProfiler profileThisFunction( &PPRGlobals::gPhaseProfilers->midTermPhaseProfiler );
+	AutomaticFunctionProfiler profileThisFunction( &_aiModule->_phaseProfilers.midTermPhaseProfiler, "pprAI::midTermPlanning" );
 
 	// if we reached the current waypoint, then increment to the next waypoint
 	if (reachedCurrentWaypoint()) {
@@ -557,7 +547,7 @@ void PPRAgent::runShortTermPlanningPhase()
 {
 	unsigned int closestPathNode;
 	if (!_enabled) return;
-	if ( dont_plan )
+	if ( _aiModule->_dontPlan )
 	{
 		// if we want to ignore planning, then just decide to steer towards the final target.
 		// possibly update the landmark target if we arrived at it.
@@ -579,7 +569,7 @@ void PPRAgent::runShortTermPlanningPhase()
 	}
 
 
-	AutomaticFunctionProfiler profileThisFunction( &PPRGlobals::gPhaseProfilers->shortTermPhaseProfiler );
+	AutomaticFunctionProfiler profileThisFunction( &_aiModule->_phaseProfilers.shortTermPhaseProfiler, "pprAI::shortTermPlanning" );
 	int myIndexPosition = getSimulationEngine()->getSpatialDatabase()->getCellIndexFromLocation(_position.x, _position.z);
 
 
@@ -697,7 +687,7 @@ void PPRAgent::runShortTermPlanningPhase()
 	}
 
 
-	if (gUseDynamicPhaseScheduling) {
+	if (_aiModule->_gUseDynamicPhaseScheduling) {
 		// decimating short-term planning
 		float distanceHeuristic = (_position - _localTargetLocation).length() - 5.0f;
 		if (distanceHeuristic <= 0.0f) {
@@ -723,10 +713,10 @@ void PPRAgent::runPerceptivePhase()
 {
 	if (!_enabled) return;
 
-	AutomaticFunctionProfiler profileThisFunction( &PPRGlobals::gPhaseProfilers->perceptivePhaseProfiler );
+	AutomaticFunctionProfiler profileThisFunction( &_aiModule->_phaseProfilers.perceptivePhaseProfiler, "pprAI::perceptivePhase" );
 	collectObjectsInVisualField();
 
-	if (gUseDynamicPhaseScheduling) {
+	if (_aiModule->_gUseDynamicPhaseScheduling) {
 		if (_currentSpeed <= 0.4f) {
 			_framesToNextPerceptivePhase = 65;
 		}
@@ -747,7 +737,7 @@ void PPRAgent::runPredictivePhase()
 {
 	if (!_enabled) return;
 
-	AutomaticFunctionProfiler profileThisFunction( &PPRGlobals::gPhaseProfilers->predictivePhaseProfiler );
+	AutomaticFunctionProfiler profileThisFunction( &_aiModule->_phaseProfilers.predictivePhaseProfiler, "pprAI::predictivePhase" );
 
 	bool threatListChanged = false;
 	bool alreadyExists = false;
@@ -790,11 +780,10 @@ void PPRAgent::runPredictivePhase()
 		//for (unsigned int i=0; i<_neighbors.size(); i++) {
 
 			// ignore items that are not AI agents.
-			if (!(*neighbor)->isAgent())
+			SteerLib::AgentInterface * otherGuy = SteerLib::asAgent(*neighbor);
+			if (otherGuy == NULL)
 				continue;
 
-			SteerLib::AgentInterface * otherGuy = dynamic_cast<SteerLib::AgentInterface *>(*neighbor);
-
 			//Vector aff = _position - otherGuy->position();
 			//if (aff.lengthlength) _numAgentsInVisualField++;
 			_numAgentsInVisualField++;
@@ -1035,7 +1024,7 @@ void PPRAgent::runReactivePhase()
 		if (!_enabled) return;
 	}
 
-	AutomaticFunctionProfiler profileThisFunction( &PPRGlobals::gPhaseProfilers->reactivePhaseProfiler );
+	AutomaticFunctionProfiler profileThisFunction( &_aiModule->_phaseProfilers.reactivePhaseProfiler, "pprAI::reactivePhase" );
 	FeelerInfo feelers;
 
 	bool comfortZoneViolated = false;
@@ -1105,9 +1094,9 @@ void PPRAgent::runReactivePhase()
 
 		// check if we hit agents that were not already in our _threatList
 		bool foundNewThreat = false;
-		if (   ((feelers.object_front) && (feelers.object_front->isAgent()) && (!threatListContainsAgent(dynamic_cast<SteerLib::AgentInterface*>(feelers.object_front))))
-			|| ((feelers.object_left) && (feelers.object_left->isAgent()) && (!threatListContainsAgent(dynamic_cast<SteerLib::AgentInterface*>(feelers.object_left))))
-			|| ((feelers.object_right) && (feelers.object_right->isAgent()) && (!threatListContainsAgent(dynamic_cast<SteerLib::AgentInterface*>(feelers.object_right)))))
+		if (   ((feelers.object_front) && (feelers.object_front->isAgent()) && (!threatListContainsAgent(SteerLib::asAgent(feelers.object_front))))
+			|| ((feelers.object_left) && (feelers.object_left->isAgent()) && (!threatListContainsAgent(SteerLib::asAgent(feelers.object_left))))
+			|| ((feelers.object_right) && (feelers.object_right->isAgent()) && (!threatListContainsAgent(SteerLib::asAgent(feelers.object_right)))))
 		{
 			foundNewThreat = true;
 		}
@@ -1116,9 +1105,9 @@ void PPRAgent::runReactivePhase()
 		// TODO: its not clear whether we should react to existing non-imminent threats or not ???
 		bool existingThreatRaisedAgain = false;
 		unsigned int tempIndex;
-		if (   ((feelers.object_front) && (feelers.object_front->isAgent()) && (threatListContainsAgent(dynamic_cast<SteerLib::AgentInterface*>(feelers.object_front), tempIndex)) && (!_threatList[tempIndex].imminent) )
-			|| ((feelers.object_left) && (feelers.object_left->isAgent()) && (threatListContainsAgent(dynamic_cast<SteerLib::AgentInterface*>(feelers.object_left), tempIndex)) && (!_threatList[tempIndex].imminent) )
-			|| ((feelers.object_right) && (feelers.object_right->isAgent()) && (threatListContainsAgent(dynamic_cast<SteerLib::AgentInterface*>(feelers.object_right), tempIndex)) && (!_threatList[tempIndex].imminent) ))
+		if (   ((feelers.object_front) && (feelers.object_front->isAgent()) && (threatListContainsAgent(SteerLib::asAgent(feelers.object_front), tempIndex)) && (!_threatList[tempIndex].imminent) )
+			|| ((feelers.object_left) && (feelers.object_left->isAgent()) && (threatListContainsAgent(SteerLib::asAgent(feelers.object_left), tempIndex)) && (!_threatList[tempIndex].imminent) )
+			|| ((feelers.object_right) && (feelers.object_right->isAgent()) && (threatListContainsAgent(SteerLib::asAgent(feelers.object_right), tempIndex)) && (!_threatList[tempIndex].imminent) ))
 		{
 			existingThreatRaisedAgain = true;
 		}
@@ -1134,7 +1123,7 @@ void PPRAgent::runReactivePhase()
 		unsigned int numAgentsNotPosingThreat = 0;
 		if ((feelers.object_front) && (feelers.object_front->isAgent())) {
 			numAgentsHit++;
-			SteerLib::AgentInterface * p = dynamic_cast<SteerLib::AgentInterface*>(feelers.object_front);
+			SteerLib::AgentInterface * p = SteerLib::asAgent(feelers.object_front);
 			Vector dV = _velocity - p->velocity();
 			Vector dO = _position - p->position();
 			float distanceThreshold = _radius + p->radius() + _PPRParams.ped_dynamic_collision_padding;
@@ -1150,7 +1139,7 @@ void PPRAgent::runReactivePhase()
 		}
 		if ((feelers.object_left) && (feelers.object_left!=feelers.object_front) && (feelers.object_left->isAgent())) {
 			numAgentsHit++;
-			SteerLib::AgentInterface * p = dynamic_cast<SteerLib::AgentInterface*>(feelers.object_left);
+			SteerLib::AgentInterface * p = SteerLib::asAgent(feelers.object_left);
 			Vector dV = _velocity - p->velocity();
 			Vector dO = _position - p->position();
 			float distanceThreshold = _radius + p->radius() + _PPRParams.ped_dynamic_collision_padding;
@@ -1166,7 +1155,7 @@ void PPRAgent::runReactivePhase()
 		}
 		if ((feelers.object_right) && (feelers.object_right!=feelers.object_front) && (feelers.object_right!=feelers.object_left) && (feelers.object_right->isAgent())) {
 			numAgentsHit++;
-			SteerLib::AgentInterface * p = dynamic_cast<SteerLib::AgentInterface*>(feelers.object_right);
+			SteerLib::AgentInterface * p = SteerLib::asAgent(feelers.object_right);
 			Vector dV = _velocity - p->velocity();
 			Vector dO = _position - p->position();
 			float distanceThreshold = _radius + p->radius() + _PPRParams.ped_dynamic_collision_padding;
@@ -1249,17 +1238,17 @@ void PPRAgent::runReactivePhase()
 			
 			// match speed:
 			if ((feelers.object_left)&&(feelers.object_left->isAgent())) {
-				float tempVelocity = dot(forward(),(dynamic_cast<SteerLib::AgentInterface*>(feelers.object_left))->velocity());
+				float tempVelocity = dot(forward(),(SteerLib::asAgent(feelers.object_left))->velocity());
 				//if (tempVelocity > -1.0f)
 					_finalSteeringCommand.targetSpeed = min(_finalSteeringCommand.targetSpeed,tempVelocity);
 			}
 			if ((feelers.object_right)&&(feelers.object_right->isAgent())) {
-				float tempVelocity = dot(forward(),(dynamic_cast<SteerLib::AgentInterface*>(feelers.object_right))->velocity());
+				float tempVelocity = dot(forward(),(SteerLib::asAgent(feelers.object_right))->velocity());
 				//if (tempVelocity > -1.0f)
 					_finalSteeringCommand.targetSpeed = min(_finalSteeringCommand.targetSpeed,tempVelocity);
 			}
 			if ((feelers.object_front)&&(feelers.object_front->isAgent())) {
-				float tempVelocity = dot(forward(),(dynamic_cast<SteerLib::AgentInterface*>(feelers.object_front))->velocity());
+				float tempVelocity = dot(forward(),(SteerLib::asAgent(feelers.object_front))->velocity());
 				//if (tempVelocity > -1.0f)
 					_finalSteeringCommand.targetSpeed = min(_finalSteeringCommand.targetSpeed,tempVelocity);
 			}
@@ -1271,7 +1260,7 @@ void PPRAgent::runReactivePhase()
 
 			SpatialDatabaseItemPtr obj = (feelers.object_front) ? feelers.object_front : (feelers.object_right) ? feelers.object_right : feelers.object_left;
 			assert(obj!=NULL);
-			SteerLib::AgentInterface * p = dynamic_cast<SteerLib::AgentInterface*>(obj);
+			SteerLib::AgentInterface * p = SteerLib::asAgent(obj);
 
 
 			float cosTheta = dot(_forward, p->forward());
@@ -1356,7 +1345,7 @@ void PPRAgent::runReactivePhase()
 				//  - you are crossing the other guy's path, you are perceived to be "in front"
 				SpatialDatabaseItemPtr obj = (feelers.object_front) ? feelers.object_front : (feelers.object_right) ? feelers.object_right : feelers.object_left;
 				assert(obj!=NULL);
-				SteerLib::AgentInterface * p = dynamic_cast<SteerLib::AgentInterface*>(obj);
+				SteerLib::AgentInterface * p = SteerLib::asAgent(obj);
 				float cosTheta = dot(_forward, p->forward());
 				if ( cosTheta < _PPRParams.ped_oncoming_reaction_threshold ) {
 					if ((feelers.object_front || feelers.object_left) && (!feelers.object_right)) {
@@ -1404,8 +1393,8 @@ void PPRAgent::runReactivePhase()
 				// feelers, especially with larger objects
 
 				// assert(objLeft!=objRight);
-				SteerLib::AgentInterface * pLeft = dynamic_cast<SteerLib::AgentInterface*>(objLeft);
-				SteerLib::AgentInterface * pRight = dynamic_cast<SteerLib::AgentInterface*>(objRight);
+				SteerLib::AgentInterface * pLeft = SteerLib::asAgent(objLeft);
+				SteerLib::AgentInterface * pRight = SteerLib::asAgent(objRight);
 				float cosThetaLeft = dot(_forward, pLeft->forward());
 				float cosThetaRight = dot(_forward, pRight->forward());
 				if ((cosThetaLeft < _PPRParams.ped_oncoming_reaction_threshold) && (cosThetaRight < _PPRParams.ped_oncoming_reaction_threshold)) {
@@ -1485,7 +1474,7 @@ void PPRAgent::runReactivePhase()
 				SpatialDatabaseItemPtr objAgent = (feelers.object_front && feelers.object_front->isAgent()) ? feelers.object_front : (feelers.object_right && feelers.object_right->isAgent()) ? feelers.object_right : feelers.object_left;
 				SpatialDatabaseItemPtr obstacle = (feelers.object_front && !feelers.object_front->isAgent()) ? feelers.object_front : (feelers.object_right && !feelers.object_right->isAgent()) ? feelers.object_right : feelers.object_left;
 
-				SteerLib::AgentInterface * p = dynamic_cast<SteerLib::AgentInterface*>(objAgent);
+				SteerLib::AgentInterface * p = SteerLib::asAgent(objAgent);
 
 				if ( dot(p->forward(), _forward) < _PPRParams.ped_oncoming_reaction_threshold ) {
 					if (obstacle == feelers.object_right) {
@@ -1547,15 +1536,15 @@ void PPRAgent::runReactivePhase()
 				//SteerLib::AgentInterface * pRight = dynamic_cast<SteerLib::AgentInterface*>(feelers.object_right);
 				//if (isSelected()) cerr << "REACTION: three agents - I'll just match their speed and hope it doesnt get clogged?\n";
 				if ((feelers.object_left)&&(feelers.object_left->isAgent())) {
-					float tempVelocity = dot(forward(),(dynamic_cast<SteerLib::AgentInterface*>(feelers.object_left))->velocity());
+					float tempVelocity = dot(forward(),(SteerLib::asAgent(feelers.object_left))->velocity());
 					_finalSteeringCommand.targetSpeed = min(_finalSteeringCommand.targetSpeed,tempVelocity);
 				}
 				if ((feelers.object_right)&&(feelers.object_right->isAgent())) {
-					float tempVelocity = dot(forward(),(dynamic_cast<SteerLib::AgentInterface*>(feelers.object_right))->velocity());
+					float tempVelocity = dot(forward(),(SteerLib::asAgent(feelers.object_right))->velocity());
 					_finalSteeringCommand.targetSpeed = min(_finalSteeringCommand.targetSpeed,tempVelocity);
 				}
 				if ((feelers.object_front)&&(feelers.object_front->isAgent())) {
-					float tempVelocity = dot(forward(),(dynamic_cast<SteerLib::AgentInterface*>(feelers.object_front))->velocity());
+					float tempVelocity = dot(forward(),(SteerLib::asAgent(feelers.object_front))->velocity());
 					_finalSteeringCommand.targetSpeed = min(_finalSteeringCommand.targetSpeed,tempVelocity);
 				}
 				if (comfortZoneViolated) {
@@ -1572,15 +1561,15 @@ void PPRAgent::runReactivePhase()
 				SpatialDatabaseItemPtr obstacle = (feelers.object_front && !feelers.object_front->isAgent()) ? feelers.object_front : (feelers.object_right && !feelers.object_right->isAgent()) ? feelers.object_right : feelers.object_left;
 
 				if ((feelers.object_left)&&(feelers.object_left->isAgent())) {
-					float tempVelocity = dot(forward(),(dynamic_cast<SteerLib::AgentInterface*>(feelers.object_left))->velocity());
+					float tempVelocity = dot(forward(),(SteerLib::asAgent(feelers.object_left))->velocity());
 					_finalSteeringCommand.targetSpeed = min(_finalSteeringCommand.targetSpeed,tempVelocity);
 				}
 				if ((feelers.object_right)&&(feelers.object_right->isAgent())) {
-					float tempVelocity = dot(forward(),(dynamic_cast<SteerLib::AgentInterface*>(feelers.object_right))->velocity());
+					float tempVelocity = dot(forward(),(SteerLib::asAgent(feelers.object_right))->velocity());
 					_finalSteeringCommand.targetSpeed = min(_finalSteeringCommand.targetSpeed,tempVelocity);
 				}
 				if ((feelers.object_front)&&(feelers.object_front->isAgent())) {
-					float tempVelocity = dot(forward(),(dynamic_cast<SteerLib::AgentInterface*>(feelers.object_front))->velocity());
+					float tempVelocity = dot(forward(),(SteerLib::asAgent(feelers.object_front))->velocity());
 					_finalSteeringCommand.targetSpeed = min(_finalSteeringCommand.targetSpeed,tempVelocity);
 				}
 				if (comfortZoneViolated) {
@@ -1731,12 +1720,12 @@ void PPRAgent::runReactivePhase()
 		}
 		_finalSteeringCommand.aimForTargetDirection = true;
 		_finalSteeringCommand.aimForTargetSpeed = true;
-		_finalSteeringCommand.targetSpeed = ped_typical_speed_factor*_currentGoal.desiredSpeed;
+		_finalSteeringCommand.targetSpeed = _aiModule->_PPRParams.ped_typical_speed_factor*_currentGoal.desiredSpeed;
 	}
 
 	_finalSteeringCommand.steeringMode = SteeringCommand::LOCOMOTION_MODE_COMMAND;
 
-	if (gUseDynamicPhaseScheduling) {
+	if (_aiModule->_gUseDynamicPhaseScheduling) {
 	
 		// potentially give a break to perception
 		if (hitSomething) {
@@ -1773,7 +1762,7 @@ void PPRAgent::doSteering()
 {
 	if (!_enabled) return;
 
-	AutomaticFunctionProfiler profileThisFunction( &PPRGlobals::gPhaseProfilers->steeringPhaseProfiler );
+	AutomaticFunctionProfiler profileThisFunction( &_aiModule->_phaseProfilers.steeringPhaseProfiler, "pprAI::steeringPhase" );
 
 	switch ( _finalSteeringCommand.steeringMode) {
 		case SteeringCommand::LOCOMOTION_MODE_COMMAND:
@@ -2024,26 +2013,29 @@ bool PPRAgent::threatListContainsAgent(SteerLib::AgentInterface * agent, unsigne
 //
 bool PPRAgent::updateReactiveFeelers( FeelerInfo & feelers )
 {
-	// TODO: would it be faster to use one ray and just keep re-initializing it?
-
 	Ray myRay, myLeftRay, myRightRay, myLSideRay, myRSideRay;
 
 	feelers.clear();
 
 	// Adjusting feeler length to compensate for issues with pprAI not being able to choose which direction to turn and
 	// proceeding through an obstacle. SHould make these parameters.
-	myRay.initWithLengthInterval(_position, _forward * (_PPRParams.ped_typical_speed*ped_reactive_anticipation_factor) * 1.1f);
+	myRay.initWithLengthInterval(_position, _forward * (_PPRParams.ped_typical_speed*_aiModule->_PPRParams.ped_reactive_anticipation_factor) * 1.1f);
 	myRightRay.initWithLengthInterval( _position + _radius * _rightSide ,  ((_forward * 0.75f) + 0.1f*_rightSide)* (_PPRParams.ped_typical_speed*_PPRParams.ped_reactive_anticipation_factor));
 	myLeftRay.initWithLengthInterval( _position - _radius * _rightSide,  ((_forward * 0.75f) - 0.1f*_rightSide)* (_PPRParams.ped_typical_speed*_PPRParams.ped_reactive_anticipation_factor));
 	myRSideRay.initWithLengthInterval( _position + _radius * _rightSide,  (0.05f * _forward + 0.1f * _rightSide)* (_PPRParams.ped_typical_speed*_PPRParams.ped_reactive_anticipation_factor));
 	myLSideRay.initWithLengthInterval( _position - _radius * _rightSide,  (0.05f * _forward - 0.1f * _rightSide)* (_PPRParams.ped_typical_speed*_PPRParams.ped_reactive_anticipation_factor));
 
 	SpatialDatabaseItemPtr me = dynamic_cast<SpatialDatabaseItemPtr>(this);
-	getSimulationEngine()->getSpatialDatabase()->trace(myRay,      feelers.t_front, feelers.object_front, me, false);
-	getSimulationEngine()->getSpatialDatabase()->trace(myRightRay, feelers.t_right, feelers.object_right, me, false);
-	getSimulationEngine()->getSpatialDatabase()->trace(myLeftRay,  feelers.t_left,  feelers.object_left,  me, false);
-	getSimulationEngine()->getSpatialDatabase()->trace(myRSideRay, feelers.t_rside, feelers.object_rside, me, false);
-	getSimulationEngine()->getSpatialDatabase()->trace(myLSideRay, feelers.t_lside, feelers.object_lside, me, false);
+	// the five feelers start next to each other, so trace them as one packet.
+	Ray feelerRays[5] = { myRay, myRightRay, myLeftRay, myRSideRay, myLSideRay };
+	float feelerT[5] = { feelers.t_front, feelers.t_right, feelers.t_left, feelers.t_rside, feelers.t_lside };
+	SpatialDatabaseItemPtr feelerObjects[5];
+	getSimulationEngine()->getSpatialDatabase()->tracePacket(feelerRays, 5, feelerT, feelerObjects, me, false);
+	feelers.t_front = feelerT[0];  feelers.object_front = feelerObjects[0];
+	feelers.t_right = feelerT[1];  feelers.object_right = feelerObjects[1];
+	feelers.t_left  = feelerT[2];  feelers.object_left  = feelerObjects[2];
+	feelers.t_rside = feelerT[3];  feelers.object_rside = feelerObjects[3];
+	feelers.t_lside = feelerT[4];  feelers.object_lside = feelerObjects[4];
 
 #ifdef USE_ANNOTATIONS
 	__myRay = myRay;
@@ -2084,6 +2076,150 @@ void PPRAgent::disable()
 
 	//  2. set enabled = false
 	_enabled = false;
+
+	//  3. give up its phase slots to the other agents
+	if (_phaseSchedulerClient >= 0) {
+		_aiModule->_phaseScheduler.removeClient((unsigned int)_phaseSchedulerClient);
+		_phaseSchedulerClient = -1;
+	}
+}
+
+
+//
+// saveState() and restoreState()
+//
+// PPRParameters and the values derived from them in reset() are configuration, and are not part of a checkpoint.
+//
+void PPRAgent::saveState(SteerLib::CheckpointWriter & out)
+{
+	AgentInterface::saveState(out);
+
+	out.write(_currentWaypointIndex);
+	out.writeSequence(_midTermPath);
+	out.write(_midTermPathSize);
+	out.write(_localTargetLocation);
+
+	// the predictive phase only looks at the agents in the visual field, so static objects are not saved.
+	std::vector<SteerLib::AgentInterface*> neighborAgents;
+	for (std::set<SteerLib::SpatialDatabaseItemPtr>::iterator neighbor = _neighbors.begin(); neighbor != _neighbors.end(); ++neighbor) {
+		if (SteerLib::AgentInterface * agent = SteerLib::asAgent(*neighbor)) {
+			neighborAgents.push_back(agent);
+		}
+	}
+	out.write<unsigned int>((unsigned int)neighborAgents.size());
+	for (unsigned int i=0; i < neighborAgents.size(); i++) {
+		out.writeAgentReference(neighborAgents[i]);
+	}
+	out.write(_numAgentsInVisualField);
+
+	out.write(_timeToWait);
+	out.write(_minThreatTime);
+	out.write(_maxThreatTime);
+	out.write(_mostImminentThreatIndex);
+	out.write<unsigned int>((unsigned int)_threatList.size());
+	for (unsigned int i=0; i < _threatList.size(); i++) {
+		out.writeAgentReference(_threatList[i].threatGuy);
+		out.write(_threatList[i].minTime);
+		out.write(_threatList[i].maxTime);
+		out.write(_threatList[i].originalMaxTime);
+		out.write(_threatList[i].threatType);
+		out.write(_threatList[i].imminent);
+		out.write(_threatList[i].oncomingToRightSide);
+	}
+	out.write(_crowdControlDirection);
+	out.write(_steeringState);
+
+	out.write(_finalSteeringCommand);
+
+	out.write(_nextFrameToRunLongTermPlanningPhase);
+	out.write(_nextFrameToRunMidTermPlanningPhase);
+	out.write(_nextFrameToRunShortTermPlanningPhase);
+	out.write(_nextFrameToRunPerceptivePhase);
+	out.write(_nextFrameToRunPredictivePhase);
+	out.write(_nextFrameToRunReactivePhase);
+	out.write(_lastFrameLongTermWasCalled);
+	out.write(_lastFrameMidTermWasCalled);
+	out.write(_lastFrameShortTermWasCalled);
+	out.write(_lastFramePerceptiveWasCalled);
+	out.write(_lastFramePredictiveWasCalled);
+	out.write(_lastFrameReactiveWasCalled);
+	out.write(_framesToNextLongTermPlanning);
+	out.write(_framesToNextMidTermPlanning);
+	out.write(_framesToNextShortTermPlanning);
+	out.write(_framesToNextPerceptivePhase);
+	out.write(_framesToNextPredictivePhase);
+	out.write(_framesToNextReactivePhase);
+	out.write(_phaseSchedulerClient);
+
+	out.write(_rightSide);
+	out.write(_currentSpeed);
+	out.write(_currentTimeStamp);
+	out.write(_dt);
+	out.write(_currentFrameNumber);
+	out.writeGoal(_currentGoal);
+}
+
+void PPRAgent::restoreState(SteerLib::CheckpointReader & in)
+{
+	AgentInterface::restoreState(in);
+
+	in.read(_currentWaypointIndex);
+	in.readSequence(_midTermPath);
+	in.read(_midTermPathSize);
+	in.read(_localTargetLocation);
+
+	_neighbors.clear();
+	unsigned int numNeighbors = in.read<unsigned int>();
+	for (unsigned int i=0; i < numNeighbors; i++) {
+		_neighbors.insert(in.readAgentReference());
+	}
+	in.read(_numAgentsInVisualField);
+
+	in.read(_timeToWait);
+	in.read(_minThreatTime);
+	in.read(_maxThreatTime);
+	in.read(_mostImminentThreatIndex);
+	_threatList.resize(in.read<unsigned int>());
+	for (unsigned int i=0; i < _threatList.size(); i++) {
+		_threatList[i].threatGuy = in.readAgentReference();
+		in.read(_threatList[i].minTime);
+		in.read(_threatList[i].maxTime);
+		in.read(_threatList[i].originalMaxTime);
+		in.read(_threatList[i].threatType);
+		in.read(_threatList[i].imminent);
+		in.read(_threatList[i].oncomingToRightSide);
+	}
+	in.read(_crowdControlDirection);
+	in.read(_steeringState);
+
+	in.read(_finalSteeringCommand);
+
+	in.read(_nextFrameToRunLongTermPlanningPhase);
+	in.read(_nextFrameToRunMidTermPlanningPhase);
+	in.read(_nextFrameToRunShortTermPlanningPhase);
+	in.read(_nextFrameToRunPerceptivePhase);
+	in.read(_nextFrameToRunPredictivePhase);
+	in.read(_nextFrameToRunReactivePhase);
+	in.read(_lastFrameLongTermWasCalled);
+	in.read(_lastFrameMidTermWasCalled);
+	in.read(_lastFrameShortTermWasCalled);
+	in.read(_lastFramePerceptiveWasCalled);
+	in.read(_lastFramePredictiveWasCalled);
+	in.read(_lastFrameReactiveWasCalled);
+	in.read(_framesToNextLongTermPlanning);
+	in.read(_framesToNextMidTermPlanning);
+	in.read(_framesToNextShortTermPlanning);
+	in.read(_framesToNextPerceptivePhase);
+	in.read(_framesToNextPredictivePhase);
+	in.read(_framesToNextReactivePhase);
+	in.read(_phaseSchedulerClient);
+
+	in.read(_rightSide);
+	in.read(_currentSpeed);
+	in.read(_currentTimeStamp);
+	in.read(_dt);
+	in.read(_currentFrameNumber);
+	in.readGoal(_currentGoal);
 }
 
 // Overrides base finished() method, required to run from command line
@@ -2110,7 +2246,7 @@ void PPRAgent::drawPlannedPath()
 
 #ifdef ENABLE_GUI
 #ifdef USE_ANNOTATIONS
-if (dont_plan == false)
+if (_aiModule->_dontPlan == false)
 {
 
 #ifdef _WIN32
@@ -2205,7 +2341,7 @@ void PPRAgent::draw()
 	AgentInterface::draw();
 #ifdef ENABLE_GUI
 	if (!_enabled) return;
-	AutomaticFunctionProfiler profileThisFunction( &PPRGlobals::gPhaseProfilers->drawProfiler );
+	AutomaticFunctionProfiler profileThisFunction( &_aiModule->_phaseProfilers.drawProfiler, "pprAI::draw" );
 
 	/*
 	std::cout << "max speed is " << _PPRParams.ped_max_speed << " and quert radius is " <<
@@ -33,68 +33,24 @@ namespace ReactiveGlobals {
 		Util::PerformanceProfiler steeringPhaseProfiler;
 	};
 
-
-	extern SteerLib::EngineInterface * gEngineInfo;
-	extern SteerLib::GridDatabase2D * gSpatialDatabase;
-	extern unsigned int gLongTermPlanningPhaseInterval;
-	extern unsigned int gMidTermPlanningPhaseInterval;
-	extern unsigned int gShortTermPlanningPhaseInterval;
-	extern unsigned int gPredictivePhaseInterval;
-	extern unsigned int gReactivePhaseInterval;
-	extern unsigned int gPerceptivePhaseInterval;
-	extern bool gUseDynamicPhaseScheduling;
-	extern bool gShowStats;
-	extern bool gShowAllStats;
-
-
-	// Adding a bunch of parameters so they can be changed via input
-	extern float ped_max_speed;
-	extern float ped_typical_speed ;
-	extern float ped_max_force  ;
-	extern float ped_max_speed_factor  ;
-	extern float ped_faster_speed_factor ;
-	extern float ped_slightly_faster_speed_factor;
-	extern float ped_typical_speed_factor   ;
-	extern float ped_slightly_slower_speed_factor;
-	extern float ped_slower_speed_factor;
-	extern float ped_cornering_turn_rate;
-	extern float ped_adjustment_turn_rate;
-	extern float ped_faster_avoidance_turn_rate;
-	extern float ped_typical_avoidance_turn_rate;
-	extern float ped_braking_rate ;
-	extern float ped_comfort_zone   ;
-	extern float ped_query_radius  ;
-	extern float ped_similar_direction_dot_product_threshold;
-	extern float ped_same_direction_dot_product_threshold;
-	extern float ped_oncoming_prediction_threshold;
-	extern float ped_oncoming_reaction_threshold;
-	extern float ped_wrong_direction_dot_product_threshold;
-	extern float ped_threat_distance_threshold;
-	extern float ped_threat_min_time_threshold;
-	extern float ped_threat_max_time_threshold;
-	extern float ped_predictive_anticipation_factor ;
-	extern float ped_reactive_anticipation_factor;
-	extern float ped_crowd_influence_factor;
-	extern float ped_facing_static_object_threshold;
-	extern float ped_ordinary_steering_strength;
-	extern float ped_oncoming_threat_avoidance_strength;
-	extern float ped_cross_threat_avoidance_strength;
-	extern float ped_max_turning_rate;
-	extern int ped_feeling_crowded_threshold;
-	extern float ped_scoot_rate ;
-	extern float ped_reached_target_distance_threshold ;
-	extern float ped_dynamic_collision_padding;
-	extern int ped_furthest_local_target_distance;
-	extern int ped_next_waypoint_distance;
-	extern int ped_max_num_waypoints;
-
-
-	extern PhaseProfilers * gPhaseProfilers;
+	/// The phases of an agent, as numbered in the module's SteerLib::PhaseScheduler.
+	enum Phase {
+		LONG_TERM_PLANNING_PHASE = 0,
+		MID_TERM_PLANNING_PHASE,
+		SHORT_TERM_PLANNING_PHASE,
+		PERCEPTIVE_PHASE,
+		PREDICTIVE_PHASE,
+		REACTIVE_PHASE,
+		NUM_PHASES
+	};
 }
 
 class ReactiveAIModule : public SteerLib::ModuleInterface
 {
 public:
+	ReactiveAIModule();
+	/// Closes the module's log, see LogManager::destroyLogger().
+	~ReactiveAIModule();
 	
 	// removing test case dependency for the purpose of automatic scenario generation
 	//std::string getDependencies() { return "testCasePlayer"; }
@@ -105,16 +61,44 @@ public:
 	LogData * getLogData() { return new LogData(); }
 	void init( const SteerLib::OptionDictionary & options, SteerLib::EngineInterface * engineInfo );
 	void finish();
-	SteerLib::AgentInterface * createAgent() { return new ReactiveAgent; }
+	SteerLib::AgentInterface * createAgent();
 	void destroyAgent( SteerLib::AgentInterface * agent ) { if (agent) delete agent;  agent = NULL; }
 
 	void initializeSimulation();
 	void cleanupSimulation();
 
+	void saveState(SteerLib::CheckpointWriter & out);
+	void restoreState(SteerLib::CheckpointReader & in);
+
 private:
 	std::string logFilename;
+	bool logStats;
 	Logger * _pprLogger;
 
+	SteerLib::EngineInterface * _gEngine;
+	SteerLib::GridDatabase2D * _gSpatialDatabase;
+
+	unsigned int _gLongTermPlanningPhaseInterval;
+	unsigned int _gMidTermPlanningPhaseInterval;
+	unsigned int _gShortTermPlanningPhaseInterval;
+	unsigned int _gPredictivePhaseInterval;
+	unsigned int _gReactivePhaseInterval;
+	unsigned int _gPerceptivePhaseInterval;
+	bool _gUseDynamicPhaseScheduling;
+	/// If true, the phases with intervals longer than one frame are staggered across agents by _phaseScheduler, instead of
+	/// running for every agent on the same frames; ignored with dynamic phase scheduling.
+	bool _gStaggerPhases;
+	bool _gShowStats;
+	bool _gShowAllStats;
+
+	/// The parameters given to the module; every new agent starts with a copy of these.
+	ReactiveParameters _ReactiveParams;
+	/// The profilers shared by all agents of this module.
+	ReactiveGlobals::PhaseProfilers _phaseProfilers;
+	/// Staggers the phases of the agents when _gStaggerPhases is set, and counts the phases run on every frame.
+	SteerLib::PhaseScheduler _phaseScheduler;
+
+	friend class ReactiveAgent;
 };
 
 
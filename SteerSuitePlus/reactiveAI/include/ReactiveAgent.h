@@ -15,7 +15,7 @@
 
 // #define USE_ANNOTATIONS
 
-#define AGENT_PTR(agent) (dynamic_cast<AgentInterface*>(agent))
+#define AGENT_PTR(agent) (SteerLib::asAgent(agent))
 
 
 //======================================================================================
@@ -24,11 +24,7 @@
 
 class ReactiveAgent;
 
-namespace ReactiveGlobals {
-	// NOTE this is forward declared for an inline function defined below
-	// other declarations for this namespace belong in PPRAIModule.h
-	extern SteerLib::EngineInterface * gEngineInfo;
-}
+class ReactiveAIModule;
 
 
 //======================================================================================
@@ -135,7 +131,7 @@ public:
 	Util::Point localTargetLocation() { return _localTargetLocation; }
 	Util::Vector localTargetDirection() { return _finalSteeringCommand.targetDirection; }
 	bool isSelected() { 
-		return ReactiveGlobals::gEngineInfo->isAgentSelected(this);
+		return _gEngine->isAgentSelected(this);
 	}
 
 
@@ -228,6 +224,9 @@ protected:
 	unsigned int _framesToNextPredictivePhase;
 	unsigned int _framesToNextReactivePhase;
 
+	// this agent's client in the module's phase scheduler, or -1 if it is not registered.
+	int _phaseSchedulerClient;
+
 
 	// GEOMETRY STATE of the agent (can potentially change per frame)
 	float _radius;
@@ -281,6 +280,13 @@ protected:
 	std::stack<unsigned int> longTermPath; // Should be changed to vectors
 #endif
 
+	SteerLib::EngineInterface * _gEngine;
+	SteerLib::GridDatabase2D * _gSpatialDatabase;
+	/// The module that created this agent; its phase intervals and profilers are shared by all of its agents.
+	ReactiveAIModule * _aiModule;
+	ReactiveParameters _ReactiveParams;
+
+	friend class ReactiveAIModule;
 };
 
 
@@ -115,5 +115,50 @@
 #define PED_MAX_NUM_WAYPOINTS 20
 
 
+/// The tunable parameters of a ReactiveAgent; the ReactiveAIModule initializes them from the PED_* constants and its options.
+class ReactiveParameters
+{
+public:
+	float ped_max_speed;
+	float ped_typical_speed ;
+	float ped_max_force  ;
+	float ped_max_speed_factor  ;
+	float ped_faster_speed_factor ;
+	float ped_slightly_faster_speed_factor;
+	float ped_typical_speed_factor   ;
+	float ped_slightly_slower_speed_factor;
+	float ped_slower_speed_factor;
+	float ped_cornering_turn_rate;
+	float ped_adjustment_turn_rate;
+	float ped_faster_avoidance_turn_rate;
+	float ped_typical_avoidance_turn_rate;
+	float ped_braking_rate ;
+	float ped_comfort_zone   ;
+	float ped_query_radius  ;
+	float ped_similar_direction_dot_product_threshold;
+	float ped_same_direction_dot_product_threshold;
+	float ped_oncoming_prediction_threshold;
+	float ped_oncoming_reaction_threshold;
+	float ped_wrong_direction_dot_product_threshold;
+	float ped_threat_distance_threshold;
+	float ped_threat_min_time_threshold;
+	float ped_threat_max_time_threshold;
+	float ped_predictive_anticipation_factor ;
+	float ped_reactive_anticipation_factor;
+	float ped_crowd_influence_factor;
+	float ped_facing_static_object_threshold;
+	float ped_ordinary_steering_strength;
+	float ped_oncoming_threat_avoidance_strength;
+	float ped_cross_threat_avoidance_strength;
+	float ped_max_turning_rate;
+	int ped_feeling_crowded_threshold;
+	float ped_scoot_rate ;
+	float ped_reached_target_distance_threshold ;
+	float ped_dynamic_collision_padding;
+	int ped_furthest_local_target_distance;
+	int ped_next_waypoint_distance;
+	int ped_max_num_waypoints;
+};
+
 
 #endif
@@ -32,6 +32,10 @@ using std::min;
 ReactiveAgent::ReactiveAgent()
 {
 	_enabled = false;
+	_gEngine = NULL;
+	_gSpatialDatabase = NULL;
+	_aiModule = NULL;
+	_phaseSchedulerClient = -1;
 }
 
 
@@ -43,7 +47,10 @@ ReactiveAgent::~ReactiveAgent()
 {
 	if (_enabled) {
 		Util::AxisAlignedBox bounds(_position.x-_radius, _position.x+_radius, 0.0f, 0.0f, _position.z-_radius, _position.z+_radius);
-		gSpatialDatabase->removeObject( this, bounds);
+		_gSpatialDatabase->removeObject( this, bounds);
+	}
+	if (_phaseSchedulerClient >= 0) {
+		_aiModule->_phaseScheduler.removeClient((unsigned int)_phaseSchedulerClient);
 	}
 }
 
@@ -64,10 +71,10 @@ void ReactiveAgent::reset(const SteerLib::AgentInitialConditions & initialCondit
 
 
 	if (!_enabled) {
-		gSpatialDatabase->addObject( dynamic_cast<SpatialDatabaseItemPtr>(this), newBounds);
+		_gSpatialDatabase->addObject( dynamic_cast<SpatialDatabaseItemPtr>(this), newBounds);
 	}
 	else {
-		gSpatialDatabase->updateObject( dynamic_cast<SpatialDatabaseItemPtr>(this), oldBounds, newBounds);
+		_gSpatialDatabase->updateObject( dynamic_cast<SpatialDatabaseItemPtr>(this), oldBounds, newBounds);
 	}
 	_enabled = true;
 
@@ -135,6 +142,15 @@ void ReactiveAgent::reset(const SteerLib::AgentInitialConditions & initialCondit
 	_framesToNextPredictivePhase = 1;
 	_framesToNextReactivePhase = 1;
 
+	// staggered agents get their own slot of every phase, which they keep until they are disabled.
+	if (_phaseSchedulerClient >= 0) {
+		_aiModule->_phaseScheduler.removeClient((unsigned int)_phaseSchedulerClient);
+		_phaseSchedulerClient = -1;
+	}
+	if (_aiModule->_gStaggerPhases && !_aiModule->_gUseDynamicPhaseScheduling) {
+		_phaseSchedulerClient = (int)_aiModule->_phaseScheduler.addClient();
+	}
+
 	// GEOMETRY STATE
 	// other geometry state was initialized above using the given initial conditions.
 	_rightSide = rightSideInXZPlane(_forward);
@@ -142,8 +158,8 @@ void ReactiveAgent::reset(const SteerLib::AgentInitialConditions & initialCondit
 	// PHYSICS STATE
 	_velocity = normalize(_forward) * _currentSpeed;
 	_mass = 1.0f;
-	_maxSpeed = ped_max_speed; //  PED_MAX_SPEED;
-	_maxForce = ped_max_force;
+	_maxSpeed = _ReactiveParams.ped_max_speed; //  PED_MAX_SPEED;
+	_maxForce = _ReactiveParams.ped_max_force;
 	// currentSpeed was initialized above.
 
 	// these will be removed soon.
@@ -190,7 +206,7 @@ void ReactiveAgent::addGoal(const SteerLib::AgentGoalInfo & newGoal) {
 		if (_currentGoal.targetIsRandom) {
 
 			SteerLib::AgentGoalInfo _goal;
-			_goal.targetLocation = gSpatialDatabase->randomPositionWithoutCollisions(1.0f, true);
+			_goal.targetLocation = _gSpatialDatabase->randomPositionWithoutCollisions(1.0f, true);
 			_goalQueue.push(_goal);
 			_currentGoal.targetLocation = _goal.targetLocation;
 		}
@@ -207,7 +223,7 @@ void ReactiveAgent::updateAI(float timeStamp, float dt, unsigned int frameNumber
 
 	if (!_enabled) return;
 
-	AutomaticFunctionProfiler profileThisFunction( &ReactiveGlobals::gPhaseProfilers->aiProfiler );
+	AutomaticFunctionProfiler profileThisFunction( &_aiModule->_phaseProfilers.aiProfiler, "reactiveAI::updateAI" );
 
 	Util::Point oldPosition = position();
 
@@ -264,11 +280,12 @@ void ReactiveAgent::updateAI(float timeStamp, float dt, unsigned int frameNumber
 		_finalSteeringCommand.clear();
 
 		runReactivePhase();
+		_aiModule->_phaseScheduler.countPhase(REACTIVE_PHASE, _currentFrameNumber);
 		_lastFrameReactiveWasCalled = _currentFrameNumber;
 	}
 
 		
-	if (gUseDynamicPhaseScheduling) {
+	if (_aiModule->_gUseDynamicPhaseScheduling) {
 		_nextFrameToRunLongTermPlanningPhase = _lastFrameLongTermWasCalled + _framesToNextLongTermPlanning;
 		_nextFrameToRunMidTermPlanningPhase = _lastFrameMidTermWasCalled + _framesToNextMidTermPlanning;
 		_nextFrameToRunShortTermPlanningPhase = _lastFrameShortTermWasCalled + _framesToNextShortTermPlanning;
@@ -276,13 +293,23 @@ void ReactiveAgent::updateAI(float timeStamp, float dt, unsigned int frameNumber
 		_nextFrameToRunPredictivePhase = _lastFramePredictiveWasCalled + _framesToNextPredictivePhase;
 		_nextFrameToRunReactivePhase = _lastFrameReactiveWasCalled + _framesToNextReactivePhase;
 	}
+	else if (_phaseSchedulerClient >= 0) {
+		PhaseScheduler & scheduler = _aiModule->_phaseScheduler;
+		unsigned int client = (unsigned int)_phaseSchedulerClient;
+		_nextFrameToRunLongTermPlanningPhase = scheduler.getNextFrame(client, LONG_TERM_PLANNING_PHASE, _lastFrameLongTermWasCalled);
+		_nextFrameToRunMidTermPlanningPhase = scheduler.getNextFrame(client, MID_TERM_PLANNING_PHASE, _lastFrameMidTermWasCalled);
+		_nextFrameToRunShortTermPlanningPhase = scheduler.getNextFrame(client, SHORT_TERM_PLANNING_PHASE, _lastFrameShortTermWasCalled);
+		_nextFrameToRunPerceptivePhase = scheduler.getNextFrame(client, PERCEPTIVE_PHASE, _lastFramePerceptiveWasCalled);
+		_nextFrameToRunPredictivePhase = scheduler.getNextFrame(client, PREDICTIVE_PHASE, _lastFramePredictiveWasCalled);
+		_nextFrameToRunReactivePhase = scheduler.getNextFrame(client, REACTIVE_PHASE, _lastFrameReactiveWasCalled);
+	}
 	else {
-		_nextFrameToRunLongTermPlanningPhase = _lastFrameLongTermWasCalled + gLongTermPlanningPhaseInterval;
-		_nextFrameToRunMidTermPlanningPhase = _lastFrameMidTermWasCalled + gMidTermPlanningPhaseInterval;
-		_nextFrameToRunShortTermPlanningPhase = _lastFrameShortTermWasCalled + gShortTermPlanningPhaseInterval;
-		_nextFrameToRunPerceptivePhase = _lastFramePerceptiveWasCalled + gPerceptivePhaseInterval;
-		_nextFrameToRunPredictivePhase = _lastFramePredictiveWasCalled + gPredictivePhaseInterval;
-		_nextFrameToRunReactivePhase = _lastFrameReactiveWasCalled + gReactivePhaseInterval;
+		_nextFrameToRunLongTermPlanningPhase = _lastFrameLongTermWasCalled + _aiModule->_gLongTermPlanningPhaseInterval;
+		_nextFrameToRunMidTermPlanningPhase = _lastFrameMidTermWasCalled + _aiModule->_gMidTermPlanningPhaseInterval;
+		_nextFrameToRunShortTermPlanningPhase = _lastFrameShortTermWasCalled + _aiModule->_gShortTermPlanningPhaseInterval;
+		_nextFrameToRunPerceptivePhase = _lastFramePerceptiveWasCalled + _aiModule->_gPerceptivePhaseInterval;
+		_nextFrameToRunPredictivePhase = _lastFramePredictiveWasCalled + _aiModule->_gPredictivePhaseInterval;
+		_nextFrameToRunReactivePhase = _lastFrameReactiveWasCalled + _aiModule->_gReactivePhaseInterval;
 	}
 
 
@@ -318,7 +345,7 @@ void ReactiveAgent::runCognitivePhase()
 	// if the goal asks for a random target, then randomly assign the target location
 	if (_currentGoal.targetIsRandom) {
 		AxisAlignedBox aab = AxisAlignedBox(-100.0f, 100.0f, 0.0f, 0.0f, -100.0f, 100.0f);
-		_currentGoal.targetLocation = gSpatialDatabase->randomPositionInRegionWithoutCollisions(aab, 1.0f, true);
+		_currentGoal.targetLocation = _gSpatialDatabase->randomPositionInRegionWithoutCollisions(aab, 1.0f, true);
 	}
 }
 
@@ -346,17 +373,17 @@ void ReactiveAgent::runLongTermPlanningPhase()
 		if (!_enabled) return;
 	}
 
-	AutomaticFunctionProfiler profileThisFunction( &ReactiveGlobals::gPhaseProfilers->longTermPhaseProfiler );
+	AutomaticFunctionProfiler profileThisFunction( &_aiModule->_phaseProfilers.longTermPhaseProfiler, "reactiveAI::longTermPlanning" );
 
 	//==========================================================================
 
-	int myIndexPosition = gSpatialDatabase->getCellIndexFromLocation(_position);
-	int goalIndex = gSpatialDatabase->getCellIndexFromLocation(_currentGoal.targetLocation);
+	int myIndexPosition = _gSpatialDatabase->getCellIndexFromLocation(_position);
+	int goalIndex = _gSpatialDatabase->getCellIndexFromLocation(_currentGoal.targetLocation);
 
 	if (myIndexPosition != -1) {
 
 		// run the main a-star search here
-		gSpatialDatabase->planPath(myIndexPosition, goalIndex, longTermPath);
+		_gSpatialDatabase->planPath(myIndexPosition, goalIndex, longTermPath);
 
 
 		// set up the waypoints along this path.
@@ -367,7 +394,7 @@ void ReactiveAgent::runLongTermPlanningPhase()
 			// repeatedly pop the path stack, adding waypoints every so often, until the stack is empty.
 			while ( ! longTermPath.empty()) {
 				unsigned int mostRecentNode = 0;
-				for (unsigned int i=0; i < ped_next_waypoint_distance; i++) {
+				for (unsigned int i=0; i < _ReactiveParams.ped_next_waypoint_distance; i++) {
 					if ( ! longTermPath.empty()) {
 						mostRecentNode = longTermPath.top();
 						longTermPath.pop();
@@ -381,7 +408,7 @@ void ReactiveAgent::runLongTermPlanningPhase()
 
 				// every time we successfully popped that many nodes in the path, we can add the next one as a waypoint.
 				Point waypoint;
-				gSpatialDatabase->getLocationFromIndex(mostRecentNode,waypoint);
+				_gSpatialDatabase->getLocationFromIndex(mostRecentNode,waypoint);
 				_waypoints.push_back(waypoint);
 			}
 
@@ -392,12 +419,12 @@ void ReactiveAgent::runLongTermPlanningPhase()
 			// note the >2 condition: if the astar path is not at least this large, then there will be a behavior bug in the AI
 			// when it tries to create waypoints.  in this case, the right thing to do is create only one waypoint that is at the landmark target.
 			// remember the astar lib produces "backwards" paths that start at [pathLengh-1] and end at [0].
-			int nextWaypointIndex = ((int)longTermAStar.getPath().size())-1 - ped_next_waypoint_distance;
+			int nextWaypointIndex = ((int)longTermAStar.getPath().size())-1 - _ReactiveParams.ped_next_waypoint_distance;
 			while (nextWaypointIndex > 0) {
 				Point waypoint;
-				gSpatialDatabase->getLocationFromIndex(longTermAStar.getPath()[nextWaypointIndex],waypoint);
+				_gSpatialDatabase->getLocationFromIndex(longTermAStar.getPath()[nextWaypointIndex],waypoint);
 				_waypoints.push_back(waypoint);
-				nextWaypointIndex -= ped_next_waypoint_distance;
+				nextWaypointIndex -= _ReactiveParams.ped_next_waypoint_distance;
 			}
 			_waypoints.push_back(_currentGoal.targetLocation);
 			
@@ -444,7 +471,7 @@ void ReactiveAgent::runMidTermPlanningPhase()
 		if (!_enabled) return;
 	}
 
-	AutomaticFunctionProfiler profileThisFunction( &ReactiveGlobals::gPhaseProfilers->midTermPhaseProfiler );
+	AutomaticFunctionProfiler profileThisFunction( &_aiModule->_phaseProfilers.midTermPhaseProfiler, "reactiveAI::midTermPlanning" );
 
 	// if we reached the current waypoint, then increment to the next waypoint
 	if (reachedCurrentWaypoint()) {
@@ -455,10 +482,10 @@ void ReactiveAgent::runMidTermPlanningPhase()
 	}
 
 	// compute a local a-star from your current location to the waypoint.
-	int myIndexPosition = gSpatialDatabase->getCellIndexFromLocation(_position.x, _position.z);
-	int waypointIndexPosition = gSpatialDatabase->getCellIndexFromLocation(_waypoints[_currentWaypointIndex].x, _waypoints[_currentWaypointIndex].z);
+	int myIndexPosition = _gSpatialDatabase->getCellIndexFromLocation(_position.x, _position.z);
+	int waypointIndexPosition = _gSpatialDatabase->getCellIndexFromLocation(_waypoints[_currentWaypointIndex].x, _waypoints[_currentWaypointIndex].z);
 
-	gSpatialDatabase->planPath(myIndexPosition, waypointIndexPosition,midTermPathStack);
+	_gSpatialDatabase->planPath(myIndexPosition, waypointIndexPosition,midTermPathStack);
 
 	// copy the local AStar path to your array
 	_midTermPathSize = (int)midTermPathStack.size();
@@ -467,9 +494,9 @@ void ReactiveAgent::runMidTermPlanningPhase()
 	//
 	// TODO, something is not quite right with this sanity check, it needs to be debugged.
 	//
-	if (_midTermPathSize > ped_next_waypoint_distance + 3) {
+	if (_midTermPathSize > _ReactiveParams.ped_next_waypoint_distance + 3) {
 		// the plus 1 is because a-star counts the agent's immediate location, but we do not.
-		std::cerr << "ERROR!!!  _midTermPathSize is larger than expected: should be less than or equal to " << ped_next_waypoint_distance+3 << ", but it actually is " << _midTermPathSize << "\n";
+		std::cerr << "ERROR!!!  _midTermPathSize is larger than expected: should be less than or equal to " << _ReactiveParams.ped_next_waypoint_distance+3 << ", but it actually is " << _midTermPathSize << "\n";
 		std::cerr << "agent name is:" << this->position() << std::endl;
 		assert(false);
 	}
@@ -519,11 +546,11 @@ void ReactiveAgent::runShortTermPlanningPhase()
 	}
 
 
-	AutomaticFunctionProfiler profileThisFunction( &ReactiveGlobals::gPhaseProfilers->shortTermPhaseProfiler );
+	AutomaticFunctionProfiler profileThisFunction( &_aiModule->_phaseProfilers.shortTermPhaseProfiler, "reactiveAI::shortTermPlanning" );
 #ifdef _DEBUG
 	std::cout << "about to accessgSpatialDatabase1\n";
 #endif
-	int myIndexPosition = gSpatialDatabase->getCellIndexFromLocation(_position.x, _position.z);
+	int myIndexPosition = _gSpatialDatabase->getCellIndexFromLocation(_position.x, _position.z);
 
 
 	closestPathNode = 0;
@@ -543,7 +570,7 @@ void ReactiveAgent::runShortTermPlanningPhase()
 #endif
 		for (unsigned int i=0; i<_midTermPathSize; i++) {
 			Point tempTargetLocation;
-			gSpatialDatabase->getLocationFromIndex( _midTermPath[i], tempTargetLocation);
+			_gSpatialDatabase->getLocationFromIndex( _midTermPath[i], tempTargetLocation);
 			Vector temp = tempTargetLocation-_position;
 			float distSquared = temp.lengthSquared();
 			if (distSquared < minDistSquared) {
@@ -563,19 +590,19 @@ void ReactiveAgent::runShortTermPlanningPhase()
 			float dummyt;
 			SpatialDatabaseItemPtr dummyObject;
 			unsigned int localTargetIndex = closestPathNode;
-			unsigned int furthestTargetIndex = min(_midTermPathSize-1, closestPathNode + ped_furthest_local_target_distance);
+			unsigned int furthestTargetIndex = min(_midTermPathSize-1, closestPathNode + _ReactiveParams.ped_furthest_local_target_distance);
 			unsigned int localTargetCellID = _midTermPath[localTargetIndex];
-			gSpatialDatabase->getLocationFromIndex( localTargetCellID, _localTargetLocation );
+			_gSpatialDatabase->getLocationFromIndex( localTargetCellID, _localTargetLocation );
 			Ray lineOfSightTest1, lineOfSightTest2;
 			lineOfSightTest1.initWithUnitInterval(_position + _radius*_rightSide, _localTargetLocation - (_position + _radius*_rightSide));
 			lineOfSightTest2.initWithUnitInterval(_position - _radius*_rightSide, _localTargetLocation - (_position - _radius*_rightSide));
 			while ( (localTargetIndex <= furthestTargetIndex)
-				&& (!gSpatialDatabase->trace(lineOfSightTest1,dummyt, dummyObject, dynamic_cast<SpatialDatabaseItemPtr>(this),true))
-				&& (!gSpatialDatabase->trace(lineOfSightTest2,dummyt, dummyObject, dynamic_cast<SpatialDatabaseItemPtr>(this),true)))
+				&& (!_gSpatialDatabase->trace(lineOfSightTest1,dummyt, dummyObject, dynamic_cast<SpatialDatabaseItemPtr>(this),true))
+				&& (!_gSpatialDatabase->trace(lineOfSightTest2,dummyt, dummyObject, dynamic_cast<SpatialDatabaseItemPtr>(this),true)))
 			{
 				localTargetIndex++;
 				localTargetCellID = _midTermPath[localTargetIndex];
-				gSpatialDatabase->getLocationFromIndex( localTargetCellID, _localTargetLocation );
+				_gSpatialDatabase->getLocationFromIndex( localTargetCellID, _localTargetLocation );
 				lineOfSightTest1.initWithUnitInterval(_position + _radius*_rightSide, _localTargetLocation - (_position + _radius*_rightSide));
 				lineOfSightTest2.initWithUnitInterval(_position - _radius*_rightSide, _localTargetLocation - (_position - _radius*_rightSide));
 			}
@@ -596,11 +623,11 @@ void ReactiveAgent::runShortTermPlanningPhase()
 			{
 				// if localTargetIndex is valid
 				localTargetCellID = _midTermPath[localTargetIndex];
-				gSpatialDatabase->getLocationFromIndex( localTargetCellID, _localTargetLocation );
+				_gSpatialDatabase->getLocationFromIndex( localTargetCellID, _localTargetLocation );
 #ifdef _DEBUG
 	std::cout << "done gSpatialDatabase->getLocationFromIndex( localTargetCellID, _localTargetLocation );\n";
 #endif
-				if ((_localTargetLocation - _waypoints[_currentWaypointIndex]).length() < 2.0f * ped_reached_target_distance_threshold)
+				if ((_localTargetLocation - _waypoints[_currentWaypointIndex]).length() < 2.0f * _ReactiveParams.ped_reached_target_distance_threshold)
 				{
 					_localTargetLocation = _waypoints[_currentWaypointIndex];
 				}
@@ -617,7 +644,7 @@ void ReactiveAgent::runShortTermPlanningPhase()
 #ifdef _DEBUG
 	std::cout << "done localTargetCellID = _midTermPath[closestPathNode+2];\n";
 #endif
-				gSpatialDatabase->getLocationFromIndex( localTargetCellID, _localTargetLocation );
+				_gSpatialDatabase->getLocationFromIndex( localTargetCellID, _localTargetLocation );
 			}
 		}
 		else {		
@@ -645,7 +672,7 @@ void ReactiveAgent::runShortTermPlanningPhase()
 #ifdef _DEBUG
 	std::cout << "about to gSpatialDatabase->getLocationFromIndex( closestPathNode, _localTargetLocation);\n";
 #endif
-			gSpatialDatabase->getLocationFromIndex( closestPathNode, _localTargetLocation);
+			_gSpatialDatabase->getLocationFromIndex( closestPathNode, _localTargetLocation);
 		}
 		else {
 			// this case should never be reached
@@ -655,12 +682,12 @@ void ReactiveAgent::runShortTermPlanningPhase()
 	}
 
 #ifdef _DEBUG
-	std::cout << "about to (gUseDynamicPhaseScheduling)1\n";
+	std::cout << "about to (_aiModule->_gUseDynamicPhaseScheduling)1\n";
 #endif
 
-	if (gUseDynamicPhaseScheduling) {
+	if (_aiModule->_gUseDynamicPhaseScheduling) {
 #ifdef _DEBUG
-	std::cout << "about to (gUseDynamicPhaseScheduling)2\n";
+	std::cout << "about to (_aiModule->_gUseDynamicPhaseScheduling)2\n";
 #endif
 		// decimating short-term planning
 		float distanceHeuristic = (_position - _localTargetLocation).length() - 5.0f;
@@ -687,14 +714,14 @@ void ReactiveAgent::runPerceptivePhase()
 {
 	if (!_enabled) return;
 
-	AutomaticFunctionProfiler profileThisFunction( &ReactiveGlobals::gPhaseProfilers->perceptivePhaseProfiler );
+	AutomaticFunctionProfiler profileThisFunction( &_aiModule->_phaseProfilers.perceptivePhaseProfiler, "reactiveAI::perceptivePhase" );
 	collectObjectsInVisualField();
 
-	if (gUseDynamicPhaseScheduling) {
+	if (_aiModule->_gUseDynamicPhaseScheduling) {
 		if (_currentSpeed <= 0.4f) {
 			_framesToNextPerceptivePhase = 65;
 		}
-		else if (_currentSpeed <= ped_typical_speed - 0.2f) {
+		else if (_currentSpeed <= _ReactiveParams.ped_typical_speed - 0.2f) {
 			_framesToNextPerceptivePhase = 65;
 		}
 		else {
@@ -711,7 +738,7 @@ void ReactiveAgent::runPredictivePhase()
 {
 	if (!_enabled) return;
 
-	AutomaticFunctionProfiler profileThisFunction( &ReactiveGlobals::gPhaseProfilers->predictivePhaseProfiler );
+	AutomaticFunctionProfiler profileThisFunction( &_aiModule->_phaseProfilers.predictivePhaseProfiler, "reactiveAI::predictivePhase" );
 
 	bool threatListChanged = false;
 	bool alreadyExists = false;
@@ -782,7 +809,7 @@ void ReactiveAgent::runPredictivePhase()
 
 			Vector dV = _velocity - otherGuy->velocity();
 			Vector dO = _position - otherGuy->position();
-			float distanceThreshold = _radius + otherGuy->radius() + ped_dynamic_collision_padding;
+			float distanceThreshold = _radius + otherGuy->radius() + _ReactiveParams.ped_dynamic_collision_padding;
 			float A = dot(dV,dV);
 			float B = 2.0f*dot(dV,dO);
 			float C = dot(dO,dO) - (distanceThreshold*distanceThreshold);
@@ -801,7 +828,7 @@ void ReactiveAgent::runPredictivePhase()
 						// TODO: what todo in this situation?
 						// note, we do not necessarily reach this code for ALL agent-agent collisions, because of scheduling phases.
 					}
-					else if ((minTimeOfThreat > ped_threat_min_time_threshold) && (maxTimeOfThreat < ped_threat_max_time_threshold)) {
+					else if ((minTimeOfThreat > _ReactiveParams.ped_threat_min_time_threshold) && (maxTimeOfThreat < _ReactiveParams.ped_threat_max_time_threshold)) {
 						//cerr << "NEW THREAT!!!\n";
 						PredictedThreat newThreat;
 						newThreat.maxTime = _currentTimeStamp + maxTimeOfThreat;
@@ -813,12 +840,12 @@ void ReactiveAgent::runPredictivePhase()
 						newThreat.oncomingToRightSide = false;
 
 						float cosTheta = dot(_forward,otherGuy->forward());
-						if (cosTheta > ped_similar_direction_dot_product_threshold) {
+						if (cosTheta > _ReactiveParams.ped_similar_direction_dot_product_threshold) {
 							// otherGuy is facing a similar direction as you
 							// in the current implementation, this is not considered a 
 							// threat, and reactive steering handles it.
 						} 
-						else if (cosTheta < ped_oncoming_prediction_threshold) {
+						else if (cosTheta < _ReactiveParams.ped_oncoming_prediction_threshold) {
 							// otherGuy is oncoming.
 							float whichSideOfTarget = directionToLocalTarget.x * (otherGuy->position().x-_localTargetLocation.x) + directionToLocalTarget.z * (otherGuy->position().z-_localTargetLocation.z);
 							float whichSideOfLocation = directionToLocalTarget.x * (otherGuy->position().x-position().x) + directionToLocalTarget.z * (otherGuy->position().z-position().z);
@@ -885,7 +912,7 @@ void ReactiveAgent::runPredictivePhase()
 						// collided with a threat that we already predicted
 						// doh!
 					}
-					else if ((minTimeOfThreat > ped_threat_min_time_threshold) && (maxTimeOfThreat < ped_threat_max_time_threshold)) {
+					else if ((minTimeOfThreat > _ReactiveParams.ped_threat_min_time_threshold) && (maxTimeOfThreat < _ReactiveParams.ped_threat_max_time_threshold)) {
 						// still imminent, update the threat where it exists in the _threatList.
 						_threatList[threatIndex].maxTime = _currentTimeStamp + maxTimeOfThreat;
 						_threatList[threatIndex].minTime = _currentTimeStamp + minTimeOfThreat;
@@ -945,13 +972,13 @@ void ReactiveAgent::runPredictivePhase()
 	// depending on the threatlist, assume various states
 	// steering actions in reactive phase are determined by the chosen state.
 	//
-//	if (_threatList.size() >= ped_feeling_crowded_threshold) {
+//	if (_threatList.size() >= _ReactiveParams.ped_feeling_crowded_threshold) {
 //		// if there are too many threats, then we feel crowded and set the state accordingly.
 //		// reactive steering behaviors will be more crowd-oriented in this state.
 //		_steeringState = STEERING_STATE_COOPERATE_WITH_CROWD;
 //	}
 //	else 
-	if ( (dot(directionToLocalTarget,forward()) < ped_wrong_direction_dot_product_threshold) || ((dot(directionToLocalTarget,forward()) < ped_same_direction_dot_product_threshold) && (_steeringState == STEERING_STATE_TURN_TOWARDS_TARGET))) {
+	if ( (dot(directionToLocalTarget,forward()) < _ReactiveParams.ped_wrong_direction_dot_product_threshold) || ((dot(directionToLocalTarget,forward()) < _ReactiveParams.ped_same_direction_dot_product_threshold) && (_steeringState == STEERING_STATE_TURN_TOWARDS_TARGET))) {
 		// if we are not following a space-time path, then we should be facing our local target.
 		// in this case, we are not... so change the state to turn towards the target.
 		_steeringState = STEERING_STATE_TURN_TOWARDS_TARGET;
@@ -996,7 +1023,7 @@ void ReactiveAgent::runReactivePhase()
 		if (!_enabled) return;
 	}
 
-	AutomaticFunctionProfiler profileThisFunction( &ReactiveGlobals::gPhaseProfilers->reactivePhaseProfiler );
+	AutomaticFunctionProfiler profileThisFunction( &_aiModule->_phaseProfilers.reactivePhaseProfiler, "reactiveAI::reactivePhase" );
 
 	FeelerInfo feelers;
 
@@ -1008,9 +1035,9 @@ void ReactiveAgent::runReactivePhase()
 	_finalSteeringCommand.aimForTargetDirection = true; // assume its true unless the reactions below indicate otherwise.
 	_finalSteeringCommand.targetDirection = normalize(_localTargetLocation - _position);
 	_finalSteeringCommand.aimForTargetSpeed = true;  // assume its true unless reactions indicate otherwise.
-	_finalSteeringCommand.turningAmount = ped_adjustment_turn_rate;
+	_finalSteeringCommand.turningAmount = _ReactiveParams.ped_adjustment_turn_rate;
 	_finalSteeringCommand.acceleration = 1.0f;
-	_finalSteeringCommand.targetSpeed = ped_typical_speed_factor * _currentGoal.desiredSpeed;
+	_finalSteeringCommand.targetSpeed = _ReactiveParams.ped_typical_speed_factor * _currentGoal.desiredSpeed;
 	//_finalSteeringCommand.dynamicsSteeringForce
 	//_finalSteeringCommand.steeringMode
 
@@ -1022,14 +1049,14 @@ void ReactiveAgent::runReactivePhase()
 	// TODO: it is OK that this happens regardless of state?
 	// TODO: should you comment out the 2nd and 3rd conditions for violating comfort zone in the conditional above??
 	//
-	if (feelers.t_right < ped_comfort_zone) {
+	if (feelers.t_right < _ReactiveParams.ped_comfort_zone) {
 		if ((!feelers.object_left) && (!feelers.object_lside)) {
 			_finalSteeringCommand.scoot = max(-1.0f / feelers.t_right, -_maxForce);
 		} else {
 			comfortZoneViolated=true;
 		}
 	}
-	if (feelers.t_left < ped_comfort_zone) {
+	if (feelers.t_left < _ReactiveParams.ped_comfort_zone) {
 		if ((!feelers.object_right) && (!feelers.object_rside)) {
 			_finalSteeringCommand.scoot = min(1.0f / feelers.t_left, _maxForce);
 		} else {
@@ -1083,7 +1110,7 @@ void ReactiveAgent::runReactivePhase()
 		}
 
 		// check if our comfortzone is violated
-		if ((feelers.t_front < ped_comfort_zone) || (feelers.t_right < ped_comfort_zone) || (feelers.t_left < ped_comfort_zone)) {
+		if ((feelers.t_front < _ReactiveParams.ped_comfort_zone) || (feelers.t_right < _ReactiveParams.ped_comfort_zone) || (feelers.t_left < _ReactiveParams.ped_comfort_zone)) {
 			comfortZoneViolated=true;
 		}
 
@@ -1096,7 +1123,7 @@ void ReactiveAgent::runReactivePhase()
 			ReactiveAgent * p = dynamic_cast<ReactiveAgent*>(feelers.object_front);
 			Vector dV = _velocity - p->velocity();
 			Vector dO = _position - p->position();
-			float distanceThreshold = _radius + p->radius() + ped_dynamic_collision_padding;
+			float distanceThreshold = _radius + p->radius() + _ReactiveParams.ped_dynamic_collision_padding;
 			float A = dot(dV,dV);
 			float B = 2.0f*dot(dV,dO);
 			float C = dot(dO,dO) - (distanceThreshold*distanceThreshold);
@@ -1112,7 +1139,7 @@ void ReactiveAgent::runReactivePhase()
 			ReactiveAgent * p = dynamic_cast<ReactiveAgent*>(feelers.object_left);
 			Vector dV = _velocity - p->velocity();
 			Vector dO = _position - p->position();
-			float distanceThreshold = _radius + p->radius() + ped_dynamic_collision_padding;
+			float distanceThreshold = _radius + p->radius() + _ReactiveParams.ped_dynamic_collision_padding;
 			float A = dot(dV,dV);
 			float B = 2.0f*dot(dV,dO);
 			float C = dot(dO,dO) - (distanceThreshold*distanceThreshold);
@@ -1128,7 +1155,7 @@ void ReactiveAgent::runReactivePhase()
 			ReactiveAgent * p = dynamic_cast<ReactiveAgent*>(feelers.object_right);
 			Vector dV = _velocity - p->velocity();
 			Vector dO = _position - p->position();
-			float distanceThreshold = _radius + p->radius() + ped_dynamic_collision_padding;
+			float distanceThreshold = _radius + p->radius() + _ReactiveParams.ped_dynamic_collision_padding;
 			float A = dot(dV,dV);
 			float B = 2.0f*dot(dV,dO);
 			float C = dot(dO,dO) - (distanceThreshold*distanceThreshold);
@@ -1184,17 +1211,17 @@ void ReactiveAgent::runReactivePhase()
 		//
 
 		if (_steeringState == STEERING_STATE_TURN_TOWARDS_TARGET) {
-			if ((dot(_finalSteeringCommand.targetDirection,forward()) > ped_same_direction_dot_product_threshold)) {
+			if ((dot(_finalSteeringCommand.targetDirection,forward()) > _ReactiveParams.ped_same_direction_dot_product_threshold)) {
 				_steeringState = STEERING_STATE_NO_THREAT;
 			}
 			_finalSteeringCommand.aimForTargetDirection = true;
-			_finalSteeringCommand.turningAmount = ped_cornering_turn_rate;
+			_finalSteeringCommand.turningAmount = _ReactiveParams.ped_cornering_turn_rate;
 			_finalSteeringCommand.aimForTargetSpeed = true;
 			_finalSteeringCommand.targetSpeed = 0.0f;
-			if ((feelers.t_left < ped_comfort_zone) && (!(feelers.t_right < ped_comfort_zone))) {
+			if ((feelers.t_left < _ReactiveParams.ped_comfort_zone) && (!(feelers.t_right < _ReactiveParams.ped_comfort_zone))) {
 				_finalSteeringCommand.scoot = 0.5f * _maxForce;
 			}
-			else if (feelers.t_right < ped_comfort_zone) {
+			else if (feelers.t_right < _ReactiveParams.ped_comfort_zone) {
 				_finalSteeringCommand.scoot = -0.5f * _maxForce;
 			}
 		}
@@ -1234,12 +1261,12 @@ void ReactiveAgent::runReactivePhase()
 				if ((feelers.object_front || feelers.object_left) && (!feelers.object_right)) {
 					//if (isSelected()) cerr << "REACTION: one oncoming agent, while I was trying to avoid another threat. I'll go to the right.\n";
 					_finalSteeringCommand.aimForTargetDirection = false;
-					_finalSteeringCommand.turningAmount = ped_typical_avoidance_turn_rate;
+					_finalSteeringCommand.turningAmount = _ReactiveParams.ped_typical_avoidance_turn_rate;
 				}
 				else {
 					//if (isSelected()) cerr << "REACTION: one oncoming agent, while I was trying to avoid another threat. I'll go to the left.\n";
 					_finalSteeringCommand.aimForTargetDirection = false;
-					_finalSteeringCommand.turningAmount = -ped_typical_avoidance_turn_rate;
+					_finalSteeringCommand.turningAmount = -_ReactiveParams.ped_typical_avoidance_turn_rate;
 				}
 
 			}
@@ -1249,12 +1276,12 @@ void ReactiveAgent::runReactivePhase()
 					if (_threatList[_mostImminentThreatIndex].oncomingToRightSide) {
 						//if (isSelected()) cerr << "REACTION: one oncoming agent,while I was trying to avoid another threatI'll go to the left.\n";
 						_finalSteeringCommand.aimForTargetDirection = false;
-						_finalSteeringCommand.turningAmount = -ped_adjustment_turn_rate;
+						_finalSteeringCommand.turningAmount = -_ReactiveParams.ped_adjustment_turn_rate;
 					}
 					else {
 						//if (isSelected()) cerr << "REACTION: one oncoming agent, while I was trying to avoid another threat. I'll go to the right.\n";
 						_finalSteeringCommand.aimForTargetDirection = false;
-						_finalSteeringCommand.turningAmount = ped_adjustment_turn_rate;
+						_finalSteeringCommand.turningAmount = _ReactiveParams.ped_adjustment_turn_rate;
 					}
 				}
 				else if (_threatList[_mostImminentThreatIndex].threatType == PredictedThreat::THREAT_TYPE_CROSSING_SOON) {
@@ -1264,16 +1291,16 @@ void ReactiveAgent::runReactivePhase()
 					if ( dot((_rightSide),threatGuy->forward()) < 0.0f) {
 						//if (isSelected()) cerr << "REACTION: one crossing agent, while I was trying to avoid another threat. (crossing_soon) steering left.\n";
 						//_finalSteeringCommand.aimForTargetSpeed = true;
-						//_finalSteeringCommand.targetSpeed = ped_slightly_faster_speed_factor*_currentGoal.desiredSpeed;
+						//_finalSteeringCommand.targetSpeed = _ReactiveParams.ped_slightly_faster_speed_factor*_currentGoal.desiredSpeed;
 						_finalSteeringCommand.aimForTargetDirection = false;
-						_finalSteeringCommand.turningAmount = -ped_typical_avoidance_turn_rate;
+						_finalSteeringCommand.turningAmount = -_ReactiveParams.ped_typical_avoidance_turn_rate;
 					}
 					else {
 						//if (isSelected()) cerr << "REACTION: one crossing agent, while I was trying to avoid another threat. (crossing_soon) steering right.\n";
 						//_finalSteeringCommand.aimForTargetSpeed = true;
-						//_finalSteeringCommand.targetSpeed = ped_slightly_faster_speed_factor*_currentGoal.desiredSpeed;
+						//_finalSteeringCommand.targetSpeed = _ReactiveParams.ped_slightly_faster_speed_factor*_currentGoal.desiredSpeed;
 						_finalSteeringCommand.aimForTargetDirection = false;
-						_finalSteeringCommand.turningAmount = ped_typical_avoidance_turn_rate;
+						_finalSteeringCommand.turningAmount = _ReactiveParams.ped_typical_avoidance_turn_rate;
 					}
 				}
 				else if (_threatList[_mostImminentThreatIndex].threatType == PredictedThreat::THREAT_TYPE_CROSSING_LATE) {
@@ -1283,16 +1310,16 @@ void ReactiveAgent::runReactivePhase()
 					if ( dot((_rightSide),threatGuy->forward()) < 0.0f) {
 						//if (isSelected()) cerr << "REACTION: one crossing agent, while I was trying to avoid another threat. (crossing_late) steering right.\n";
 						//_finalSteeringCommand.aimForTargetSpeed = true;
-						//_finalSteeringCommand.targetSpeed = ped_slightly_slower_speed_factor*_currentGoal.desiredSpeed;
+						//_finalSteeringCommand.targetSpeed = _ReactiveParams.ped_slightly_slower_speed_factor*_currentGoal.desiredSpeed;
 						_finalSteeringCommand.aimForTargetDirection = false;
-						_finalSteeringCommand.turningAmount = ped_typical_avoidance_turn_rate;
+						_finalSteeringCommand.turningAmount = _ReactiveParams.ped_typical_avoidance_turn_rate;
 					}
 					else {
 						//if (isSelected()) cerr << "REACTION: one crossing agent, while I was trying to avoid another threat. (crossing_late) steering left.\n";
 						//_finalSteeringCommand.aimForTargetSpeed = true;
-						//_finalSteeringCommand.targetSpeed = ped_slightly_slower_speed_factor*_currentGoal.desiredSpeed;
+						//_finalSteeringCommand.targetSpeed = _ReactiveParams.ped_slightly_slower_speed_factor*_currentGoal.desiredSpeed;
 						_finalSteeringCommand.aimForTargetDirection = false;
-						_finalSteeringCommand.turningAmount = -ped_typical_avoidance_turn_rate;
+						_finalSteeringCommand.turningAmount = -_ReactiveParams.ped_typical_avoidance_turn_rate;
 					}
 				}
 				else {
@@ -1313,18 +1340,18 @@ void ReactiveAgent::runReactivePhase()
 				assert(obj!=NULL);
 				ReactiveAgent * p = dynamic_cast<ReactiveAgent*>(obj);
 				float cosTheta = dot(_forward, p->forward());
-				if ( cosTheta < ped_oncoming_reaction_threshold ) {
+				if ( cosTheta < _ReactiveParams.ped_oncoming_reaction_threshold ) {
 					if ((feelers.object_front || feelers.object_left) && (!feelers.object_right)) {
 						//if (isSelected()) cerr << "REACTION: one oncoming agent, I'll go to the right.\n";
 						_finalSteeringCommand.aimForTargetDirection = false;
-						_finalSteeringCommand.turningAmount = (comfortZoneViolated) ? ped_faster_avoidance_turn_rate : ped_typical_avoidance_turn_rate;
-						_finalSteeringCommand.targetSpeed = (comfortZoneViolated) ? ped_slower_speed_factor * _currentGoal.desiredSpeed : ped_typical_speed_factor * _currentGoal.desiredSpeed;
+						_finalSteeringCommand.turningAmount = (comfortZoneViolated) ? _ReactiveParams.ped_faster_avoidance_turn_rate : _ReactiveParams.ped_typical_avoidance_turn_rate;
+						_finalSteeringCommand.targetSpeed = (comfortZoneViolated) ? _ReactiveParams.ped_slower_speed_factor * _currentGoal.desiredSpeed : _ReactiveParams.ped_typical_speed_factor * _currentGoal.desiredSpeed;
 					}
 					else {
 						//if (isSelected()) cerr << "REACTION: one oncoming agent, I'll go to the left.\n";
 						_finalSteeringCommand.aimForTargetDirection = false;
-						_finalSteeringCommand.turningAmount = (comfortZoneViolated) ? -ped_faster_avoidance_turn_rate : -ped_typical_avoidance_turn_rate;
-						_finalSteeringCommand.targetSpeed = (comfortZoneViolated) ? ped_slower_speed_factor * _currentGoal.desiredSpeed : ped_typical_speed_factor * _currentGoal.desiredSpeed;
+						_finalSteeringCommand.turningAmount = (comfortZoneViolated) ? -_ReactiveParams.ped_faster_avoidance_turn_rate : -_ReactiveParams.ped_typical_avoidance_turn_rate;
+						_finalSteeringCommand.targetSpeed = (comfortZoneViolated) ? _ReactiveParams.ped_slower_speed_factor * _currentGoal.desiredSpeed : _ReactiveParams.ped_typical_speed_factor * _currentGoal.desiredSpeed;
 					}
 
 				}
@@ -1335,19 +1362,19 @@ void ReactiveAgent::runReactivePhase()
 					if (his_time < my_time) {
 						//if (isSelected()) cerr << "REACTION: one agent, he'll go in front of me, so I'll wait\n";
 						float tempVelocity = dot(forward(),p->velocity());
-						_finalSteeringCommand.targetSpeed = min(_finalSteeringCommand.targetSpeed, (float)ped_slower_speed_factor * tempVelocity);
+						_finalSteeringCommand.targetSpeed = min(_finalSteeringCommand.targetSpeed, (float)_ReactiveParams.ped_slower_speed_factor * tempVelocity);
 					}
 					else {
 						//if (isSelected()) cerr << "REACTION: one agent, I'm in front of him, so I'll go.\n";
 						if ((feelers.object_right) && (feelers.object_front==NULL)) {
 							_finalSteeringCommand.aimForTargetDirection = false;
-							_finalSteeringCommand.turningAmount = -ped_typical_avoidance_turn_rate;
+							_finalSteeringCommand.turningAmount = -_ReactiveParams.ped_typical_avoidance_turn_rate;
 						}
 						else {
 							_finalSteeringCommand.aimForTargetDirection = false;
-							_finalSteeringCommand.turningAmount = ped_typical_avoidance_turn_rate;
+							_finalSteeringCommand.turningAmount = _ReactiveParams.ped_typical_avoidance_turn_rate;
 						}
-						_finalSteeringCommand.targetSpeed = (comfortZoneViolated) ? ped_slower_speed_factor * _currentGoal.desiredSpeed : ped_typical_speed_factor * _currentGoal.desiredSpeed;
+						_finalSteeringCommand.targetSpeed = (comfortZoneViolated) ? _ReactiveParams.ped_slower_speed_factor * _currentGoal.desiredSpeed : _ReactiveParams.ped_typical_speed_factor * _currentGoal.desiredSpeed;
 					}
 				}
 			}
@@ -1359,25 +1386,25 @@ void ReactiveAgent::runReactivePhase()
 				ReactiveAgent * pRight = dynamic_cast<ReactiveAgent*>(objRight);
 				float cosThetaLeft = dot(_forward, pLeft->forward());
 				float cosThetaRight = dot(_forward, pRight->forward());
-				if ((cosThetaLeft < ped_oncoming_reaction_threshold) && (cosThetaRight < ped_oncoming_reaction_threshold)) {
+				if ((cosThetaLeft < _ReactiveParams.ped_oncoming_reaction_threshold) && (cosThetaRight < _ReactiveParams.ped_oncoming_reaction_threshold)) {
 					//if (isSelected()) cerr << "REACTION: two agents oncoming to me... I'll just stop...\n";
 					_finalSteeringCommand.aimForTargetDirection = true;
-					_finalSteeringCommand.turningAmount = ped_typical_avoidance_turn_rate;
+					_finalSteeringCommand.turningAmount = _ReactiveParams.ped_typical_avoidance_turn_rate;
 					_finalSteeringCommand.targetSpeed = 0.0;
 				}
-				else if ((cosThetaLeft > ped_same_direction_dot_product_threshold) && (cosThetaRight < ped_oncoming_reaction_threshold)) {
+				else if ((cosThetaLeft > _ReactiveParams.ped_same_direction_dot_product_threshold) && (cosThetaRight < _ReactiveParams.ped_oncoming_reaction_threshold)) {
 					//if (isSelected()) cerr << "REACTION: two agents - I'll follow the one on the left.\n";
 					_finalSteeringCommand.aimForTargetDirection = false;
-					_finalSteeringCommand.turningAmount = (objRight == feelers.object_front) ? -ped_typical_avoidance_turn_rate : -ped_adjustment_turn_rate;
+					_finalSteeringCommand.turningAmount = (objRight == feelers.object_front) ? -_ReactiveParams.ped_typical_avoidance_turn_rate : -_ReactiveParams.ped_adjustment_turn_rate;
 					float tempVelocity = dot(forward(),pLeft->velocity());
 					_finalSteeringCommand.targetSpeed = min(_finalSteeringCommand.targetSpeed, tempVelocity);
 					if (comfortZoneViolated) _finalSteeringCommand.targetSpeed = 0.7f * _finalSteeringCommand.targetSpeed;
 					if (_finalSteeringCommand.targetSpeed < 0.0f) _finalSteeringCommand.targetSpeed = 0.0f;
 				}
-				else if ((cosThetaLeft < ped_oncoming_reaction_threshold) && (cosThetaRight > ped_same_direction_dot_product_threshold)) {
+				else if ((cosThetaLeft < _ReactiveParams.ped_oncoming_reaction_threshold) && (cosThetaRight > _ReactiveParams.ped_same_direction_dot_product_threshold)) {
 					//if (isSelected()) cerr << "REACTION: two agents - I'll follow the one on the right.\n";
 					_finalSteeringCommand.aimForTargetDirection = false;
-					_finalSteeringCommand.turningAmount = (objLeft == feelers.object_front) ? ped_typical_avoidance_turn_rate : ped_adjustment_turn_rate;
+					_finalSteeringCommand.turningAmount = (objLeft == feelers.object_front) ? _ReactiveParams.ped_typical_avoidance_turn_rate : _ReactiveParams.ped_adjustment_turn_rate;
 					float tempVelocity = dot(forward(),pRight->velocity());
 					_finalSteeringCommand.targetSpeed = min(_finalSteeringCommand.targetSpeed, tempVelocity);
 					if (comfortZoneViolated) _finalSteeringCommand.targetSpeed = 0.7f * _finalSteeringCommand.targetSpeed;
@@ -1396,14 +1423,14 @@ void ReactiveAgent::runReactivePhase()
 				if ((feelers.t_left >= feelers.t_front) && (feelers.t_front > feelers.t_right)) {
 					//if (isSelected()) cerr << "REACTION: just static obstacles... I should steer left.\n";
 					_finalSteeringCommand.aimForTargetDirection = false;
-					_finalSteeringCommand.turningAmount = (comfortZoneViolated) ? -ped_faster_avoidance_turn_rate : -ped_typical_avoidance_turn_rate;
-					_finalSteeringCommand.targetSpeed = ped_typical_speed_factor * _currentGoal.desiredSpeed;
+					_finalSteeringCommand.turningAmount = (comfortZoneViolated) ? -_ReactiveParams.ped_faster_avoidance_turn_rate : -_ReactiveParams.ped_typical_avoidance_turn_rate;
+					_finalSteeringCommand.targetSpeed = _ReactiveParams.ped_typical_speed_factor * _currentGoal.desiredSpeed;
 				}
 				else if ((feelers.t_right >= feelers.t_front) && (feelers.t_front > feelers.t_left)) {
 					//if (isSelected()) cerr << "REACTION: just static obstacles... I should steer right.\n";
 					_finalSteeringCommand.aimForTargetDirection = false;
-					_finalSteeringCommand.turningAmount = (comfortZoneViolated) ? ped_faster_avoidance_turn_rate : ped_typical_avoidance_turn_rate;
-					_finalSteeringCommand.targetSpeed = ped_typical_speed_factor * _currentGoal.desiredSpeed;
+					_finalSteeringCommand.turningAmount = (comfortZoneViolated) ? _ReactiveParams.ped_faster_avoidance_turn_rate : _ReactiveParams.ped_typical_avoidance_turn_rate;
+					_finalSteeringCommand.targetSpeed = _ReactiveParams.ped_typical_speed_factor * _currentGoal.desiredSpeed;
 				}
 				else {
 					// in this case, t_front was not correctly in-between t_right and t_left
@@ -1411,22 +1438,22 @@ void ReactiveAgent::runReactivePhase()
 					if ((feelers.t_front < feelers.t_left) && (feelers.t_front < feelers.t_right)) {
 						//if (isSelected()) cerr << "REACTION: just static obstacles... I'm reaching a convex corner... I'll just quickly steer towards my targetDirection\n";
 						_finalSteeringCommand.aimForTargetDirection = true;
-						_finalSteeringCommand.turningAmount = ped_faster_avoidance_turn_rate;
-						_finalSteeringCommand.targetSpeed = (comfortZoneViolated) ? ped_slower_speed_factor * _currentGoal.desiredSpeed : ped_typical_speed_factor * _currentGoal.desiredSpeed;
+						_finalSteeringCommand.turningAmount = _ReactiveParams.ped_faster_avoidance_turn_rate;
+						_finalSteeringCommand.targetSpeed = (comfortZoneViolated) ? _ReactiveParams.ped_slower_speed_factor * _currentGoal.desiredSpeed : _ReactiveParams.ped_typical_speed_factor * _currentGoal.desiredSpeed;
 					}
 					else if (feelers.t_front == INFINITY) {
 						//if (isSelected()) cerr << "REACTION: just static obstacles... I should steer through.\n";
 						_finalSteeringCommand.aimForTargetDirection = true;
-						_finalSteeringCommand.turningAmount = ped_typical_avoidance_turn_rate;
-						_finalSteeringCommand.targetSpeed = ped_typical_speed_factor * _currentGoal.desiredSpeed;
+						_finalSteeringCommand.turningAmount = _ReactiveParams.ped_typical_avoidance_turn_rate;
+						_finalSteeringCommand.targetSpeed = _ReactiveParams.ped_typical_speed_factor * _currentGoal.desiredSpeed;
 						_finalSteeringCommand.scoot = (feelers.t_left < feelers.t_right) ? 0.5f * _maxForce : -0.5f * _maxForce;
 					}
 					else {
 						//if (isSelected()) cerr << "REACTION: just static obstacles... I think I'm steering into a concave corner... I'll just quickly steer towards my targetDirection\n";
 						// TODO: is there something more intelligent to do?
 						_finalSteeringCommand.aimForTargetDirection = true;
-						_finalSteeringCommand.turningAmount = ped_faster_avoidance_turn_rate;
-						_finalSteeringCommand.targetSpeed = ped_slower_speed_factor * _currentGoal.desiredSpeed;
+						_finalSteeringCommand.turningAmount = _ReactiveParams.ped_faster_avoidance_turn_rate;
+						_finalSteeringCommand.targetSpeed = _ReactiveParams.ped_slower_speed_factor * _currentGoal.desiredSpeed;
 					}
 				}
 			}
@@ -1438,7 +1465,7 @@ void ReactiveAgent::runReactivePhase()
 
 				ReactiveAgent * p = dynamic_cast<ReactiveAgent*>(objAgent);
 
-				if ( dot(p->forward(), _forward) < ped_oncoming_reaction_threshold ) {
+				if ( dot(p->forward(), _forward) < _ReactiveParams.ped_oncoming_reaction_threshold ) {
 					if (obstacle == feelers.object_right) {
 						//if (isSelected()) cerr << "REACTION: a static obstacle and an oncoming agent... I'll just wait for him to go around me.\n";
 						_finalSteeringCommand.targetSpeed = 0.0f;
@@ -1446,15 +1473,15 @@ void ReactiveAgent::runReactivePhase()
 					else if (obstacle == feelers.object_left) {
 						//if (isSelected()) cerr << "REACTION: a static obstacle and an oncoming agent... I'll go around them on the right\n";
 						_finalSteeringCommand.aimForTargetDirection = false;
-						_finalSteeringCommand.turningAmount = ped_typical_avoidance_turn_rate;
-						_finalSteeringCommand.targetSpeed = ped_typical_speed_factor * _currentGoal.desiredSpeed;
+						_finalSteeringCommand.turningAmount = _ReactiveParams.ped_typical_avoidance_turn_rate;
+						_finalSteeringCommand.targetSpeed = _ReactiveParams.ped_typical_speed_factor * _currentGoal.desiredSpeed;
 					}
 					else {
 						// weird, only hit the static object in the middle, its either a small obstacle, or a corner.
 						//if (isSelected()) cerr << "REACTION: a static obstacle and an oncoming agent... a corner? what do I do?\n";
 						// TODO: is this the right thing to do here?
 						_finalSteeringCommand.aimForTargetDirection = true;
-						_finalSteeringCommand.turningAmount = ped_cornering_turn_rate;
+						_finalSteeringCommand.turningAmount = _ReactiveParams.ped_cornering_turn_rate;
 						_finalSteeringCommand.targetSpeed = 0.0f;
 					}
 				}
@@ -1465,27 +1492,27 @@ void ReactiveAgent::runReactivePhase()
 					// choose target speed based on agent
 					if (my_time < his_time) {
 						//if (isSelected()) cerr << "REACTION: a static obstacle and an non-oncoming agent, I'm in front of him, so I'll go.\n";
-						_finalSteeringCommand.targetSpeed = ped_slightly_faster_speed_factor * _currentGoal.desiredSpeed;
+						_finalSteeringCommand.targetSpeed = _ReactiveParams.ped_slightly_faster_speed_factor * _currentGoal.desiredSpeed;
 					}
 					else {
 						//if (isSelected()) cerr << "REACTION: a static obstacle and an non-oncoming agent, he'll go in front of me, so I'll wait\n";
 						float tempVelocity = dot(forward(),p->velocity());
-						_finalSteeringCommand.targetSpeed = min(_finalSteeringCommand.targetSpeed, ped_slower_speed_factor * tempVelocity);
+						_finalSteeringCommand.targetSpeed = min(_finalSteeringCommand.targetSpeed, _ReactiveParams.ped_slower_speed_factor * tempVelocity);
 					}
 					/*
 					// choose target direction to avoid the static obstacle.
 					if (obstacle == feelers.object_right) {
 						_finalSteeringCommand.aimForTargetDirection = false;
-						_finalSteeringCommand.turningAmount = -ped_adjustment_turn_rate;
+						_finalSteeringCommand.turningAmount = -_ReactiveParams.ped_adjustment_turn_rate;
 					}
 					else if (obstacle == feelers.object_left) {
 						_finalSteeringCommand.aimForTargetDirection = false;
-						_finalSteeringCommand.turningAmount = ped_adjustment_turn_rate;
+						_finalSteeringCommand.turningAmount = _ReactiveParams.ped_adjustment_turn_rate;
 					}
 					else {
 						// TODO: is this the right thing to do here?
 						_finalSteeringCommand.aimForTargetDirection = true;
-						_finalSteeringCommand.turningAmount = ped_cornering_turn_rate;
+						_finalSteeringCommand.turningAmount = _ReactiveParams.ped_cornering_turn_rate;
 						_finalSteeringCommand.targetSpeed = 0.0f;
 					}*/
 
@@ -1543,17 +1570,17 @@ void ReactiveAgent::runReactivePhase()
 				// choose turning
 				if (obstacle == feelers.object_right) {
 					_finalSteeringCommand.aimForTargetDirection = false;
-					_finalSteeringCommand.turningAmount = (comfortZoneViolated) ? -ped_faster_avoidance_turn_rate : -ped_typical_avoidance_turn_rate;
+					_finalSteeringCommand.turningAmount = (comfortZoneViolated) ? -_ReactiveParams.ped_faster_avoidance_turn_rate : -_ReactiveParams.ped_typical_avoidance_turn_rate;
 				}
 				else if (obstacle == feelers.object_left) {
 					_finalSteeringCommand.aimForTargetDirection = false;
-					_finalSteeringCommand.turningAmount = (comfortZoneViolated) ? ped_faster_avoidance_turn_rate : ped_typical_avoidance_turn_rate;
+					_finalSteeringCommand.turningAmount = (comfortZoneViolated) ? _ReactiveParams.ped_faster_avoidance_turn_rate : _ReactiveParams.ped_typical_avoidance_turn_rate;
 				}
 				else {
 					// weird, only hit the static object in the middle, its either a small obstacle, or a corner.
 					// TODO: is this the right thing to do here?
 					_finalSteeringCommand.aimForTargetDirection = true;
-					_finalSteeringCommand.turningAmount = ped_cornering_turn_rate;
+					_finalSteeringCommand.turningAmount = _ReactiveParams.ped_cornering_turn_rate;
 					_finalSteeringCommand.targetSpeed = 0.0f;
 				}
 			}
@@ -1573,11 +1600,11 @@ void ReactiveAgent::runReactivePhase()
 	}
 	//========================
 	else if (_steeringState == STEERING_STATE_TURN_TOWARDS_TARGET) {
-		if ((dot(_finalSteeringCommand.targetDirection,forward()) > ped_same_direction_dot_product_threshold)) {
+		if ((dot(_finalSteeringCommand.targetDirection,forward()) > _ReactiveParams.ped_same_direction_dot_product_threshold)) {
 			_steeringState = STEERING_STATE_NO_THREAT;
 		}
 		_finalSteeringCommand.aimForTargetDirection = true;
-		_finalSteeringCommand.turningAmount = ped_cornering_turn_rate;
+		_finalSteeringCommand.turningAmount = _ReactiveParams.ped_cornering_turn_rate;
 		_finalSteeringCommand.aimForTargetSpeed = true;
 		_finalSteeringCommand.targetSpeed = _currentGoal.desiredSpeed;
 	}
@@ -1597,17 +1624,17 @@ void ReactiveAgent::runReactivePhase()
 			// opposite sides of your direction
 			_finalSteeringCommand.aimForTargetDirection = true;
 			// targetDirection already initialized to point towards the local target location
-			_finalSteeringCommand.turningAmount = ped_adjustment_turn_rate;
+			_finalSteeringCommand.turningAmount = _ReactiveParams.ped_adjustment_turn_rate;
 			_finalSteeringCommand.aimForTargetSpeed = true;
-			_finalSteeringCommand.targetSpeed = ped_typical_speed_factor*_currentGoal.desiredSpeed;
+			_finalSteeringCommand.targetSpeed = _ReactiveParams.ped_typical_speed_factor*_currentGoal.desiredSpeed;
 		}
 		else {
 			// same side, so steer with the crowd.
 			_finalSteeringCommand.aimForTargetDirection = true;
 			_finalSteeringCommand.targetDirection = normalize(_crowdControlDirection);
-			_finalSteeringCommand.turningAmount = ped_adjustment_turn_rate;
+			_finalSteeringCommand.turningAmount = _ReactiveParams.ped_adjustment_turn_rate;
 			_finalSteeringCommand.aimForTargetSpeed = true;
-			_finalSteeringCommand.targetSpeed = ped_typical_speed_factor*_currentGoal.desiredSpeed;
+			_finalSteeringCommand.targetSpeed = _ReactiveParams.ped_typical_speed_factor*_currentGoal.desiredSpeed;
 		}
 
 
@@ -1617,11 +1644,11 @@ void ReactiveAgent::runReactivePhase()
 		if (_threatList[_mostImminentThreatIndex].threatType == PredictedThreat::THREAT_TYPE_ONCOMING) {
 			if (_threatList[_mostImminentThreatIndex].oncomingToRightSide) {
 				_finalSteeringCommand.aimForTargetDirection = false;
-				_finalSteeringCommand.turningAmount = -ped_adjustment_turn_rate;
+				_finalSteeringCommand.turningAmount = -_ReactiveParams.ped_adjustment_turn_rate;
 			}
 			else {
 				_finalSteeringCommand.aimForTargetDirection = false;
-				_finalSteeringCommand.turningAmount = ped_adjustment_turn_rate;
+				_finalSteeringCommand.turningAmount = _ReactiveParams.ped_adjustment_turn_rate;
 			}
 		}
 		else if (_threatList[_mostImminentThreatIndex].threatType == PredictedThreat::THREAT_TYPE_CROSSING_SOON) {
@@ -1631,15 +1658,15 @@ void ReactiveAgent::runReactivePhase()
 			ReactiveAgent * threatGuy = _threatList[_mostImminentThreatIndex].threatGuy;//((Pedestrian*)(imminentThreat->object));
 			if ( dot((_rightSide),threatGuy->forward()) < 0.0f) {
 				_finalSteeringCommand.aimForTargetSpeed = true;
-				_finalSteeringCommand.targetSpeed = ped_slightly_faster_speed_factor*_currentGoal.desiredSpeed;
+				_finalSteeringCommand.targetSpeed = _ReactiveParams.ped_slightly_faster_speed_factor*_currentGoal.desiredSpeed;
 				_finalSteeringCommand.aimForTargetDirection = false;
-				_finalSteeringCommand.turningAmount = -ped_typical_avoidance_turn_rate;
+				_finalSteeringCommand.turningAmount = -_ReactiveParams.ped_typical_avoidance_turn_rate;
 			}
 			else {
 				_finalSteeringCommand.aimForTargetSpeed = true;
-				_finalSteeringCommand.targetSpeed = ped_slightly_faster_speed_factor*_currentGoal.desiredSpeed;
+				_finalSteeringCommand.targetSpeed = _ReactiveParams.ped_slightly_faster_speed_factor*_currentGoal.desiredSpeed;
 				_finalSteeringCommand.aimForTargetDirection = false;
-				_finalSteeringCommand.turningAmount = ped_typical_avoidance_turn_rate;
+				_finalSteeringCommand.turningAmount = _ReactiveParams.ped_typical_avoidance_turn_rate;
 			}
 		}
 		else if (_threatList[_mostImminentThreatIndex].threatType == PredictedThreat::THREAT_TYPE_CROSSING_LATE) {
@@ -1648,15 +1675,15 @@ void ReactiveAgent::runReactivePhase()
 			ReactiveAgent * threatGuy = _threatList[_mostImminentThreatIndex].threatGuy;//((Pedestrian*)(imminentThreat->object));
 			if ( dot((_rightSide),threatGuy->forward()) < 0.0f) {
 				_finalSteeringCommand.aimForTargetSpeed = true;
-				_finalSteeringCommand.targetSpeed = ped_slightly_slower_speed_factor*_currentGoal.desiredSpeed;
+				_finalSteeringCommand.targetSpeed = _ReactiveParams.ped_slightly_slower_speed_factor*_currentGoal.desiredSpeed;
 				_finalSteeringCommand.aimForTargetDirection = false;
-				_finalSteeringCommand.turningAmount = ped_typical_avoidance_turn_rate;
+				_finalSteeringCommand.turningAmount = _ReactiveParams.ped_typical_avoidance_turn_rate;
 			}
 			else {
 				_finalSteeringCommand.aimForTargetSpeed = true;
-				_finalSteeringCommand.targetSpeed = ped_slightly_slower_speed_factor*_currentGoal.desiredSpeed;
+				_finalSteeringCommand.targetSpeed = _ReactiveParams.ped_slightly_slower_speed_factor*_currentGoal.desiredSpeed;
 				_finalSteeringCommand.aimForTargetDirection = false;
-				_finalSteeringCommand.turningAmount = -ped_typical_avoidance_turn_rate;
+				_finalSteeringCommand.turningAmount = -_ReactiveParams.ped_typical_avoidance_turn_rate;
 			}
 		}
 		else {
@@ -1674,21 +1701,21 @@ void ReactiveAgent::runReactivePhase()
 	else if (_steeringState == STEERING_STATE_NO_THREAT) {
 		// steer towards the local target node
 		float td = dot(_finalSteeringCommand.targetDirection,forward());
-		if ((td > ped_wrong_direction_dot_product_threshold) && (td < ped_similar_direction_dot_product_threshold)) {
-			_finalSteeringCommand.turningAmount = ped_faster_avoidance_turn_rate;
+		if ((td > _ReactiveParams.ped_wrong_direction_dot_product_threshold) && (td < _ReactiveParams.ped_similar_direction_dot_product_threshold)) {
+			_finalSteeringCommand.turningAmount = _ReactiveParams.ped_faster_avoidance_turn_rate;
 		}
 		else {
-			_finalSteeringCommand.turningAmount = ped_adjustment_turn_rate;
+			_finalSteeringCommand.turningAmount = _ReactiveParams.ped_adjustment_turn_rate;
 		}
 		_finalSteeringCommand.aimForTargetDirection = true;
 		_finalSteeringCommand.aimForTargetSpeed = true;
-		_finalSteeringCommand.targetSpeed = ped_typical_speed_factor*_currentGoal.desiredSpeed;
+		_finalSteeringCommand.targetSpeed = _ReactiveParams.ped_typical_speed_factor*_currentGoal.desiredSpeed;
 	}
 
 
 	_finalSteeringCommand.steeringMode = SteeringCommand::LOCOMOTION_MODE_COMMAND;
 
-	if (gUseDynamicPhaseScheduling) {
+	if (_aiModule->_gUseDynamicPhaseScheduling) {
 	
 		// potentially give a break to perception
 		if (hitSomething) {
@@ -1725,7 +1752,7 @@ void ReactiveAgent::doSteering()
 {
 	if (!_enabled) return;
 
-	AutomaticFunctionProfiler profileThisFunction( &ReactiveGlobals::gPhaseProfilers->steeringPhaseProfiler );
+	AutomaticFunctionProfiler profileThisFunction( &_aiModule->_phaseProfilers.steeringPhaseProfiler, "reactiveAI::steeringPhase" );
 
 	switch ( _finalSteeringCommand.steeringMode) {
 		case SteeringCommand::LOCOMOTION_MODE_COMMAND:
@@ -1762,7 +1789,7 @@ void ReactiveAgent::doEulerStepWithForce(const Vector & force)
 	// update the database with the new agent's setup
 	AxisAlignedBox oldBounds = AxisAlignedBox(_position.x - _radius, _position.x + _radius, 0.0f, 0.0f, _position.z - _radius, _position.z + _radius);
 	AxisAlignedBox newBounds = AxisAlignedBox(newPosition.x - _radius, newPosition.x + _radius, 0.0f, 0.0f, newPosition.z - _radius, newPosition.z + _radius);
-	gSpatialDatabase->updateObject( dynamic_cast<SpatialDatabaseItemPtr>(this), oldBounds, newBounds);
+	_gSpatialDatabase->updateObject( dynamic_cast<SpatialDatabaseItemPtr>(this), oldBounds, newBounds);
 
 	_position = newPosition;
 }
@@ -1796,12 +1823,12 @@ void ReactiveAgent::doCommandBasedSteering()
 	//
 	if (!_finalSteeringCommand.aimForTargetDirection) {
 		// simple turning case "turn left" or "turn right"
-		newForward = _forward + ped_max_turning_rate * _finalSteeringCommand.turningAmount * _rightSide;
+		newForward = _forward + _ReactiveParams.ped_max_turning_rate * _finalSteeringCommand.turningAmount * _rightSide;
 	}
 	else {
 		// turn to face "targetDirection" - magnitude of targetDirection doesn't matter
 		float initialDot = dot(_finalSteeringCommand.targetDirection,_rightSide);
-		float turningRate = (initialDot > 0.0f) ? ped_max_turning_rate : -ped_max_turning_rate;  // positive rate is right-turn
+		float turningRate = (initialDot > 0.0f) ? _ReactiveParams.ped_max_turning_rate : -_ReactiveParams.ped_max_turning_rate;  // positive rate is right-turn
 		newForward = _forward + turningRate * fabsf(_finalSteeringCommand.turningAmount) * _rightSide;
 		float newDot = dot(_finalSteeringCommand.targetDirection, rightSideInXZPlane(newForward)); // dot with the new side vector
 		if (initialDot*newDot <= 0.0f) {
@@ -1850,7 +1877,7 @@ void ReactiveAgent::doCommandBasedSteering()
 		// if delta-speed == -speed
 		// force * mass * time-step = -speed
 		//
-		float maxBackwardsForce = (-ped_braking_rate * fabsf(_currentSpeed) * _mass / _dt);
+		float maxBackwardsForce = (-_ReactiveParams.ped_braking_rate * fabsf(_currentSpeed) * _mass / _dt);
 		float scalarForce = (_finalSteeringCommand.targetSpeed - _currentSpeed) * 8.0f; // crudely trying to make accelerations quicker...
 		if (scalarForce > _maxForce) scalarForce = _maxForce;
 		if (scalarForce < maxBackwardsForce) scalarForce = maxBackwardsForce;
@@ -1859,7 +1886,7 @@ void ReactiveAgent::doCommandBasedSteering()
 
 	// TODO: should we clamp scoot?
 	// add the side-to-side motion to the planned steering force.
-	totalSteeringForce = totalSteeringForce + ped_scoot_rate * _finalSteeringCommand.scoot * _rightSide;
+	totalSteeringForce = totalSteeringForce + _ReactiveParams.ped_scoot_rate * _finalSteeringCommand.scoot * _rightSide;
 
 	doEulerStepWithForce(totalSteeringForce);
 
@@ -1876,9 +1903,9 @@ void ReactiveAgent::doCommandBasedSteering()
 void ReactiveAgent::collectObjectsInVisualField()
 {
 	_neighbors.clear();
-	gSpatialDatabase->getItemsInVisualField(_neighbors, _position.x-ped_query_radius, _position.x+ped_query_radius,
-		_position.z-ped_query_radius, _position.z+ped_query_radius, dynamic_cast<SpatialDatabaseItemPtr>(this),
-		_position, _forward, (float)(ped_query_radius*ped_query_radius));
+	_gSpatialDatabase->getItemsInVisualField(_neighbors, _position.x-_ReactiveParams.ped_query_radius, _position.x+_ReactiveParams.ped_query_radius,
+		_position.z-_ReactiveParams.ped_query_radius, _position.z+_ReactiveParams.ped_query_radius, dynamic_cast<SpatialDatabaseItemPtr>(this),
+		_position, _forward, (float)(_ReactiveParams.ped_query_radius*_ReactiveParams.ped_query_radius));
 }
 
 
@@ -1887,7 +1914,7 @@ void ReactiveAgent::collectObjectsInVisualField()
 //
 bool ReactiveAgent::reachedCurrentGoal()
 {
-	return ( (_currentGoal.targetLocation-_position).lengthSquared() < (ped_reached_target_distance_threshold * ped_reached_target_distance_threshold) );
+	return ( (_currentGoal.targetLocation-_position).lengthSquared() < (_ReactiveParams.ped_reached_target_distance_threshold * _ReactiveParams.ped_reached_target_distance_threshold) );
 }
 
 
@@ -1905,8 +1932,8 @@ bool ReactiveAgent::reachedCurrentWaypoint()
 
 
 #endif
-	return ( (_localTargetLocation-_position).lengthSquared() < (ped_reached_target_distance_threshold * ped_reached_target_distance_threshold) );
-	// return ( (_waypoints[_currentWaypointIndex]-_position).lengthSquared() < (ped_reached_target_distance_threshold * ped_reached_target_distance_threshold) );
+	return ( (_localTargetLocation-_position).lengthSquared() < (_ReactiveParams.ped_reached_target_distance_threshold * _ReactiveParams.ped_reached_target_distance_threshold) );
+	// return ( (_waypoints[_currentWaypointIndex]-_position).lengthSquared() < (_ReactiveParams.ped_reached_target_distance_threshold * _ReactiveParams.ped_reached_target_distance_threshold) );
 }
 
 
@@ -1916,7 +1943,7 @@ bool ReactiveAgent::reachedCurrentWaypoint()
 //
 bool ReactiveAgent::reachedLocalTarget()
 {
-	return ( (_localTargetLocation-_position).lengthSquared() < (ped_reached_target_distance_threshold * ped_reached_target_distance_threshold) );
+	return ( (_localTargetLocation-_position).lengthSquared() < (_ReactiveParams.ped_reached_target_distance_threshold * _ReactiveParams.ped_reached_target_distance_threshold) );
 }
 
 
@@ -1940,26 +1967,29 @@ bool ReactiveAgent::threatListContainsAgent(ReactiveAgent * agent, unsigned int
 //
 bool ReactiveAgent::updateReactiveFeelers( FeelerInfo & feelers )
 {
-	// TODO: would it be faster to use one ray and just keep re-initializing it?
-
 	Ray myRay, myLeftRay, myRightRay, myLSideRay, myRSideRay;
 
 	feelers.clear();
 
 	// Adjusting feeler length to compensate for issues with pprAI not being able to choose which direction to turn and
 	// proceeding through an obstacle. SHould make these parameters.
-	myRay.initWithLengthInterval(_position, _forward * (ped_typical_speed*ped_reactive_anticipation_factor) * 1.1f);
-	myRightRay.initWithLengthInterval( _position + _radius * _rightSide ,  ((_forward * 0.75f) + 0.1f*_rightSide)* (ped_typical_speed*ped_reactive_anticipation_factor));
-	myLeftRay.initWithLengthInterval( _position - _radius * _rightSide,  ((_forward * 0.75f) - 0.1f*_rightSide)* (ped_typical_speed*ped_reactive_anticipation_factor));
-	myRSideRay.initWithLengthInterval( _position + _radius * _rightSide,  (0.05f * _forward + 0.1f * _rightSide)* (ped_typical_speed*ped_reactive_anticipation_factor));
-	myLSideRay.initWithLengthInterval( _position - _radius * _rightSide,  (0.05f * _forward - 0.1f * _rightSide)* (ped_typical_speed*ped_reactive_anticipation_factor));
+	myRay.initWithLengthInterval(_position, _forward * (_ReactiveParams.ped_typical_speed*_ReactiveParams.ped_reactive_anticipation_factor) * 1.1f);
+	myRightRay.initWithLengthInterval( _position + _radius * _rightSide ,  ((_forward * 0.75f) + 0.1f*_rightSide)* (_ReactiveParams.ped_typical_speed*_ReactiveParams.ped_reactive_anticipation_factor));
+	myLeftRay.initWithLengthInterval( _position - _radius * _rightSide,  ((_forward * 0.75f) - 0.1f*_rightSide)* (_ReactiveParams.ped_typical_speed*_ReactiveParams.ped_reactive_anticipation_factor));
+	myRSideRay.initWithLengthInterval( _position + _radius * _rightSide,  (0.05f * _forward + 0.1f * _rightSide)* (_ReactiveParams.ped_typical_speed*_ReactiveParams.ped_reactive_anticipation_factor));
+	myLSideRay.initWithLengthInterval( _position - _radius * _rightSide,  (0.05f * _forward - 0.1f * _rightSide)* (_ReactiveParams.ped_typical_speed*_ReactiveParams.ped_reactive_anticipation_factor));
 
 	SpatialDatabaseItemPtr me = dynamic_cast<SpatialDatabaseItemPtr>(this);
-	gSpatialDatabase->trace(myRay,      feelers.t_front, feelers.object_front, me, false);
-	gSpatialDatabase->trace(myRightRay, feelers.t_right, feelers.object_right, me, false);
-	gSpatialDatabase->trace(myLeftRay,  feelers.t_left,  feelers.object_left,  me, false);
-	gSpatialDatabase->trace(myRSideRay, feelers.t_rside, feelers.object_rside, me, false);
-	gSpatialDatabase->trace(myLSideRay, feelers.t_lside, feelers.object_lside, me, false);
+	// the five feelers start next to each other, so trace them as one packet.
+	Ray feelerRays[5] = { myRay, myRightRay, myLeftRay, myRSideRay, myLSideRay };
+	float feelerT[5] = { feelers.t_front, feelers.t_right, feelers.t_left, feelers.t_rside, feelers.t_lside };
+	SpatialDatabaseItemPtr feelerObjects[5];
+	_gSpatialDatabase->tracePacket(feelerRays, 5, feelerT, feelerObjects, me, false);
+	feelers.t_front = feelerT[0];  feelers.object_front = feelerObjects[0];
+	feelers.t_right = feelerT[1];  feelers.object_right = feelerObjects[1];
+	feelers.t_left  = feelerT[2];  feelers.object_left  = feelerObjects[2];
+	feelers.t_rside = feelerT[3];  feelers.object_rside = feelerObjects[3];
+	feelers.t_lside = feelerT[4];  feelers.object_lside = feelerObjects[4];
 
 #ifdef USE_ANNOTATIONS
 	__myRay = myRay;
@@ -1996,10 +2026,16 @@ void ReactiveAgent::disable()
 
 	//  1. remove from database
 	AxisAlignedBox b = AxisAlignedBox(_position.x - _radius, _position.x + _radius, 0.0f, 0.0f, _position.z - _radius, _position.z + _radius);
-	gSpatialDatabase->removeObject(dynamic_cast<SpatialDatabaseItemPtr>(this), b);
+	_gSpatialDatabase->removeObject(dynamic_cast<SpatialDatabaseItemPtr>(this), b);
 
 	//  2. set enabled = false
 	_enabled = false;
+
+	//  3. give up its phase slots to the other agents
+	if (_phaseSchedulerClient >= 0) {
+		_aiModule->_phaseScheduler.removeClient((unsigned int)_phaseSchedulerClient);
+		_phaseSchedulerClient = -1;
+	}
 }
 
 
@@ -2026,10 +2062,10 @@ void ReactiveAgent::drawPlannedPath()
 		for (unsigned int i=0; i < longTermPath.size() - 1; i++) {
 			Vector xOffset,zOffset;
 			Point center,nextCenter;
-			xOffset.x = 0.5f * gSpatialDatabase->getCellSizeX();
-			zOffset.z = 0.5f * gSpatialDatabase->getCellSizeZ();
-			gSpatialDatabase->getLocationFromIndex(longTermPath._Get_container()[i], center); // DOes not work on LInux
-			gSpatialDatabase->getLocationFromIndex(longTermPath._Get_container()[i+1], nextCenter);
+			xOffset.x = 0.5f * _gSpatialDatabase->getCellSizeX();
+			zOffset.z = 0.5f * _gSpatialDatabase->getCellSizeZ();
+			_gSpatialDatabase->getLocationFromIndex(longTermPath._Get_container()[i], center); // DOes not work on LInux
+			_gSpatialDatabase->getLocationFromIndex(longTermPath._Get_container()[i+1], nextCenter);
 			center.y = 0.01f;
 			nextCenter.y = 0.01f;
 			DrawLib::glColor(gDarkBlue);
@@ -2058,10 +2094,10 @@ void ReactiveAgent::drawPlannedPath()
 		for (unsigned int i=0; i < longTermPath.size() - 1; i++) {
 			Vector xOffset,zOffset;
 			Point center,nextCenter;
-			xOffset.x = 0.5f * gSpatialDatabase->getCellSizeX();
-			zOffset.z = 0.5f * gSpatialDatabase->getCellSizeZ();
-			gSpatialDatabase->getLocationFromIndex(ltpath->at(i), center);
-			gSpatialDatabase->getLocationFromIndex(ltpath->at(i+1), nextCenter);
+			xOffset.x = 0.5f * _gSpatialDatabase->getCellSizeX();
+			zOffset.z = 0.5f * _gSpatialDatabase->getCellSizeZ();
+			_gSpatialDatabase->getLocationFromIndex(ltpath->at(i), center);
+			_gSpatialDatabase->getLocationFromIndex(ltpath->at(i+1), nextCenter);
 			center.y = 0.01f;
 			nextCenter.y = 0.01f;
 			DrawLib::glColor(gDarkBlue);
@@ -2082,10 +2118,10 @@ void ReactiveAgent::drawPlannedPath()
 		for (unsigned int i=0; i < _midTermPathSize - 1; i++) {
 			Vector xOffset,zOffset;
 			Point center,nextCenter;
-			xOffset.x = 0.5f * gSpatialDatabase->getCellSizeX();
-			zOffset.z = 0.5f * gSpatialDatabase->getCellSizeZ();
-			gSpatialDatabase->getLocationFromIndex(_midTermPath[i], center);
-			gSpatialDatabase->getLocationFromIndex(_midTermPath[i+1], nextCenter);
+			xOffset.x = 0.5f * _gSpatialDatabase->getCellSizeX();
+			zOffset.z = 0.5f * _gSpatialDatabase->getCellSizeZ();
+			_gSpatialDatabase->getLocationFromIndex(_midTermPath[i], center);
+			_gSpatialDatabase->getLocationFromIndex(_midTermPath[i+1], nextCenter);
 			center.y = 0.02f;
 			nextCenter.y = 0.02f;
 			DrawLib::glColor(gBlue);
@@ -2095,7 +2131,7 @@ void ReactiveAgent::drawPlannedPath()
 
 	// draw a marker on the closest node you are to the mid-term path (computed from short-term planning)
 	Point closestNodeOnPath;
-	gSpatialDatabase->getLocationFromIndex(_midTermPath[__closestPathNode],closestNodeOnPath);
+	_gSpatialDatabase->getLocationFromIndex(_midTermPath[__closestPathNode],closestNodeOnPath);
 	DrawLib::drawHighlight(closestNodeOnPath, Vector(1.0f, 0.0f, 0.0f), 0.5f, gBlue);
 	//drawXZCircle(0.30f, closestNodeOnPath, gBlue, 10);
 
@@ -2118,7 +2154,7 @@ void ReactiveAgent::draw()
 	// DrawLib::drawAgent
 #ifdef ENABLE_GUI
 	if (!_enabled) return;
-	AutomaticFunctionProfiler profileThisFunction( &ReactiveGlobals::gPhaseProfilers->drawProfiler );
+	AutomaticFunctionProfiler profileThisFunction( &_aiModule->_phaseProfilers.drawProfiler, "reactiveAI::draw" );
 
 
 #ifndef USE_ANNOTATIONS
@@ -2142,7 +2178,7 @@ void ReactiveAgent::draw()
 	/*
 	std::set<SteerLib::SpatialDatabaseItemPtr> _neighbors;
 	*/
-	gSpatialDatabase->getItemsInRange(_neighbors, this->position().x-(this->_radius * 3), this->position().x+(this->_radius * 3),
+	_gSpatialDatabase->getItemsInRange(_neighbors, this->position().x-(this->_radius * 3), this->position().x+(this->_radius * 3),
 			this->position().z-(this->_radius * 3), this->position().z+(this->_radius * 3), dynamic_cast<SteerLib::SpatialDatabaseItemPtr>(this));
 
 	for (std::set<SteerLib::SpatialDatabaseItemPtr>::iterator neighbor = _neighbors.begin();  neighbor != _neighbors.end();  neighbor++)
@@ -2192,7 +2228,7 @@ void ReactiveAgent::draw()
 	Vector verticalOffset = Vector(0.0f, 0.03f, 0.0f);
 	// Vector testingLengthVec = Vector(0.0f, )
 
-	float speedRatio = _currentSpeed / ped_typical_speed;
+	float speedRatio = _currentSpeed / _ReactiveParams.ped_typical_speed;
 	__myPredictorRay.initWithUnitInterval(__myRay.pos + verticalOffset, __myRay.dir*__myRay.maxt*speedRatio);
 	__myPredictorRightRay.initWithUnitInterval(__myRightRay.pos + verticalOffset, __myRightRay.dir*__myRightRay.maxt*speedRatio);
 	__myPredictorLeftRay.initWithUnitInterval(__myLeftRay.pos + verticalOffset, __myLeftRay.dir*__myLeftRay.maxt*speedRatio);
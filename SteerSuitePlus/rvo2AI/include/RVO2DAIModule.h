@@ -36,39 +36,15 @@ namespace RVO2DGlobals {
 		Util::PerformanceProfiler reactivePhaseProfiler;
 		Util::PerformanceProfiler steeringPhaseProfiler;
 	};
-
-
-	// extern SteerLib::EngineInterface * gEngineInfo;
-	// extern SteerLib::SpatialDataBaseInterface * gSpatialDatabase;
-	extern unsigned int gLongTermPlanningPhaseInterval;
-	extern unsigned int gMidTermPlanningPhaseInterval;
-	extern unsigned int gShortTermPlanningPhaseInterval;
-	extern unsigned int gPredictivePhaseInterval;
-	extern unsigned int gReactivePhaseInterval;
-	extern unsigned int gPerceptivePhaseInterval;
-	extern bool gUseDynamicPhaseScheduling;
-	extern bool gShowStats;
-	extern bool gShowAllStats;
-	extern bool dont_plan;
-
-
-	// Adding a bunch of parameters so they can be changed via input
-	extern float rvo_neighbor_distance;
-	extern float rvo_time_horizon;
-	extern float rvo_max_speed;
-	extern float rvo_preferred_speed;
-	extern float rvo_time_horizon_obstacles;
-	extern int rvo_max_neighbors;
-	extern int next_waypoint_distance;
-
-
-	extern PhaseProfilers * gPhaseProfilers;
 }
 
 
 class RVO2DAIModule : public SteerLib::ModuleInterface
 {
 public:
+	RVO2DAIModule();
+	/// Closes the module's log, see LogManager::destroyLogger().
+	~RVO2DAIModule();
 	
 	void cleanupSimulation();
 	void preprocessSimulation();
@@ -101,6 +77,18 @@ protected:
 	std::vector<LogObject *> _logData;
 
 	SteerLib::EngineInterface * _gEngine;
+	unsigned int _gLongTermPlanningPhaseInterval;
+	bool _gUseDynamicPhaseScheduling;
+	bool _gShowStats;
+	bool _gShowAllStats;
+	bool _dontPlan;
+
+	/// The parameters given to the module; every new agent starts with a copy of these.
+	RVO2DParameters _RVO2DParams;
+	/// The profilers shared by all agents of this module.
+	RVO2DGlobals::PhaseProfilers _phaseProfilers;
+
+	friend class RVO2DAgent;
 };
 
 #endif
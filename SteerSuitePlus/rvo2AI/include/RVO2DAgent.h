@@ -17,6 +17,8 @@
 #include "Obstacle.h"
 #include "RVO2D_Parameters.h"
 
+class RVO2DAIModule;
+
 
 /**
  * @brief An example agent with very basic AI, that is part of the simpleAI plugin.
@@ -130,7 +132,7 @@ protected:
 	// std::vector<std::pair<float, const Obstacle *> > obstacleNeighbors_;
 	std::vector<Util::Plane> orcaPlanes_;
 	std::vector<Line> orcaLines_;
-	SteerLib::ModuleInterface * rvoModule;
+	RVO2DAIModule * rvoModule;
 
 	SteerLib::EngineInterface * _gEngine;
 
@@ -17,40 +17,6 @@
 #include "LogManager.h"
 
 
-// globally accessible to the simpleAI plugin
-// SteerLib::EngineInterface * gEngine;
-// SteerLib::SpatialDataBaseInterface * gSpatialDatabase;
-
-namespace RVO2DGlobals
-{
-
-	// SteerLib::EngineInterface * gEngineInfo;
-	// SteerLib::SpatialDataBaseInterface * gSpatialDatabase;
-	unsigned int gLongTermPlanningPhaseInterval;
-	unsigned int gMidTermPlanningPhaseInterval;
-	unsigned int gShortTermPlanningPhaseInterval;
-	unsigned int gPredictivePhaseInterval;
-	unsigned int gReactivePhaseInterval;
-	unsigned int gPerceptivePhaseInterval;
-	bool gUseDynamicPhaseScheduling;
-	bool gShowStats;
-	bool gShowAllStats;
-	bool dont_plan;
-
-
-	// Adding a bunch of parameters so they can be changed via input
-	float rvo_neighbor_distance;
-	float rvo_time_horizon;
-	float rvo_max_speed;
-	float rvo_preferred_speed;
-	float rvo_time_horizon_obstacles;
-	int rvo_max_neighbors;
-	int next_waypoint_distance;
-
-
-	PhaseProfilers * gPhaseProfilers;
-}
-
 using namespace RVO2DGlobals;
 
 PLUGIN_API SteerLib::ModuleInterface * createModule()
@@ -64,61 +30,72 @@ PLUGIN_API void destroyModule( SteerLib::ModuleInterface*  module )
 }
 
 
+RVO2DAIModule::RVO2DAIModule()
+{
+	_rvoLogger = NULL;
+}
+
+RVO2DAIModule::~RVO2DAIModule()
+{
+	LogManager::getInstance()->destroyLogger(_rvoLogger);
+}
+
 void RVO2DAIModule::init( const SteerLib::OptionDictionary & options, SteerLib::EngineInterface * engineInfo )
 {
 	_gEngine = engineInfo;
 	// gSpatialDatabase = engineInfo->getSpatialDatabase();
 
-	gUseDynamicPhaseScheduling = false;
-	gShowStats = false;
+	_gLongTermPlanningPhaseInterval = 0;
+	_gUseDynamicPhaseScheduling = false;
+	_gShowStats = false;
 	logStats = false;
-	gShowAllStats = false;
+	_gShowAllStats = false;
 	logFilename = "rvo2AI.log";
-	dont_plan=false;
+	_dontPlan=false;
 
-	rvo_max_neighbors = MAX_NEIGHBORS;
-	rvo_max_speed = MAX_SPEED;
-	rvo_neighbor_distance = NEIGHBOR_DISTANCE;
-	rvo_time_horizon = TIME_HORIZON;
-	rvo_time_horizon_obstacles = TIME_HORIZON_OBSTACLES;
-	next_waypoint_distance = NEXT_WAYPOINT_DISTANCE;
+	_RVO2DParams.rvo_max_neighbors = MAX_NEIGHBORS;
+	_RVO2DParams.rvo_max_speed = MAX_SPEED;
+	_RVO2DParams.rvo_neighbor_distance = NEIGHBOR_DISTANCE;
+	_RVO2DParams.rvo_time_horizon = TIME_HORIZON;
+	_RVO2DParams.rvo_time_horizon_obstacles = TIME_HORIZON_OBSTACLES;
+	_RVO2DParams.next_waypoint_distance = NEXT_WAYPOINT_DISTANCE;
 
 	SteerLib::OptionDictionary::const_iterator optionIter;
 	for (optionIter = options.begin(); optionIter != options.end(); ++optionIter) {
 		std::stringstream value((*optionIter).second);
 		if ((*optionIter).first == "")
 		{
-			value >> gLongTermPlanningPhaseInterval;
+			value >> _gLongTermPlanningPhaseInterval;
 		}
 		else if ((*optionIter).first == "rvo_neighbor_distance")
 		{
-			value >> rvo_neighbor_distance;
+			value >> _RVO2DParams.rvo_neighbor_distance;
 		}
 		else if ((*optionIter).first == "rvo_time_horizon")
 		{
-			value >> rvo_time_horizon;
+			value >> _RVO2DParams.rvo_time_horizon;
 		}
 		else if ((*optionIter).first == "rvo_max_speed")
 		{
-			value >> rvo_max_speed;
+			value >> _RVO2DParams.rvo_max_speed;
 		}
 		else if ((*optionIter).first == "rvo_preferred_speed")
 		{
-			value >> rvo_preferred_speed;
+			value >> _RVO2DParams.rvo_preferred_speed;
 		}
 		else if ((*optionIter).first == "rvo_time_horizon_obstacles")
 		{
 			std::cout << "Setting rvo_time_horizon_obstacles to: " << value.str() << std::endl;
-			value >> rvo_time_horizon_obstacles;
+			value >> _RVO2DParams.rvo_time_horizon_obstacles;
 		}
 		else if ((*optionIter).first == "rvo_max_neighbors")
 		{
-			value >> rvo_max_neighbors;
+			value >> _RVO2DParams.rvo_max_neighbors;
 		}
 		else if ((*optionIter).first == "next_waypoint_distance")
 		{
 			std::cout << "Setting next_waypoint_distance to: " << value.str() << std::endl;
-			value >> next_waypoint_distance;
+			value >> _RVO2DParams.next_waypoint_distance;
 		}
 		else if ((*optionIter).first == "ailogFileName")
 		{
@@ -127,15 +104,15 @@ void RVO2DAIModule::init( const SteerLib::OptionDictionary & options, SteerLib::
 		}
 		else if ((*optionIter).first == "stats")
 		{
-			gShowStats = Util::getBoolFromString(value.str());
+			_gShowStats = Util::getBoolFromString(value.str());
 		}
 		else if ((*optionIter).first == "allstats")
 		{
-			gShowAllStats = Util::getBoolFromString(value.str());
+			_gShowAllStats = Util::getBoolFromString(value.str());
 		}
 		else if ((*optionIter).first == "dont_plan")
 		{
-			dont_plan = Util::getBoolFromString(value.str());
+			_dontPlan = Util::getBoolFromString(value.str());
 		}
 		else
 		{
@@ -143,6 +120,8 @@ void RVO2DAIModule::init( const SteerLib::OptionDictionary & options, SteerLib::
 		}
 	}
 
+	// a module that is initialized again starts a new log under the same name.
+	LogManager::getInstance()->destroyLogger(_rvoLogger);
 	_rvoLogger = LogManager::getInstance()->createLogger(logFilename,LoggerType::BASIC_WRITE);
 
 	_rvoLogger->addDataField("number_of_times_executed",DataType::LongLong );
@@ -175,15 +154,14 @@ void RVO2DAIModule::initializeSimulation()
 	//
 	// initialize the performance profilers
 	//
-	gPhaseProfilers = new PhaseProfilers;
-	gPhaseProfilers->aiProfiler.reset();
-	gPhaseProfilers->longTermPhaseProfiler.reset();
-	gPhaseProfilers->midTermPhaseProfiler.reset();
-	gPhaseProfilers->shortTermPhaseProfiler.reset();
-	gPhaseProfilers->perceptivePhaseProfiler.reset();
-	gPhaseProfilers->predictivePhaseProfiler.reset();
-	gPhaseProfilers->reactivePhaseProfiler.reset();
-	gPhaseProfilers->steeringPhaseProfiler.reset();
+	_phaseProfilers.aiProfiler.reset();
+	_phaseProfilers.longTermPhaseProfiler.reset();
+	_phaseProfilers.midTermPhaseProfiler.reset();
+	_phaseProfilers.shortTermPhaseProfiler.reset();
+	_phaseProfilers.perceptivePhaseProfiler.reset();
+	_phaseProfilers.predictivePhaseProfiler.reset();
+	_phaseProfilers.reactivePhaseProfiler.reset();
+	_phaseProfilers.steeringPhaseProfiler.reset();
 
 }
 
@@ -230,6 +208,7 @@ SteerLib::AgentInterface * RVO2DAIModule::createAgent()
 	agent->_id = agents_.size();
 	agents_.push_back(agent);
 	agent->_gEngine = this->_gEngine;
+	agent->_RVO2DParams = _RVO2DParams;
 	return agent;
 }
 
@@ -288,15 +267,15 @@ void RVO2DAIModule::cleanupSimulation()
 
 		LogObject rvoLogObject;
 
-		rvoLogObject.addLogData(gPhaseProfilers->aiProfiler.getNumTimesExecuted());
-		rvoLogObject.addLogData(gPhaseProfilers->aiProfiler.getTotalTicksAccumulated());
-		rvoLogObject.addLogData(gPhaseProfilers->aiProfiler.getMinTicks());
-		rvoLogObject.addLogData(gPhaseProfilers->aiProfiler.getMaxTicks());
-		rvoLogObject.addLogData(gPhaseProfilers->aiProfiler.getMinExecutionTimeMills());
-		rvoLogObject.addLogData(gPhaseProfilers->aiProfiler.getMaxExecutionTimeMills());
-		rvoLogObject.addLogData(gPhaseProfilers->aiProfiler.getAverageExecutionTimeMills());
-		rvoLogObject.addLogData(gPhaseProfilers->aiProfiler.getTotalTime());
-		rvoLogObject.addLogData(gPhaseProfilers->aiProfiler.getTickFrequency());
+		rvoLogObject.addLogData(_phaseProfilers.aiProfiler.getNumTimesExecuted());
+		rvoLogObject.addLogData(_phaseProfilers.aiProfiler.getTotalTicksAccumulated());
+		rvoLogObject.addLogData(_phaseProfilers.aiProfiler.getMinTicks());
+		rvoLogObject.addLogData(_phaseProfilers.aiProfiler.getMaxTicks());
+		rvoLogObject.addLogData(_phaseProfilers.aiProfiler.getMinExecutionTimeMills());
+		rvoLogObject.addLogData(_phaseProfilers.aiProfiler.getMaxExecutionTimeMills());
+		rvoLogObject.addLogData(_phaseProfilers.aiProfiler.getAverageExecutionTimeMills());
+		rvoLogObject.addLogData(_phaseProfilers.aiProfiler.getTotalTime());
+		rvoLogObject.addLogData(_phaseProfilers.aiProfiler.getTickFrequency());
 
 		_logData.push_back(rvoLogObject.copy());
 	if ( logStats )
@@ -306,13 +285,13 @@ void RVO2DAIModule::cleanupSimulation()
 		// cleanup profiling metrics for next simulation/scenario
 	}
 
-	gPhaseProfilers->aiProfiler.reset();
-	gPhaseProfilers->longTermPhaseProfiler.reset();
-	gPhaseProfilers->midTermPhaseProfiler.reset();
-	gPhaseProfilers->shortTermPhaseProfiler.reset();
-	gPhaseProfilers->perceptivePhaseProfiler.reset();
-	gPhaseProfilers->predictivePhaseProfiler.reset();
-	gPhaseProfilers->reactivePhaseProfiler.reset();
-	gPhaseProfilers->steeringPhaseProfiler.reset();
+	_phaseProfilers.aiProfiler.reset();
+	_phaseProfilers.longTermPhaseProfiler.reset();
+	_phaseProfilers.midTermPhaseProfiler.reset();
+	_phaseProfilers.shortTermPhaseProfiler.reset();
+	_phaseProfilers.perceptivePhaseProfiler.reset();
+	_phaseProfilers.predictivePhaseProfiler.reset();
+	_phaseProfilers.reactivePhaseProfiler.reset();
+	_phaseProfilers.steeringPhaseProfiler.reset();
 	// kdTree_->deleteObstacleTree(kdTree_->obstacleTree_);
 }
@@ -30,12 +30,6 @@ using namespace SteerLib;
 
 RVO2DAgent::RVO2DAgent()
 {
-	_RVO2DParams.rvo_max_neighbors  = rvo_max_neighbors ;
-	_RVO2DParams.rvo_max_speed  = rvo_max_speed ;
-	_RVO2DParams.rvo_neighbor_distance  = rvo_neighbor_distance ;
-	_RVO2DParams.rvo_time_horizon  = rvo_time_horizon ;
-	_RVO2DParams.rvo_time_horizon_obstacles  = rvo_time_horizon_obstacles ;
-	_RVO2DParams.next_waypoint_distance = next_waypoint_distance;
 	_enabled = false;
 }
 
@@ -202,7 +196,7 @@ void RVO2DAgent::reset(const SteerLib::AgentInitialConditions & initialCondition
 	// this->_position = vert;
 	// std::cout << "Number of goals " << _goalQueue.size() << std::endl;
 	// std::cout << "location of goals.front " << _goalQueue.front().targetLocation << std::endl;
-	runLongTermPlanning(_goalQueue.front().targetLocation, dont_plan);
+	runLongTermPlanning(_goalQueue.front().targetLocation, rvoModule->_dontPlan);
 	 
 	if ( !_waypoints.empty() )
 	{
@@ -668,7 +662,7 @@ void RVO2DAgent::insertObstacleNeighbor(const ObstacleInterface *obstacle, float
 void RVO2DAgent::updateAI(float timeStamp, float dt, unsigned int frameNumber)
 {
 	// std::cout << "_RVO2DParams.rvo_max_speed " << _RVO2DParams._RVO2DParams.rvo_max_speed << std::endl;
-	Util::AutomaticFunctionProfiler profileThisFunction( &RVO2DGlobals::gPhaseProfilers->aiProfiler );
+	Util::AutomaticFunctionProfiler profileThisFunction( &rvoModule->_phaseProfilers.aiProfiler, "rvo2AI::updateAI" );
 	if (!enabled())
 	{
 		return;
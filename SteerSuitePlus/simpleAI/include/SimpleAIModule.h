@@ -16,10 +16,6 @@
 
 
 
-// globally accessible to the simpleAI plugin
-extern SteerLib::EngineInterface * gEngine;
-extern SteerLib::SpatialDataBaseInterface * gSpatialDatabase;
-
 namespace SimpleAIGlobals {
 
 	struct PhaseProfilers {
@@ -33,19 +29,6 @@ namespace SimpleAIGlobals {
 		Util::PerformanceProfiler reactivePhaseProfiler;
 		Util::PerformanceProfiler steeringPhaseProfiler;
 	};
-
-
-	extern unsigned int gLongTermPlanningPhaseInterval;
-	extern unsigned int gMidTermPlanningPhaseInterval;
-	extern unsigned int gShortTermPlanningPhaseInterval;
-	extern unsigned int gPredictivePhaseInterval;
-	extern unsigned int gReactivePhaseInterval;
-	extern unsigned int gPerceptivePhaseInterval;
-	extern bool gUseDynamicPhaseScheduling;
-	extern bool gShowStats;
-	extern bool gShowAllStats;
-
-	extern PhaseProfilers * gPhaseProfilers;
 }
 
 
@@ -64,17 +47,27 @@ namespace SimpleAIGlobals {
  *  - The SimpleAgent class inherits from SteerLib::AgentInterface, which is the agent steering AI used by the engine.
  *    this agent serves as an example of how to create your own steering AI using SteerLib features.
  *
+ * All state of the plugin belongs to the module instance, so that several engines can use the plugin at the same time.
+ *
  */
 class SimpleAIModule : public SteerLib::ModuleInterface
 {
 public:
+	SimpleAIModule();
+	/// Closes the module's log, see LogManager::destroyLogger().
+	~SimpleAIModule();
 	
 	//std::string getDependencies() { return "testCasePlayer"; }
 	std::string getDependencies() { return ""; }
 	
 	std::string getConflicts() { return ""; }
 	std::string getData() { return ""; }
-	LogData * getLogData() { return new LogData(); }
+	LogData * getLogData()
+	{
+		LogData * lD = new LogData();
+		lD->setLogger(this->_logger);
+		return lD;
+	}
 	void init( const SteerLib::OptionDictionary & options, SteerLib::EngineInterface * engineInfo );
 	void finish();
 	SteerLib::AgentInterface * createAgent();
@@ -90,6 +83,15 @@ protected:
 	std::string logFilename; // = "AI.log";
 	bool logStats; // = false;
 	Logger * _logger;
+
+	SteerLib::EngineInterface * _gEngine;
+	unsigned int _gLongTermPlanningPhaseInterval;
+	bool _gUseDynamicPhaseScheduling;
+	bool _gShowStats;
+	bool _gShowAllStats;
+
+	/// The profilers shared by all agents of this module.
+	SimpleAIGlobals::PhaseProfilers _phaseProfilers;
 };
 
 #endif
@@ -68,6 +68,14 @@ protected:
 
 
 	virtual SteerLib::EngineInterface * getSimulationEngine();
+
+	/// The engine and spatial database of the module that created this agent.
+	SteerLib::EngineInterface * _gEngine;
+	SteerLib::SpatialDataBaseInterface * _gSpatialDatabase;
+	/// The profilers of the module that created this agent.
+	SimpleAIGlobals::PhaseProfilers * _phaseProfilers;
+
+	friend class SimpleAIModule;
 };
 
 #endif
@@ -16,26 +16,6 @@
 #include "LogObject.h"
 #include "LogManager.h"
 
-
-// globally accessible to the simpleAI plugin
-SteerLib::EngineInterface * gEngine;
-SteerLib::SpatialDataBaseInterface * gSpatialDatabase;
-
-namespace SimpleAIGlobals
-{
-	unsigned int gLongTermPlanningPhaseInterval;
-	unsigned int gMidTermPlanningPhaseInterval;
-	unsigned int gShortTermPlanningPhaseInterval;
-	unsigned int gPredictivePhaseInterval;
-	unsigned int gReactivePhaseInterval;
-	unsigned int gPerceptivePhaseInterval;
-	bool gUseDynamicPhaseScheduling;
-	bool gShowStats;
-	bool gShowAllStats;
-
-	PhaseProfilers * gPhaseProfilers;
-}
-
 using namespace SimpleAIGlobals;
 
 PLUGIN_API SteerLib::ModuleInterface * createModule()
@@ -49,15 +29,25 @@ PLUGIN_API void destroyModule( SteerLib::ModuleInterface*  module )
 }
 
 
+SimpleAIModule::SimpleAIModule()
+{
+	_logger = NULL;
+}
+
+SimpleAIModule::~SimpleAIModule()
+{
+	LogManager::getInstance()->destroyLogger(_logger);
+}
+
 void SimpleAIModule::init( const SteerLib::OptionDictionary & options, SteerLib::EngineInterface * engineInfo )
 {
-	gEngine = engineInfo;
-	gSpatialDatabase = engineInfo->getSpatialDatabase();
+	_gEngine = engineInfo;
 
-	gUseDynamicPhaseScheduling = false;
-	gShowStats = false;
+	_gLongTermPlanningPhaseInterval = 0;
+	_gUseDynamicPhaseScheduling = false;
+	_gShowStats = false;
 	logStats = false;
-	gShowAllStats = false;
+	_gShowAllStats = false;
 	logFilename = "simpleAI.log";
 
 	SteerLib::OptionDictionary::const_iterator optionIter;
@@ -65,7 +55,7 @@ void SimpleAIModule::init( const SteerLib::OptionDictionary & options, SteerLib:
 		std::stringstream value((*optionIter).second);
 		if ((*optionIter).first == "")
 		{
-			value >> gLongTermPlanningPhaseInterval;
+			value >> _gLongTermPlanningPhaseInterval;
 		}
 		else if ((*optionIter).first == "ailogFileName")
 		{
@@ -74,11 +64,11 @@ void SimpleAIModule::init( const SteerLib::OptionDictionary & options, SteerLib:
 		}
 		else if ((*optionIter).first == "stats")
 		{
-			gShowStats = Util::getBoolFromString(value.str());
+			_gShowStats = Util::getBoolFromString(value.str());
 		}
 		else if ((*optionIter).first == "allstats")
 		{
-			gShowAllStats = Util::getBoolFromString(value.str());
+			_gShowAllStats = Util::getBoolFromString(value.str());
 		}
 		else
 		{
@@ -89,6 +79,8 @@ void SimpleAIModule::init( const SteerLib::OptionDictionary & options, SteerLib:
 	if( logStats )
 	{
 
+		// a module that is initialized again starts a new log under the same name.
+		LogManager::getInstance()->destroyLogger(_logger);
 		_logger = LogManager::getInstance()->createLogger(logFilename,LoggerType::BASIC_WRITE);
 
 		_logger->addDataField("number_of_times_executed",DataType::LongLong );
@@ -118,15 +110,14 @@ void SimpleAIModule::initializeSimulation()
 	//
 	// initialize the performance profilers
 	//
-	gPhaseProfilers = new PhaseProfilers;
-	gPhaseProfilers->aiProfiler.reset();
-	gPhaseProfilers->longTermPhaseProfiler.reset();
-	gPhaseProfilers->midTermPhaseProfiler.reset();
-	gPhaseProfilers->shortTermPhaseProfiler.reset();
-	gPhaseProfilers->perceptivePhaseProfiler.reset();
-	gPhaseProfilers->predictivePhaseProfiler.reset();
-	gPhaseProfilers->reactivePhaseProfiler.reset();
-	gPhaseProfilers->steeringPhaseProfiler.reset();
+	_phaseProfilers.aiProfiler.reset();
+	_phaseProfilers.longTermPhaseProfiler.reset();
+	_phaseProfilers.midTermPhaseProfiler.reset();
+	_phaseProfilers.shortTermPhaseProfiler.reset();
+	_phaseProfilers.perceptivePhaseProfiler.reset();
+	_phaseProfilers.predictivePhaseProfiler.reset();
+	_phaseProfilers.reactivePhaseProfiler.reset();
+	_phaseProfilers.steeringPhaseProfiler.reset();
 
 }
 
@@ -152,27 +143,27 @@ void SimpleAIModule::cleanupSimulation()
 	{
 		LogObject logObject;
 
-		logObject.addLogData(gPhaseProfilers->aiProfiler.getNumTimesExecuted());
-		logObject.addLogData(gPhaseProfilers->aiProfiler.getTotalTicksAccumulated());
-		logObject.addLogData(gPhaseProfilers->aiProfiler.getMinTicks());
-		logObject.addLogData(gPhaseProfilers->aiProfiler.getMaxTicks());
-		logObject.addLogData(gPhaseProfilers->aiProfiler.getMinExecutionTimeMills());
-		logObject.addLogData(gPhaseProfilers->aiProfiler.getMaxExecutionTimeMills());
-		logObject.addLogData(gPhaseProfilers->aiProfiler.getAverageExecutionTimeMills());
-		logObject.addLogData(gPhaseProfilers->aiProfiler.getTotalTime());
-		logObject.addLogData(gPhaseProfilers->aiProfiler.getTickFrequency());
+		logObject.addLogData(_phaseProfilers.aiProfiler.getNumTimesExecuted());
+		logObject.addLogData(_phaseProfilers.aiProfiler.getTotalTicksAccumulated());
+		logObject.addLogData(_phaseProfilers.aiProfiler.getMinTicks());
+		logObject.addLogData(_phaseProfilers.aiProfiler.getMaxTicks());
+		logObject.addLogData(_phaseProfilers.aiProfiler.getMinExecutionTimeMills());
+		logObject.addLogData(_phaseProfilers.aiProfiler.getMaxExecutionTimeMills());
+		logObject.addLogData(_phaseProfilers.aiProfiler.getAverageExecutionTimeMills());
+		logObject.addLogData(_phaseProfilers.aiProfiler.getTotalTime());
+		logObject.addLogData(_phaseProfilers.aiProfiler.getTickFrequency());
 
 		_logger->writeLogObject(logObject);
 
 		// cleanup profileing metrics for next simulation/scenario
-		gPhaseProfilers->aiProfiler.reset();
-		gPhaseProfilers->longTermPhaseProfiler.reset();
-		gPhaseProfilers->midTermPhaseProfiler.reset();
-		gPhaseProfilers->shortTermPhaseProfiler.reset();
-		gPhaseProfilers->perceptivePhaseProfiler.reset();
-		gPhaseProfilers->predictivePhaseProfiler.reset();
-		gPhaseProfilers->reactivePhaseProfiler.reset();
-		gPhaseProfilers->steeringPhaseProfiler.reset();
+		_phaseProfilers.aiProfiler.reset();
+		_phaseProfilers.longTermPhaseProfiler.reset();
+		_phaseProfilers.midTermPhaseProfiler.reset();
+		_phaseProfilers.shortTermPhaseProfiler.reset();
+		_phaseProfilers.perceptivePhaseProfiler.reset();
+		_phaseProfilers.predictivePhaseProfiler.reset();
+		_phaseProfilers.reactivePhaseProfiler.reset();
+		_phaseProfilers.steeringPhaseProfiler.reset();
 	}
 
 	// kdTree_->deleteObstacleTree(kdTree_->obstacleTree_);
@@ -185,7 +176,11 @@ void SimpleAIModule::finish()
 
 SteerLib::AgentInterface * SimpleAIModule::createAgent()
 {
-	return new SimpleAgent; 
+	SimpleAgent * agent = new SimpleAgent;
+	agent->_gEngine = _gEngine;
+	agent->_gSpatialDatabase = _gEngine->getSpatialDatabase();
+	agent->_phaseProfilers = &_phaseProfilers;
+	return agent;
 }
 
 void SimpleAIModule::destroyAgent( SteerLib::AgentInterface * agent )
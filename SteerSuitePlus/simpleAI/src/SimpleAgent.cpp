@@ -18,20 +18,23 @@
 SimpleAgent::SimpleAgent()
 {
 	_enabled = false;
+	_gEngine = NULL;
+	_gSpatialDatabase = NULL;
+	_phaseProfilers = NULL;
 }
 
 SimpleAgent::~SimpleAgent()
 {
 	if (_enabled) {
 		Util::AxisAlignedBox bounds(_position.x-_radius, _position.x+_radius, 0.0f, 0.0f, _position.z-_radius, _position.z+_radius);
-		gSpatialDatabase->removeObject( this, bounds);
+		_gSpatialDatabase->removeObject( this, bounds);
 	}
 }
 
 void SimpleAgent::disable()
 {
 	Util::AxisAlignedBox bounds(_position.x-_radius, _position.x+_radius, 0.0f, 0.0f, _position.z-_radius, _position.z+_radius);
-	gSpatialDatabase->removeObject( this, bounds);
+	_gSpatialDatabase->removeObject( this, bounds);
 	_enabled = false;
 }
 
@@ -52,11 +55,11 @@ void SimpleAgent::reset(const SteerLib::AgentInitialConditions & initialConditio
 
 	if (!_enabled) {
 		// if the agent was not enabled, then it does not already exist in the database, so add it.
-		gSpatialDatabase->addObject( this, newBounds);
+		_gSpatialDatabase->addObject( this, newBounds);
 	}
 	else {
 		// if the agent was enabled, then the agent already existed in the database, so update it instead of adding it.
-		gSpatialDatabase->updateObject( this, oldBounds, newBounds);
+		_gSpatialDatabase->updateObject( this, oldBounds, newBounds);
 	}
 
 	_enabled = true;
@@ -72,7 +75,7 @@ void SimpleAgent::reset(const SteerLib::AgentInitialConditions & initialConditio
 			if (initialConditions.goals[i].targetIsRandom) {
 				// if the goal is random, we must randomly generate the goal.
 				SteerLib::AgentGoalInfo _goal;
-				_goal.targetLocation = gSpatialDatabase->randomPositionWithoutCollisions(1.0f, true);
+				_goal.targetLocation = _gSpatialDatabase->randomPositionWithoutCollisions(1.0f, true);
 				_goalQueue.push(_goal);
 			}
 		}
@@ -91,7 +94,7 @@ void SimpleAgent::updateAI(float timeStamp, float dt, unsigned int frameNumber)
 {
 	// for this function, we assume that all goals are of type GOAL_TYPE_SEEK_STATIC_TARGET.
 	// the error check for this was performed in reset().
-	Util::AutomaticFunctionProfiler profileThisFunction( &SimpleAIGlobals::gPhaseProfilers->aiProfiler );
+	Util::AutomaticFunctionProfiler profileThisFunction( &_phaseProfilers->aiProfiler, "simpleAI::updateAI" );
 
 	Util::Vector vectorToGoal = _goalQueue.front().targetLocation - _position;
 
@@ -119,20 +122,20 @@ void SimpleAgent::updateAI(float timeStamp, float dt, unsigned int frameNumber)
 
 SteerLib::EngineInterface * SimpleAgent::getSimulationEngine()
 {
-	return gEngine;
+	return _gEngine;
 }
 
 void SimpleAgent::draw()
 {
 #ifdef ENABLE_GUI
 	// if the agent is selected, do some annotations just for demonstration
-	if (gEngine->isAgentSelected(this)) {
+	if (_gEngine->isAgentSelected(this)) {
 		Util::Ray ray;
 		ray.initWithUnitInterval(_position, _forward);
 		float t = 0.0f;
 		SteerLib::SpatialDatabaseItem * objectFound;
 		Util::DrawLib::drawLine(ray.pos, ray.eval(1.0f));
-		if (gSpatialDatabase->trace(ray, t, objectFound, this, false)) {
+		if (_gSpatialDatabase->trace(ray, t, objectFound, this, false)) {
 			Util::DrawLib::drawAgentDisc(_position, _forward, _radius, Util::gBlue);
 		}
 		else {
@@ -166,7 +169,7 @@ void SimpleAgent::_doEulerStep(const Util::Vector & steeringDecisionForce, float
 	// update the database with the new agent's setup
 	Util::AxisAlignedBox oldBounds(_position.x - _radius, _position.x + _radius, 0.0f, 0.0f, _position.z - _radius, _position.z + _radius);
 	Util::AxisAlignedBox newBounds(newPosition.x - _radius, newPosition.x + _radius, 0.0f, 0.0f, newPosition.z - _radius, newPosition.z + _radius);
-	gSpatialDatabase->updateObject( this, oldBounds, newBounds);
+	_gSpatialDatabase->updateObject( this, oldBounds, newBounds);
 
 	_position = newPosition;
 }
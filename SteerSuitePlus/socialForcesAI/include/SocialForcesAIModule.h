@@ -44,6 +44,9 @@
 class SocialForcesAIModule : public SteerLib::ModuleInterface
 {
 public:
+	SocialForcesAIModule();
+	/// Closes the module's log, see LogManager::destroyLogger().
+	~SocialForcesAIModule();
 	
 	void cleanupSimulation();
 	void preprocessSimulation();
@@ -52,7 +55,8 @@ public:
 	std::string getDependencies() { return ""; }
 	
 	std::string getConflicts() { return ""; }
-	std::string getData() { return _data; }
+	/// Returns the field labels (if stats are logged) and one line per logged simulation, formatted only when called.
+	std::string getData();
 	LogData * getLogData()
 	{
 		LogData * lD = new LogData();
@@ -72,11 +76,30 @@ public:
 protected:
 	std::string logFilename; // = "pprAI.log";
 	bool logStats; // = false;
+	bool logBinary; // = false;
 	Logger * _rvoLogger;
-	std::string _data;
 	std::vector<LogObject *> _logData;
+	/// The text returned by getData(), formatted from _logData up to _numLogObjectsInData.
+	std::string _data;
+	size_t _numLogObjectsInData;
 
 	SteerLib::EngineInterface * _gEngine;
+	unsigned int _gLongTermPlanningPhaseInterval;
+	bool _gUseDynamicPhaseScheduling;
+	bool _gShowStats;
+	bool _gShowAllStats;
+	bool _dontPlan;
+	/// If true, agents take wall forces from the engine's SteerLib::ObstacleDistanceField instead of from each nearby obstacle.
+	bool _useDistanceField;
+	/// If true, agents ask the engine's SteerLib::VisibilityCache whether they can see their goal, and only trace rays to it when the cache does not know.
+	bool _useVisibilityCache;
+
+	/// The parameters given to the module; every new agent starts with a copy of these.
+	SocialForcesParameters _SocialForcesParams;
+	/// The profilers shared by all agents of this module.
+	SocialForcesGlobals::PhaseProfilers _phaseProfilers;
+
+	friend class SocialForcesAgent;
 };
 
 #endif
@@ -17,6 +17,8 @@
 // #include "SocialForcesAIModule.h"
 #include "SocialForces_Parameters.h"
 
+class SocialForcesAIModule;
+
 
 /**
  * @brief Social Forces Agent stuff
@@ -83,7 +85,7 @@ protected:
 	// Util::Vector prefVelocity_; // This is the velocity the agent wants to be at
 	// Util::Vector newVelocity_;
 	size_t id_;
-	SteerLib::ModuleInterface * rvoModule;
+	SocialForcesAIModule * rvoModule;
 
 	SteerLib::EngineInterface * _gEngine;
 
@@ -98,16 +100,27 @@ private:
 
 
 	void calcNextStep(float dt);
+	/// hasLineOfSightTo() for the current goal, answered from the engine's visibility cache when it knows the answer.
+	bool hasLineOfSightToGoal(const Util::Point & goal);
+	/// Fills _neighborAgents and _neighborObstacles with the items that overlap the sf_query_radius box around the agent.
+	void gatherNeighbors();
 	Util::Vector calcRepulsionForce(float dt);
 	Util::Vector calcProximityForce(float dt);
 
 	Util::Vector calcAgentRepulsionForce(float dt);
 	Util::Vector calcWallRepulsionForce(float dt);
+	/// The wall proximity and repulsion forces of the nearest obstacle, from the engine's distance field.
+	Util::Vector calcDistanceFieldProximityForce(float dt);
+	Util::Vector calcDistanceFieldRepulsionForce(float dt);
 
 	Util::Vector calcWallNormal(SteerLib::ObstacleInterface* obs);
 	std::pair<Util::Point, Util::Point> calcWallPointsFromNormal(SteerLib::ObstacleInterface* obs, Util::Vector normal);
 	Util::Vector calcObsNormal(SteerLib::ObstacleInterface* obs);
 
+	/// The neighbors used by all forces of the current frame; gathered once per updateAI() from the engine's neighbor lists.
+	std::vector<SteerLib::AgentInterface*> _neighborAgents;
+	std::vector<SteerLib::ObstacleInterface*> _neighborObstacles;
+
 	// For midterm planning stores the plan to the current goal
 	// holds the location of the best local target along the midtermpath
 
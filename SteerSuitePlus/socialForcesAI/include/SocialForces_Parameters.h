@@ -56,39 +56,6 @@ namespace SocialForcesGlobals {
 		Util::PerformanceProfiler reactivePhaseProfiler;
 		Util::PerformanceProfiler steeringPhaseProfiler;
 	};
-
-
-	extern SteerLib::EngineInterface * gEngineInfo;
-	extern SteerLib::SpatialDataBaseInterface * gSpatialDatabase;
-	extern unsigned int gLongTermPlanningPhaseInterval;
-	extern unsigned int gMidTermPlanningPhaseInterval;
-	extern unsigned int gShortTermPlanningPhaseInterval;
-	extern unsigned int gPredictivePhaseInterval;
-	extern unsigned int gReactivePhaseInterval;
-	extern unsigned int gPerceptivePhaseInterval;
-	extern bool gUseDynamicPhaseScheduling;
-	extern bool gShowStats;
-	extern bool gShowAllStats;
-	extern bool dont_plan;
-
-
-	// Adding a bunch of parameters so they can be changed via input
-	extern float sf_acceleration;
-	extern float sf_personal_space_threshold;
-	extern float sf_agent_repulsion_importance;
-	extern float sf_query_radius;
-	extern float sf_body_force;
-	extern float sf_agent_body_force;
-	extern float sf_sliding_friction_force;
-	extern float sf_agent_b;
-	extern float sf_agent_a;
-	extern float sf_wall_b;
-	extern float sf_wall_a;
-	extern float sf_max_speed;
-
-
-
-	extern PhaseProfilers * gPhaseProfilers;
 }
 
 
@@ -16,45 +16,6 @@
 #include "LogManager.h"
 
 
-// globally accessible to the simpleAI plugin
-// SteerLib::EngineInterface * gEngine;
-// SteerLib::SpatialDataBaseInterface * gSpatialDatabase;
-
-namespace SocialForcesGlobals
-{
-
-	// SteerLib::EngineInterface * gEngineInfo;
-	// SteerLib::SpatialDataBaseInterface * gSpatialDatabase;
-	unsigned int gLongTermPlanningPhaseInterval;
-	unsigned int gMidTermPlanningPhaseInterval;
-	unsigned int gShortTermPlanningPhaseInterval;
-	unsigned int gPredictivePhaseInterval;
-	unsigned int gReactivePhaseInterval;
-	unsigned int gPerceptivePhaseInterval;
-	bool gUseDynamicPhaseScheduling;
-	bool gShowStats;
-	bool gShowAllStats;
-	bool dont_plan;
-
-
-	// Adding a bunch of parameters so they can be changed via input
-	float sf_acceleration;
-	float sf_personal_space_threshold;
-	float sf_agent_repulsion_importance;
-	float sf_query_radius;
-	float sf_body_force;
-	float sf_agent_body_force;
-	float sf_sliding_friction_force;
-	float sf_agent_b;
-	float sf_agent_a;
-	float sf_wall_b;
-	float sf_wall_a;
-	float sf_max_speed;
-
-
-	PhaseProfilers * gPhaseProfilers;
-}
-
 using namespace SocialForcesGlobals;
 
 PLUGIN_API SteerLib::ModuleInterface * createModule()
@@ -68,32 +29,47 @@ PLUGIN_API void destroyModule( SteerLib::ModuleInterface*  module )
 }
 
 
+SocialForcesAIModule::SocialForcesAIModule()
+{
+	_rvoLogger = NULL;
+}
+
+SocialForcesAIModule::~SocialForcesAIModule()
+{
+	LogManager::getInstance()->destroyLogger(_rvoLogger);
+}
+
 void SocialForcesAIModule::init( const SteerLib::OptionDictionary & options, SteerLib::EngineInterface * engineInfo )
 {
 	// gEngine = engineInfo;
 	// gSpatialDatabase = engineInfo->getSpatialDatabase();
 	_gEngine = engineInfo;		
 	_data = "";
+	_numLogObjectsInData = _logData.size();
 
-	gUseDynamicPhaseScheduling = false;
-	gShowStats = false;
+	_gLongTermPlanningPhaseInterval = 0;
+	_gUseDynamicPhaseScheduling = false;
+	_gShowStats = false;
 	logStats = false;
-	gShowAllStats = false;
+	logBinary = false;
+	_gShowAllStats = false;
 	logFilename = "sfAI.log";
-	dont_plan = false;
-
-	sf_acceleration = ACCELERATION;
-	sf_personal_space_threshold = PERSONAL_SPACE_THRESHOLD;
-	sf_agent_repulsion_importance = AGENT_REPULSION_IMPORTANCE;
-	sf_query_radius = QUERY_RADIUS;
-	sf_body_force = BODY_FORCE;
-	sf_agent_body_force = AGENT_BODY_FORCE;
-	sf_sliding_friction_force = SLIDING_FRICTION_FORCE;
-	sf_agent_b = AGENT_B;
-	sf_agent_a = AGENT_A;
-	sf_wall_b = WALL_B;
-	sf_wall_a = WALL_A;
-	sf_max_speed = MAX_SPEED;
+	_dontPlan = false;
+	_useDistanceField = false;
+	_useVisibilityCache = false;
+
+	_SocialForcesParams.sf_acceleration = ACCELERATION;
+	_SocialForcesParams.sf_personal_space_threshold = PERSONAL_SPACE_THRESHOLD;
+	_SocialForcesParams.sf_agent_repulsion_importance = AGENT_REPULSION_IMPORTANCE;
+	_SocialForcesParams.sf_query_radius = QUERY_RADIUS;
+	_SocialForcesParams.sf_body_force = BODY_FORCE;
+	_SocialForcesParams.sf_agent_body_force = AGENT_BODY_FORCE;
+	_SocialForcesParams.sf_sliding_friction_force = SLIDING_FRICTION_FORCE;
+	_SocialForcesParams.sf_agent_b = AGENT_B;
+	_SocialForcesParams.sf_agent_a = AGENT_A;
+	_SocialForcesParams.sf_wall_b = WALL_B;
+	_SocialForcesParams.sf_wall_a = WALL_A;
+	_SocialForcesParams.sf_max_speed = MAX_SPEED;
 
 
 	SteerLib::OptionDictionary::const_iterator optionIter;
@@ -102,57 +78,57 @@ void SocialForcesAIModule::init( const SteerLib::OptionDictionary & options, Ste
 		// std::cout << "option " << (*optionIter).first << " value " << value.str() << std::endl;
 		if ((*optionIter).first == "")
 		{
-			value >> gLongTermPlanningPhaseInterval;
+			value >> _gLongTermPlanningPhaseInterval;
 		}
 		else if ((*optionIter).first == "sf_acceleration")
 		{
-			value >> sf_acceleration;
-			std::cout << "set sf acceleration to " << sf_acceleration << std::endl;
+			value >> _SocialForcesParams.sf_acceleration;
+			std::cout << "set sf acceleration to " << _SocialForcesParams.sf_acceleration << std::endl;
 		}
 		else if ((*optionIter).first == "sf_personal_space_threshold")
 		{
-			value >> sf_personal_space_threshold;
+			value >> _SocialForcesParams.sf_personal_space_threshold;
 		}
 		else if ((*optionIter).first == "sf_agent_repulsion_importance")
 		{
-			value >> sf_agent_repulsion_importance;
+			value >> _SocialForcesParams.sf_agent_repulsion_importance;
 		}
 		else if ((*optionIter).first == "sf_query_radius")
 		{
-			value >> sf_query_radius;
+			value >> _SocialForcesParams.sf_query_radius;
 		}
 		else if ((*optionIter).first == "sf_body_force")
 		{
-			value >> sf_body_force;
+			value >> _SocialForcesParams.sf_body_force;
 		}
 		else if ((*optionIter).first == "sf_agent_body_force")
 		{
-			value >> sf_body_force;
+			value >> _SocialForcesParams.sf_body_force;
 		}
 		else if ((*optionIter).first == "sf_sliding_friction_force")
 		{
-			value >> sf_sliding_friction_force;
-			// std::cout << "*************** set sf_sliding_friction_force to " << sf_sliding_friction_force << std::endl;
+			value >> _SocialForcesParams.sf_sliding_friction_force;
+			// std::cout << "*************** set sf_sliding_friction_force to " << _SocialForcesParams.sf_sliding_friction_force << std::endl;
 		}
 		else if ((*optionIter).first == "sf_agent_b")
 		{
-			value >> sf_agent_b;
+			value >> _SocialForcesParams.sf_agent_b;
 		}
 		else if ((*optionIter).first == "sf_agent_a")
 		{
-			value >> sf_agent_a;
+			value >> _SocialForcesParams.sf_agent_a;
 		}
 		else if ((*optionIter).first == "sf_wall_b")
 		{
-			value >> sf_wall_b;
+			value >> _SocialForcesParams.sf_wall_b;
 		}
 		else if ((*optionIter).first == "sf_wall_a")
 		{
-			value >> sf_wall_a;
+			value >> _SocialForcesParams.sf_wall_a;
 		}
 		else if ((*optionIter).first == "sf_max_speed")
 		{
-			value >> sf_max_speed;
+			value >> _SocialForcesParams.sf_max_speed;
 		}
 		else if ((*optionIter).first == "ailogFileName")
 		{
@@ -163,17 +139,29 @@ void SocialForcesAIModule::init( const SteerLib::OptionDictionary & options, Ste
 		{
 			logStats = true;
 		}
+		else if ((*optionIter).first == "logBinary")
+		{
+			logBinary = Util::getBoolFromString(value.str());
+		}
 		else if ((*optionIter).first == "stats")
 		{
-			gShowStats = Util::getBoolFromString(value.str());
+			_gShowStats = Util::getBoolFromString(value.str());
 		}
 		else if ((*optionIter).first == "allstats")
 		{
-			gShowAllStats = Util::getBoolFromString(value.str());
+			_gShowAllStats = Util::getBoolFromString(value.str());
 		}
 		else if ((*optionIter).first == "dont_plan")
 		{
-			dont_plan = Util::getBoolFromString(value.str());
+			_dontPlan = Util::getBoolFromString(value.str());
+		}
+		else if ((*optionIter).first == "use_distance_field")
+		{
+			_useDistanceField = Util::getBoolFromString(value.str());
+		}
+		else if ((*optionIter).first == "use_visibility_cache")
+		{
+			_useVisibilityCache = Util::getBoolFromString(value.str());
 		}
 		else
 		{
@@ -181,7 +169,9 @@ void SocialForcesAIModule::init( const SteerLib::OptionDictionary & options, Ste
 		}
 	}
 
-		_rvoLogger = LogManager::getInstance()->createLogger(logFilename,LoggerType::BASIC_WRITE);
+		// a module that is initialized again starts a new log under the same name.
+		LogManager::getInstance()->destroyLogger(_rvoLogger);
+		_rvoLogger = LogManager::getInstance()->createLogger(logFilename, logBinary ? LoggerType::BINARY_WRITE : LoggerType::BASIC_WRITE);
 
 		_rvoLogger->addDataField("number_of_times_executed",DataType::LongLong );
 		_rvoLogger->addDataField("total_ticks_accumulated",DataType::LongLong );
@@ -203,7 +193,9 @@ void SocialForcesAIModule::init( const SteerLib::OptionDictionary & options, Ste
 		labelStream << _rvoLogger->getFieldName(i);
 		_data = labelStream.str() + "\n";
 
-		_rvoLogger->writeData(labelStream.str());
+		// a binary log stores the labels in its header.
+		if (!logBinary)
+			_rvoLogger->writeData(labelStream.str());
 
 	}
 }
@@ -213,21 +205,31 @@ void SocialForcesAIModule::initializeSimulation()
 	//
 	// initialize the performance profilers
 	//
-	gPhaseProfilers = new PhaseProfilers;
-	gPhaseProfilers->aiProfiler.reset();
-	gPhaseProfilers->longTermPhaseProfiler.reset();
-	gPhaseProfilers->midTermPhaseProfiler.reset();
-	gPhaseProfilers->shortTermPhaseProfiler.reset();
-	gPhaseProfilers->perceptivePhaseProfiler.reset();
-	gPhaseProfilers->predictivePhaseProfiler.reset();
-	gPhaseProfilers->reactivePhaseProfiler.reset();
-	gPhaseProfilers->steeringPhaseProfiler.reset();
+	_phaseProfilers.aiProfiler.reset();
+	_phaseProfilers.longTermPhaseProfiler.reset();
+	_phaseProfilers.midTermPhaseProfiler.reset();
+	_phaseProfilers.shortTermPhaseProfiler.reset();
+	_phaseProfilers.perceptivePhaseProfiler.reset();
+	_phaseProfilers.predictivePhaseProfiler.reset();
+	_phaseProfilers.reactivePhaseProfiler.reset();
+	_phaseProfilers.steeringPhaseProfiler.reset();
 
 }
 
 void SocialForcesAIModule::finish()
 {
-	// nothing to do here
+	// binary logs are buffered
+	_rvoLogger->flush();
+}
+
+std::string SocialForcesAIModule::getData()
+{
+	// formatting every simulation's stats as text is only worth it when someone asks for them.
+	for (; _numLogObjectsInData < _logData.size(); _numLogObjectsInData++)
+	{
+		_data += _rvoLogger->logObjectToString(*_logData[_numLogObjectsInData]);
+	}
+	return _data;
 }
 
 void SocialForcesAIModule::preprocessSimulation()
@@ -269,6 +271,7 @@ SteerLib::AgentInterface * SocialForcesAIModule::createAgent()
 	agent->id_ = agents_.size();
 	agents_.push_back(agent);
 	agent->_gEngine = this->_gEngine;
+	agent->_SocialForcesParams = _SocialForcesParams;
 	return agent;
 }
 
@@ -325,29 +328,28 @@ void SocialForcesAIModule::cleanupSimulation()
 
 		LogObject rvoLogObject;
 
-		rvoLogObject.addLogData(gPhaseProfilers->aiProfiler.getNumTimesExecuted());
-		rvoLogObject.addLogData(gPhaseProfilers->aiProfiler.getTotalTicksAccumulated());
-		rvoLogObject.addLogData(gPhaseProfilers->aiProfiler.getMinTicks());
-		rvoLogObject.addLogData(gPhaseProfilers->aiProfiler.getMaxTicks());
-		rvoLogObject.addLogData(gPhaseProfilers->aiProfiler.getMinExecutionTimeMills());
-		rvoLogObject.addLogData(gPhaseProfilers->aiProfiler.getMaxExecutionTimeMills());
-		rvoLogObject.addLogData(gPhaseProfilers->aiProfiler.getAverageExecutionTimeMills());
-		rvoLogObject.addLogData(gPhaseProfilers->aiProfiler.getTotalTime());
-		rvoLogObject.addLogData(gPhaseProfilers->aiProfiler.getTickFrequency());
+		rvoLogObject.addLogData(_phaseProfilers.aiProfiler.getNumTimesExecuted());
+		rvoLogObject.addLogData(_phaseProfilers.aiProfiler.getTotalTicksAccumulated());
+		rvoLogObject.addLogData(_phaseProfilers.aiProfiler.getMinTicks());
+		rvoLogObject.addLogData(_phaseProfilers.aiProfiler.getMaxTicks());
+		rvoLogObject.addLogData(_phaseProfilers.aiProfiler.getMinExecutionTimeMills());
+		rvoLogObject.addLogData(_phaseProfilers.aiProfiler.getMaxExecutionTimeMills());
+		rvoLogObject.addLogData(_phaseProfilers.aiProfiler.getAverageExecutionTimeMills());
+		rvoLogObject.addLogData(_phaseProfilers.aiProfiler.getTotalTime());
+		rvoLogObject.addLogData(_phaseProfilers.aiProfiler.getTickFrequency());
 
 		_rvoLogger->writeLogObject(rvoLogObject);
-		_data = _data + _rvoLogger->logObjectToString(rvoLogObject);
 		_logData.push_back(rvoLogObject.copy());
 
 		// cleanup profileing metrics for next simulation/scenario
-		gPhaseProfilers->aiProfiler.reset();
-		gPhaseProfilers->longTermPhaseProfiler.reset();
-		gPhaseProfilers->midTermPhaseProfiler.reset();
-		gPhaseProfilers->shortTermPhaseProfiler.reset();
-		gPhaseProfilers->perceptivePhaseProfiler.reset();
-		gPhaseProfilers->predictivePhaseProfiler.reset();
-		gPhaseProfilers->reactivePhaseProfiler.reset();
-		gPhaseProfilers->steeringPhaseProfiler.reset();
+		_phaseProfilers.aiProfiler.reset();
+		_phaseProfilers.longTermPhaseProfiler.reset();
+		_phaseProfilers.midTermPhaseProfiler.reset();
+		_phaseProfilers.shortTermPhaseProfiler.reset();
+		_phaseProfilers.perceptivePhaseProfiler.reset();
+		_phaseProfilers.predictivePhaseProfiler.reset();
+		_phaseProfilers.reactivePhaseProfiler.reset();
+		_phaseProfilers.steeringPhaseProfiler.reset();
 	if ( logStats )
 	{
 		_rvoLogger->writeLogObject(rvoLogObject);
@@ -8,6 +8,7 @@
 #include "SocialForcesAgent.h"
 #include "SocialForcesAIModule.h"
 #include "SocialForces_Parameters.h"
+#include <algorithm>
 // #include <math.h>
 
 // #include "util/Geometry.h"
@@ -26,21 +27,27 @@ using namespace SteerLib;
 
 // #define _DEBUG_ENTROPY 1
 
-SocialForcesAgent::SocialForcesAgent()
+/// Orders neighbor agents by id, so forces are summed in the same order no matter where the agents were allocated.
+static bool isAgentBefore(SteerLib::AgentInterface * first, SteerLib::AgentInterface * second)
 {
-	_SocialForcesParams.sf_acceleration = sf_acceleration;
-	_SocialForcesParams.sf_personal_space_threshold = sf_personal_space_threshold;
-	_SocialForcesParams.sf_agent_repulsion_importance = sf_agent_repulsion_importance;
-	_SocialForcesParams.sf_query_radius = sf_query_radius;
-	_SocialForcesParams.sf_body_force = sf_body_force;
-	_SocialForcesParams.sf_agent_body_force = sf_agent_body_force;
-	_SocialForcesParams.sf_sliding_friction_force = sf_sliding_friction_force;
-	_SocialForcesParams.sf_agent_b = sf_agent_b;
-	_SocialForcesParams.sf_agent_a = sf_agent_a;
-	_SocialForcesParams.sf_wall_b = sf_wall_b;
-	_SocialForcesParams.sf_wall_a = sf_wall_a;
-	_SocialForcesParams.sf_max_speed = sf_max_speed;
+	return first->id() < second->id();
+}
+
+/// Orders neighbor obstacles by their bounds, for the same reason as isAgentBefore().
+static bool isObstacleBefore(SteerLib::ObstacleInterface * first, SteerLib::ObstacleInterface * second)
+{
+	const Util::AxisAlignedBox & a = first->getBounds();
+	const Util::AxisAlignedBox & b = second->getBounds();
+	if (a.xmin != b.xmin) return a.xmin < b.xmin;
+	if (a.zmin != b.zmin) return a.zmin < b.zmin;
+	if (a.xmax != b.xmax) return a.xmax < b.xmax;
+	if (a.zmax != b.zmax) return a.zmax < b.zmax;
+	if (a.ymin != b.ymin) return a.ymin < b.ymin;
+	return a.ymax < b.ymax;
+}
 
+SocialForcesAgent::SocialForcesAgent()
+{
 	_enabled = false;
 }
 
@@ -135,6 +142,11 @@ void SocialForcesAgent::reset(const SteerLib::AgentInitialConditions & initialCo
 	}
 
 	_enabled = true;
+	getSimulationEngine()->getNeighborListService()->requestQueryRange(_radius + _SocialForcesParams.sf_query_radius);
+	if (rvoModule->_useDistanceField)
+	{
+		getSimulationEngine()->getObstacleDistanceField()->requestMaxDistance(_radius + _SocialForcesParams.sf_query_radius);
+	}
 
 	if (initialConditions.goals.size() == 0)
 	{
@@ -170,7 +182,7 @@ void SocialForcesAgent::reset(const SteerLib::AgentInitialConditions & initialCo
 		}
 	}
 
-	runLongTermPlanning(_goalQueue.front().targetLocation, dont_plan);
+	runLongTermPlanning(_goalQueue.front().targetLocation, rvoModule->_dontPlan);
 
 	// std::cout << "first waypoint: " << _waypoints.front() << " agents position: " << position() << std::endl;
 	/*
@@ -246,27 +258,69 @@ std::pair<float, Util::Point> minimum_distance(Util::Point l1, Util::Point l2, U
 }
 
 
+void SocialForcesAgent::gatherNeighbors()
+{
+	float xmin = _position.x-(this->_radius + _SocialForcesParams.sf_query_radius);
+	float xmax = _position.x+(this->_radius + _SocialForcesParams.sf_query_radius);
+	float zmin = _position.z-(this->_radius + _SocialForcesParams.sf_query_radius);
+	float zmax = _position.z+(this->_radius + _SocialForcesParams.sf_query_radius);
+
+	_neighborAgents.clear();
+	_neighborObstacles.clear();
+
+	// the cached lists reach further than the query, and may hold agents that were disabled since they were built; the
+	// spatial database returns every item whose cell overlaps the query.  Both are filtered the same way below.
+	std::vector<SteerLib::AgentInterface*> queriedAgents;
+	std::vector<SteerLib::ObstacleInterface*> queriedObstacles;
+	const std::vector<SteerLib::AgentInterface*> * candidateAgents = &queriedAgents;
+	const std::vector<SteerLib::ObstacleInterface*> * candidateObstacles = &queriedObstacles;
+	const SteerLib::NeighborList * neighborList = getSimulationEngine()->getNeighborListService()->getNeighbors(this);
+	if (neighborList != NULL)
+	{
+		candidateAgents = &neighborList->agents;
+		candidateObstacles = &neighborList->obstacles;
+	}
+	else
+	{
+		// this agent was enabled after the lists were last rebuilt, so query the spatial database directly.
+		getSimulationEngine()->getSpatialDatabase()->getAgentsInRange(queriedAgents, xmin, xmax, zmin, zmax, this);
+		getSimulationEngine()->getSpatialDatabase()->getObstaclesInRange(queriedObstacles, xmin, xmax, zmin, zmax, this);
+	}
+
+	for (unsigned int a = 0; a < candidateAgents->size(); a++)
+	{
+		SteerLib::AgentInterface * agent = (*candidateAgents)[a];
+		if ( agent->enabled() && SteerLib::NeighborListService::isAgentInRange(agent, xmin, xmax, zmin, zmax) )
+		{
+			_neighborAgents.push_back(agent);
+		}
+	}
+	for (unsigned int o = 0; o < candidateObstacles->size(); o++)
+	{
+		SteerLib::ObstacleInterface * obstacle = (*candidateObstacles)[o];
+		if ( SteerLib::NeighborListService::isObstacleInRange(obstacle, xmin, xmax, zmin, zmax) )
+		{
+			_neighborObstacles.push_back(obstacle);
+		}
+	}
+
+	// the spatial database returns items in address order, which changes when a session re-creates its agents.
+	std::stable_sort(_neighborAgents.begin(), _neighborAgents.end(), isAgentBefore);
+	std::stable_sort(_neighborObstacles.begin(), _neighborObstacles.end(), isObstacleBefore);
+}
+
 Util::Vector SocialForcesAgent::calcProximityForce(float dt)
 {
-	std::set<SteerLib::SpatialDatabaseItemPtr> _neighbors;
-		getSimulationEngine()->getSpatialDatabase()->getItemsInRange(_neighbors,
-				_position.x-(this->_radius + _SocialForcesParams.sf_query_radius),
-				_position.x+(this->_radius + _SocialForcesParams.sf_query_radius),
-				_position.z-(this->_radius + _SocialForcesParams.sf_query_radius),
-				_position.z+(this->_radius + _SocialForcesParams.sf_query_radius),
-				dynamic_cast<SteerLib::SpatialDatabaseItemPtr>(this));
 
 	SteerLib::AgentInterface * tmp_agent;
 	SteerLib::ObstacleInterface * tmp_ob;
 	Util::Vector away = Util::Vector(0,0,0);
 	Util::Vector away_obs = Util::Vector(0,0,0);
 
-	for (std::set<SteerLib::SpatialDatabaseItemPtr>::iterator neighbour = _neighbors.begin();  neighbour != _neighbors.end();  neighbour++)
-	// for (int a =0; a < tmp_agents.size(); a++)
+	for (unsigned int a = 0; a < _neighborAgents.size(); a++)
 	{
-		if ( (*neighbour)->isAgent() )
 		{
-			tmp_agent = dynamic_cast<SteerLib::AgentInterface *>(*neighbour);
+			tmp_agent = _neighborAgents[a];
 
 			// direction away from other agent
 			Util::Vector away_tmp = normalize(position() - tmp_agent->position());
@@ -332,10 +386,18 @@ Util::Vector SocialForcesAgent::calcProximityForce(float dt)
 						) << std::endl;
 						*/
 		}
-		else
+	}
+
+	if (rvoModule->_useDistanceField)
+	{
+		return away + calcDistanceFieldProximityForce(dt);
+	}
+
+	for (unsigned int o = 0; o < _neighborObstacles.size(); o++)
+	{
 		{
 			// It is an obstacle
-			tmp_ob = dynamic_cast<SteerLib::ObstacleInterface *>(*neighbour);
+			tmp_ob = _neighborObstacles[o];
 			CircleObstacle * obs_cir = dynamic_cast<SteerLib::CircleObstacle *>(tmp_ob);
 			if ( obs_cir != NULL && USE_CIRCLES)
 			{
@@ -424,6 +486,10 @@ Util::Vector SocialForcesAgent::calcRepulsionForce(float dt)
 	std::cout << "wall repulsion; " << calcWallRepulsionForce(dt) << " agent repulsion " <<
 			(_SocialForcesParams.sf_agent_repulsion_importance * calcAgentRepulsionForce(dt)) << std::endl;
 #endif
+	if (rvoModule->_useDistanceField)
+	{
+		return calcDistanceFieldRepulsionForce(dt) + (_SocialForcesParams.sf_agent_repulsion_importance * calcAgentRepulsionForce(dt));
+	}
 	return calcWallRepulsionForce(dt) + (_SocialForcesParams.sf_agent_repulsion_importance * calcAgentRepulsionForce(dt));
 }
 
@@ -432,27 +498,12 @@ Util::Vector SocialForcesAgent::calcAgentRepulsionForce(float dt)
 
 	Util::Vector agent_repulsion_force = Util::Vector(0,0,0);
 
-	std::set<SteerLib::SpatialDatabaseItemPtr> _neighbors;
-		getSimulationEngine()->getSpatialDatabase()->getItemsInRange(_neighbors,
-				_position.x-(this->_radius + _SocialForcesParams.sf_query_radius),
-				_position.x+(this->_radius + _SocialForcesParams.sf_query_radius),
-				_position.z-(this->_radius + _SocialForcesParams.sf_query_radius),
-				_position.z+(this->_radius + _SocialForcesParams.sf_query_radius),
-				(this));
 
 	SteerLib::AgentInterface * tmp_agent;
 
-	for (std::set<SteerLib::SpatialDatabaseItemPtr>::iterator neighbour = _neighbors.begin();  neighbour != _neighbors.end();  neighbour++)
-	// for (int a =0; a < tmp_agents.size(); a++)
+	for (unsigned int a = 0; a < _neighborAgents.size(); a++)
 	{
-		if ( (*neighbour)->isAgent() )
-		{
-			tmp_agent = dynamic_cast<SteerLib::AgentInterface *>(*neighbour);
-		}
-		else
-		{
-			continue;
-		}
+		tmp_agent = _neighborAgents[a];
 		if ( ( id() != tmp_agent->id() ) &&
 				(tmp_agent->computePenetration(this->position(), this->radius()) > 0.000001)
 			)
@@ -500,27 +551,12 @@ Util::Vector SocialForcesAgent::calcWallRepulsionForce(float dt)
 	Util::Vector wall_repulsion_force = Util::Vector(0,0,0);
 
 
-	std::set<SteerLib::SpatialDatabaseItemPtr> _neighbors;
-		getSimulationEngine()->getSpatialDatabase()->getItemsInRange(_neighbors,
-				_position.x-(this->_radius + _SocialForcesParams.sf_query_radius),
-				_position.x+(this->_radius + _SocialForcesParams.sf_query_radius),
-				_position.z-(this->_radius + _SocialForcesParams.sf_query_radius),
-				_position.z+(this->_radius + _SocialForcesParams.sf_query_radius),
-				dynamic_cast<SteerLib::SpatialDatabaseItemPtr>(this));
 
 	SteerLib::ObstacleInterface * tmp_ob;
 
-	for (std::set<SteerLib::SpatialDatabaseItemPtr>::iterator neighbour = _neighbors.begin();  neighbour != _neighbors.end();  neighbour++)
-	// for (std::set<SteerLib::ObstacleInterface * >::iterator tmp_o = _neighbors.begin();  tmp_o != _neighbors.end();  tmp_o++)
+	for (unsigned int o = 0; o < _neighborObstacles.size(); o++)
 	{
-		if ( !(*neighbour)->isAgent() )
-		{
-			tmp_ob = dynamic_cast<SteerLib::ObstacleInterface *>(*neighbour);
-		}
-		else
-		{
-			continue;
-		}
+		tmp_ob = _neighborObstacles[o];
 		if ( tmp_ob->computePenetration(this->position(), this->radius()) > 0.000001 )
 		{
 			CircleObstacle * cir_obs = dynamic_cast<SteerLib::CircleObstacle *>(tmp_ob);
@@ -632,6 +668,32 @@ std::pair<Util::Point, Util::Point> SocialForcesAgent::calcWallPointsFromNormal(
 	}
 }
 
+Util::Vector SocialForcesAgent::calcDistanceFieldProximityForce(float dt)
+{
+	Util::Vector wall_normal;
+	float distance = getSimulationEngine()->getObstacleDistanceField()->getDistanceAndNormal(position(), wall_normal);
+	if ( distance > this->radius() + _SocialForcesParams.sf_query_radius )
+	{
+		return Util::Vector(0,0,0);
+	}
+	return wall_normal * (_SocialForcesParams.sf_wall_a * exp((this->radius() - distance) / _SocialForcesParams.sf_wall_b)) * dt;
+}
+
+Util::Vector SocialForcesAgent::calcDistanceFieldRepulsionForce(float dt)
+{
+	Util::Vector wall_normal;
+	float distance = getSimulationEngine()->getObstacleDistanceField()->getDistanceAndNormal(position(), wall_normal);
+	float penetration = this->radius() - distance;
+	if ( penetration <= 0.000001 )
+	{
+		return Util::Vector(0,0,0);
+	}
+	// the body force grows without bound as the agent reaches the surface; keep it finite if it is pushed inside.
+	distance = std::max(distance, 0.01f * this->radius());
+	return ((wall_normal * (radius() + _SocialForcesParams.sf_personal_space_threshold - distance) / distance) * _SocialForcesParams.sf_body_force * dt) +
+		((dot(forward(), rightSideInXZPlane(wall_normal)) * rightSideInXZPlane(wall_normal) * penetration) * _SocialForcesParams.sf_sliding_friction_force * dt);
+}
+
 /**
  * Basically What side of the obstacle is the agent on use that as the normal
  * DOES NOT SUPPORT non-axis-aligned boxes
@@ -763,10 +825,25 @@ void SocialForcesAgent::computeNeighbors()
 }*/
 
 
+bool SocialForcesAgent::hasLineOfSightToGoal(const Util::Point & goal)
+{
+	if (rvoModule->_useVisibilityCache)
+	{
+		// hasLineOfSightTo() traces from points at most _radius * |forward| away from the agent, ignoring other agents.
+		SteerLib::VisibilityCache::Visibility visibility = getSimulationEngine()->getVisibilityCache()->getVisibility(position(), _radius * forward().length(), goal);
+		if (visibility != SteerLib::VisibilityCache::VISIBILITY_UNKNOWN)
+		{
+			return (visibility == SteerLib::VisibilityCache::VISIBILITY_VISIBLE);
+		}
+	}
+	return hasLineOfSightTo(goal);
+}
+
+
 void SocialForcesAgent::updateAI(float timeStamp, float dt, unsigned int frameNumber)
 {
 	// std::cout << "_SocialForcesParams.rvo_max_speed " << _SocialForcesParams._SocialForcesParams.rvo_max_speed << std::endl;
-	Util::AutomaticFunctionProfiler profileThisFunction( &SocialForcesGlobals::gPhaseProfilers->aiProfiler );
+	Util::AutomaticFunctionProfiler profileThisFunction( &rvoModule->_phaseProfilers.aiProfiler, "sfAI::updateAI" );
 	if (!enabled())
 	{
 		return;
@@ -777,7 +854,7 @@ void SocialForcesAgent::updateAI(float timeStamp, float dt, unsigned int frameNu
 	SteerLib::AgentGoalInfo goalInfo = _goalQueue.front();
 	Util::Vector goalDirection;
 	// std::cout << "midtermpath empty: " << _midTermPath.empty() << std::endl;
-	if ( ! _midTermPath.empty() && (!this->hasLineOfSightTo(goalInfo.targetLocation)) )
+	if ( ! _midTermPath.empty() && (!this->hasLineOfSightToGoal(goalInfo.targetLocation)) )
 	{
 		if (reachedCurrentWaypoint())
 		{
@@ -798,6 +875,7 @@ void SocialForcesAgent::updateAI(float timeStamp, float dt, unsigned int frameNu
 	prefForce = prefForce + velocity();
 	// _velocity = prefForce;
 
+	gatherNeighbors();
 	Util::Vector repulsionForce = calcRepulsionForce(dt);
 	if ( repulsionForce.x != repulsionForce.x)
 	{
@@ -904,7 +982,7 @@ void SocialForcesAgent::draw()
 					+
 					(
 						(
-							dynamic_cast<AgentInterface*>(*neighbor)->position()
+							asAgent(*neighbor)->position()
 							-
 							this->position()
 						)
@@ -10,6 +10,12 @@
 ///
 /// The %SteerBench utility is essentially a command-line wrapper for the BenchmarkEngine class.
 ///
+/// With <tt>-j N</tt>, up to N rec files are benchmarked concurrently, each with its own benchmark
+/// technique and BenchmarkEngine; results are still printed in the order the files were given, and
+/// a file only starts when it is less than N files ahead of the next result to print.
+/// <tt>-csv</tt> prints one CSV row per rec file using the technique's printTotalScoreCSV().
+/// <tt>-metricsThreads N</tt> updates the per-agent metrics of each frame with N threads; the results do not change.
+///
 
 #include "SteerLib.h"
 
@@ -19,6 +25,23 @@ using namespace SteerLib;
 
 #define DEFAULT_BENCHMARK_TECHNIQUE "composite01"
 
+/// Options that control how each rec file is benchmarked and what is printed for it.
+struct BenchmarkRunOptions {
+	std::string benchmarkTechniqueName;
+	unsigned int agentToBenchmark;
+	bool benchmarkSingleAgent;
+	std::string testCaseSearchPath;
+	bool validateRecFile;
+	unsigned int frameToDumpMetrics;
+	bool printMetricsForEnd;
+	bool printMetricsForFrame;
+	bool printMetricsForAllFrames;
+	bool printScoreDetails;
+	bool printNumericalScoreOnly;
+	bool printScoreCSV;
+	unsigned int numMetricsThreads;
+};
+
 /// Helper function to ask the benchmark engine to print metrics for all agents or a specific agent
 void printCurrentMetrics(BenchmarkEngine * benchEngine, std::ostream & out, bool singleAgent, unsigned int agentIndex)
 {
@@ -31,47 +54,224 @@ void printCurrentMetrics(BenchmarkEngine * benchEngine, std::ostream & out, bool
 	}
 }
 
+/// Benchmarks a single rec file from start to finish, using its own benchmark technique and BenchmarkEngine.
+void benchmarkRecFile(const BenchmarkRunOptions & opts, const std::string & recFilename, std::ostream & metricsOutputStream, std::ostream & scoreOutputStream)
+{
+	if (!opts.printNumericalScoreOnly) {
+		scoreOutputStream << "Analyzing " << recFilename << "...\n";
+	}
+
+	BenchmarkTechniqueInterface * benchTechnique = createBenchmarkTechnique(opts.benchmarkTechniqueName);
+	BenchmarkEngine * benchEngine = NULL;
+
+	try {
+		benchEngine = new BenchmarkEngine(recFilename, benchTechnique, opts.numMetricsThreads);
+
+		// If we were supposed to validate the rec files, then do that first.
+		if (opts.validateRecFile) {
+			if (benchEngine->isValidTestCaseSimulation( opts.testCaseSearchPath ) == false) {
+				throw GenericException("Rec file \"" + recFilename + "\" does not match the corresponding test case.\n");
+			}
+		}
+
+		// Otherwise, run the benchmark
+		while (!benchEngine->isDone()) {
+			benchEngine->stepOneFrame();
+			if (  ((benchEngine->currentFrameNumber() == opts.frameToDumpMetrics) && (opts.printMetricsForFrame)  )  || (opts.printMetricsForAllFrames)) {
+				printCurrentMetrics(benchEngine, metricsOutputStream, opts.benchmarkSingleAgent, opts.agentToBenchmark);
+			}
+		}
+
+		// print whatever the user wanted after benchmarking
+		if (opts.printMetricsForEnd) {
+			printCurrentMetrics(benchEngine, metricsOutputStream, opts.benchmarkSingleAgent, opts.agentToBenchmark);
+		}
+
+		if (opts.printScoreCSV) {
+			scoreOutputStream << recFilename << ",";
+			benchEngine->printTotalScoreCSV(scoreOutputStream);
+		}
+		else if (opts.benchmarkSingleAgent) {
+			if (opts.printScoreDetails) {
+				benchEngine->printAgentScoreDetails(opts.agentToBenchmark, scoreOutputStream);
+			}
+			else {
+				scoreOutputStream << benchEngine->getAgentBenchmarkScore(opts.agentToBenchmark) << endl;
+			}
+		}
+		else {
+			if (opts.printScoreDetails) {
+				benchEngine->printTotalScoreDetails(scoreOutputStream);
+			}
+			else {
+				scoreOutputStream << benchEngine->getTotalBenchmarkScore() << endl;
+			}
+		}
+	}
+	catch (...) {
+		delete benchEngine;
+		destroyBenchmarkTechnique(benchTechnique);
+		throw;
+	}
+
+	delete benchEngine;
+	destroyBenchmarkTechnique(benchTechnique);
+}
+
+
+/**
+ * @brief Shared state for benchmarking many rec files concurrently.
+ *
+ * Each rec file is one task of a Util::TaskGroup.  A task benchmarks its file into a private
+ * buffer, and then flushes every consecutive finished result to the output stream.  This keeps the
+ * output in the same order as the input, while at most one BenchmarkEngine exists per thread.
+ *
+ * Files are not all spawned up front: a file is only started once it is less than window files
+ * ahead of the next result to print.  Otherwise one slow file would let the other threads finish,
+ * and buffer, the results of all remaining files; this way at most window results exist at once.
+ */
+struct BatchBenchmarkState {
+	const BenchmarkRunOptions * opts;
+	const std::vector<char*> * recFiles;
+	std::ostream * out;
+	Util::TaskGroup * group;
+	unsigned int window;
+
+	Util::Mutex lock;
+	unsigned int nextFileToPrint;
+	unsigned int nextFileToStart;
+	std::vector<std::string> results;
+	std::vector<bool> finished;
+	bool failed;
+
+	/// Writes all consecutive finished results starting at nextFileToPrint; <em>assumes lock is already acquired</em>.
+	void flushFinishedResults() {
+		while ((nextFileToPrint < finished.size()) && (finished[nextFileToPrint])) {
+			(*out) << results[nextFileToPrint];
+			out->flush();
+			// release the buffered text right away, so memory does not grow with the number of files.
+			std::string().swap(results[nextFileToPrint]);
+			nextFileToPrint++;
+		}
+	}
+
+	/// Returns the indices of the files that may start now, and counts them as started; <em>assumes lock is already acquired</em>.
+	void takeFilesToStart(std::vector<unsigned int> & filesToStart) {
+		while (!failed && (nextFileToStart < finished.size()) && (nextFileToStart < nextFileToPrint + window)) {
+			filesToStart.push_back(nextFileToStart);
+			nextFileToStart++;
+		}
+	}
+};
+
+void batchBenchmarkFile(BatchBenchmarkState * state, unsigned int fileIndex);
+
+/// Spawns a task for each file of filesToStart; must be called without holding the lock of the state.
+void startBatchBenchmarkFiles(BatchBenchmarkState * state, const std::vector<unsigned int> & filesToStart)
+{
+	for (unsigned int i=0; i<filesToStart.size(); i++) {
+		unsigned int fileIndex = filesToStart[i];
+		state->group->run([state, fileIndex]() { batchBenchmarkFile(state, fileIndex); });
+	}
+}
+
+/// Task of the batch mode that benchmarks one rec file, and then starts the files that its result lets into the window; see BatchBenchmarkState.
+void batchBenchmarkFile(BatchBenchmarkState * state, unsigned int fileIndex)
+{
+	state->lock.lock();
+	bool skip = state->failed;
+	state->lock.unlock();
+	if (skip) {
+		return;
+	}
+
+	std::ostringstream fileOutput;
+	try {
+		benchmarkRecFile(*(state->opts), std::string((*state->recFiles)[fileIndex]), fileOutput, fileOutput);
+	}
+	catch (...) {
+		state->lock.lock();
+		state->failed = true;
+		state->lock.unlock();
+		// the task group re-throws the exception of the first failed file.
+		throw;
+	}
+
+	std::vector<unsigned int> filesToStart;
+	state->lock.lock();
+	state->results[fileIndex] = fileOutput.str();
+	state->finished[fileIndex] = true;
+	state->flushFinishedResults();
+	state->takeFilesToStart(filesToStart);
+	state->lock.unlock();
+
+	startBatchBenchmarkFiles(state, filesToStart);
+}
+
 int main(int argc, char** argv)
 {
 	try {
 		CommandLineParser * cp = new CommandLineParser();
 
 		// options initialized with defaults, which can be overridden by command line arguments
-		std::string benchmarkTechniqueName = DEFAULT_BENCHMARK_TECHNIQUE;
-		unsigned int agentToBenchmark = 0;
-		bool benchmarkSingleAgent = false;
-		std::string testCaseSearchPath = "";
-		bool validateRecFile = false;
-		unsigned int frameToDumpMetrics = 0;
-		bool printMetricsForEnd = false;
-		bool printMetricsForFrame = false;
-		bool printMetricsForAllFrames = false;
-		bool printScoreDetails = false;
-		bool printNumericalScoreOnly = false;
+		BenchmarkRunOptions opts;
+		opts.benchmarkTechniqueName = DEFAULT_BENCHMARK_TECHNIQUE;
+		opts.agentToBenchmark = 0;
+		opts.benchmarkSingleAgent = false;
+		opts.testCaseSearchPath = "";
+		opts.validateRecFile = false;
+		opts.frameToDumpMetrics = 0;
+		opts.printMetricsForEnd = false;
+		opts.printMetricsForFrame = false;
+		opts.printMetricsForAllFrames = false;
+		opts.printScoreDetails = false;
+		opts.printNumericalScoreOnly = false;
+		opts.printScoreCSV = false;
+		opts.numMetricsThreads = 1;
+		unsigned int numWorkerThreads = 1;
 		std::vector<char*> recFilesToBenchmark;
 		/// @todo add options to redirect output streams to anywhere the user requests, not only cout (default).
 		std::ostream metricsOutputStream(cout.rdbuf());
 		std::ostream scoreOutputStream(cout.rdbuf());
 		
 		
-		cp->addOption("-technique", &benchmarkTechniqueName, OPTION_DATA_TYPE_STRING);
-		cp->addOption("-agent", &agentToBenchmark, OPTION_DATA_TYPE_UNSIGNED_INT, 1, &benchmarkSingleAgent, true);
-		cp->addOption("-testcasepath", &testCaseSearchPath, OPTION_DATA_TYPE_STRING);
-		cp->addOption("-testCasePath", &testCaseSearchPath, OPTION_DATA_TYPE_STRING);
-		cp->addOption("-validate", NULL, OPTION_DATA_TYPE_NO_DATA, 0, &validateRecFile, true);
-		cp->addOption("-m", NULL, OPTION_DATA_TYPE_NO_DATA, 0, &printMetricsForEnd, true);
-		cp->addOption("-fm", &frameToDumpMetrics, OPTION_DATA_TYPE_UNSIGNED_INT, 1, &printMetricsForFrame, true);
-		cp->addOption("-am", NULL, OPTION_DATA_TYPE_NO_DATA, 0, &printMetricsForAllFrames, true);
-		cp->addOption("-details", NULL, OPTION_DATA_TYPE_NO_DATA, 0, &printScoreDetails, true);
-		cp->addOption("-scoreonly", NULL, OPTION_DATA_TYPE_NO_DATA, 0, &printNumericalScoreOnly, true);
-		cp->addOption("-scoreOnly", NULL, OPTION_DATA_TYPE_NO_DATA, 0, &printNumericalScoreOnly, true);
+		cp->addOption("-technique", &opts.benchmarkTechniqueName, OPTION_DATA_TYPE_STRING);
+		cp->addOption("-agent", &opts.agentToBenchmark, OPTION_DATA_TYPE_UNSIGNED_INT, 1, &opts.benchmarkSingleAgent, true);
+		cp->addOption("-testcasepath", &opts.testCaseSearchPath, OPTION_DATA_TYPE_STRING);
+		cp->addOption("-testCasePath", &opts.testCaseSearchPath, OPTION_DATA_TYPE_STRING);
+		cp->addOption("-validate", NULL, OPTION_DATA_TYPE_NO_DATA, 0, &opts.validateRecFile, true);
+		cp->addOption("-m", NULL, OPTION_DATA_TYPE_NO_DATA, 0, &opts.printMetricsForEnd, true);
+		cp->addOption("-fm", &opts.frameToDumpMetrics, OPTION_DATA_TYPE_UNSIGNED_INT, 1, &opts.printMetricsForFrame, true);
+		cp->addOption("-am", NULL, OPTION_DATA_TYPE_NO_DATA, 0, &opts.printMetricsForAllFrames, true);
+		cp->addOption("-details", NULL, OPTION_DATA_TYPE_NO_DATA, 0, &opts.printScoreDetails, true);
+		cp->addOption("-scoreonly", NULL, OPTION_DATA_TYPE_NO_DATA, 0, &opts.printNumericalScoreOnly, true);
+		cp->addOption("-scoreOnly", NULL, OPTION_DATA_TYPE_NO_DATA, 0, &opts.printNumericalScoreOnly, true);
+		cp->addOption("-csv", NULL, OPTION_DATA_TYPE_NO_DATA, 0, &opts.printScoreCSV, true);
+		cp->addOption("-j", &numWorkerThreads, OPTION_DATA_TYPE_UNSIGNED_INT);
+		cp->addOption("-metricsthreads", &opts.numMetricsThreads, OPTION_DATA_TYPE_UNSIGNED_INT);
+		cp->addOption("-metricsThreads", &opts.numMetricsThreads, OPTION_DATA_TYPE_UNSIGNED_INT);
 
 		// the first arg will be ignored cause it is the exectuable binary itself.
 		cp->parse(argc, argv, true, recFilesToBenchmark);
 
+		if (opts.printScoreCSV) {
+			// CSV output is meant for scripts, so only the CSV rows are printed.
+			if (opts.benchmarkSingleAgent) {
+				throw GenericException("-csv prints the total score of each rec file, it cannot be combined with -agent.");
+			}
+			opts.printNumericalScoreOnly = true;
+		}
 
-		if (!printNumericalScoreOnly) {
-			std::cout << "Benchmark technique: " << benchmarkTechniqueName << "\n";
+		if (numWorkerThreads == 0) {
+			throw GenericException("-j requires at least 1 worker thread.");
+		}
+		if (opts.numMetricsThreads == 0) {
+			throw GenericException("-metricsThreads requires at least 1 thread.");
+		}
+
+
+		if (!opts.printNumericalScoreOnly) {
+			std::cout << "Benchmark technique: " << opts.benchmarkTechniqueName << "\n";
 		}
 
 		for (unsigned int i=0; i<recFilesToBenchmark.size(); i++) {
@@ -81,52 +281,36 @@ int main(int argc, char** argv)
 			}
 		}
 
-		for (unsigned int i=0; i<recFilesToBenchmark.size(); i++) {
-			std::string recFilename = std::string(recFilesToBenchmark[i]);
-			if (!printNumericalScoreOnly) {
-				std::cout << "Analyzing " << recFilename << "...\n";
+		if ((numWorkerThreads == 1) || (recFilesToBenchmark.size() <= 1)) {
+			for (unsigned int i=0; i<recFilesToBenchmark.size(); i++) {
+				benchmarkRecFile(opts, std::string(recFilesToBenchmark[i]), metricsOutputStream, scoreOutputStream);
 			}
-
-			BenchmarkTechniqueInterface * benchTechnique = createBenchmarkTechnique(benchmarkTechniqueName);
-
-			BenchmarkEngine * benchEngine = new BenchmarkEngine(recFilename, benchTechnique);
-
-			// If we were supposed to validate the rec files, then do that first.
-			if (validateRecFile) {
-				if (benchEngine->isValidTestCaseSimulation( testCaseSearchPath ) == false) {
-					throw GenericException("Rec file \"" + recFilename + "\" does not match the corresponding test case.\n");
-				}
+		}
+		else {
+			// batch mode: benchmark several rec files at the same time, printing the results in input order.
+			if (numWorkerThreads > recFilesToBenchmark.size()) {
+				numWorkerThreads = (unsigned int)recFilesToBenchmark.size();
 			}
 
-			// Otherwise, run the benchmark
-			while (!benchEngine->isDone()) {
-				benchEngine->stepOneFrame();
-				if (  ((benchEngine->currentFrameNumber() == frameToDumpMetrics) && (printMetricsForFrame)  )  || (printMetricsForAllFrames)) {
-					printCurrentMetrics(benchEngine, metricsOutputStream, benchmarkSingleAgent, agentToBenchmark);
-				}
-			}
+			TaskScheduler scheduler(numWorkerThreads);
+			TaskGroup group(scheduler);
 
-			// print whatever the user wanted after benchmarking
-			if (printMetricsForEnd) {
-				printCurrentMetrics(benchEngine, metricsOutputStream, benchmarkSingleAgent, agentToBenchmark);
-			}
+			BatchBenchmarkState state;
+			state.opts = &opts;
+			state.recFiles = &recFilesToBenchmark;
+			state.out = &scoreOutputStream;
+			state.group = &group;
+			state.window = numWorkerThreads;
+			state.nextFileToPrint = 0;
+			state.nextFileToStart = 0;
+			state.results.resize(recFilesToBenchmark.size());
+			state.finished.resize(recFilesToBenchmark.size(), false);
+			state.failed = false;
 
-			if (benchmarkSingleAgent) {
-				if (printScoreDetails) {
-					benchEngine->printAgentScoreDetails(agentToBenchmark, scoreOutputStream);
-				}
-				else {
-					scoreOutputStream << benchEngine->getAgentBenchmarkScore(agentToBenchmark) << endl;
-				}
-			}
-			else {
-				if (printScoreDetails) {
-					benchEngine->printTotalScoreDetails(scoreOutputStream);
-				}
-				else {
-					scoreOutputStream << benchEngine->getTotalBenchmarkScore() << endl;
-				}
-			}
+			std::vector<unsigned int> filesToStart;
+			state.takeFilesToStart(filesToStart);
+			startBatchBenchmarkFiles(&state, filesToStart);
+			group.wait();
 		}
 	}
 	catch (std::exception &e) {
@@ -26,6 +26,7 @@
 #include "testcaseio/TestCaseIO.h"
 #include "testcaseio/AgentInitialConditions.h"
 #include "testcaseio/ObstacleInitialConditions.h"
+#include "testcaseio/TestCaseScaler.h"
 
 #include "griddatabase/GridCell.h"
 #include "interfaces/SpatialDataBaseInterface.h"
@@ -42,6 +43,12 @@
 #include "simulation/Clock.h"
 #include "simulation/SimulationOptions.h"
 #include "simulation/SimulationEngine.h"
+#include "simulation/SimulationCheckpoint.h"
+#include "simulation/NeighborListService.h"
+#include "simulation/ObstacleDistanceField.h"
+#include "simulation/VisibilityCache.h"
+#include "simulation/PhaseScheduler.h"
+#include "simulation/TrajectorySink.h"
 #include "simulation/SteeringCommand.h"
 
 #include "benchmarking/AgentMetricsCollector.h"
@@ -22,7 +22,9 @@
 #include "util/Mutex.h"
 #include "util/PerformanceProfiler.h"
 #include "util/StateMachine.h"
+#include "util/TaskScheduler.h"
 #include "util/ThreadedTaskManager.h"
+#include "util/TraceProfiler.h"
 #include "util/XMLParser.h"
 
 
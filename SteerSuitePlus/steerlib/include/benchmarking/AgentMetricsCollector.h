@@ -17,7 +17,7 @@
 
 #include <iostream>
 #include <set>
-#include <map>
+#include <deque>
 #include <vector>
 #include "Globals.h"
 #include "interfaces/SpatialDataBaseInterface.h"
@@ -55,6 +55,12 @@ namespace SteerLib {
 	 * Anyone interested in scrutinizing the benchmark process will want to look at the update()
 	 * function here as well as the implementation of individual benchmark techniques.
 	 *
+	 * Collision bookkeeping is designed to not allocate memory once it has warmed up:  current collisions
+	 * are kept in a vector sorted by collision key, the neighbor query re-uses the same vector every frame,
+	 * and past collisions are appended to a block-allocated deque.  Counts for each pair of thresholds given
+	 * to getNumThresholdedCollisions() are kept incrementally as collisions end, so only the first query for a
+	 * new pair of thresholds scans the collision history.
+	 *
 	 */
 	class STEERLIB_API AgentMetricsCollector
 	{
@@ -70,8 +76,8 @@ namespace SteerLib {
 		//@{
 		/// Returns all the metrics in their current form.
 		AgentMetrics * getCurrentMetrics() { return &_metrics; }
-		/// Returns information about all current collisions.
-		std::map<uintptr_t, SteerLib::CollisionInfo> * getCurrentCollisions() { return &_currentCollidingObjects; }
+		/// Returns information about all current collisions, sorted by CollisionInfo::collisionKey.
+		const std::vector<SteerLib::CollisionInfo> * getCurrentCollisions() { return &_currentCollidingObjects; }
 		/// Returns the number of total unique collisions, both past and present.
 	    size_t getNumTotalCollisions() { return _pastCollisions.size() + _currentCollidingObjects.size(); }
 		/// Returns the number of unique past collisions (i.e. ones that are no longer still in a collision state) that are greater than both specified thresholds.
@@ -86,6 +92,10 @@ namespace SteerLib {
 	    void _resetMetrics();
 		void _updateCollisionStats(SteerLib::SpatialDataBaseInterface * gridDB, SteerLib::AgentInterface * updatedAgent, float currentTimeStamp);
 	    void _checkAndUpdateOneCollision(uintptr_t collisionKey, float penetration, float currentTimeStamp);
+		/// Moves a finished collision into the collision history, and updates the incremental thresholded counts.
+		void _recordPastCollision(const CollisionInfo & oldCollision);
+		/// Returns the position of collisionKey in _currentCollidingObjects, or the position where it should be inserted.
+		std::vector<CollisionInfo>::iterator _findCurrentCollision(uintptr_t collisionKey);
 	    void _updateAgentInformation(SteerLib::AgentInterface * updatedAgent);
 
 	    unsigned int _numFramesMeasured;
@@ -112,8 +122,17 @@ namespace SteerLib {
 	    windowArray<Util::Vector> _instantaneousAccelerationWindow; // stores the *magnitude* only of change in velocity (not instantaneous acceleration) at each frame.
 
 		// collision history
-		std::map<uintptr_t, SteerLib::CollisionInfo> _currentCollidingObjects; // a list of agents and obstacles that this agent is colliding with.  hopefully won't ever be too large.
-	    std::vector<CollisionInfo> _pastCollisions;
+		std::vector<CollisionInfo> _currentCollidingObjects; // agents and obstacles that this agent is colliding with, sorted by collisionKey.  hopefully won't ever be too large.
+	    std::deque<CollisionInfo> _pastCollisions;
+		std::vector<SpatialDatabaseItemPtr> _neighbors; // re-used by every collision query, so that it does not allocate each frame.
+
+		/// The number of past collisions greater than a pair of thresholds, kept up to date as collisions end.
+		struct ThresholdedCollisionCount {
+			float penetrationThreshold;
+			float timeDurationThreshold;
+			unsigned int numPastCollisions;
+		};
+		std::vector<ThresholdedCollisionCount> _thresholdedCollisionCounts;
 	};
 
 
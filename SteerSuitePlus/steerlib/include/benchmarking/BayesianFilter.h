@@ -134,8 +134,11 @@ Functionality shared by the various filters.
 
 #include <iterator>
 #include <vector>
+#include <algorithm>
 #include <stdlib.h>
 #include "util/dmatrix.h"
+#include "util/TaskScheduler.h"
+#include "mersenne/MersenneTwister.h"
 #include "benchmarking/CompositeTechniqueEntropy.h"
 
 
@@ -240,6 +243,115 @@ namespace Util {
 		return SVec * SVal * sample + mean;
 	}
 
+	/*!
+	*  @brief       The number of particles or sigma points that one task of the parallel filter steps handles.
+	*
+	*  The parallel steps split the particles into chunks of this size, and every chunk draws its random numbers
+	*  from its own stream, so the results depend on this size but not on the number of threads.
+	*  \ingroup globalfunc
+	*/
+	static const size_t PARALLEL_FILTER_GRAIN_SIZE = 32;
+
+	/*!
+	*  @brief       Randomly samples from the univariate standard Gaussian distribution N(0,1), using a given
+	*               random number generator instead of rand().
+	*  @param       rng     The random number generator.
+	*  @returns     A random number from the univariate standard Gaussian distribution N(0,1).
+	*  \ingroup globalfunc
+	*/
+	inline double normal(MTRand & rng) {
+		double u, v, s(0);
+
+		while (s == 0 || s > 1) {
+			u = 2*rng.rand()-1;
+			v = 2*rng.rand()-1;
+			s = u*u + v*v;
+		}
+
+		return u * sqrt(-2*log(s)/s);
+	}
+
+	/*!
+	*  @brief       Randomly samples from the multivariate standard Gaussian distribution N(0,I), using a given
+	*               random number generator instead of rand().
+	*  @param       dim     The dimension of the distribution.
+	*  @param       rng     The random number generator.
+	*  @returns     A random vector from the multivariate standard Gaussian distribution N(0,I).
+	*  \ingroup globalfunc
+	*/
+	inline Matrix sampleGaussian(size_t dim, MTRand & rng) {
+		Matrix sample(dim);
+		for (size_t j = 0; j < dim; ++j) {
+			sample[j] = normal(rng);
+		}
+		return sample;
+	}
+
+	/*!
+	*  @brief       Calls body(first, end) for the consecutive chunks of PARALLEL_FILTER_GRAIN_SIZE indices of [0, n),
+	*               in parallel on scheduler, or in order on the calling thread if scheduler is NULL.
+	*  \ingroup globalfunc
+	*/
+	inline void forEachChunk(Util::TaskScheduler * scheduler, size_t n, const std::function<void(size_t first, size_t end)> & body) {
+		if (scheduler != NULL) {
+			scheduler->parallelFor(0, n, PARALLEL_FILTER_GRAIN_SIZE, body);
+			return;
+		}
+		for (size_t first = 0; first < n; first += PARALLEL_FILTER_GRAIN_SIZE) {
+			body(first, std::min(first + PARALLEL_FILTER_GRAIN_SIZE, n));
+		}
+	}
+
+	/*!
+	*  @brief       Draws the seeds of the random number streams of the chunks of forEachChunk(), in order, from rng.
+	*  @param       n       The number of indices that are split into chunks.
+	*  @param       rng     The random number generator that the seeds are drawn from.
+	*  @param       seeds   Out: one seed per chunk; the chunk that starts at index first uses
+	*                       seeds[first / PARALLEL_FILTER_GRAIN_SIZE].
+	*  \ingroup globalfunc
+	*/
+	inline void seedChunkStreams(size_t n, MTRand & rng, std::vector<MTRand::uint32> & seeds) {
+		seeds.resize((n + PARALLEL_FILTER_GRAIN_SIZE - 1) / PARALLEL_FILTER_GRAIN_SIZE);
+		for (size_t c = 0; c < seeds.size(); ++c) {
+			seeds[c] = rng.randInt();
+		}
+	}
+
+	/*!
+	*  @brief       Turns log-weights into weights that sum to one.
+	*  @param[in,out]       W       In: the logarithms of the unnormalized weights.
+	*                              Out: the normalized weights.
+	*  @param       scheduler       The scheduler to run on, or NULL to run on the calling thread. The sum is
+	*                       always added in order, so the weights do not depend on the number of threads.
+	*  \ingroup globalfunc
+	*/
+	inline void normalizeLogWeights(std::vector<double>& W, Util::TaskScheduler * scheduler = NULL) {
+		double maxLogW = log(0.0);
+		for (size_t i = 0; i < W.size(); ++i) {
+			if (W[i] > maxLogW) {
+				maxLogW = W[i];
+			}
+		}
+
+		// scale W[i] such that exp(maxLogW) == 1 for numerical stability
+		forEachChunk(scheduler, W.size(), [&](size_t first, size_t end) {
+			for (size_t i = first; i < end; ++i) {
+				W[i] = exp(W[i] - maxLogW);
+			}
+		});
+		double totalW = 0;
+		for (size_t i = 0; i < W.size(); ++i) {
+			totalW += W[i];
+		}
+
+		// normalize weights
+		forEachChunk(scheduler, W.size(), [&](size_t first, size_t end) {
+			for (size_t i = first; i < end; ++i) {
+				W[i] /= totalW;
+			}
+		});
+	}
+
 	/*!
 	*  @brief       Evaluates the probability density function of a multivariate Gaussian distribution
 	with zero mean and specified variance at a specified point.
@@ -268,6 +380,76 @@ namespace Util {
 		return -0.5*tr(~x*(var%x)) - 0.5*dim*log(2*M_PI) - 0.5*log(det(var));
 	}
 
+	/*!
+	*  @brief       Randomly samples from the multivariate standard Gaussian distribution N(0,I) without allocating.
+	*  @tparam      dim     The dimension of the distribution.
+	*  @returns     A random vector from the multivariate standard Gaussian distribution N(0,I).
+	*  \ingroup globalfunc
+	*/
+	template <size_t dim>
+	inline FixedMatrix<dim,1> sampleGaussian() {
+		FixedMatrix<dim,1> sample;
+		for (size_t j = 0; j < dim; ++j) {
+			sample[j] = normal();
+		}
+		return sample;
+	}
+
+	/*!
+	*  @brief       Randomly samples from the multivariate Gaussian distribution with specified
+	*               mean and variance, for dimensions known at compile time.
+	*  @tparam      dim     The dimension of the distribution.
+	*  @param       mean    The mean of the distribution.
+	*  @param       var     The variance (covariance matrix) of the distribution.
+	*  @returns     A random vector from the specified Gaussian distribution; it draws the same random
+	*               numbers and returns the same values as the Matrix version.
+	*  \ingroup globalfunc
+	*/
+	template <size_t dim>
+	inline FixedMatrix<dim,1> sampleGaussian(const FixedMatrix<dim,1>& mean, const FixedMatrix<dim,dim>& var) {
+		FixedMatrix<dim,1> sample = sampleGaussian<dim>();
+		FixedMatrix<dim,dim> SVec, SVal;
+		jacobi(var, SVec, SVal);
+		for (size_t i = 0; i < dim; ++i) {
+			if (SVal(i,i) < 0) {
+				SVal(i,i) = 0;
+			} else {
+				SVal(i,i) = sqrt(SVal(i,i));
+			}
+		}
+		return SVec * SVal * sample + mean;
+	}
+
+	/*!
+	*  @brief       Evaluates the probability density function of a multivariate Gaussian distribution
+	with zero mean and specified variance at a specified point, for dimensions known at compile time.
+	*  @tparam      dim     The dimension of the distribution.
+	*  @param       var     The variance (covariance matrix) of the distribution.
+	*  @param       x       The point at which the pdf is to be evaluated.
+	*  @returns     The probability density of the specified Gaussian distribution at the specified point.
+	*  \ingroup globalfunc
+	*/
+	template <size_t dim>
+	inline double pdf(const FixedMatrix<dim,dim>& var, const FixedMatrix<dim,1>& x) {
+		return exp(-0.5*tr(~x*(var%x))) / sqrt(det(2*M_PI*var));
+	}
+
+	/*!
+	*  @brief       Evaluates the logarithm of the probability density function of a multivariate
+	*               Gaussian distribution with zero mean and specified variance at a specified point,
+	*               for dimensions known at compile time.
+	*  @tparam      dim     The dimension of the distribution.
+	*  @param       var     The variance (covariance matrix) of the distribution.
+	*  @param       x       The point at which the log-pdf is to be evaluated.
+	*  @returns     The logarithm of the probability density of the specified Gaussian distribution at
+	*               the specified point.
+	*  \ingroup globalfunc
+	*/
+	template <size_t dim>
+	inline double logpdf(const FixedMatrix<dim,dim>& var, const FixedMatrix<dim,1>& x) {
+		return -0.5*tr(~x*(var%x)) - 0.5*dim*log(2*M_PI) - 0.5*log(det(var));
+	}
+
 	/*!
 	*  @brief       Computes the Jacobian of a specified function with three arguments with respect to the first
 	*               argument at a specified point using numerical differentiation.
@@ -461,11 +643,14 @@ namespace Util {
 	inline void enkfControlUpdate(std::vector<Matrix>& X, const Matrix& u, size_t mDim,
 			SteerLib::CompositeTechniqueEntropy * entopy)
 	{
-		// run ensemble members through f
+		// run ensemble members through f; the noise and the new state reuse the same storage for every member
+		Matrix m(mDim), xNew;
 		for (size_t i = 0; i < X.size(); ++i) {
-			if (i == 684)
-				i = 684;
-			X[i] = entopy->m_fHat(X[i], u, sampleGaussian(mDim));
+			for (size_t j = 0; j < mDim; ++j) {
+				m[j] = normal();
+			}
+			entopy->m_fHat(X[i], u, m, xNew);
+			X[i] = xNew;
 		}
 	}
 
@@ -835,6 +1020,33 @@ namespace Util {
 		}
 	}
 
+	/*!
+	*  @brief       Performs a control update step of the standard Particle Filter on a task scheduler.
+	*  @param[in,out]       X       In: the set of particles defining the prior distribution of the state.
+	*                              Out: the set of particles defining the posterior distribution of the state.
+	*  @param       u       The control input that is applied.
+	*  @param       f       A pointer to the dynamics function of the form <i>x = f(x, u, m), m ~ N(0, I)</i>; it is
+	*                       called from several threads at once, so it must be thread-safe.
+	*  @param       scheduler       The scheduler to run on, or NULL to run on the calling thread.
+	*  @param       rng     The random number generator that seeds one stream per chunk of particles; the motion noise
+	*                       of every particle comes from the stream of its chunk, so the particles are the same for any
+	*                       number of threads.
+	*  \ingroup pf
+	*/
+	inline void pfControlUpdate(std::vector<Matrix>& X, const Matrix& u, size_t mDim, Matrix (*f)(const Matrix&, const Matrix&, const Matrix&),
+								Util::TaskScheduler * scheduler, MTRand & rng) {
+		std::vector<MTRand::uint32> seeds;
+		seedChunkStreams(X.size(), rng, seeds);
+
+		// run particles through f
+		forEachChunk(scheduler, X.size(), [&](size_t first, size_t end) {
+			MTRand chunkRng(seeds[first / PARALLEL_FILTER_GRAIN_SIZE]);
+			for (size_t i = first; i < end; ++i) {
+				X[i] = f(X[i], u, sampleGaussian(mDim, chunkRng)); // O(|X| xDim)
+			}
+		});
+	}
+
 	/*!
 	*  @brief       Performs a measurement update step of the standard Particle Filter.
 	*  @tparam      xDim    The dimension of the state.
@@ -854,32 +1066,22 @@ namespace Util {
 	*                       function of x. If the measurement function is not linear in <i>n</i>, it is approximated
 	*                       by linearizing <i>h</i> in <i>n = 0</i>.
 	*  @param       jStep   Parameter determining the step size used for numerical differentiation (optional).
+	*  @param       scheduler       The scheduler to weigh the particles on (optional); <i>h</i> must then be thread-safe.
 	*  \ingroup pf
 	*/
-	inline void pfMeasurementUpdate(std::vector<Matrix>& X, std::vector<double>& W, const Matrix& z, size_t nDim, Matrix (*h)(const Matrix&, const Matrix&), double jStep = DEFAULTSTEPSIZE)
+	inline void pfMeasurementUpdate(std::vector<Matrix>& X, std::vector<double>& W, const Matrix& z, size_t nDim, Matrix (*h)(const Matrix&, const Matrix&), double jStep = DEFAULTSTEPSIZE,
+									Util::TaskScheduler * scheduler = NULL)
 	{
 		size_t zDim = z.numRows();
 
-		double maxLogW = log(0.0);
-		for (size_t i = 0; i < X.size(); ++i) {
-			Matrix N = jacobian2(X[i], zeros(nDim), zDim, h, jStep);
-			W[i] = log(W[i]) + logpdf(N*~N, z - h(X[i], zeros(nDim))); // O(|X| zDim^3)
-			if (W[i] > maxLogW) {
-				maxLogW = W[i];
+		forEachChunk(scheduler, X.size(), [&](size_t first, size_t end) {
+			for (size_t i = first; i < end; ++i) {
+				Matrix N = jacobian2(X[i], zeros(nDim), zDim, h, jStep);
+				W[i] = log(W[i]) + logpdf(N*~N, z - h(X[i], zeros(nDim))); // O(|X| zDim^3)
 			}
-		}
-
-		// scale W[i] such that exp(maxLogW) == 1 for numerical stability
-		double totalW = 0;
-		for (size_t i = 0; i < X.size(); ++i) {
-			W[i] = exp(W[i] - maxLogW);
-			totalW += W[i];
-		}
+		});
 
-		// normalize weights
-		for (size_t i = 0; i < X.size(); ++i) {
-			W[i] /= totalW;
-		}
+		normalizeLogWeights(W, scheduler);
 	}
 
 	/*!
@@ -897,35 +1099,25 @@ namespace Util {
 	*                       is used to perform the control update step.
 	*  @param       N       The measurement noise covariance matrix of the measurement function of the form
 	*                       <i>z = h(x) + n, n ~ N(0, N)</i> that is used to perform the measurement update step.
+	*  @param       scheduler       The scheduler to weigh the particles on (optional); <i>h</i> must then be thread-safe.
 	*  \ingroup pf
 	*/
 
-	inline void pfMeasurementUpdate(std::vector<Matrix>& X, std::vector<double>& W, const Matrix& z, Matrix (*h)(const Matrix&), const Matrix& N)
+	inline void pfMeasurementUpdate(std::vector<Matrix>& X, std::vector<double>& W, const Matrix& z, Matrix (*h)(const Matrix&), const Matrix& N,
+									Util::TaskScheduler * scheduler = NULL)
 	{
 		size_t zDim = z.numRows();
 
 		double constant = -0.5*zDim*log(2*M_PI) - 0.5*log(det(N)); // O(zDim^3)
 		Matrix Ninv = !N;
-		double maxLogW = log(0.0);
-		for (size_t i = 0; i < X.size(); ++i) {
-			Matrix zHat = z - h(X[i]);
-			W[i] = log(W[i]) - 0.5*tr(~zHat*Ninv*zHat) + constant; // O(|X| zDim^2)
-			if (W[i] > maxLogW) {
-				maxLogW = W[i];
+		forEachChunk(scheduler, X.size(), [&](size_t first, size_t end) {
+			for (size_t i = first; i < end; ++i) {
+				Matrix zHat = z - h(X[i]);
+				W[i] = log(W[i]) - 0.5*tr(~zHat*Ninv*zHat) + constant; // O(|X| zDim^2)
 			}
-		}
+		});
 
-		// scale W[i] such that exp(maxLogW) == 1 for numerical stability
-		double totalW = 0;
-		for (size_t i = 0; i < X.size(); ++i) {
-			W[i] = exp(W[i] - maxLogW);
-			totalW += W[i];
-		}
-
-		// normalize weights
-		for (size_t i = 0; i < X.size(); ++i) {
-			W[i] /= totalW;
-		}
+		normalizeLogWeights(W, scheduler);
 	}
 
 	/*!
@@ -959,6 +1151,50 @@ namespace Util {
 		W.assign(W.size(), avW);
 	}
 
+	/*!
+	*  @brief       Resamples the set of particles using low-variance systematic resampling on a task scheduler.
+	*  @param[in,out]       X       In: the set of particles defining the distribution of the state.
+	*                              Out: the resampled set of particles defining the distribution of the state.
+	*  @param[in,out]       W       In: the weights of the particles of the distribution.
+	*                              Out: the weights of the resampled particles of the distribution.
+	*                              It is required that <i>|W| = |X|</i>, and that the weights are normalized, i.e.
+	*                              <i>sum(W) = 1</i>.
+	*  @param       scheduler       The scheduler to run on, or NULL to run on the calling thread.
+	*  @param       rng     The random number generator that draws the offset of the comb.
+	*  @note        Picks the same particles as the sequential version for the same offset: every chunk of the comb finds
+	*               its first particle by binary search in the running sums of the weights, and walks on from there.
+	*  \ingroup pf
+	*/
+	inline void resample(std::vector<Matrix>& X, std::vector<double>& W, Util::TaskScheduler * scheduler, MTRand & rng)
+	{
+		// the running sums of the weights, added in the same order as the sequential version does
+		std::vector<double> C(W.size());
+		double c = 0;
+		for (size_t i = 0; i < W.size(); ++i) {
+			c += W[i];
+			C[i] = c;
+		}
+
+		std::vector<Matrix> Xnew(X.size());
+		double avW = 1.0 / X.size();
+		double r = rng.rand() * avW;
+		forEachChunk(scheduler, X.size(), [&](size_t first, size_t end) {
+			// the first particle whose running sum reaches the first tooth of the chunk; rounding may leave the last
+			// teeth past the last sum, which then pick the last particle
+			size_t i = std::lower_bound(C.begin(), C.end(), r + first*avW) - C.begin();
+			i = std::min(i, C.size() - 1);
+			for (size_t j = first; j < end; ++j) {
+				double U = r + j*avW;
+				while (U > C[i] && i + 1 < C.size()) {
+					++i;
+				}
+				Xnew[j] = X[i];
+			}
+		});
+		X.swap(Xnew);
+		W.assign(W.size(), avW);
+	}
+
 
 	/*!
 	*  @brief       Performs a full step of the standard Particle Filter.
@@ -996,6 +1232,24 @@ namespace Util {
 		resample(X, W);
 	}
 
+	/*!
+	*  @brief       Performs a full step of the standard Particle Filter on a task scheduler.
+	*  @param       scheduler       The scheduler to run on, or NULL to run on the calling thread; <i>f</i> and <i>h</i>
+	*                       must be thread-safe.
+	*  @param       rng     The random number generator that seeds the random number streams of the step.
+	*  @note        Same as the sequential version, but the particles are propagated, weighed and resampled in
+	*               parallel; the results depend on rng but not on the number of threads.
+	*  \ingroup pf
+	*/
+	inline void particleFilter(std::vector<Matrix>& X, std::vector<double>& W, const Matrix& u, const Matrix& z,
+							   size_t mDim, Matrix (*f)(const Matrix&, const Matrix&, const Matrix&),
+							   size_t nDim, Matrix (*h)(const Matrix&, const Matrix&), Util::TaskScheduler * scheduler, MTRand & rng)
+	{
+		pfControlUpdate(X, u, mDim, f, scheduler, rng);
+		pfMeasurementUpdate(X, W, z, nDim, h, DEFAULTSTEPSIZE, scheduler);
+		resample(X, W, scheduler, rng);
+	}
+
 	/*!
 	*  @brief       Performs a full step of the standard Particle Filter.
 	*  @tparam      xDim    The dimension of the state.
@@ -1028,6 +1282,23 @@ namespace Util {
 		resample(X, W);
 	}
 
+	/*!
+	*  @brief       Performs a full step of the standard Particle Filter, with additive measurement noise, on a task
+	*               scheduler.
+	*  @param       scheduler       The scheduler to run on, or NULL to run on the calling thread; <i>f</i> and <i>h</i>
+	*                       must be thread-safe.
+	*  @param       rng     The random number generator that seeds the random number streams of the step.
+	*  \ingroup pf
+	*/
+	inline void particleFilter(std::vector<Matrix>& X, std::vector<double>& W, const Matrix& u, const Matrix& z,
+							   size_t mDim, Matrix (*f)(const Matrix&, const Matrix&, const Matrix&), Matrix (*h)(const Matrix&), const Matrix& N,
+							   Util::TaskScheduler * scheduler, MTRand & rng)
+	{
+		pfControlUpdate(X, u, mDim, f, scheduler, rng);
+		pfMeasurementUpdate(X, W, z, h, N, scheduler);
+		resample(X, W, scheduler, rng);
+	}
+
 
 	/*!
 	*  @brief       Performs a control update step of the Unscented Kalman Filter.
@@ -1044,10 +1315,12 @@ namespace Util {
 	*  @param       alpha   Parameter determining the spread of the sigma points (optional).
 	*  @param       beta    Parameter to incorporate prior knowledge of the kurtosis of the distribution (optional).
 	*  @param       kappa   Scaling parameter (optional).
+	*  @param       scheduler       The scheduler to propagate the sigma points on (optional); <i>f</i> must then be
+	*                       thread-safe. The results are the same as without a scheduler.
 	*  \ingroup ukf
 	*/
 	inline void ukfControlUpdate(Matrix& xHat, Matrix& Sigma, const Matrix& u, size_t mDim, Matrix (*f)(const Matrix&, const Matrix&, const Matrix&),
-								 double alpha = DEFAULTALPHA, double beta = DEFAULTBETA, double kappa = DEFAULTKAPPA)
+								 double alpha = DEFAULTALPHA, double beta = DEFAULTBETA, double kappa = DEFAULTKAPPA, Util::TaskScheduler * scheduler = NULL)
 	{
 		size_t xDim = xHat.numRows();
 
@@ -1060,10 +1333,6 @@ namespace Util {
 
 		// Control Update
 
-		// propagate sigma points through f
-		std::vector<Matrix> X;
-		X.push_back(f(xHat, u, zeros(mDim)));
-
 		Matrix V(xDim,xDim), D(xDim,xDim);
 		jacobi((L + lambda) * Sigma, V, D);
 		for (size_t i = 0; i < xDim; ++i) {
@@ -1071,21 +1340,27 @@ namespace Util {
 		}
 		V = V*D; // or V*D*~V ?
 
+		// the sigma points, and the motion noise that goes with each of them
+		std::vector<Matrix> points(1 + 2*xDim + 2*mDim, xHat);
+		std::vector<Matrix> noises(points.size(), zeros(mDim));
 		for (size_t i = 0; i < xDim; ++i) {
-			X.push_back(f(xHat + V.subMatrix(0, i, xDim, 1), u, zeros(mDim) ));
-			X.push_back(f(xHat - V.subMatrix(0, i, xDim, 1), u, zeros(mDim) ));
+			points[1 + 2*i] = xHat + V.subMatrix(0, i, xDim, 1);
+			points[2 + 2*i] = xHat - V.subMatrix(0, i, xDim, 1);
 		}
-
-		Matrix m = zeros(mDim);
 		double sigma = sqrt(L + lambda);
 		for (size_t i = 0; i < mDim; ++i) {
-			m[i] = sigma;
-			X.push_back(f(xHat, u, m));
-			m[i] = -sigma;
-			X.push_back(f(xHat, u, m));
-			m[i] = 0;
+			noises[1 + 2*xDim + 2*i][i] = sigma;
+			noises[2 + 2*xDim + 2*i][i] = -sigma;
 		}
 
+		// propagate sigma points through f
+		std::vector<Matrix> X(points.size());
+		forEachChunk(scheduler, X.size(), [&](size_t first, size_t end) {
+			for (size_t i = first; i < end; ++i) {
+				X[i] = f(points[i], u, noises[i]);
+			}
+		});
+
 		// calculate mean
 		xHat = mw * X[0];
 		for (size_t i = 1; i < X.size(); ++i) {
@@ -1114,10 +1389,13 @@ namespace Util {
 	*  @param       alpha   Parameter determining the spread of the sigma points (optional).
 	*  @param       beta    Parameter to incorporate prior knowledge of the kurtosis of the distribution (optional).
 	*  @param       kappa   Scaling parameter (optional).
+	*  @param       scheduler       The scheduler to propagate the sigma points on (optional); <i>h</i> must then be
+	*                       thread-safe. The results are the same as without a scheduler.
 	*  \ingroup ukf
 	*/
 	inline void ukfMeasurementUpdate(Matrix& xHat, Matrix& Sigma, const Matrix& z, size_t nDim,
-									 Matrix (*h)(const Matrix&, const Matrix&), double alpha = DEFAULTALPHA, double beta = DEFAULTBETA, double kappa = DEFAULTKAPPA)
+									 Matrix (*h)(const Matrix&, const Matrix&), double alpha = DEFAULTALPHA, double beta = DEFAULTBETA, double kappa = DEFAULTKAPPA,
+									 Util::TaskScheduler * scheduler = NULL)
 	{
 		size_t xDim = xHat.numRows();
 		size_t zDim = z.numRows();
@@ -1129,11 +1407,6 @@ namespace Util {
 		double mw = lambda / (L + lambda);
 		double vw = mw + (1 - alpha*alpha + beta);
 
-		std::vector<Matrix> Z;
-		std::vector<Matrix> X;
-		X.push_back(xHat);
-		Z.push_back(h(xHat, zeros(nDim)));
-
 		Matrix V(xDim,xDim), D(xDim,xDim);
 		jacobi((L + lambda) * Sigma, V, D);
 		for (size_t i = 0; i < xDim; ++i) {
@@ -1141,23 +1414,27 @@ namespace Util {
 		}
 		V = V*D;
 
+		// the sigma points of the state, followed by the measurement noise sigma points around xHat
+		std::vector<Matrix> X(1 + 2*xDim, xHat);
 		for (size_t i = 0; i < xDim; ++i) {
-			X.push_back(xHat + V.subMatrix(0, i, xDim, 1));
-			Z.push_back(h(xHat + V.subMatrix(0, i, xDim, 1), zeros(nDim) ));
-			X.push_back(xHat - V.subMatrix(0, i, xDim, 1));
-			Z.push_back(h(xHat - V.subMatrix(0, i, xDim, 1), zeros(nDim) ));
+			X[1 + 2*i] = xHat + V.subMatrix(0, i, xDim, 1);
+			X[2 + 2*i] = xHat - V.subMatrix(0, i, xDim, 1);
 		}
-
-		Matrix n = zeros(nDim);
+		std::vector<Matrix> noises(X.size() + 2*nDim, zeros(nDim));
 		double sigma = sqrt(L + lambda);
 		for (size_t i = 0; i < nDim; ++i) {
-			n[i] = sigma;
-			Z.push_back(h(xHat, n));
-			n[i] = -sigma;
-			Z.push_back(h(xHat, n));
-			n[i] = 0;
+			noises[X.size() + 2*i][i] = sigma;
+			noises[X.size() + 2*i + 1][i] = -sigma;
 		}
 
+		// propagate sigma points through h
+		std::vector<Matrix> Z(noises.size());
+		forEachChunk(scheduler, Z.size(), [&](size_t first, size_t end) {
+			for (size_t i = first; i < end; ++i) {
+				Z[i] = h((i < X.size()) ? X[i] : xHat, noises[i]);
+			}
+		});
+
 		// calculate mean
 		Matrix zHat(zDim);
 		zHat = mw * Z[0];
@@ -1205,6 +1482,8 @@ namespace Util {
 	*  @param       alpha   Parameter determining the spread of the sigma points (optional).
 	*  @param       beta    Parameter to incorporate prior knowledge of the kurtosis of the distribution (optional).
 	*  @param       kappa   Scaling parameter (optional).
+	*  @param       scheduler       The scheduler to propagate the sigma points on (optional); <i>f</i> and <i>h</i>
+	*                       must then be thread-safe. The results are the same as without a scheduler.
 	*  @note        Performing a full step of the Unscented Kalman Filter is not equivalent to sequentially performing
 	*               a control and a measurement update step, as the sigma points are not resampled after the control
 	*               update.
@@ -1212,7 +1491,8 @@ namespace Util {
 	*/
 	inline void unscentedKalmanFilter(Matrix& xHat, Matrix& Sigma, const Matrix& u, const Matrix& z,
 									  size_t mDim, Matrix (*f)(const Matrix&, const Matrix&, const Matrix&),
-									  size_t nDim, Matrix (*h)(const Matrix&, const Matrix&), double alpha = DEFAULTALPHA, double beta = DEFAULTBETA, double kappa = DEFAULTKAPPA)
+									  size_t nDim, Matrix (*h)(const Matrix&, const Matrix&), double alpha = DEFAULTALPHA, double beta = DEFAULTBETA, double kappa = DEFAULTKAPPA,
+									  Util::TaskScheduler * scheduler = NULL)
 	{
 		size_t xDim = xHat.numRows();
 		size_t zDim = z.numRows();
@@ -1226,10 +1506,6 @@ namespace Util {
 
 		// Control Update -- O(xDim^3)
 
-		// propagate sigma points through f
-		std::vector<Matrix> X;
-		X.push_back(f(xHat, u, zeros(mDim)));
-
 		Matrix V(xDim,xDim), D(xDim,xDim); // O(xDim^3)
 		jacobi((L + lambda) * Sigma, V, D);
 		for (size_t i = 0; i < xDim; ++i) {
@@ -1237,21 +1513,27 @@ namespace Util {
 		}
 		V = V*D; // or V*D*~V ?
 
-		for (size_t i = 0; i < xDim; ++i) { // O(xDim^2)
-			X.push_back(f(xHat + V.subMatrix(0, i, xDim, 1), u, zeros(mDim) ));
-			X.push_back(f(xHat - V.subMatrix(0, i, xDim, 1), u, zeros(mDim) ));
+		// the sigma points, and the motion noise that goes with each of them -- O(xDim^2)
+		std::vector<Matrix> points(1 + 2*xDim + 2*mDim, xHat);
+		std::vector<Matrix> mNoises(points.size(), zeros(mDim));
+		for (size_t i = 0; i < xDim; ++i) {
+			points[1 + 2*i] = xHat + V.subMatrix(0, i, xDim, 1);
+			points[2 + 2*i] = xHat - V.subMatrix(0, i, xDim, 1);
 		}
-
-		Matrix m = zeros(mDim);
 		double sigma = sqrt(L + lambda);
 		for (size_t i = 0; i < mDim; ++i) {
-			m[i] = sigma;
-			X.push_back(f(xHat, u, m));
-			m[i] = -sigma;
-			X.push_back(f(xHat, u, m));
-			m[i] = 0;
+			mNoises[1 + 2*xDim + 2*i][i] = sigma;
+			mNoises[2 + 2*xDim + 2*i][i] = -sigma;
 		}
 
+		// propagate sigma points through f
+		std::vector<Matrix> X(points.size());
+		forEachChunk(scheduler, X.size(), [&](size_t first, size_t end) {
+			for (size_t i = first; i < end; ++i) {
+				X[i] = f(points[i], u, mNoises[i]);
+			}
+		});
+
 		// calculate mean -- O(xDim^2)
 		xHat = (mw + 2*nDim*w) * X[0];
 		for (size_t i = 1; i < X.size(); ++i) {
@@ -1266,21 +1548,21 @@ namespace Util {
 
 		// Measurement Update
 
-		// propagate sigma points through h -- O(xDim * zDim)
-		std::vector<Matrix> Z;
-		for (size_t i = 0; i < X.size(); ++i) {
-			Z.push_back(h(X[i], zeros(nDim)));
-		}
-
-		Matrix n = zeros(nDim); // O(zDim^2)
+		// the measurement noise sigma points around X[0] -- O(zDim^2)
+		std::vector<Matrix> nNoises(X.size() + 2*nDim, zeros(nDim));
 		for (size_t i = 0; i < nDim; ++i) {
-			n[i] = sigma;
-			Z.push_back(h(X[0], n));
-			n[i] = -sigma;
-			Z.push_back(h(X[0], n));
-			n[i] = 0;
+			nNoises[X.size() + 2*i][i] = sigma;
+			nNoises[X.size() + 2*i + 1][i] = -sigma;
 		}
 
+		// propagate sigma points through h -- O(xDim * zDim)
+		std::vector<Matrix> Z(nNoises.size());
+		forEachChunk(scheduler, Z.size(), [&](size_t first, size_t end) {
+			for (size_t i = first; i < end; ++i) {
+				Z[i] = h((i < X.size()) ? X[i] : X[0], nNoises[i]);
+			}
+		});
+
 		// calculate mean -- O(xDim*zDim + zDim^2)
 		Matrix zHat(zDim);
 		zHat = mw * Z[0];
@@ -1532,6 +1814,54 @@ namespace Util {
 		kfControlUpdate(xHat, Sigma, u, A, B, M);
 		kfMeasurementUpdate(xHat, Sigma, z, H, N);
 	}
+
+	/*!
+	*  @brief       Performs a control update step of the Kalman Filter, for dimensions known at compile time.
+	*  @tparam      xDim    The dimension of the state.
+	*  @tparam      uDim    The dimension of the control input.
+	*  @note        Same as the Matrix version, but every intermediate result lives on the stack, so
+	*               filtering many small states (e.g., one per agent) does not allocate.
+	*  \ingroup kf
+	*/
+	template <size_t xDim, size_t uDim>
+	inline void kfControlUpdate(FixedMatrix<xDim,1>& xHat, FixedMatrix<xDim,xDim>& Sigma, const FixedMatrix<uDim,1>& u,
+								const FixedMatrix<xDim,xDim>& A, const FixedMatrix<xDim,uDim>& B, const FixedMatrix<xDim,xDim>& M)
+	{
+		xHat = A*xHat + B*u; // O(xDim)
+		Sigma = A*Sigma*~A + M;        // O(xDim^3)
+	}
+
+	/*!
+	*  @brief       Performs a measurement update step of the Kalman Filter, for dimensions known at compile time.
+	*  @tparam      xDim    The dimension of the state.
+	*  @tparam      zDim    The dimension of the measurement.
+	*  \ingroup kf
+	*/
+	template <size_t xDim, size_t zDim>
+	inline void kfMeasurementUpdate(FixedMatrix<xDim,1>& xHat, FixedMatrix<xDim,xDim>& Sigma, const FixedMatrix<zDim,1>& z,
+									const FixedMatrix<zDim,xDim>& H, const FixedMatrix<zDim,zDim>& N)
+	{
+		FixedMatrix<xDim,zDim> K = Sigma*~H/(H*Sigma*~H + N); // O(zDim*xDim^2 + zDim^2*xDim + zDim^3)
+
+		xHat += K*(z - H*xHat); // O(xDim*zDim)
+		Sigma -= K*(H*Sigma);   // O(xDim^2*zDim)
+	}
+
+	/*!
+	*  @brief       Performs a full step of the Kalman Filter, for dimensions known at compile time.
+	*  @tparam      xDim    The dimension of the state.
+	*  @tparam      uDim    The dimension of the control input.
+	*  @tparam      zDim    The dimension of the measurement.
+	*  \ingroup kf
+	*/
+	template <size_t xDim, size_t uDim, size_t zDim>
+	inline void kalmanFilter(FixedMatrix<xDim,1>& xHat, FixedMatrix<xDim,xDim>& Sigma, const FixedMatrix<uDim,1>& u, const FixedMatrix<zDim,1>& z,
+							 const FixedMatrix<xDim,xDim>& A, const FixedMatrix<xDim,uDim>& B, const FixedMatrix<xDim,xDim>& M,
+							 const FixedMatrix<zDim,xDim>& H, const FixedMatrix<zDim,zDim>& N)
+	{
+		kfControlUpdate(xHat, Sigma, u, A, B, M);
+		kfMeasurementUpdate(xHat, Sigma, z, H, N);
+	}
 	
 	#endif
 
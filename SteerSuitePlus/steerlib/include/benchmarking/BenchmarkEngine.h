@@ -78,8 +78,10 @@ namespace SteerLib {
 	class STEERLIB_API BenchmarkEngine : public SteerLib::BenchmarkEnginePrivate
 	{
 	public:
-		/// Initializes the engine
-		BenchmarkEngine(const std::string & recordingFilename, SteerLib::BenchmarkTechniqueInterface * benchmarkTechnique);
+		/// Initializes the engine; numMetricsThreads is the number of threads used to update the per-agent metrics of each frame.
+		BenchmarkEngine(const std::string & recordingFilename, SteerLib::BenchmarkTechniqueInterface * benchmarkTechnique, unsigned int numMetricsThreads = 1);
+		/// Releases the rec file, spatial database, agents and obstacles; the benchmark technique is owned by the caller and is not destroyed.
+		~BenchmarkEngine();
 		/// Validates the rec file against a test case, returns true if the rec file initial conditions match the test case initial conditions, false otherwise.
 		bool isValidTestCaseSimulation(const std::string & testCaseDirectory);
 		/// Updates metrics and benchmark scoring for the next frame of the rec file.
@@ -103,6 +105,8 @@ namespace SteerLib {
 
 		/// Prints details about how the total benchmark score was computed
 		void printTotalScoreDetails(std::ostream & out);
+		/// Prints one CSV-formatted line for the total benchmark score, if the benchmark technique supports it
+		void printTotalScoreCSV(std::ostream & out);
 		/// Prints details about how an agent's benchmark score was computed
 		void printAgentScoreDetails(unsigned int agentIndex, std::ostream & out);
 		/// Prints the current metrics for an agent; this can become <b>very verbose</b> if used for multiple agents or multiple frames.
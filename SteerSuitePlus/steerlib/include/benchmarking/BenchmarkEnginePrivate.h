@@ -72,6 +72,14 @@ namespace SteerLib {
 		inline void setForward(const Util::Vector & newForward) { _forward = newForward; }
 		inline void setRadius(float newRadius) { _radius = newRadius; }
 		inline void setCurrentGoal(const SteerLib::AgentGoalInfo & newGoal) { _currentGoal = newGoal; }
+		/// Sets all recorded fields of this agent from a single rec file agent record.
+		inline void setFromRecFileInfo(const SteerLib::RecFileAgentInfo & info) {
+			_enabled = info.enabled;
+			_position = Util::Point(info.pos.x, info.pos.y, info.pos.z);
+			_forward = Util::Vector(info.dir.x, info.dir.y, info.dir.z);
+			_radius = info.radius;
+			_currentGoal.targetLocation = Util::Point(info.goal.x, info.goal.y, info.goal.z);
+		}
 		inline Util::AxisAlignedBox getBounds() { return Util::AxisAlignedBox(_position.x - _radius, _position.x + _radius, 0.0f, 0.0f, _position.z - _radius, _position.z + _radius); }
 
 		void insertAgentNeighbor(const SteerLib::AgentInterface *agent, float &rangeSq) { throw Util::GenericException("insertAgentNeighbor not implemented yet for BenchmarkAgent"); }
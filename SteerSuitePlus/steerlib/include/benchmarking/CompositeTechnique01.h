@@ -53,6 +53,7 @@ namespace SteerLib {
 		float getAgentBenchmarkScore(unsigned int agentIndex, SimulationMetricsCollector * simulationMetrics);
 		void printTotalScoreDetails(SimulationMetricsCollector * simulationMetrics, std::ostream & out);
 		void printAgentScoreDetails(unsigned int agentIndex, SimulationMetricsCollector * simulationMetrics, std::ostream & out);
+		void printTotalScoreCSV(SimulationMetricsCollector * simulationMetrics, std::ostream & out);
 
 	protected:
 		float _computeTotalBenchmarkScore(SimulationMetricsCollector * simulationMetrics);
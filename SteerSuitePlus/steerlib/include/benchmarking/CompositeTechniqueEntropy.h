@@ -29,6 +29,10 @@ namespace SteerLib
 	class STEERLIB_API CompositeTechniqueEntropy : public SteerLib::CompositeBenchmarkTechnique02
 	{
 	public:
+		/// The state of one agent (p_x, p_z, v_x, v_z) and its covariance; fixed size, so per agent math does not allocate.
+		typedef FixedMatrix<4,1> AgentState;
+		typedef FixedMatrix<4,4> AgentCovariance;
+
 		CompositeTechniqueEntropy();
 		virtual ~CompositeTechniqueEntropy();
 
@@ -41,6 +45,7 @@ namespace SteerLib
 
 		SteerLib::AgentInitialConditions getAgentConditions(SteerLib::AgentInterface * interface_);
 
+		/// Runs the whole estimation at once; update() instead advances it by estimationStepsPerFrame steps each frame.
 		void performEstimation();
 
 		void readNoisyData(std::string file);
@@ -88,6 +93,8 @@ namespace SteerLib
 		 */
 		// real simulator
 		Matrix m_fHat(const Matrix& x, const Matrix& u, const Matrix& m1);
+		/// Same as m_fHat(x, u, m1), but writes the new state into xNew, reusing its storage if it already has the right size.
+		void m_fHat(const Matrix& x, const Matrix& u, const Matrix& m1, Matrix & xNew);
 		// just compairs real data to estimated data
 		Matrix m_fHatData(const Matrix& x, const Matrix& u, const Matrix& m1);
 		// measurement update
@@ -116,35 +123,44 @@ namespace SteerLib
 		unsigned int _perferedNumFrames;
 
 		/*
-		 * This will be filled with a number of samples
-		 * Matrix0
-		 * 						frame0				frame1				.	.	.
-		 * 			agent0	p_x, p_z, v_x, v_z	p_x, p_z, v_x, v_z   	.	.	.
-		 * 			agent1	p_x, p_z, v_x, v_z
-		 * 			.				.			.
-		 * 			.				.				.
-		 * 			.				.					.
-		 *
-		 * Matrix1
-		 * 						frame0				frame1				.	.	.
-		 * 			agent0	p_x, p_z, v_x, v_z	p_x, p_z, v_x, v_z   	.	.	.
-		 * 			agent1	p_x, p_z, v_x, v_z
-		 * 			.				.			.
-		 * 			.				.				.
-		 * 			.				.					.
-		 */
-		std::vector<std::vector<Matrix> > Xs;
-
-		/*
-		 * This will contain the estimated data
-		 *
-		 * frame0 a0p_x, a0p_z, a0v_x, a0v_z	a1p_x, a1p_z, a1v_x, a1v_z   	.	.	.
-		 * frame1 a0p_x, a0p_z, a0v_x, a0v_z	a1p_x, a1p_z, a1v_x, a1v_z   	.	.	.
-		 * .
-		 * .
-		 * .
+		 * Streaming state of the estimation.  Each new ensemble (one p_x, p_z, v_x, v_z
+		 * vector per sample) is only compared against the previous one, so instead of the
+		 * ensembles of every frame only the previous ensemble and running sums are kept.
 		 */
-		std::vector<Matrix> _xHats;
+		std::vector<Matrix> _previousEnsemble;
+		Matrix _previousXHat;
+		/// The state simulated from one sample of the previous ensemble; reused for every sample, so the model error does not allocate per sample.
+		Matrix _simulatedState;
+		/// Running sum of diff*~diff between simulating the previous ensemble one step and the new ensemble.
+		AgentCovariance _modelErrorSum;
+		AgentState _lastModelError;
+		/// Per agent running sums of the distance between the estimated and the recorded positions/velocities.
+		std::vector<float> _positionErrorSums;
+		std::vector<float> _velocityErrorSums;
+		size_t _numEstimatedSteps;
+
+		/// The ensemble (one state per sample) that the estimation filters one time step of _posData at a time.
+		std::vector<Matrix> _ensemble;
+		/// The next time step of _posData to filter; 0 until the estimation begins.
+		size_t _nextEstimationStep;
+		/// The number of time steps in _posData.
+		size_t _numEstimationSteps;
+		/// The number of time steps update() filters each frame, or 0 to filter all of them in the first frame; the "estimationStepsPerFrame" option.
+		unsigned int _estimationStepsPerFrame;
+
+		/// Reads and selects the data, sets up the agents, and samples the initial ensemble.
+		void _beginEstimation();
+		/// Filters the ensemble with the data of the next time step, and updates _entropyResult to the entropy of the steps filtered so far.
+		void _estimateNextStep();
+		/// Reports the errors of the estimation and sets the final _entropyResult.
+		void _endEstimation();
+
+		/// Clears the streaming state before the first ensemble is estimated.
+		void _beginModelError();
+		/// Adds the error of the newest ensemble X (with mean xHat) against the previous ensemble to the running sums.
+		void _accumulateModelError(const std::vector<Matrix> & X, const Matrix & xHat);
+		/// Returns the entropy of the model error accumulated so far.
+		double _computeEntropy();
 
 		std::string _realDataFileName;
 		std::string _agentModuleName;
@@ -175,7 +191,7 @@ namespace SteerLib
 		int Z_DIM; // Measurement dimension
 		int M_DIM;  // Motion Noise dimension
 		int N_DIM;  // Measurement Noise dimension
-		Matrix M;
+		AgentCovariance M;
 
 		void setDIM()
 		{
@@ -12,12 +12,17 @@
 /// @brief Declares the SteerLib::SimulationMetricsCollector class
 
 #include <vector>
+#include <string>
 #include "Globals.h"
 #include "benchmarking/AgentMetricsCollector.h"
 #include "interfaces/SpatialDataBaseInterface.h"
 #include "recfileio/RecFileIO.h"
 #include "interfaces/AgentInterface.h"
 
+namespace Util {
+	class TaskScheduler;
+}
+
 #ifdef _WIN32
 // on win32, there is an unfortunate conflict between exporting symbols for a
 // dynamic/shared library and STL code.  A good document describing the problem
@@ -32,13 +37,19 @@ namespace SteerLib {
 	/**
 	 * @brief Functionality for collecting all metrics of a simulation, including an AgentMetricsCollector for each agent.
 	 *
+	 * The per-agent updates only read the spatial database and each one only writes to its own
+	 * AgentMetricsCollector, so when numThreads is larger than 1, update() splits the agents into
+	 * contiguous ranges and updates them in parallel with Util::TaskScheduler::parallelFor().
+	 * The ranges depend only on the number of agents, and the collected metrics are identical to
+	 * the single-threaded results.  The spatial database must not be modified while update() is running.
+	 *
 	 * @todo
 	 *    - add more documentation for this class
 	 */
     class STEERLIB_API SimulationMetricsCollector
 	{
 	public:
-	    SimulationMetricsCollector( const std::vector<SteerLib::AgentInterface*> & agents);
+	    SimulationMetricsCollector( const std::vector<SteerLib::AgentInterface*> & agents, unsigned int numThreads = 1);
 	    ~SimulationMetricsCollector();
 	    
 		void reset();
@@ -46,6 +57,8 @@ namespace SteerLib {
 	    
 	    AgentMetricsCollector * getAgentCollector(unsigned int agentIndex) { return _agentCollectors[agentIndex]; }
 	    size_t getNumAgents() { return _agentCollectors.size(); }
+		/// Returns the number of threads used to update the agent metrics.
+		unsigned int getNumThreads() { return _numThreads; }
 
 		void printCurrentMetrics(unsigned int agentIndex, std::ostream & out);
 
@@ -53,9 +66,14 @@ namespace SteerLib {
 	    void _resetEnvironmentMetrics();
 	    void _updateAgentMetrics(SteerLib::SpatialDataBaseInterface * gridDB, const std::vector<SteerLib::AgentInterface*> & updatedAgents, float currentTimeStamp, float timePassedSinceLastFrame);
 	    void _updateEnvironmentMetrics(SteerLib::SpatialDataBaseInterface * gridDB, float currentTimeStamp, float timePassedSinceLastFrame);
+		/// Updates the agent metrics collectors in the index range [firstAgent, endAgent).
+		void _updateAgentMetricsRange(SteerLib::SpatialDataBaseInterface * gridDB, const std::vector<SteerLib::AgentInterface*> & updatedAgents, float currentTimeStamp, float timePassedSinceLastFrame, size_t firstAgent, size_t endAgent);
 	    
 	    std::vector<AgentMetricsCollector*> _agentCollectors;
 	    EnvironmentMetrics _environmentMetrics;
+
+		unsigned int _numThreads;
+		Util::TaskScheduler * _taskScheduler;
     
 	};
     
@@ -14,7 +14,6 @@
 // #include "SteerLib.h"
 #include "util/Geometry.h"
 #include "util/GenericException.h"
-#include "util/Mutex.h"
 // #include "interfaces/AgentInterface.h"
 #include <sstream>
 
@@ -40,9 +39,17 @@ namespace SteerLib {
 	 * The cell contains a list of pointers of SpatialDatabaseItem objects that 
 	 * overlap the cell.
 	 *
+	 * The cell belongs to the agent layer of the database: the list only holds agents (items whose isAgent() returns true),
+	 * packed in the first _numItems slots, with the remaining slots NULL.  The obstacles that overlap the cell are stored in
+	 * the obstacle layer of the database instead; the cell only counts them, and includes their traversal cost in its own.
+	 * Adding or removing an item moves at most one other item; the order of the items is not preserved.
+	 *
 	 * Most users should not need to use this class at all, the GridDatabase2D is the main 
 	 * public interface for using the spatial database functionality.
 	 *
+	 * A grid cell does no locking of its own, so adding and removing items costs nothing extra; the database must only
+	 * be updated from one thread at a time.
+	 *
 	 */
 	class STEERLIB_API GridCell {
 
@@ -53,14 +60,13 @@ namespace SteerLib {
 				_items[j] = NULL;
 			}
 			_numItems = 0; // initialize with no items in the grid cell
+			_numObstacles = 0;
 			_traversalCost = initialTraversalCost;
 		}
 
 		/// Adds an object reference to this cell.
 		inline void add(SpatialDatabaseItemPtr entry, unsigned int maxItems, float traversalCostToAdd) {
 
-			_gridCellMutex.lock();
-
 			/** 
 			 * If an exception is thrown in this function, it means, there are too many 
 			 * agents in one grid cell.  If you are certain its not a bug, you can increase 
@@ -70,29 +76,19 @@ namespace SteerLib {
 
 			if (_numItems >= maxItems)
 			{
-				_gridCellMutex.unlock();
 				std::cout << "The number of items in this cell is:" << _numItems << " The max number of items can be: " << maxItems << std::endl;
 				throw Util::GenericException("There are too many items in a single cell of the grid database.\nIn the next version, this will be handled robstly and not be an error.\nFor now, use a higher number for maxItemsPerGridCell (in the config file), or\nincrease the resolution of the grid (both of which may decrease performance).");
 			}
+			_items[_numItems] = entry;
 			_numItems++;
-			unsigned int i=0;
-			while (_items[i] != NULL) {
-				i++;
-			}
-			_items[i] = entry;
 
 			_traversalCost += traversalCostToAdd;
-
-			_gridCellMutex.unlock();
 		}
 
 		/// Removes an object reference from this cell.
 		inline void remove(SpatialDatabaseItemPtr entry, unsigned int maxItems, float traversalCostToSubtract) {
 
-			_gridCellMutex.lock();
-
 			if (_numItems <= 0) {
-				_gridCellMutex.unlock();
 				// throw Util::GenericException("Tried to remove an object from a grid cell, but the grid cell was empty." );
 				std::stringstream errormsg;
 				// I was trying to create a more informative error message
@@ -107,30 +103,43 @@ namespace SteerLib {
 				}
 				throw Util::GenericException(errormsg.str());
 			}
-			_numItems--;
 			unsigned int i=0;
-			while ((_items[i] != entry) && (i<maxItems)) i++;
-			if (i >= maxItems) {
-				_gridCellMutex.unlock();
+			while ((i<_numItems) && (_items[i] != entry)) i++;
+			if (i >= _numItems) {
 				throw Util::GenericException("Tried to remove an object from a grid cell, but it did not exist there in the first place.");
 			}
-			_items[i] = NULL;
+			// fill the hole with the last item.
+			_items[i] = _items[_numItems-1];
+			_numItems--;
+			_items[_numItems] = NULL;
 
 			_traversalCost -= traversalCostToSubtract;
-
-			_gridCellMutex.unlock();
-
 		}
 
-		inline void clear()
+		/// Removes all object references from this cell; items may be in any of the maxItems slots.
+		inline void clear(unsigned int maxItems)
 		{
-			_gridCellMutex.lock();
-			for (unsigned int j=0; j < _numItems; j++) {
+			for (unsigned int j=0; j < maxItems; j++) {
 				_items[j] = NULL;
 			}
 			_traversalCost = 0;
 			_numItems=0;
-			_gridCellMutex.unlock();
+			_numObstacles=0;
+		}
+
+		/// Counts an obstacle that overlaps this cell; the obstacle itself is stored in the obstacle layer.
+		inline void addObstacle(float traversalCostToAdd) {
+			_numObstacles++;
+			_traversalCost += traversalCostToAdd;
+		}
+
+		/// Stops counting an obstacle that overlapped this cell.
+		inline void removeObstacle(float traversalCostToSubtract) {
+			if (_numObstacles == 0) {
+				throw Util::GenericException("Tried to remove an obstacle from a grid cell, but the grid cell had no obstacles.");
+			}
+			_numObstacles--;
+			_traversalCost -= traversalCostToSubtract;
 		}
 
 	private:
@@ -142,14 +151,14 @@ namespace SteerLib {
 		/// The number of items currently referenced in this cell.
 		unsigned int _numItems;
 
+		/// The number of obstacles of the obstacle layer that overlap this cell.
+		unsigned int _numObstacles;
+
 		/// An array of pointers of fixed length; the length is determined during GridDatabase initialization.
 		SpatialDatabaseItemPtr * _items;
 
 		/// Cost of traversing this grid cell
 		float _traversalCost;
-
-		/// This lock is used by the grid database directly; by itself the grid cell is not necessarily thread safe.
-		Util::Mutex _gridCellMutex;
 	};
 
 
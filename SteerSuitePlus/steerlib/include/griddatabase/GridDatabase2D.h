@@ -31,8 +31,12 @@ namespace SteerLib {
 	 * @brief A 2-D spatial database, that can contain any objects that inherit the SpatialDatabaseItem interface.
 	 *
 	 * This class is an efficient 2-D spatial database that organizes objects in your environment (i.e., agents or obstacles).
-	 * In particular, this database organizes objects in a 2-D grid, where each cell in the grid contains a fixed
-	 * number of references to objects.
+	 * In particular, this database organizes objects in two 2-D grids over the same area, which can have different resolutions:
+	 *  - The <b>agent layer</b> holds the items whose isAgent() returns true.  Each of its cells contains a fixed number of
+	 *    references to agents, so that agents can move from cell to cell cheaply.
+	 *  - The <b>obstacle layer</b> holds all other items.  It is densely packed and immutable: adding or removing an obstacle
+	 *    marks it dirty, and it is rebuilt as a whole by the next query that needs it, or by #refreshDataBase(), which the
+	 *    engine calls once all obstacles of a test case are added.  Its cells have no limit on the number of items.
 	 *
 	 * The database supports four main types of queries:
 	 *  - <b>Updates and basic queries:</b> i.e. adding/removing objects from the database, and querying the basic properties of the database.
@@ -51,12 +55,17 @@ namespace SteerLib {
 	 * Perform queries on the database using the appropriate functionality described in the public interface.
 	 *
 	 * <h3> Notes </h3>
-	 *  - The database implementation is not (yet) thread-safe.
+	 *  - Queries only scan the layers they need: #getAgentsInRange() only the agent layer, #getObstaclesInRange() and #trace()
+	 *    with excludeAgents only the obstacle layer.  Other queries scan both, and merge the results as if there was one grid.
+	 *  - The cell indices, #getTraversalCost(), and #hasAnyItems() refer to the agent layer; obstacles are counted in every agent
+	 *    cell they overlap, so traversal costs are the same as with one grid.
+	 *  - Queries may run in parallel, but updates must come from one thread, while no queries run.
+	 *    Moving an obstacle rebuilds the obstacle layer, so items that move every frame should be agents.
 	 *  - The grid is located on the x-z plane.
 	 *  - During initialization you separately define (1) the spatial size of the grid, and (2) the 
-	 *    number of cells to create along the x and z directions.
-	 *  - You also define the max number of items to store in each cell.  Trying to storing more than 
-	 *    this number of items in a single grid cell will cause a Util::GenericException to be thrown.
+	 *    number of cells to create along the x and z directions, for each layer.
+	 *  - You also define the max number of agents to store in each cell.  Trying to storing more than 
+	 *    this number of agents in a single grid cell will cause a Util::GenericException to be thrown.
 	 *
 	 * <h3> Performance considerations </h3>
 	 * Algorithmically, all types of queries are fairly efficient, by narrowing the computation cost down to 
@@ -86,8 +95,9 @@ namespace SteerLib {
 	public:
 		/// @name Constructors and destructors
 		//@{
-		GridDatabase2D(float xmin, float xmax, float zmin, float zmax, unsigned int numXCells, unsigned int numZCells, unsigned int numItemsPerCell, bool drawGrid);
-		GridDatabase2D(const Util::Point & origin2D, float xExtent, float zExtent, unsigned int numXCells, unsigned int numZCells, unsigned int numItemsPerCell, bool drawGrid);
+		/// numXCells and numZCells are the resolution of the agent layer; the obstacle layer has the same resolution unless numObstacleXCells and numObstacleZCells are not zero.
+		GridDatabase2D(float xmin, float xmax, float zmin, float zmax, unsigned int numXCells, unsigned int numZCells, unsigned int numItemsPerCell, bool drawGrid, unsigned int numObstacleXCells = 0, unsigned int numObstacleZCells = 0);
+		GridDatabase2D(const Util::Point & origin2D, float xExtent, float zExtent, unsigned int numXCells, unsigned int numZCells, unsigned int numItemsPerCell, bool drawGrid, unsigned int numObstacleXCells = 0, unsigned int numObstacleZCells = 0);
 		~GridDatabase2D();
 		//@}
 
@@ -109,6 +119,14 @@ namespace SteerLib {
 		inline unsigned int getNumCellsX() { return _xNumCells; }
 		/// Returns the number of grid cells along the a direction.
 		inline unsigned int getNumCellsZ() { return _zNumCells; }
+		/// Returns the size of one cell of the obstacle layer along the x direction.
+		inline float getObstacleCellSizeX() { return  _xObstacleCellSize; }
+		/// Returns the size of one cell of the obstacle layer along the z direction.
+		inline float getObstacleCellSizeZ() { return  _zObstacleCellSize; }
+		/// Returns the number of cells of the obstacle layer along the x direction.
+		inline unsigned int getNumObstacleCellsX() { return _xNumObstacleCells; }
+		/// Returns the number of cells of the obstacle layer along the z direction.
+		inline unsigned int getNumObstacleCellsZ() { return _zNumObstacleCells; }
 		//@}
 
 		/// @name Conversions between index, location, and grid coordinates
@@ -135,14 +153,16 @@ namespace SteerLib {
 		void updateObject( SpatialDatabaseItemPtr item, const Util::AxisAlignedBox & oldBounds, const Util::AxisAlignedBox & newBounds );
 		///
 		virtual void clearDatabase();
+		/// Builds the obstacle layer now if obstacles were added or removed, instead of in the next query that needs it.
+		virtual void refreshDataBase();
 		//@}
 
 		/// @name Traversability queries
 		//@{
 		/// Returns true if there are any objects referenced in the GridCell.
-		inline bool hasAnyItems( unsigned int cellIndex ) { return (_cells[cellIndex]._numItems != 0); }
+		inline bool hasAnyItems( unsigned int cellIndex ) { return (_cells[cellIndex]._numItems != 0) || (_cells[cellIndex]._numObstacles != 0); }
 		/// Returns true if there are any objects referenced in the GridCell.
-		inline bool hasAnyItems( unsigned int x, unsigned int z ) { return (_cells[getCellIndexFromGridCoords(x,z)]._numItems != 0); }
+		inline bool hasAnyItems( unsigned int x, unsigned int z ) { return hasAnyItems(getCellIndexFromGridCoords(x,z)); }
 		/// Returns the sum total of traversal costs of all objects referenced in the GridCell.
 		inline float getTraversalCost( unsigned int cellIndex ) { return _cells[cellIndex]._traversalCost; }
 		/// Returns the sum total of traversal costs of all objects referenced in the GridCell.
@@ -155,6 +175,14 @@ namespace SteerLib {
 		void getItemsInRange(std::set<SpatialDatabaseItemPtr> & neighborList, float xmin, float xmax, float zmin, float zmax, SpatialDatabaseItemPtr exclude);
 		/// Returns an STL set of objects found in the specified range of GridCells.
 		void getItemsInRange(std::set<SpatialDatabaseItemPtr> & neighborList, unsigned int xMinIndex, unsigned int xMaxIndex, unsigned int zMinIndex, unsigned int zMaxIndex, SpatialDatabaseItemPtr exclude);
+		/// Clears neighborList and fills it with the objects found in the specified spatial range, sorted by address and without duplicates.
+		void getItemsInRange(std::vector<SpatialDatabaseItemPtr> & neighborList, float xmin, float xmax, float zmin, float zmax, SpatialDatabaseItemPtr exclude);
+		/// Like the version above, but only scans the layers given by kinds, a combination of SteerLib::SpatialDatabaseItemKinds: SPATIAL_DATABASE_AGENTS for the agent layer, SPATIAL_DATABASE_OBSTACLES for the obstacle layer.
+		void getItemsInRange(std::vector<SpatialDatabaseItemPtr> & neighborList, float xmin, float xmax, float zmin, float zmax, SpatialDatabaseItemPtr exclude, unsigned int kinds);
+		/// Clears neighborList and fills it with the agents found in the specified spatial range, sorted by address and without duplicates; only the agent layer is scanned.
+		void getAgentsInRange(std::vector<AgentInterface*> & neighborList, float xmin, float xmax, float zmin, float zmax, SpatialDatabaseItemPtr exclude);
+		/// Clears neighborList and fills it with the obstacles found in the specified spatial range, sorted by address and without duplicates; only the obstacle layer is scanned.
+		void getObstaclesInRange(std::vector<ObstacleInterface*> & neighborList, float xmin, float xmax, float zmin, float zmax, SpatialDatabaseItemPtr exclude);
 		void computeAgentNeighbors(SpatialDatabaseItemPtr agent, float rangeSq) const ;
 		void computeObstacleNeighbors(SpatialDatabaseItemPtr agent, float rangeSq) const ;
 		/// Returns an STL set of objects in the specified range, culling agent objects to a hemisphere centered around the facingDirection.
@@ -169,6 +197,10 @@ namespace SteerLib {
 		bool hasLineOfSight(const Util::Ray & r, SpatialDatabaseItemPtr exclude1, SpatialDatabaseItemPtr exclude2);
 		/// Returns "true" if no intersections were found with objects that might block line of sight. i.e., ignores objects that return blocksLineOfSight()==false.
 		bool hasLineOfSight(const Util::Point & p1, const Util::Point & p2, SpatialDatabaseItemPtr exclude1, SpatialDatabaseItemPtr exclude2);
+		/// Traces several rays at once, such as the feelers of one agent, with the same results as trace().  Falls back to trace() if some ray leaves the grid.
+		unsigned int tracePacket(const Util::Ray * rays, unsigned int numRays, float * t, SpatialDatabaseItemPtr * hitObjects, SpatialDatabaseItemPtr exclude, bool excludeAgents);
+		/// The line-of-sight version of tracePacket().
+		unsigned int hasLineOfSightPacket(const Util::Ray * rays, unsigned int numRays, bool * visible, SpatialDatabaseItemPtr exclude1, SpatialDatabaseItemPtr exclude2);
 		//@}
 
 		/// @name Path planning queries
@@ -210,6 +242,24 @@ namespace SteerLib {
 		virtual Util::Vector getUpVector(SpatialDatabaseItemPtr exclude1) { return Util::Vector(0.0, 1.0, 0.0); }
 		//@}
 
+	protected:
+		/// How a ray marched through one layer by _traceLayer() ended.
+		enum RayMarchResult {
+			RAY_MARCH_HIT,
+			RAY_MARCH_STARTED_OUTSIDE,
+			RAY_MARCH_LEFT_GRID,
+			RAY_MARCH_REACHED_END
+		};
+		/// Marches a ray through the cells of one layer, the way trace() and hasLineOfSight() always did; t and hitObject are only written on a hit.
+		RayMarchResult _traceLayer(const Util::Ray & r, bool obstacleLayer, float & t, SpatialDatabaseItemPtr & hitObject, SpatialDatabaseItemPtr exclude1, SpatialDatabaseItemPtr exclude2, bool lineOfSight);
+		/// Returns true if every ray of a packet starts and ends inside the grid, so that tracePacket() can march it without clamping.
+		bool _canTracePacket(const Util::Ray * rays, unsigned int numRays);
+		/// The vector versions of the nearest neighbor queries: gathers the items of the requested SteerLib::SpatialDatabaseItemKinds that convert() does not map to NULL.
+		template <typename ItemType, typename Converter>
+		void _gatherItemsInRange(std::vector<ItemType*> & neighborList, float xmin, float xmax, float zmin, float zmax, SpatialDatabaseItemPtr exclude, unsigned int kinds, Converter convert);
+		/// Marches one ray of a packet through one layer; finds a hit nearer than nearest and hitObject, or any item that blocks line of sight.
+		bool _marchRay(const Util::Ray & r, bool obstacleLayer, float & nearest, SpatialDatabaseItemPtr & hitObject, SpatialDatabaseItemPtr exclude1, SpatialDatabaseItemPtr exclude2, bool lineOfSight);
+
 	}; // end class GridDatabase2D
 
 
@@ -10,6 +10,9 @@
 /// @file GridDatabase2DPrivate.h
 /// @brief Defines private functionality for the SteerLib::GridDatabase2D spatial database.
 
+#include <vector>
+#include <mutex>
+#include <atomic>
 #include "Globals.h"
 #include "util/Geometry.h"
 #include "util/GenericException.h"
@@ -26,6 +29,8 @@
 #pragma warning( disable : 4251 )
 #endif
 
+class MTRand;
+
 namespace SteerLib {
 
 	// forward declarations
@@ -46,8 +51,28 @@ namespace SteerLib {
 		/// Helper function that allocates the database correctly during initialization
 		void _allocateDatabase();
 
-		/// Helper function that converts a spatial range to a 2-D integer index range.
+		/// Helper function that converts a spatial range to a 2-D integer index range of the agent layer.
 		inline bool _clampSpatialBoundsToIndexRange(float xmin, float xmax, float zmin, float zmax, unsigned int & xMinIndex, unsigned int & xMaxIndex, unsigned int & zMinIndex, unsigned int & zMaxIndex);
+		/// Helper function that converts a spatial range to a 2-D integer index range of a layer with numXCells by numZCells cells.
+		inline bool _clampSpatialBoundsToIndexRange(float xmin, float xmax, float zmin, float zmax, unsigned int numXCells, unsigned int numZCells, unsigned int & xMinIndex, unsigned int & xMaxIndex, unsigned int & zMinIndex, unsigned int & zMaxIndex);
+		/// Converts an index range of the agent layer to the index range of the obstacle layer that covers the same cells.
+		void _getObstacleIndexRange(unsigned int xMinIndex, unsigned int xMaxIndex, unsigned int zMinIndex, unsigned int zMaxIndex, unsigned int & xMinObstacleIndex, unsigned int & xMaxObstacleIndex, unsigned int & zMinObstacleIndex, unsigned int & zMaxObstacleIndex);
+
+		/// @name The obstacle layer
+		//@{
+		/// Adds a non-agent item to the list of obstacles, counts it in the agent layer cells it overlaps, and marks the obstacle layer for rebuilding.
+		void _addObstacle(SpatialDatabaseItemPtr item, float traversalCost, const Util::AxisAlignedBox & bounds);
+		/// Removes a non-agent item from the list of obstacles, and marks the obstacle layer for rebuilding.
+		void _removeObstacle(SpatialDatabaseItemPtr item, const Util::AxisAlignedBox & bounds);
+		/// Rebuilds the obstacle layer from the list of obstacles if it changed since it was last built.
+		inline void _updateObstacleLayer() { if (_obstacleLayerDirty.load(std::memory_order_acquire)) _buildObstacleLayer(); }
+		/// Packs the obstacles into the cells of the obstacle layer; several threads may call it, the first one builds the layer.
+		void _buildObstacleLayer();
+		/// Returns the index of the cell of the obstacle layer at the 2-D integer coordinates (x,z).
+		inline unsigned int _getObstacleCellIndexFromGridCoords(unsigned int x, unsigned int z) { return (x * _zNumObstacleCells) + z; }
+		/// Returns the first item of a cell of the obstacle layer; the items of the cell end where the items of the next cell begin.
+		inline SpatialDatabaseItemPtr * _getObstacleCellItems(unsigned int cellIndex) { return _obstacleCellItems.data() + _obstacleCellStart[cellIndex]; }
+		//@}
 
 		float _xOrigin; // location of the min x,y point of the grid.
 		float _zOrigin;
@@ -67,9 +92,39 @@ namespace SteerLib {
 		/// The internal pointer to all SpatialDatabaseItem pointers, used so that all database data remains contiguous for better data locality; this is the pointer to de-allocate instead of each grid cell's pointer separately.
 		SpatialDatabaseItemPtr *  _basePtr;
 
-		/// A 2-D array of grid cells, but organized in a 1-D array.
+		/// A 2-D array of grid cells, but organized in a 1-D array; this is the agent layer.
 		GridCell* _cells;
 
+		/// @name The obstacle layer
+		/// @brief All non-agent items, packed by cell into one array at the layer's own resolution.
+		///
+		/// The items of cell c are _obstacleCellItems[_obstacleCellStart[c]] up to _obstacleCellItems[_obstacleCellStart[c+1]], in the
+		/// order they were added to the database.  The arrays are never changed in place: adding or removing an obstacle only changes
+		/// _obstacles and marks the layer dirty, and the next query that needs the layer rebuilds it from scratch.
+		//@{
+		/// An obstacle and the index ranges of the cells it overlaps.
+		struct Obstacle {
+			SpatialDatabaseItemPtr item;
+			float traversalCost;
+			unsigned int xMinIndex, xMaxIndex, zMinIndex, zMaxIndex;
+			unsigned int xMinObstacleIndex, xMaxObstacleIndex, zMinObstacleIndex, zMaxObstacleIndex;
+		};
+		std::vector<Obstacle> _obstacles;
+		float _xObstacleCellSize;
+		float _zObstacleCellSize;
+		unsigned int _xNumObstacleCells;
+		unsigned int _zNumObstacleCells;
+		std::vector<unsigned int> _obstacleCellStart;
+		std::vector<SpatialDatabaseItemPtr> _obstacleCellItems;
+		/// True if _obstacles changed since the layer was last built.
+		std::atomic<bool> _obstacleLayerDirty;
+		/// Lets only one thread rebuild the layer.
+		std::mutex _obstacleLayerLock;
+		//@}
+
+		/// The random number generator used by randomPositionInRegionWithoutCollisions() when the caller does not provide one; each database has its own, so that several engines can use their databases concurrently.
+		MTRand * _randomNumberGenerator;
+
 		/// The state space interface used by the planner to plan paths through the database.
 		// GridDatabasePlanningDomain * _planningDomain;
 	};
@@ -24,8 +24,10 @@
 
 namespace SteerLib {
 
-	// forward declaration
+	// forward declarations
 	class STEERLIB_API EngineInterface;
+	class STEERLIB_API CheckpointWriter;
+	class STEERLIB_API CheckpointReader;
 
 
 	/**
@@ -52,6 +54,7 @@ namespace SteerLib {
 	class STEERLIB_API AgentInterface : public SteerLib::SpatialDatabaseItem
 	{
 	public:
+		AgentInterface() : SpatialDatabaseItem(SPATIAL_DATABASE_ITEM_AGENT) { }
 		virtual ~AgentInterface() { }
 		/// @name Core functionality
 		//@{
@@ -124,6 +127,20 @@ namespace SteerLib {
 		virtual void setParameters(SteerLib::Behaviour behave) = 0;
 		//@}
 
+		/// @name Checkpoints
+		/// @brief Used by SimulationEngine::saveCheckpoint() and SimulationEngine::restoreCheckpoint().
+		///
+		/// The default implementations save the state declared in AgentInterface (position, velocity, goals, waypoints, paths, ...)
+		/// and keep the spatial database up to date with the restored position.  Of the recorded trajectory, only its length is
+		/// saved: restoring cuts off the positions recorded after the checkpoint, but does not copy the trajectory of a forked agent.  Agents that keep more state of their own
+		/// should override both functions, call the AgentInterface version first, and then write or read their own state in the
+		/// same order.  Parameters set up by reset() or setParameters() are configuration, not state, and should not be saved, so
+		/// that a checkpoint can be restored into an engine whose modules use different parameters.
+		//@{
+		virtual void saveState(SteerLib::CheckpointWriter & out);
+		virtual void restoreState(SteerLib::CheckpointReader & in);
+		//@}
+
 		/*
 		 * Is a1 closer to me than a2
 		 */
@@ -190,6 +207,8 @@ namespace SteerLib {
 	protected:
 		virtual void updateLocalTarget();
 		virtual void updateLocalTarget2();
+		/// Appends a position to the trajectory of this agent: to the engine's trajectory sink if it is open, otherwise to _positionList.
+		void _recordPosition(SteerLib::EngineInterface * engineInfo, float time, const Util::Point & position);
 		bool _enabled;
 		Util::Point _position;
 		std::vector<std::pair<float, Util::Point>> _positionList;
@@ -228,6 +247,12 @@ namespace SteerLib {
 	};
 
 
+	/// Returns the item as an agent, or NULL if it is not one; unlike a dynamic_cast, this only compares the type tag of the item.
+	inline AgentInterface * asAgent(SpatialDatabaseItemPtr item)
+	{
+		return ((item != NULL) && (item->getSpatialDatabaseItemType() == SPATIAL_DATABASE_ITEM_AGENT)) ? static_cast<AgentInterface*>(item) : NULL;
+	}
+
 	inline std::ostream &operator<<(std::ostream &out, const AgentInterface &a)
 	{ // methods used here must be const
 		out << "agent# " << a.id() << " at " << a.position() <<
@@ -22,6 +22,10 @@
 #include "simulation/Clock.h"
 #include "simulation/Camera.h"
 #include "simulation/SimulationOptions.h"
+#include "simulation/NeighborListService.h"
+#include "simulation/ObstacleDistanceField.h"
+#include "simulation/VisibilityCache.h"
+#include "simulation/TrajectorySink.h"
 
 namespace SteerLib {
 
@@ -107,6 +111,14 @@ namespace SteerLib {
 		virtual const SimulationOptions & getOptions() = 0;
 		// Get the current static triangle geometry of the Engine
 		virtual std::pair<std::vector<Util::Point>,std::vector<size_t> > getStaticGeometry() = 0;
+		/// Returns the neighbor lists that the engine maintains for all agents; see SteerLib::NeighborListService.
+		virtual SteerLib::NeighborListService * getNeighborListService() = 0;
+		/// Returns the signed distance field of the obstacles that the engine maintains; see SteerLib::ObstacleDistanceField.
+		virtual SteerLib::ObstacleDistanceField * getObstacleDistanceField() = 0;
+		/// Returns the cached line of sight to fixed targets that the engine maintains; see SteerLib::VisibilityCache.
+		virtual SteerLib::VisibilityCache * getVisibilityCache() = 0;
+		/// Returns the sink that streams agent trajectories to the trajectoryFile engine option; see SteerLib::TrajectorySink.
+		virtual SteerLib::TrajectorySink * getTrajectorySink() = 0;
 		/// Returns the # of frames simulated so far
 		virtual int getNumFramesSimulated() = 0;
 		//@}
@@ -130,6 +130,14 @@ namespace SteerLib {
 		/// Uses OpenGL to draw any module-specific information to the screen; <b>WARNING:</b> this may be called multiple times per simulation step.
 		virtual void draw() { }
 		//@}
+
+		/// @name Checkpoints
+		/// @brief Called by SimulationEngine::saveCheckpoint() and SimulationEngine::restoreCheckpoint(), after all agents were saved or restored.
+		/// Modules that keep per-simulation state which influences later frames should write it here, and read it back in the same order.
+		//@{
+		virtual void saveState(SteerLib::CheckpointWriter & out) { }
+		virtual void restoreState(SteerLib::CheckpointReader & in) { }
+		//@}
 	};
 
 } // end namespace SteerLib
@@ -21,7 +21,7 @@ namespace SteerLib {
 	 */
 	class STEERLIB_API ObstacleInterface : public SteerLib::SpatialDatabaseItem {
 	public:
-		ObstacleInterface() : nextObstacle_(NULL), prevObstacle_(NULL), id_(0), isConvex_(false) {}
+		ObstacleInterface() : SpatialDatabaseItem(SPATIAL_DATABASE_ITEM_OBSTACLE), nextObstacle_(NULL), prevObstacle_(NULL), id_(0), isConvex_(false) {}
 		virtual ~ObstacleInterface() { }
 		virtual void init() { }
 		virtual void update(float timeStamp, float dt, unsigned int frameNumber) { }
@@ -52,6 +52,12 @@ namespace SteerLib {
 		//@}
 	};
 
+	/// Returns the item as an obstacle, or NULL if it is not one; unlike a dynamic_cast, this only compares the type tag of the item.
+	inline ObstacleInterface * asObstacle(SpatialDatabaseItemPtr item)
+	{
+		return ((item != NULL) && (item->getSpatialDatabaseItemType() == SPATIAL_DATABASE_ITEM_OBSTACLE)) ? static_cast<ObstacleInterface*>(item) : NULL;
+	}
+
 } // end namespace SteerLib
 
 #endif
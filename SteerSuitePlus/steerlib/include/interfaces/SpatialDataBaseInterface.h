@@ -25,6 +25,10 @@ class MTRand;
 
 namespace SteerLib {
 
+	// forward declarations
+	class AgentInterface;
+	class ObstacleInterface;
+
 	/**
 	 * @brief The basic interface for a benchmark technique
 	 *
@@ -103,6 +107,12 @@ namespace SteerLib {
 		virtual void getItemsInRange(std::set<SpatialDatabaseItemPtr> & neighborList, float xmin, float xmax, float zmin, float zmax, SpatialDatabaseItemPtr exclude) = 0;
 		/// Returns an STL set of objects found in the specified range of GridCells.
 		virtual void getItemsInRange(std::set<SpatialDatabaseItemPtr> & neighborList, unsigned int xMinIndex, unsigned int xMaxIndex, unsigned int zMinIndex, unsigned int zMaxIndex, SpatialDatabaseItemPtr exclude) = 0;
+		/// Clears neighborList and fills it with the objects found in the specified spatial range, sorted by address and without duplicates (the same order as the STL set version).  Re-using the same vector avoids allocating on every query.
+		virtual void getItemsInRange(std::vector<SpatialDatabaseItemPtr> & neighborList, float xmin, float xmax, float zmin, float zmax, SpatialDatabaseItemPtr exclude) = 0;
+		/// Clears neighborList and fills it with the agents found in the specified spatial range, sorted by address and without duplicates.  The default filters the vector version of getItemsInRange() with SteerLib::asAgent(); databases that keep agents apart should override it.
+		virtual void getAgentsInRange(std::vector<AgentInterface*> & neighborList, float xmin, float xmax, float zmin, float zmax, SpatialDatabaseItemPtr exclude);
+		/// Clears neighborList and fills it with the obstacles found in the specified spatial range, sorted by address and without duplicates.  The default filters the vector version of getItemsInRange() with SteerLib::asObstacle().
+		virtual void getObstaclesInRange(std::vector<ObstacleInterface*> & neighborList, float xmin, float xmax, float zmin, float zmax, SpatialDatabaseItemPtr exclude);
 		/**
 		 * \brief   Computes the agent neighbors of the specified agent.
 		 * \param   agent    A pointer to the agent for which agent neighbors are to be computed.
@@ -129,6 +139,30 @@ namespace SteerLib {
 		virtual bool hasLineOfSight(const Util::Ray & r, SpatialDatabaseItemPtr exclude1, SpatialDatabaseItemPtr exclude2) = 0;
 		/// Returns "true" if no intersections were found with objects that might block line of sight. i.e., ignores objects that return blocksLineOfSight()==false.
 		virtual bool hasLineOfSight(const Util::Point & p1, const Util::Point & p2, SpatialDatabaseItemPtr exclude1, SpatialDatabaseItemPtr exclude2) = 0;
+		/// Traces numRays rays as if by trace(); hitObjects[i] receives the nearest item hit by ray i, or NULL, and t[i] its distance; t[i] is not changed if ray i hits nothing.  Returns the number of rays that hit something.  Databases may override this to share work between rays that are close together.
+		virtual unsigned int tracePacket(const Util::Ray * rays, unsigned int numRays, float * t, SpatialDatabaseItemPtr * hitObjects, SpatialDatabaseItemPtr exclude, bool excludeAgents)
+		{
+			unsigned int numHits = 0;
+			for (unsigned int i = 0; i < numRays; i++) {
+				hitObjects[i] = NULL;
+				if (trace(rays[i], t[i], hitObjects[i], exclude, excludeAgents)) {
+					numHits++;
+				}
+			}
+			return numHits;
+		}
+		/// Tests numRays rays as if by hasLineOfSight(); visible[i] receives the result of ray i.  Returns the number of rays with line of sight.
+		virtual unsigned int hasLineOfSightPacket(const Util::Ray * rays, unsigned int numRays, bool * visible, SpatialDatabaseItemPtr exclude1, SpatialDatabaseItemPtr exclude2)
+		{
+			unsigned int numVisible = 0;
+			for (unsigned int i = 0; i < numRays; i++) {
+				visible[i] = hasLineOfSight(rays[i], exclude1, exclude2);
+				if (visible[i]) {
+					numVisible++;
+				}
+			}
+			return numVisible;
+		}
 		//@}
 
 
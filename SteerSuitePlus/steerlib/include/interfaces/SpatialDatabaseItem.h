@@ -15,6 +15,23 @@
 
 namespace SteerLib {
 
+	/// The type tag of a SteerLib::SpatialDatabaseItem, which tells the interface that the item implements.
+	enum SpatialDatabaseItemType {
+		/// Any other item, such as the raw agents and obstacles of a test case.
+		SPATIAL_DATABASE_ITEM_OTHER,
+		/// The item is a SteerLib::AgentInterface.
+		SPATIAL_DATABASE_ITEM_AGENT,
+		/// The item is a SteerLib::ObstacleInterface.
+		SPATIAL_DATABASE_ITEM_OBSTACLE
+	};
+
+	/// The kinds of items that a spatial database query can ask for; agents are the items whose isAgent() returns true, and obstacles are all others.
+	enum SpatialDatabaseItemKinds {
+		SPATIAL_DATABASE_AGENTS = 1,
+		SPATIAL_DATABASE_OBSTACLES = 2,
+		SPATIAL_DATABASE_ALL_ITEMS = SPATIAL_DATABASE_AGENTS | SPATIAL_DATABASE_OBSTACLES
+	};
+
 	/**
 	 * @brief The virtual interface used by objects in the spatial database.
 	 *
@@ -29,11 +46,18 @@ namespace SteerLib {
 	 *  - the SpatialDataBaseInterface spatial database
 	 *  - examples of this virtual interface being used: RawAgentInfo, RawObstacleInfo.
 	 *
+	 * Every item also carries a type tag, set by the constructor of SteerLib::AgentInterface or SteerLib::ObstacleInterface.
+	 * Code that gets items from a query can convert them with SteerLib::asAgent() and SteerLib::asObstacle(), which only
+	 * compare the tag, instead of using a dynamic_cast in its inner loops.
+	 *
 	 */
 	class STEERLIB_API SpatialDatabaseItem {
 	public:
+		SpatialDatabaseItem(SpatialDatabaseItemType itemType = SPATIAL_DATABASE_ITEM_OTHER) : _spatialDatabaseItemType(itemType) {}
 		/// Overriding this default (empty) destructor is optional.
 		virtual ~SpatialDatabaseItem() {}
+		/// Returns the type tag of the item.
+		inline SpatialDatabaseItemType getSpatialDatabaseItemType() const { return _spatialDatabaseItemType; }
 		/// Returns true if the object is an agent, false if not.
 		virtual bool isAgent() = 0;
 		/// Returns true if the object blocks line-of-sight.  Usually agents and invisible boundaries (like a pool or a street) should return false, while larger objects should return true.
@@ -49,6 +73,9 @@ namespace SteerLib {
 		// virtual bool overlaps(const SteerLib::SpatialDatabaseItemPtr item) = 0;
 		/// Returns the amount of penetration that a circle has if it overlaps, or 0.0 if there is no overlap.
 		virtual float computePenetration(const Util::Point & p, float radius) = 0;
+
+	private:
+		SpatialDatabaseItemType _spatialDatabaseItemType;
 	};
 
 	typedef SpatialDatabaseItem* SpatialDatabaseItemPtr;
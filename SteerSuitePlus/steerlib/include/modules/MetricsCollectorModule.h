@@ -10,9 +10,11 @@
 /// @file MetricsCollectorModule.h
 /// @brief Declares the MetricsCollectorModule built-in module.
 
+#include <sstream>
 #include "interfaces/ModuleInterface.h"
 #include "interfaces/EngineInterface.h"
 #include "benchmarking/SimulationMetricsCollector.h"
+#include "util/GenericException.h"
 
 namespace SteerLib {
 
@@ -27,6 +29,16 @@ namespace SteerLib {
 		void init( const SteerLib::OptionDictionary & options, SteerLib::EngineInterface * engineInfo ) {
 			_engine = engineInfo;
 			_simulationMetrics = NULL;
+			_numThreads = 1;
+
+			// parse the options; numThreads is the only option, any others are ignored.
+			SteerLib::OptionDictionary::const_iterator optionIter = options.find("numThreads");
+			if (optionIter != options.end()) {
+				std::istringstream((*optionIter).second) >> _numThreads;
+				if (_numThreads == 0) {
+					throw Util::GenericException("metricsCollector module requires at least one thread, numThreads was " + (*optionIter).second);
+				}
+			}
 		}
 
 		void finish() {
@@ -42,7 +54,7 @@ namespace SteerLib {
 			delete _simulationMetrics;
 
 			// allocate and setup metrics collection
-			_simulationMetrics = new SteerLib::SimulationMetricsCollector( _engine->getAgents() );
+			_simulationMetrics = new SteerLib::SimulationMetricsCollector( _engine->getAgents(), _numThreads );
 
 		}
 
@@ -61,6 +73,8 @@ namespace SteerLib {
 	protected:
 		SteerLib::EngineInterface * _engine;
 		SteerLib::SimulationMetricsCollector * _simulationMetrics;
+		/// Number of threads used to update the per-agent metrics, set by the "numThreads" module option.
+		unsigned int _numThreads;
 	};
 
 } // end namespace SteerLib
@@ -104,6 +104,7 @@ namespace SteerLib
 		double _fixedTimeStep;
 
 		std::vector<SteerLib::BoxObstacle *> _obstacles;
+		std::vector<SteerLib::RecFileAgentInfo> _agentStates;
 		std::string _recFilename;
 
 	};
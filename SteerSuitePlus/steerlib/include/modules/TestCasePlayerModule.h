@@ -13,6 +13,8 @@
 #include "interfaces/ModuleInterface.h"
 #include "interfaces/EngineInterface.h"
 #include "obstacles/BoxObstacle.h"
+#include "testcaseio/TestCaseIO.h"
+#include "testcaseio/TestCaseScaler.h"
 
 namespace SteerLib {
 
@@ -39,6 +41,25 @@ namespace SteerLib {
 
 		std::vector<SteerLib::ObstacleInterface *> _obstacles;
 
+		/// The parsed test case is kept between simulations, and only read again if the test case file changes.
+		SteerLib::TestCaseReader * _testCaseReader;
+		std::string _testCaseReaderPath;
+
+		/// @name Scaling the test case in memory, without writing a new XML test case
+		/// @brief See TestCaseScaler; the scaled test case is kept between simulations along with the parsed one.
+		//@{
+		float _scaleFactor;
+		unsigned int _tilesX;
+		unsigned int _tilesZ;
+		float _tileSpacing;
+		unsigned int _numAgents;
+		SteerLib::TestCaseScaler * _testCaseScaler;
+		//@}
+
+		/// Creates the obstacles, agents and agent emitters of a TestCaseReader or TestCaseScaler.
+		template <typename TestCaseType>
+		void _createTestCaseObjects(const TestCaseType & testCase);
+
 	};
 
 } // end namespace SteerLib
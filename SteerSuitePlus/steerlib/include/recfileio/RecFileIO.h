@@ -25,6 +25,29 @@ namespace SteerLib {
 		DATA_REC,
 		SHADOW_REC
 	};
+
+	/**
+	 * @brief A read-only, zero-copy view of all agent records of a single frame in a rec file.
+	 *
+	 * The view points directly into the memory-mapped rec file, so it is only valid while the
+	 * RecFileReader that returned it remains open.  Consecutive records are #stride bytes apart;
+	 * use operator[] instead of assuming the records are tightly packed.
+	 *
+	 * @see
+	 *  - RecFileReader::getFrameView()
+	 */
+	struct RecFileFrameView {
+		/// Pointer to the record of the first agent in the frame.
+		const RecFileAgentInfo * data;
+		/// Number of agent records in the frame.
+		unsigned int numAgents;
+		/// Distance in bytes between two consecutive agent records.
+		unsigned int stride;
+
+		/// Returns the record of the specified agent; the index is not bounds-checked.
+		inline const RecFileAgentInfo & operator[]( unsigned int agentIndex ) const { return *(const RecFileAgentInfo*)(((const char*)data) + agentIndex*stride); }
+	};
+
 	/** 
 	 * @brief The public interface for reading SteerSuite rec files (recordings of agents steering).
 	 *
@@ -63,6 +86,10 @@ namespace SteerLib {
 	 * change over different frames.  Therefore, the parameter for frame number or time stamp in 
 	 * getObstacleBoundsAtFrame() and getObstacleBoundsAtTime() are not used yet.
 	 *
+	 * Code that needs every agent on a frame (e.g. playback or benchmarking) should use the bulk
+	 * queries getFrameView() and getAllAgentsAtTime() instead of the per-agent queries; they validate
+	 * the frame or time stamp once and avoid a function call per agent per field.
+	 *
 	 * @see 
 	 *  - RecFileWriter to write rec files
 	 *
@@ -174,6 +201,15 @@ namespace SteerLib {
 		/// Returns the obstacle bounds of an obstacle at the specified time stamp.
 		inline Util::AxisAlignedBox getObstacleBoundsAtTime( unsigned int obstacleIndex, float time ) { Util::AxisAlignedBox b; getObstacleBoundsAtTime(obstacleIndex, time, b.xmin, b.xmax, b.ymin, b.ymax, b.zmin, b.zmax); return b; }
 		//@}
+
+		/// @name Bulk agent queries
+		/// @brief These functions read all agents of a frame at once, with a single bounds check.
+		//@{
+		/// Returns a zero-copy view of all agent records at the specified frame number; the view is valid until close() is called.
+		RecFileFrameView getFrameView( unsigned int frameNumber );
+		/// Interpolates all agents at the specified time stamp, writing getNumAgents() records into agentInfo; results match the per-agent "AtTime" queries.
+		void getAllAgentsAtTime( float time, RecFileAgentInfo * agentInfo );
+		//@}
 	};
 
 
@@ -201,6 +201,7 @@ namespace SteerLib {
 		RecFileReaderPrivate() { }
 
 		void _getFramesForTime(float time, unsigned int &frameIndex1, unsigned int &frameIndex2);
+		void _interpolateOrientation(const RecFileVectorData & v1, const RecFileVectorData & v2, double alpha, float &dirx, float &diry, float &dirz);
 
 		std::string _filename;
 		std::string _testCaseName;
@@ -31,6 +31,10 @@ using std::max;
 
 namespace SteerLib {
 
+	// forward declarations
+	class STEERLIB_API CheckpointWriter;
+	class STEERLIB_API CheckpointReader;
+
 	/**
 	 * @brief A clock that maintains real-time and simulation-time separately.
 	 *
@@ -221,6 +225,14 @@ namespace SteerLib {
 		void setClockMode(ClockModeEnum clockMode, float fixedFps, float minSimulationDt, float maxSimulationDt);
 		//@}
 
+		/// @name Checkpoints
+		//@{
+		/// Writes the simulation time and frame number into a checkpoint; the clock mode and real-time counters are not saved.
+		void saveState(SteerLib::CheckpointWriter & out);
+		/// Restores the simulation time and frame number written by saveState().
+		void restoreState(SteerLib::CheckpointReader & in);
+		//@}
+
 	protected:
 		/// @name Protected helper functions
 		//@{
@@ -0,0 +1,116 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+#ifndef __STEERLIB_NEIGHBOR_LIST_SERVICE_H__
+#define __STEERLIB_NEIGHBOR_LIST_SERVICE_H__
+
+/// @file NeighborListService.h
+/// @brief Declares the SteerLib::NeighborListService class, which caches the neighbors of every agent across frames.
+
+#ifdef _WIN32
+// see steerlib/util/DrawLib.h for explanation
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+
+#include <vector>
+#include <map>
+#include "Globals.h"
+#include "util/Geometry.h"
+
+namespace SteerLib {
+
+	class AgentInterface;
+	class ObstacleInterface;
+	class SpatialDataBaseInterface;
+
+	/// The cached neighbors of one agent; both arrays are sorted by address, the same order as a std::set of SpatialDatabaseItemPtr.
+	struct STEERLIB_API NeighborList {
+		/// Other agents that were within range at the last rebuild; an agent may have been disabled since, so check enabled().
+		std::vector<SteerLib::AgentInterface*> agents;
+		/// Obstacles that were within range at the last rebuild.
+		std::vector<SteerLib::ObstacleInterface*> obstacles;
+	};
+
+	/**
+	 * @brief Verlet neighbor lists, shared by all AI modules.
+	 *
+	 * Many steering algorithms ask the spatial database for the items around each agent, often several times per frame.
+	 * Instead, a module can call requestQueryRange() once with the largest range it will ever query (measured from the agent's
+	 * center), and then read getNeighbors() from its agents' updateAI().
+	 *
+	 * The engine calls update() before updating the agents of every frame.  The lists are rebuilt with one spatial database query per
+	 * agent, over the requested range plus a "skin" (the neighborListSkin engine option), and are reused as long as no agent can have
+	 * moved more than half the skin since the rebuild by the end of the frame: two agents that approach each other can then close the
+	 * gap by at most the skin, so the lists still contain every item within the requested range of the agent's position.  Because the
+	 * agents are updated one after another after update(), an agent read from a list may already have taken this frame's step, so
+	 * the largest step of the frame (the largest agent speed times dt) is counted against the half skin.  The lists are also rebuilt
+	 * when agents or obstacles are added, removed, enabled or disabled, and when a larger range is requested.
+	 *
+	 * The lists are a superset of the requested range: callers that need exactly the items overlapping a query box should
+	 * filter them, for example with isAgentInRange() and isObstacleInRange().  A larger skin makes rebuilds rarer but the lists longer.
+	 *
+	 * The service is idle until some module requests a range, so simulations that do not use it pay nothing.
+	 */
+	class STEERLIB_API NeighborListService {
+	public:
+		NeighborListService();
+
+		/// Sets the spatial database used for rebuilds and the skin in meters, and clears all lists.
+		void init(SteerLib::SpatialDataBaseInterface * spatialDatabase, float skin);
+		/// Makes sure that the lists contain every item within range meters of an agent's center; ranges only grow until clear().
+		void requestQueryRange(float range);
+		/// Forces a rebuild at the next update(); the engine calls this whenever agents or obstacles are added or removed.
+		inline void invalidate() { _valid = false; }
+		/// Clears the lists and the requested range; called when a simulation is unloaded.
+		void clear();
+
+		/// Rebuilds the lists of the given agents if needed, before a frame of dt seconds; does nothing if no range was requested.
+		void update(const std::vector<SteerLib::AgentInterface*> & agents, float dt);
+
+		/// Returns true if some module requested a range, i.e., if the lists are maintained.
+		inline bool isActive() const { return _queryRange > 0.0f; }
+		/// Returns the cached neighbors of agent, or NULL if the agent was not enabled at the last rebuild or the service is not active.
+		const NeighborList * getNeighbors(const SteerLib::AgentInterface * agent) const;
+
+		/// Returns true if agent's bounds overlap the given query box; the same criterion as an exact range query.
+		static bool isAgentInRange(SteerLib::AgentInterface * agent, float xmin, float xmax, float zmin, float zmax);
+		/// Returns true if obstacle's bounds overlap the given query box.
+		static bool isObstacleInRange(SteerLib::ObstacleInterface * obstacle, float xmin, float xmax, float zmin, float zmax);
+
+		/// @name Statistics
+		//@{
+		inline float getQueryRange() const { return _queryRange; }
+		inline float getSkin() const { return _skin; }
+		inline unsigned int getNumRebuilds() const { return _numRebuilds; }
+		//@}
+
+	protected:
+		/// Returns true if the lists must be rebuilt for these agents, which are about to move for dt seconds.
+		bool _needsRebuild(const std::vector<SteerLib::AgentInterface*> & agents, float dt) const;
+		void _rebuild(const std::vector<SteerLib::AgentInterface*> & agents);
+
+		SteerLib::SpatialDataBaseInterface * _spatialDatabase;
+		float _skin;
+		float _queryRange;
+		bool _valid;
+		unsigned int _numRebuilds;
+
+		/// The enabled agents at the last rebuild, their positions at that time, and their lists, all in the same order.
+		std::vector<SteerLib::AgentInterface*> _listedAgents;
+		std::vector<Util::Point> _positionsAtRebuild;
+		std::vector<NeighborList> _lists;
+		/// Maps each listed agent to its index in _lists.
+		std::map<const SteerLib::AgentInterface*, unsigned int> _listIndices;
+	};
+
+} // end namespace SteerLib
+
+#ifdef _WIN32
+#pragma warning( pop )
+#endif
+
+#endif
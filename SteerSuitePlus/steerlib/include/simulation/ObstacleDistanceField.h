@@ -0,0 +1,125 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+#ifndef __STEERLIB_OBSTACLE_DISTANCE_FIELD_H__
+#define __STEERLIB_OBSTACLE_DISTANCE_FIELD_H__
+
+/// @file ObstacleDistanceField.h
+/// @brief Declares the SteerLib::ObstacleDistanceField class, a precomputed signed distance field of the static obstacles.
+
+#ifdef _WIN32
+// see steerlib/util/DrawLib.h for explanation
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+
+#include <vector>
+#include <set>
+#include "Globals.h"
+#include "util/Geometry.h"
+
+namespace SteerLib {
+
+	class ObstacleInterface;
+
+	/**
+	 * @brief A signed distance field of the obstacles on the ground plane, with its gradient.
+	 *
+	 * The field stores, at the corners of a regular grid of cells, the signed distance to the nearest obstacle (negative inside
+	 * an obstacle) and the direction in which that distance grows, i.e., the outward normal of the nearest obstacle surface.
+	 * getDistance() and getDistanceAndNormal() interpolate them bilinearly, so a query costs the same no matter how many obstacles
+	 * are nearby.  Distances are clamped to the requested maximum distance; beyond it, and outside the area covered by the field,
+	 * getDistance() returns that maximum and a zero normal.
+	 *
+	 * Like SteerLib::NeighborListService, the field is idle until some module calls requestMaxDistance(), usually when its agents
+	 * are reset.  The engine then builds it at the end of preprocessSimulation(), covering the bounds of all obstacles plus the
+	 * maximum distance, with the cell size given by the distanceFieldCellSize engine option.  When obstacles are added or removed,
+	 * only the samples within the maximum distance of them are recomputed, before the agents of the next frame are updated.
+	 *
+	 * Boxes, oriented boxes, walls and polygons are measured against the outline returned by get2DStaticGeometry(); circles are
+	 * measured exactly.  Near convex corners, the interpolated distance can be smaller than the exact distance by up to about
+	 * half a cell.
+	 */
+	class STEERLIB_API ObstacleDistanceField {
+	public:
+		ObstacleDistanceField();
+
+		/// Sets the cell size in meters and clears the field.
+		void init(float cellSize);
+		/// Makes sure that distances up to maxDistance meters are stored; the maximum only grows until clear().
+		void requestMaxDistance(float maxDistance);
+		/// Clears the field and the requested distance; called when a simulation is unloaded.
+		void clear();
+
+		/// @name Notifications from the engine
+		//@{
+		void obstacleAdded(SteerLib::ObstacleInterface * obstacle);
+		void obstacleRemoved(SteerLib::ObstacleInterface * obstacle);
+		inline void invalidate() { _built = false; }
+		//@}
+
+		/// Builds the field, or recomputes the parts changed by added or removed obstacles; does nothing if no distance was requested.
+		void update(const std::set<SteerLib::ObstacleInterface*> & obstacles);
+
+		/// Returns true if some module requested a distance, i.e., if the field is maintained.
+		inline bool isActive() const { return _maxDistance > 0.0f; }
+		/// Returns the signed distance from p to the nearest obstacle, clamped to the maximum distance.
+		float getDistance(const Util::Point & p) const;
+		/// Returns the signed distance from p to the nearest obstacle, and the unit outward normal of that obstacle in normal.
+		float getDistanceAndNormal(const Util::Point & p, Util::Vector & normal) const;
+		/// Returns true if a circle of the given radius at p does not overlap any obstacle.
+		inline bool hasClearance(const Util::Point & p, float radius) const { return getDistance(p) >= radius; }
+
+		/// @name Statistics
+		//@{
+		inline float getCellSize() const { return _cellSize; }
+		inline float getMaxDistance() const { return _maxDistance; }
+		inline unsigned int getNumSamplesX() const { return _numSamplesX; }
+		inline unsigned int getNumSamplesZ() const { return _numSamplesZ; }
+		//@}
+
+	protected:
+		/// One corner of the grid: the distance, and the x and z components of its gradient.
+		struct Sample {
+			float distance;
+			float normalX;
+			float normalZ;
+		};
+
+		/// Returns the bounds of an obstacle on the ground plane, grown by the maximum distance.
+		Util::AxisAlignedBox _getInfluenceBounds(SteerLib::ObstacleInterface * obstacle) const;
+		/// Allocates the field to cover all obstacles, and computes every sample.
+		void _build(const std::set<SteerLib::ObstacleInterface*> & obstacles);
+		/// Recomputes the samples inside region from all obstacles.
+		void _recompute(const std::set<SteerLib::ObstacleInterface*> & obstacles, const Util::AxisAlignedBox & region);
+		/// Lowers the samples with indices [ixmin, ixmax] x [izmin, izmax] to the signed distance of one obstacle, where it is closer.
+		void _splatObstacle(SteerLib::ObstacleInterface * obstacle, int ixmin, int ixmax, int izmin, int izmax);
+		/// Clamps the sample indices covered by box to the field; returns false if box does not overlap the field.
+		bool _getSampleRange(const Util::AxisAlignedBox & box, int & ixmin, int & ixmax, int & izmin, int & izmax) const;
+
+		float _cellSize;
+		float _maxDistance;
+		bool _built;
+
+		/// The changed obstacles since the field was last updated, as influence bounds; empty if there were none.
+		Util::AxisAlignedBox _dirtyRegion;
+		bool _hasDirtyRegion;
+
+		/// The position of sample (0,0), and the samples in row-major order along x.
+		float _originX;
+		float _originZ;
+		unsigned int _numSamplesX;
+		unsigned int _numSamplesZ;
+		std::vector<Sample> _samples;
+	};
+
+} // end namespace SteerLib
+
+#ifdef _WIN32
+#pragma warning( pop )
+#endif
+
+#endif
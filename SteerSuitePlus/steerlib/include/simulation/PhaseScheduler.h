@@ -0,0 +1,126 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+#ifndef __STEERLIB_PHASE_SCHEDULER_H__
+#define __STEERLIB_PHASE_SCHEDULER_H__
+
+/// @file PhaseScheduler.h
+/// @brief Declares the SteerLib::PhaseScheduler class, which staggers the periodic phases of many agents across frames.
+
+#ifdef _WIN32
+// see steerlib/util/DrawLib.h for explanation
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+
+#include <vector>
+#include <iostream>
+#include <string>
+#include "Globals.h"
+
+namespace SteerLib {
+
+	class CheckpointWriter;
+	class CheckpointReader;
+
+	/**
+	 * @brief Spreads the periodic phases of many agents evenly across frames, and counts how many run on each frame.
+	 *
+	 * Agents such as those of pprAI run each of their phases every N frames, counted from the last time the phase ran.  If all
+	 * agents start on the same frame, a phase with N > 1 runs for all of them on the same frames and for none in between, which
+	 * makes the frame time spike.  Instead, each agent registers as a client with addClient(), which gives it an offset in
+	 * [0, N) for every phase: the slot that the fewest clients use so far.  After running a phase on some frame, the agent asks
+	 * getNextFrame() for the next frame of its slot, so every slot runs on one frame out of N, and each frame runs the phase for
+	 * about 1/N of the clients.  Phases with N = 1 run every frame, as before.
+	 *
+	 * When a client is removed, for example because its agent reached its goal, one client of the fullest slot of each phase moves
+	 * to the emptiest slot if they differ by more than one, so the load stays flat while agents come and go.  A moved client
+	 * follows its new slot from the next time it runs the phase.
+	 *
+	 * The schedule depends only on the order of the calls, never on timings, so simulations remain deterministic.  Every agent
+	 * still runs all its phases on its first frame, since later phases depend on the results of earlier ones.
+	 *
+	 * countPhase() records every run of a phase, whether it was staggered or not; the per-frame counts can be read back with
+	 * getPhaseCount(), and summarized with printStatistics().
+	 */
+	class STEERLIB_API PhaseScheduler {
+	public:
+		PhaseScheduler();
+
+		/// Sets the number of phases, sets every interval to 1, and forgets all clients and counts.
+		void init(unsigned int numPhases);
+		/// Sets the interval of a phase in frames; must be called before any client is added.
+		void setInterval(unsigned int phase, unsigned int interval);
+		/// Forgets all clients and counts, but keeps the intervals; called when a simulation starts.
+		void clear();
+
+		/// @name Clients
+		//@{
+		/// Registers a new client and gives it the least used slot of every phase; returns its id.
+		unsigned int addClient();
+		/// Releases the slots of a client, and moves other clients to keep the slots balanced.
+		void removeClient(unsigned int client);
+		/// Returns the slot of a client for a phase, in [0, interval).
+		unsigned int getOffset(unsigned int client, unsigned int phase) const;
+		/// Returns the first frame after lastFrame on which the client should run the phase.
+		unsigned int getNextFrame(unsigned int client, unsigned int phase, unsigned int lastFrame) const;
+		//@}
+
+		/// @name Per-frame counts
+		//@{
+		/// Records that some agent ran the phase on the given frame.
+		void countPhase(unsigned int phase, unsigned int frame);
+		/// Returns how many times the phase ran on the given frame.
+		unsigned int getPhaseCount(unsigned int frame, unsigned int phase) const;
+		/// Returns the number of frames with counts, i.e., one more than the last frame on which a phase ran.
+		inline unsigned int getNumFramesCounted() const { return (_numPhases == 0) ? 0 : (unsigned int)(_phaseCounts.size() / _numPhases); }
+		/// Returns the largest number of times the phase ran on one frame, from firstFrame on.
+		unsigned int getMaxPhaseCount(unsigned int phase, unsigned int firstFrame = 0) const;
+		/// Returns the average number of times the phase ran per frame, from firstFrame on.
+		float getAveragePhaseCount(unsigned int phase, unsigned int firstFrame = 0) const;
+		/// Prints the interval of every phase, its count on frame 0, and its maximum and average count per frame after that; names
+		/// must have one entry per phase.  Frame 0 is shown apart because every agent runs all its phases on its first frame.
+		void printStatistics(std::ostream & out, const std::string * names) const;
+		//@}
+
+		/// @name Checkpoints
+		//@{
+		void saveState(SteerLib::CheckpointWriter & out);
+		void restoreState(SteerLib::CheckpointReader & in);
+		//@}
+
+		inline unsigned int getNumPhases() const { return _numPhases; }
+		inline unsigned int getInterval(unsigned int phase) const { return _intervals[phase]; }
+		inline unsigned int getNumClients() const { return _numClients; }
+
+	protected:
+		/// Returns the least used slot of a phase; ties go to the lowest slot, to keep the schedule deterministic.
+		unsigned int _getLeastUsedSlot(unsigned int phase) const;
+		/// Moves one client from the most used to the least used slot of a phase, if they differ by more than one.
+		void _rebalance(unsigned int phase);
+
+		unsigned int _numPhases;
+		/// The interval of each phase in frames.
+		std::vector<unsigned int> _intervals;
+		/// For each phase, the number of clients in each of its slots.
+		std::vector< std::vector<unsigned int> > _slotLoads;
+		/// The slot of each client for each phase, indexed by client * _numPhases + phase.
+		std::vector<unsigned int> _offsets;
+		/// Whether each client is still registered.
+		std::vector<unsigned char> _active;
+		unsigned int _numClients;
+
+		/// The number of runs of each phase, indexed by frame * _numPhases + phase.
+		std::vector<unsigned int> _phaseCounts;
+	};
+
+} // end namespace SteerLib
+
+#ifdef _WIN32
+#pragma warning( pop )
+#endif
+
+#endif
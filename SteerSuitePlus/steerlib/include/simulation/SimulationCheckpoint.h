@@ -0,0 +1,189 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+#ifndef __STEERLIB_SIMULATION_CHECKPOINT_H__
+#define __STEERLIB_SIMULATION_CHECKPOINT_H__
+
+/// @file SimulationCheckpoint.h
+/// @brief Declares the SteerLib::SimulationCheckpoint class and the helpers that write and read it.
+
+#include <vector>
+#include <map>
+#include <string>
+#include <cstring>
+#include "Globals.h"
+#include "testcaseio/AgentInitialConditions.h"
+#include "util/GenericException.h"
+
+#ifdef _WIN32
+// on win32, there is an unfortunate conflict between exporting symbols for a
+// dynamic/shared library and STL code.  A good document describing the problem
+// in detail is http://www.unknownroad.com/rtfm/VisualStudio/warningC4251.html
+// the "least evil" solution is just to simply ignore this warning.
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+
+namespace SteerLib {
+
+	// forward declaration
+	class STEERLIB_API AgentInterface;
+
+	/// The "magic number" placed at the beginning of every checkpoint written by SimulationEngine::saveCheckpoint().
+	const unsigned int CHECKPOINT_MAGIC_NUMBER = 0x5c4b9e17;
+	/// The version of the checkpoint layout; must be changed whenever the data written by the engine, agents, or modules changes.
+	const unsigned int CHECKPOINT_VERSION = 2;
+
+	/**
+	 * @brief A compact binary snapshot of a running simulation.
+	 *
+	 * A checkpoint is created by SimulationEngine::saveCheckpoint() and holds everything that changes while a simulation
+	 * runs: the simulation clock, the state of every agent, the agents that were spawned by emitters or from the wait list,
+	 * and any state that modules choose to save.  Data that does not change during a simulation, such as obstacles, the
+	 * planning domain (including navigation meshes), and the emitters of the test case, is <b>not</b> copied; the checkpoint
+	 * only records enough about it to verify that the engine it is restored into refers to the same data.  The trajectories
+	 * recorded by agents are not copied either, since they grow with every frame; only their lengths are, so that a rewind can
+	 * drop what was recorded after the checkpoint.
+	 *
+	 * Once written, a checkpoint is never modified by the engine, so one checkpoint can be restored any number of times, into
+	 * the engine that created it (to rewind) or into other engines that loaded the same modules and test case (to fork).
+	 *
+	 * Agents and modules write their own data with a CheckpointWriter and read it back with a CheckpointReader.
+	 *
+	 * @see
+	 *   - SimulationEngine::saveCheckpoint() and SimulationEngine::restoreCheckpoint()
+	 *   - AgentInterface::saveState() and AgentInterface::restoreState()
+	 *   - ModuleInterface::saveState() and ModuleInterface::restoreState()
+	 */
+	class STEERLIB_API SimulationCheckpoint {
+	public:
+		SimulationCheckpoint() { }
+
+		/// Discards the contents of the checkpoint.
+		void clear() { _data.clear(); }
+		/// Returns true if nothing was written into the checkpoint.
+		bool empty() const { return _data.empty(); }
+		/// Returns the size of the checkpoint in bytes.
+		size_t size() const { return _data.size(); }
+		/// Returns the raw bytes of the checkpoint.
+		const char * data() const { return _data.empty() ? NULL : &(_data[0]); }
+
+		/// Writes the raw bytes of the checkpoint into a file.
+		void writeToFile(const std::string & filename) const;
+		/// Replaces the contents of the checkpoint with the raw bytes of a file written by writeToFile().
+		void readFromFile(const std::string & filename);
+
+	protected:
+		std::vector<char> _data;
+
+		friend class CheckpointWriter;
+		friend class CheckpointReader;
+	};
+
+
+	/**
+	 * @brief Appends data to a SimulationCheckpoint.
+	 *
+	 * Plain data (numbers, enums, Util::Point, Util::Vector, Util::Color, and other structs without pointers) is
+	 * written with write() and writeSequence().  Pointers to other agents must be written with writeAgentReference(),
+	 * which stores the index of the agent in the engine instead of its address.
+	 *
+	 * Sections group the data of one agent or one module; the reader uses them to verify that exactly the same
+	 * amount of data is read back as was written.
+	 */
+	class STEERLIB_API CheckpointWriter {
+	public:
+		/// Appends to checkpoint; agents are the engine's agents, used to turn agent pointers into indices.
+		CheckpointWriter(SimulationCheckpoint & checkpoint, const std::vector<SteerLib::AgentInterface*> & agents);
+
+		/// Writes a value of plain data type.
+		template <typename T>
+		void write(const T & value) {
+			const char * bytes = reinterpret_cast<const char *>(&value);
+			_data.insert(_data.end(), bytes, bytes + sizeof(T));
+		}
+		/// Writes the number of elements of an STL container of plain data, followed by the elements.
+		template <typename ContainerType>
+		void writeSequence(const ContainerType & container) {
+			write<unsigned int>((unsigned int)container.size());
+			for (typename ContainerType::const_iterator iter = container.begin(); iter != container.end(); ++iter) {
+				write(*iter);
+			}
+		}
+		void writeString(const std::string & value);
+		void writeGoal(const SteerLib::AgentGoalInfo & goal);
+		void writeInitialConditions(const SteerLib::AgentInitialConditions & initialConditions);
+		/// Writes a reference to an agent known to the engine; agent may be NULL.
+		void writeAgentReference(const SteerLib::AgentInterface * agent);
+
+		/// Begins a section; the returned value must be given to endSection().
+		size_t beginSection();
+		void endSection(size_t section);
+
+	protected:
+		std::vector<char> & _data;
+		std::map<const SteerLib::AgentInterface*, unsigned int> _agentIndices;
+	};
+
+
+	/**
+	 * @brief Reads data from a SimulationCheckpoint in the same order it was written by a CheckpointWriter.
+	 *
+	 * All functions throw a Util::GenericException if the checkpoint does not contain enough data.
+	 */
+	class STEERLIB_API CheckpointReader {
+	public:
+		/// Reads from checkpoint; agents are the engine's agents, used to turn indices back into agent pointers.
+		CheckpointReader(const SimulationCheckpoint & checkpoint, const std::vector<SteerLib::AgentInterface*> & agents);
+
+		/// Reads a value of plain data type.
+		template <typename T>
+		void read(T & value) {
+			_require(sizeof(T));
+			memcpy(&value, _data + _position, sizeof(T));
+			_position += sizeof(T);
+		}
+		template <typename T>
+		T read() { T value; read(value); return value; }
+		/// Replaces the contents of an STL container of plain data with the elements written by CheckpointWriter::writeSequence().
+		template <typename ContainerType>
+		void readSequence(ContainerType & container) {
+			unsigned int count = read<unsigned int>();
+			container.clear();
+			for (unsigned int i = 0; i < count; i++) {
+				container.push_back(read<typename ContainerType::value_type>());
+			}
+		}
+		std::string readString();
+		void readGoal(SteerLib::AgentGoalInfo & goal);
+		void readInitialConditions(SteerLib::AgentInitialConditions & initialConditions);
+		SteerLib::AgentInterface * readAgentReference();
+
+		/// Begins a section written by CheckpointWriter::beginSection(); the returned value must be given to endSection().
+		size_t beginSection();
+		/// Throws an exception if the data read since beginSection() was not exactly the data of the section.
+		void endSection(size_t section);
+
+		/// Returns true if all data of the checkpoint was read.
+		bool atEnd() const { return _position == _size; }
+
+	protected:
+		void _require(size_t numBytes) {
+			if (numBytes > _size - _position) throw Util::GenericException("Simulation checkpoint is truncated or was not written by this version of SteerLib.");
+		}
+		const char * _data;
+		size_t _size;
+		size_t _position;
+		const std::vector<SteerLib::AgentInterface*> & _agents;
+	};
+
+} // end namespace SteerLib
+
+#ifdef _WIN32
+#pragma warning( pop )
+#endif
+
+#endif
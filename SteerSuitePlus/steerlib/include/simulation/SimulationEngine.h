@@ -17,6 +17,7 @@
 #include "interfaces/EngineInterface.h"
 #include "util/StateMachine.h"
 #include "testcaseio/TestCaseIO.h"
+#include "simulation/SimulationCheckpoint.h"
 
 #define KEY_PRESSED 1
 
@@ -88,6 +89,10 @@ namespace SteerLib {
 	 *   - When a simulation is "paused", then update(true) will still update the real-time clock and camera.
 	 *     This way, the engine can still update camera movements and possibly other real-time aspects that
 	 *     may arise in the future.  In this case, the simulation clock and modules will not be updated.
+	 *   - saveCheckpoint() writes the state of a running simulation into a SteerLib::SimulationCheckpoint, and restoreCheckpoint()
+	 *     continues the simulation from that state.  To fork a simulation, initialize a second engine with the same options,
+	 *     call initializeSimulation() and preprocessSimulation() on it, and then restore the checkpoint into it.  Obstacles,
+	 *     the planning domain and the emitters of the test case are never copied; each engine keeps its own.
 	 *
 	 * @see
 	 *   - SteerLib::EngineInterface is the virtual interface that is given to modules
@@ -160,6 +165,14 @@ namespace SteerLib {
 		/// stops execution
 		void stop();
 		//@}
+
+		/// @name Checkpoints
+		//@{
+		/// Writes the state of the running simulation into checkpoint, replacing its contents; can be called between any two calls to update().
+		void saveCheckpoint(SteerLib::SimulationCheckpoint & checkpoint);
+		/// Returns the running simulation to the state written by saveCheckpoint() of this engine (rewind), or of another engine that loaded the same modules and test case (fork).
+		void restoreCheckpoint(const SteerLib::SimulationCheckpoint & checkpoint);
+		//@}
 	#ifdef ENABLE_GUI
 		/// Handles keyboard and mouse input by forwarding the keyboard event to all modules.
 		void processKeyboardInput(int key, int action);
@@ -194,6 +207,10 @@ namespace SteerLib {
 		virtual const OptionDictionary & getModuleOptions(const std::string & moduleName) { return _options->getModuleOptions(moduleName); }
 		virtual const SimulationOptions & getOptions() { return (*_options); }
 		virtual std::pair<std::vector<Util::Point>,std::vector<size_t> > getStaticGeometry();
+		virtual SteerLib::NeighborListService * getNeighborListService() { return &_neighborLists; }
+		virtual SteerLib::ObstacleDistanceField * getObstacleDistanceField() { return &_distanceField; }
+		virtual SteerLib::VisibilityCache * getVisibilityCache() { return &_visibilityCache; }
+		virtual SteerLib::TrajectorySink * getTrajectorySink() { return &_trajectorySink; }
 		virtual std::vector<SteerLib::AgentInitialConditions> getAgentInitialConditions() { return _agentInitialConditions; }
 		virtual int getNumFramesSimulated() { return _numFramesSimulated;  }
 
@@ -208,6 +225,8 @@ namespace SteerLib {
 
 		virtual void loadModule(const std::string & moduleName, const std::string & searchPath, const std::string & options);
 		virtual void unloadModule(SteerLib::ModuleInterface * moduleToDestroy, bool recursivelyUnloadDependencies );
+		/// Merges new options into an already loaded module and calls its finish() and init() again, without unloading the module or its dependencies.
+		void reinitializeModule(const std::string & moduleName, const std::string & options);
 
 		virtual SteerLib::AgentInterface * createAgent(const SteerLib::AgentInitialConditions & initialConditions, SteerLib::ModuleInterface * owner);
 		virtual SteerLib::AgentInterface * createEmittedAgent(const SteerLib::AgentInitialConditions & initialConditions, SteerLib::ModuleInterface * owner, int emitterNum);
@@ -253,6 +272,14 @@ namespace SteerLib {
 		bool _unloadModule(SteerLib::ModuleInterface * moduleToDestroy, bool recursivelyUnloadDependencies, bool errorIfCannotUnload );
 		/// Helper function to initialize and start the engine state machine that makes sure the engine is always in a valid state.
 		void _setupStateMachine();
+		/// Returns the name of the span that the Util::TraceProfiler records for one phase of a module, e.g. "sfAI::preprocessFrame".
+		const char * _getModuleTraceName(const std::string & moduleName, const char * phase);
+
+		/// The interned names of the spans recorded for each per-frame phase of one module.
+		struct ModuleTraceNames {
+			const char * preprocessFrame;
+			const char * postprocessFrame;
+		};
 
 	#ifdef ENABLE_GUI
 		void _drawEnvironment();
@@ -282,6 +309,8 @@ namespace SteerLib {
 		std::map<SteerLib::ModuleInterface*, SteerLib::ModuleMetaInformation*> _moduleMetaInfoByReference;
 		/// the modules sorted in order of execution (i.e. modules execute after their dependencies.)
 		std::vector<SteerLib::ModuleInterface*> _modulesInExecutionOrder;
+		/// the trace span names of each module in _modulesInExecutionOrder, at the same index; interned when the module is loaded.
+		std::vector<ModuleTraceNames> _moduleTraceNamesInExecutionOrder;
 		/// maps the name of a conflicting module to the module that declared it a conflict.
 		std::multimap<std::string, std::string> _moduleConflicts;
 		//@}
@@ -296,6 +325,11 @@ namespace SteerLib {
 		std::vector<SteerLib::AgentInitialConditions> _init_agents;
 		std::vector<SteerLib::ModuleInterface*> _agents_ai;
 		std::vector<int> _spawned_agent_emitter_num;
+		/// the number of agents and agent initial conditions after preprocessSimulation(); agents beyond these were spawned while the simulation was running.
+		size_t _numPreprocessedAgents;
+		size_t _numPreprocessedAgentInitialConditions;
+		/// the initial conditions that each agent spawned while the simulation was running was reset with, in the order of _agents.
+		std::vector<SteerLib::AgentInitialConditions> _spawnedAgentConditions;
 		//@}
 
 		/// @name Other objects managed by the engine
@@ -306,6 +340,10 @@ namespace SteerLib {
 		SteerLib::SpatialDataBaseInterface * _spatialDatabase;
 		SteerLib::PlanningDomainInterface * _pathPlanner;
 		std::set<SteerLib::ObstacleInterface*> _obstacles;
+		SteerLib::NeighborListService _neighborLists;
+		SteerLib::ObstacleDistanceField _distanceField;
+		SteerLib::VisibilityCache _visibilityCache;
+		SteerLib::TrajectorySink _trajectorySink;
 		SteerLib::EngineControllerInterface * _engineController;
 		//@}
 
@@ -174,6 +174,8 @@ namespace SteerLib {
 		inline float defaultGridSizeZ() const { return _gridDatabaseDefaults.gridSizeZ; }
 		inline unsigned int defaultNumGridCellsX() const { return _gridDatabaseDefaults.numGridCellsX; }
 		inline unsigned int defaultNumGridCellsZ() const { return _gridDatabaseDefaults.numGridCellsZ; }
+		inline unsigned int defaultNumObstacleCellsX() const { return _gridDatabaseDefaults.numObstacleCellsX; }
+		inline unsigned int defaultNumObstacleCellsZ() const { return _gridDatabaseDefaults.numObstacleCellsZ; }
 		//@}
 
 		/// @name GUI options accessors
@@ -255,8 +257,16 @@ namespace SteerLib {
 			std::string moduleSearchPath;
 			std::string testCaseSearchPath;
 			std::string frameDumpDirectory;
+			/// If not empty, the Util::TraceProfiler records the simulation and writes a Chrome trace to this file when the engine finishes.
+			std::string traceFilename;
+			/// If not empty, agent trajectories are streamed to this file while the simulation runs; see SteerLib::TrajectorySink.
+			std::string trajectoryFilename;
 			std::set<std::string> startupModules;
 			unsigned int numThreads;
+			/// The extra range, in meters, that SteerLib::NeighborListService adds to its lists so that they can be reused for several frames.
+			float neighborListSkin;
+			/// The spacing, in meters, of the samples of SteerLib::ObstacleDistanceField.
+			float distanceFieldCellSize;
 			unsigned int numFramesToSimulate;
 			float fixedFPS;
 			float minVariableDt;
@@ -271,6 +281,9 @@ namespace SteerLib {
 			float gridSizeZ;
 			unsigned int numGridCellsX;
 			unsigned int numGridCellsZ;
+			/// The resolution of the obstacle layer of the grid database; 0 uses the resolution of the agent layer, numGridCellsX and numGridCellsZ.
+			unsigned int numObstacleCellsX;
+			unsigned int numObstacleCellsZ;
 			bool drawGrid;
 		};
 
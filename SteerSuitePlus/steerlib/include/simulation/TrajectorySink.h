@@ -0,0 +1,179 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+#ifndef __STEERLIB_TRAJECTORY_SINK_H__
+#define __STEERLIB_TRAJECTORY_SINK_H__
+
+/// @file TrajectorySink.h
+/// @brief Declares the SteerLib::TrajectorySink class, which streams agent trajectories to a file from a background thread.
+
+#ifdef _WIN32
+// see steerlib/util/DrawLib.h for explanation
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Globals.h"
+#include "util/Geometry.h"
+
+namespace SteerLib {
+
+	class AgentInterface;
+	class CheckpointWriter;
+	class CheckpointReader;
+
+	/**
+	 * @brief Streams the (time, position) trajectories of agents to a file, one batch per frame, from a background thread.
+	 *
+	 * Without a sink, agents that record their trajectory append to their own _positionList, which grows with the number of frames
+	 * until the results are written at the end of the simulation.  When the trajectoryFile engine option is set, the engine opens
+	 * its sink instead, and SteerLib::AgentInterface::_recordPosition() sends the positions here.  They are collected in a batch
+	 * until the engine calls endFrame(), which hands the batch to a writer thread.  At most maxPendingFrames batches wait for the
+	 * writer; beyond that, endFrame() blocks until the writer catches up, so memory stays bounded no matter how long the simulation
+	 * runs.  The sink only keeps a number of positions per agent.
+	 *
+	 * If the file name ends with ".csv", the file has a header line and one "agent,time,x,y,z" line per position; otherwise it is
+	 * binary: the 8 characters "STEERTRJ", a 32-bit version number, and one record of a 32-bit agent index and four 32-bit floats
+	 * (time, x, y, z) per position, in native byte order.  Agents are numbered in the order in which they first recorded a
+	 * position, and the positions of one agent appear in the order they were recorded.  Both formats store floats exactly.
+	 *
+	 * readTrajectories() reads the positions back from the file in the same form as SteerLib::AgentInterface::getPositionList(),
+	 * for as many agents at a time as fit in a fixed budget, so that SteerLib::TestCaseWriter writes the same results as before.
+	 * If the agents do not all fit, the first call splits them into groups that do and copies the file once into a temporary file
+	 * that holds the positions of each group one after the other; every call then reads only its own group.
+	 *
+	 * A simulation checkpoint stores how far the file was written (see saveState()), so that restoring the checkpoint into the
+	 * same engine cuts off the positions that were recorded after it, instead of recording those frames twice.
+	 */
+	class STEERLIB_API TrajectorySink {
+	public:
+		/// A trajectory, in the same form as SteerLib::AgentInterface::getPositionList().
+		typedef std::vector<std::pair<float, Util::Point> > PositionList;
+
+		TrajectorySink();
+		~TrajectorySink();
+
+		/// Creates the file and starts the writer thread; throws an exception if the file cannot be created.
+		void open(const std::string & filename, unsigned int maxPendingFrames = 8);
+		/// Writes all pending positions, stops the writer thread, and closes the file; the file can still be read back afterwards.
+		void close();
+		inline bool isOpen() const { return _file != NULL; }
+		inline const std::string & getFilename() const { return _filename; }
+
+		/// Adds a position to the batch of the current frame.
+		void addPosition(const SteerLib::AgentInterface * agent, float time, const Util::Point & position);
+		/// Hands the batch of the current frame to the writer thread; blocks while too many batches are waiting.
+		void endFrame();
+		/// Waits until everything added so far is in the file.
+		void flush();
+
+		/// Returns the number of positions recorded for an agent since the file was opened.
+		size_t getNumPositions(const SteerLib::AgentInterface * agent) const;
+		/// Returns the number of positions recorded for all agents since the file was opened.
+		inline unsigned long long getTotalNumPositions() const { return _totalNumPositions; }
+		/**
+		 * @brief Reads back the trajectories of agents[firstAgent], agents[firstAgent+1], ... from the file.
+		 *
+		 * Reads as many agents as fit in the budget, but at least one, and returns one trajectory per agent read; agents that
+		 * recorded nothing get an empty trajectory.  Call it again with the same agents and the next agent to read the rest.
+		 */
+		void readTrajectories(const std::vector<SteerLib::AgentInterface*> & agents, size_t firstAgent, std::vector<PositionList> & trajectories);
+
+		/// @name Checkpoints
+		/// @brief Used by SimulationEngine::saveCheckpoint() and SimulationEngine::restoreCheckpoint().
+		///
+		/// saveState() waits until everything added so far is in the file, and writes how far the file got.  If the same file is
+		/// still open, restoreState() removes everything written after that point; a checkpoint of any other file (e.g., of the
+		/// engine a simulation was forked from) leaves the file as it is.
+		//@{
+		void saveState(SteerLib::CheckpointWriter & out);
+		void restoreState(SteerLib::CheckpointReader & in);
+		//@}
+
+	protected:
+		/// One position in the file.
+		struct Record {
+			unsigned int agent;
+			float time;
+			float x;
+			float y;
+			float z;
+		};
+
+		void _runWriterThread();
+		void _writeBatch(const std::vector<Record> & batch);
+		/// Returns the index of an agent in the file, or -1 if it recorded nothing.
+		int _getAgentIndex(const SteerLib::AgentInterface * agent) const;
+		/// Opens the file for reading and skips the header; throws an exception if it is not a trajectory file.
+		FILE * _openForReading() const;
+		/// Reads the next records from a file returned by _openForReading(); returns the number read, 0 at the end of the file.
+		size_t _readRecords(FILE * fp, std::vector<Record> & records) const;
+		/// Removes everything after the first numPositions positions and the first numAgentIndices agents from the file.
+		void _truncate(unsigned long long numBytes, unsigned long long numPositions, unsigned int numAgentIndices);
+		/// Splits agents[firstAgent], agents[firstAgent+1], ... into groups that fit the budget of readTrajectories(), and sorts the file by group if there are several.
+		void _groupAgents(const std::vector<SteerLib::AgentInterface*> & agents, size_t firstAgent);
+		/// Forgets the groups and removes the sorted file.
+		void _clearGroups();
+
+		std::string _filename;
+		FILE * _file;
+		bool _csv;
+		unsigned int _maxPendingFrames;
+		/// Identifies the file that was opened, so that restoreState() only truncates the file a checkpoint was saved with.
+		unsigned long long _fileId;
+		/// The size of the file, only used by the writer thread, or while it is idle.
+		unsigned long long _numBytesWritten;
+
+		/// The index of every agent that recorded a position, and the number of positions of each index.
+		std::map<const SteerLib::AgentInterface*, unsigned int> _agentIndices;
+		std::vector<size_t> _numPositions;
+		unsigned long long _totalNumPositions;
+
+		/// @name The groups of agents of readTrajectories()
+		//@{
+		/// The agents that were grouped, and the number of positions in the file at that time.
+		std::vector<SteerLib::AgentInterface*> _groupedAgents;
+		unsigned long long _groupedNumPositions;
+		/// The first agent of each group, followed by the end of the last group.
+		std::vector<size_t> _groupFirstAgents;
+		/// The first record of each group in _groupFile, followed by the number of records in it.
+		std::vector<unsigned long long> _groupFirstRecords;
+		/// A temporary file with the binary records of each group one after the other, or NULL if there is only one group.
+		FILE * _groupFile;
+		//@}
+
+		/// The batch of the current frame, only used by the simulation thread.
+		std::vector<Record> _currentBatch;
+
+		/// @name Shared with the writer thread, protected by _mutex
+		//@{
+		std::deque< std::vector<Record> > _pendingBatches;
+		/// Written batches, kept to reuse their memory.
+		std::vector< std::vector<Record> > _freeBatches;
+		bool _writing;
+		bool _stopping;
+		std::mutex _mutex;
+		std::condition_variable _batchReady;
+		std::condition_variable _batchWritten;
+		//@}
+		std::thread _writerThread;
+	};
+
+} // end namespace SteerLib
+
+#ifdef _WIN32
+#pragma warning( pop )
+#endif
+
+#endif
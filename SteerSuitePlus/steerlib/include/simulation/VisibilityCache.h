@@ -0,0 +1,162 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+#ifndef __STEERLIB_VISIBILITY_CACHE_H__
+#define __STEERLIB_VISIBILITY_CACHE_H__
+
+/// @file VisibilityCache.h
+/// @brief Declares the SteerLib::VisibilityCache class, which remembers which grid cells can see a fixed target past the obstacles.
+
+#ifdef _WIN32
+// see steerlib/util/DrawLib.h for explanation
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+
+#include <vector>
+#include <set>
+#include <map>
+#include "Globals.h"
+#include "util/Geometry.h"
+
+namespace SteerLib {
+
+	class ObstacleInterface;
+	class SpatialDataBaseInterface;
+
+	/// The number of targets a VisibilityCache keeps unless VisibilityCache::setMaxNumTargets() is called.
+	const unsigned int DEFAULT_MAX_VISIBILITY_CACHE_TARGETS = 16;
+
+	/**
+	 * @brief Cached line of sight from the cells of the spatial database to fixed targets, such as goals.
+	 *
+	 * Many agents test every frame whether they can see their goal, but with agents ignored, the answer only depends on the
+	 * agent's position and on the obstacles, which rarely change.  For each target, the cache keeps one state per cell of the
+	 * spatial database grid, classified the first time the cell is queried:
+	 *  - visible: no obstacle bounds overlap the convex hull of the cell and the target, so every point of the cell has an
+	 *    unobstructed straight line to the target.
+	 *  - occluded: the segments from all four corners of the cell to the target go through the same convex obstacle (a box,
+	 *    oriented box, wall or circle), so every segment from a point of the cell to the target goes through it too.
+	 *  - partially visible: anything else, for example a cell that sees the target through a doorway.
+	 *
+	 * getVisibility() answers for all the cells within a radius of a position: VISIBILITY_VISIBLE or VISIBILITY_OCCLUDED if they
+	 * all agree, and VISIBILITY_UNKNOWN otherwise, in which case the caller should trace its rays as before.  A known answer is
+	 * the same as tracing from any point within the radius against the obstacles.
+	 *
+	 * When an obstacle is added, the cells whose hull overlaps it and that are not already occluded are classified again, and
+	 * likewise the cells that are not visible when an obstacle is removed; other cells keep their state.  Each target keeps a
+	 * list of its classified cells, so these updates only visit the cells that agents actually queried, not the whole grid.
+	 *
+	 * Each target takes one byte per grid cell, so the cache suits a few targets shared by many agents, such as the exits of an
+	 * evacuation.  It keeps at most getMaxNumTargets() targets; a query for a new target when the cache is full forgets the
+	 * least recently queried target and reuses its cells.  Many distinct targets, such as the individual goals of wandering
+	 * agents, therefore cost a bounded amount of memory, and just fall back to tracing more often.
+	 */
+	class STEERLIB_API VisibilityCache {
+	public:
+		/// The answer of getVisibility().
+		enum Visibility {
+			VISIBILITY_UNKNOWN = 0,
+			VISIBILITY_VISIBLE,
+			VISIBILITY_OCCLUDED
+		};
+
+		VisibilityCache();
+
+		/// Sets the spatial database whose grid the cache follows and the obstacles it tests, and forgets all targets.
+		void init(SteerLib::SpatialDataBaseInterface * spatialDatabase, const std::set<SteerLib::ObstacleInterface*> * obstacles);
+		/// Forgets all targets; called when a simulation is unloaded.
+		void clear();
+
+		/// Sets the number of targets the cache keeps, forgetting the least recently queried ones if there are more; zero disables the cache.
+		void setMaxNumTargets(unsigned int maxNumTargets);
+		inline unsigned int getMaxNumTargets() const { return _maxNumTargets; }
+
+		/// @name Notifications from the engine
+		//@{
+		void obstacleAdded(SteerLib::ObstacleInterface * obstacle);
+		void obstacleRemoved(SteerLib::ObstacleInterface * obstacle);
+		/// Classifies every cell of every target again.
+		void invalidate();
+		//@}
+
+		/// Returns whether every point within radius of position sees target past all obstacles, or is hidden from it by an obstacle.
+		Visibility getVisibility(const Util::Point & position, float radius, const Util::Point & target);
+
+		/// @name Statistics
+		//@{
+		inline size_t getNumTargets() const { return _targets.size(); }
+		inline unsigned long long getNumQueries() const { return _numQueries; }
+		inline unsigned long long getNumVisibleQueries() const { return _numVisibleQueries; }
+		inline unsigned long long getNumOccludedQueries() const { return _numOccludedQueries; }
+		inline unsigned long long getNumClassifiedCells() const { return _numClassifiedCells; }
+		inline unsigned long long getNumEvictedTargets() const { return _numEvictedTargets; }
+		//@}
+
+	protected:
+		enum CellState {
+			CELL_UNCLASSIFIED = 0,
+			CELL_VISIBLE,
+			CELL_OCCLUDED,
+			CELL_PARTIALLY_VISIBLE
+		};
+
+		/// A target on the ground plane, ordered so that it can be used as a map key.
+		typedef std::pair<float, float> TargetKey;
+
+		/// The cell states of one target.
+		struct Target {
+			/// One state per cell, indexed by ix * _numCellsZ + iz like the cells of SteerLib::GridDatabase2D.
+			std::vector<unsigned char> cells;
+			/// The indices of the cells that are not CELL_UNCLASSIFIED.
+			std::vector<unsigned int> classifiedCells;
+			/// The value of _numQueries when the target was last queried.
+			unsigned long long lastQuery;
+		};
+
+		/// Adds a target with all cells unclassified, forgetting the least recently queried target first if the cache is full.
+		std::map<TargetKey, Target>::iterator _addTarget(const TargetKey & key);
+		/// Forgets the least recently queried target; returns its cells, all unclassified, in cells.
+		void _evictLeastRecentlyQueriedTarget(std::vector<unsigned char> & cells);
+		/// Returns the state of cell (ix,iz) for target, classifying it if needed.
+		unsigned char _getCellState(Target & cachedTarget, unsigned int ix, unsigned int iz, const Util::Point & target);
+		/// Returns true if box overlaps the convex hull of cell (ix,iz) and target.
+		bool _hullOverlapsBox(unsigned int ix, unsigned int iz, const Util::Point & target, const Util::AxisAlignedBox & box) const;
+		/// Returns true if the segments from all corners of cell (ix,iz) to target go through obstacle, which must be convex.
+		bool _obstacleOccludesCell(SteerLib::ObstacleInterface * obstacle, unsigned int ix, unsigned int iz, const Util::Point & target) const;
+		/// Returns true if obstacle is convex and inside the grid, so that _obstacleOccludesCell() can be trusted.
+		bool _canOcclude(SteerLib::ObstacleInterface * obstacle) const;
+		/// Unclassifies the classified cells whose hull overlaps the bounds of obstacle, except those in keptState, for every target.
+		void _resetCells(SteerLib::ObstacleInterface * obstacle, unsigned char keptState);
+
+		SteerLib::SpatialDataBaseInterface * _spatialDatabase;
+		const std::set<SteerLib::ObstacleInterface*> * _obstacles;
+
+		/// The grid of the spatial database, read by init().
+		float _originX;
+		float _originZ;
+		float _cellSizeX;
+		float _cellSizeZ;
+		unsigned int _numCellsX;
+		unsigned int _numCellsZ;
+
+		std::map<TargetKey, Target> _targets;
+		unsigned int _maxNumTargets;
+
+		unsigned long long _numQueries;
+		unsigned long long _numVisibleQueries;
+		unsigned long long _numOccludedQueries;
+		unsigned long long _numClassifiedCells;
+		unsigned long long _numEvictedTargets;
+	};
+
+} // end namespace SteerLib
+
+#ifdef _WIN32
+#pragma warning( pop )
+#endif
+
+#endif
@@ -51,6 +51,11 @@ namespace SteerLib {
 	 * If the test case is large, this class may consume a large amount of memory.  It is a good idea to de-allocate it
 	 * as soon as you finish initializing your own data.
 	 *
+	 * For large test cases, parsing the XML and randomly placing agents can take a long time.  A test case can be converted
+	 * once into a binary test case with TestCaseWriter::writeBinaryTestCaseToFile() (or "steertool -tobinary"), which stores
+	 * the fully initialized agents and obstacles.  #readTestCaseFromFile() recognizes binary test cases by their magic number,
+	 * and loads them through a memory map without any parsing; the random choices made during the conversion are kept.
+	 *
 	 * @see
 	 *  - Documentation of AgentInitialConditions, which is the return value of #getAgentInitialConditions()
 	 *  - Documentation of ObstacleInitialConditions, which is the return value of #getObstacleInitialConditions()
@@ -59,8 +64,10 @@ namespace SteerLib {
 	class STEERLIB_API TestCaseReader : public TestCaseReaderPrivate {
 	public:
 		TestCaseReader();
-		/// Parses the specified XML test case; after this function returns the class contains all initialized information about the test case.
+		/// Parses the specified XML or binary test case; after this function returns the class contains all initialized information about the test case.
 		void readTestCaseFromFile( const std::string & testCaseFilename );
+		/// Returns true if the file is a binary test case written by TestCaseWriter::writeBinaryTestCaseToFile().
+		static bool isABinaryTestCase( const std::string & filename );
 
 		/// @name General queries about the test case
 		//@{
@@ -75,13 +82,13 @@ namespace SteerLib {
 		/// Returns the test case name (not the filename) specified by the test case.
 		inline const std::string & getTestCaseName() const { return _header.name; }
 		/// Returns the description specified by the test case.
-		inline const std::string & getDescription() { return _header.description; }
+		inline const std::string & getDescription() const { return _header.description; }
 		/// Returns a string indicating the version of this test case.
-		inline const std::string & getVersion() { return _header.version; }
+		inline const std::string & getVersion() const { return _header.version; }
 		/// Returns a human-readable string desciribing the criteria for passing a particular test case; In the future this criteria may become more elaborate and automated.
-		inline const std::string & getPassingCriteria() { return _header.passingCriteria; }
+		inline const std::string & getPassingCriteria() const { return _header.passingCriteria; }
 		/// Returns a data structure containing information about one suggested camera view.
-		inline const CameraView & getCameraView(unsigned int cameraIndex) { return _cameraViews[cameraIndex]; }
+		inline const CameraView & getCameraView(unsigned int cameraIndex) const { return _cameraViews[cameraIndex]; }
 		/// Returns the world boundaries specified by the test case.
 		inline const Util::AxisAlignedBox & getWorldBounds() const { return _header.worldBounds; }
 		#ifdef VARIABLE_SPAWN_TIME
@@ -156,7 +163,28 @@ namespace SteerLib {
 			const std::vector<SteerLib::AgentInterface*> & agents,
 			const std::vector<SteerLib::ObstacleInterface*> obstacles,
 			SteerLib::EngineInterface *engineInfo);
+
+		/// Writes the fully initialized agents, agent emitters, obstacles and camera views of testCase as a binary test case, which TestCaseReader loads without parsing.
+		void writeBinaryTestCaseToFile(const std::string & filename, const SteerLib::TestCaseReader & testCase);
+
+		/// Writes out agents, agent emitters and obstacles as an xml testcase file, with the given world bounds instead of the bounds of an engine.
+		void writeTestCaseToFile(const std::string & testCaseName,
+			std::vector<SteerLib::AgentInitialConditions> & agents,
+			std::vector<SteerLib::AgentInitialConditions> & agentEmitters,
+			std::vector<SteerLib::ObstacleInitialConditions*> & obstacles,
+			const Util::AxisAlignedBox & worldBounds);
+
+		void writeTestCaseToFile(FILE *fp,
+			std::vector<SteerLib::AgentInitialConditions> & agents,
+			std::vector<SteerLib::AgentInitialConditions> & agentEmitters,
+			std::vector<SteerLib::ObstacleInitialConditions*> & obstacles,
+			const Util::AxisAlignedBox & worldBounds);
     private:
+        /// Writes one obstacle with the xml tag of its type.
+        void _writeObstacle(FILE *fp, const SteerLib::ObstacleInitialConditions * obstacle) ;
+        /// Writes the agents and their goal sequences, each under the given xml tag (agent or agentEmitter).
+        void _writeAgents(FILE *fp, std::vector<SteerLib::AgentInitialConditions> & agents, const char * tagName) ;
+
         /// The name of the testcase
         std::string _testCaseName ;
     } ;
@@ -305,6 +305,168 @@ namespace SteerLib {
 
 
 
+	//
+	// ---------------------------------
+	// Binary test cases (version 1):
+	//
+	// A binary test case stores the fully initialized test case, i.e. after agent and obstacle regions were
+	// expanded and all random values were chosen, so that it can be loaded without any parsing or random placement.
+	// Like rec files, it is written in the byte order of the machine that wrote it, and is read through a memory map.
+	//
+	// The file contains these sections, each starting at an 8-byte aligned offset given in the header:
+	//  - header
+	//  - list of agents, followed by the list of agent emitters
+	//  - list of goals of all agents and agent emitters; each agent refers to a contiguous range of goals
+	//  - list of behaviour parameters of all goals; each goal refers to a contiguous range of parameters
+	//  - list of obstacles
+	//  - list of polygon obstacle vertices; each polygon obstacle refers to a contiguous range of vertices
+	//  - list of camera views
+	//  - string table of nul-terminated strings; strings are referred to by their offset in the table, and offset 0 is always the empty string.
+	// ---------------------------------
+	//
+
+	/// The "magic number" placed at the beginning of every binary test case; used to identify binary test cases and to check big-endian/little-endian issues.
+	const unsigned int BINARY_TEST_CASE_MAGIC_NUMBER = 0x7e5c47b1;
+	/// The version of binary test cases written by TestCaseWriter.
+	const unsigned int BINARY_TEST_CASE_VERSION = 1;
+
+	/**
+	 * @brief The header data contained in the very beginning of a binary test case.
+	 *
+	 * <b>This struct is used for file IO, so do not reorder items.</b>
+	 */
+	struct BinaryTestCaseHeader {
+		/// A unique number that helps identify a binary test case, and to detect big-endian/little-endian issues.
+		unsigned int magic;
+		/// Integer number representing the version of the binary test case.
+		unsigned int version;
+		/// Size in bytes of this data structure.
+		unsigned int headerSize;
+
+		unsigned int numAgents;
+		unsigned int numAgentEmitters;
+		unsigned int numGoals;
+		unsigned int numBehaviourParameters;
+		unsigned int numObstacles;
+		unsigned int numVertices;
+		unsigned int numCameraViews;
+
+		/// @name String table offsets of the test case header data
+		//@{
+		unsigned int nameOffset;
+		unsigned int descriptionOffset;
+		unsigned int versionOffset;
+		unsigned int passingCriteriaOffset;
+		//@}
+		float worldBounds[6];
+
+		/// @name Offsets in bytes from the beginning of the file to each section
+		//@{
+		unsigned int agentListOffset;
+		unsigned int goalListOffset;
+		unsigned int behaviourParameterListOffset;
+		unsigned int obstacleListOffset;
+		unsigned int vertexListOffset;
+		unsigned int cameraListOffset;
+		unsigned int stringTableOffset;
+		//@}
+		/// Size in bytes of the string table, which is the last section of the file.
+		unsigned int stringTableSize;
+	};
+
+	/**
+	 * @brief The initial conditions of an agent or agent emitter, used for reading/writing binary test cases.
+	 *
+	 * <b>This struct is used for file IO, so do not reorder items.</b>
+	 */
+	struct BinaryTestCaseAgentInfo {
+		float position[3];
+		float direction[3];
+		float radius;
+		float speed;
+		float startTime;
+		float color[3];
+		unsigned int colorSet;
+		unsigned int fromRandom;
+		float randBox[6];
+		unsigned int nameOffset;
+		unsigned int firstGoal;
+		unsigned int numGoals;
+	};
+
+	/**
+	 * @brief One goal of an agent, used for reading/writing binary test cases.
+	 *
+	 * <b>This struct is used for file IO, so do not reorder items.</b>
+	 */
+	struct BinaryTestCaseGoalInfo {
+		unsigned int goalType;
+		unsigned int targetIsRandom;
+		float timeDuration;
+		float desiredSpeed;
+		float targetLocation[3];
+		float targetDirection[3];
+		float targetRegion[6];
+		unsigned int targetNameOffset;
+		unsigned int flowTypeOffset;
+		unsigned int steeringAlgorithmOffset;
+		unsigned int firstBehaviourParameter;
+		unsigned int numBehaviourParameters;
+	};
+
+	/**
+	 * @brief A key/value parameter of a goal's behaviour, used for reading/writing binary test cases.
+	 *
+	 * <b>This struct is used for file IO, so do not reorder items.</b>
+	 */
+	struct BinaryTestCaseBehaviourParameterInfo {
+		unsigned int keyOffset;
+		unsigned int valueOffset;
+	};
+
+	/// The type of an obstacle in a binary test case, i.e. which ObstacleInitialConditions it is read into.
+	enum BinaryTestCaseObstacleTypeEnum {
+		BINARY_TEST_CASE_BOX_OBSTACLE,
+		BINARY_TEST_CASE_CIRCLE_OBSTACLE,
+		BINARY_TEST_CASE_ORIENTED_BOX_OBSTACLE,
+		BINARY_TEST_CASE_ORIENTED_WALL_OBSTACLE,
+		BINARY_TEST_CASE_POLYGON_OBSTACLE
+	};
+
+	/**
+	 * @brief The initial conditions of an obstacle, used for reading/writing binary test cases.
+	 *
+	 * Only the items used by the obstacle's type are valid.
+	 * <b>This struct is used for file IO, so do not reorder items.</b>
+	 */
+	struct BinaryTestCaseObstacleInfo {
+		double doorLocation;
+		double doorRadius;
+		unsigned int type;
+		float bounds[6];
+		float position[3];
+		float radius;
+		float height;
+		float lengthX;
+		float lengthZ;
+		float thetaY;
+		unsigned int firstVertex;
+		unsigned int numVertices;
+	};
+
+	/**
+	 * @brief A suggested camera view, used for reading/writing binary test cases.
+	 *
+	 * <b>This struct is used for file IO, so do not reorder items.</b>
+	 */
+	struct BinaryTestCaseCameraInfo {
+		float position[3];
+		float lookat[3];
+		float up[3];
+		float fovy;
+	};
+
+
 	/**
 	 * @brief Private data for the TestCaseReader public interface
 	 *
@@ -361,6 +523,9 @@ namespace SteerLib {
 		void _getBehaviorFromXMLElement(const ticpp::Element * subRoot, Behaviour * behavior);
 		//@}
 
+		/// Reads a binary test case written by TestCaseWriter::writeBinaryTestCaseToFile(), directly into the initialized agents, obstacles, and camera views.
+		void _readBinaryTestCase(const std::string & testCaseFilename);
+
 		/// @name Helper functions to set up initial conditions
 		//@{
 		void _initObstacleInitialConditions( SteerLib::BoxObstacleInitialConditions & o, const Util::AxisAlignedBox & bounds );
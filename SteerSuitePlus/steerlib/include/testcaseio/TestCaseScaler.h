@@ -0,0 +1,99 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+#ifndef __STEERLIB_TEST_CASE_SCALER_H__
+#define __STEERLIB_TEST_CASE_SCALER_H__
+
+/// @file TestCaseScaler.h
+/// @brief Declares the SteerLib::TestCaseScaler class, which generates larger variants of existing test cases.
+
+#ifdef _WIN32
+// see steerlib/util/DrawLib.h for explanation
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+
+#include <vector>
+#include <string>
+#include "Globals.h"
+#include "testcaseio/TestCaseIO.h"
+#include "testcaseio/AgentInitialConditions.h"
+#include "testcaseio/ObstacleInitialConditions.h"
+
+namespace SteerLib {
+
+	/**
+	 * @brief Generates stress variants of a test case by scaling and tiling it.
+	 *
+	 * The scaler copies the agents, agent emitters, obstacles and world bounds of a parsed test case, and transforms them on the
+	 * ground plane:
+	 *  - scaling stretches positions, goal targets, goal and random regions, and obstacle footprints by a factor about the
+	 *    center of the world bounds.  Agent radii and obstacle heights are not changed, so a larger factor gives a sparser scenario.
+	 *  - tiling repeats the (scaled) test case tilesX by tilesZ times, side by side and centered on the original world, which
+	 *    multiplies the number of agents and obstacles.  Agent names, and the dynamic targets that refer to them, get a
+	 *    per-tile suffix so that they stay unique.
+	 *
+	 * The result can be written as a new XML test case with writeTestCaseToFile(), or used directly to create the agents and
+	 * obstacles of a simulation, as the testCasePlayer module does with its scaleFactor, tilesX, tilesZ and numAgents options.
+	 *
+	 * Note that the world bounds of the result usually grow; the spatial database of the engine must be large enough to contain them
+	 * (see the sizeX and sizeZ options of the gridDatabase).
+	 */
+	class STEERLIB_API TestCaseScaler {
+	public:
+		TestCaseScaler();
+		~TestCaseScaler();
+
+		/// Copies testCase scaled by scaleFactor, then tiled tilesX by tilesZ times with tileSpacing meters between tiles; replaces any previous result.
+		void scaleTestCase(const TestCaseReader & testCase, float scaleFactor, unsigned int tilesX = 1, unsigned int tilesZ = 1, float tileSpacing = 0.0f);
+
+		/// Returns the smallest, roughly square tiling that gives at least numAgents agents from a test case with numAgentsInTestCase agents.
+		static void getTilesForNumAgents(size_t numAgentsInTestCase, size_t numAgents, unsigned int & tilesX, unsigned int & tilesZ);
+
+		/// Writes the result as the XML test case testCaseName + ".xml"; like TestCaseWriter, agent emitters are not written.
+		void writeTestCaseToFile(const std::string & testCaseName);
+
+		/// @name Queries about the scaled test case, in the same form as TestCaseReader
+		//@{
+		inline size_t getNumAgents() const { return _agents.size(); }
+		inline size_t getNumAgentEmitters() const { return _agentEmitters.size(); }
+		inline size_t getNumObstacles() const { return _obstacles.size(); }
+		inline const std::string & getTestCaseName() const { return _testCaseName; }
+		inline const Util::AxisAlignedBox & getWorldBounds() const { return _worldBounds; }
+		inline const AgentInitialConditions & getAgentInitialConditions(unsigned int agentIndex) const { return _agents.at(agentIndex); }
+		inline const AgentInitialConditions & getAgentEmitterInitialConditions(unsigned int agentEmitterIndex) const { return _agentEmitters.at(agentEmitterIndex); }
+		inline const ObstacleInitialConditions * getObstacleInitialConditions(unsigned int obstacleIndex) const { return _obstacles.at(obstacleIndex); }
+		//@}
+
+	protected:
+		/// Deletes the obstacles and clears the previous result.
+		void _clear();
+		/// Returns p scaled about _center, then moved by offset; y is not changed.
+		Util::Point _transformPoint(const Util::Point & p, const Util::Vector & offset) const;
+		Util::AxisAlignedBox _transformBox(const Util::AxisAlignedBox & box, const Util::Vector & offset) const;
+		AgentInitialConditions _transformAgent(const AgentInitialConditions & agent, const Util::Vector & offset, const std::string & nameSuffix) const;
+		/// Returns a new, transformed copy of the obstacle, or NULL if its type is not known.
+		ObstacleInitialConditions * _transformObstacle(const ObstacleInitialConditions * obstacle, const Util::Vector & offset) const;
+
+		std::string _testCaseName;
+		Util::AxisAlignedBox _worldBounds;
+		std::vector<AgentInitialConditions> _agents;
+		std::vector<AgentInitialConditions> _agentEmitters;
+		/// Owned by the scaler.
+		std::vector<ObstacleInitialConditions*> _obstacles;
+
+		/// The transform being applied by scaleTestCase().
+		Util::Point _center;
+		float _scaleFactor;
+	};
+
+} // end namespace SteerLib
+
+#ifdef _WIN32
+#pragma warning( pop )
+#endif
+
+#endif
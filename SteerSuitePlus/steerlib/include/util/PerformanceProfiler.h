@@ -13,6 +13,7 @@
 #include <ostream>
 #include "Globals.h"
 #include "util/HighResCounter.h"
+#include "util/TraceProfiler.h"
 
 namespace Util {
 
@@ -98,14 +99,18 @@ namespace Util {
 	 * With this class, PerformanceProfiler::stop() is automatically invoked when the function 
 	 * returns, no matter where the function returns from.
 	 *
+	 * If a traceName is given, the same block is also recorded as a span with the Util::TraceProfiler
+	 * (while it is enabled), so that it shows up on the per-frame timeline.
+	 *
 	 */
 	class UTIL_API AutomaticFunctionProfiler
 	{
 	public:
-		AutomaticFunctionProfiler(PerformanceProfiler * pp) { _pp = pp; _pp->start(); }
+		AutomaticFunctionProfiler(PerformanceProfiler * pp, const char * traceName = NULL) : _trace(traceName) { _pp = pp; _pp->start(); }
 		~AutomaticFunctionProfiler() { _pp->stop(); }
 	private:
 		PerformanceProfiler * _pp;
+		TraceScope _trace;
 	};
 
 } // end namespace Util
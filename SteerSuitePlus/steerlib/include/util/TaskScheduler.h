@@ -0,0 +1,176 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+#ifndef __UTIL_TASK_SCHEDULER_H__
+#define __UTIL_TASK_SCHEDULER_H__
+
+/// @file TaskScheduler.h
+/// @brief Declares Util::TaskScheduler, a work-stealing thread pool, and Util::TaskGroup.
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+
+#include "Globals.h"
+
+
+#ifdef _WIN32
+// on win32, there is an unfortunate conflict between exporting symbols for a
+// dynamic/shared library and STL code.  A good document describing the problem
+// in detail is http://www.unknownroad.com/rtfm/VisualStudio/warningC4251.html
+// the "least evil" solution is just to simply ignore this warning.
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+
+
+namespace Util {
+
+	class TaskGroup;
+
+	/// When parallelFor() is given a grain size of zero, the range is split into this many chunks.
+	const size_t DEFAULT_NUM_PARALLEL_FOR_CHUNKS = 64;
+
+	/**
+	 * @brief A work-stealing thread pool.
+	 *
+	 * Every thread of the scheduler has its own double-ended queue of tasks.  A thread pushes and pops tasks
+	 * at the back of its own queue, so recently spawned (and still cache-warm) work runs first; a thread that
+	 * runs out of work steals the oldest task from the front of another thread's queue.  There is no single
+	 * queue that all threads contend for.
+	 *
+	 * Tasks are spawned and joined with a Util::TaskGroup.  The thread that waits for a group does not sleep
+	 * while there is work to do; it runs queued tasks itself, so a scheduler with numThreads threads creates
+	 * only numThreads-1 worker threads, and a scheduler with one thread runs everything on the calling thread.
+	 *
+	 * parallelFor() splits an index range into chunks that depend only on the range and the grain size, never
+	 * on the number of threads or on which thread steals what.  If each chunk writes only its own results, the
+	 * results are the same for any number of threads.
+	 *
+	 * Of course, <b>you will need to make your tasks thread-safe!</b>
+	 *
+	 * <h3>Notes</h3>
+	 * All task groups must be waited on before the scheduler is destroyed.
+	 *
+	 * @see
+	 *  - Util::TaskGroup, to spawn and join individual tasks.
+	 */
+	class UTIL_API TaskScheduler {
+	public:
+		/// Creates a scheduler that runs tasks on numThreads threads, including the thread that waits for them; zero uses getDefaultNumThreads().
+		TaskScheduler(unsigned int numThreads = 0);
+		/// Terminates the worker threads; all task groups must be completed before the scheduler is destroyed.
+		~TaskScheduler();
+
+		/// Returns the number of threads that run tasks, including the thread that waits for them.
+		unsigned int getNumThreads() const { return (unsigned int)_queues.size(); }
+		/// Returns the number of hardware threads, or 1 if that number is not known.
+		static unsigned int getDefaultNumThreads();
+
+		/// Calls body(first, end) for consecutive chunks of [begin, end) in parallel, and returns when all chunks are done.
+		/// Chunks have grainSize indices (the last one may have fewer); a grainSize of zero splits the range into DEFAULT_NUM_PARALLEL_FOR_CHUNKS chunks.
+		/// If chunks throw exceptions, all chunks still run, and then the exception of the first of them (in chunk order) is re-thrown.
+		void parallelFor(size_t begin, size_t end, size_t grainSize, const std::function<void(size_t first, size_t end)> & body);
+		/// Returns the number of chunks that parallelFor() uses for the range [begin, end).
+		static size_t getNumChunks(size_t begin, size_t end, size_t grainSize);
+		/// Returns the grain size that parallelFor() uses for the range [begin, end); only differs from grainSize if grainSize is zero.
+		static size_t getChunkSize(size_t begin, size_t end, size_t grainSize);
+
+	protected:
+		/// A task that was spawned by a TaskGroup and has not run yet.
+		struct Job {
+			std::function<void()> function;
+			TaskGroup * group;
+			unsigned long long taskNumber;
+		};
+
+		/// One double-ended queue of jobs per thread; index 0 is shared by all threads that are not workers of this scheduler.
+		struct WorkQueue {
+			std::mutex lock;
+			std::deque<Job*> jobs;
+		};
+
+		/// Pushes a job onto the queue of the current thread and wakes up a sleeping worker.
+		void _spawn(Job * job);
+		/// Pops a job from the back of the queue of thread queueIndex, or steals one from the front of another queue; returns NULL if there is no work.
+		Job * _findJob(unsigned int queueIndex);
+		/// Runs a job, records its exception in its group, and deletes it.
+		void _runJob(Job * job);
+		/// Returns the index of the queue of the current thread.
+		unsigned int _getCurrentQueueIndex() const;
+		/// Terminates and joins the worker threads, and deletes the queues.
+		void _shutDown();
+		/// The main function executed by every worker thread; runs and steals jobs until the scheduler is destroyed.
+		void _runWorkerThread(unsigned int queueIndex);
+
+		std::vector<WorkQueue*> _queues;
+		std::vector<std::thread> _threads;
+		/// The number of jobs in all queues, used by idle workers to decide whether to sleep.
+		std::atomic<unsigned int> _numQueuedJobs;
+
+		/// Protects _shuttingDown, and is used with _workAvailable to put idle workers to sleep.
+		std::mutex _sleepLock;
+		std::condition_variable _workAvailable;
+		bool _shuttingDown;
+
+		friend class TaskGroup;
+	};
+
+
+	/**
+	 * @brief A set of tasks that run on a Util::TaskScheduler and are waited on together.
+	 *
+	 * Tasks may spawn more tasks into the same group or into other groups.  If tasks throw exceptions,
+	 * wait() re-throws the exception of the first task that was spawned, after all tasks are done.
+	 */
+	class UTIL_API TaskGroup {
+	public:
+		TaskGroup(TaskScheduler & scheduler);
+		/// Waits for any tasks that are still running; exceptions are discarded.
+		~TaskGroup();
+
+		/// Spawns a task; the task may start running before run() returns.
+		void run(const std::function<void()> & task);
+		/// Runs other tasks until all tasks of this group are done, then re-throws the first exception thrown by a task, if any.
+		void wait();
+
+	protected:
+		/// Waits for all tasks of the group without re-throwing exceptions.
+		void _join();
+		/// Called when a task of the group is done.
+		void _taskDone(unsigned long long taskNumber, std::exception_ptr exception);
+
+		TaskScheduler & _scheduler;
+		std::atomic<unsigned int> _numPendingTasks;
+		/// Tasks are numbered in the order they were spawned, so the exception re-thrown by wait() does not depend on timing.
+		std::atomic<unsigned long long> _numSpawnedTasks;
+
+		/// Protects the exception, and is used with _allTasksDone to sleep while the last tasks run on other threads.
+		std::mutex _lock;
+		std::condition_variable _allTasksDone;
+		std::exception_ptr _exception;
+		unsigned long long _exceptionTaskNumber;
+
+		friend class TaskScheduler;
+
+	private:
+		TaskGroup(const TaskGroup &);
+		TaskGroup & operator=(const TaskGroup &);
+	};
+
+} // namespace Util
+
+
+#ifdef _WIN32
+#pragma warning( pop )
+#endif
+
+#endif
@@ -67,12 +67,17 @@ namespace Util {
 	 * <h3>Notes</h3>
 	 * The throw() syntax, with nothing inside the parentheses, means that the function cannot throw exceptions.
 	 *
+	 * @deprecated
+	 *  New code should use Util::TaskScheduler, which has per-thread work-stealing queues, parallel loops
+	 *  and task groups, and works on all platforms.
+	 *
 	 * @todo
 	 *  - This class has not been tested thoroughly yet, and may still need to be debugged.
 	 *  - Use Windows Vista conditions
 	 *
 	 * @see
 	 *  - Util::Mutex, a platform-independent wrapper for pthreads/win32 user-mode locks.
+	 *  - Util::TaskScheduler
 	 */
 	class UTIL_API ThreadedTaskManager {
 	public:
@@ -0,0 +1,197 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+#ifndef __UTIL_TRACE_PROFILER_H__
+#define __UTIL_TRACE_PROFILER_H__
+
+/// @file TraceProfiler.h
+/// @brief Declares Util::TraceProfiler, which records a timeline of nested spans, and Util::TraceScope.
+
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include "Globals.h"
+#include "util/HighResCounter.h"
+
+#ifdef _WIN32
+// on win32, there is an unfortunate conflict between exporting symbols for a
+// dynamic/shared library and STL code.  A good document describing the problem
+// in detail is http://www.unknownroad.com/rtfm/VisualStudio/warningC4251.html
+// the "least evil" solution is just to simply ignore this warning.
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+
+namespace Util {
+
+	/// The number of spans each thread keeps by default; older spans are overwritten.
+	const unsigned int DEFAULT_TRACE_EVENTS_PER_THREAD = 1 << 16;
+
+	/// One span recorded by the Util::TraceProfiler.
+	struct TraceEvent {
+		/// The name of the span; must remain valid until the trace is written (string literals, or names from TraceProfiler::internName()).
+		const char * name;
+		unsigned long long startTick;
+		unsigned long long endTick;
+		/// The simulation frame that was running when the span started.
+		unsigned int frameNumber;
+		/// The number of spans of the same thread that enclose this one.
+		unsigned int depth;
+	};
+
+	/// The number and total duration of the spans with the same name; see TraceProfiler::collectSpanTotals().
+	struct TraceSpanTotals {
+		TraceSpanTotals() : numSpans(0), totalTicks(0), maxTicks(0) {}
+		unsigned long long numSpans;
+		unsigned long long totalTicks;
+		unsigned long long maxTicks;
+	};
+
+	/**
+	 * @brief Records a timeline of nested, named spans of code from any number of threads, and exports it for chrome://tracing.
+	 *
+	 * Unlike Util::PerformanceProfiler, which only accumulates statistics, the trace profiler keeps every span:
+	 * when it started, how long it took, which frame it belonged to, and which thread ran it.  A spike in a single
+	 * frame of a long run can then be attributed to the module, agent phase, or thread that caused it, by loading
+	 * the file written by writeChromeTrace() into chrome://tracing (or any viewer of the Chrome trace-event format).
+	 *
+	 * Spans are recorded with Util::TraceScope.  Every thread records into its own ring buffer, so recording needs no
+	 * locks; only the last spans that fit into the buffer are kept.  While the profiler is disabled (the default), a
+	 * TraceScope costs one test of a flag.  The buffer of a thread that exits keeps its spans until they are discarded,
+	 * and is then given to the next thread that records, so threads that are created for every run (e.g., by a
+	 * Util::TaskScheduler) do not add a buffer each.
+	 *
+	 * There is one trace profiler per process, like the Util::LogManager.  The engine records every frame, the
+	 * pre-processing, agent updates, and post-processing of each frame, and each module's part of those; modules and
+	 * agents can add their own spans.
+	 *
+	 * Engines share the profiler through beginRecording() and endRecording(), which count the recordings in progress:
+	 * the first beginRecording() discards old spans and enables the profiler, and the last endRecording() disables it
+	 * and writes the trace to the files of all recordings that ended since.  When several engines of one process trace
+	 * at the same time, their spans therefore end up in one timeline, told apart only by thread, and the frame number of
+	 * a span is the one last set by any engine; for a trace of a single engine, run only one traced engine at a time.
+	 *
+	 * <h3>Notes</h3>
+	 * writeChromeTrace(), clear(), and setEnabled() must not be called while other threads are recording spans; use
+	 * beginRecording() and endRecording() instead when other engines may be running.
+	 */
+	class UTIL_API TraceProfiler {
+	public:
+		/// Returns the trace profiler of this process.
+		static TraceProfiler * getInstance();
+
+		/// Starts or stops recording spans, regardless of other recordings in progress.
+		void setEnabled(bool enabled) { _enabled.store(enabled); }
+		/// Starts a recording; if no other recording is in progress, discards all spans and enables the profiler.
+		void beginRecording();
+		/// Ends a recording started by beginRecording(); if it was the last one, disables the profiler and writes the trace to filename and to the files of the recordings that ended before.  An empty filename writes nothing.
+		void endRecording(const std::string & filename);
+		/// Returns true if spans are being recorded.
+		inline bool isEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+		/// Sets the number of spans kept per thread; only affects threads that have not recorded any spans yet.
+		void setEventsPerThread(unsigned int numEvents) { _eventsPerThread = (numEvents > 0) ? numEvents : 1; }
+		/// Sets the frame number that is stored with the spans that start from now on.
+		inline void setFrameNumber(unsigned int frameNumber) { _frameNumber.store(frameNumber, std::memory_order_relaxed); }
+
+		/// Returns a copy of name that remains valid for the lifetime of the process, to be used as the name of spans.
+		const char * internName(const std::string & name);
+
+		/// Records one span of the calling thread; usually called by Util::TraceScope.
+		void recordEvent(const char * name, unsigned long long startTick, unsigned long long endTick, unsigned int depth);
+		/// Discards all recorded spans.
+		void clear();
+		/// Adds the number and duration of all recorded spans to totals, by span name, then discards the spans; call often enough that the ring buffers do not wrap.
+		void collectSpanTotals(std::map<std::string, TraceSpanTotals> & totals);
+		/// Writes all recorded spans, ordered by thread and time, as a Chrome trace-event JSON file.
+		void writeChromeTrace(const std::string & filename);
+
+		/// The spans of one thread; used by Util::TraceScope to track the nesting depth.
+		struct ThreadBuffer {
+			std::vector<TraceEvent> events;
+			/// The index in events where the next span is stored.
+			size_t next;
+			/// True once events is full and older spans are being overwritten.
+			bool wrapped;
+			unsigned int threadIndex;
+			unsigned int depth;
+			/// True once the thread that recorded into it exited; the buffer is reused when it holds no spans.
+			bool released;
+		};
+		/// Returns the buffer of the calling thread; on the first call of the thread, reuses a released buffer or creates one.
+		ThreadBuffer * getThreadBuffer();
+		/// Called when a thread that has a buffer exits; the spans it recorded are kept.
+		void releaseThreadBuffer(ThreadBuffer * buffer);
+
+	protected:
+		TraceProfiler();
+		~TraceProfiler();
+
+		std::atomic<bool> _enabled;
+		std::atomic<unsigned int> _frameNumber;
+		unsigned int _eventsPerThread;
+
+		/// Discards all recorded spans; the caller holds _lock.
+		void _clearThreadBuffers();
+
+		/// Protects _threadBuffers, _internedNames, _numRecordings, and _pendingTraceFiles.
+		std::mutex _lock;
+		std::vector<ThreadBuffer*> _threadBuffers;
+		std::set<std::string> _internedNames;
+		/// The number of recordings started by beginRecording() that have not ended yet.
+		unsigned int _numRecordings;
+		/// The files to write the trace to when the last recording ends.
+		std::vector<std::string> _pendingTraceFiles;
+
+	private:
+		TraceProfiler(const TraceProfiler &);
+		TraceProfiler & operator=(const TraceProfiler &);
+	};
+
+
+	/**
+	 * @brief Records one span with the Util::TraceProfiler, from construction until destruction.
+	 *
+	 * Place an instance on the stack at the beginning of the block of code to be traced, like
+	 * Util::AutomaticFunctionProfiler.  Spans that are open at the same time on the same thread are nested.
+	 */
+	class UTIL_API TraceScope {
+	public:
+		/// name must remain valid until the trace is written; use string literals or TraceProfiler::internName().  Nothing is recorded if name is NULL.
+		TraceScope(const char * name) {
+			TraceProfiler * profiler = TraceProfiler::getInstance();
+			if ((name != NULL) && profiler->isEnabled()) {
+				_name = name;
+				_buffer = profiler->getThreadBuffer();
+				_buffer->depth++;
+				_startTick = getHighResCounterValue();
+			}
+			else {
+				_buffer = NULL;
+			}
+		}
+		~TraceScope() {
+			if (_buffer != NULL) {
+				unsigned long long endTick = getHighResCounterValue();
+				_buffer->depth--;
+				TraceProfiler::getInstance()->recordEvent(_name, _startTick, endTick, _buffer->depth);
+			}
+		}
+	private:
+		const char * _name;
+		TraceProfiler::ThreadBuffer * _buffer;
+		unsigned long long _startTick;
+	};
+
+} // end namespace Util
+
+#ifdef _WIN32
+#pragma warning( pop )
+#endif
+
+#endif
@@ -848,4 +848,459 @@ inline Matrix hilbert(size_t size) {
   return m;
 }
 
+/**
+ * A matrix whose dimensions are known at compile time.  Its elements are stored inside the object, so unlike Matrix,
+ * creating, copying and combining FixedMatrix values never allocates, and every loop has constant bounds that the
+ * compiler can unroll.  It is meant for small matrices such as the per agent states (position and velocity) of the
+ * Bayesian filters; use Matrix when the dimensions are only known at run time.
+ */
+template <size_t R, size_t C>
+class FixedMatrix {
+
+private:
+  double _elems[R * C];
+
+public:
+  // constructors; the elements of a default constructed matrix are undefined, as with Matrix
+  inline FixedMatrix() { }
+
+  // Copies the R x C block of q that starts at (row, column)
+  inline explicit FixedMatrix(const Matrix& q, size_t row = 0, size_t column = 0) {
+    assert(row + R <= q.numRows() && column + C <= q.numColumns());
+    for (size_t i = 0; i < R; ++i) {
+      for (size_t j = 0; j < C; ++j) {
+        (*this)(i, j) = q(row + i, column + j);
+      }
+    }
+  }
+
+  // Conversion to a run time sized matrix
+  inline Matrix toMatrix() const {
+    Matrix m(R, C);
+    insertInto(m, 0, 0);
+    return m;
+  }
+
+  // Copies this matrix into the block of q that starts at (row, column)
+  inline void insertInto(Matrix& q, size_t row = 0, size_t column = 0) const {
+    assert(row + R <= q.numRows() && column + C <= q.numColumns());
+    for (size_t i = 0; i < R; ++i) {
+      for (size_t j = 0; j < C; ++j) {
+        q(row + i, column + j) = (*this)(i, j);
+      }
+    }
+  }
+
+  // Submatrix
+  template <size_t R2, size_t C2>
+  inline FixedMatrix<R2, C2> subMatrix(size_t row, size_t column) const {
+    assert(row + R2 <= R && column + C2 <= C);
+    FixedMatrix<R2, C2> m;
+    for (size_t i = 0; i < R2; ++i) {
+      for (size_t j = 0; j < C2; ++j) {
+        m(i, j) = (*this)(row + i, column + j);
+      }
+    }
+    return m;
+  }
+
+  static inline FixedMatrix zeros() {
+    FixedMatrix m;
+    m.reset();
+    return m;
+  }
+
+  static inline FixedMatrix identity() {
+    FixedMatrix m;
+    for (size_t i = 0; i < R; ++i) {
+      for (size_t j = 0; j < C; ++j) {
+        m(i, j) = (i == j ? double(1) : double(0));
+      }
+    }
+    return m;
+  }
+
+  // Retrieval
+  inline size_t numRows() const {
+    return R;
+  }
+  inline size_t numColumns() const {
+    return C;
+  }
+
+  // Subscript operator
+  inline double& operator () (size_t row, size_t column) {
+    assert(row < R && column < C);
+    return _elems[row * C + column];
+  }
+  inline double  operator () (size_t row, size_t column) const {
+    assert(row < R && column < C);
+    return _elems[row * C + column];
+  }
+
+  inline double& operator [] (size_t elt) {
+    assert(elt < R * C);
+    return _elems[elt];
+  }
+  inline double  operator [] (size_t elt) const {
+    assert(elt < R * C);
+    return _elems[elt];
+  }
+
+  // Reset to zeros
+  inline void reset() {
+    for (size_t i = 0; i < R * C; ++i) {
+      _elems[i] = double(0);
+    }
+  }
+
+  // Unary minus
+  inline FixedMatrix operator-() const {
+    FixedMatrix m;
+    for (size_t i = 0; i < R * C; ++i) {
+      m._elems[i] = -_elems[i];
+    }
+    return m;
+  }
+
+  // Unary plus
+  inline const FixedMatrix& operator+() const {
+    return *this;
+  }
+
+  // Equality
+  inline bool operator==(const FixedMatrix& q) const {
+    for (size_t i = 0; i < R * C; ++i) {
+      if (_elems[i] != q._elems[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Inequality
+  inline bool operator!=(const FixedMatrix& q) const {
+    return !((*this) == q);
+  }
+
+  // Matrix addition
+  inline FixedMatrix operator+(const FixedMatrix& q) const {
+    FixedMatrix m;
+    for (size_t i = 0; i < R * C; ++i) {
+      m._elems[i] = _elems[i] + q._elems[i];
+    }
+    return m;
+  }
+  inline const FixedMatrix& operator+=(const FixedMatrix& q) {
+    for (size_t i = 0; i < R * C; ++i) {
+      _elems[i] += q._elems[i];
+    }
+    return *this;
+  }
+
+  // Matrix subtraction
+  inline FixedMatrix operator-(const FixedMatrix& q) const {
+    FixedMatrix m;
+    for (size_t i = 0; i < R * C; ++i) {
+      m._elems[i] = _elems[i] - q._elems[i];
+    }
+    return m;
+  }
+  inline const FixedMatrix& operator-=(const FixedMatrix& q) {
+    for (size_t i = 0; i < R * C; ++i) {
+      _elems[i] -= q._elems[i];
+    }
+    return *this;
+  }
+
+  // Scalar multiplication
+  inline FixedMatrix operator*(double a) const {
+    FixedMatrix m;
+    for (size_t i = 0; i < R * C; ++i) {
+      m._elems[i] = _elems[i] * a;
+    }
+    return m;
+  }
+  inline const FixedMatrix& operator*=(double a) {
+    for (size_t i = 0; i < R * C; ++i) {
+      _elems[i] *= a;
+    }
+    return *this;
+  }
+
+  // Scalar division
+  inline FixedMatrix operator/(double a) const {
+    FixedMatrix m;
+    for (size_t i = 0; i < R * C; ++i) {
+      m._elems[i] = _elems[i] / a;
+    }
+    return m;
+  }
+  inline const FixedMatrix& operator/=(double a) {
+    for (size_t i = 0; i < R * C; ++i) {
+      _elems[i] /= a;
+    }
+    return *this;
+  }
+
+  // Matrix multiplication
+  template <size_t C2>
+  inline FixedMatrix<R, C2> operator*(const FixedMatrix<C, C2>& q) const {
+    FixedMatrix<R, C2> m;
+    for (size_t i = 0; i < R; ++i) {
+      for (size_t j = 0; j < C2; ++j) {
+        double temp = double(0);
+        for (size_t k = 0; k < C; ++k) {
+          temp += (*this)(i, k) * q(k, j);
+        }
+        m(i, j) = temp;
+      }
+    }
+    return m;
+  }
+
+  inline const FixedMatrix& operator*=(const FixedMatrix<C, C>& q) {
+    return ((*this) = (*this) * q);
+  }
+
+  // Matrix transpose
+  inline FixedMatrix<C, R> operator~() const {
+    FixedMatrix<C, R> m;
+    for (size_t i = 0; i < C; ++i) {
+      for (size_t j = 0; j < R; ++j) {
+        m(i, j) = (*this)(j, i);
+      }
+    }
+    return m;
+  }
+
+  // Solve this*X=q for q (faster and more accurate than !this*q)
+  template <size_t C2>
+  inline FixedMatrix<R, C2> operator%(const FixedMatrix<R, C2>& q) const {
+    static_assert(R == C, "FixedMatrix::operator% needs a square matrix");
+    FixedMatrix m(*this);
+    FixedMatrix<R, C2> inv(q);
+
+    size_t row_p[R];
+    size_t col_p[R];
+    for (size_t i = 0; i < R; ++i) {
+      row_p[i] = i; col_p[i] = i;
+    }
+
+    // Gaussian elimination
+    for (size_t k = 0; k < R; ++k) {
+      // find maximal pivot element
+      double maximum = double(0); size_t max_row = k; size_t max_col = k;
+      for (size_t i = k; i < R; ++i) {
+        for (size_t j = k; j < R; ++j) {
+          double abs_ij = fabs(m(row_p[i], col_p[j]));
+          if (abs_ij > maximum) {
+            maximum = abs_ij; max_row = i; max_col = j;
+          }
+        }
+      }
+
+      assert(maximum != double(0));
+
+      // swap rows and columns
+      if (k != max_row) {
+        size_t swap = row_p[k]; row_p[k] = row_p[max_row]; row_p[max_row] = swap;
+      }
+      if (k != max_col) {
+        size_t swap = col_p[k]; col_p[k] = col_p[max_col]; col_p[max_col] = swap;
+      }
+
+      // eliminate column
+      for (size_t i = k + 1; i < R; ++i) {
+        double factor = m(row_p[i], col_p[k]) / m(row_p[k], col_p[k]);
+        for (size_t j = k + 1; j < R; ++j) {
+          m(row_p[i], col_p[j]) -= factor * m(row_p[k], col_p[j]);
+        }
+        for (size_t j = 0; j < C2; ++j) {
+          inv(row_p[i], j) -= factor * inv(row_p[k], j);
+        }
+      }
+    }
+
+    // Backward substitution
+    for (size_t k = R - 1;; --k) {
+      double quotient = m(row_p[k], col_p[k]);
+      for (size_t j = 0; j < C2; ++j) {
+        inv(row_p[k], j) /= quotient;
+      }
+
+      for (size_t i = 0; i < k; ++i) {
+        double factor = m(row_p[i], col_p[k]);
+        for (size_t j = 0; j < C2; ++j) {
+          inv(row_p[i], j) -= factor * inv(row_p[k], j);
+        }
+      }
+      if (k == 0)
+          break;
+    }
+
+    // reshuffle result
+    FixedMatrix<R, C2> result;
+    for (size_t i = 0; i < R; ++i) {
+      for (size_t j = 0; j < C2; ++j) {
+        result(col_p[i], j) = inv(row_p[i], j);
+      }
+    }
+    return result;
+  }
+
+  // Solve this=X*q for X (faster and more accurate than this*!q)
+  inline FixedMatrix operator/(const FixedMatrix<C, C>& q) const {
+    return ~(~q%~(*this));
+  }
+
+};
+
+// Scalar multiplication
+template <size_t R, size_t C>
+inline FixedMatrix<R, C> operator*(double a, const FixedMatrix<R, C>& q) { return q*a; }
+
+// Matrix inverse
+template <size_t N>
+inline FixedMatrix<N, N> operator!(const FixedMatrix<N, N>& q) {
+  return q % FixedMatrix<N, N>::identity();
+}
+
+// Matrix trace
+template <size_t N>
+inline double tr(const FixedMatrix<N, N>& q) {
+  double trace = double(0);
+  for (size_t i = 0; i < N; ++i) {
+    trace += q(i, i);
+  }
+  return trace;
+}
+
+// Element wise absolute value
+template <size_t R, size_t C>
+inline FixedMatrix<R, C> abs(const FixedMatrix<R, C>& q) {
+  FixedMatrix<R, C> m;
+  for (size_t i = 0; i < R * C; ++i) {
+    m[i] = fabs(q[i]);
+  }
+  return m;
+}
+
+// Matrix determinant
+template <size_t N>
+inline double det(const FixedMatrix<N, N>& q) {
+  FixedMatrix<N, N> m(q);
+  double D = double(1);
+
+  size_t row_p[N];
+  size_t col_p[N];
+  for (size_t i = 0; i < N; ++i) {
+    row_p[i] = i; col_p[i] = i;
+  }
+
+  // Gaussian elimination
+  for (size_t k = 0; k < N; ++k) {
+    // find maximal pivot element
+    double maximum = double(0); size_t max_row = k; size_t max_col = k;
+    for (size_t i = k; i < N; ++i) {
+      for (size_t j = k; j < N; ++j) {
+        double abs_ij = fabs(m(row_p[i], col_p[j]));
+        if (abs_ij > maximum) {
+          maximum = abs_ij; max_row = i; max_col = j;
+        }
+      }
+    }
+
+    // swap rows and columns
+    if (k != max_row) {
+      size_t swap = row_p[k]; row_p[k] = row_p[max_row]; row_p[max_row] = swap;
+      D = -D;
+    }
+    if (k != max_col) {
+      size_t swap = col_p[k]; col_p[k] = col_p[max_col]; col_p[max_col] = swap;
+      D = -D;
+    }
+
+    D *= m(row_p[k], col_p[k]);
+    if (D == double(0)) {
+      return double(0);
+    }
+
+    // eliminate column
+    for (size_t i = k + 1; i < N; ++i) {
+      double factor = m(row_p[i], col_p[k]) / m(row_p[k], col_p[k]);
+      for (size_t j = k + 1; j < N; ++j) {
+        m(row_p[i], col_p[j]) -= factor * m(row_p[k], col_p[j]);
+      }
+    }
+  }
+  return D;
+}
+
+// Eigen decomposition of a symmetric matrix, q = V*D*~V, with the same Jacobi rotations as jacobi(const Matrix&, ...)
+template <size_t N>
+inline void jacobi(const FixedMatrix<N, N>& q, FixedMatrix<N, N>& V, FixedMatrix<N, N>& D) {
+  D = q;
+  V = FixedMatrix<N, N>::identity();
+
+  while (true) {
+    double maximum = 0; size_t max_row = 0; size_t max_col = 0;
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = i + 1; j < N; ++j) {
+        if (fabs(D(i,j)) > maximum) {
+          maximum = fabs(D(i,j));
+          max_row = i;
+          max_col = j;
+        }
+      }
+    }
+
+    if (maximum <= DBL_EPSILON) {
+      break;
+    }
+
+    double theta = (D(max_col, max_col) - D(max_row, max_row)) / (2 * D(max_row, max_col));
+    double t = 1 / (fabs(theta) + sqrt(theta*theta+1));
+    if (theta < 0) t = -t;
+    double c = 1 / sqrt(t*t+1);
+    double s = c*t;
+
+    // update D //
+    double temp1 = c*c*D(max_row, max_row) + s*s*D(max_col, max_col) - 2*c*s*D(max_row, max_col);
+    double temp2 = s*s*D(max_row, max_row) + c*c*D(max_col, max_col) + 2*c*s*D(max_row, max_col);
+    D(max_row, max_col) = 0;
+    D(max_col, max_row) = 0;
+    D(max_row, max_row) = temp1;
+    D(max_col, max_col) = temp2;
+    for (size_t j = 0; j < N; ++j) {
+      if ((j != max_row) && (j != max_col)) {
+        temp1 = c * D(j, max_row) - s * D(j, max_col);
+        temp2 = c * D(j, max_col) + s * D(j, max_row);
+        D(j, max_row) = (D(max_row, j) = temp1);
+        D(j, max_col) = (D(max_col, j) = temp2);
+      }
+    }
+
+    // V = V * R, where R is the identity except for the rotation of max_row and max_col; only those two columns change
+    for (size_t i = 0; i < N; ++i) {
+      double vr = V(i, max_row);
+      double vc = V(i, max_col);
+      V(i, max_row) = vr * c - vc * s;
+      V(i, max_col) = vr * s + vc * c;
+    }
+  }
+}
+
+// Output stream
+template <size_t R, size_t C>
+inline std::ostream& operator<<(std::ostream& os, const FixedMatrix<R, C>& q) {
+  for (size_t i = 0; i < R; ++i) {
+    for (size_t j = 0; j < C; ++j) {
+      os << q(i,j) << "\t";
+    }
+    os << std::endl;
+  }
+  return os;
+}
+
 #endif
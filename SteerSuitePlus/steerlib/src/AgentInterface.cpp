@@ -253,6 +253,17 @@ std::vector<std::pair<float, Util::Point>> AgentInterface::getPositionList() {
 	return _positionList;
 }
 
+void AgentInterface::_recordPosition(SteerLib::EngineInterface * engineInfo, float time, const Util::Point & position)
+{
+	SteerLib::TrajectorySink * sink = engineInfo->getTrajectorySink();
+	if (sink->isOpen()) {
+		sink->addPosition(this, time, position);
+	}
+	else {
+		_positionList.push_back(std::pair<float, Util::Point>(time, position));
+	}
+}
+
 void AgentInterface::draw()
 {
 #ifdef ENABLE_GUI
@@ -345,3 +356,80 @@ void AgentInterface::draw()
 	}
 #endif
 }
+
+void AgentInterface::saveState(SteerLib::CheckpointWriter & out)
+{
+	out.write(_enabled);
+	out.write(_position);
+	out.write(_velocity);
+	out.write(_forward);
+	out.write(_prefVelocity);
+	out.write(_newVelocity);
+	out.write(_color);
+	out.write(_radius);
+	out.write(_id);
+
+	// only the length of the trajectory; positions are never changed once recorded, so restoring just cuts off the rest.
+	out.write<unsigned int>((unsigned int)_positionList.size());
+
+	out.writeSequence(_waypoints);
+	out.writeSequence(_midTermPath);
+	out.write(_currentLocalTarget);
+	out.writeGoal(_currentGoal);
+
+	std::queue<SteerLib::AgentGoalInfo> goals(_goalQueue);
+	out.write<unsigned int>((unsigned int)goals.size());
+	while (!goals.empty()) {
+		out.writeGoal(goals.front());
+		goals.pop();
+	}
+}
+
+void AgentInterface::restoreState(SteerLib::CheckpointReader & in)
+{
+	bool wasEnabled = _enabled;
+	Util::AxisAlignedBox oldBounds(_position.x-_radius, _position.x+_radius, 0.0f, 0.0f, _position.z-_radius, _position.z+_radius);
+
+	in.read(_enabled);
+	in.read(_position);
+	in.read(_velocity);
+	in.read(_forward);
+	in.read(_prefVelocity);
+	in.read(_newVelocity);
+	in.read(_color);
+	in.read(_radius);
+	in.read(_id);
+
+	unsigned int numPositions = in.read<unsigned int>();
+	if (_positionList.size() > numPositions) {
+		_positionList.resize(numPositions);
+	}
+
+	in.readSequence(_waypoints);
+	in.readSequence(_midTermPath);
+	in.read(_currentLocalTarget);
+	in.readGoal(_currentGoal);
+
+	while (!_goalQueue.empty()) {
+		_goalQueue.pop();
+	}
+	unsigned int numGoals = in.read<unsigned int>();
+	for (unsigned int i = 0; i < numGoals; i++) {
+		SteerLib::AgentGoalInfo goal;
+		in.readGoal(goal);
+		_goalQueue.push(goal);
+	}
+
+	// keep the spatial database consistent with the restored position; disabled agents are not in the database.
+	Util::AxisAlignedBox newBounds(_position.x-_radius, _position.x+_radius, 0.0f, 0.0f, _position.z-_radius, _position.z+_radius);
+	SteerLib::SpatialDataBaseInterface * spatialDatabase = getSimulationEngine()->getSpatialDatabase();
+	if (wasEnabled && _enabled) {
+		spatialDatabase->updateObject(this, oldBounds, newBounds);
+	}
+	else if (wasEnabled) {
+		spatialDatabase->removeObject(this, oldBounds);
+	}
+	else if (_enabled) {
+		spatialDatabase->addObject(this, newBounds);
+	}
+}
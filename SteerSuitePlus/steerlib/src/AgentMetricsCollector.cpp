@@ -15,7 +15,7 @@
 #include <iostream>
 #include <iomanip>
 
-//#include <algorithm>
+#include <algorithm>
 //#include <string>
 
 // this causes linker error in hammerhead 
@@ -52,6 +52,7 @@ void AgentMetricsCollector::reset()
 	// initialize collision stats and metrics
 	_currentCollidingObjects.clear();
 	_pastCollisions.clear();
+	_thresholdedCollisionCounts.clear();
 	_metrics.reset();
 }
 
@@ -129,10 +130,16 @@ void AgentMetrics::reset()
 }
 
 
+/// Returns true if the collision is greater than both thresholds.
+static inline bool isAboveThresholds(const CollisionInfo & collision, float penetrationThreshold, float timeDurationThreshold)
+{
+	return (collision.maxPenetration > penetrationThreshold) && (collision.timeDuration > timeDurationThreshold);
+}
+
+
 unsigned int AgentMetricsCollector::getNumThresholdedCollisions(float penetrationThreshold, float timeDurationThreshold)
 {
 	assert(_metrics.numUniqueCollisions == _pastCollisions.size()+_currentCollidingObjects.size());
-	unsigned int numThresholdedCollisions = 0;
 
 	// if there is no thresholding, its OK to just return the total number of unique collisions.
 	if (penetrationThreshold <= 0.0f && timeDurationThreshold <= 0.0f) {
@@ -140,15 +147,34 @@ unsigned int AgentMetricsCollector::getNumThresholdedCollisions(float penetratio
 		return _metrics.numUniqueCollisions;
 	}
 
-	// otherwise, go through the entire history of collisions.
-	for (unsigned int i=0; i<_pastCollisions.size(); i++) {
-		if ((_pastCollisions[i].maxPenetration > penetrationThreshold) && (_pastCollisions[i].timeDuration > timeDurationThreshold)) {
-			numThresholdedCollisions++;
+	// past collisions never change, so their count is kept incrementally for each pair of thresholds that was asked for.
+	// the first time a pair of thresholds is requested, count the existing history once.
+	unsigned int numThresholdedCollisions = 0;
+	unsigned int countIndex;
+	for (countIndex=0; countIndex < _thresholdedCollisionCounts.size(); countIndex++) {
+		if ((_thresholdedCollisionCounts[countIndex].penetrationThreshold == penetrationThreshold) && (_thresholdedCollisionCounts[countIndex].timeDurationThreshold == timeDurationThreshold)) {
+			break;
 		}
 	}
 
+	if (countIndex == _thresholdedCollisionCounts.size()) {
+		ThresholdedCollisionCount newCount;
+		newCount.penetrationThreshold = penetrationThreshold;
+		newCount.timeDurationThreshold = timeDurationThreshold;
+		newCount.numPastCollisions = 0;
+		for (unsigned int i=0; i<_pastCollisions.size(); i++) {
+			if (isAboveThresholds(_pastCollisions[i], penetrationThreshold, timeDurationThreshold)) {
+				newCount.numPastCollisions++;
+			}
+		}
+		_thresholdedCollisionCounts.push_back(newCount);
+	}
+
+	numThresholdedCollisions = _thresholdedCollisionCounts[countIndex].numPastCollisions;
+
+	// current collisions are still changing, so they are always checked.
 	for (unsigned int i=0; i<_currentCollidingObjects.size(); i++) {
-		if ((_currentCollidingObjects[i].maxPenetration > penetrationThreshold) && (_currentCollidingObjects[i].timeDuration > timeDurationThreshold)) {
+		if (isAboveThresholds(_currentCollidingObjects[i], penetrationThreshold, timeDurationThreshold)) {
 			numThresholdedCollisions++;
 		}
 	}
@@ -157,8 +183,36 @@ unsigned int AgentMetricsCollector::getNumThresholdedCollisions(float penetratio
 }
 
 
+/// Orders a CollisionInfo by its collision key, for the binary search in _findCurrentCollision().
+static inline bool hasSmallerCollisionKey(const CollisionInfo & collision, uintptr_t collisionKey)
+{
+	return collision.collisionKey < collisionKey;
+}
+
+
+std::vector<CollisionInfo>::iterator AgentMetricsCollector::_findCurrentCollision(uintptr_t collisionKey)
+{
+	return std::lower_bound(_currentCollidingObjects.begin(), _currentCollidingObjects.end(), collisionKey, hasSmallerCollisionKey);
+}
+
+
+void AgentMetricsCollector::_recordPastCollision(const CollisionInfo & oldCollision)
+{
+	_pastCollisions.push_back(oldCollision);
+
+	for (unsigned int i=0; i < _thresholdedCollisionCounts.size(); i++) {
+		if (isAboveThresholds(oldCollision, _thresholdedCollisionCounts[i].penetrationThreshold, _thresholdedCollisionCounts[i].timeDurationThreshold)) {
+			_thresholdedCollisionCounts[i].numPastCollisions++;
+		}
+	}
+}
+
+
 void AgentMetricsCollector::_checkAndUpdateOneCollision(uintptr_t collisionKey, float penetration, float currentTimeStamp)
 {
+	std::vector<CollisionInfo>::iterator collision = _findCurrentCollision(collisionKey);
+	bool alreadyColliding = (collision != _currentCollidingObjects.end()) && (collision->collisionKey == collisionKey);
+
 	if (penetration > 0.0f + COLLISION_EPSILON )
 	{
 		_metrics.collisionScore++;
@@ -166,7 +220,7 @@ void AgentMetricsCollector::_checkAndUpdateOneCollision(uintptr_t collisionKey,
 #ifdef _DEBUG_1
 			std::cout << "Collision: " << std::endl;
 #endif
-		if (_currentCollidingObjects.find(collisionKey) == _currentCollidingObjects.end()){
+		if (!alreadyColliding){
 			//
 			// existing collision with this object not found, so it is a new collision
 			//
@@ -176,17 +230,17 @@ void AgentMetricsCollector::_checkAndUpdateOneCollision(uintptr_t collisionKey,
 			newCollision.startTime = currentTimeStamp;
 			newCollision.endTime = currentTimeStamp;
 			newCollision.timeDuration = 0.0f;
-			// the [] operator actually inserts the new collisionInfo using key collisionKey, because it is not found.  (see STL map documentation)
-			_currentCollidingObjects[collisionKey] = newCollision;
+			// insert at the position found by the search, which keeps the vector sorted.
+			_currentCollidingObjects.insert(collision, newCollision);
 			_metrics.numUniqueCollisions++;
 		}
 		else {
 			//
 			// update the existing collision
 			//
-			_currentCollidingObjects[collisionKey].maxPenetration = max(_currentCollidingObjects[collisionKey].maxPenetration, penetration);
-			_currentCollidingObjects[collisionKey].endTime = currentTimeStamp;
-			_currentCollidingObjects[collisionKey].timeDuration = _currentCollidingObjects[collisionKey].endTime - _currentCollidingObjects[collisionKey].startTime;
+			collision->maxPenetration = max(collision->maxPenetration, penetration);
+			collision->endTime = currentTimeStamp;
+			collision->timeDuration = collision->endTime - collision->startTime;
 		}
 		float e_c = 10; // J / (Kg * m * s)
 		_metrics._totalPenetration += ( penetration * e_c );
@@ -198,12 +252,12 @@ void AgentMetricsCollector::_checkAndUpdateOneCollision(uintptr_t collisionKey,
 		// 
 		// at the same time, update the agent's stats on max penetration and max time duration
 		//
-		if (_currentCollidingObjects.find(collisionKey) != _currentCollidingObjects.end()){
-			CollisionInfo oldCollision = _currentCollidingObjects[collisionKey];
-			_currentCollidingObjects.erase(collisionKey);
+		if (alreadyColliding){
+			CollisionInfo oldCollision = *collision;
+			_currentCollidingObjects.erase(collision);
 			oldCollision.endTime = currentTimeStamp;
 			oldCollision.timeDuration = oldCollision.endTime - oldCollision.startTime;
-			_pastCollisions.push_back(oldCollision);
+			_recordPastCollision(oldCollision);
 
 			if (_metrics.maxCollisionPenetration < oldCollision.maxPenetration) _metrics.maxCollisionPenetration = oldCollision.maxPenetration;
 			if (_metrics.maxTimeSpentInCollision < oldCollision.timeDuration) _metrics.maxTimeSpentInCollision = oldCollision.timeDuration;
@@ -220,12 +274,11 @@ void AgentMetricsCollector::_updateCollisionStats(SpatialDataBaseInterface * gri
 	// when analyzing a recording, the spatial database will be populated with AgentMetricsCollector objects instead of agents.
 	//
 
-	std::set<SpatialDatabaseItemPtr> neighbors;
-	std::set<SpatialDatabaseItemPtr>::iterator neighbor;
-	gridDB->getItemsInRange(neighbors, _currentPosition.x - _agentBeingAnalyzed->radius(), _currentPosition.x + _agentBeingAnalyzed->radius(), _currentPosition.z - _agentBeingAnalyzed->radius(), _currentPosition.z + _agentBeingAnalyzed->radius(), updatedAgent);
+	std::vector<SpatialDatabaseItemPtr>::iterator neighbor;
+	gridDB->getItemsInRange(_neighbors, _currentPosition.x - _agentBeingAnalyzed->radius(), _currentPosition.x + _agentBeingAnalyzed->radius(), _currentPosition.z - _agentBeingAnalyzed->radius(), _currentPosition.z + _agentBeingAnalyzed->radius(), updatedAgent);
 
 
-	for (neighbor = neighbors.begin(); neighbor != neighbors.end(); ++neighbor) {
+	for (neighbor = _neighbors.begin(); neighbor != _neighbors.end(); ++neighbor) {
 		
 		// this way, collisionKey will be unique across all objects in the spatial database.
 
@@ -27,7 +27,7 @@ using namespace Util;
 
 // TODO: this is not used anymore??
 
-BenchmarkEngine::BenchmarkEngine(const std::string & recordingFilename, BenchmarkTechniqueInterface * benchmarkTechnique)
+BenchmarkEngine::BenchmarkEngine(const std::string & recordingFilename, BenchmarkTechniqueInterface * benchmarkTechnique, unsigned int numMetricsThreads)
 {
 	_currentFrameNumber = 0;
 	_done = false;
@@ -41,19 +41,10 @@ BenchmarkEngine::BenchmarkEngine(const std::string & recordingFilename, Benchmar
 
 	// allocate agents
 	_agents.clear();
-	for (unsigned int i=0; i < _recFileReader->getNumAgents(); i++) {
+	RecFileFrameView firstFrame = _recFileReader->getFrameView(0);
+	for (unsigned int i=0; i < firstFrame.numAgents; i++) {
 		BenchmarkAgent * newAgent = new BenchmarkAgent();
-
-		/// @todo
-		///   The next version of the RecFileReader should also return an AgentGoalInfo struct, and this indirection should be unnecessary.
-		AgentGoalInfo newGoal;
-		newGoal.targetLocation = _recFileReader->getAgentGoalAtFrame(i,0);
-
-		newAgent->setEnabled(_recFileReader->isAgentEnabledAtFrame(i,0));
-		newAgent->setPosition(_recFileReader->getAgentLocationAtFrame(i,0));
-		newAgent->setForward(_recFileReader->getAgentOrientationAtFrame(i,0));
-		newAgent->setRadius(_recFileReader->getAgentRadiusAtFrame(i,0));
-		newAgent->setCurrentGoal(newGoal);
+		newAgent->setFromRecFileInfo(firstFrame[i]);
 		_spatialDatabase->addObject(newAgent, newAgent->getBounds());
 		_agents.push_back(newAgent);
 	}
@@ -67,13 +58,32 @@ BenchmarkEngine::BenchmarkEngine(const std::string & recordingFilename, Benchmar
 	}
 
 	// allocate and initialize the metrics collector
-	_simulationMetricsCollector = new SimulationMetricsCollector( _agents);
+	_simulationMetricsCollector = new SimulationMetricsCollector( _agents, numMetricsThreads);
 
 	_benchmarkTechnique = benchmarkTechnique;
 	_benchmarkTechnique->init();
 
 }
 
+BenchmarkEngine::~BenchmarkEngine()
+{
+	delete _simulationMetricsCollector;
+
+	for (unsigned int i=0; i < _agents.size(); i++) {
+		delete _agents[i];
+	}
+	_agents.clear();
+
+	for (unsigned int i=0; i < _obstacles.size(); i++) {
+		delete _obstacles[i];
+	}
+	_obstacles.clear();
+
+	delete _spatialDatabase;
+
+	delete _recFileReader;
+}
+
 bool BenchmarkEngine::isValidTestCaseSimulation(const std::string & testCaseDirectory)
 {
 	throw GenericException("validating rec files against test cases not implemented yet.");
@@ -91,20 +101,11 @@ void BenchmarkEngine::stepOneFrame()
 	}
 
 	// 1. update all AgentInterface dummies and the spatial database based on the rec file
-	for (unsigned int i=0; i < _recFileReader->getNumAgents(); i++) {
-		BenchmarkAgent * agent = dynamic_cast<BenchmarkAgent*>(_agents[i]);
-
-		/// @todo
-		///   The next version of the RecFileReader should also return an AgentGoalInfo struct, and this indirection should be unnecessary.
-		AgentGoalInfo newGoal;
-		newGoal.targetLocation = _recFileReader->getAgentGoalAtFrame(i,_currentFrameNumber);
-
+	RecFileFrameView frame = _recFileReader->getFrameView(_currentFrameNumber);
+	for (unsigned int i=0; i < frame.numAgents; i++) {
+		BenchmarkAgent * agent = static_cast<BenchmarkAgent*>(_agents[i]);
 		AxisAlignedBox oldBounds = agent->getBounds();
-		agent->setEnabled(_recFileReader->isAgentEnabledAtFrame(i,_currentFrameNumber));
-		agent->setPosition(_recFileReader->getAgentLocationAtFrame(i,_currentFrameNumber));
-		agent->setForward(_recFileReader->getAgentOrientationAtFrame(i,_currentFrameNumber));
-		agent->setRadius(_recFileReader->getAgentRadiusAtFrame(i,_currentFrameNumber));
-		agent->setCurrentGoal(newGoal);
+		agent->setFromRecFileInfo(frame[i]);
 		_spatialDatabase->updateObject(agent, oldBounds, agent->getBounds());
 	}
 
@@ -136,6 +137,12 @@ void BenchmarkEngine::printTotalScoreDetails(std::ostream & out)
 	_benchmarkTechnique->printTotalScoreDetails(_simulationMetricsCollector, out);
 }
 
+void BenchmarkEngine::printTotalScoreCSV(std::ostream & out)
+{
+	// ask the benchmark technique to do this
+	_benchmarkTechnique->printTotalScoreCSV(_simulationMetricsCollector, out);
+}
+
 void BenchmarkEngine::printAgentScoreDetails(unsigned int agentIndex, std::ostream & out)
 {
 	// ask the benchmark technique to do this
@@ -16,6 +16,7 @@
 #include "util/HighResCounter.h"
 #include "util/Misc.h"
 #include "simulation/Clock.h"
+#include "simulation/SimulationCheckpoint.h"
 
 using namespace SteerLib;
 using namespace Util;
@@ -139,6 +140,31 @@ void Clock::setClockMode(ClockModeEnum clockMode, float fixedFps, float minSimul
 }
 
 
+void Clock::saveState(SteerLib::CheckpointWriter & out)
+{
+	out.write(Util::getHighResCounterFrequency());
+	out.write(_simulationFrameNumber);
+	out.write(_totalSimulationTime);
+	out.write(_simulationDt);
+}
+
+
+void Clock::restoreState(SteerLib::CheckpointReader & in)
+{
+	unsigned long long frequency = in.read<unsigned long long>();
+	in.read(_simulationFrameNumber);
+	in.read(_totalSimulationTime);
+	in.read(_simulationDt);
+
+	// checkpoints written to a file may come from a machine with a different counter frequency.
+	if (frequency != Util::getHighResCounterFrequency()) {
+		double scale = (double)Util::getHighResCounterFrequency() / (double)frequency;
+		_totalSimulationTime = (unsigned long long)((double)_totalSimulationTime * scale);
+		_simulationDt = (unsigned long long)((double)_simulationDt * scale);
+	}
+}
+
+
 void Clock::_updateFpsMeasurement()
 {
 	if(_realDt > 0.f)
@@ -51,6 +51,14 @@ void CompositeBenchmarkTechnique01::printTotalScoreDetails(SimulationMetricsColl
 
 }
 
+void CompositeBenchmarkTechnique01::printTotalScoreCSV(SimulationMetricsCollector * simulationMetrics, std::ostream & out) {
+
+	_computeTotalBenchmarkScore(simulationMetrics);
+
+	// columns: num agents, avg. collisions, avg. time, avg. energy, final score
+	out << (unsigned int)_numAgents << "," << _numCollisionsOfAllAgents / _numAgents << "," << _totalTimeOfAllAgents / _numAgents << "," << _totalEnergyOfAllAgents / _numAgents << "," << _totalBenchmarkScore << "\n";
+}
+
 void CompositeBenchmarkTechnique01::printAgentScoreDetails(unsigned int agentIndex, SimulationMetricsCollector * simulationMetrics, std::ostream & out) {
 
 	float score = getAgentBenchmarkScore(agentIndex,simulationMetrics);
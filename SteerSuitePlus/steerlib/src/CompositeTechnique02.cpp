@@ -50,6 +50,14 @@ void CompositeBenchmarkTechnique02::printTotalScoreDetails(SimulationMetricsColl
 
 }
 
+void CompositeBenchmarkTechnique02::printTotalScoreCSV(SimulationMetricsCollector * simulationMetrics, std::ostream & out) {
+
+	_computeTotalBenchmarkScore(simulationMetrics);
+
+	// columns: num agents, avg. collisions, avg. time, avg. energy, avg. sum of instantaneous accelerations, final score
+	out << (unsigned int)_numAgents << "," << _numCollisionsOfAllAgents / _numAgents << "," << _totalTimeOfAllAgents / _numAgents << "," << _totalEnergyOfAllAgents / _numAgents << "," << _totalInstantaneousAcceleration / _numAgents << "," << _totalBenchmarkScore << "\n";
+}
+
 void CompositeBenchmarkTechnique02::printAgentScoreDetails(unsigned int agentIndex, SimulationMetricsCollector * simulationMetrics, std::ostream & out) {
 
 	float score = getAgentBenchmarkScore(agentIndex,simulationMetrics);
@@ -24,6 +24,7 @@
 
 
 #include <fstream>
+#include <algorithm>
 
 // #define _DEBUG_ENTROPY 1
 
@@ -61,6 +62,12 @@ void CompositeTechniqueEntropy::init()
 	// FOr now this need to be set so that vectors can be resized.
 	_numAgt = 0; // scalling down for quicker testing turn around
 	_estimationDone = 0;
+	_entropyResult = 0.0;
+	_numEstimatedSteps = 0;
+	_ensemble.clear();
+	_nextEstimationStep = 0;
+	_numEstimationSteps = 0;
+	_estimationStepsPerFrame = 1;
 	// _agentStartFrame.resize(_numAgt);
 
 	// real world data is in cm
@@ -132,6 +139,10 @@ void CompositeTechniqueEntropy::init( const SteerLib::OptionDictionary & options
 			_numSamples = atoi((*optionIter).second.c_str());
 			std::cout << "Number of samples has been set to " << _numSamples << std::endl;
 		}
+		else if ( (*optionIter).first == "estimationStepsPerFrame")
+		{
+			_estimationStepsPerFrame = atoi((*optionIter).second.c_str());
+		}
 		else if ( (*optionIter).first == "replayData")
 		{
 
@@ -294,60 +305,54 @@ int CompositeTechniqueEntropy::readNoisyData2(std::string fileName)
  *
  * similar to maximize multiprocess scheduling but we know more information about
  * the time of each process
- * for each timestep
- *
- * Create a matrix  Mt timesteps x timestepsahead where
- *
- * Mt[i][j] = sum of agents active from i to i+j
  *
- * The maximal item row will be the start frame for best data and the maximal
- * item column will be the time length from i.
+ * The data set is _perferedNumFrames long, so only its start frame is chosen: the
+ * first frame i for which the most agents are active from i to i+_perferedNumFrames.
  */
 void CompositeTechniqueEntropy::selectGoodData(unsigned int maxFrameNumber)
 {
 
 	// real max is 1017 and min is 43
 	std::cout << "max frame number is " << maxFrameNumber << std::endl;
-	std::vector<std::vector<unsigned int> > dataSums;
-	unsigned int timestart = 0, timestop = 0, maxsum = 0;
+	unsigned int timestart = 0, timestop = 0, maxCount = 0;
 
-	dataSums.resize(maxFrameNumber);
-	for (int i = 1; i < maxFrameNumber; i++ )
+	// Select the window of frames [i, i+_perferedNumFrames] (with 1 <= i and i+_perferedNumFrames < maxFrameNumber) that
+	// the most agents are active for; an agent counts if it started at or before frame i and is still active at frame
+	// i+_perferedNumFrames.  So agent a counts for all windows that start in [_agentStartFrame[a], end of a - _perferedNumFrames];
+	// add those ranges to a difference array, then one pass over the frames finds the first window with the most agents.
+	if (_perferedNumFrames + 1 < maxFrameNumber)
 	{
-		// calculate sum of agents active from i to i+j
-		for (int j = i; j < maxFrameNumber; j++)
+		unsigned int lastWindowStart = maxFrameNumber - 1 - _perferedNumFrames;
+		std::vector<int> countChanges(lastWindowStart + 2, 0);
+		for (int a = 0; a < _numAgt; a++)
 		{
-			unsigned int sum = 0, acount = 0;
-			for ( int a = 0; a < _numAgt; a++)
+			size_t agentEndFrame = _posData[a].size() + _agentStartFrame[a];
+			if (agentEndFrame < _perferedNumFrames)
 			{
-				// is agent active at start           agent still active at end
-				if ( (i >= _agentStartFrame[a]) && ((j) <= (_posData[a].size()+_agentStartFrame[a])) )
-				{
-					sum = sum + ((j - i)+1);
-					// Keeps track of the number of agents in the simulation
-					acount = acount + 1;
-				}
+				continue;
 			}
-			// if ( (sum > maxsum) && (acount > 14) ) // agent min
-			// if ( ((sum > maxsum) && (j-i == _perferedNumFrames )) && (acount == _perferedNumAgents) ) // time min 3s
-			if ( ((sum > maxsum) && (j-i == _perferedNumFrames )))// && (acount == _perferedNumAgents) ) // time min 3s
+			size_t first = std::max(_agentStartFrame[a], 1u);
+			size_t last = std::min(agentEndFrame - _perferedNumFrames, (size_t)lastWindowStart);
+			if (first <= last)
 			{
-				// std::cout << "There are " << acount << " agent in this max" << std::endl;
-				maxsum = sum;
+				countChanges[first]++;
+				countChanges[last + 1]--;
+			}
+		}
+
+		int count = 0;
+		for (unsigned int i = 1; i <= lastWindowStart; i++)
+		{
+			count += countChanges[i];
+			if ((unsigned int)count > maxCount)
+			{
+				maxCount = count;
 				timestart = i;
-				timestop = j;
+				timestop = i + _perferedNumFrames;
 			}
-			acount = 0;
-			dataSums[i].push_back(sum);
 		}
 	}
 
-	/*
-	for (int p = 0; p < dataSums.size(); p++)
-	{
-		std::cout << "dataSums[" << p << "].size() is = " << dataSums[p].size() << std::endl;
-	}*/
-
 	/*
 	 * Reallocate timestep data according to best data subset
 	 */
@@ -407,6 +412,16 @@ void CompositeTechniqueEntropy::selectGoodData(unsigned int maxFrameNumber)
 
 
 void CompositeTechniqueEntropy::performEstimation()
+{
+	_beginEstimation();
+	while (_nextEstimationStep < _numEstimationSteps)
+	{
+		_estimateNextStep();
+	}
+	_endEstimation();
+}
+
+void CompositeTechniqueEntropy::_beginEstimation()
 {
 
 	//std::cout << "number of agents in the simulation " << this->getEngineInterface()->getAgents().size() <<
@@ -453,12 +468,10 @@ void CompositeTechniqueEntropy::performEstimation()
 	Matrix xHat = zeros(X_DIM);
 
 
-	Matrix z = zeros(Z_DIM);
-	Matrix u = zeros(U_DIM);
-
-	std::vector<Matrix> X(_numSamples);
+	std::vector<Matrix> & X = _ensemble;
+	X.resize(_numSamples);
 
-	M = m_identity(M_DIM);
+	M = AgentCovariance::identity();
 
 	m_initGuess(Sigma,xHat);
 
@@ -495,197 +508,158 @@ void CompositeTechniqueEntropy::performEstimation()
 		X[i] = zeros(X_DIM);
 		for (int a = 0; a < _numAgt; a++) // for each agent
 		{
-			Matrix sampx  = Util::sampleGaussian(xHat.subMatrix(a*sx,0,sx,1), M);
+			AgentState sampx  = Util::sampleGaussian(AgentState(xHat, a*sx, 0), M);
 			// Matrix sampx  = sampleGaussian(xHat.subMatrix(a*sx,0,a*sx,1), M);
-			for (int z = 0; z < sx; z++)// for each data dimension p_x, p_z, v_x, v_z
-			{
-				X[i][a*sx+z] = sampx[z];
-			}
+			sampx.insertInto(X[i], a*sx, 0); // for each data dimension p_x, p_z, v_x, v_z
 		}
 	}
 
 	/*
 	 * Now run the EM-algorithm to estimate X (the true state) from
 	 * Z (the noisy input data)
+	 *
+	 * The model error is accumulated as each new ensemble is estimated, comparing it against the
+	 * simulation step of the previous ensemble.  Only the previous ensemble and running sums are kept,
+	 * so memory does not grow with the number of frames, and the entropy is available after every step.
 	 */
-	// std::vector<std::vector<Matrix> > Xs;
-	size_t ses = _posData[0].size();
-	// int ses = 4;
-	for (size_t s = 1; s < ses; s++)
-	{ //for each timestep we compute an X
-		for (size_t a = 0; a < _numAgt; a++)
-		{
-			z[2*a+0] = _posData[a][s].x;
-			z[2*a+1] = _posData[a][s].y;
-		}
-		curStep = s;
-		if (s == 26)
-			s = 26;
-		std::cout << "Calling Kalman filter, timestep: " << s << std::endl;
-		// std::cout << "M_DIM: " << M_DIM << " N_DIM: " << N_DIM << std::endl;
-		// std::cout << "z: " << z << std::endl;
-		/*
-		 *
-		 */
-		// std::cout << "number of agents in the simulation " << this->getEngineInterface()->getAgents().size() <<
-			//		" number of agents from the data " << _posData.size() << std::endl;
-		Util::ensembleKalmanFilter(X, u, z,  M_DIM, this, N_DIM, this); ////
-		// ensembleKalmanFilter(X, u, z,  M_DIM, [=](int v){return this->m_fHat;}, N_DIM, &CompositeTechniqueEntropy::h); ////
-		// this->getEngineInterface()->getSpatialDatabase()->getItemsInRange(neighborList, -30.0f, 30, -30, 30, NULL);
-		// std::cout << "agents left in database: " << neighborList.size() << std::endl;
-		xHat = zeros(X_DIM);
-		for (size_t i = 0; i < X.size(); ++i)
-		{
-			xHat += X[i] / X.size();
-		}
-		_xHats.push_back(xHat);
-		Xs.push_back(X);
+	_numEstimationSteps = _posData[0].size();
+	_nextEstimationStep = 1;
+	_beginModelError();
+}
+
+void CompositeTechniqueEntropy::_estimateNextStep()
+{
+	std::vector<Matrix> & X = _ensemble;
+	Matrix z = zeros(Z_DIM);
+	Matrix u = zeros(U_DIM);
+	size_t s = _nextEstimationStep++;
+
+	//for each timestep we compute an X
+	for (size_t a = 0; a < _numAgt; a++)
+	{
+		z[2*a+0] = _posData[a][s].x;
+		z[2*a+1] = _posData[a][s].y;
+	}
+	curStep = s;
+	std::cout << "Calling Kalman filter, timestep: " << s << std::endl;
+	// std::cout << "M_DIM: " << M_DIM << " N_DIM: " << N_DIM << std::endl;
+	// std::cout << "z: " << z << std::endl;
+	Util::ensembleKalmanFilter(X, u, z,  M_DIM, this, N_DIM, this); ////
+	// ensembleKalmanFilter(X, u, z,  M_DIM, [=](int v){return this->m_fHat;}, N_DIM, &CompositeTechniqueEntropy::h); ////
+	Matrix xHat = zeros(X_DIM);
+	for (size_t i = 0; i < X.size(); ++i)
+	{
+		xHat += X[i] / X.size();
 	}
-	xHat = zeros(X_DIM);
+	_accumulateModelError(X, xHat);
+	_entropyResult = _computeEntropy();
+}
+
+void CompositeTechniqueEntropy::_endEstimation()
+{
+	std::vector<Matrix> & X = _ensemble;
+	Matrix xHat = zeros(X_DIM);
 	for (size_t i = 0; i < X.size(); ++i)
 	{
 		xHat += X[i] / X.size();
 	}
-	Sigma = zeros(X_DIM,X_DIM);
+	Matrix Sigma = zeros(X_DIM,X_DIM);
 	for (size_t i = 0; i < X.size(); ++i)
 	{
 		Sigma += (X[i] - xHat)*~(X[i] - xHat) / X.size();
 	}
 
-	// std::cout << "Ensemble Kalman Filter size: " << xHat.numColumns()*xHat.numRows() <<  std::endl << ~xHat << std::endl;
-	// std::cout << "Sigma: " << std::endl << ~Sigma << std::endl;
-	// std::cout << "Length of a sample: " <<  ((Xs[0][0]).numRows() * (Xs[0][0]).numColumns())  << std::endl;
-	// std::cout << "Xs[0][0]: " << ~(Xs[0][0]) << std::endl;
-	// std::cout << "Xs[0][numsamples]: " << ~(Xs[0][_numSamples-1]) << std::endl;
-	// int tsSize = ((Xs[0][0]).numRows() * (Xs[0][0]).numColumns());
-
-
 	float pos_dist_agents = 0;
 	float vel_diff_agents = 0;
 	for ( size_t agent = 0; agent < _posData.size(); agent++)
 	{
-		float distance = 0;
-		float distance2 = 0;
-		float pos_dist = 0;
-		float vel_diff = 0;
-		for (size_t ts = 0; ts < _xHats.size()-1; ts++)
-		{
-			float x_v = _xHats[ts][4*agent+2]; //*_timeStep; // distance traveled in one frame
-			float y_v = _xHats[ts][4*agent+3]; //*_timeStep;
-			float x_d = _xHats[ts+1][4*agent] - _xHats[ts][4*agent];
-			float y_d = _xHats[ts+1][4*agent+1] - _xHats[ts][4*agent+1];
-			float pos_x_diff = fabs(_xHats[ts][4*agent] - _posData.at(agent).at(ts).x);
-			float pos_z_diff = fabs(_xHats[ts][4*agent+1] - _posData.at(agent).at(ts).y);
-			float pos_x_v = (_posData.at(agent).at(ts+1).x - _posData.at(agent).at(ts).x);
-			float pos_z_v = (_posData.at(agent).at(ts+1).y - _posData.at(agent).at(ts).y);
-			Util::Vector tmpVelDiff = Util::Vector(pos_x_v, 0, pos_z_v)/_timeStep;
-			// std::cout << "Velocity calced from raw data " << tmpVelDiff << " length " << tmpVelDiff.length() <<
-				// 	" or length " << Util::Vector(pos_x_v, 0, pos_z_v).length()/_timeStep <<  std::endl;
-
-			distance = distance + (sqrtf((x_v*x_v)+(y_v*y_v))*_timeStep);
-			distance2 = distance2 + (sqrtf((x_d*x_d)+(y_d*y_d)));
-			pos_dist = pos_dist + (sqrtf((pos_x_diff*pos_x_diff)+(pos_z_diff*pos_z_diff)));
-			vel_diff = vel_diff + (Util::Vector(x_v, 0, y_v)-tmpVelDiff).length();
-			// vel_diff
-		}
-		// std::cout << "Average velocity of agent: " << agent << " is " << distance/(_posData.at(agent).size()*_timeStep) << std::endl;
-		// std::cout << "Average position velocity of agent: " << agent << " is " << distance2/(_posData.at(agent).size()*_timeStep) << std::endl;
-		// std::cout << "Average position difference from data: " << agent << " is " << pos_dist/_xHats.size() << std::endl;
-
-		pos_dist_agents =  pos_dist_agents + pos_dist/_xHats.size();
-		vel_diff_agents = vel_diff_agents + vel_diff/_xHats.size();
-
-
+		pos_dist_agents =  pos_dist_agents + _positionErrorSums[agent]/_numEstimatedSteps;
+		vel_diff_agents = vel_diff_agents + _velocityErrorSums[agent]/_numEstimatedSteps;
 	}
 	std::cout << "Average position difference from data: " << pos_dist_agents/_posData.size() << std::endl;
 	std::cout << "Average velocity difference from data: " << vel_diff_agents/_posData.size() << std::endl;
 
-	/*
-	for ( int ts = 0; ts < _posData[0].size()-1; ts++)
-	{
-		std::cout << "Xs[" << ts << "][0]: " << ~(Xs[ts][_numSamples-2]) << std::endl;
-
-		for (int samp = 0; samp < _numSamples ; samp++)
-		{
-			for ( int d = 0; d < tsSize; d++)
-			{
-				if ( std::isnan(Xs[ts][samp][d]) )
-				{
-					std::cout << "Some of the data is nan" << std::endl;
-				}
-			}
-		}
-	}
-	*/
-
 	/************************************************************
 	* End of EM estimation
 	************************************************************/
 
-	/**
-	 * Now to calculate difference
-	 */
+	std::cout << "The last diff was " << std::endl << ~_lastModelError << std::endl << _lastModelError*~_lastModelError << std::endl;
+	std::cout << "Varience of M.subMatrix(0,0,2,2) " << std::endl <<  ~(_modelErrorSum.subMatrix<2,2>(0,0)) << std::endl;
+
+	_entropyResult = _computeEntropy();
+	_previousEnsemble.clear();
+	_ensemble.clear();
+
+	std::cout << "Entropy result: " << _entropyResult << std::endl;
+}
 
-	Matrix zu = zeros(U_DIM);
-	Matrix zm = zeros(M_DIM);
-	Matrix diff;
-	M = zeros(M_DIM,M_DIM);
-	for (int e = 0; e < _numSamples; e++)
-	{//for each sample in the ensemple
-		std::vector<Matrix> fxs;
-		// fxs.push_back(Xs[0][e]); // Not used bu one needs to be added into data
-		for (int s = 0; s < ses-2; s++)
-		{ //for each timestep
-			fxs.push_back(this->m_fHat(Xs[s][e],zu,zm));
+void CompositeTechniqueEntropy::_beginModelError()
+{
+	_previousEnsemble.clear();
+	_modelErrorSum = AgentCovariance::zeros();
+	_lastModelError = AgentState::zeros();
+	_positionErrorSums.assign(_numAgt, 0.0f);
+	_velocityErrorSums.assign(_numAgt, 0.0f);
+	_numEstimatedSteps = 0;
+}
+
+void CompositeTechniqueEntropy::_accumulateModelError(const std::vector<Matrix> & X, const Matrix & xHat)
+{
+	if (_numEstimatedSteps > 0)
+	{
+		/**
+		 * Difference between simulating one step from the previous ensemble and the new ensemble
+		 */
+		Matrix zu = zeros(U_DIM);
+		Matrix zm = zeros(M_DIM);
+		for (int e = 0; e < _numSamples; e++)
+		{//for each sample in the ensemble
+			this->m_fHat(_previousEnsemble[e], zu, zm, _simulatedState);
 			for (int a = 0; a < _numAgt; a++)
 			{ // for each agent in the timestep
-				// std::cout << "subMatrix s=" << s << " a=" << a << " : " << ~(fxs.back()) << std::endl;
-				/*
-				 * Compare computed next step to all the steps in the ensamble
-				 */
-				// diff = (fxs.back().subMatrix(a*sx,0,sx,1) - Xs[s+1][e].subMatrix(a*sx,0,sx,1));
-				diff = abs(fxs.back().subMatrix(a*sx,0,sx,1) - Xs[s+1][e].subMatrix(a*sx,0,sx,1));
-				M = M + diff*~diff;
-				/*
-				for ( int m = 0; m < (M.numRows()*M.numColumns()); m++)
-				{
-						if ( std::isnan(M[m]) )
-						{
-							std::cout << "Got some nan in the comparison" << std::endl;
-						}
-				}*/
+				_lastModelError = abs(AgentState(_simulatedState, a*sx, 0) - AgentState(X[e], a*sx, 0));
+				_modelErrorSum += _lastModelError*~_lastModelError;
 			}
 		}
+
+		/**
+		 * How far the previous estimate is from the (noisy) data
+		 */
+		size_t ts = _numEstimatedSteps-1;
+		for ( size_t agent = 0; agent < _posData.size(); agent++)
+		{
+			float x_v = _previousXHat[4*agent+2]; // distance traveled in one frame
+			float y_v = _previousXHat[4*agent+3];
+			float pos_x_diff = fabs(_previousXHat[4*agent] - _posData.at(agent).at(ts).x);
+			float pos_z_diff = fabs(_previousXHat[4*agent+1] - _posData.at(agent).at(ts).y);
+			float pos_x_v = (_posData.at(agent).at(ts+1).x - _posData.at(agent).at(ts).x);
+			float pos_z_v = (_posData.at(agent).at(ts+1).y - _posData.at(agent).at(ts).y);
+			Util::Vector tmpVelDiff = Util::Vector(pos_x_v, 0, pos_z_v)/_timeStep;
+
+			_positionErrorSums[agent] += sqrtf((pos_x_diff*pos_x_diff)+(pos_z_diff*pos_z_diff));
+			_velocityErrorSums[agent] += (Util::Vector(x_v, 0, y_v)-tmpVelDiff).length();
+		}
 	}
-	std::cout << "The last diff was " << std::endl << ~diff << std::endl << diff*~diff << std::endl;
-	std::cout << "Varience of M.subMatrix(0,0,2,2) " << std::endl <<  ~(M.subMatrix(0,0,2,2)) << std::endl;
-	M = M / ((float)_numSamples*_numAgt*(ses-1));
 
-	Matrix m2 = M.subMatrix(0,0,2,2);
-	/*
-	for (int i = 0; i < 2; i++)
+	_previousEnsemble = X;
+	_previousXHat = xHat;
+	_numEstimatedSteps++;
+}
+
+double CompositeTechniqueEntropy::_computeEntropy()
+{
+	if (_numEstimatedSteps < 2)
 	{
-		double r_ = r(1);
-		std::cout << "adding r " << r_ << " to m2(i,i) " << m2(i,i) << std::endl;
-		m2(i,i) = m2(i,i); // *_numSamples; //  + 0.2f;
-	}*/
-// 		std::cout << "\n\n M2:\n " << m2 << "\n\n";
+		return 0.0;
+	}
+
+	FixedMatrix<2,2> m2 = _modelErrorSum.subMatrix<2,2>(0,0) / ((float)_numSamples*_numAgt*_numEstimatedSteps);
 	m2 = m2 *_numSamples;
-	std::cout << "Varience of m2 " << std::endl <<  ~(m2) << std::endl;
 
 	double realDet = fabs(m2(0,0)*m2(1,1)-m2(1,0)*m2(0,1));//determinant
 // 		double realDet = fabs(m2(0,0))+fabs(m2(1,1));//trace
-// 		std::cout << "realDet: " << realDet << "\n\n";
 
-
-
-	std::cout << "the determinate is " << realDet <<  std::endl;
-
-	// realDet = fabs(realDet);
-	double result = 0.5*log(pow(2*3.14159265*2.718281828,2)*realDet)/log(2.0);
-	_entropyResult = result;
-
-	std::cout << "Entropy result: " << result << std::endl;
+	return 0.5*log(pow(2*3.14159265*2.718281828,2)*realDet)/log(2.0);
 }
 
 /*
@@ -768,6 +742,13 @@ SteerLib::AgentInitialConditions CompositeTechniqueEntropy::getAgentConditions(S
  * the additional information from the noisy data
  */
 Matrix CompositeTechniqueEntropy::m_fHat(const Matrix& x, const Matrix& u, const Matrix& m1)
+{
+	Matrix xNew(4*_numAgt);
+	m_fHat(x, u, m1, xNew);
+	return xNew;
+}
+
+void CompositeTechniqueEntropy::m_fHat(const Matrix& x, const Matrix& u, const Matrix& m1, Matrix & xNew)
 {
 	// std::cout << this->getEngineInterface() << std::endl;
 	// std::cout << "agents ready " << this->getEngineInterface()->getAgents().size() << std::endl;
@@ -880,12 +861,15 @@ Matrix CompositeTechniqueEntropy::m_fHat(const Matrix& x, const Matrix& u, const
 			// 		std::endl;
 
 
-	Matrix xNew(4*_numAgt);
+	if ((xNew.numRows() != (size_t)(4*_numAgt)) || (xNew.numColumns() != 1))
+	{
+		xNew = Matrix(4*_numAgt);
+	}
 	// double speedTrav = 0;
 	for (int a = 0; a < _numAgt; a++){
-		Matrix m = Util::sampleGaussian(zeros(4),m_identity(4));
+		AgentState m = Util::sampleGaussian(AgentState::zeros(), AgentCovariance::identity());
 		if (m1[0] == m1[1] && m1[1] == 0){
-			m = zeros(4);
+			m = AgentState::zeros();
 		}
 
 
@@ -958,8 +942,6 @@ Matrix CompositeTechniqueEntropy::m_fHat(const Matrix& x, const Matrix& u, const
 	}
 	this->_agentModule->cleanupSimulation();
 	*/
-
-	return xNew;
 }
 
 //Matrix CompositeTechniqueEntropy::m_fHatData(const Matrix& x, const Matrix& u, const Matrix& m1)
@@ -1026,8 +1008,20 @@ void CompositeTechniqueEntropy::update(SteerLib::EngineInterface * engineInterfa
 	{
 		if ( _replay_data == 0)
 		{
-			this->performEstimation();
-			this->_estimationDone = 1;
+			// the filter advances with the simulation, so getTotalBenchmarkScore() reports the entropy of the data filtered so far.
+			if (_nextEstimationStep == 0)
+			{
+				_beginEstimation();
+			}
+			for (unsigned int i = 0; (_nextEstimationStep < _numEstimationSteps) && ((_estimationStepsPerFrame == 0) || (i < _estimationStepsPerFrame)); i++)
+			{
+				_estimateNextStep();
+			}
+			if (_nextEstimationStep >= _numEstimationSteps)
+			{
+				_endEstimation();
+				this->_estimationDone = 1;
+			}
 		}
 		else
 		{
@@ -10,6 +10,9 @@
 #include <set>
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <cfloat>
 
 #include "util/GenericException.h"
 #include "util/Geometry.h"
@@ -30,7 +33,7 @@ using namespace Util;
 //
 // constructor for grid database - takes the bounds and desired number of cells
 //
-GridDatabase2D::GridDatabase2D(float xmin, float xmax, float zmin, float zmax, unsigned int numXCells, unsigned int numZCells, unsigned int maxItemsPerCell, bool drawGrid)
+GridDatabase2D::GridDatabase2D(float xmin, float xmax, float zmin, float zmax, unsigned int numXCells, unsigned int numZCells, unsigned int maxItemsPerCell, bool drawGrid, unsigned int numObstacleXCells, unsigned int numObstacleZCells)
 {
 	if (xmin > xmax) swap(xmin, xmax);
 	if (zmin > zmax) swap(xmin, xmax);
@@ -47,6 +50,8 @@ GridDatabase2D::GridDatabase2D(float xmin, float xmax, float zmin, float zmax, u
 	_zCellSize = _zGridSize / ((float)numZCells);
 	_maxItemsPerCell = maxItemsPerCell;
 	_drawGrid = drawGrid;
+	_xNumObstacleCells = numObstacleXCells;
+	_zNumObstacleCells = numObstacleZCells;
 	// std::cout << "Creating grid database: " << this << std::endl;
 
 	_allocateDatabase();
@@ -56,7 +61,7 @@ GridDatabase2D::GridDatabase2D(float xmin, float xmax, float zmin, float zmax, u
 //
 // alternate constructor for grid database - specify the (minx,minz) corner, and the desired grid size and number of cells
 //
-GridDatabase2D::GridDatabase2D(const Point & origin2D, float xExtent, float zExtent, unsigned int numXCells, unsigned int numZCells, unsigned int maxItemsPerCell, bool drawGrid)
+GridDatabase2D::GridDatabase2D(const Point & origin2D, float xExtent, float zExtent, unsigned int numXCells, unsigned int numZCells, unsigned int maxItemsPerCell, bool drawGrid, unsigned int numObstacleXCells, unsigned int numObstacleZCells)
 {
 	_xOrigin = origin2D.x;
 	_zOrigin = origin2D.z;
@@ -70,6 +75,8 @@ GridDatabase2D::GridDatabase2D(const Point & origin2D, float xExtent, float zExt
 	_zCellSize = _zGridSize / ((float)numZCells);
 	_maxItemsPerCell = maxItemsPerCell;
 	_drawGrid = drawGrid;
+	_xNumObstacleCells = numObstacleXCells;
+	_zNumObstacleCells = numObstacleZCells;
 
 	_allocateDatabase();
 }
@@ -82,6 +89,7 @@ GridDatabase2D::~GridDatabase2D()
 {
 	delete [] _basePtr;
 	delete [] _cells;
+	delete _randomNumberGenerator;
 }
 
 
@@ -107,6 +115,18 @@ void GridDatabase2DPrivate::_allocateDatabase()
 		// of astar lib...  is traversal cost a fixed cost to add, or is it a multiplicative factor?
 		_cells[i].init( _maxItemsPerCell, _basePtr + (i*_maxItemsPerCell), 1.0f );
 	}
+
+	// the obstacle layer uses the resolution of the agent layer, unless it was given its own.
+	if ((_xNumObstacleCells == 0) || (_zNumObstacleCells == 0)) {
+		_xNumObstacleCells = _xNumCells;
+		_zNumObstacleCells = _zNumCells;
+	}
+	_xObstacleCellSize = _xGridSize / ((float)_xNumObstacleCells);
+	_zObstacleCellSize = _zGridSize / ((float)_zNumObstacleCells);
+	_obstacleCellStart.assign(_xNumObstacleCells*_zNumObstacleCells + 1, 0);
+	_obstacleLayerDirty = false;
+
+	_randomNumberGenerator = new MTRand(2);
 }
 
 
@@ -117,8 +137,16 @@ void GridDatabase2D::clearDatabase()
 	{
 		// TODO: is it OK to make the traversal cost 0.0f ?? it would be more general.  need to double-check assumptions
 		// of astar lib...  is traversal cost a fixed cost to add, or is it a multiplicative factor?
-		_cells[i].clear();
+		_cells[i].clear(_maxItemsPerCell);
 	}
+	_obstacles.clear();
+	_obstacleLayerDirty = true;
+}
+
+
+void GridDatabase2D::refreshDataBase()
+{
+	_updateObstacleLayer();
 }
 
 // Rounds the given float to the nearest integer if it is in the specified error range.
@@ -143,6 +171,12 @@ float _roundClose(float f)
 // because it is inline, if this function ever needs to become public, place it in the .h file instead.
 //
 inline bool GridDatabase2DPrivate::_clampSpatialBoundsToIndexRange(float xmin, float xmax, float zmin, float zmax, unsigned int & xMinIndex, unsigned int & xMaxIndex, unsigned int & zMinIndex, unsigned int & zMaxIndex)
+{
+	return _clampSpatialBoundsToIndexRange(xmin, xmax, zmin, zmax, _xNumCells, _zNumCells, xMinIndex, xMaxIndex, zMinIndex, zMaxIndex);
+}
+
+
+inline bool GridDatabase2DPrivate::_clampSpatialBoundsToIndexRange(float xmin, float xmax, float zmin, float zmax, unsigned int numXCells, unsigned int numZCells, unsigned int & xMinIndex, unsigned int & xMaxIndex, unsigned int & zMinIndex, unsigned int & zMaxIndex)
 {
 	// clamp and convert xmin to xMinIndex
 	if (xmin < _xOrigin)
@@ -150,7 +184,7 @@ inline bool GridDatabase2DPrivate::_clampSpatialBoundsToIndexRange(float xmin, f
 	else if (xmin > _xOrigin + _xGridSize)
 		return false;
 	else
-		xMinIndex = (unsigned int)floor(_roundClose(((xmin - _xOrigin) * _xInvGridSize) * _xNumCells));
+		xMinIndex = (unsigned int)floor(_roundClose(((xmin - _xOrigin) * _xInvGridSize) * numXCells));
 
 	// clamp and convert zmin to zMinIndex
 	if (zmin < _zOrigin)
@@ -158,31 +192,49 @@ inline bool GridDatabase2DPrivate::_clampSpatialBoundsToIndexRange(float xmin, f
 	else if (zmin > _zOrigin + _zGridSize)
 		return false;
 	else
-		zMinIndex = (unsigned int)floor(_roundClose(((zmin - _zOrigin) * _zInvGridSize) * _zNumCells));
+		zMinIndex = (unsigned int)floor(_roundClose(((zmin - _zOrigin) * _zInvGridSize) * numZCells));
 
 	// clamp and convert xmax to xMaxIndex
 	if (xmax >= _xOrigin + _xGridSize)
-		xMaxIndex = _xNumCells-1; // subtract one because xMaxIndex is included in the spatial bounds.
+		xMaxIndex = numXCells-1; // subtract one because xMaxIndex is included in the spatial bounds.
 	else if (xmax < _xOrigin)
 		return false;
 	else
-		xMaxIndex = (unsigned int)ceil(_roundClose(((xmax - _xOrigin) * _xInvGridSize) * _xNumCells))-1;
+		xMaxIndex = (unsigned int)ceil(_roundClose(((xmax - _xOrigin) * _xInvGridSize) * numXCells))-1;
 
 	// clamp and convert zmax to zMaxIndex
 	if (zmax >= _zOrigin + _zGridSize)
-		zMaxIndex = _zNumCells-1;  // subtract one because zMaxIndex is included in the spatial bounds.
+		zMaxIndex = numZCells-1;  // subtract one because zMaxIndex is included in the spatial bounds.
 	else if (zmax < _zOrigin)
 		return false;
 	else
-		zMaxIndex = (unsigned int)ceil(_roundClose(((zmax  - _zOrigin) * _zInvGridSize) * _zNumCells))-1;
+		zMaxIndex = (unsigned int)ceil(_roundClose(((zmax  - _zOrigin) * _zInvGridSize) * numZCells))-1;
 
 	return true;
 }
 
 
 //
-// addObject() - adds the given item to the database.  Each grid cell that overlaps
-//               "newBounds" will then contain a reference to the item.
+// _getObstacleIndexRange() - the cells of the obstacle layer that cover the given cells of the agent layer.
+//
+void GridDatabase2DPrivate::_getObstacleIndexRange(unsigned int xMinIndex, unsigned int xMaxIndex, unsigned int zMinIndex, unsigned int zMaxIndex, unsigned int & xMinObstacleIndex, unsigned int & xMaxObstacleIndex, unsigned int & zMinObstacleIndex, unsigned int & zMaxObstacleIndex)
+{
+	if ((_xNumObstacleCells == _xNumCells) && (_zNumObstacleCells == _zNumCells)) {
+		xMinObstacleIndex = xMinIndex;
+		xMaxObstacleIndex = xMaxIndex;
+		zMinObstacleIndex = zMinIndex;
+		zMaxObstacleIndex = zMaxIndex;
+		return;
+	}
+	xMinObstacleIndex = xMaxObstacleIndex = zMinObstacleIndex = zMaxObstacleIndex = 0;
+	_clampSpatialBoundsToIndexRange(_xOrigin + xMinIndex * _xCellSize, _xOrigin + (xMaxIndex + 1) * _xCellSize, _zOrigin + zMinIndex * _zCellSize, _zOrigin + (zMaxIndex + 1) * _zCellSize,
+		_xNumObstacleCells, _zNumObstacleCells, xMinObstacleIndex, xMaxObstacleIndex, zMinObstacleIndex, zMaxObstacleIndex);
+}
+
+
+//
+// addObject() - adds the given item to the database.  If it is an agent, each grid cell that overlaps
+//               "newBounds" will then contain a reference to the item; otherwise it goes to the obstacle layer.
 //
 void GridDatabase2D::addObject( SpatialDatabaseItemPtr item, const AxisAlignedBox & newBounds )
 {
@@ -198,6 +250,11 @@ void GridDatabase2D::addObject( SpatialDatabaseItemPtr item, const AxisAlignedBo
 		return;
 	}
 
+	if (!item->isAgent()) {
+		_addObstacle(item, item->getTraversalCost(), newBounds);
+		return;
+	}
+
 	unsigned int cellIndex;
 
 	// iterate over all cells that overlap the bounding box of the object
@@ -208,7 +265,7 @@ void GridDatabase2D::addObject( SpatialDatabaseItemPtr item, const AxisAlignedBo
 	for (unsigned int i=xMinIndex; i<=xMaxIndex; i++) {
 		cellIndex = getCellIndexFromGridCoords(i,zMinIndex);
 		for (unsigned int j=zMinIndex; j<=zMaxIndex; j++) {
-			_cells[cellIndex].add(item,_maxItemsPerCell, item->getTraversalCost());
+			_cells[cellIndex].add(item, _maxItemsPerCell, item->getTraversalCost());
 			// std::cout << "CellIndex is: " << cellIndex << std::endl;
 			cellIndex++;
 		}
@@ -228,6 +285,11 @@ void GridDatabase2D::removeObject( SpatialDatabaseItemPtr item, const AxisAligne
 		return;
 	}
 
+	if (!item->isAgent()) {
+		_removeObstacle(item, oldBounds);
+		return;
+	}
+
 	unsigned int cellIndex;
 
 	// iterate over all cells that overlap the bounding box of the object
@@ -267,6 +329,98 @@ void GridDatabase2D::updateObject( SpatialDatabaseItemPtr item, const AxisAligne
 }
 
 
+//
+// the obstacle layer - obstacles are kept in a list in the order they were added, and packed into the cells of the
+// layer only when a query needs them.  Between two rebuilds, queries only read the packed arrays.
+//
+void GridDatabase2DPrivate::_addObstacle(SpatialDatabaseItemPtr item, float traversalCost, const AxisAlignedBox & bounds)
+{
+	Obstacle obstacle;
+	obstacle.item = item;
+	obstacle.traversalCost = traversalCost;
+	if (!_clampSpatialBoundsToIndexRange(bounds.xmin, bounds.xmax, bounds.zmin, bounds.zmax, obstacle.xMinIndex, obstacle.xMaxIndex, obstacle.zMinIndex, obstacle.zMaxIndex) ||
+		!_clampSpatialBoundsToIndexRange(bounds.xmin, bounds.xmax, bounds.zmin, bounds.zmax, _xNumObstacleCells, _zNumObstacleCells, obstacle.xMinObstacleIndex, obstacle.xMaxObstacleIndex, obstacle.zMinObstacleIndex, obstacle.zMaxObstacleIndex)) {
+		// the object's bounds are completely outside the database.
+		return;
+	}
+
+	for (unsigned int i=obstacle.xMinIndex; i<=obstacle.xMaxIndex; i++) {
+		unsigned int cellIndex = (i * _zNumCells) + obstacle.zMinIndex;
+		for (unsigned int j=obstacle.zMinIndex; j<=obstacle.zMaxIndex; j++) {
+			_cells[cellIndex].addObstacle(traversalCost);
+			cellIndex++;
+		}
+	}
+	_obstacles.push_back(obstacle);
+	_obstacleLayerDirty = true;
+}
+
+
+void GridDatabase2DPrivate::_removeObstacle(SpatialDatabaseItemPtr item, const AxisAlignedBox & bounds)
+{
+	unsigned int xMinIndex, xMaxIndex, zMinIndex, zMaxIndex;
+	if (!_clampSpatialBoundsToIndexRange(bounds.xmin, bounds.xmax, bounds.zmin, bounds.zmax, xMinIndex, xMaxIndex, zMinIndex, zMaxIndex)) {
+		// the object's bounds are completely outside the database, so it was never added.
+		return;
+	}
+
+	unsigned int o=0;
+	while ((o < _obstacles.size()) && (_obstacles[o].item != item)) o++;
+	if (o >= _obstacles.size()) {
+		throw GenericException("Tried to remove an obstacle from the grid database, but it did not exist there in the first place.");
+	}
+	// the cells that counted the obstacle are the ones it overlapped when it was added.
+	const Obstacle & obstacle = _obstacles[o];
+	for (unsigned int i=obstacle.xMinIndex; i<=obstacle.xMaxIndex; i++) {
+		unsigned int cellIndex = (i * _zNumCells) + obstacle.zMinIndex;
+		for (unsigned int j=obstacle.zMinIndex; j<=obstacle.zMaxIndex; j++) {
+			_cells[cellIndex].removeObstacle(obstacle.traversalCost);
+			cellIndex++;
+		}
+	}
+	_obstacles.erase(_obstacles.begin() + o);
+	_obstacleLayerDirty = true;
+}
+
+
+void GridDatabase2DPrivate::_buildObstacleLayer()
+{
+	std::lock_guard<std::mutex> lock(_obstacleLayerLock);
+	if (!_obstacleLayerDirty.load(std::memory_order_relaxed)) {
+		// another thread built it while this one was waiting.
+		return;
+	}
+
+	// count the items of each cell, turn the counts into the index of the first item of each cell, and then fill the cells.
+	unsigned int numTotalCells = _xNumObstacleCells*_zNumObstacleCells;
+	_obstacleCellStart.assign(numTotalCells + 1, 0);
+	for (unsigned int o=0; o < _obstacles.size(); o++) {
+		const Obstacle & obstacle = _obstacles[o];
+		for (unsigned int i=obstacle.xMinObstacleIndex; i<=obstacle.xMaxObstacleIndex; i++) {
+			for (unsigned int j=obstacle.zMinObstacleIndex; j<=obstacle.zMaxObstacleIndex; j++) {
+				_obstacleCellStart[_getObstacleCellIndexFromGridCoords(i,j) + 1]++;
+			}
+		}
+	}
+	for (unsigned int c=0; c < numTotalCells; c++) {
+		_obstacleCellStart[c+1] += _obstacleCellStart[c];
+	}
+
+	_obstacleCellItems.resize(_obstacleCellStart[numTotalCells]);
+	std::vector<unsigned int> nextItem(_obstacleCellStart.begin(), _obstacleCellStart.end() - 1);
+	for (unsigned int o=0; o < _obstacles.size(); o++) {
+		const Obstacle & obstacle = _obstacles[o];
+		for (unsigned int i=obstacle.xMinObstacleIndex; i<=obstacle.xMaxObstacleIndex; i++) {
+			for (unsigned int j=obstacle.zMinObstacleIndex; j<=obstacle.zMaxObstacleIndex; j++) {
+				_obstacleCellItems[nextItem[_getObstacleCellIndexFromGridCoords(i,j)]++] = obstacle.item;
+			}
+		}
+	}
+
+	_obstacleLayerDirty.store(false, std::memory_order_release);
+}
+
+
 //
 // getItemsInRange() - the protected version uses the integer index ranges.
 //
@@ -278,14 +432,31 @@ void GridDatabase2D::getItemsInRange(set<SpatialDatabaseItemPtr> & neighborList,
 	for (unsigned int i=xMinIndex; i<=xMaxIndex; i++) {
 		cellIndex = (i * _zNumCells) + zMinIndex;
 		for (unsigned int j=zMinIndex; j<=zMaxIndex; j++) {
-			for (unsigned int k=0; k < _maxItemsPerCell; k++) {
-				if ((_cells[cellIndex]._items[k]!=NULL) && (_cells[cellIndex]._items[k]!=exclude)) {
-					neighborList.insert(_cells[cellIndex]._items[k]);
+			const GridCell & cell = _cells[cellIndex];
+			for (unsigned int k=0; k < cell._numItems; k++) {
+				if (cell._items[k]!=exclude) {
+					neighborList.insert(cell._items[k]);
 				}
 			}
 			cellIndex++;
 		}
 	}
+
+	_updateObstacleLayer();
+	unsigned int xMinObstacleIndex, xMaxObstacleIndex, zMinObstacleIndex, zMaxObstacleIndex;
+	_getObstacleIndexRange(xMinIndex, xMaxIndex, zMinIndex, zMaxIndex, xMinObstacleIndex, xMaxObstacleIndex, zMinObstacleIndex, zMaxObstacleIndex);
+	for (unsigned int i=xMinObstacleIndex; i<=xMaxObstacleIndex; i++) {
+		for (unsigned int j=zMinObstacleIndex; j<=zMaxObstacleIndex; j++) {
+			unsigned int obstacleCellIndex = _getObstacleCellIndexFromGridCoords(i,j);
+			SpatialDatabaseItemPtr * items = _getObstacleCellItems(obstacleCellIndex);
+			SpatialDatabaseItemPtr * itemsEnd = _getObstacleCellItems(obstacleCellIndex + 1);
+			for (; items != itemsEnd; items++) {
+				if (*items!=exclude) {
+					neighborList.insert(*items);
+				}
+			}
+		}
+	}
 }
 
 
@@ -299,6 +470,91 @@ void GridDatabase2D::getItemsInRange(set<SpatialDatabaseItemPtr> & neighborList,
 	getItemsInRange(neighborList,xMinIndex,xMaxIndex,zMinIndex,zMaxIndex,exclude);
 }
 
+//
+// getItemsInRange() - vector version; objects that span several cells are gathered more than once, so sort and remove duplicates afterwards.
+//
+void GridDatabase2D::getItemsInRange(vector<SpatialDatabaseItemPtr> & neighborList, float xmin, float xmax, float zmin, float zmax, SpatialDatabaseItemPtr exclude)
+{
+	_gatherItemsInRange(neighborList, xmin, xmax, zmin, zmax, exclude, SPATIAL_DATABASE_ALL_ITEMS, [](SpatialDatabaseItemPtr item) { return item; });
+}
+
+
+void GridDatabase2D::getItemsInRange(vector<SpatialDatabaseItemPtr> & neighborList, float xmin, float xmax, float zmin, float zmax, SpatialDatabaseItemPtr exclude, unsigned int kinds)
+{
+	_gatherItemsInRange(neighborList, xmin, xmax, zmin, zmax, exclude, kinds, [](SpatialDatabaseItemPtr item) { return item; });
+}
+
+
+//
+// getAgentsInRange() and getObstaclesInRange() - typed versions, that only scan one layer.
+//
+void GridDatabase2D::getAgentsInRange(vector<AgentInterface*> & neighborList, float xmin, float xmax, float zmin, float zmax, SpatialDatabaseItemPtr exclude)
+{
+	_gatherItemsInRange(neighborList, xmin, xmax, zmin, zmax, exclude, SPATIAL_DATABASE_AGENTS, asAgent);
+}
+
+
+void GridDatabase2D::getObstaclesInRange(vector<ObstacleInterface*> & neighborList, float xmin, float xmax, float zmin, float zmax, SpatialDatabaseItemPtr exclude)
+{
+	_gatherItemsInRange(neighborList, xmin, xmax, zmin, zmax, exclude, SPATIAL_DATABASE_OBSTACLES, asObstacle);
+}
+
+
+//
+// _gatherItemsInRange() - objects that span several cells are gathered more than once, so sort and remove duplicates afterwards.
+// items that convert() maps to NULL are left out.
+//
+template <typename ItemType, typename Converter>
+void GridDatabase2D::_gatherItemsInRange(vector<ItemType*> & neighborList, float xmin, float xmax, float zmin, float zmax, SpatialDatabaseItemPtr exclude, unsigned int kinds, Converter convert)
+{
+	neighborList.clear();
+
+	if (kinds & SPATIAL_DATABASE_AGENTS) {
+		unsigned int xMinIndex=0, xMaxIndex=0, zMinIndex=0, zMaxIndex=0;
+		_clampSpatialBoundsToIndexRange(xmin, xmax, zmin, zmax, xMinIndex, xMaxIndex, zMinIndex, zMaxIndex);
+		int cellIndex;
+		for (unsigned int i=xMinIndex; i<=xMaxIndex; i++) {
+			cellIndex = (i * _zNumCells) + zMinIndex;
+			for (unsigned int j=zMinIndex; j<=zMaxIndex; j++) {
+				const GridCell & cell = _cells[cellIndex];
+				for (unsigned int k=0; k < cell._numItems; k++) {
+					if (cell._items[k]!=exclude) {
+						ItemType * item = convert(cell._items[k]);
+						if (item != NULL) {
+							neighborList.push_back(item);
+						}
+					}
+				}
+				cellIndex++;
+			}
+		}
+	}
+
+	if (kinds & SPATIAL_DATABASE_OBSTACLES) {
+		_updateObstacleLayer();
+		unsigned int xMinIndex=0, xMaxIndex=0, zMinIndex=0, zMaxIndex=0;
+		_clampSpatialBoundsToIndexRange(xmin, xmax, zmin, zmax, _xNumObstacleCells, _zNumObstacleCells, xMinIndex, xMaxIndex, zMinIndex, zMaxIndex);
+		for (unsigned int i=xMinIndex; i<=xMaxIndex; i++) {
+			for (unsigned int j=zMinIndex; j<=zMaxIndex; j++) {
+				unsigned int cellIndex = _getObstacleCellIndexFromGridCoords(i,j);
+				SpatialDatabaseItemPtr * items = _getObstacleCellItems(cellIndex);
+				SpatialDatabaseItemPtr * itemsEnd = _getObstacleCellItems(cellIndex + 1);
+				for (; items != itemsEnd; items++) {
+					if (*items!=exclude) {
+						ItemType * item = convert(*items);
+						if (item != NULL) {
+							neighborList.push_back(item);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	std::sort(neighborList.begin(), neighborList.end());
+	neighborList.erase(std::unique(neighborList.begin(), neighborList.end()), neighborList.end());
+}
+
 //
 // getItemsInVisualField()
 //
@@ -312,15 +568,17 @@ void GridDatabase2D::getItemsInVisualField(set<SpatialDatabaseItemPtr> & neighbo
 	for (unsigned int i=xMinIndex; i<=xMaxIndex; i++) {
 		cellIndex = getCellIndexFromGridCoords(i,zMinIndex);
 		for (unsigned int j=zMinIndex; j<=zMaxIndex; j++) {
-			for (unsigned int k=0; k < _maxItemsPerCell; k++) {
-				SpatialDatabaseItemPtr possiblyVisibleObject = _cells[cellIndex]._items[k];
+			const GridCell & cell = _cells[cellIndex];
+			for (unsigned int k=0; k < cell._numItems; k++) {
+				SpatialDatabaseItemPtr possiblyVisibleObject = cell._items[k];
 
 
-				// ignore this object if it is actually not an object (NULL), or if we are supposed to exclude it
-				if ((possiblyVisibleObject==NULL) || (possiblyVisibleObject==exclude))
+				// ignore this object if we are supposed to exclude it
+				if (possiblyVisibleObject==exclude)
 					continue;
 
-				if (possiblyVisibleObject->isAgent()) {
+				AgentInterface * otherAgent = asAgent(possiblyVisibleObject);
+				if (otherAgent != NULL) {
 					// three more conditions...
 
 					// do a search to make sure it doesnt exist in the set already, if it does exist 
@@ -328,7 +586,7 @@ void GridDatabase2D::getItemsInVisualField(set<SpatialDatabaseItemPtr> & neighbo
 					if (neighborList.find(possiblyVisibleObject) != neighborList.end()) continue;
 
 					// (1) if the agent is outside of the radius of the visual field, then forget it
-					Point hisPosition = (dynamic_cast<AgentInterface*>(possiblyVisibleObject))->position();
+					Point hisPosition = otherAgent->position();
 					Vector directionToOtherAgent = hisPosition - position;
 					float distSquared = directionToOtherAgent.lengthSquared();
 					if (distSquared > radiusSquared) 
@@ -363,6 +621,25 @@ void GridDatabase2D::getItemsInVisualField(set<SpatialDatabaseItemPtr> & neighbo
 		}
 
 	}
+
+	// for non-Agent items, i.e. "objects" --> obstacles and such: we assume the 
+	// agent will know where such items are, even if its not directly 
+	// in its visual field.  so, always add it without needing to check
+	// line-of-sight or distance.
+	_updateObstacleLayer();
+	_clampSpatialBoundsToIndexRange(xmin, xmax, zmin, zmax, _xNumObstacleCells, _zNumObstacleCells, xMinIndex, xMaxIndex, zMinIndex, zMaxIndex);
+	for (unsigned int i=xMinIndex; i<=xMaxIndex; i++) {
+		for (unsigned int j=zMinIndex; j<=zMaxIndex; j++) {
+			unsigned int obstacleCellIndex = _getObstacleCellIndexFromGridCoords(i,j);
+			SpatialDatabaseItemPtr * items = _getObstacleCellItems(obstacleCellIndex);
+			SpatialDatabaseItemPtr * itemsEnd = _getObstacleCellItems(obstacleCellIndex + 1);
+			for (; items != itemsEnd; items++) {
+				if (*items!=exclude) {
+					neighborList.insert(*items);
+				}
+			}
+		}
+	}
 }
 
 void GridDatabase2D::draw()
@@ -419,13 +696,11 @@ void GridDatabase2D::draw()
 
 			for (unsigned int item=0; item < _cells[cellIndex]._numItems; item++)
 			{
-				if ((_cells[cellIndex]._items[item] != NULL))
-				{
-					if (_cells[cellIndex]._items[item]->isAgent())
-						color = color + Color(0,0,0.9f / _maxItemsPerCell);
-					else
-						color = color + Color(0.8f / _maxItemsPerCell,0,0);
-				}
+				color = color + Color(0,0,0.9f / _maxItemsPerCell);
+			}
+			for (unsigned int item=0; item < _cells[cellIndex]._numObstacles; item++)
+			{
+				color = color + Color(0.8f / _maxItemsPerCell,0,0);
 			}
 			DrawLib::glColor(color);
 			DrawLib::drawQuad(a, b, c, d);
@@ -438,16 +713,53 @@ void GridDatabase2D::draw()
 }
 
 bool GridDatabase2D::trace(const Ray & r, float & t, SpatialDatabaseItemPtr &hitObject, SpatialDatabaseItemPtr exclude, bool excludeAgents)
+{
+	// the agent layer is traced first, so that the obstacle layer only needs to find a nearer hit; like in the cells of one
+	// grid, an agent wins over an obstacle at the same t.
+	hitObject = NULL;
+	bool hit = false;
+	Ray obstacleRay = r;
+	if (!excludeAgents && (_traceLayer(r, false, t, hitObject, exclude, NULL, false) == RAY_MARCH_HIT)) {
+		hit = true;
+		obstacleRay.maxt = t;
+	}
+	_updateObstacleLayer();
+	if (_traceLayer(obstacleRay, true, t, hitObject, exclude, NULL, false) == RAY_MARCH_HIT) {
+		hit = true;
+	}
+	return hit;
+}
+
+bool GridDatabase2D::hasLineOfSight(const Ray & r, SpatialDatabaseItemPtr exclude1, SpatialDatabaseItemPtr exclude2)
+{
+	// obstacles are the items that usually block line of sight, so their layer is traced first.  A ray that runs into the
+	// edge of the grid counts as blocked; only the agent layer decides that, so the answer does not depend on the
+	// resolution of the obstacle layer.
+	float t;
+	SpatialDatabaseItemPtr blocker;
+	_updateObstacleLayer();
+	if (_traceLayer(r, true, t, blocker, exclude1, exclude2, true) == RAY_MARCH_HIT) {
+		return false;
+	}
+	RayMarchResult result = _traceLayer(r, false, t, blocker, exclude1, exclude2, true);
+	return (result == RAY_MARCH_REACHED_END) || (result == RAY_MARCH_STARTED_OUTSIDE);
+}
+
+GridDatabase2D::RayMarchResult GridDatabase2D::_traceLayer(const Ray & r, bool obstacleLayer, float & t, SpatialDatabaseItemPtr & hitObject, SpatialDatabaseItemPtr exclude1, SpatialDatabaseItemPtr exclude2, bool lineOfSight)
 {
 	// 1. march through grid cells
 	// 2. for each grid cell:
 	//   - test all items in each grid cell
-	// 3. if the intersection found lies within the current grid cell, then return true with that info
+	// 3. if the intersection found lies within the current grid cell, then return that info
 	// 4. else, go on to the next grid cell.
 
 	// just declare all vars in the first place
+	unsigned int xNumCells = obstacleLayer ? _xNumObstacleCells : _xNumCells;
+	unsigned int zNumCells = obstacleLayer ? _zNumObstacleCells : _zNumCells;
+	float xCellSize = obstacleLayer ? _xObstacleCellSize : _xCellSize;
+	float zCellSize = obstacleLayer ? _zObstacleCellSize : _zCellSize;
 	unsigned int x,z; // (x,z) are 2-d coordinates and currentBin is the 1-d index to refer to the bin being traversed
-	int currentBin;
+	unsigned int currentBin;
 	Point center;
 	float xlow, xhi, zlow, zhi, xOffset, zOffset;  // spatial info for the grid cell being traversed
 	float txnear, txfar, tznear, tzfar, invRayDirx, invRayDirz;
@@ -455,17 +767,18 @@ bool GridDatabase2D::trace(const Ray & r, float & t, SpatialDatabaseItemPtr &hit
 	bool validIntersectionFound;
 
 	// one-time initialization stuff here
-	currentBin = getCellIndexFromLocation(r.pos.x, r.pos.z);
 #ifdef _DEBUG
 	std::cout << "r.pos.x = " << r.pos.x << "\n";
 	std::cout << "r.pos.z = " << r.pos.z << "\n";
 #endif
-	if (currentBin == -1) return false;
-	getGridCoordinatesFromIndex(currentBin,x,z);
+	if ((r.pos.x < _xOrigin) || (r.pos.z < _zOrigin) || (r.pos.x >= _xOrigin + _xGridSize) || (r.pos.z >= _zOrigin + _zGridSize)) return RAY_MARCH_STARTED_OUTSIDE;
+	x = (unsigned int) (((r.pos.x - _xOrigin) * _xInvGridSize) * xNumCells);
+	z = (unsigned int) (((r.pos.z - _zOrigin) * _zInvGridSize) * zNumCells);
+	currentBin = (x * zNumCells) + z;
 	invRayDirx = 1.0f / r.dir.x;
 	invRayDirz = 1.0f / r.dir.z;
-	xOffset = 0.5f * _xGridSize / ((float)_xNumCells);
-	zOffset = 0.5f * _zGridSize / ((float)_zNumCells);
+	xOffset = 0.5f * _xGridSize / ((float)xNumCells);
+	zOffset = 0.5f * _zGridSize / ((float)zNumCells);
 
 	// clamp maxt to be within the grid
 	xlow = _xOrigin;
@@ -484,7 +797,8 @@ bool GridDatabase2D::trace(const Ray & r, float & t, SpatialDatabaseItemPtr &hit
 	mint = r.mint;
 
 	// set up info for the first grid cell
-	getLocationFromIndex(currentBin, center);
+	center.x = (((float)x) + 0.5f)*xCellSize + _xOrigin;
+	center.z = (((float)z) + 0.5f)*zCellSize + _zOrigin;
 	xlow = center.x - xOffset;
 	xhi  = center.x + xOffset;
 	zlow = center.z - zOffset;
@@ -501,19 +815,24 @@ bool GridDatabase2D::trace(const Ray & r, float & t, SpatialDatabaseItemPtr &hit
 	// the closest one (if another object in the next grid cell is actually closer but we dont realize it yet)
 	do {
 		validIntersectionFound = false;
-		hitObject = NULL;
 		float mostRecent_maxt = min(maxt,min(txfar,tzfar)); // this way no intersection will be valid unless it was within this grid cell
 
-		for (unsigned int i=0; i<_maxItemsPerCell; i++)
+		SpatialDatabaseItemPtr * items;
+		SpatialDatabaseItemPtr * itemsEnd;
+		if (obstacleLayer) {
+			items = _getObstacleCellItems(currentBin);
+			itemsEnd = _getObstacleCellItems(currentBin + 1);
+		}
+		else {
+			items = _cells[currentBin]._items;
+			itemsEnd = items + _cells[currentBin]._numItems;
+		}
+		for (; items != itemsEnd; items++)
 		{
-
-			if ((_cells[currentBin]._items[i] != NULL) && (_cells[currentBin]._items[i] != exclude)) // && (_cells[currentBin]._numItems > i))
+			if ((*items != exclude1) && (*items != exclude2) && (!lineOfSight || (*items)->blocksLineOfSight()))
 			{ // Getting trace errors for outside of mapped region.
 				// Access not within mapped region at address 0xFFFFFFE00991E050
 
-				if ((excludeAgents) && _cells[currentBin]._items[i]->isAgent())
-					continue;
-
 				float temp_t;
 				bool intersected;
 				intersected = false;
@@ -521,30 +840,30 @@ bool GridDatabase2D::trace(const Ray & r, float & t, SpatialDatabaseItemPtr &hit
 				tempRay.initWithUnitInterval(r.pos, r.dir);
 				tempRay.maxt = mostRecent_maxt;
 				tempRay.mint = mint;
-				intersected = _cells[currentBin]._items[i]->intersects(tempRay,temp_t);
+				intersected = (*items)->intersects(tempRay,temp_t);
 				if ((intersected) && (temp_t < mostRecent_maxt)) {
 					// found a valid intersection, set all the values appropriately
 					validIntersectionFound = true;
 					mostRecent_maxt = temp_t;
 					t = temp_t;
-					hitObject = _cells[currentBin]._items[i];
+					hitObject = *items;
 				}
 			}
 		}
 
 		// if a valid intersection was found in this bin, then just return
-		if (validIntersectionFound) { return true; }
+		if (validIntersectionFound) { return RAY_MARCH_HIT; }
 
 		// otherwise, decide which way to move to the next grid cell
 		if (txfar < tzfar) {
 			// then move along the x grid cells
 			if (r.dir.x < 0.0f) {
                 if (x == 0)
-                    return false; // no intersection found yet, and next we'd be out of bounds.
+                    return RAY_MARCH_LEFT_GRID; // no intersection found yet, and next we'd be out of bounds.
 				x--;
 			} else {
-                if (x == _xNumCells)
-                    return false; // no intersection found yet, and next we'd be out of bounds.
+                if (x == xNumCells)
+                    return RAY_MARCH_LEFT_GRID; // no intersection found yet, and next we'd be out of bounds.
 				x++;
             }
 		}
@@ -552,18 +871,22 @@ bool GridDatabase2D::trace(const Ray & r, float & t, SpatialDatabaseItemPtr &hit
 			// then move along the z grid cells
 			if (r.dir.z < 0.0f) {
                 if (z == 0)
-                    return false; // no intersection found yet, and next we'd be out of bounds.
+                    return RAY_MARCH_LEFT_GRID; // no intersection found yet, and next we'd be out of bounds.
 				z--;
 			} else {
-                if (z == _zNumCells)
-                    return false; // no intersection found yet, and next we'd be out of bounds.
+                if (z == zNumCells)
+                    return RAY_MARCH_LEFT_GRID; // no intersection found yet, and next we'd be out of bounds.
 				z++;
             }
         }
 
+		// the ray left the grid through its far side, which is beyond maxt.
+		if ((x >= xNumCells) || (z >= zNumCells)) return RAY_MARCH_REACHED_END;
+
 		// set up info for the next grid cell
-		currentBin = getCellIndexFromGridCoords(x,z);
-		getLocationFromIndex(currentBin, center);
+		currentBin = (x * zNumCells) + z;
+		center.x = (((float)x) + 0.5f)*xCellSize + _xOrigin;
+		center.z = (((float)z) + 0.5f)*zCellSize + _zOrigin;
 		xlow = center.x - xOffset;
 		xhi  = center.x + xOffset;
 		zlow = center.z - zOffset;
@@ -577,146 +900,142 @@ bool GridDatabase2D::trace(const Ray & r, float & t, SpatialDatabaseItemPtr &hit
 
 	} while ( maxt > max(txnear,tznear));  // keep doing this loop until the ray's endpoint is in the cell you just traversed
 
-	return false;
-
+	return RAY_MARCH_REACHED_END;
 }
 
-bool GridDatabase2D::hasLineOfSight(const Ray & r, SpatialDatabaseItemPtr exclude1, SpatialDatabaseItemPtr exclude2)
+bool GridDatabase2D::hasLineOfSight(const Point & p1, const Point & p2, SpatialDatabaseItemPtr exclude1, SpatialDatabaseItemPtr exclude2)
 {
-	// 1. march through grid cells
-	// 2. for each grid cell:
-	//   - test all items in each grid cell
-	// 3. if th intersection found lies within the current grid cell, then return false
-	// 4. else, go on to the next grid cell.
-
-	// just declare all vars in the first place
-	unsigned int x,z; // (x,z) are 2-d coordinates and currentBin is the 1-d index to refer to the bin being traversed
-	int currentBin;
-	Point center;
-	float xlow, xhi, zlow, zhi, xOffset, zOffset;  // spatial info for the grid cell being traversed
-	float txnear, txfar, tznear, tzfar, invRayDirx, invRayDirz;
-	float maxt, mint;
-	bool validIntersectionFound;
-
-	// one-time initialization stuff here
-	currentBin = getCellIndexFromLocation(r.pos.x, r.pos.z);
-	if (currentBin == -1) return true;
-	getGridCoordinatesFromIndex(currentBin,x,z);
-	invRayDirx = 1.0f / r.dir.x;
-	invRayDirz = 1.0f / r.dir.z;
-	xOffset = 0.5f * _xGridSize / ((float)_xNumCells);
-	zOffset = 0.5f * _zGridSize / ((float)_zNumCells);
-
-	// clamp maxt to be within the grid
-	xlow = _xOrigin;
-	xhi  = _xOrigin + _xGridSize;
-	zlow = _xOrigin;
-	zhi  = _xOrigin + _zGridSize;
-	txnear = (xlow-r.pos.x) * invRayDirx;
-	txfar = (xhi -r.pos.x) * invRayDirx;
-	if (txnear>txfar) swap(txnear,txfar);
-	tznear = (zlow-r.pos.z) * invRayDirz;
-	tzfar = (zhi -r.pos.z) * invRayDirz;
-	if (tznear>tzfar) swap(tznear,tzfar);
-	maxt = min(r.maxt, min(txfar, tzfar));  // txnear and tznear will be "behind" the ray, since this bounding box is the entire grid and we only reach this code if the position is inside of the grid.
-
-	// ****** URGENT TODO: ***** really should clamp mint, too...  if you are crashing when the agent is outside the grid, check this error.
-	mint = r.mint;
-
-	// set up info for the first grid cell
-	getLocationFromIndex(currentBin, center);
-	xlow = center.x - xOffset;
-	xhi  = center.x + xOffset;
-	zlow = center.z - zOffset;
-	zhi  = center.z + zOffset;
-	txnear = (xlow-r.pos.x) * invRayDirx;
-	txfar = (xhi -r.pos.x) * invRayDirx;
-	if (txnear>txfar) swap(txnear,txfar);
-	tznear = (zlow-r.pos.z) * invRayDirz;
-	tzfar = (zhi -r.pos.z) * invRayDirz;
-	if (tznear>tzfar) swap(tznear,tzfar);
+	Ray r;
+	r.initWithUnitInterval(p1, p2-p1);
+	return hasLineOfSight(r, exclude1, exclude2);
+}
 
-	// march through all appropriate grid cells, in order, terminating early when an *appropriate* intersection is found
-	// "appropriate" means that the t value is INSIDE of the grid cell.  otherwise there is a risk of that t value not being
-	// the closest one (if another object in the next grid cell is actually closer but we dont realize it yet)
-	do {
-		validIntersectionFound = false;
-		float mostRecent_maxt = min(maxt,min(txfar,tzfar)); // this way no intersection will be valid unless it was within this grid cell
+//
+// packet ray queries - the rays of a packet, such as the feelers of one agent, are checked once against the grid bounds, and
+// then each ray is marched with an incremental DDA: the next cell boundary along each axis is advanced by a constant step,
+// instead of recomputing the bounds of every cell from its index as trace() does.  A ray stops at the first cell that
+// contains its nearest hit, so short feelers that hit a neighbor only visit one or two cells.
+//
+bool GridDatabase2D::_canTracePacket(const Ray * rays, unsigned int numRays)
+{
+	for (unsigned int i=0; i<numRays; i++) {
+		const Ray & r = rays[i];
+		if ((r.maxt > 1e10f) || (r.mint > r.maxt)) return false;
+		Point p1 = r.eval(r.mint);
+		Point p2 = r.eval(r.maxt);
+		if ((getCellIndexFromLocation(p1.x, p1.z) == -1) || (getCellIndexFromLocation(p2.x, p2.z) == -1)) return false;
+	}
+	return true;
+}
 
-		for (unsigned int i=0; i<_maxItemsPerCell; i++) {
-			if ((_cells[currentBin]._items[i] != NULL) && (_cells[currentBin]._items[i] != exclude1) 
-				&& (_cells[currentBin]._items[i] != exclude2) && (_cells[currentBin]._items[i]->blocksLineOfSight())) {
 
-				float temp_t;
-				bool intersected;
-				intersected = false;
-				Ray tempRay;
-				tempRay.initWithUnitInterval(r.pos, r.dir);
-				tempRay.maxt = mostRecent_maxt;
-				tempRay.mint = mint;
-				intersected = _cells[currentBin]._items[i]->intersects(tempRay,temp_t);
-				if ((intersected) && (temp_t < mostRecent_maxt)) {
-					// found a valid intersection, set all the values appropriately
-					validIntersectionFound = true;
-					mostRecent_maxt = temp_t;
-				}
+bool GridDatabase2D::_marchRay(const Ray & r, bool obstacleLayer, float & nearest, SpatialDatabaseItemPtr & hitObject, SpatialDatabaseItemPtr exclude1, SpatialDatabaseItemPtr exclude2, bool lineOfSight)
+{
+	unsigned int xNumCells = obstacleLayer ? _xNumObstacleCells : _xNumCells;
+	unsigned int zNumCells = obstacleLayer ? _zNumObstacleCells : _zNumCells;
+	float xCellSize = obstacleLayer ? _xObstacleCellSize : _xCellSize;
+	float zCellSize = obstacleLayer ? _zObstacleCellSize : _zCellSize;
+
+	Point start = r.eval(r.mint);
+	int x = (int)((start.x - _xOrigin) * _xInvGridSize * xNumCells);
+	int z = (int)((start.z - _zOrigin) * _zInvGridSize * zNumCells);
+
+	// t of the next cell boundary along each axis, and the t between two boundaries.
+	int xStep = (r.dir.x < 0.0f) ? -1 : 1;
+	int zStep = (r.dir.z < 0.0f) ? -1 : 1;
+	float invDirX = 1.0f / r.dir.x;
+	float invDirZ = 1.0f / r.dir.z;
+	float txNext = (r.dir.x == 0.0f) ? FLT_MAX : (_xOrigin + (x + (xStep > 0 ? 1 : 0)) * xCellSize - r.pos.x) * invDirX;
+	float tzNext = (r.dir.z == 0.0f) ? FLT_MAX : (_zOrigin + (z + (zStep > 0 ? 1 : 0)) * zCellSize - r.pos.z) * invDirZ;
+	float txDelta = (r.dir.x == 0.0f) ? FLT_MAX : xCellSize * fabsf(invDirX);
+	float tzDelta = (r.dir.z == 0.0f) ? FLT_MAX : zCellSize * fabsf(invDirZ);
+
+	for (;;) {
+		unsigned int cellIndex = (x * zNumCells) + z;
+		SpatialDatabaseItemPtr * items;
+		SpatialDatabaseItemPtr * itemsEnd;
+		if (obstacleLayer) {
+			items = _getObstacleCellItems(cellIndex);
+			itemsEnd = _getObstacleCellItems(cellIndex + 1);
+		}
+		else {
+			items = _cells[cellIndex]._items;
+			itemsEnd = items + _cells[cellIndex]._numItems;
+		}
+		for (; items != itemsEnd; items++) {
+			SpatialDatabaseItemPtr item = *items;
+			if ((item == exclude1) || (item == exclude2)) continue;
+			if (lineOfSight && !item->blocksLineOfSight()) continue;
+
+			Ray tempRay = r;
+			tempRay.maxt = nearest;
+			float temp_t;
+			if (item->intersects(tempRay, temp_t) && (temp_t < nearest)) {
+				nearest = temp_t;
+				hitObject = item;
+				if (lineOfSight) return true;
 			}
 		}
 
+		// a hit inside the cells visited so far cannot be beaten by the cells that follow.
+		float tCellExit = min(txNext, tzNext);
+		if ((hitObject != NULL) && (nearest <= tCellExit)) return true;
+		if (tCellExit >= r.maxt) break;
 
-		// if a valid intersection was found in this bin, then just return
-		if (validIntersectionFound) { return false; }
-
-		// otherwise, decide which way to move to the next grid cell
-		if (txfar < tzfar) {
-			// then move along the x grid cells
-			if (r.dir.x < 0.0f) {
-                if (x == 0)
-                    return false; // no intersection found yet, and next we'd be out of bounds.
-				x--;
-			} else {
-                if (x == _xNumCells)
-                    return false; // no intersection found yet, and next we'd be out of bounds.
-				x++;
-            }
+		if (txNext < tzNext) {
+			x += xStep;
+			txNext += txDelta;
 		}
 		else {
-			// then move along the z grid cells
-			if (r.dir.z < 0.0f) {
-                if (z == 0)
-                    return false; // no intersection found yet, and next we'd be out of bounds.
-				z--;
-			} else {
-                if (z == _zNumCells)
-                    return false; // no intersection found yet, and next we'd be out of bounds.
-				z++;
-            }
+			z += zStep;
+			tzNext += tzDelta;
 		}
+		if ((x < 0) || (x >= (int)xNumCells) || (z < 0) || (z >= (int)zNumCells)) break;
+	}
+	return (hitObject != NULL);
+}
 
-		// set up info for the next grid cell
-		currentBin = getCellIndexFromGridCoords(x,z);
-		getLocationFromIndex(currentBin, center);
-		xlow = center.x - xOffset;
-		xhi  = center.x + xOffset;
-		zlow = center.z - zOffset;
-		zhi  = center.z + zOffset;
-		txnear = (xlow-r.pos.x) * invRayDirx;
-		txfar = (xhi -r.pos.x) * invRayDirx;
-		if (txnear>txfar) swap(txnear,txfar);
-		tznear = (zlow-r.pos.z) * invRayDirz;
-		tzfar = (zhi -r.pos.z) * invRayDirz;
-		if (tznear>tzfar) swap(tznear,tzfar);
 
-	} while ( maxt > max(txnear,tznear));  // keep doing this loop until the ray's endpoint is in the cell you just traversed
+unsigned int GridDatabase2D::tracePacket(const Ray * rays, unsigned int numRays, float * t, SpatialDatabaseItemPtr * hitObjects, SpatialDatabaseItemPtr exclude, bool excludeAgents)
+{
+	if (!_canTracePacket(rays, numRays)) {
+		return SpatialDataBaseInterface::tracePacket(rays, numRays, t, hitObjects, exclude, excludeAgents);
+	}
 
-	return true;
+	_updateObstacleLayer();
+	unsigned int numHits = 0;
+	for (unsigned int i=0; i<numRays; i++) {
+		// like trace(), the obstacle layer only needs to find a hit nearer than the nearest agent.
+		float nearest = rays[i].maxt;
+		hitObjects[i] = NULL;
+		if (!excludeAgents) {
+			_marchRay(rays[i], false, nearest, hitObjects[i], exclude, NULL, false);
+		}
+		if (_marchRay(rays[i], true, nearest, hitObjects[i], exclude, NULL, false)) {
+			// like trace(), t[i] is only written if ray i hits something
+			t[i] = nearest;
+			numHits++;
+		}
+	}
+	return numHits;
 }
 
-bool GridDatabase2D::hasLineOfSight(const Point & p1, const Point & p2, SpatialDatabaseItemPtr exclude1, SpatialDatabaseItemPtr exclude2)
+
+unsigned int GridDatabase2D::hasLineOfSightPacket(const Ray * rays, unsigned int numRays, bool * visible, SpatialDatabaseItemPtr exclude1, SpatialDatabaseItemPtr exclude2)
 {
-	Ray r;
-	r.initWithUnitInterval(p1, p2-p1);
-	return hasLineOfSight(r, exclude1, exclude2);
+	if (!_canTracePacket(rays, numRays)) {
+		return SpatialDataBaseInterface::hasLineOfSightPacket(rays, numRays, visible, exclude1, exclude2);
+	}
+
+	_updateObstacleLayer();
+	unsigned int numVisible = 0;
+	for (unsigned int i=0; i<numRays; i++) {
+		float nearest = rays[i].maxt;
+		SpatialDatabaseItemPtr blocker = NULL;
+		visible[i] = !_marchRay(rays[i], true, nearest, blocker, exclude1, exclude2, true) && !_marchRay(rays[i], false, nearest, blocker, exclude1, exclude2, true);
+		if (visible[i]) numVisible++;
+	}
+	return numVisible;
 }
 
 
@@ -728,8 +1047,7 @@ Point GridDatabase2D::randomPositionWithoutCollisions(float radius, bool exclude
 
 Point GridDatabase2D::randomPositionInRegionWithoutCollisions(const AxisAlignedBox & region, float radius, bool excludeAgents)
 {
-	static MTRand _randomNumberGenerator(2);
-	return randomPositionInRegionWithoutCollisions(region, radius, excludeAgents, _randomNumberGenerator);
+	return randomPositionInRegionWithoutCollisions(region, radius, excludeAgents, *_randomNumberGenerator);
 }
 
 Point GridDatabase2D::randomPositionInRegionWithoutCollisions(const AxisAlignedBox & region, float radius, bool excludeAgents,  MTRand & randomNumberGenerator)
@@ -798,7 +1116,7 @@ bool GridDatabase2D::randomPositionInRegionWithoutCollisions(const Util::AxisAli
 
 	if ( item->isAgent() )
 	{
-		ai = dynamic_cast<AgentInterface*>(item);
+		ai = asAgent(item);
 		radius = ai->radius();
 		aic = ai->getAgentConditions(ai);
 	}
@@ -0,0 +1,149 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+/// @file NeighborListService.cpp
+/// @brief Implements the SteerLib::NeighborListService class.
+
+#include <algorithm>
+#include <cmath>
+#include "simulation/NeighborListService.h"
+#include "interfaces/AgentInterface.h"
+#include "interfaces/ObstacleInterface.h"
+#include "interfaces/SpatialDataBaseInterface.h"
+#include "util/TraceProfiler.h"
+
+using namespace SteerLib;
+using namespace Util;
+
+
+NeighborListService::NeighborListService()
+{
+	_spatialDatabase = NULL;
+	_skin = 0.0f;
+	clear();
+}
+
+
+void NeighborListService::init(SpatialDataBaseInterface * spatialDatabase, float skin)
+{
+	_spatialDatabase = spatialDatabase;
+	_skin = (skin > 0.0f) ? skin : 0.0f;
+	clear();
+}
+
+
+void NeighborListService::clear()
+{
+	_queryRange = 0.0f;
+	_valid = false;
+	_numRebuilds = 0;
+	_listedAgents.clear();
+	_positionsAtRebuild.clear();
+	_lists.clear();
+	_listIndices.clear();
+}
+
+
+void NeighborListService::requestQueryRange(float range)
+{
+	if (range > _queryRange) {
+		_queryRange = range;
+		_valid = false;
+	}
+}
+
+
+const NeighborList * NeighborListService::getNeighbors(const AgentInterface * agent) const
+{
+	std::map<const AgentInterface*, unsigned int>::const_iterator index = _listIndices.find(agent);
+	if (index == _listIndices.end()) {
+		return NULL;
+	}
+	return &_lists[index->second];
+}
+
+
+bool NeighborListService::isAgentInRange(AgentInterface * agent, float xmin, float xmax, float zmin, float zmax)
+{
+	Point p = agent->position();
+	float r = agent->radius();
+	return (p.x + r >= xmin) && (p.x - r <= xmax) && (p.z + r >= zmin) && (p.z - r <= zmax);
+}
+
+
+bool NeighborListService::isObstacleInRange(ObstacleInterface * obstacle, float xmin, float xmax, float zmin, float zmax)
+{
+	const AxisAlignedBox & b = obstacle->getBounds();
+	return (b.xmax >= xmin) && (b.xmin <= xmax) && (b.zmax >= zmin) && (b.zmin <= zmax);
+}
+
+
+void NeighborListService::update(const std::vector<AgentInterface*> & agents, float dt)
+{
+	if (!isActive() || (_spatialDatabase == NULL)) {
+		return;
+	}
+	if (_needsRebuild(agents, dt)) {
+		TraceScope traceRebuild("neighborListRebuild");
+		_rebuild(agents);
+	}
+}
+
+
+bool NeighborListService::_needsRebuild(const std::vector<AgentInterface*> & agents, float dt) const
+{
+	if (!_valid) {
+		return true;
+	}
+
+	// the enabled agents must be the same, in the same order, and none may move more than half the skin by the end of this frame.
+	// the agents are updated one at a time, so a neighbor may already have taken this frame's step when an agent reads its list.
+	float maxDisplacementSquared = 0.0f;
+	float maxSpeedSquared = 0.0f;
+	size_t listed = 0;
+	for (size_t i = 0; i < agents.size(); i++) {
+		if (!agents[i]->enabled()) {
+			continue;
+		}
+		if ((listed >= _listedAgents.size()) || (_listedAgents[listed] != agents[i])) {
+			return true;
+		}
+		maxDisplacementSquared = std::max(maxDisplacementSquared, (agents[i]->position() - _positionsAtRebuild[listed]).lengthSquared());
+		maxSpeedSquared = std::max(maxSpeedSquared, agents[i]->velocity().lengthSquared());
+		listed++;
+	}
+	if (listed != _listedAgents.size()) {
+		return true;
+	}
+	return (sqrtf(maxDisplacementSquared) + sqrtf(maxSpeedSquared) * dt > 0.5f * _skin);
+}
+
+
+void NeighborListService::_rebuild(const std::vector<AgentInterface*> & agents)
+{
+	_listedAgents.clear();
+	_positionsAtRebuild.clear();
+	_listIndices.clear();
+	for (size_t i = 0; i < agents.size(); i++) {
+		if (agents[i]->enabled()) {
+			_listIndices[agents[i]] = (unsigned int)_listedAgents.size();
+			_listedAgents.push_back(agents[i]);
+			_positionsAtRebuild.push_back(agents[i]->position());
+		}
+	}
+	_lists.resize(_listedAgents.size());
+
+	float range = _queryRange + _skin;
+	for (size_t i = 0; i < _listedAgents.size(); i++) {
+		const Point & p = _positionsAtRebuild[i];
+		NeighborList & list = _lists[i];
+		_spatialDatabase->getAgentsInRange(list.agents, p.x - range, p.x + range, p.z - range, p.z + range, _listedAgents[i]);
+		_spatialDatabase->getObstaclesInRange(list.obstacles, p.x - range, p.x + range, p.z - range, p.z + range, _listedAgents[i]);
+	}
+
+	_valid = true;
+	_numRebuilds++;
+}
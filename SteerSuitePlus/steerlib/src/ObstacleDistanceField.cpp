@@ -0,0 +1,318 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+/// @file ObstacleDistanceField.cpp
+/// @brief Implements the SteerLib::ObstacleDistanceField class.
+
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include "simulation/ObstacleDistanceField.h"
+#include "interfaces/ObstacleInterface.h"
+#include "obstacles/CircleObstacle.h"
+#include "util/TraceProfiler.h"
+
+using namespace SteerLib;
+using namespace Util;
+
+
+ObstacleDistanceField::ObstacleDistanceField()
+{
+	_cellSize = 1.0f;
+	clear();
+}
+
+
+void ObstacleDistanceField::init(float cellSize)
+{
+	_cellSize = (cellSize > 0.0f) ? cellSize : 1.0f;
+	clear();
+}
+
+
+void ObstacleDistanceField::clear()
+{
+	_maxDistance = 0.0f;
+	_built = false;
+	_hasDirtyRegion = false;
+	_originX = 0.0f;
+	_originZ = 0.0f;
+	_numSamplesX = 0;
+	_numSamplesZ = 0;
+	_samples.clear();
+}
+
+
+void ObstacleDistanceField::requestMaxDistance(float maxDistance)
+{
+	if (maxDistance > _maxDistance) {
+		_maxDistance = maxDistance;
+		_built = false;
+	}
+}
+
+
+void ObstacleDistanceField::obstacleAdded(ObstacleInterface * obstacle)
+{
+	// before the first build there is nothing to patch; the build sees every obstacle.
+	if (!_built) {
+		return;
+	}
+	AxisAlignedBox influence = _getInfluenceBounds(obstacle);
+	if (!_hasDirtyRegion) {
+		_dirtyRegion = influence;
+		_hasDirtyRegion = true;
+	}
+	else {
+		_dirtyRegion.xmin = std::min(_dirtyRegion.xmin, influence.xmin);
+		_dirtyRegion.xmax = std::max(_dirtyRegion.xmax, influence.xmax);
+		_dirtyRegion.zmin = std::min(_dirtyRegion.zmin, influence.zmin);
+		_dirtyRegion.zmax = std::max(_dirtyRegion.zmax, influence.zmax);
+	}
+}
+
+
+void ObstacleDistanceField::obstacleRemoved(ObstacleInterface * obstacle)
+{
+	// the samples that the obstacle influenced are recomputed from the remaining obstacles.
+	obstacleAdded(obstacle);
+}
+
+
+AxisAlignedBox ObstacleDistanceField::_getInfluenceBounds(ObstacleInterface * obstacle) const
+{
+	const AxisAlignedBox & b = obstacle->getBounds();
+	return AxisAlignedBox(b.xmin - _maxDistance, b.xmax + _maxDistance, b.ymin, b.ymax, b.zmin - _maxDistance, b.zmax + _maxDistance);
+}
+
+
+void ObstacleDistanceField::update(const std::set<ObstacleInterface*> & obstacles)
+{
+	if (!isActive()) {
+		return;
+	}
+
+	if (!_built) {
+		TraceScope traceBuild("distanceFieldBuild");
+		_build(obstacles);
+		return;
+	}
+
+	if (_hasDirtyRegion) {
+		// an obstacle outside the covered area needs a larger field.
+		float fieldXMax = _originX + (float)((int)_numSamplesX - 1) * _cellSize;
+		float fieldZMax = _originZ + (float)((int)_numSamplesZ - 1) * _cellSize;
+		TraceScope traceUpdate("distanceFieldUpdate");
+		if ((_numSamplesX == 0) || (_dirtyRegion.xmin < _originX) || (_dirtyRegion.zmin < _originZ) || (_dirtyRegion.xmax > fieldXMax) || (_dirtyRegion.zmax > fieldZMax)) {
+			_build(obstacles);
+		}
+		else {
+			_recompute(obstacles, _dirtyRegion);
+			_hasDirtyRegion = false;
+		}
+	}
+}
+
+
+void ObstacleDistanceField::_build(const std::set<ObstacleInterface*> & obstacles)
+{
+	_samples.clear();
+	_numSamplesX = 0;
+	_numSamplesZ = 0;
+	_built = true;
+	_hasDirtyRegion = false;
+
+	if (obstacles.empty()) {
+		return;
+	}
+
+	AxisAlignedBox region(FLT_MAX, -FLT_MAX, 0.0f, 0.0f, FLT_MAX, -FLT_MAX);
+	for (std::set<ObstacleInterface*>::const_iterator obstacle = obstacles.begin(); obstacle != obstacles.end(); ++obstacle) {
+		AxisAlignedBox influence = _getInfluenceBounds(*obstacle);
+		region.xmin = std::min(region.xmin, influence.xmin);
+		region.xmax = std::max(region.xmax, influence.xmax);
+		region.zmin = std::min(region.zmin, influence.zmin);
+		region.zmax = std::max(region.zmax, influence.zmax);
+	}
+
+	_originX = region.xmin;
+	_originZ = region.zmin;
+	_numSamplesX = (unsigned int)ceil((region.xmax - region.xmin) / _cellSize) + 1;
+	_numSamplesZ = (unsigned int)ceil((region.zmax - region.zmin) / _cellSize) + 1;
+	_samples.resize((size_t)_numSamplesX * _numSamplesZ);
+
+	AxisAlignedBox all(_originX, _originX + (float)(_numSamplesX - 1) * _cellSize, 0.0f, 0.0f, _originZ, _originZ + (float)(_numSamplesZ - 1) * _cellSize);
+	_recompute(obstacles, all);
+}
+
+
+bool ObstacleDistanceField::_getSampleRange(const AxisAlignedBox & box, int & ixmin, int & ixmax, int & izmin, int & izmax) const
+{
+	ixmin = std::max(0, (int)floor((box.xmin - _originX) / _cellSize));
+	ixmax = std::min((int)_numSamplesX - 1, (int)ceil((box.xmax - _originX) / _cellSize));
+	izmin = std::max(0, (int)floor((box.zmin - _originZ) / _cellSize));
+	izmax = std::min((int)_numSamplesZ - 1, (int)ceil((box.zmax - _originZ) / _cellSize));
+	return (ixmin <= ixmax) && (izmin <= izmax);
+}
+
+
+void ObstacleDistanceField::_recompute(const std::set<ObstacleInterface*> & obstacles, const AxisAlignedBox & region)
+{
+	int ixmin, ixmax, izmin, izmax;
+	if (!_getSampleRange(region, ixmin, ixmax, izmin, izmax)) {
+		return;
+	}
+
+	for (int iz = izmin; iz <= izmax; iz++) {
+		for (int ix = ixmin; ix <= ixmax; ix++) {
+			Sample & sample = _samples[(size_t)iz * _numSamplesX + ix];
+			sample.distance = _maxDistance;
+			sample.normalX = 0.0f;
+			sample.normalZ = 0.0f;
+		}
+	}
+
+	for (std::set<ObstacleInterface*>::const_iterator obstacle = obstacles.begin(); obstacle != obstacles.end(); ++obstacle) {
+		int oxmin, oxmax, ozmin, ozmax;
+		if (_getSampleRange(_getInfluenceBounds(*obstacle), oxmin, oxmax, ozmin, ozmax)) {
+			oxmin = std::max(oxmin, ixmin);
+			oxmax = std::min(oxmax, ixmax);
+			ozmin = std::max(ozmin, izmin);
+			ozmax = std::min(ozmax, izmax);
+			if ((oxmin <= oxmax) && (ozmin <= ozmax)) {
+				_splatObstacle(*obstacle, oxmin, oxmax, ozmin, ozmax);
+			}
+		}
+	}
+}
+
+
+void ObstacleDistanceField::_splatObstacle(ObstacleInterface * obstacle, int ixmin, int ixmax, int izmin, int izmax)
+{
+	// circles are measured exactly; everything else against its outline.
+	CircleObstacle * circle = dynamic_cast<CircleObstacle*>(obstacle);
+	std::vector<Point> outline;
+	if (circle == NULL) {
+		outline = obstacle->get2DStaticGeometry();
+		if (outline.empty()) {
+			return;
+		}
+	}
+
+	for (int iz = izmin; iz <= izmax; iz++) {
+		for (int ix = ixmin; ix <= ixmax; ix++) {
+			Point p(_originX + (float)ix * _cellSize, 0.0f, _originZ + (float)iz * _cellSize);
+			float distance;
+			float normalX = 0.0f;
+			float normalZ = 0.0f;
+
+			if (circle != NULL) {
+				float dx = p.x - circle->position().x;
+				float dz = p.z - circle->position().z;
+				float centerDistance = sqrtf(dx * dx + dz * dz);
+				distance = centerDistance - circle->radius();
+				if (centerDistance > 0.0f) {
+					normalX = dx / centerDistance;
+					normalZ = dz / centerDistance;
+				}
+			}
+			else {
+				// closest point on the outline, and a crossing test to tell whether p is inside it.
+				float closestDistanceSquared = FLT_MAX;
+				float closestX = outline[0].x;
+				float closestZ = outline[0].z;
+				bool inside = false;
+				size_t numVertices = outline.size();
+				for (size_t i = 0, j = numVertices - 1; i < numVertices; j = i++) {
+					const Point & a = outline[j];
+					const Point & b = outline[i];
+					float ex = b.x - a.x;
+					float ez = b.z - a.z;
+					float lengthSquared = ex * ex + ez * ez;
+					float t = (lengthSquared > 0.0f) ? ((p.x - a.x) * ex + (p.z - a.z) * ez) / lengthSquared : 0.0f;
+					t = std::max(0.0f, std::min(1.0f, t));
+					float cx = a.x + t * ex;
+					float cz = a.z + t * ez;
+					float distanceSquared = (p.x - cx) * (p.x - cx) + (p.z - cz) * (p.z - cz);
+					if (distanceSquared < closestDistanceSquared) {
+						closestDistanceSquared = distanceSquared;
+						closestX = cx;
+						closestZ = cz;
+					}
+					if (((a.z > p.z) != (b.z > p.z)) && (p.x < a.x + (p.z - a.z) * ex / ez)) {
+						inside = !inside;
+					}
+				}
+				if (numVertices < 3) {
+					inside = false;
+				}
+
+				distance = sqrtf(closestDistanceSquared);
+				if (distance > 0.0f) {
+					normalX = (p.x - closestX) / distance;
+					normalZ = (p.z - closestZ) / distance;
+				}
+				if (inside) {
+					distance = -distance;
+					normalX = -normalX;
+					normalZ = -normalZ;
+				}
+			}
+
+			Sample & sample = _samples[(size_t)iz * _numSamplesX + ix];
+			if (distance < sample.distance) {
+				sample.distance = distance;
+				sample.normalX = normalX;
+				sample.normalZ = normalZ;
+			}
+		}
+	}
+}
+
+
+float ObstacleDistanceField::getDistance(const Point & p) const
+{
+	Vector normal;
+	return getDistanceAndNormal(p, normal);
+}
+
+
+float ObstacleDistanceField::getDistanceAndNormal(const Point & p, Vector & normal) const
+{
+	normal = Vector(0.0f, 0.0f, 0.0f);
+	if ((_numSamplesX < 2) || (_numSamplesZ < 2)) {
+		return _maxDistance;
+	}
+
+	float fx = (p.x - _originX) / _cellSize;
+	float fz = (p.z - _originZ) / _cellSize;
+	if ((fx < 0.0f) || (fz < 0.0f) || (fx > (float)(_numSamplesX - 1)) || (fz > (float)(_numSamplesZ - 1))) {
+		return _maxDistance;
+	}
+
+	unsigned int ix = std::min((unsigned int)fx, _numSamplesX - 2);
+	unsigned int iz = std::min((unsigned int)fz, _numSamplesZ - 2);
+	float tx = fx - (float)ix;
+	float tz = fz - (float)iz;
+
+	const Sample & s00 = _samples[(size_t)iz * _numSamplesX + ix];
+	const Sample & s10 = _samples[(size_t)iz * _numSamplesX + ix + 1];
+	const Sample & s01 = _samples[(size_t)(iz + 1) * _numSamplesX + ix];
+	const Sample & s11 = _samples[(size_t)(iz + 1) * _numSamplesX + ix + 1];
+
+	float w00 = (1.0f - tx) * (1.0f - tz);
+	float w10 = tx * (1.0f - tz);
+	float w01 = (1.0f - tx) * tz;
+	float w11 = tx * tz;
+
+	float normalX = w00 * s00.normalX + w10 * s10.normalX + w01 * s01.normalX + w11 * s11.normalX;
+	float normalZ = w00 * s00.normalZ + w10 * s10.normalZ + w01 * s01.normalZ + w11 * s11.normalZ;
+	float length = sqrtf(normalX * normalX + normalZ * normalZ);
+	if (length > 0.0f) {
+		normal = Vector(normalX / length, 0.0f, normalZ / length);
+	}
+	return w00 * s00.distance + w10 * s10.distance + w01 * s01.distance + w11 * s11.distance;
+}
@@ -0,0 +1,217 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+/// @file PhaseScheduler.cpp
+/// @brief Implements the SteerLib::PhaseScheduler class.
+
+#include <iomanip>
+#include "simulation/PhaseScheduler.h"
+#include "simulation/SimulationCheckpoint.h"
+#include "util/GenericException.h"
+
+using namespace SteerLib;
+
+
+PhaseScheduler::PhaseScheduler()
+{
+	init(0);
+}
+
+
+void PhaseScheduler::init(unsigned int numPhases)
+{
+	_numPhases = numPhases;
+	_intervals.assign(numPhases, 1);
+	_slotLoads.assign(numPhases, std::vector<unsigned int>(1, 0));
+	clear();
+}
+
+
+void PhaseScheduler::setInterval(unsigned int phase, unsigned int interval)
+{
+	if (_numClients != 0) {
+		throw Util::GenericException("PhaseScheduler::setInterval() cannot change an interval after clients were added.");
+	}
+	if (interval == 0) {
+		interval = 1;
+	}
+	_intervals[phase] = interval;
+	_slotLoads[phase].assign(interval, 0);
+}
+
+
+void PhaseScheduler::clear()
+{
+	for (unsigned int phase = 0; phase < _numPhases; phase++) {
+		_slotLoads[phase].assign(_intervals[phase], 0);
+	}
+	_offsets.clear();
+	_active.clear();
+	_numClients = 0;
+	_phaseCounts.clear();
+}
+
+
+unsigned int PhaseScheduler::addClient()
+{
+	unsigned int client = (unsigned int)_active.size();
+	_active.push_back(1);
+	_numClients++;
+	for (unsigned int phase = 0; phase < _numPhases; phase++) {
+		unsigned int slot = _getLeastUsedSlot(phase);
+		_offsets.push_back(slot);
+		_slotLoads[phase][slot]++;
+	}
+	return client;
+}
+
+
+void PhaseScheduler::removeClient(unsigned int client)
+{
+	if ((client >= _active.size()) || !_active[client]) {
+		return;
+	}
+	_active[client] = 0;
+	_numClients--;
+	for (unsigned int phase = 0; phase < _numPhases; phase++) {
+		_slotLoads[phase][_offsets[client * _numPhases + phase]]--;
+		_rebalance(phase);
+	}
+}
+
+
+unsigned int PhaseScheduler::getOffset(unsigned int client, unsigned int phase) const
+{
+	return _offsets[client * _numPhases + phase];
+}
+
+
+unsigned int PhaseScheduler::getNextFrame(unsigned int client, unsigned int phase, unsigned int lastFrame) const
+{
+	unsigned int interval = _intervals[phase];
+	unsigned int frame = lastFrame + 1;
+	return frame + (getOffset(client, phase) + interval - (frame % interval)) % interval;
+}
+
+
+unsigned int PhaseScheduler::_getLeastUsedSlot(unsigned int phase) const
+{
+	const std::vector<unsigned int> & loads = _slotLoads[phase];
+	unsigned int best = 0;
+	for (unsigned int slot = 1; slot < loads.size(); slot++) {
+		if (loads[slot] < loads[best]) {
+			best = slot;
+		}
+	}
+	return best;
+}
+
+
+void PhaseScheduler::_rebalance(unsigned int phase)
+{
+	std::vector<unsigned int> & loads = _slotLoads[phase];
+	unsigned int fullest = 0;
+	for (unsigned int slot = 1; slot < loads.size(); slot++) {
+		if (loads[slot] > loads[fullest]) {
+			fullest = slot;
+		}
+	}
+	unsigned int emptiest = _getLeastUsedSlot(phase);
+	if (loads[fullest] <= loads[emptiest] + 1) {
+		return;
+	}
+
+	// move the most recently added client of the fullest slot.
+	for (unsigned int client = (unsigned int)_active.size(); client-- > 0; ) {
+		unsigned int & offset = _offsets[client * _numPhases + phase];
+		if (_active[client] && (offset == fullest)) {
+			offset = emptiest;
+			loads[fullest]--;
+			loads[emptiest]++;
+			return;
+		}
+	}
+}
+
+
+void PhaseScheduler::countPhase(unsigned int phase, unsigned int frame)
+{
+	size_t index = (size_t)frame * _numPhases + phase;
+	if (index >= _phaseCounts.size()) {
+		_phaseCounts.resize(((size_t)frame + 1) * _numPhases, 0);
+	}
+	_phaseCounts[index]++;
+}
+
+
+unsigned int PhaseScheduler::getPhaseCount(unsigned int frame, unsigned int phase) const
+{
+	size_t index = (size_t)frame * _numPhases + phase;
+	return (index < _phaseCounts.size()) ? _phaseCounts[index] : 0;
+}
+
+
+unsigned int PhaseScheduler::getMaxPhaseCount(unsigned int phase, unsigned int firstFrame) const
+{
+	unsigned int maxCount = 0;
+	for (size_t index = (size_t)firstFrame * _numPhases + phase; index < _phaseCounts.size(); index += _numPhases) {
+		if (_phaseCounts[index] > maxCount) {
+			maxCount = _phaseCounts[index];
+		}
+	}
+	return maxCount;
+}
+
+
+float PhaseScheduler::getAveragePhaseCount(unsigned int phase, unsigned int firstFrame) const
+{
+	unsigned int numFrames = getNumFramesCounted();
+	if (numFrames <= firstFrame) {
+		return 0.0f;
+	}
+	unsigned long long total = 0;
+	for (size_t index = (size_t)firstFrame * _numPhases + phase; index < _phaseCounts.size(); index += _numPhases) {
+		total += _phaseCounts[index];
+	}
+	return (float)((double)total / (double)(numFrames - firstFrame));
+}
+
+
+void PhaseScheduler::printStatistics(std::ostream & out, const std::string * names) const
+{
+	out << " PHASE RUNS PER FRAME over " << getNumFramesCounted() << " frames (interval / frame 0 / max after / average after):\n";
+	for (unsigned int phase = 0; phase < _numPhases; phase++) {
+		out << std::setw(11) << names[phase] << ": " << _intervals[phase] << " / " << getPhaseCount(0, phase) << " / " << getMaxPhaseCount(phase, 1) << " / " << getAveragePhaseCount(phase, 1) << "\n";
+	}
+}
+
+
+void PhaseScheduler::saveState(CheckpointWriter & out)
+{
+	out.writeSequence(_intervals);
+	for (unsigned int phase = 0; phase < _numPhases; phase++) {
+		out.writeSequence(_slotLoads[phase]);
+	}
+	out.writeSequence(_offsets);
+	out.writeSequence(_active);
+	out.write(_numClients);
+	out.writeSequence(_phaseCounts);
+}
+
+
+void PhaseScheduler::restoreState(CheckpointReader & in)
+{
+	in.readSequence(_intervals);
+	_numPhases = (unsigned int)_intervals.size();
+	_slotLoads.resize(_numPhases);
+	for (unsigned int phase = 0; phase < _numPhases; phase++) {
+		in.readSequence(_slotLoads[phase]);
+	}
+	in.readSequence(_offsets);
+	in.readSequence(_active);
+	in.read(_numClients);
+	in.readSequence(_phaseCounts);
+}
@@ -126,18 +126,20 @@ void RecFilePlayerModule::initializeSimulation()
 	//
 	// allocate agents, initialize them to frame 0.
 	//
-	for (unsigned int i=0;  i < _simulationReader->getNumAgents(); i++) {
+	SteerLib::RecFileFrameView firstFrame = _simulationReader->getFrameView(0);
+	for (unsigned int i=0;  i < firstFrame.numAgents; i++) {
 		ReplayAgent * agent = new ReplayAgent();
+		const RecFileAgentInfo & info = firstFrame[i];
 
 		/// @todo
 		///   The next version of the RecFileReader should also return an AgentGoalInfo struct, and this indirection should be unnecessary.
 		AgentGoalInfo newGoal;
-		newGoal.targetLocation = _simulationReader->getAgentGoalAtFrame(i,0);
+		newGoal.targetLocation = Util::Point(info.goal.x, info.goal.y, info.goal.z);
 
-		agent->setPosition(_simulationReader->getAgentLocationAtFrame(i,0));
-		agent->setForward(_simulationReader->getAgentOrientationAtFrame(i,0));
-		agent->setEnabled(_simulationReader->isAgentEnabledAtFrame(i,0));
-		agent->setRadius(_simulationReader->getAgentRadiusAtFrame(i,0));
+		agent->setPosition(Util::Point(info.pos.x, info.pos.y, info.pos.z));
+		agent->setForward(Util::Vector(info.dir.x, info.dir.y, info.dir.z));
+		agent->setEnabled(info.enabled);
+		agent->setRadius(info.radius);
 		agent->setCurrentGoal(newGoal);
 		// Best to start out with zero velocity until this support is move into recFileWriter format
 		agent->setVelocity(Util::Vector(0,0,0));
@@ -150,6 +152,9 @@ void RecFilePlayerModule::initializeSimulation()
 		_engine->getSpatialDatabase()->addObject( dynamic_cast<SpatialDatabaseItemPtr>(agent), newBounds);
 	}
 
+	// scratch space for the interpolated agent states, filled in bulk every frame.
+	_agentStates.resize(_simulationReader->getNumAgents());
+
 }
 
 void RecFilePlayerModule::cleanupSimulation()
@@ -175,34 +180,38 @@ void RecFilePlayerModule::preprocessFrame(float timeStamp, float dt, unsigned in
 	const std::vector< SteerLib::AgentInterface * > & agents = _engine->getAgents();
 
 	// for HybridAI
-	std::vector< SteerLib::AgentInterface * > * tmp_agents = new std::vector< SteerLib::AgentInterface * >();
-	for (int a=0; a < agents.size(); a++)
+	std::vector< ReplayAgent * > replayAgents;
+	for (unsigned int a=0; a < agents.size(); a++)
 	{
-		SteerLib::AgentInterface * tmp_agent = dynamic_cast<ReplayAgent *>(agents.at(a));
+		ReplayAgent * tmp_agent = dynamic_cast<ReplayAgent *>(agents[a]);
 		if ( tmp_agent != NULL )
 		{
-			tmp_agents->push_back(tmp_agent);
+			replayAgents.push_back(tmp_agent);
 		}
 	}
 
+	// interpolate every agent at once, instead of one reader query per agent per field.
+	// data() instead of &_agentStates[0], because a rec file may have no agents at all.
+	_simulationReader->getAllAgentsAtTime((float)_currentTimeToPlayback, _agentStates.data());
 
-	for (unsigned int i=0;  i < tmp_agents->size(); i++)
+	for (unsigned int i=0;  i < replayAgents.size(); i++)
 	{
+		const RecFileAgentInfo & info = _agentStates[i];
+
 		/// @todo
 		///   The next version of the RecFileReader should also return an AgentGoalInfo struct, and this indirection should be unnecessary.
 		AgentGoalInfo newGoal;
-		newGoal.targetLocation = _simulationReader->getAgentGoalAtTime(i,(float)_currentTimeToPlayback);
-		ReplayAgent * agent;
-		agent = dynamic_cast<ReplayAgent*>(tmp_agents->at(i));
+		newGoal.targetLocation = Util::Point(info.goal.x, info.goal.y, info.goal.z);
+		ReplayAgent * agent = replayAgents[i];
 		Util::AxisAlignedBox oldBounds(agent->position().x-agent->radius(),
 								agent->position().x+agent->radius(), 0.0f, 0.5f,
 								agent->position().z-agent->radius(), agent->position().z+agent->radius());
 		Util::Point oldLoc = agent->position();
 
-	    agent->setPosition(_simulationReader->getAgentLocationAtTime(i,(float)_currentTimeToPlayback));
-		agent->setForward(_simulationReader->getAgentOrientationAtTime(i,(float)_currentTimeToPlayback));
-		agent->setEnabled(_simulationReader->isAgentEnabledAtTime(i,(float)_currentTimeToPlayback));
-		agent->setRadius(_simulationReader->getAgentRadiusAtTime(i,(float)_currentTimeToPlayback));
+		agent->setPosition(Util::Point(info.pos.x, info.pos.y, info.pos.z));
+		agent->setForward(Util::Vector(info.dir.x, info.dir.y, info.dir.z));
+		agent->setEnabled(info.enabled);
+		agent->setRadius(info.radius);
 		agent->setCurrentGoal(newGoal);
 		// Somewhat good approximation of
 		agent->setVelocity((oldLoc-(agent->position())).length()/dt * agent->forward());
@@ -97,6 +97,38 @@ void RecFileReaderPrivate::_getFramesForTime(float time, unsigned int &frameInde
 }
 
 
+void RecFileReaderPrivate::_interpolateOrientation(const RecFileVectorData & v1, const RecFileVectorData & v2, double alpha, float &dirx, float &diry, float &dirz)
+{
+	RecFileVectorData r1;
+
+	// WARNING: assuming 2-d x-z plane only right now.  eventually NEED to fix this to be generally 3D.
+	if ((v1.y != 0.0f) && (v2.y != 0.0f)) {
+		throw GenericException("currently assuming that orientation is 2D in the x-z plane - cannot interpolate if y component is non-zero.");
+	}
+
+	r1.x = -v1.z;
+	r1.y = v1.y;
+	r1.z = v1.x;
+
+	double invNorm1 = 1.0f / sqrtf(v1.x*v1.x + v1.y*v1.y + v1.z*v1.z);
+	double invNorm2 = 1.0f / sqrtf(v2.x*v2.x + v2.y*v2.y + v2.z*v2.z);
+
+	double cosRatio = ((double)(v1.x*v2.x + v1.y*v2.y + v1.z*v2.z)) * invNorm1 * invNorm2;  // cos x = v1 dot v2 / (|v1| |v2|)
+
+	if (cosRatio > 1.0) cosRatio = 1.0;
+	if (cosRatio < -1.0) cosRatio = -1.0;
+
+	if ( (r1.x*v2.x + r1.y*v2.y + r1.z*v2.z) < 0)
+		alpha = -alpha;
+
+	double angle = alpha * acos( cosRatio );
+
+	dirx = (float)(cos(angle) * v1.x - sin(angle) * v1.z);
+	diry = v1.y;
+	dirz = (float)(sin(angle) * v1.x + cos(angle) * v1.z);
+}
+
+
 
 //===========================================================================
 //===========================================================================
@@ -468,42 +500,8 @@ void RecFileReader::getAgentOrientationAtTime( unsigned int agentIndex, float ti
 	unsigned int frameIndex1, frameIndex2;
 	_getFramesForTime(time, frameIndex1, frameIndex2);
 	
-	RecFileVectorData v1 = _frames[frameIndex1][agentIndex].dir;
-	RecFileVectorData v2 = _frames[frameIndex2][agentIndex].dir;
-	RecFileVectorData r1;
-
-	// WARNING: assuming 2-d x-z plane only right now.  eventually NEED to fix this to be generally 3D.
-	if ((v1.y != 0.0f) && (v2.y != 0.0f)) {
-		throw GenericException("currently assuming that orientation is 2D in the x-z plane - cannot interpolate if y component is non-zero.");
-	}
-
-	r1.x = -v1.z;
-	r1.y = v1.y;
-	r1.z = v1.x;
-
-	double invNorm1 = 1.0f / sqrtf(v1.x*v1.x + v1.y*v1.y + v1.z*v1.z);
-	double invNorm2 = 1.0f / sqrtf(v2.x*v2.x + v2.y*v2.y + v2.z*v2.z);
-
 	double alpha = (time-_frameTable[frameIndex1].timeStamp) / _frameTable[frameIndex1].dtToNextFrame;
-	double cosRatio = ((double)(v1.x*v2.x + v1.y*v2.y + v1.z*v2.z)) * invNorm1 * invNorm2;  // cos x = v1 dot v2 / (|v1| |v2|)
-
-	if (cosRatio > 1.0) cosRatio = 1.0;
-	if (cosRatio < -1.0) cosRatio = -1.0;
-
-	if ( (r1.x*v2.x + r1.y*v2.y + r1.z*v2.z) < 0)
-		alpha = -alpha;
-		
-
-	double angle;
-	if (cosRatio >= 1.0f)
-		angle = alpha * acos( cosRatio );
-	else
-		angle = alpha * acos( cosRatio );
-
-
-	dirx = (float)(cos(angle) * _frames[frameIndex1][agentIndex].dir.x - sin(angle) * _frames[frameIndex1][agentIndex].dir.z);
-	diry = _frames[frameIndex1][agentIndex].dir.y;
-	dirz = (float)(sin(angle) * _frames[frameIndex1][agentIndex].dir.x + cos(angle) * _frames[frameIndex1][agentIndex].dir.z);
+	_interpolateOrientation(_frames[frameIndex1][agentIndex].dir, _frames[frameIndex2][agentIndex].dir, alpha, dirx, diry, dirz);
 
 	// for debugging - return non-interpolated vectors
 	//dirx = _frames[frameIndex1][agentIndex].dir.x;
@@ -587,4 +585,52 @@ bool RecFileReader::isAgentEnabledAtTime( unsigned int agentIndex, float time )
 }
 
 
+//
+// getFrameView()
+//
+RecFileFrameView RecFileReader::getFrameView( unsigned int frameNumber )
+{
+	CHECK_MAX_INDEX(frameNumber, _header->numFrames, "frameNumber", "getFrameView()");
+
+	RecFileFrameView view;
+	view.data = _frames[frameNumber];
+	view.numAgents = _header->numAgents;
+	view.stride = sizeof(RecFileAgentInfo);
+	return view;
+}
+
+
+//
+// getAllAgentsAtTime()
+//
+void RecFileReader::getAllAgentsAtTime( float time, RecFileAgentInfo * agentInfo )
+{
+	CHECK_BOUNDS(time,_frameTable[0].timeStamp,_frameTable[_header->numFrames-1].timeStamp, "time", "getAllAgentsAtTime()");
+
+	// the frame lookup and interpolation weights are shared by all agents, so compute them only once.
+	unsigned int frameIndex1, frameIndex2;
+	_getFramesForTime(time, frameIndex1, frameIndex2);
+
+	const RecFileAgentInfo * frame1 = _frames[frameIndex1];
+	const RecFileAgentInfo * frame2 = _frames[frameIndex2];
+
+	float beta = (time-_frameTable[frameIndex1].timeStamp) / _frameTable[frameIndex1].dtToNextFrame;
+	float alpha = 1.0f - beta;
+
+	for (unsigned int i=0; i < _header->numAgents; i++) {
+		const RecFileAgentInfo & a1 = frame1[i];
+		const RecFileAgentInfo & a2 = frame2[i];
+		RecFileAgentInfo & out = agentInfo[i];
 
+		out.pos.x = alpha*a1.pos.x + beta*a2.pos.x;
+		out.pos.y = alpha*a1.pos.y + beta*a2.pos.y;
+		out.pos.z = alpha*a1.pos.z + beta*a2.pos.z;
+
+		_interpolateOrientation(a1.dir, a2.dir, beta, out.dir.x, out.dir.y, out.dir.z);
+
+		// goal and enabled do not interpolate; see getAgentGoalAtTime() and isAgentEnabledAtTime().
+		out.goal = a2.goal;
+		out.radius = alpha * a1.radius + beta * a2.radius;
+		out.enabled = (a1.enabled && a2.enabled);
+	}
+}
@@ -0,0 +1,231 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+/// @file SimulationCheckpoint.cpp
+/// @brief Implements the SteerLib::SimulationCheckpoint, SteerLib::CheckpointWriter and SteerLib::CheckpointReader classes.
+
+#include <fstream>
+#include "simulation/SimulationCheckpoint.h"
+
+using namespace std;
+using namespace SteerLib;
+using namespace Util;
+
+/// agent references to NULL are written with this index.
+#define CHECKPOINT_NULL_AGENT 0xffffffff
+
+
+void SimulationCheckpoint::writeToFile(const std::string & filename) const
+{
+	ofstream outFile;
+	outFile.open(filename.c_str(), ios::binary);
+	if (!outFile.is_open()) {
+		throw GenericException("Could not open file \"" + filename + "\" to write a simulation checkpoint.");
+	}
+	if (!_data.empty()) {
+		outFile.write(&(_data[0]), _data.size());
+	}
+	outFile.close();
+}
+
+
+void SimulationCheckpoint::readFromFile(const std::string & filename)
+{
+	ifstream inFile;
+	inFile.open(filename.c_str(), ios::binary);
+	if (!inFile.is_open()) {
+		throw GenericException("Could not open simulation checkpoint \"" + filename + "\".");
+	}
+	inFile.seekg(0, ios::end);
+	size_t numBytes = (size_t)inFile.tellg();
+	inFile.seekg(0, ios::beg);
+
+	_data.resize(numBytes);
+	if (numBytes > 0) {
+		inFile.read(&(_data[0]), numBytes);
+	}
+	inFile.close();
+}
+
+
+//========================================
+
+CheckpointWriter::CheckpointWriter(SimulationCheckpoint & checkpoint, const std::vector<SteerLib::AgentInterface*> & agents) : _data(checkpoint._data)
+{
+	for (unsigned int i = 0; i < agents.size(); i++) {
+		_agentIndices[agents[i]] = i;
+	}
+}
+
+
+void CheckpointWriter::writeString(const std::string & value)
+{
+	write<unsigned int>((unsigned int)value.size());
+	_data.insert(_data.end(), value.begin(), value.end());
+}
+
+
+void CheckpointWriter::writeGoal(const SteerLib::AgentGoalInfo & goal)
+{
+	write(goal.goalType);
+	write(goal.targetIsRandom);
+	write(goal.timeDuration);
+	write(goal.desiredSpeed);
+	write(goal.targetLocation);
+	writeString(goal.targetName);
+	write(goal.targetDirection);
+	writeString(goal.flowType);
+	write(goal.targetRegion);
+
+	writeString(goal.targetBehaviour.getSteeringAlg());
+	std::vector<BehaviourParameter> parameters = goal.targetBehaviour.getParameters();
+	write<unsigned int>((unsigned int)parameters.size());
+	for (unsigned int i = 0; i < parameters.size(); i++) {
+		writeString(parameters[i].key);
+		writeString(parameters[i].value);
+	}
+}
+
+
+void CheckpointWriter::writeInitialConditions(const SteerLib::AgentInitialConditions & initialConditions)
+{
+	writeString(initialConditions.name);
+	write(initialConditions.position);
+	write(initialConditions.direction);
+	write(initialConditions.radius);
+	write(initialConditions.speed);
+	write<unsigned int>((unsigned int)initialConditions.goals.size());
+	for (unsigned int i = 0; i < initialConditions.goals.size(); i++) {
+		writeGoal(initialConditions.goals[i]);
+	}
+	write(initialConditions.color);
+	write(initialConditions.colorSet);
+	write(initialConditions.fromRandom);
+	write(initialConditions.randBox);
+	write(initialConditions.startTime);
+}
+
+
+void CheckpointWriter::writeAgentReference(const SteerLib::AgentInterface * agent)
+{
+	if (agent == NULL) {
+		write<unsigned int>(CHECKPOINT_NULL_AGENT);
+		return;
+	}
+
+	std::map<const SteerLib::AgentInterface*, unsigned int>::iterator iter = _agentIndices.find(agent);
+	if (iter == _agentIndices.end()) {
+		throw GenericException("Cannot write a reference to an agent that is not known to the engine into a simulation checkpoint.");
+	}
+	write<unsigned int>(iter->second);
+}
+
+
+size_t CheckpointWriter::beginSection()
+{
+	size_t section = _data.size();
+	write<unsigned int>(0);  // the size of the section is filled in by endSection().
+	return section;
+}
+
+
+void CheckpointWriter::endSection(size_t section)
+{
+	unsigned int sectionSize = (unsigned int)(_data.size() - section - sizeof(unsigned int));
+	memcpy(&(_data[section]), &sectionSize, sizeof(unsigned int));
+}
+
+
+//========================================
+
+CheckpointReader::CheckpointReader(const SimulationCheckpoint & checkpoint, const std::vector<SteerLib::AgentInterface*> & agents) : _agents(agents)
+{
+	_data = checkpoint.data();
+	_size = checkpoint.size();
+	_position = 0;
+}
+
+
+std::string CheckpointReader::readString()
+{
+	unsigned int length = read<unsigned int>();
+	_require(length);
+	std::string value(_data + _position, length);
+	_position += length;
+	return value;
+}
+
+
+void CheckpointReader::readGoal(SteerLib::AgentGoalInfo & goal)
+{
+	read(goal.goalType);
+	read(goal.targetIsRandom);
+	read(goal.timeDuration);
+	read(goal.desiredSpeed);
+	read(goal.targetLocation);
+	goal.targetName = readString();
+	read(goal.targetDirection);
+	goal.flowType = readString();
+	read(goal.targetRegion);
+
+	goal.targetBehaviour = Behaviour();
+	goal.targetBehaviour.setSteeringAlg(readString());
+	unsigned int numParameters = read<unsigned int>();
+	for (unsigned int i = 0; i < numParameters; i++) {
+		std::string key = readString();
+		std::string value = readString();
+		goal.targetBehaviour.addParameter(BehaviourParameter(key, value));
+	}
+}
+
+
+void CheckpointReader::readInitialConditions(SteerLib::AgentInitialConditions & initialConditions)
+{
+	initialConditions.name = readString();
+	read(initialConditions.position);
+	read(initialConditions.direction);
+	read(initialConditions.radius);
+	read(initialConditions.speed);
+	unsigned int numGoals = read<unsigned int>();
+	initialConditions.goals.resize(numGoals);
+	for (unsigned int i = 0; i < numGoals; i++) {
+		readGoal(initialConditions.goals[i]);
+	}
+	read(initialConditions.color);
+	read(initialConditions.colorSet);
+	read(initialConditions.fromRandom);
+	read(initialConditions.randBox);
+	read(initialConditions.startTime);
+}
+
+
+SteerLib::AgentInterface * CheckpointReader::readAgentReference()
+{
+	unsigned int index = read<unsigned int>();
+	if (index == CHECKPOINT_NULL_AGENT) {
+		return NULL;
+	}
+	if (index >= _agents.size()) {
+		throw GenericException("Simulation checkpoint refers to an agent that does not exist.");
+	}
+	return _agents[index];
+}
+
+
+size_t CheckpointReader::beginSection()
+{
+	unsigned int sectionSize = read<unsigned int>();
+	_require(sectionSize);
+	return _position + sectionSize;
+}
+
+
+void CheckpointReader::endSection(size_t section)
+{
+	if (_position != section) {
+		throw GenericException("Simulation checkpoint does not match the agents or modules it is restored into.");
+	}
+}
@@ -27,6 +27,7 @@
 // #include "modules/SpatialDatabaseModule.h"
 #include "griddatabase/GridDatabase2D.h"
 #include "griddatabase/GridDatabasePlanningDomain.h"
+#include "util/TraceProfiler.h"
 // #include "kdtree/KdTreeDataBase.h"
 #include "interfaces/SpatialDataBaseModuleInterface.h"
 #include "interfaces/PlanningDomainModuleInterface.h"
@@ -53,6 +54,7 @@ void SimulationEngine::_reset()
 	_moduleMetaInfoByName.clear();
 	_moduleMetaInfoByReference.clear();
 	_modulesInExecutionOrder.clear();
+	_moduleTraceNamesInExecutionOrder.clear();
 	_moduleConflicts.clear();
 	_agents.clear();
 	_selectedAgents.clear();
@@ -73,6 +75,9 @@ void SimulationEngine::_reset()
 	_init_agents.clear();
 	_agents_ai.clear();
 	_spawned_agent_emitter_num.clear();
+	_numPreprocessedAgents = 0;
+	_numPreprocessedAgentInitialConditions = 0;
+	_spawnedAgentConditions.clear();
 }
 
 void SimulationEngine::stop()
@@ -107,6 +112,10 @@ void SimulationEngine::init(SimulationOptions * options, SteerLib::EngineControl
 	}
 	_clock.setClockMode(clockMode, _options->engineOptions.fixedFPS, _options->engineOptions.minVariableDt, _options->engineOptions.maxVariableDt);
 
+	if (_options->engineOptions.traceFilename != "") {
+		Util::TraceProfiler::getInstance()->beginRecording();
+	}
+
 	if(!_testcaseCameraView)
 	{
 		_camera.reset();
@@ -127,7 +136,7 @@ void SimulationEngine::init(SimulationOptions * options, SteerLib::EngineControl
 	if ( _options->spatialDatabaseOptions.name == "gridDatabase")
 	{// Grid planner only works with grid database
 		std::cout << "Creating spatialdatabase: " << _options->spatialDatabaseOptions.name << std::endl;
-		GridDatabase2D * grid = new GridDatabase2D(xmin, xmax, zmin, zmax, _options->gridDatabaseOptions.numGridCellsX, _options->gridDatabaseOptions.numGridCellsZ, _options->gridDatabaseOptions.maxItemsPerGridCell, _options->gridDatabaseOptions.drawGrid);
+		GridDatabase2D * grid = new GridDatabase2D(xmin, xmax, zmin, zmax, _options->gridDatabaseOptions.numGridCellsX, _options->gridDatabaseOptions.numGridCellsZ, _options->gridDatabaseOptions.maxItemsPerGridCell, _options->gridDatabaseOptions.drawGrid, _options->gridDatabaseOptions.numObstacleCellsX, _options->gridDatabaseOptions.numObstacleCellsZ);
 		_spatialDatabase = grid;
 		// _pathPlanner = new GridDatabasePlanningDomain(grid);
 
@@ -191,15 +200,19 @@ void SimulationEngine::init(SimulationOptions * options, SteerLib::EngineControl
 		throw Util::GenericException("Spatial Database " + _options->spatialDatabaseOptions.name + " is not a valid spatial database module");
 	}
 
+	_neighborLists.init(_spatialDatabase, _options->engineOptions.neighborListSkin);
+	_distanceField.init(_options->engineOptions.distanceFieldCellSize);
+	_visibilityCache.init(_spatialDatabase, &_obstacles);
+
 	int planningDomainIndex = -1;
 	if ( _options->planningDomainOptions.name == "gridDomain")
 	{
 		std::cout << "Creating planning domain: " << _options->planningDomainOptions.name << std::endl;
 		// GridDatabase2D* grid = dynamic_cast<GridDatabase2D *>(_spatialDatabase);
-		GridDatabase2D* grid = new GridDatabase2D(xmin, xmax, zmin, zmax, _options->gridDatabaseOptions.numGridCellsX, _options->gridDatabaseOptions.numGridCellsZ, _options->gridDatabaseOptions.maxItemsPerGridCell, _options->gridDatabaseOptions.drawGrid);
+		GridDatabase2D* grid = new GridDatabase2D(xmin, xmax, zmin, zmax, _options->gridDatabaseOptions.numGridCellsX, _options->gridDatabaseOptions.numGridCellsZ, _options->gridDatabaseOptions.maxItemsPerGridCell, _options->gridDatabaseOptions.drawGrid, _options->gridDatabaseOptions.numObstacleCellsX, _options->gridDatabaseOptions.numObstacleCellsZ);
 		/*if ( grid == NULL )
 		{
-			grid = new GridDatabase2D(xmin, xmax, zmin, zmax, _options->gridDatabaseOptions.numGridCellsX, _options->gridDatabaseOptions.numGridCellsZ, _options->gridDatabaseOptions.maxItemsPerGridCell, _options->gridDatabaseOptions.drawGrid);
+			grid = new GridDatabase2D(xmin, xmax, zmin, zmax, _options->gridDatabaseOptions.numGridCellsX, _options->gridDatabaseOptions.numGridCellsZ, _options->gridDatabaseOptions.maxItemsPerGridCell, _options->gridDatabaseOptions.drawGrid, _options->gridDatabaseOptions.numObstacleCellsX, _options->gridDatabaseOptions.numObstacleCellsZ);
 		}*/
 		_pathPlanner = new GridDatabasePlanningDomain(grid, this);
 		/*else
@@ -323,6 +336,10 @@ void SimulationEngine::finish()
 		_modulesInExecutionOrder[i]->finish();
 	}
 
+	if (_options->engineOptions.traceFilename != "") {
+		Util::TraceProfiler::getInstance()->endRecording(_options->engineOptions.traceFilename);
+	}
+
 	// if modules did not clean up agents (they should), we can compensate user-friendly here.
 	if (_agents.size() != 0) {
 		std::vector<SteerLib::AgentInterface*>::iterator agentIterator;
@@ -377,6 +394,11 @@ void SimulationEngine::initializeSimulation()
 
 	_clock.reset();
 
+	// agents may record their first position when they are reset, so the trajectory file must be ready before any are created.
+	if (_options->engineOptions.trajectoryFilename != "") {
+		_trajectorySink.open(_options->engineOptions.trajectoryFilename);
+	}
+
 	// iterate over all modules asking them to initialize.
 	std::vector<SteerLib::ModuleInterface*>::iterator iter;
 	for ( iter = _modulesInExecutionOrder.begin(); iter != _modulesInExecutionOrder.end();  ++iter ) {
@@ -399,6 +421,21 @@ void SimulationEngine::cleanupSimulation()
 
 	_clock.reset();
 
+	// forget the per-simulation state so that the engine can load another simulation.
+	_agentInitialConditions.clear();
+	_waitList.clear();
+	_init_agents.clear();
+	_agents_ai.clear();
+	_spawned_agent_emitter_num.clear();
+	_numPreprocessedAgents = 0;
+	_numPreprocessedAgentInitialConditions = 0;
+	_spawnedAgentConditions.clear();
+	_numFramesSimulated = 0;
+	_neighborLists.clear();
+	_distanceField.clear();
+	_visibilityCache.clear();
+	_trajectorySink.close();
+
 	_engineState.transitionToState(ENGINE_STATE_READY);
 }
 
@@ -414,6 +451,8 @@ void SimulationEngine::preprocessSimulation()
 		(*iter)->preprocessSimulation();
 	}
 
+	// the modules have added all obstacles of the test case by now, so the database can pack them before the first query.
+	_spatialDatabase->refreshDataBase();
 	this->_pathPlanner->refresh();
 	// reset the agents
 	for (size_t a=0; a < _agentInitialConditions.size(); a++)
@@ -425,6 +464,14 @@ void SimulationEngine::preprocessSimulation()
 	}
 	// _agentInitialConditions.clear();
 
+	// everything created from here on is spawned while the simulation runs, and must be recorded by checkpoints.
+	_numPreprocessedAgents = _agents.size();
+	_numPreprocessedAgentInitialConditions = _agentInitialConditions.size();
+	_spawnedAgentConditions.clear();
+
+	// the agents have requested what they need by now, so the distance field can be built before the first frame.
+	_distanceField.update(_obstacles);
+
 	_engineState.transitionToState(ENGINE_STATE_SIMULATION_READY_FOR_UPDATE);
 }
 
@@ -490,37 +537,51 @@ bool SimulationEngine::_simulateOneStep()
 	float simulatonDt = _clock.getSimulationDt();
 	unsigned int currentFrameNumber = _clock.getCurrentFrameNumber();
 
+	Util::TraceProfiler * traceProfiler = Util::TraceProfiler::getInstance();
+	traceProfiler->setFrameNumber(currentFrameNumber);
+	Util::TraceScope traceFrame("frame");
 
 	// call preprocess for all modules
-	std::vector<SteerLib::ModuleInterface*>::iterator moduleIterator;
-	for ( moduleIterator = _modulesInExecutionOrder.begin(); moduleIterator != _modulesInExecutionOrder.end();  ++moduleIterator ) {
-		(*moduleIterator)->preprocessFrame(currentSimulationTime, simulatonDt, currentFrameNumber);
+	{
+		Util::TraceScope tracePreprocess("preprocessFrame");
+		for (unsigned int i = 0; i < _modulesInExecutionOrder.size(); i++) {
+			Util::TraceScope traceModule(_moduleTraceNamesInExecutionOrder[i].preprocessFrame);
+			_modulesInExecutionOrder[i]->preprocessFrame(currentSimulationTime, simulatonDt, currentFrameNumber);
+		}
 	}
 
+	// rebuild the neighbor lists, if some module uses them and agents moved far enough since the last rebuild.
+	_neighborLists.update(_agents, simulatonDt);
+	// patch the distance field where obstacles were added or removed.
+	_distanceField.update(_obstacles);
+
 	int iter = 0;
 	short count = 0;
 	std::vector<int> agentsEmit;
 	// call updateAI for all agents
 	std::vector<SteerLib::AgentInterface*>::iterator agentIterator;
-	for ( agentIterator = _agents.begin(); agentIterator != _agents.end(); ++agentIterator )
 	{
-		if ((*agentIterator)->enabled()){
-			(*agentIterator)->updateAI(currentSimulationTime, simulatonDt, currentFrameNumber);
-			// Output agent position at each frame
-			//std::cout << "Agent " << count << " Position: " << (*agentIterator)->position() << std::endl;
-		}
-		else {
-			if((*agentIterator)->finished()) {	//for most AIs, this will in turn call enabled() and duplicate original behavior; ShadowAI overrides this behavior
-				numDisabledAgents++;
+		Util::TraceScope traceUpdateAI("updateAI");
+		for ( agentIterator = _agents.begin(); agentIterator != _agents.end(); ++agentIterator )
+		{
+			if ((*agentIterator)->enabled()){
+				(*agentIterator)->updateAI(currentSimulationTime, simulatonDt, currentFrameNumber);
+				// Output agent position at each frame
+				//std::cout << "Agent " << count << " Position: " << (*agentIterator)->position() << std::endl;
 			}
-			if(iter <= _spawned_agent_emitter_num.size()-1) {//make sure agent is within bounds
-				if(_spawned_agent_emitter_num[iter] >= 0) {//only agents emitted call another emit
-					agentsEmit.push_back(iter);
+			else {
+				if((*agentIterator)->finished()) {	//for most AIs, this will in turn call enabled() and duplicate original behavior; ShadowAI overrides this behavior
+					numDisabledAgents++;
+				}
+				if(iter <= _spawned_agent_emitter_num.size()-1) {//make sure agent is within bounds
+					if(_spawned_agent_emitter_num[iter] >= 0) {//only agents emitted call another emit
+						agentsEmit.push_back(iter);
+					}
 				}
 			}
+			iter++;
+			count++;
 		}
-		iter++;
-		count++;
 	}
 
 	// emit agents and turn off disabled agent from emitting more agents
@@ -533,10 +594,15 @@ bool SimulationEngine::_simulateOneStep()
 	}
 
 	// call postprocess for all modules
-	for ( moduleIterator = _modulesInExecutionOrder.begin(); moduleIterator != _modulesInExecutionOrder.end();  ++moduleIterator ) {
-		(*moduleIterator)->postprocessFrame(currentSimulationTime, simulatonDt, currentFrameNumber);
+	{
+		Util::TraceScope tracePostprocess("postprocessFrame");
+		for (unsigned int i = 0; i < _modulesInExecutionOrder.size(); i++) {
+			Util::TraceScope traceModule(_moduleTraceNamesInExecutionOrder[i].postprocessFrame);
+			_modulesInExecutionOrder[i]->postprocessFrame(currentSimulationTime, simulatonDt, currentFrameNumber);
+		}
 	}
 
+	_trajectorySink.endFrame();
 	_numFramesSimulated++;
 
 
@@ -556,6 +622,200 @@ bool SimulationEngine::_simulateOneStep()
 	return true;
 }
 
+//========================================
+
+const char * SimulationEngine::_getModuleTraceName(const std::string & moduleName, const char * phase)
+{
+	return Util::TraceProfiler::getInstance()->internName(moduleName + "::" + phase);
+}
+
+//========================================
+
+void SimulationEngine::saveCheckpoint(SteerLib::SimulationCheckpoint & checkpoint)
+{
+	if ((_engineState.getCurrentState() != SimulationEngine::ENGINE_STATE_SIMULATION_READY_FOR_UPDATE) &&
+		(_engineState.getCurrentState() != SimulationEngine::ENGINE_STATE_SIMULATION_NO_MORE_UPDATES_ALLOWED)) {
+		throw GenericException("Cannot save a checkpoint, the simulation is not running.");
+	}
+	if (_agents.size() != _numPreprocessedAgents + _spawnedAgentConditions.size()) {
+		throw GenericException("Cannot save a checkpoint, agents were added to or removed from the engine without createAgent() while the simulation was running.");
+	}
+
+	checkpoint.clear();
+	CheckpointWriter out(checkpoint, _agents);
+
+	out.write(CHECKPOINT_MAGIC_NUMBER);
+	out.write(CHECKPOINT_VERSION);
+
+	// data that does not change during the simulation is not copied, only enough to verify that a checkpoint is restored into the same kind of simulation.
+	out.write<unsigned int>((unsigned int)_modulesInExecutionOrder.size());
+	std::vector<SteerLib::ModuleInterface*>::iterator moduleIter;
+	for (moduleIter = _modulesInExecutionOrder.begin(); moduleIter != _modulesInExecutionOrder.end(); ++moduleIter) {
+		out.writeString(_moduleMetaInfoByReference[(*moduleIter)]->moduleName);
+	}
+	out.write<unsigned int>((unsigned int)_obstacles.size());
+	out.write<unsigned int>((unsigned int)_init_agents.size());
+	out.write<unsigned int>((unsigned int)_numPreprocessedAgents);
+	out.write<unsigned int>((unsigned int)_numPreprocessedAgentInitialConditions);
+
+	_clock.saveState(out);
+	out.write(_numFramesSimulated);
+
+	// agents that were spawned or are still waiting to be spawned
+	out.write<unsigned int>((unsigned int)(_agentInitialConditions.size() - _numPreprocessedAgentInitialConditions));
+	for (size_t i = _numPreprocessedAgentInitialConditions; i < _agentInitialConditions.size(); i++) {
+		out.writeInitialConditions(_agentInitialConditions[i]);
+	}
+	out.write<unsigned int>((unsigned int)_spawnedAgentConditions.size());
+	for (size_t i = 0; i < _spawnedAgentConditions.size(); i++) {
+		out.writeString(_moduleMetaInfoByReference[_agentOwners[_agents[_numPreprocessedAgents + i]]]->moduleName);
+		out.writeInitialConditions(_spawnedAgentConditions[i]);
+	}
+	out.write<unsigned int>((unsigned int)_waitList.size());
+	for (size_t i = 0; i < _waitList.size(); i++) {
+		out.writeString(_moduleMetaInfoByReference[_waitList[i].second]->moduleName);
+		out.writeInitialConditions(_waitList[i].first);
+	}
+	out.writeSequence(_spawned_agent_emitter_num);
+
+	// the state of all agents, then all modules
+	for (size_t i = 0; i < _agents.size(); i++) {
+		size_t section = out.beginSection();
+		_agents[i]->saveState(out);
+		out.endSection(section);
+	}
+	for (moduleIter = _modulesInExecutionOrder.begin(); moduleIter != _modulesInExecutionOrder.end(); ++moduleIter) {
+		size_t section = out.beginSection();
+		(*moduleIter)->saveState(out);
+		out.endSection(section);
+	}
+
+	// how far the trajectory file got, so that restoring cuts off what this engine records after the checkpoint.
+	size_t trajectorySection = out.beginSection();
+	_trajectorySink.saveState(out);
+	out.endSection(trajectorySection);
+}
+
+//========================================
+
+void SimulationEngine::restoreCheckpoint(const SteerLib::SimulationCheckpoint & checkpoint)
+{
+	if ((_engineState.getCurrentState() != SimulationEngine::ENGINE_STATE_SIMULATION_READY_FOR_UPDATE) &&
+		(_engineState.getCurrentState() != SimulationEngine::ENGINE_STATE_SIMULATION_NO_MORE_UPDATES_ALLOWED)) {
+		throw GenericException("Cannot restore a checkpoint, the simulation is not running.");
+	}
+
+	CheckpointReader in(checkpoint, _agents);
+
+	if (in.read<unsigned int>() != CHECKPOINT_MAGIC_NUMBER) {
+		throw GenericException("Cannot restore a checkpoint, the data is not a simulation checkpoint.");
+	}
+	if (in.read<unsigned int>() != CHECKPOINT_VERSION) {
+		throw GenericException("Cannot restore a checkpoint, it was written by a different version of SteerLib.");
+	}
+
+	// verify that the shared data matches before anything is modified.
+	bool sameSimulation = (in.read<unsigned int>() == _modulesInExecutionOrder.size());
+	for (size_t i = 0; sameSimulation && (i < _modulesInExecutionOrder.size()); i++) {
+		sameSimulation = (in.readString() == _moduleMetaInfoByReference[_modulesInExecutionOrder[i]]->moduleName);
+	}
+	sameSimulation = sameSimulation && (in.read<unsigned int>() == _obstacles.size());
+	sameSimulation = sameSimulation && (in.read<unsigned int>() == _init_agents.size());
+	sameSimulation = sameSimulation && (in.read<unsigned int>() == _numPreprocessedAgents);
+	sameSimulation = sameSimulation && (in.read<unsigned int>() == _numPreprocessedAgentInitialConditions);
+	if (!sameSimulation) {
+		throw GenericException("Cannot restore a checkpoint, it was written by a simulation with different modules, obstacles, or agents.");
+	}
+
+	_clock.restoreState(in);
+	in.read(_numFramesSimulated);
+
+	_agentInitialConditions.resize(_numPreprocessedAgentInitialConditions);
+	unsigned int numAddedInitialConditions = in.read<unsigned int>();
+	for (unsigned int i = 0; i < numAddedInitialConditions; i++) {
+		SteerLib::AgentInitialConditions initialConditions;
+		in.readInitialConditions(initialConditions);
+		_agentInitialConditions.push_back(initialConditions);
+	}
+
+	unsigned int numSpawnedAgents = in.read<unsigned int>();
+	std::vector<SteerLib::ModuleInterface*> spawnedAgentOwners(numSpawnedAgents);
+	_spawnedAgentConditions.resize(numSpawnedAgents);
+	for (unsigned int i = 0; i < numSpawnedAgents; i++) {
+		std::string moduleName = in.readString();
+		spawnedAgentOwners[i] = getModule(moduleName);
+		if (spawnedAgentOwners[i] == NULL) {
+			throw GenericException("Cannot restore a checkpoint, module \"" + moduleName + "\" is not loaded.");
+		}
+		in.readInitialConditions(_spawnedAgentConditions[i]);
+	}
+
+	// agents this engine already spawned are kept as long as they belong to the same modules; the others are destroyed,
+	// and agents that this engine did not spawn (yet) are created.  Their state is restored below.
+	size_t numKeptAgents = 0;
+	while ((numKeptAgents < numSpawnedAgents) && (_numPreprocessedAgents + numKeptAgents < _agents.size()) &&
+		(_agentOwners[_agents[_numPreprocessedAgents + numKeptAgents]] == spawnedAgentOwners[numKeptAgents])) {
+		numKeptAgents++;
+	}
+	while (_agents.size() > _numPreprocessedAgents + numKeptAgents) {
+		SteerLib::AgentInterface * agent = _agents.back();
+		if (agent->enabled()) {
+			agent->disable();
+		}
+		_selectedAgents.erase(agent);
+		destroyAgent(agent);
+	}
+	for (size_t i = numKeptAgents; i < numSpawnedAgents; i++) {
+		SteerLib::AgentInterface * newAgent = spawnedAgentOwners[i]->createAgent();
+		if (newAgent == NULL) {
+			throw GenericException("Cannot restore a checkpoint, a module did not create an agent.");
+		}
+		_agents.push_back(newAgent);
+		_agentOwners[newAgent] = spawnedAgentOwners[i];
+		newAgent->reset(_spawnedAgentConditions[i], this);
+		// all these agents start at their emitter; take them out of the spatial database until their state is restored,
+		// otherwise they pile up in the same grid cell.
+		if (newAgent->enabled()) {
+			newAgent->disable();
+		}
+	}
+
+	_waitList.clear();
+	unsigned int numWaitingAgents = in.read<unsigned int>();
+	for (unsigned int i = 0; i < numWaitingAgents; i++) {
+		std::string moduleName = in.readString();
+		SteerLib::ModuleInterface * owner = getModule(moduleName);
+		if (owner == NULL) {
+			throw GenericException("Cannot restore a checkpoint, module \"" + moduleName + "\" is not loaded.");
+		}
+		SteerLib::AgentInitialConditions initialConditions;
+		in.readInitialConditions(initialConditions);
+		_waitList.push_back(std::make_pair(initialConditions, owner));
+	}
+	in.readSequence(_spawned_agent_emitter_num);
+
+	for (size_t i = 0; i < _agents.size(); i++) {
+		size_t section = in.beginSection();
+		_agents[i]->restoreState(in);
+		in.endSection(section);
+	}
+	std::vector<SteerLib::ModuleInterface*>::iterator moduleIter;
+	for (moduleIter = _modulesInExecutionOrder.begin(); moduleIter != _modulesInExecutionOrder.end(); ++moduleIter) {
+		size_t section = in.beginSection();
+		(*moduleIter)->restoreState(in);
+		in.endSection(section);
+	}
+
+	// last, so that it also cuts off the positions recorded by agents that were re-created above.
+	size_t trajectorySection = in.beginSection();
+	_trajectorySink.restoreState(in);
+	in.endSection(trajectorySection);
+
+	_stop = false;
+	if (_engineState.getCurrentState() == SimulationEngine::ENGINE_STATE_SIMULATION_NO_MORE_UPDATES_ALLOWED) {
+		_engineState.transitionToState(ENGINE_STATE_SIMULATION_READY_FOR_UPDATE);
+	}
+}
 
 //========================================
 
@@ -1033,12 +1293,38 @@ SteerLib::ModuleMetaInformation * SimulationEngine::_loadModule(const std::strin
 	// if all went well up to this point, the module and its dependencies is loaded, so add it to the end of the list of modules
 	// (i.e. it executes after all its dependencies) and return!
 	_modulesInExecutionOrder.push_back(newModule);
+	ModuleTraceNames traceNames;
+	traceNames.preprocessFrame = _getModuleTraceName(newMetaInfo->moduleName, "preprocessFrame");
+	traceNames.postprocessFrame = _getModuleTraceName(newMetaInfo->moduleName, "postprocessFrame");
+	_moduleTraceNamesInExecutionOrder.push_back(traceNames);
 	std::cout << "loaded module " << newMetaInfo->moduleName << "\n";
 
 	return newMetaInfo;
 }
 
 
+void SimulationEngine::reinitializeModule(const std::string & moduleName, const std::string & options)
+{
+	SteerLib::ModuleMetaInformation * moduleMetaInfo = getModuleMetaInfo(moduleName);
+	if (moduleMetaInfo == NULL) {
+		throw GenericException("Cannot re-initialize module \"" + moduleName + "\", it is not loaded.");
+	}
+
+	_engineState.transitionToState(ENGINE_STATE_LOADING_MODULE);
+
+	// modify the list of options (overrides command line)
+	_options->mergeModuleOptions(moduleName, options);
+
+	// the dynamic library, and any modules that depend on this one, stay loaded.
+	if (moduleMetaInfo->isInitialized) {
+		moduleMetaInfo->module->finish();
+	}
+	moduleMetaInfo->isInitialized = true; // set this BEFORE calling init.
+	moduleMetaInfo->module->init(_options->getModuleOptions(moduleName), this);
+
+	_engineState.transitionToState(ENGINE_STATE_READY);
+}
+
 void SimulationEngine::unloadModule( SteerLib::ModuleInterface * moduleToDestroy, bool recursivelyUnloadDependencies )
 {
 	_engineState.transitionToState(ENGINE_STATE_UNLOADING_MODULE);
@@ -1086,6 +1372,7 @@ bool SimulationEngine::_unloadModule( SteerLib::ModuleInterface * moduleToDestro
 	_moduleMetaInfoByReference.erase(moduleToDestroy);
 	std::vector<SteerLib::ModuleInterface*>::iterator moduleExecIter = _modulesInExecutionOrder.begin();
 	while ((*moduleExecIter) != moduleToDestroy) { ++moduleExecIter; }
+	_moduleTraceNamesInExecutionOrder.erase(_moduleTraceNamesInExecutionOrder.begin() + (moduleExecIter - _modulesInExecutionOrder.begin()));
 	_modulesInExecutionOrder.erase(moduleExecIter);
 	std::set<std::string>::iterator conflictsIter;
 	for (conflictsIter = moduleMetaInfoToDestroy->conflicts.begin(); conflictsIter != moduleMetaInfoToDestroy->conflicts.end(); ++conflictsIter) {
@@ -1224,6 +1511,7 @@ SteerLib::AgentInterface * SimulationEngine::createAgent(const SteerLib::AgentIn
 		_agents.push_back(newAgent);
 		_agentOwners[newAgent] = owner;
 		_spawned_agent_emitter_num.push_back(-1);// default = no emitter
+		_spawnedAgentConditions.push_back(initialConditions);
 	}
 
 	return newAgent;
@@ -1249,6 +1537,7 @@ void SimulationEngine::checkWaitingAgents() {
 					_agents.push_back(newAgent);
 					_agentOwners[newAgent] = (*waitListIterator).second;
 					_spawned_agent_emitter_num.push_back(-1);
+					_spawnedAgentConditions.push_back((*waitListIterator).first);
 
 					// Reset the agent (adds to the simulation, usually done in the preprocessSimulation step)
 					_agents.back()->reset(_agentInitialConditions.back(), this);
@@ -1272,6 +1561,7 @@ SteerLib::AgentInterface * SimulationEngine::createEmittedAgent(const SteerLib::
 		_agents.push_back(newAgent);
 		_agentOwners[newAgent] = owner;
 		_spawned_agent_emitter_num.push_back(emitterNum);// default = no emitter
+		_spawnedAgentConditions.push_back(initialConditions);
 	}
 
 	return newAgent;
@@ -1344,6 +1634,7 @@ void SimulationEngine::destroyAgent(SteerLib::AgentInterface * agentToDestroy)
 
 		// remove the agent from the list of owners
 		_agentOwners.erase(agentToDestroy);
+		_neighborLists.invalidate();
 
 		// destroy the agent
 		module->destroyAgent(agentToDestroy);
@@ -1367,6 +1658,11 @@ void SimulationEngine::destroyAllAgentsFromModule(SteerLib::ModuleInterface * ow
 #ifdef _DEBUG
 	std::cout << "Destroying agent\n";
 #endif
+			// not all agents remove themselves from the spatial database when deleted; an agent left
+			// there would be a dangling pointer once the engine loads the next simulation.
+			if (_agents[i]->enabled()) {
+				_agents[i]->disable();
+			}
 			destroyAgent(_agents[i]);
 		}
 	}
@@ -1383,6 +1679,7 @@ void SimulationEngine::addAgent(SteerLib::AgentInterface * newAgent, SteerLib::M
 
 	_agents.push_back(newAgent);
 	_agentOwners[newAgent] = owner;
+	_neighborLists.invalidate();
 }
 
 //========================================
@@ -1402,6 +1699,7 @@ void SimulationEngine::removeAgent(SteerLib::AgentInterface * agentToRemove)
 
 	// remove the agent from the list of owners
 	_agentOwners.erase(agentToRemove);
+	_neighborLists.invalidate();
 }
 
 /*
@@ -1432,6 +1730,9 @@ void SimulationEngine::destroyAllObstaclesFromModule(SteerLib::ModuleInterface *
 void SimulationEngine::addObstacle(SteerLib::ObstacleInterface * newObstacle)
 {
 	_obstacles.insert(newObstacle);
+	_neighborLists.invalidate();
+	_distanceField.obstacleAdded(newObstacle);
+	_visibilityCache.obstacleAdded(newObstacle);
 }
 
 
@@ -1440,6 +1741,9 @@ void SimulationEngine::addObstacle(SteerLib::ObstacleInterface * newObstacle)
 void SimulationEngine::removeObstacle(SteerLib::ObstacleInterface * obstacleToRemove)
 {
 	_obstacles.erase(obstacleToRemove);
+	_neighborLists.invalidate();
+	_distanceField.obstacleRemoved(obstacleToRemove);
+	_visibilityCache.obstacleRemoved(obstacleToRemove);
 }
 
 /**
@@ -1448,6 +1752,9 @@ void SimulationEngine::removeObstacle(SteerLib::ObstacleInterface * obstacleToRe
 void SimulationEngine::removeAllObstacles()
 {
 	_obstacles.clear();
+	_neighborLists.invalidate();
+	_distanceField.invalidate();
+	_visibilityCache.invalidate();
 }
 
 
@@ -1539,6 +1846,8 @@ void SimulationEngine::_setupStateMachine()
 	_engineState.addTransition( SimulationEngine::ENGINE_STATE_UPDATING_SIMULATION, SimulationEngine::ENGINE_STATE_SIMULATION_READY_FOR_UPDATE );
 	_engineState.addTransition( SimulationEngine::ENGINE_STATE_UPDATING_SIMULATION, SimulationEngine::ENGINE_STATE_SIMULATION_NO_MORE_UPDATES_ALLOWED );
 	_engineState.addTransition( SimulationEngine::ENGINE_STATE_SIMULATION_NO_MORE_UPDATES_ALLOWED, SimulationEngine::ENGINE_STATE_POSTPROCESSING_SIMULATION );
+	// restoring a checkpoint allows more updates again.
+	_engineState.addTransition( SimulationEngine::ENGINE_STATE_SIMULATION_NO_MORE_UPDATES_ALLOWED, SimulationEngine::ENGINE_STATE_SIMULATION_READY_FOR_UPDATE );
 
 	// After the user initiates a postprocess, the simulation becomes finished, and then the user
 	// must unload the simulation, after which the engine is ready to load another simulation or to finish.
@@ -8,14 +8,21 @@
 /// @brief implements the SteerLib::SimulationMetricsCollector class
 
 #include "benchmarking/SimulationMetricsCollector.h"
+#include "util/TaskScheduler.h"
+#include "util/TraceProfiler.h"
+#include "util/GenericException.h"
 
 using namespace std;
 using namespace SteerLib;
 using namespace Util;
 
 
-SimulationMetricsCollector::SimulationMetricsCollector( const std::vector<SteerLib::AgentInterface*> & agents )
+SimulationMetricsCollector::SimulationMetricsCollector( const std::vector<SteerLib::AgentInterface*> & agents, unsigned int numThreads )
 {
+	if (numThreads == 0) {
+		throw GenericException("SimulationMetricsCollector requires at least one thread.");
+	}
+
 	// allocate and organize the agent metrics collectors
 	_agentCollectors.clear();
 	for (unsigned int i=0; i<agents.size(); i++) {
@@ -24,12 +31,25 @@ SimulationMetricsCollector::SimulationMetricsCollector( const std::vector<SteerL
 	}
 	
 	_resetEnvironmentMetrics();
+
+	// never use more threads than there are agents.
+	_numThreads = numThreads;
+	if (_numThreads > _agentCollectors.size()) {
+		_numThreads = (_agentCollectors.size() > 0) ? (unsigned int)_agentCollectors.size() : 1;
+	}
+
+	_taskScheduler = NULL;
+	if (_numThreads > 1) {
+		_taskScheduler = new Util::TaskScheduler(_numThreads);
+	}
 }
 
 
 
 SimulationMetricsCollector::~SimulationMetricsCollector()
 {
+	delete _taskScheduler;
+
 	// std::cout << "The simulation metrics are being updated" << std::endl;
 	for (unsigned int i=0; i<_agentCollectors.size(); i++) {
 		if (_agentCollectors[i] != NULL) delete _agentCollectors[i];
@@ -56,7 +76,22 @@ void SimulationMetricsCollector::_resetEnvironmentMetrics()
 
 void SimulationMetricsCollector::_updateAgentMetrics(SteerLib::SpatialDataBaseInterface * gridDB, const std::vector<SteerLib::AgentInterface*> & updatedAgents, float currentTimeStamp, float timePassedSinceLastFrame)
 {
-	for (unsigned int i=0; i < getNumAgents(); i++) {
+	if (_taskScheduler == NULL) {
+		_updateAgentMetricsRange(gridDB, updatedAgents, currentTimeStamp, timePassedSinceLastFrame, 0, getNumAgents());
+		return;
+	}
+
+	// the ranges only depend on the number of agents, so every run partitions the work the same way.
+	_taskScheduler->parallelFor(0, getNumAgents(), 0, [&](size_t firstAgent, size_t endAgent) {
+		_updateAgentMetricsRange(gridDB, updatedAgents, currentTimeStamp, timePassedSinceLastFrame, firstAgent, endAgent);
+	});
+}
+
+
+void SimulationMetricsCollector::_updateAgentMetricsRange(SteerLib::SpatialDataBaseInterface * gridDB, const std::vector<SteerLib::AgentInterface*> & updatedAgents, float currentTimeStamp, float timePassedSinceLastFrame, size_t firstAgent, size_t endAgent)
+{
+	Util::TraceScope traceThisFunction("updateAgentMetrics");
+	for (size_t i=firstAgent; i < endAgent; i++) {
 		/// @todo do we need this enabled() check here?  It may even be undesirable to keep it here.
 		// std::cout << "Updating agent " << i << " metrics" << std::endl;
 		if (updatedAgents[i]->enabled()) _agentCollectors[i]->update(gridDB, updatedAgents[i], currentTimeStamp, timePassedSinceLastFrame);
@@ -144,6 +144,8 @@ using namespace Util;
 #define DEFAULT_CLOG_REDIRECTION_FILENAME ""
 #define DEFAULT_DATA_FILE ""
 #define DEFAULT_NUM_THREADS 1
+#define DEFAULT_NEIGHBOR_LIST_SKIN 1.0f
+#define DEFAULT_DISTANCE_FIELD_CELL_SIZE 0.2f
 #define DEFAULT_NUM_FRAMES_TO_SIMULATE 0
 #define DEFAULT_FIXED_FPS 14.0f
 #define DEFAULT_MIN_VARIABLE_DT 0.001f
@@ -164,6 +166,8 @@ using namespace Util;
 #define DEFAULT_GRID_SIZE_Z 200.0f
 #define DEFAULT_NUM_GRID_CELLS_X 200
 #define DEFAULT_NUM_GRID_CELLS_Z 200
+#define DEFAULT_NUM_OBSTACLE_CELLS_X 0
+#define DEFAULT_NUM_OBSTACLE_CELLS_Z 0
 #define DEFAULT_DRAW_GRID true
 
 //====================================
@@ -240,8 +244,12 @@ SimulationOptions::SimulationOptions()
 	// engine options
 	engineOptions.moduleSearchPath = DEFAULT_MODULE_SEARCH_PATH;
 	engineOptions.testCaseSearchPath = DEFAULT_TEST_CASE_SEARCH_PATH;
+	engineOptions.traceFilename = "";
+	engineOptions.trajectoryFilename = "";
 	engineOptions.startupModules.clear();
 	engineOptions.numThreads = DEFAULT_NUM_THREADS;
+	engineOptions.neighborListSkin = DEFAULT_NEIGHBOR_LIST_SKIN;
+	engineOptions.distanceFieldCellSize = DEFAULT_DISTANCE_FIELD_CELL_SIZE;
 	engineOptions.numFramesToSimulate = DEFAULT_NUM_FRAMES_TO_SIMULATE;
 	engineOptions.fixedFPS = DEFAULT_FIXED_FPS;
 	engineOptions.minVariableDt = DEFAULT_MIN_VARIABLE_DT;
@@ -257,6 +265,8 @@ SimulationOptions::SimulationOptions()
 	gridDatabaseOptions.gridSizeZ = DEFAULT_GRID_SIZE_Z;
 	gridDatabaseOptions.numGridCellsX = DEFAULT_NUM_GRID_CELLS_X;
 	gridDatabaseOptions.numGridCellsZ = DEFAULT_NUM_GRID_CELLS_Z;
+	gridDatabaseOptions.numObstacleCellsX = DEFAULT_NUM_OBSTACLE_CELLS_X;
+	gridDatabaseOptions.numObstacleCellsZ = DEFAULT_NUM_OBSTACLE_CELLS_Z;
 	gridDatabaseOptions.drawGrid = DEFAULT_DRAW_GRID;
 
 	// Planning Domain options
@@ -461,11 +471,15 @@ void SimulationOptions::_setupXMLStructure( Util::XMLParser & xmlOpts )
 	engineTag->createChildTag("testCaseSearchPath","The default directory to search for test cases at runtime.", XML_DATA_TYPE_STRING, &engineOptions.testCaseSearchPath);
 	engineTag->createChildTag("startupModules", "The list of modules to use on startup.  Modules specified by the command line will be merged with this list.", XML_DATA_TYPE_CONTAINER, NULL, &_startupModulesXMLParser);
 	engineTag->createChildTag("numThreads", "The default number of threads to run on the simulation", XML_DATA_TYPE_UNSIGNED_INT, &engineOptions.numThreads);
+	engineTag->createChildTag("neighborListSkin", "The extra distance, in meters, that the engine's neighbor lists reach beyond the range AI modules requested.  The lists are rebuilt only after some agent moved more than half of this distance; larger values mean fewer rebuilds but longer lists.", XML_DATA_TYPE_FLOAT, &engineOptions.neighborListSkin);
+	engineTag->createChildTag("distanceFieldCellSize", "The spacing, in meters, of the samples of the engine's signed distance field of the obstacles.  Smaller values are more accurate near corners but use more memory and take longer to build.", XML_DATA_TYPE_FLOAT, &engineOptions.distanceFieldCellSize);
 	engineTag->createChildTag("numFrames", "The default number of frames to simulate - 0 means run the entire simulation until all agents are disabled.", XML_DATA_TYPE_UNSIGNED_INT, &engineOptions.numFramesToSimulate);
 	engineTag->createChildTag("fixedFPS", "The fixed frames-per-second for the simulation clock.  This value is used when simulationClockMode is \"fixed-fast\" or \"fixed-real-time\".", XML_DATA_TYPE_FLOAT, &engineOptions.fixedFPS);
 	engineTag->createChildTag("minVariableDt", "The minimum time-step allowed when the clock is in \"variable-real-time\" mode.  If the proposed time-step is smaller, this value will be used instead, effectively limiting the max frame rate.", XML_DATA_TYPE_FLOAT, &engineOptions.minVariableDt);
 	engineTag->createChildTag("maxVariableDt", "The maximum time-step allowed when the clock is in \"variable-real-time\" mode.  If the proposed time-step is larger, this value will be used instead, at the expense of breaking synchronization between simulation time and real-time.", XML_DATA_TYPE_FLOAT, &engineOptions.maxVariableDt);
 	engineTag->createChildTag("clockMode", "can be either \"fixed-fast\" (fixed simulation frame rate, running as fast as possible), \"fixed-real-time\" (fixed simulation frame rate, running in real-time), or \"variable-real-time\" (variable simulation frame rate in real-time).", XML_DATA_TYPE_STRING, &engineOptions.clockMode);
+	engineTag->createChildTag("traceFile", "If a filename is specified, a timeline of every frame, module, and agent phase is recorded and written to that file in the Chrome trace format (viewable in chrome://tracing).", XML_DATA_TYPE_STRING, &engineOptions.traceFilename);
+	engineTag->createChildTag("trajectoryFile", "If a filename is specified, the positions of the agents are written to that file while the simulation runs, instead of being kept in memory until the results are output.  Files ending in .csv are written as text, others in a compact binary format.", XML_DATA_TYPE_STRING, &engineOptions.trajectoryFilename);
 	engineTag->createChildTag("outputResults", "either true or false. If true, an altered XML file will be output.", XML_DATA_TYPE_BOOLEAN, &engineOptions.outputResults);
 
 	// spatial database stuff
@@ -484,6 +498,8 @@ void SimulationOptions::_setupXMLStructure( Util::XMLParser & xmlOpts )
 	gridDatabaseTag->createChildTag("sizeZ", "Total size of the grid along the Z axis", XML_DATA_TYPE_FLOAT, &gridDatabaseOptions.gridSizeZ);
 	gridDatabaseTag->createChildTag("numCellsX", "Number of cells in the grid along the X axis", XML_DATA_TYPE_UNSIGNED_INT, &gridDatabaseOptions.numGridCellsX);
 	gridDatabaseTag->createChildTag("numCellsZ", "Number of cells in the grid along the Z axis", XML_DATA_TYPE_UNSIGNED_INT, &gridDatabaseOptions.numGridCellsZ);
+	gridDatabaseTag->createChildTag("numObstacleCellsX", "Number of cells of the obstacle layer along the X axis; 0 uses numCellsX", XML_DATA_TYPE_UNSIGNED_INT, &gridDatabaseOptions.numObstacleCellsX);
+	gridDatabaseTag->createChildTag("numObstacleCellsZ", "Number of cells of the obstacle layer along the Z axis; 0 uses numCellsZ", XML_DATA_TYPE_UNSIGNED_INT, &gridDatabaseOptions.numObstacleCellsZ);
 	gridDatabaseTag->createChildTag("draw", "Draws the grid if \"true\".", XML_DATA_TYPE_BOOLEAN, &gridDatabaseOptions.drawGrid);
 
 	// GLFW engine driver options
@@ -138,5 +138,9 @@ void SimulationRecorderModule::postprocessSimulation() {
 	std::cout << "Wrote " << _engine->getClock().getCurrentFrameNumber()+1 << " frames. (one extra frame for initial conditions)" << std::endl;
 #endif
 	delete _simulationWriter;
+	_simulationWriter = NULL;
+
+	// the next simulation of the same engine (e.g., the next run of a SteerSimSession) records again.
+	_initialized = false;
 }
 
@@ -0,0 +1,40 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+/// @file SpatialDataBaseInterface.cpp
+/// @brief Implements the default typed queries of the SteerLib::SpatialDataBaseInterface.
+
+#include "interfaces/SpatialDataBaseInterface.h"
+#include "interfaces/AgentInterface.h"
+#include "interfaces/ObstacleInterface.h"
+
+using namespace SteerLib;
+
+
+void SpatialDataBaseInterface::getAgentsInRange(std::vector<AgentInterface*> & neighborList, float xmin, float xmax, float zmin, float zmax, SpatialDatabaseItemPtr exclude)
+{
+	std::vector<SpatialDatabaseItemPtr> items;
+	getItemsInRange(items, xmin, xmax, zmin, zmax, exclude);
+	neighborList.clear();
+	for (size_t i = 0; i < items.size(); i++) {
+		if (AgentInterface * agent = asAgent(items[i])) {
+			neighborList.push_back(agent);
+		}
+	}
+}
+
+
+void SpatialDataBaseInterface::getObstaclesInRange(std::vector<ObstacleInterface*> & neighborList, float xmin, float xmax, float zmin, float zmax, SpatialDatabaseItemPtr exclude)
+{
+	std::vector<SpatialDatabaseItemPtr> items;
+	getItemsInRange(items, xmin, xmax, zmin, zmax, exclude);
+	neighborList.clear();
+	for (size_t i = 0; i < items.size(); i++) {
+		if (ObstacleInterface * obstacle = asObstacle(items[i])) {
+			neighborList.push_back(obstacle);
+		}
+	}
+}
@@ -0,0 +1,309 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+/// @file TaskScheduler.cpp
+/// @brief Implements Util::TaskScheduler and Util::TaskGroup.
+
+#include <algorithm>
+#include "util/TaskScheduler.h"
+#include "util/GenericException.h"
+
+using namespace Util;
+
+
+/// The scheduler that the current thread is a worker of, or NULL.
+static thread_local const TaskScheduler * tlsCurrentScheduler = NULL;
+/// The index of the queue of the current worker thread in tlsCurrentScheduler.
+static thread_local unsigned int tlsCurrentQueueIndex = 0;
+
+
+TaskScheduler::TaskScheduler(unsigned int numThreads)
+{
+	if (numThreads == 0) {
+		numThreads = getDefaultNumThreads();
+	}
+
+	_numQueuedJobs = 0;
+	_shuttingDown = false;
+
+	for (unsigned int i = 0; i < numThreads; i++) {
+		_queues.push_back(new WorkQueue());
+	}
+
+	// queue 0 belongs to the threads that spawn and wait for tasks, every other queue to one worker thread.
+	try {
+		for (unsigned int i = 1; i < numThreads; i++) {
+			_threads.push_back(std::thread(&TaskScheduler::_runWorkerThread, this, i));
+		}
+	}
+	catch (std::exception &e) {
+		_shutDown();
+		throw GenericException(std::string("Could not create the worker threads of a TaskScheduler: ") + e.what());
+	}
+}
+
+
+TaskScheduler::~TaskScheduler()
+{
+	_shutDown();
+}
+
+
+void TaskScheduler::_shutDown()
+{
+	{
+		std::lock_guard<std::mutex> lock(_sleepLock);
+		_shuttingDown = true;
+	}
+	_workAvailable.notify_all();
+
+	for (unsigned int i = 0; i < _threads.size(); i++) {
+		_threads[i].join();
+	}
+	_threads.clear();
+
+	for (unsigned int i = 0; i < _queues.size(); i++) {
+		delete _queues[i];
+	}
+	_queues.clear();
+}
+
+
+unsigned int TaskScheduler::getDefaultNumThreads()
+{
+	unsigned int numThreads = std::thread::hardware_concurrency();
+	return (numThreads > 0) ? numThreads : 1;
+}
+
+
+size_t TaskScheduler::getChunkSize(size_t begin, size_t end, size_t grainSize)
+{
+	if (grainSize > 0) {
+		return grainSize;
+	}
+	size_t rangeSize = (end > begin) ? (end - begin) : 0;
+	size_t chunkSize = (rangeSize + DEFAULT_NUM_PARALLEL_FOR_CHUNKS - 1) / DEFAULT_NUM_PARALLEL_FOR_CHUNKS;
+	return (chunkSize > 0) ? chunkSize : 1;
+}
+
+
+size_t TaskScheduler::getNumChunks(size_t begin, size_t end, size_t grainSize)
+{
+	if (end <= begin) {
+		return 0;
+	}
+	size_t chunkSize = getChunkSize(begin, end, grainSize);
+	return (end - begin + chunkSize - 1) / chunkSize;
+}
+
+
+void TaskScheduler::parallelFor(size_t begin, size_t end, size_t grainSize, const std::function<void(size_t first, size_t end)> & body)
+{
+	size_t chunkSize = getChunkSize(begin, end, grainSize);
+	size_t numChunks = getNumChunks(begin, end, grainSize);
+
+	// the chunks are the same either way; without other threads there is no point in queueing them.
+	if ((numChunks <= 1) || (_threads.empty())) {
+		// like a task group, run every chunk and then re-throw the first exception.
+		std::exception_ptr exception;
+		for (size_t chunk = 0; chunk < numChunks; chunk++) {
+			size_t first = begin + chunk * chunkSize;
+			try {
+				body(first, std::min(first + chunkSize, end));
+			}
+			catch (...) {
+				if (!exception) {
+					exception = std::current_exception();
+				}
+			}
+		}
+		if (exception) {
+			std::rethrow_exception(exception);
+		}
+		return;
+	}
+
+	TaskGroup group(*this);
+	for (size_t chunk = 0; chunk < numChunks; chunk++) {
+		size_t first = begin + chunk * chunkSize;
+		size_t last = std::min(first + chunkSize, end);
+		group.run([&body, first, last]() { body(first, last); });
+	}
+	group.wait();
+}
+
+
+unsigned int TaskScheduler::_getCurrentQueueIndex() const
+{
+	return (tlsCurrentScheduler == this) ? tlsCurrentQueueIndex : 0;
+}
+
+
+void TaskScheduler::_spawn(Job * job)
+{
+	// count the job before it becomes visible, so that stealing it never makes the count negative.
+	_numQueuedJobs++;
+	WorkQueue * queue = _queues[_getCurrentQueueIndex()];
+	{
+		std::lock_guard<std::mutex> lock(queue->lock);
+		queue->jobs.push_back(job);
+	}
+
+	// taking the lock makes sure a worker that just found nothing to do is already waiting, so it cannot miss this notification.
+	{
+		std::lock_guard<std::mutex> lock(_sleepLock);
+	}
+	_workAvailable.notify_one();
+}
+
+
+TaskScheduler::Job * TaskScheduler::_findJob(unsigned int queueIndex)
+{
+	if (_numQueuedJobs == 0) {
+		return NULL;
+	}
+
+	// newest job from the own queue first, then the oldest job of every other queue in turn.
+	unsigned int numQueues = (unsigned int)_queues.size();
+	for (unsigned int i = 0; i < numQueues; i++) {
+		WorkQueue * queue = _queues[(queueIndex + i) % numQueues];
+		std::lock_guard<std::mutex> lock(queue->lock);
+		if (!queue->jobs.empty()) {
+			Job * job;
+			if (i == 0) {
+				job = queue->jobs.back();
+				queue->jobs.pop_back();
+			}
+			else {
+				job = queue->jobs.front();
+				queue->jobs.pop_front();
+			}
+			_numQueuedJobs--;
+			return job;
+		}
+	}
+	return NULL;
+}
+
+
+void TaskScheduler::_runJob(Job * job)
+{
+	std::exception_ptr exception;
+	try {
+		job->function();
+	}
+	catch (...) {
+		exception = std::current_exception();
+	}
+
+	TaskGroup * group = job->group;
+	unsigned long long taskNumber = job->taskNumber;
+	delete job;
+	// the group may be destroyed as soon as this returns.
+	group->_taskDone(taskNumber, exception);
+}
+
+
+void TaskScheduler::_runWorkerThread(unsigned int queueIndex)
+{
+	tlsCurrentScheduler = this;
+	tlsCurrentQueueIndex = queueIndex;
+
+	while (true) {
+		Job * job = _findJob(queueIndex);
+		if (job != NULL) {
+			_runJob(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(_sleepLock);
+		_workAvailable.wait(lock, [this]() { return _shuttingDown || (_numQueuedJobs > 0); });
+		if (_shuttingDown) {
+			break;
+		}
+	}
+
+	tlsCurrentScheduler = NULL;
+}
+
+
+//========================================
+
+TaskGroup::TaskGroup(TaskScheduler & scheduler) : _scheduler(scheduler)
+{
+	_numPendingTasks = 0;
+	_numSpawnedTasks = 0;
+	_exceptionTaskNumber = 0;
+}
+
+
+TaskGroup::~TaskGroup()
+{
+	_join();
+}
+
+
+void TaskGroup::run(const std::function<void()> & task)
+{
+	TaskScheduler::Job * job = new TaskScheduler::Job();
+	job->function = task;
+	job->group = this;
+	job->taskNumber = _numSpawnedTasks++;
+
+	_numPendingTasks++;
+	_scheduler._spawn(job);
+}
+
+
+void TaskGroup::wait()
+{
+	_join();
+
+	std::exception_ptr exception;
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		exception = _exception;
+		_exception = std::exception_ptr();
+	}
+	if (exception) {
+		std::rethrow_exception(exception);
+	}
+}
+
+
+void TaskGroup::_join()
+{
+	unsigned int queueIndex = _scheduler._getCurrentQueueIndex();
+
+	// help with any queued work (of this group or any other) instead of sleeping.
+	while (_numPendingTasks > 0) {
+		TaskScheduler::Job * job = _scheduler._findJob(queueIndex);
+		if (job != NULL) {
+			_scheduler._runJob(job);
+			continue;
+		}
+
+		// nothing is queued, so the remaining tasks are running on other threads; they notify when they are done.
+		std::unique_lock<std::mutex> lock(_lock);
+		_allTasksDone.wait(lock, [this]() { return (_numPendingTasks == 0); });
+	}
+
+	// the last task may still be inside _taskDone(); wait until it released the lock.
+	std::lock_guard<std::mutex> lock(_lock);
+}
+
+
+void TaskGroup::_taskDone(unsigned long long taskNumber, std::exception_ptr exception)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	if (exception && (!_exception || (taskNumber < _exceptionTaskNumber))) {
+		_exception = exception;
+		_exceptionTaskNumber = taskNumber;
+	}
+	if (--_numPendingTasks == 0) {
+		_allTasksDone.notify_all();
+	}
+}
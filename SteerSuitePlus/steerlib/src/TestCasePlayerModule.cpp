@@ -23,6 +23,14 @@ void TestCasePlayerModule::init( const SteerLib::OptionDictionary & options, Ste
 	_aiModuleSearchPath = "";
 	_aiModule = NULL;
 	_obstacles.clear();
+	_testCaseReader = NULL;
+	_testCaseReaderPath = "";
+	_scaleFactor = 1.0f;
+	_tilesX = 1;
+	_tilesZ = 1;
+	_tileSpacing = 0.0f;
+	_numAgents = 0;
+	_testCaseScaler = NULL;
 
 	// parse command line options
 	SteerLib::OptionDictionary::const_iterator optionIter;
@@ -33,6 +41,21 @@ void TestCasePlayerModule::init( const SteerLib::OptionDictionary & options, Ste
 		else if ((*optionIter).first == "ai") {
 			_aiModuleName = (*optionIter).second;
 		}
+		else if ((*optionIter).first == "scaleFactor") {
+			_scaleFactor = atof((*optionIter).second.c_str());
+		}
+		else if ((*optionIter).first == "tilesX") {
+			_tilesX = atoi((*optionIter).second.c_str());
+		}
+		else if ((*optionIter).first == "tilesZ") {
+			_tilesZ = atoi((*optionIter).second.c_str());
+		}
+		else if ((*optionIter).first == "tileSpacing") {
+			_tileSpacing = atof((*optionIter).second.c_str());
+		}
+		else if ((*optionIter).first == "numAgents") {
+			_numAgents = atoi((*optionIter).second.c_str());
+		}
 		else {
 			throw Util::GenericException("unrecognized option \"" + Util::toString((*optionIter).first) + "\" given to testCasePlayer module.");
 		}
@@ -71,9 +94,41 @@ void TestCasePlayerModule::init( const SteerLib::OptionDictionary & options, Ste
 #endif
 }
 
-void TestCasePlayerModule::initializeSimulation() {
+template <typename TestCaseType>
+void TestCasePlayerModule::_createTestCaseObjects(const TestCaseType & testCase) {
 
-	SteerLib::TestCaseReader * testCaseReader;
+	//Create the obstacles
+	for (unsigned int i=0; i < testCase.getNumObstacles(); i++) {
+		const SteerLib::ObstacleInitialConditions * ic = testCase.getObstacleInitialConditions(i);
+		/*SteerLib::BoxObstacle * b;
+		b = new SteerLib::BoxObstacle(ic.xmin, ic.xmax, ic.ymin, ic.ymax, ic.zmin, ic.zmax);*/
+		SteerLib::ObstacleInterface *b = const_cast<SteerLib::ObstacleInitialConditions*>(ic)->createObstacle(); // TODO: FIX THIS.
+		_obstacles.push_back(b);
+		_engine->addObstacle(b);
+		_engine->getSpatialDatabase()->addObject( b, b->getBounds());
+		// std::cout << "adding obstacle";
+	}
+
+	//Create the agents
+	for (unsigned int i=0; i < testCase.getNumAgents(); i++) {
+		const SteerLib::AgentInitialConditions & ic = testCase.getAgentInitialConditions(i);
+		// If the agent starts at time 0, add to the agent list
+		if (ic.startTime == 0) {
+			_engine->createAgent(ic, _aiModule);
+		}
+		else { // Otherwise, add late start agent to a "waiting agents" list
+			_engine->addWaitingAgent(ic, _aiModule);
+		}
+	}
+
+	//Create the agent emitters
+	for (unsigned int i=0; i < testCase.getNumAgentEmitters(); i++) {
+		const SteerLib::AgentInitialConditions & ic = testCase.getAgentEmitterInitialConditions(i);
+		_engine->createAgentEmitter( ic, _aiModule );
+	}
+}
+
+void TestCasePlayerModule::initializeSimulation() {
 
 	std::string testCasePath;
 
@@ -94,38 +149,47 @@ void TestCasePlayerModule::initializeSimulation() {
 		throw Util::GenericException("Could not find test case " + _testCaseFilename + ".");
 	}
 
-	// open the test case
-	testCaseReader = new SteerLib::TestCaseReader();
-	testCaseReader->readTestCaseFromFile(testCasePath);
-
-	//Create the obstacles
-	for (unsigned int i=0; i < testCaseReader->getNumObstacles(); i++) {
-		const SteerLib::ObstacleInitialConditions * ic = testCaseReader->getObstacleInitialConditions(i);
-		/*SteerLib::BoxObstacle * b;
-		b = new SteerLib::BoxObstacle(ic.xmin, ic.xmax, ic.ymin, ic.ymax, ic.zmin, ic.zmax);*/
-		SteerLib::ObstacleInterface *b = const_cast<SteerLib::ObstacleInitialConditions*>(ic)->createObstacle(); // TODO: FIX THIS.
-		_obstacles.push_back(b);
-		_engine->addObstacle(b);
-		_engine->getSpatialDatabase()->addObject( b, b->getBounds());
-		// std::cout << "adding obstacle";
-	}
-
-	//Create the agents
-	for (unsigned int i=0; i < testCaseReader->getNumAgents(); i++) {
-		const SteerLib::AgentInitialConditions & ic = testCaseReader->getAgentInitialConditions(i);
-		// If the agent starts at time 0, add to the agent list
-		if (ic.startTime == 0) {
-			_engine->createAgent(ic, _aiModule);
+	// open the test case, unless it was already parsed for a previous simulation.
+	if ((_testCaseReader == NULL) || (_testCaseReaderPath != testCasePath)) {
+		delete _testCaseReader;
+		_testCaseReader = NULL;
+		delete _testCaseScaler;
+		_testCaseScaler = NULL;
+		SteerLib::TestCaseReader * newTestCaseReader = new SteerLib::TestCaseReader();
+		try {
+			newTestCaseReader->readTestCaseFromFile(testCasePath);
 		}
-		else { // Otherwise, add late start agent to a "waiting agents" list
-			_engine->addWaitingAgent(ic, _aiModule);
+		catch (...) {
+			delete newTestCaseReader;
+			throw;
 		}
+		_testCaseReader = newTestCaseReader;
+		_testCaseReaderPath = testCasePath;
 	}
-
-	//Create the agent emitters
-	for (unsigned int i=0; i < testCaseReader->getNumAgentEmitters(); i++) {
-		const SteerLib::AgentInitialConditions & ic = testCaseReader->getAgentEmitterInitialConditions(i);
-		_engine->createAgentEmitter( ic, _aiModule );
+	SteerLib::TestCaseReader * testCaseReader = _testCaseReader;
+
+	// a scaled or tiled test case is created in memory, without an XML round trip.
+	if ((_scaleFactor != 1.0f) || (_tilesX * _tilesZ > 1) || (_numAgents > testCaseReader->getNumAgents())) {
+		if (_testCaseScaler == NULL) {
+			unsigned int tilesX = _tilesX;
+			unsigned int tilesZ = _tilesZ;
+			if (_numAgents > 0) {
+				SteerLib::TestCaseScaler::getTilesForNumAgents(testCaseReader->getNumAgents(), _numAgents, tilesX, tilesZ);
+			}
+			_testCaseScaler = new SteerLib::TestCaseScaler();
+			_testCaseScaler->scaleTestCase(*testCaseReader, _scaleFactor, tilesX, tilesZ, _tileSpacing);
+
+			const Util::AxisAlignedBox & bounds = _testCaseScaler->getWorldBounds();
+			SteerLib::SpatialDataBaseInterface * spatialDatabase = _engine->getSpatialDatabase();
+			if ((bounds.xmin < spatialDatabase->getOriginX()) || (bounds.xmax > spatialDatabase->getOriginX() + spatialDatabase->getGridSizeX()) ||
+				(bounds.zmin < spatialDatabase->getOriginZ()) || (bounds.zmax > spatialDatabase->getOriginZ() + spatialDatabase->getGridSizeZ())) {
+				std::cerr << "WARNING: the scaled test case " << _testCaseFilename << " is larger than the spatial database; increase the sizeX and sizeZ options of the gridDatabase.\n";
+			}
+		}
+		_createTestCaseObjects(*_testCaseScaler);
+	}
+	else {
+		_createTestCaseObjects(*testCaseReader);
 	}
 
 	//Setting CameraView if defined
@@ -136,8 +200,6 @@ void TestCasePlayerModule::initializeSimulation() {
 		_engine->getCamera().setView(testCaseReader->getCameraView(0));
 	}
 
-	delete testCaseReader;
-
 
 #ifdef ENABLE_GUI
 #ifdef ENABLE_QT
@@ -178,6 +240,11 @@ void TestCasePlayerModule::cleanupSimulation() {
 
 void TestCasePlayerModule::finish() {
 
+	delete _testCaseReader;
+	_testCaseReader = NULL;
+	delete _testCaseScaler;
+	_testCaseScaler = NULL;
+
 #ifdef ENABLE_GUI
 #ifdef ENABLE_QT
 
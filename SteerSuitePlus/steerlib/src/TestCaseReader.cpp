@@ -7,6 +7,7 @@
 /// @file TestCaseReader.cpp
 /// @brief Implements the SteerLib::TestCaseReader class.
 
+#include <fstream>
 #include "testcaseio/TestCaseIO.h"
 #include "util/GenericException.h"
 #include "util/Misc.h"
@@ -24,6 +25,22 @@ TestCaseReader::TestCaseReader()
 	_randomNumberGenerator.seed(2);
 }
 
+bool TestCaseReader::isABinaryTestCase( const std::string & filename )
+{
+	ifstream testCaseFile;
+	testCaseFile.open( filename.c_str(), ios::binary );
+
+	if (!testCaseFile.is_open()) {
+		return false;
+	}
+
+	unsigned int magic = 0;
+	testCaseFile.read((char*)&magic, sizeof(unsigned int));
+	testCaseFile.close();
+
+	return (magic == BINARY_TEST_CASE_MAGIC_NUMBER);
+}
+
 void TestCaseReader::readTestCaseFromFile( const std::string & testCaseFilename )
 {
 	_header.description = "";
@@ -33,6 +50,11 @@ void TestCaseReader::readTestCaseFromFile( const std::string & testCaseFilename
 	_header.worldBounds = AxisAlignedBox(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
 	_header.scale = 1.0;
 
+	// binary test cases are already initialized, so they are loaded directly.
+	if (isABinaryTestCase(testCaseFilename)) {
+		_readBinaryTestCase(testCaseFilename);
+		return;
+	}
 
 	//
 	// first, parse the test case and get the raw data from it
@@ -8,13 +8,14 @@
 //
 
 /// @file TestCaseReaderPrivate.cpp
-/// @brief Helper functions to read complex data types from an SteerSuite XML test case.
+/// @brief Helper functions to read complex data types from an SteerSuite XML test case, and to read binary test cases.
 
 #include "testcaseio/TestCaseIO.h"
 #include "testcaseio/Behaviour.h"
 #include "util/Geometry.h"
 #include "util/Misc.h"
 #include "util/GenericException.h"
+#include "util/MemoryMapper.h"
 
 using namespace std;
 using namespace SteerLib;
@@ -964,6 +965,7 @@ void TestCaseReaderPrivate::_parseInitialConditions(const ticpp::Element * subRo
 {
 	ticpp::Iterator<ticpp::Element> child;
 	newAgent.colorSet = false;
+	newAgent.startTime = 0.0f;
 	for (child = child.begin(subRoot); child != child.end(); child++ ) {
 
 		std::string childTagName = child->Value();
@@ -1075,3 +1077,195 @@ void TestCaseReaderPrivate::_initAgentEmitterInitialConditions( AgentInitialCond
 	a.speed = agent.speed;
 	a.goals = agent.goals;  // note, this is a STL vector being copied into another STL vector.
 }
+
+
+/// Throws an exception unless numItems items of itemSize bytes starting at offset are inside the file.
+static void _checkBinaryTestCaseSection(const std::string & testCaseFilename, const std::string & sectionName, unsigned int offset, unsigned int numItems, size_t itemSize, unsigned int fileSize)
+{
+	unsigned long long sectionEnd = (unsigned long long)offset + (unsigned long long)numItems * (unsigned long long)itemSize;
+	if (sectionEnd > (unsigned long long)fileSize) {
+		throw GenericException("Binary test case " + testCaseFilename + " is truncated or corrupt: the " + sectionName + " section ends at byte " + toString(sectionEnd) + ", but the file has " + toString(fileSize) + " bytes.");
+	}
+}
+
+
+/// Helper for reading the string table of a binary test case.
+class BinaryTestCaseStrings {
+public:
+	BinaryTestCaseStrings(const char * strings, unsigned int size, const std::string & testCaseFilename) : _strings(strings), _size(size), _testCaseFilename(testCaseFilename)
+	{
+		if ((size == 0) || (strings[size-1] != '\0')) {
+			throw GenericException("Binary test case " + testCaseFilename + " has a corrupt string table.");
+		}
+	}
+	std::string get(unsigned int offset) const
+	{
+		if (offset >= _size) {
+			throw GenericException("Binary test case " + _testCaseFilename + " refers to string " + toString(offset) + " outside its string table.");
+		}
+		return std::string(_strings + offset);
+	}
+private:
+	const char * _strings;
+	unsigned int _size;
+	const std::string & _testCaseFilename;
+};
+
+
+static inline Point _pointFromBinary(const float * p) { return Point(p[0], p[1], p[2]); }
+static inline Vector _vectorFromBinary(const float * v) { return Vector(v[0], v[1], v[2]); }
+static inline AxisAlignedBox _boxFromBinary(const float * b) { return AxisAlignedBox(b[0], b[1], b[2], b[3], b[4], b[5]); }
+
+
+void TestCaseReaderPrivate::_readBinaryTestCase(const std::string & testCaseFilename)
+{
+	MemoryMapper fileMap;
+	fileMap.open(testCaseFilename);
+
+	const char * base = (const char*)fileMap.getBasePointer();
+	unsigned int fileSize = fileMap.getFileSize();
+	if (fileSize < sizeof(BinaryTestCaseHeader)) {
+		throw GenericException("Binary test case " + testCaseFilename + " is too small to contain a header.");
+	}
+
+	const BinaryTestCaseHeader * header = (const BinaryTestCaseHeader*)base;
+	if (header->magic != BINARY_TEST_CASE_MAGIC_NUMBER) {
+		throw GenericException(testCaseFilename + " does not seem to be a binary test case; if it was written on another machine, it may be a big-endian/little-endian incompatibility.");
+	}
+	if ((header->version != BINARY_TEST_CASE_VERSION) || (header->headerSize != sizeof(BinaryTestCaseHeader))) {
+		throw GenericException("Version incompatibility; this TestCaseReader supports binary test case version " + toString(BINARY_TEST_CASE_VERSION) + ", but " + testCaseFilename + " is version " + toString(header->version) + ".");
+	}
+
+	unsigned int numAgentsAndEmitters = header->numAgents + header->numAgentEmitters;
+	_checkBinaryTestCaseSection(testCaseFilename, "agent", header->agentListOffset, numAgentsAndEmitters, sizeof(BinaryTestCaseAgentInfo), fileSize);
+	_checkBinaryTestCaseSection(testCaseFilename, "goal", header->goalListOffset, header->numGoals, sizeof(BinaryTestCaseGoalInfo), fileSize);
+	_checkBinaryTestCaseSection(testCaseFilename, "behaviour parameter", header->behaviourParameterListOffset, header->numBehaviourParameters, sizeof(BinaryTestCaseBehaviourParameterInfo), fileSize);
+	_checkBinaryTestCaseSection(testCaseFilename, "obstacle", header->obstacleListOffset, header->numObstacles, sizeof(BinaryTestCaseObstacleInfo), fileSize);
+	_checkBinaryTestCaseSection(testCaseFilename, "vertex", header->vertexListOffset, header->numVertices, 3 * sizeof(float), fileSize);
+	_checkBinaryTestCaseSection(testCaseFilename, "camera view", header->cameraListOffset, header->numCameraViews, sizeof(BinaryTestCaseCameraInfo), fileSize);
+	_checkBinaryTestCaseSection(testCaseFilename, "string table", header->stringTableOffset, header->stringTableSize, 1, fileSize);
+
+	const BinaryTestCaseAgentInfo * agentList = (const BinaryTestCaseAgentInfo*)(base + header->agentListOffset);
+	const BinaryTestCaseGoalInfo * goalList = (const BinaryTestCaseGoalInfo*)(base + header->goalListOffset);
+	const BinaryTestCaseBehaviourParameterInfo * parameterList = (const BinaryTestCaseBehaviourParameterInfo*)(base + header->behaviourParameterListOffset);
+	const BinaryTestCaseObstacleInfo * obstacleList = (const BinaryTestCaseObstacleInfo*)(base + header->obstacleListOffset);
+	const float * vertexList = (const float*)(base + header->vertexListOffset);
+	const BinaryTestCaseCameraInfo * cameraList = (const BinaryTestCaseCameraInfo*)(base + header->cameraListOffset);
+	BinaryTestCaseStrings strings(base + header->stringTableOffset, header->stringTableSize, testCaseFilename);
+
+	_header.name = strings.get(header->nameOffset);
+	_header.description = strings.get(header->descriptionOffset);
+	_header.version = strings.get(header->versionOffset);
+	_header.passingCriteria = strings.get(header->passingCriteriaOffset);
+	_header.worldBounds = _boxFromBinary(header->worldBounds);
+
+	// agents, followed by agent emitters.
+	_initializedAgents.reserve(_initializedAgents.size() + header->numAgents);
+	_initializedAgentEmitters.reserve(_initializedAgentEmitters.size() + header->numAgentEmitters);
+	for (unsigned int i=0; i < numAgentsAndEmitters; i++) {
+		const BinaryTestCaseAgentInfo & agentInfo = agentList[i];
+		std::vector<AgentInitialConditions> & agents = (i < header->numAgents) ? _initializedAgents : _initializedAgentEmitters;
+		agents.push_back(AgentInitialConditions());
+		AgentInitialConditions & agent = agents.back();
+
+		agent.name = strings.get(agentInfo.nameOffset);
+		agent.position = _pointFromBinary(agentInfo.position);
+		agent.direction = _vectorFromBinary(agentInfo.direction);
+		agent.radius = agentInfo.radius;
+		agent.speed = agentInfo.speed;
+		agent.startTime = agentInfo.startTime;
+		agent.color = Color(agentInfo.color[0], agentInfo.color[1], agentInfo.color[2]);
+		agent.colorSet = (agentInfo.colorSet != 0);
+		agent.fromRandom = (agentInfo.fromRandom != 0);
+		agent.randBox = _boxFromBinary(agentInfo.randBox);
+
+		if ((unsigned long long)agentInfo.firstGoal + agentInfo.numGoals > header->numGoals) {
+			throw GenericException("Binary test case " + testCaseFilename + " refers to goals outside its goal list.");
+		}
+		agent.goals.resize(agentInfo.numGoals);
+		for (unsigned int g=0; g < agentInfo.numGoals; g++) {
+			const BinaryTestCaseGoalInfo & goalInfo = goalList[agentInfo.firstGoal + g];
+			AgentGoalInfo & goal = agent.goals[g];
+			goal.goalType = (AgentGoalTypeEnum)goalInfo.goalType;
+			goal.targetIsRandom = (goalInfo.targetIsRandom != 0);
+			goal.timeDuration = goalInfo.timeDuration;
+			goal.desiredSpeed = goalInfo.desiredSpeed;
+			goal.targetLocation = _pointFromBinary(goalInfo.targetLocation);
+			goal.targetDirection = _vectorFromBinary(goalInfo.targetDirection);
+			goal.targetRegion = _boxFromBinary(goalInfo.targetRegion);
+			goal.targetName = strings.get(goalInfo.targetNameOffset);
+			goal.flowType = strings.get(goalInfo.flowTypeOffset);
+
+			goal.targetBehaviour.setSteeringAlg(strings.get(goalInfo.steeringAlgorithmOffset));
+			if ((unsigned long long)goalInfo.firstBehaviourParameter + goalInfo.numBehaviourParameters > header->numBehaviourParameters) {
+				throw GenericException("Binary test case " + testCaseFilename + " refers to behaviour parameters outside its parameter list.");
+			}
+			for (unsigned int p=0; p < goalInfo.numBehaviourParameters; p++) {
+				const BinaryTestCaseBehaviourParameterInfo & parameterInfo = parameterList[goalInfo.firstBehaviourParameter + p];
+				goal.targetBehaviour.addParameter(BehaviourParameter(strings.get(parameterInfo.keyOffset), strings.get(parameterInfo.valueOffset)));
+			}
+		}
+	}
+
+	_initializedObstacles.reserve(_initializedObstacles.size() + header->numObstacles);
+	for (unsigned int i=0; i < header->numObstacles; i++) {
+		const BinaryTestCaseObstacleInfo & obstacleInfo = obstacleList[i];
+		switch (obstacleInfo.type) {
+		case BINARY_TEST_CASE_BOX_OBSTACLE:
+			_initializedObstacles.push_back(new BoxObstacleInitialConditions(obstacleInfo.bounds[0], obstacleInfo.bounds[1], obstacleInfo.bounds[2], obstacleInfo.bounds[3], obstacleInfo.bounds[4], obstacleInfo.bounds[5]));
+			break;
+		case BINARY_TEST_CASE_CIRCLE_OBSTACLE:
+		{
+			CircleObstacleInitialConditions * circle = new CircleObstacleInitialConditions();
+			circle->position = _pointFromBinary(obstacleInfo.position);
+			circle->radius = obstacleInfo.radius;
+			circle->height = obstacleInfo.height;
+			_initializedObstacles.push_back(circle);
+			break;
+		}
+		case BINARY_TEST_CASE_ORIENTED_BOX_OBSTACLE:
+		case BINARY_TEST_CASE_ORIENTED_WALL_OBSTACLE:
+		{
+			OrientedBoxObstacleInitialConditions * orientedBox;
+			if (obstacleInfo.type == BINARY_TEST_CASE_ORIENTED_WALL_OBSTACLE) {
+				OrientedWallObstacleInitialConditions * wall = new OrientedWallObstacleInitialConditions();
+				wall->doorLocation = obstacleInfo.doorLocation;
+				wall->doorRadius = obstacleInfo.doorRadius;
+				orientedBox = wall;
+			}
+			else {
+				orientedBox = new OrientedBoxObstacleInitialConditions();
+			}
+			orientedBox->position = _pointFromBinary(obstacleInfo.position);
+			orientedBox->lengthX = obstacleInfo.lengthX;
+			orientedBox->lengthZ = obstacleInfo.lengthZ;
+			orientedBox->height = obstacleInfo.height;
+			orientedBox->thetaY = obstacleInfo.thetaY;
+			_initializedObstacles.push_back(orientedBox);
+			break;
+		}
+		case BINARY_TEST_CASE_POLYGON_OBSTACLE:
+		{
+			if ((unsigned long long)obstacleInfo.firstVertex + obstacleInfo.numVertices > header->numVertices) {
+				throw GenericException("Binary test case " + testCaseFilename + " refers to vertices outside its vertex list.");
+			}
+			PolygonObstacleInitialConditions * polygon = new PolygonObstacleInitialConditions();
+			polygon->_vertices.reserve(obstacleInfo.numVertices);
+			for (unsigned int v=0; v < obstacleInfo.numVertices; v++) {
+				polygon->_vertices.push_back(_pointFromBinary(vertexList + 3 * (obstacleInfo.firstVertex + v)));
+			}
+			_initializedObstacles.push_back(polygon);
+			break;
+		}
+		default:
+			throw GenericException("Binary test case " + testCaseFilename + " has an obstacle of unknown type " + toString(obstacleInfo.type) + ".");
+		}
+	}
+
+	for (unsigned int i=0; i < header->numCameraViews; i++) {
+		const BinaryTestCaseCameraInfo & cameraInfo = cameraList[i];
+		_cameraViews.push_back(CameraView(_pointFromBinary(cameraInfo.position), _pointFromBinary(cameraInfo.lookat), _vectorFromBinary(cameraInfo.up), cameraInfo.fovy));
+	}
+
+	fileMap.close();
+}
@@ -0,0 +1,197 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+/// @file TestCaseScaler.cpp
+/// @brief Implements the SteerLib::TestCaseScaler class.
+
+#include <cmath>
+#include <algorithm>
+#include "testcaseio/TestCaseScaler.h"
+#include "util/GenericException.h"
+#include "util/Misc.h"
+
+using namespace std;
+using namespace SteerLib;
+using namespace Util;
+
+
+TestCaseScaler::TestCaseScaler()
+{
+	_scaleFactor = 1.0f;
+}
+
+
+TestCaseScaler::~TestCaseScaler()
+{
+	_clear();
+}
+
+
+void TestCaseScaler::_clear()
+{
+	for (unsigned int i = 0; i < _obstacles.size(); i++) {
+		delete _obstacles[i];
+	}
+	_obstacles.clear();
+	_agents.clear();
+	_agentEmitters.clear();
+	_worldBounds = AxisAlignedBox();
+	_testCaseName = "";
+}
+
+
+void TestCaseScaler::getTilesForNumAgents(size_t numAgentsInTestCase, size_t numAgents, unsigned int & tilesX, unsigned int & tilesZ)
+{
+	tilesX = 1;
+	tilesZ = 1;
+	if ((numAgentsInTestCase == 0) || (numAgents <= numAgentsInTestCase)) {
+		return;
+	}
+
+	size_t numTiles = (numAgents + numAgentsInTestCase - 1) / numAgentsInTestCase;
+	tilesX = (unsigned int)ceil(sqrt((double)numTiles));
+	tilesZ = (unsigned int)((numTiles + tilesX - 1) / tilesX);
+}
+
+
+void TestCaseScaler::scaleTestCase(const TestCaseReader & testCase, float scaleFactor, unsigned int tilesX, unsigned int tilesZ, float tileSpacing)
+{
+	if ((scaleFactor <= 0.0f) || (tilesX == 0) || (tilesZ == 0)) {
+		throw GenericException("TestCaseScaler: the scale factor and the number of tiles must be positive.");
+	}
+
+	_clear();
+
+	const AxisAlignedBox & bounds = testCase.getWorldBounds();
+	_center = Point(0.5f * (bounds.xmin + bounds.xmax), 0.0f, 0.5f * (bounds.zmin + bounds.zmax));
+	_scaleFactor = scaleFactor;
+
+	// tiles are laid out side by side, centered on the original world.
+	float tileSizeX = (bounds.xmax - bounds.xmin) * scaleFactor + tileSpacing;
+	float tileSizeZ = (bounds.zmax - bounds.zmin) * scaleFactor + tileSpacing;
+
+	unsigned int numTiles = tilesX * tilesZ;
+	_agents.reserve(testCase.getNumAgents() * numTiles);
+	_agentEmitters.reserve(testCase.getNumAgentEmitters() * numTiles);
+	_obstacles.reserve(testCase.getNumObstacles() * numTiles);
+
+	for (unsigned int tileZ = 0; tileZ < tilesZ; tileZ++) {
+		for (unsigned int tileX = 0; tileX < tilesX; tileX++) {
+			Vector offset(((float)tileX - 0.5f * (float)(tilesX - 1)) * tileSizeX, 0.0f, ((float)tileZ - 0.5f * (float)(tilesZ - 1)) * tileSizeZ);
+			std::string nameSuffix = (numTiles > 1) ? ("_" + toString(tileX) + "_" + toString(tileZ)) : "";
+
+			for (unsigned int i = 0; i < testCase.getNumAgents(); i++) {
+				_agents.push_back(_transformAgent(testCase.getAgentInitialConditions(i), offset, nameSuffix));
+			}
+			for (unsigned int i = 0; i < testCase.getNumAgentEmitters(); i++) {
+				_agentEmitters.push_back(_transformAgent(testCase.getAgentEmitterInitialConditions(i), offset, nameSuffix));
+			}
+			for (unsigned int i = 0; i < testCase.getNumObstacles(); i++) {
+				ObstacleInitialConditions * obstacle = _transformObstacle(testCase.getObstacleInitialConditions(i), offset);
+				if (obstacle == NULL) {
+					throw GenericException("TestCaseScaler: obstacle " + toString(i) + " of test case " + testCase.getTestCaseName() + " has an unknown type.");
+				}
+				_obstacles.push_back(obstacle);
+			}
+			AxisAlignedBox tileBounds = _transformBox(bounds, offset);
+			_worldBounds.xmin = std::min(_worldBounds.xmin, tileBounds.xmin);
+			_worldBounds.xmax = std::max(_worldBounds.xmax, tileBounds.xmax);
+			_worldBounds.ymin = std::min(_worldBounds.ymin, tileBounds.ymin);
+			_worldBounds.ymax = std::max(_worldBounds.ymax, tileBounds.ymax);
+			_worldBounds.zmin = std::min(_worldBounds.zmin, tileBounds.zmin);
+			_worldBounds.zmax = std::max(_worldBounds.zmax, tileBounds.zmax);
+		}
+	}
+
+	_testCaseName = testCase.getTestCaseName();
+}
+
+
+void TestCaseScaler::writeTestCaseToFile(const std::string & testCaseName)
+{
+	TestCaseWriter writer;
+	writer.writeTestCaseToFile(testCaseName, _agents, _agentEmitters, _obstacles, _worldBounds);
+}
+
+
+Point TestCaseScaler::_transformPoint(const Point & p, const Vector & offset) const
+{
+	return Point(_center.x + (p.x - _center.x) * _scaleFactor + offset.x, p.y, _center.z + (p.z - _center.z) * _scaleFactor + offset.z);
+}
+
+
+AxisAlignedBox TestCaseScaler::_transformBox(const AxisAlignedBox & box, const Vector & offset) const
+{
+	// unused regions are left as empty boxes.
+	if ((box.xmin > box.xmax) || (box.zmin > box.zmax)) {
+		return box;
+	}
+	Point minCorner = _transformPoint(Point(box.xmin, box.ymin, box.zmin), offset);
+	Point maxCorner = _transformPoint(Point(box.xmax, box.ymax, box.zmax), offset);
+	return AxisAlignedBox(minCorner.x, maxCorner.x, box.ymin, box.ymax, minCorner.z, maxCorner.z);
+}
+
+
+AgentInitialConditions TestCaseScaler::_transformAgent(const AgentInitialConditions & agent, const Vector & offset, const std::string & nameSuffix) const
+{
+	AgentInitialConditions result = agent;
+	result.position = _transformPoint(agent.position, offset);
+	result.randBox = _transformBox(agent.randBox, offset);
+	if (!result.name.empty()) {
+		result.name += nameSuffix;
+	}
+
+	for (unsigned int i = 0; i < result.goals.size(); i++) {
+		AgentGoalInfo & goal = result.goals[i];
+		goal.targetLocation = _transformPoint(goal.targetLocation, offset);
+		goal.targetRegion = _transformBox(goal.targetRegion, offset);
+		// dynamic targets are agents of the same tile.
+		if (((goal.goalType == GOAL_TYPE_SEEK_DYNAMIC_TARGET) || (goal.goalType == GOAL_TYPE_FLEE_DYNAMIC_TARGET)) && !goal.targetName.empty()) {
+			goal.targetName += nameSuffix;
+		}
+	}
+	return result;
+}
+
+
+ObstacleInitialConditions * TestCaseScaler::_transformObstacle(const ObstacleInitialConditions * obstacle, const Vector & offset) const
+{
+	// OrientedWallObstacleInitialConditions derives from OrientedBoxObstacleInitialConditions, so it must be checked first.
+	if (const OrientedWallObstacleInitialConditions * wall = dynamic_cast<const OrientedWallObstacleInitialConditions*>(obstacle)) {
+		OrientedWallObstacleInitialConditions * result = new OrientedWallObstacleInitialConditions(*wall);
+		result->position = _transformPoint(wall->position, offset);
+		result->lengthX *= _scaleFactor;
+		result->lengthZ *= _scaleFactor;
+		result->doorLocation *= _scaleFactor;
+		result->doorRadius *= _scaleFactor;
+		return result;
+	}
+	if (const OrientedBoxObstacleInitialConditions * orientedBox = dynamic_cast<const OrientedBoxObstacleInitialConditions*>(obstacle)) {
+		OrientedBoxObstacleInitialConditions * result = new OrientedBoxObstacleInitialConditions(*orientedBox);
+		result->position = _transformPoint(orientedBox->position, offset);
+		result->lengthX *= _scaleFactor;
+		result->lengthZ *= _scaleFactor;
+		return result;
+	}
+	if (const BoxObstacleInitialConditions * box = dynamic_cast<const BoxObstacleInitialConditions*>(obstacle)) {
+		AxisAlignedBox bounds = _transformBox(AxisAlignedBox(box->xmin, box->xmax, box->ymin, box->ymax, box->zmin, box->zmax), offset);
+		return new BoxObstacleInitialConditions(bounds.xmin, bounds.xmax, bounds.ymin, bounds.ymax, bounds.zmin, bounds.zmax);
+	}
+	if (const CircleObstacleInitialConditions * circle = dynamic_cast<const CircleObstacleInitialConditions*>(obstacle)) {
+		CircleObstacleInitialConditions * result = new CircleObstacleInitialConditions(*circle);
+		result->position = _transformPoint(circle->position, offset);
+		result->radius *= _scaleFactor;
+		return result;
+	}
+	if (const PolygonObstacleInitialConditions * polygon = dynamic_cast<const PolygonObstacleInitialConditions*>(obstacle)) {
+		PolygonObstacleInitialConditions * result = new PolygonObstacleInitialConditions();
+		for (unsigned int i = 0; i < polygon->_vertices.size(); i++) {
+			result->_vertices.push_back(_transformPoint(polygon->_vertices[i], offset));
+		}
+		return result;
+	}
+	return NULL;
+}
@@ -8,6 +8,9 @@
 /// @brief Implements the SteerLib::TestCaseWriter class
 ///
 
+#include <fstream>
+#include <map>
+#include <cstring>
 #include "util/GenericException.h"
 #include "util/Misc.h"
 #include "mersenne/MersenneTwister.h"
@@ -720,6 +723,11 @@ void TestCaseWriter::writeTestCaseToFile(FILE *fp,
 		}
 	}
 
+	// with a trajectory sink, the positions are read back from its file for a group of agents at a time.
+	SteerLib::TrajectorySink * trajectorySink = engineInfo->getTrajectorySink();
+	std::vector<SteerLib::TrajectorySink::PositionList> streamedPositions;
+	size_t firstStreamedAgent = 0;
+
 	// Write agents
 	int i;
 	for (i = 0; i < agentIC.size(); i++) {
@@ -811,17 +819,457 @@ void TestCaseWriter::writeTestCaseToFile(FILE *fp,
 		}
 		fprintf(fp, "\t</goalSequence>\n");
 		// Write agent locations
+		SteerLib::TrajectorySink::PositionList positionList;
+		if (trajectorySink->isOpen()) {
+			if ((size_t)i >= firstStreamedAgent + streamedPositions.size()) {
+				firstStreamedAgent = i;
+				trajectorySink->readTrajectories(agents, i, streamedPositions);
+			}
+			positionList.swap(streamedPositions[i - firstStreamedAgent]);
+		}
+		else {
+			positionList = agents[i]->getPositionList();
+		}
 		fprintf(fp, "\t<sim_real>\n");
-		for (int j = 0; j < agents[i]->getPositionList().size(); j++) {
+		for (int j = 0; j < positionList.size(); j++) {
 			fprintf(fp, "\t\t<location>\n");
-			fprintf(fp, "\t\t\t<time>%f</time>\n", agents[i]->getPositionList().at(j).first);
-			fprintf(fp, "\t\t\t<x>%f</x>\n", agents[i]->getPositionList().at(j).second.x);
-			fprintf(fp, "\t\t\t<y>%f</y>\n", agents[i]->getPositionList().at(j).second.y);
-			fprintf(fp, "\t\t\t<z>%f</z>\n", agents[i]->getPositionList().at(j).second.z);
+			fprintf(fp, "\t\t\t<time>%f</time>\n", positionList[j].first);
+			fprintf(fp, "\t\t\t<x>%f</x>\n", positionList[j].second.x);
+			fprintf(fp, "\t\t\t<y>%f</y>\n", positionList[j].second.y);
+			fprintf(fp, "\t\t\t<z>%f</z>\n", positionList[j].second.z);
 			fprintf(fp, "\t\t</location>\n");
 		}
 		fprintf(fp, "\t</sim_real>\n");
 		fprintf(fp, "</agent>\n");
 	}
 	fprintf(fp, "</SteerBenchTestCase>\n");
-}
\ No newline at end of file
+}
+
+void TestCaseWriter::writeTestCaseToFile(const std::string & testCaseName,
+	std::vector<SteerLib::AgentInitialConditions> & agents,
+	std::vector<SteerLib::AgentInitialConditions> & agentEmitters,
+	std::vector<SteerLib::ObstacleInitialConditions*> & obstacles,
+	const Util::AxisAlignedBox & worldBounds)
+{
+	std::string testCaseFilename = testCaseName + ".xml" ;
+	FILE * fp = fopen(testCaseFilename.c_str(), "w") ;
+	if( !fp ) {
+		fprintf(stderr, "TestCaseWriter::writeTestCaseToFile: ERROR: Cannot open file %s\n", testCaseFilename.c_str()) ;
+		return ;
+	}
+
+	_testCaseName = testCaseName ;
+	writeTestCaseToFile(fp, agents, agentEmitters, obstacles, worldBounds) ;
+	fclose(fp) ;
+}
+
+void TestCaseWriter::writeTestCaseToFile(FILE *fp,
+	std::vector<SteerLib::AgentInitialConditions> & agents,
+	std::vector<SteerLib::AgentInitialConditions> & agentEmitters,
+	std::vector<SteerLib::ObstacleInitialConditions*> & obstacles,
+	const Util::AxisAlignedBox & worldBounds)
+{
+	/// Write header
+	fprintf(fp, "<!-- \n Copyright (c) 2009-2014 Shawn Singh, Glen Berseth, Mubbasir Kapadia, Petros Faloutsos, Glenn Reinman\n See license.txt for complete license.\n  -->\n") ;
+
+	fprintf(fp, "<SteerBenchTestCase xmlns=\"http://www.magix.ucla.edu/steerbench\"\n"
+                    "\t\txmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\"\n"
+                    "\t\txsi:schemaLocation=\"http://www.magix.ucla.edu/steerbench\n"
+                    "\t\t\t\tTestCaseSchema.xsd\">") ;
+
+	fprintf(fp,"<header>\n\t<version>1.0</version>\n") ;
+	fprintf(fp,"\t<name>%s</name>\n", _testCaseName.c_str()) ;
+
+	/// write the world bounds
+	fprintf(fp,"\t<worldBounds>\n") ;
+	fprintf(fp,"\t\t<xmin>%f</xmin>\n", worldBounds.xmin) ;
+	fprintf(fp,"\t\t<xmax>%f</xmax>\n", worldBounds.xmax) ;
+	fprintf(fp,"\t\t<ymin>%f</ymin>\n", worldBounds.ymin) ;
+	fprintf(fp,"\t\t<ymax>%f</ymax>\n", worldBounds.ymax) ;
+	fprintf(fp,"\t\t<zmin>%f</zmin>\n", worldBounds.zmin) ;
+	fprintf(fp,"\t\t<zmax>%f</zmax>\n", worldBounds.zmax) ;
+	fprintf(fp,"\t</worldBounds>\n") ;
+
+	fprintf(fp,"</header>\n") ;
+
+	/// write the obstacles
+	for( unsigned int i = 0 ; i < obstacles.size() ; i++)
+	{
+		_writeObstacle(fp, obstacles[i]) ;
+	}
+
+	/// write agents and agent emitters
+	_writeAgents(fp, agents, "agent") ;
+	_writeAgents(fp, agentEmitters, "agentEmitter") ;
+
+	fprintf(fp,"</SteerBenchTestCase>\n") ;
+}
+
+void TestCaseWriter::_writeObstacle(FILE *fp, const SteerLib::ObstacleInitialConditions * obstacle)
+{
+	// OrientedWallObstacleInitialConditions derives from OrientedBoxObstacleInitialConditions, so it is checked first.
+	if (const OrientedWallObstacleInitialConditions * wall = dynamic_cast<const OrientedWallObstacleInitialConditions*>(obstacle))
+	{
+		fprintf(fp,"\t<orientedWallObstacle>\n") ;
+		fprintf(fp,"\t\t<position> <x>%f</x> <y>%f</y> <z>%f</z> </position>\n", wall->position.x, wall->position.y, wall->position.z) ;
+		fprintf(fp,"\t\t<size> <x>%f</x> <y>%f</y> <z>%f</z> </size>\n", wall->lengthX, wall->height, wall->lengthZ) ;
+		fprintf(fp,"\t\t<thetaY>%f</thetaY>\n", wall->thetaY) ;
+		fprintf(fp,"\t\t<doorway> <value>%f</value> <doorRadius>%f</doorRadius> </doorway>\n", wall->doorLocation, wall->doorRadius) ;
+		fprintf(fp,"\t</orientedWallObstacle>\n") ;
+	}
+	else if (const OrientedBoxObstacleInitialConditions * orientedBox = dynamic_cast<const OrientedBoxObstacleInitialConditions*>(obstacle))
+	{
+		fprintf(fp,"\t<orientedBoxObstacle>\n") ;
+		fprintf(fp,"\t\t<position> <x>%f</x> <y>%f</y> <z>%f</z> </position>\n", orientedBox->position.x, orientedBox->position.y, orientedBox->position.z) ;
+		fprintf(fp,"\t\t<size> <x>%f</x> <y>%f</y> <z>%f</z> </size>\n", orientedBox->lengthX, orientedBox->height, orientedBox->lengthZ) ;
+		fprintf(fp,"\t\t<thetaY>%f</thetaY>\n", orientedBox->thetaY) ;
+		fprintf(fp,"\t</orientedBoxObstacle>\n") ;
+	}
+	else if (const CircleObstacleInitialConditions * circle = dynamic_cast<const CircleObstacleInitialConditions*>(obstacle))
+	{
+		fprintf(fp,"\t<circleObstacle>\n") ;
+		fprintf(fp,"\t\t<radius>%f</radius>\n", circle->radius) ;
+		fprintf(fp,"\t\t<height>%f</height>\n", circle->height) ;
+		fprintf(fp,"\t\t<position> <x>%f</x> <y>%f</y> <z>%f</z> </position>\n", circle->position.x, circle->position.y, circle->position.z) ;
+		fprintf(fp,"\t</circleObstacle>\n") ;
+	}
+	else if (const PolygonObstacleInitialConditions * polygon = dynamic_cast<const PolygonObstacleInitialConditions*>(obstacle))
+	{
+		fprintf(fp,"\t<polygonObstacle>\n") ;
+		for( unsigned int k = 0 ; k < polygon->_vertices.size() ; k++)
+		{
+			fprintf(fp,"\t\t<vertex>  <x>%f</x> <y>%f</y> <z>%f</z>  </vertex>\n", polygon->_vertices[k].x, polygon->_vertices[k].y, polygon->_vertices[k].z) ;
+		}
+		fprintf(fp,"\t</polygonObstacle>\n") ;
+	}
+	else if (const BoxObstacleInitialConditions * box = dynamic_cast<const BoxObstacleInitialConditions*>(obstacle))
+	{
+		fprintf(fp,"\t<obstacle>\n") ;
+		fprintf(fp,"\t\t<xmin>%f</xmin>\n", box->xmin) ;
+		fprintf(fp,"\t\t<xmax>%f</xmax>\n", box->xmax) ;
+		fprintf(fp,"\t\t<ymin>%f</ymin>\n", box->ymin) ;
+		fprintf(fp,"\t\t<ymax>%f</ymax>\n", box->ymax) ;
+		fprintf(fp,"\t\t<zmin>%f</zmin>\n", box->zmin) ;
+		fprintf(fp,"\t\t<zmax>%f</zmax>\n", box->zmax) ;
+		fprintf(fp,"\t</obstacle>\n") ;
+	}
+	else
+	{
+		fprintf(stderr, "writeTestCaseToFile: WARNING skipping an obstacle of unknown type\n") ;
+	}
+}
+
+void TestCaseWriter::_writeAgents(FILE *fp, std::vector<SteerLib::AgentInitialConditions> & agents, const char * tagName)
+{
+	for( unsigned int i = 0 ; i < agents.size() ; i++)
+	{
+		SteerLib::AgentInitialConditions *ic = &agents[i] ;
+
+		fprintf(fp,"\t<%s>\n", tagName) ;
+		// the reader does not accept empty tags.
+		if ( !ic->name.empty() )
+			fprintf(fp,"\t<name>%s</name>\n", ic->name.c_str()) ;
+		fprintf(fp,"<initialConditions>\n") ;
+		fprintf(fp,"\t\t<radius>%f</radius>\n", ic->radius) ;
+		fprintf(fp,"\t\t<position> <x>%f</x> <y>%f</y> <z>%f</z> </position>\n", 
+			ic->position[0],ic->position[1],ic->position[2]) ;
+		fprintf(fp,"\t\t<direction> <x>%f</x> <y>%f</y> <z>%f</z> </direction>\n", 
+			ic->direction[0],ic->direction[1],ic->direction[2]) ;
+		fprintf(fp,"\t\t<speed>%f</speed>\n", ic->speed) ;
+		fprintf(fp, "\t\t<startTime>%f</startTime>\n", ic->startTime);
+		fprintf(fp,"\t</initialConditions>\n") ;
+		
+		#ifdef _DEBUG
+		std::cout << "agent desired speed " << agents[i].goals[0].desiredSpeed << "\n";
+		#endif
+		/// write goals of each agent
+		fprintf(fp,"\t<goalSequence>\n") ;
+		for( unsigned int g = 0 ; g <  agents[i].goals.size() ; g++)
+		{
+			std::string goalType = "seekStaticTarget" ;
+			switch ( agents[i].goals[g].goalType){
+				case GOAL_TYPE_SEEK_STATIC_TARGET:
+					goalType = "seekStaticTarget" ;
+					break ;
+				case GOAL_TYPE_FLEE_STATIC_TARGET:
+					goalType = "fleeStaticTarget" ;
+					break ;
+				case GOAL_TYPE_SEEK_DYNAMIC_TARGET:
+					goalType = "seekDynamicTarget" ;
+					break ;
+				case GOAL_TYPE_FLEE_DYNAMIC_TARGET:
+					goalType = "fleeDynamicTarget" ;
+					break ;
+				case GOAL_TYPE_FLOW_STATIC_DIRECTION:
+					goalType = "flowStaticDirection" ;
+					break ;
+				case GOAL_TYPE_FLOW_DYNAMIC_DIRECTION:
+					goalType = "flowDynamicDirection" ;
+					break ;
+				case GOAL_TYPE_IDLE:
+					goalType = "idle" ;
+				default: break ;
+			}
+			fprintf(fp,"\t\t<%s>\n", goalType.c_str()) ;
+			fprintf(fp,"\t\t\t<targetLocation> <x>%f</x> <y>%f</y> <z>%f</z> </targetLocation>\n", 
+			agents[i].goals[g].targetLocation[0],agents[i].goals[g].targetLocation[1],agents[i].goals[g].targetLocation[2]) ;
+			fprintf(fp,"\t\t\t<desiredSpeed>%f</desiredSpeed>\n", agents[i].goals[g].desiredSpeed) ;
+			fprintf(fp,"\t\t\t<timeDuration>%f</timeDuration>\n",  agents[i].goals[g].timeDuration) ;
+			
+			//if ( !goal->targetName.empty() )
+			//	fprintf(fp,"\t\t\t<targetName>%s</targetName>\n", goal->targetName.c_str()) ;
+			
+			fprintf(fp,"\t\t\t<targetDirection> <x>%f</x> <y>%f</y> <z>%f</z> </targetDirection>\n", 
+			agents[i].goals[g].targetDirection[0],agents[i].goals[g].targetDirection[1],agents[i].goals[g].targetDirection[2]) ;
+			if ( !agents[i].goals[g].flowType.empty() )
+				fprintf(fp,"\t\t\t<flowType>%s</flowType>\n", agents[i].goals[g].flowType.c_str()) ;
+			std::string isRandom = "false" ;
+			if( agents[i].goals[g].targetIsRandom ) isRandom = "true" ;	
+			fprintf(fp,"\t\t\t<random>%s</random>\n", isRandom.c_str()) ;
+
+			if (agents[i].goals[g].targetBehaviour.getSteeringAlg() != "" )
+			{
+				// std::cout << "Found a Behavior while writing testcase" << std::endl;
+				fprintf(fp,"\t\t\t<Behaviour>\n") ;
+					fprintf(fp,"\t\t\t\t<SteeringAlgorithm>%s</SteeringAlgorithm>\n",
+							agents[i].goals[g].targetBehaviour.getSteeringAlg().c_str()) ;
+
+					if ( agents[i].goals[g].targetBehaviour.getParameters().size() > 0)
+					{
+						fprintf(fp,"\t\t\t\t<Parameters>\n") ;
+						int p;
+						for (p=0; p<agents[i].goals[g].targetBehaviour.getParameters().size(); p++ )
+						{
+							fprintf(fp,"\t\t\t\t\t<parameter>\n") ;
+								fprintf(fp,"\t\t\t\t\t\t<key>%s</key>\n", agents[i].goals[g].targetBehaviour.getParameters().at(p).key.c_str()) ;
+								fprintf(fp,"\t\t\t\t\t\t<value>%s</value>\n", agents[i].goals[g].targetBehaviour.getParameters().at(p).value.c_str()) ;
+							fprintf(fp,"\t\t\t\t\t</parameter>\n") ;
+						}
+						fprintf(fp,"\t\t\t\t</Parameters>\n") ;
+					}
+				fprintf(fp,"\t\t\t</Behaviour>\n") ;
+			}
+
+			fprintf(fp,"\t\t</%s>\n", goalType.c_str()) ;
+		}
+		fprintf(fp,"\t</goalSequence>\n") ;
+
+		fprintf(fp,"</%s>\n", tagName) ;
+	}
+}
+
+/// Collects the nul-terminated strings of a binary test case; identical strings are stored only once.
+class BinaryTestCaseStringTable {
+public:
+	BinaryTestCaseStringTable() { add(""); }
+	unsigned int add(const std::string & s)
+	{
+		std::map<std::string, unsigned int>::iterator iter = _offsets.find(s);
+		if (iter != _offsets.end()) {
+			return iter->second;
+		}
+		unsigned int offset = (unsigned int)_table.size();
+		_table.insert(_table.end(), s.begin(), s.end());
+		_table.push_back('\0');
+		_offsets[s] = offset;
+		return offset;
+	}
+	const std::vector<char> & getTable() const { return _table; }
+private:
+	std::vector<char> _table;
+	std::map<std::string, unsigned int> _offsets;
+};
+
+static inline void _pointToBinary(const Util::Point & p, float * result) { result[0] = p.x; result[1] = p.y; result[2] = p.z; }
+static inline void _vectorToBinary(const Util::Vector & v, float * result) { result[0] = v.x; result[1] = v.y; result[2] = v.z; }
+static inline void _boxToBinary(const Util::AxisAlignedBox & b, float * result) { result[0] = b.xmin; result[1] = b.xmax; result[2] = b.ymin; result[3] = b.ymax; result[4] = b.zmin; result[5] = b.zmax; }
+
+/// Returns offset rounded up to a multiple of 8 bytes, the alignment of every section of a binary test case.
+static inline unsigned int _alignBinarySection(size_t offset) { return (unsigned int)((offset + 7) & ~((size_t)7)); }
+
+/// Writes a section of a binary test case, padded with zeros up to its offset.
+template <typename T>
+static void _writeBinarySection(std::ofstream & out, const std::vector<T> & items, unsigned int offset)
+{
+	while ((unsigned int)out.tellp() < offset) {
+		out.put('\0');
+	}
+	if (!items.empty()) {
+		out.write((const char*)&(items[0]), items.size() * sizeof(T));
+	}
+}
+
+void TestCaseWriter::writeBinaryTestCaseToFile(const std::string & filename, const SteerLib::TestCaseReader & testCase)
+{
+	BinaryTestCaseStringTable strings;
+	std::vector<BinaryTestCaseAgentInfo> agentList;
+	std::vector<BinaryTestCaseGoalInfo> goalList;
+	std::vector<BinaryTestCaseBehaviourParameterInfo> parameterList;
+	std::vector<BinaryTestCaseObstacleInfo> obstacleList;
+	std::vector<float> vertexList;
+	std::vector<BinaryTestCaseCameraInfo> cameraList;
+
+	BinaryTestCaseHeader header;
+	memset(&header, 0, sizeof(BinaryTestCaseHeader));
+	header.magic = BINARY_TEST_CASE_MAGIC_NUMBER;
+	header.version = BINARY_TEST_CASE_VERSION;
+	header.headerSize = sizeof(BinaryTestCaseHeader);
+	header.nameOffset = strings.add(testCase.getTestCaseName());
+	header.descriptionOffset = strings.add(testCase.getDescription());
+	header.versionOffset = strings.add(testCase.getVersion());
+	header.passingCriteriaOffset = strings.add(testCase.getPassingCriteria());
+	_boxToBinary(testCase.getWorldBounds(), header.worldBounds);
+
+	/// agents, followed by agent emitters
+	size_t numAgentsAndEmitters = testCase.getNumAgents() + testCase.getNumAgentEmitters();
+	agentList.resize(numAgentsAndEmitters);
+	for( unsigned int i = 0 ; i < numAgentsAndEmitters ; i++)
+	{
+		const AgentInitialConditions & agent = (i < testCase.getNumAgents()) ? testCase.getAgentInitialConditions(i) : testCase.getAgentEmitterInitialConditions(i - (unsigned int)testCase.getNumAgents());
+		BinaryTestCaseAgentInfo & agentInfo = agentList[i];
+		memset(&agentInfo, 0, sizeof(BinaryTestCaseAgentInfo));
+		_pointToBinary(agent.position, agentInfo.position);
+		_vectorToBinary(agent.direction, agentInfo.direction);
+		agentInfo.radius = agent.radius;
+		agentInfo.speed = agent.speed;
+		agentInfo.startTime = agent.startTime;
+		agentInfo.color[0] = agent.color.r;
+		agentInfo.color[1] = agent.color.g;
+		agentInfo.color[2] = agent.color.b;
+		agentInfo.colorSet = agent.colorSet ? 1 : 0;
+		agentInfo.fromRandom = agent.fromRandom ? 1 : 0;
+		_boxToBinary(agent.randBox, agentInfo.randBox);
+		agentInfo.nameOffset = strings.add(agent.name);
+		agentInfo.firstGoal = (unsigned int)goalList.size();
+		agentInfo.numGoals = (unsigned int)agent.goals.size();
+
+		for( unsigned int g = 0 ; g < agent.goals.size() ; g++)
+		{
+			const AgentGoalInfo & goal = agent.goals[g];
+			BinaryTestCaseGoalInfo goalInfo;
+			memset(&goalInfo, 0, sizeof(BinaryTestCaseGoalInfo));
+			goalInfo.goalType = (unsigned int)goal.goalType;
+			goalInfo.targetIsRandom = goal.targetIsRandom ? 1 : 0;
+			goalInfo.timeDuration = goal.timeDuration;
+			goalInfo.desiredSpeed = goal.desiredSpeed;
+			_pointToBinary(goal.targetLocation, goalInfo.targetLocation);
+			_vectorToBinary(goal.targetDirection, goalInfo.targetDirection);
+			_boxToBinary(goal.targetRegion, goalInfo.targetRegion);
+			goalInfo.targetNameOffset = strings.add(goal.targetName);
+			goalInfo.flowTypeOffset = strings.add(goal.flowType);
+			goalInfo.steeringAlgorithmOffset = strings.add(goal.targetBehaviour.getSteeringAlg());
+
+			std::vector<BehaviourParameter> parameters = goal.targetBehaviour.getParameters();
+			goalInfo.firstBehaviourParameter = (unsigned int)parameterList.size();
+			goalInfo.numBehaviourParameters = (unsigned int)parameters.size();
+			for( unsigned int p = 0 ; p < parameters.size() ; p++)
+			{
+				BinaryTestCaseBehaviourParameterInfo parameterInfo;
+				parameterInfo.keyOffset = strings.add(parameters[p].key);
+				parameterInfo.valueOffset = strings.add(parameters[p].value);
+				parameterList.push_back(parameterInfo);
+			}
+			goalList.push_back(goalInfo);
+		}
+	}
+
+	/// obstacles
+	obstacleList.resize(testCase.getNumObstacles());
+	for( unsigned int i = 0 ; i < testCase.getNumObstacles() ; i++)
+	{
+		const ObstacleInitialConditions * obstacle = testCase.getObstacleInitialConditions(i);
+		BinaryTestCaseObstacleInfo & obstacleInfo = obstacleList[i];
+		memset(&obstacleInfo, 0, sizeof(BinaryTestCaseObstacleInfo));
+
+		// OrientedWallObstacleInitialConditions derives from OrientedBoxObstacleInitialConditions, so it is checked first.
+		if (const OrientedBoxObstacleInitialConditions * orientedBox = dynamic_cast<const OrientedBoxObstacleInitialConditions*>(obstacle))
+		{
+			obstacleInfo.type = BINARY_TEST_CASE_ORIENTED_BOX_OBSTACLE;
+			if (const OrientedWallObstacleInitialConditions * wall = dynamic_cast<const OrientedWallObstacleInitialConditions*>(obstacle))
+			{
+				obstacleInfo.type = BINARY_TEST_CASE_ORIENTED_WALL_OBSTACLE;
+				obstacleInfo.doorLocation = wall->doorLocation;
+				obstacleInfo.doorRadius = wall->doorRadius;
+			}
+			_pointToBinary(orientedBox->position, obstacleInfo.position);
+			obstacleInfo.lengthX = orientedBox->lengthX;
+			obstacleInfo.lengthZ = orientedBox->lengthZ;
+			obstacleInfo.height = orientedBox->height;
+			obstacleInfo.thetaY = orientedBox->thetaY;
+		}
+		else if (const CircleObstacleInitialConditions * circle = dynamic_cast<const CircleObstacleInitialConditions*>(obstacle))
+		{
+			obstacleInfo.type = BINARY_TEST_CASE_CIRCLE_OBSTACLE;
+			_pointToBinary(circle->position, obstacleInfo.position);
+			obstacleInfo.radius = circle->radius;
+			obstacleInfo.height = circle->height;
+		}
+		else if (const PolygonObstacleInitialConditions * polygon = dynamic_cast<const PolygonObstacleInitialConditions*>(obstacle))
+		{
+			obstacleInfo.type = BINARY_TEST_CASE_POLYGON_OBSTACLE;
+			obstacleInfo.firstVertex = (unsigned int)(vertexList.size() / 3);
+			obstacleInfo.numVertices = (unsigned int)polygon->_vertices.size();
+			for( unsigned int v = 0 ; v < polygon->_vertices.size() ; v++)
+			{
+				vertexList.push_back(polygon->_vertices[v].x);
+				vertexList.push_back(polygon->_vertices[v].y);
+				vertexList.push_back(polygon->_vertices[v].z);
+			}
+		}
+		else if (const BoxObstacleInitialConditions * box = dynamic_cast<const BoxObstacleInitialConditions*>(obstacle))
+		{
+			obstacleInfo.type = BINARY_TEST_CASE_BOX_OBSTACLE;
+			_boxToBinary(Util::AxisAlignedBox(box->xmin, box->xmax, box->ymin, box->ymax, box->zmin, box->zmax), obstacleInfo.bounds);
+		}
+		else
+		{
+			throw GenericException("TestCaseWriter::writeBinaryTestCaseToFile: obstacle " + toString(i) + " has a type that binary test cases do not support.");
+		}
+	}
+
+	/// camera views
+	cameraList.resize(testCase.getNumCameraViews());
+	for( unsigned int i = 0 ; i < testCase.getNumCameraViews() ; i++)
+	{
+		const CameraView & view = testCase.getCameraView(i);
+		_pointToBinary(view.position, cameraList[i].position);
+		_pointToBinary(view.lookat, cameraList[i].lookat);
+		_vectorToBinary(view.up, cameraList[i].up);
+		cameraList[i].fovy = view.fovy;
+	}
+
+	/// lay out the sections
+	const std::vector<char> & stringTable = strings.getTable();
+	header.numAgents = (unsigned int)testCase.getNumAgents();
+	header.numAgentEmitters = (unsigned int)testCase.getNumAgentEmitters();
+	header.numGoals = (unsigned int)goalList.size();
+	header.numBehaviourParameters = (unsigned int)parameterList.size();
+	header.numObstacles = (unsigned int)obstacleList.size();
+	header.numVertices = (unsigned int)(vertexList.size() / 3);
+	header.numCameraViews = (unsigned int)cameraList.size();
+	header.agentListOffset = _alignBinarySection(sizeof(BinaryTestCaseHeader));
+	header.goalListOffset = _alignBinarySection(header.agentListOffset + agentList.size() * sizeof(BinaryTestCaseAgentInfo));
+	header.behaviourParameterListOffset = _alignBinarySection(header.goalListOffset + goalList.size() * sizeof(BinaryTestCaseGoalInfo));
+	header.obstacleListOffset = _alignBinarySection(header.behaviourParameterListOffset + parameterList.size() * sizeof(BinaryTestCaseBehaviourParameterInfo));
+	header.vertexListOffset = _alignBinarySection(header.obstacleListOffset + obstacleList.size() * sizeof(BinaryTestCaseObstacleInfo));
+	header.cameraListOffset = _alignBinarySection(header.vertexListOffset + vertexList.size() * sizeof(float));
+	header.stringTableOffset = _alignBinarySection(header.cameraListOffset + cameraList.size() * sizeof(BinaryTestCaseCameraInfo));
+	header.stringTableSize = (unsigned int)stringTable.size();
+
+	std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!out.is_open()) {
+		throw GenericException("TestCaseWriter::writeBinaryTestCaseToFile: could not open file " + filename + " for writing.");
+	}
+	out.write((const char*)&header, sizeof(BinaryTestCaseHeader));
+	_writeBinarySection(out, agentList, header.agentListOffset);
+	_writeBinarySection(out, goalList, header.goalListOffset);
+	_writeBinarySection(out, parameterList, header.behaviourParameterListOffset);
+	_writeBinarySection(out, obstacleList, header.obstacleListOffset);
+	_writeBinarySection(out, vertexList, header.vertexListOffset);
+	_writeBinarySection(out, cameraList, header.cameraListOffset);
+	_writeBinarySection(out, stringTable, header.stringTableOffset);
+	if (!out.good()) {
+		throw GenericException("TestCaseWriter::writeBinaryTestCaseToFile: could not write the binary test case " + filename + ".");
+	}
+	out.close();
+}
@@ -130,7 +130,12 @@ void ThreadedTaskManager::waitForAllTasksToComplete()
 
 void ThreadedTaskManager::_runWorkerThread() throw()
 {
+	// the constructor holds the lock until all threads are created, so acquiring it here guarantees
+	// that _threads is complete before this thread searches it for its own index.
+	_lock();
 	unsigned int threadIndex = _getIndexOfCurrentWorkerThread();
+	_unlock();
+
 	while(true) {
 
 		// acquire the lock
@@ -0,0 +1,269 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+/// @file TraceProfiler.cpp
+/// @brief Implements Util::TraceProfiler.
+
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include "util/TraceProfiler.h"
+#include "util/GenericException.h"
+
+using namespace Util;
+
+
+/// Holds the buffer of the calling thread, and returns it to the profiler when the thread exits; buffers are owned by the profiler.
+class ThreadBufferHolder {
+public:
+	ThreadBufferHolder() : buffer(NULL) { }
+	~ThreadBufferHolder() {
+		if (buffer != NULL) {
+			TraceProfiler::getInstance()->releaseThreadBuffer(buffer);
+		}
+	}
+	TraceProfiler::ThreadBuffer * buffer;
+};
+
+static thread_local ThreadBufferHolder tlsThreadBuffer;
+
+
+TraceProfiler * TraceProfiler::getInstance()
+{
+	static TraceProfiler instance;
+	return &instance;
+}
+
+
+TraceProfiler::TraceProfiler()
+{
+	_enabled = false;
+	_frameNumber = 0;
+	_eventsPerThread = DEFAULT_TRACE_EVENTS_PER_THREAD;
+	_numRecordings = 0;
+}
+
+
+TraceProfiler::~TraceProfiler()
+{
+	for (unsigned int i = 0; i < _threadBuffers.size(); i++) {
+		delete _threadBuffers[i];
+	}
+}
+
+
+const char * TraceProfiler::internName(const std::string & name)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	return _internedNames.insert(name).first->c_str();
+}
+
+
+TraceProfiler::ThreadBuffer * TraceProfiler::getThreadBuffer()
+{
+	if (tlsThreadBuffer.buffer == NULL) {
+		std::lock_guard<std::mutex> lock(_lock);
+
+		// a buffer of a thread that exited, once its spans were discarded.
+		ThreadBuffer * buffer = NULL;
+		for (unsigned int i = 0; (i < _threadBuffers.size()) && (buffer == NULL); i++) {
+			if (_threadBuffers[i]->released && (_threadBuffers[i]->next == 0) && !_threadBuffers[i]->wrapped) {
+				buffer = _threadBuffers[i];
+			}
+		}
+		if (buffer == NULL) {
+			buffer = new ThreadBuffer();
+			buffer->threadIndex = (unsigned int)_threadBuffers.size();
+			_threadBuffers.push_back(buffer);
+		}
+		buffer->events.resize(_eventsPerThread);
+		buffer->next = 0;
+		buffer->wrapped = false;
+		buffer->depth = 0;
+		buffer->released = false;
+		tlsThreadBuffer.buffer = buffer;
+	}
+	return tlsThreadBuffer.buffer;
+}
+
+
+void TraceProfiler::releaseThreadBuffer(ThreadBuffer * buffer)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	buffer->released = true;
+}
+
+
+void TraceProfiler::recordEvent(const char * name, unsigned long long startTick, unsigned long long endTick, unsigned int depth)
+{
+	ThreadBuffer * buffer = getThreadBuffer();
+	TraceEvent & event = buffer->events[buffer->next];
+	event.name = name;
+	event.startTick = startTick;
+	event.endTick = endTick;
+	event.frameNumber = _frameNumber.load(std::memory_order_relaxed);
+	event.depth = depth;
+
+	buffer->next++;
+	if (buffer->next == buffer->events.size()) {
+		buffer->next = 0;
+		buffer->wrapped = true;
+	}
+}
+
+
+void TraceProfiler::clear()
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	_clearThreadBuffers();
+}
+
+
+void TraceProfiler::_clearThreadBuffers()
+{
+	for (unsigned int i = 0; i < _threadBuffers.size(); i++) {
+		_threadBuffers[i]->next = 0;
+		_threadBuffers[i]->wrapped = false;
+	}
+}
+
+
+void TraceProfiler::beginRecording()
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	if (_numRecordings == 0) {
+		// nobody else is recording, so no thread can be writing to the buffers.
+		_clearThreadBuffers();
+		_enabled.store(true);
+	}
+	_numRecordings++;
+}
+
+
+void TraceProfiler::endRecording(const std::string & filename)
+{
+	std::vector<std::string> filenames;
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		if (_numRecordings == 0) {
+			throw GenericException("TraceProfiler::endRecording() was called without beginRecording().");
+		}
+		if (filename != "") {
+			_pendingTraceFiles.push_back(filename);
+		}
+		_numRecordings--;
+		if (_numRecordings > 0) {
+			// other recordings are still running; the trace is written when the last of them ends.
+			return;
+		}
+		_enabled.store(false);
+		filenames.swap(_pendingTraceFiles);
+	}
+	for (unsigned int i = 0; i < filenames.size(); i++) {
+		writeChromeTrace(filenames[i]);
+	}
+}
+
+
+void TraceProfiler::collectSpanTotals(std::map<std::string, TraceSpanTotals> & totals)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	for (unsigned int i = 0; i < _threadBuffers.size(); i++) {
+		ThreadBuffer * buffer = _threadBuffers[i];
+		size_t numEvents = buffer->wrapped ? buffer->events.size() : buffer->next;
+		for (size_t e = 0; e < numEvents; e++) {
+			const TraceEvent & event = buffer->events[e];
+			TraceSpanTotals & total = totals[event.name];
+			unsigned long long ticks = event.endTick - event.startTick;
+			total.numSpans++;
+			total.totalTicks += ticks;
+			if (ticks > total.maxTicks) {
+				total.maxTicks = ticks;
+			}
+		}
+		buffer->next = 0;
+		buffer->wrapped = false;
+	}
+}
+
+
+/// Writes s as a JSON string, escaping the characters that JSON requires.
+static void _writeJSONString(std::ostream & out, const char * s)
+{
+	out << '"';
+	for (; *s != '\0'; s++) {
+		if ((*s == '"') || (*s == '\\')) {
+			out << '\\' << *s;
+		}
+		else if ((unsigned char)(*s) < 0x20) {
+			out << ' ';
+		}
+		else {
+			out << *s;
+		}
+	}
+	out << '"';
+}
+
+
+void TraceProfiler::writeChromeTrace(const std::string & filename)
+{
+	std::ofstream out(filename.c_str());
+	if (!out.is_open()) {
+		throw GenericException("Could not open file \"" + filename + "\" to write a trace.");
+	}
+
+	std::lock_guard<std::mutex> lock(_lock);
+
+	// the trace starts at the earliest recorded span; Chrome expects timestamps in microseconds.
+	unsigned long long firstTick = 0;
+	bool anyEvents = false;
+	for (unsigned int i = 0; i < _threadBuffers.size(); i++) {
+		ThreadBuffer * buffer = _threadBuffers[i];
+		size_t numEvents = buffer->wrapped ? buffer->events.size() : buffer->next;
+		for (size_t e = 0; e < numEvents; e++) {
+			if (!anyEvents || (buffer->events[e].startTick < firstTick)) {
+				firstTick = buffer->events[e].startTick;
+				anyEvents = true;
+			}
+		}
+	}
+	double microsecondsPerTick = 1000000.0 / (double)getHighResCounterFrequency();
+
+	// microseconds with a fixed number of decimals, so that spans late in a long run are not rounded to 6 significant digits.
+	out << std::fixed << std::setprecision(3);
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	bool firstEvent = true;
+	for (unsigned int i = 0; i < _threadBuffers.size(); i++) {
+		ThreadBuffer * buffer = _threadBuffers[i];
+
+		// oldest spans first; spans are recorded when they end, so sort by start time to keep parents before children.
+		std::vector<TraceEvent> events;
+		if (buffer->wrapped) {
+			events.insert(events.end(), buffer->events.begin() + buffer->next, buffer->events.end());
+		}
+		events.insert(events.end(), buffer->events.begin(), buffer->events.begin() + buffer->next);
+		std::stable_sort(events.begin(), events.end(), [](const TraceEvent & a, const TraceEvent & b) {
+			return (a.startTick < b.startTick) || ((a.startTick == b.startTick) && (a.depth < b.depth));
+		});
+
+		if (!firstEvent) out << ",\n";
+		out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->threadIndex << ",\"args\":{\"name\":\"thread " << buffer->threadIndex << "\"}}";
+		firstEvent = false;
+
+		for (size_t e = 0; e < events.size(); e++) {
+			const TraceEvent & event = events[e];
+			out << ",\n{\"name\":";
+			_writeJSONString(out, event.name);
+			out << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->threadIndex;
+			out << ",\"ts\":" << (double)(event.startTick - firstTick) * microsecondsPerTick;
+			out << ",\"dur\":" << (double)(event.endTick - event.startTick) * microsecondsPerTick;
+			out << ",\"args\":{\"frame\":" << event.frameNumber << "}}";
+		}
+	}
+	out << "\n]}\n";
+	out.close();
+}
@@ -0,0 +1,492 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+/// @file TrajectorySink.cpp
+/// @brief Implements the SteerLib::TrajectorySink class.
+
+#include <cstring>
+#include <random>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "simulation/TrajectorySink.h"
+#include "simulation/SimulationCheckpoint.h"
+#include "util/GenericException.h"
+
+using namespace SteerLib;
+using namespace Util;
+
+#define TRAJECTORY_FILE_MAGIC "STEERTRJ"
+#define TRAJECTORY_FILE_VERSION 1
+#define CSV_HEADER "agent,time,x,y,z"
+/// The most positions that readTrajectories() keeps in memory at once, unless a single agent has more.
+#define MAX_POSITIONS_PER_READ (1 << 20)
+/// The number of records read from a binary file at once.
+#define RECORDS_PER_READ 4096
+
+
+TrajectorySink::TrajectorySink()
+{
+	_file = NULL;
+	_csv = false;
+	_maxPendingFrames = 1;
+	_fileId = 0;
+	_numBytesWritten = 0;
+	_totalNumPositions = 0;
+	_writing = false;
+	_stopping = false;
+	_groupedNumPositions = 0;
+	_groupFile = NULL;
+}
+
+
+TrajectorySink::~TrajectorySink()
+{
+	close();
+}
+
+
+void TrajectorySink::open(const std::string & filename, unsigned int maxPendingFrames)
+{
+	close();
+
+	_filename = filename;
+	_csv = (filename.size() >= 4) && (filename.compare(filename.size() - 4, 4, ".csv") == 0);
+	_file = fopen(filename.c_str(), _csv ? "w" : "wb");
+	if (_file == NULL) {
+		throw GenericException("TrajectorySink::open() - cannot create trajectory file \"" + filename + "\".");
+	}
+	if (_csv) {
+		_numBytesWritten = fprintf(_file, "%s\n", CSV_HEADER);
+	}
+	else {
+		unsigned int version = TRAJECTORY_FILE_VERSION;
+		fwrite(TRAJECTORY_FILE_MAGIC, 1, 8, _file);
+		fwrite(&version, sizeof(version), 1, _file);
+		_numBytesWritten = 8 + sizeof(version);
+	}
+
+	// 0 means "no file" in a checkpoint.
+	std::random_device random;
+	do {
+		_fileId = ((unsigned long long)random() << 32) | random();
+	} while (_fileId == 0);
+
+	_maxPendingFrames = (maxPendingFrames > 0) ? maxPendingFrames : 1;
+	_agentIndices.clear();
+	_numPositions.clear();
+	_totalNumPositions = 0;
+	_currentBatch.clear();
+	_pendingBatches.clear();
+	_writing = false;
+	_stopping = false;
+	_writerThread = std::thread(&TrajectorySink::_runWriterThread, this);
+}
+
+
+void TrajectorySink::close()
+{
+	_clearGroups();
+	if (_file == NULL) {
+		return;
+	}
+	endFrame();
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_batchReady.notify_one();
+	_writerThread.join();
+
+	fclose(_file);
+	_file = NULL;
+	_freeBatches.clear();
+}
+
+
+void TrajectorySink::addPosition(const AgentInterface * agent, float time, const Point & position)
+{
+	std::map<const AgentInterface*, unsigned int>::iterator index = _agentIndices.find(agent);
+	if (index == _agentIndices.end()) {
+		index = _agentIndices.insert(std::make_pair(agent, (unsigned int)_numPositions.size())).first;
+		_numPositions.push_back(0);
+	}
+	_numPositions[index->second]++;
+	_totalNumPositions++;
+
+	Record record;
+	record.agent = index->second;
+	record.time = time;
+	record.x = position.x;
+	record.y = position.y;
+	record.z = position.z;
+	_currentBatch.push_back(record);
+}
+
+
+void TrajectorySink::endFrame()
+{
+	if ((_file == NULL) || _currentBatch.empty()) {
+		return;
+	}
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		while (_pendingBatches.size() >= _maxPendingFrames) {
+			_batchWritten.wait(lock);
+		}
+		_pendingBatches.push_back(std::vector<Record>());
+		_pendingBatches.back().swap(_currentBatch);
+		if (!_freeBatches.empty()) {
+			_currentBatch.swap(_freeBatches.back());
+			_freeBatches.pop_back();
+		}
+	}
+	_currentBatch.clear();
+	_batchReady.notify_one();
+}
+
+
+void TrajectorySink::flush()
+{
+	if (_file == NULL) {
+		return;
+	}
+	endFrame();
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (!_pendingBatches.empty() || _writing) {
+		_batchWritten.wait(lock);
+	}
+	// the writer is idle, so the file can be flushed from this thread.
+	fflush(_file);
+}
+
+
+void TrajectorySink::_runWriterThread()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		while (_pendingBatches.empty() && !_stopping) {
+			_batchReady.wait(lock);
+		}
+		if (_pendingBatches.empty()) {
+			break;
+		}
+		std::vector<Record> batch;
+		batch.swap(_pendingBatches.front());
+		_pendingBatches.pop_front();
+		_writing = true;
+
+		lock.unlock();
+		_writeBatch(batch);
+		lock.lock();
+
+		_writing = false;
+		if (_freeBatches.size() < _maxPendingFrames) {
+			_freeBatches.push_back(std::vector<Record>());
+			_freeBatches.back().swap(batch);
+		}
+		_batchWritten.notify_all();
+	}
+}
+
+
+void TrajectorySink::_writeBatch(const std::vector<Record> & batch)
+{
+	if (_csv) {
+		// 9 significant digits are enough to read every float back exactly.
+		for (size_t i = 0; i < batch.size(); i++) {
+			const Record & r = batch[i];
+			_numBytesWritten += fprintf(_file, "%u,%.9g,%.9g,%.9g,%.9g\n", r.agent, r.time, r.x, r.y, r.z);
+		}
+	}
+	else {
+		fwrite(&batch[0], sizeof(Record), batch.size(), _file);
+		_numBytesWritten += sizeof(Record) * batch.size();
+	}
+}
+
+
+size_t TrajectorySink::getNumPositions(const AgentInterface * agent) const
+{
+	int index = _getAgentIndex(agent);
+	return (index < 0) ? 0 : _numPositions[index];
+}
+
+
+int TrajectorySink::_getAgentIndex(const AgentInterface * agent) const
+{
+	std::map<const AgentInterface*, unsigned int>::const_iterator index = _agentIndices.find(agent);
+	return (index == _agentIndices.end()) ? -1 : (int)index->second;
+}
+
+
+void TrajectorySink::readTrajectories(const std::vector<AgentInterface*> & agents, size_t firstAgent, std::vector<PositionList> & trajectories)
+{
+	trajectories.clear();
+	if (firstAgent >= agents.size()) {
+		return;
+	}
+
+	// the groups are made again if the agents or the file changed, or if firstAgent does not start a group.
+	std::vector<size_t>::iterator firstAgentOfGroup = std::lower_bound(_groupFirstAgents.begin(), _groupFirstAgents.end(), firstAgent);
+	if ((_groupedNumPositions != _totalNumPositions) || (agents != _groupedAgents) ||
+		(firstAgentOfGroup == _groupFirstAgents.end()) || (*firstAgentOfGroup != firstAgent) || (firstAgentOfGroup + 1 == _groupFirstAgents.end())) {
+		_groupAgents(agents, firstAgent);
+		firstAgentOfGroup = _groupFirstAgents.begin();
+	}
+	size_t group = firstAgentOfGroup - _groupFirstAgents.begin();
+	size_t lastAgent = _groupFirstAgents[group + 1];
+
+	trajectories.resize(lastAgent - firstAgent);
+	std::vector<int> trajectoryOfIndex(_numPositions.size(), -1);
+	for (size_t i = firstAgent; i < lastAgent; i++) {
+		int index = _getAgentIndex(agents[i]);
+		if (index >= 0) {
+			trajectoryOfIndex[index] = (int)(i - firstAgent);
+			trajectories[i - firstAgent].reserve(_numPositions[index]);
+		}
+	}
+	unsigned long long numRecords = _groupFirstRecords[group + 1] - _groupFirstRecords[group];
+	if (numRecords == 0) {
+		return;
+	}
+
+	std::vector<Record> records(RECORDS_PER_READ);
+	size_t numRead;
+	if (_groupFile == NULL) {
+		// all agents fit in one group, so it is read straight from the file.
+		flush();
+		FILE * fp = _openForReading();
+		while ((numRead = _readRecords(fp, records)) > 0) {
+			for (size_t i = 0; i < numRead; i++) {
+				const Record & r = records[i];
+				if ((r.agent < trajectoryOfIndex.size()) && (trajectoryOfIndex[r.agent] >= 0)) {
+					trajectories[trajectoryOfIndex[r.agent]].push_back(std::make_pair(r.time, Point(r.x, r.y, r.z)));
+				}
+			}
+		}
+		fclose(fp);
+		return;
+	}
+
+	// the records of the group are next to each other in the sorted file.
+	fseek(_groupFile, (long)(_groupFirstRecords[group] * sizeof(Record)), SEEK_SET);
+	while ((numRecords > 0) && ((numRead = fread(&records[0], sizeof(Record), (size_t)std::min<unsigned long long>(numRecords, records.size()), _groupFile)) > 0)) {
+		for (size_t i = 0; i < numRead; i++) {
+			const Record & r = records[i];
+			trajectories[trajectoryOfIndex[r.agent]].push_back(std::make_pair(r.time, Point(r.x, r.y, r.z)));
+		}
+		numRecords -= numRead;
+	}
+	if (numRecords > 0) {
+		throw GenericException("TrajectorySink::readTrajectories() - cannot read the trajectories sorted from \"" + _filename + "\".");
+	}
+}
+
+
+void TrajectorySink::_groupAgents(const std::vector<AgentInterface*> & agents, size_t firstAgent)
+{
+	_clearGroups();
+	_groupedAgents = agents;
+	_groupedNumPositions = _totalNumPositions;
+
+	// pick the agents that fit in the budget, group after group.
+	std::vector<int> groupOfIndex(_numPositions.size(), -1);
+	unsigned long long numRecords = 0;
+	size_t agent = firstAgent;
+	while (agent < agents.size()) {
+		int group = (int)_groupFirstAgents.size();
+		_groupFirstAgents.push_back(agent);
+		_groupFirstRecords.push_back(numRecords);
+		size_t numPositions = 0;
+		while ((agent < agents.size()) && ((agent == _groupFirstAgents.back()) || (numPositions + getNumPositions(agents[agent]) <= MAX_POSITIONS_PER_READ))) {
+			int index = _getAgentIndex(agents[agent]);
+			if (index >= 0) {
+				groupOfIndex[index] = group;
+				numPositions += _numPositions[index];
+			}
+			agent++;
+		}
+		numRecords += numPositions;
+	}
+	_groupFirstAgents.push_back(agents.size());
+	_groupFirstRecords.push_back(numRecords);
+
+	size_t numGroups = _groupFirstAgents.size() - 1;
+	if (numGroups <= 1) {
+		return;
+	}
+
+	_groupFile = tmpfile();
+	if (_groupFile == NULL) {
+		throw GenericException("TrajectorySink::readTrajectories() - cannot create a temporary file to sort \"" + _filename + "\".");
+	}
+
+	// copy each record, in the order of the file, to the part of its group; each group is buffered to write it in large blocks.
+	flush();
+	FILE * fp = _openForReading();
+	std::vector<Record> records(RECORDS_PER_READ);
+	std::vector< std::vector<Record> > buffers(numGroups);
+	std::vector<unsigned long long> nextRecords(_groupFirstRecords.begin(), _groupFirstRecords.end() - 1);
+	bool atEnd = false;
+	while (!atEnd) {
+		size_t numRead = _readRecords(fp, records);
+		atEnd = (numRead == 0);
+		for (size_t i = 0; i < numRead; i++) {
+			const Record & r = records[i];
+			if ((r.agent < groupOfIndex.size()) && (groupOfIndex[r.agent] >= 0)) {
+				buffers[groupOfIndex[r.agent]].push_back(r);
+			}
+		}
+		for (size_t group = 0; group < numGroups; group++) {
+			std::vector<Record> & buffer = buffers[group];
+			if (!buffer.empty() && (atEnd || (buffer.size() >= RECORDS_PER_READ))) {
+				fseek(_groupFile, (long)(nextRecords[group] * sizeof(Record)), SEEK_SET);
+				fwrite(&buffer[0], sizeof(Record), buffer.size(), _groupFile);
+				nextRecords[group] += buffer.size();
+				buffer.clear();
+			}
+		}
+	}
+	fclose(fp);
+}
+
+
+void TrajectorySink::_clearGroups()
+{
+	if (_groupFile != NULL) {
+		fclose(_groupFile);
+		_groupFile = NULL;
+	}
+	_groupedAgents.clear();
+	_groupedNumPositions = 0;
+	_groupFirstAgents.clear();
+	_groupFirstRecords.clear();
+}
+
+
+FILE * TrajectorySink::_openForReading() const
+{
+	FILE * fp = fopen(_filename.c_str(), _csv ? "r" : "rb");
+	if (fp == NULL) {
+		throw GenericException("TrajectorySink::_openForReading() - cannot open trajectory file \"" + _filename + "\".");
+	}
+
+	if (_csv) {
+		char header[64];
+		if (fgets(header, sizeof(header), fp) == NULL) {
+			fclose(fp);
+			throw GenericException("TrajectorySink::_openForReading() - trajectory file \"" + _filename + "\" is empty.");
+		}
+	}
+	else {
+		char magic[8];
+		unsigned int version = 0;
+		if ((fread(magic, 1, 8, fp) != 8) || (memcmp(magic, TRAJECTORY_FILE_MAGIC, 8) != 0) ||
+			(fread(&version, sizeof(version), 1, fp) != 1) || (version != TRAJECTORY_FILE_VERSION)) {
+			fclose(fp);
+			throw GenericException("TrajectorySink::_openForReading() - \"" + _filename + "\" is not a trajectory file.");
+		}
+	}
+	return fp;
+}
+
+
+size_t TrajectorySink::_readRecords(FILE * fp, std::vector<Record> & records) const
+{
+	if (!_csv) {
+		return fread(&records[0], sizeof(Record), records.size(), fp);
+	}
+	size_t numRead = 0;
+	while (numRead < records.size()) {
+		Record & r = records[numRead];
+		if (fscanf(fp, "%u,%f,%f,%f,%f", &r.agent, &r.time, &r.x, &r.y, &r.z) != 5) {
+			break;
+		}
+		numRead++;
+	}
+	return numRead;
+}
+
+
+void TrajectorySink::saveState(CheckpointWriter & out)
+{
+	if (_file == NULL) {
+		out.write<unsigned long long>(0);
+		return;
+	}
+	flush();
+	out.write(_fileId);
+	out.write(_numBytesWritten);
+	out.write(_totalNumPositions);
+	out.write<unsigned int>((unsigned int)_numPositions.size());
+}
+
+
+void TrajectorySink::restoreState(CheckpointReader & in)
+{
+	unsigned long long fileId = in.read<unsigned long long>();
+	if (fileId == 0) {
+		return;
+	}
+	unsigned long long numBytes = in.read<unsigned long long>();
+	unsigned long long numPositions = in.read<unsigned long long>();
+	unsigned int numAgentIndices = in.read<unsigned int>();
+	if ((_file != NULL) && (fileId == _fileId)) {
+		_truncate(numBytes, numPositions, numAgentIndices);
+	}
+}
+
+
+void TrajectorySink::_truncate(unsigned long long numBytes, unsigned long long numPositions, unsigned int numAgentIndices)
+{
+	flush();
+	_clearGroups();
+
+	// forget the positions that are cut off.
+	FILE * fp = _openForReading();
+	fseek(fp, (long)numBytes, SEEK_SET);
+	std::vector<Record> records(RECORDS_PER_READ);
+	size_t numRead;
+	while ((numRead = _readRecords(fp, records)) > 0) {
+		for (size_t i = 0; i < numRead; i++) {
+			if (records[i].agent < _numPositions.size()) {
+				_numPositions[records[i].agent]--;
+			}
+		}
+	}
+	fclose(fp);
+
+	// the writer is idle, so the file can be truncated from this thread.
+#ifdef _WIN32
+	int failed = _chsize_s(_fileno(_file), (__int64)numBytes);
+#else
+	int failed = ftruncate(fileno(_file), (off_t)numBytes);
+#endif
+	if (failed != 0) {
+		throw GenericException("TrajectorySink::restoreState() - cannot truncate trajectory file \"" + _filename + "\".");
+	}
+	fseek(_file, (long)numBytes, SEEK_SET);
+	_numBytesWritten = numBytes;
+	_totalNumPositions = numPositions;
+
+	// agents that recorded their first position after the checkpoint get a new index when they record again.
+	std::map<const AgentInterface*, unsigned int>::iterator index = _agentIndices.begin();
+	while (index != _agentIndices.end()) {
+		if (index->second >= numAgentIndices) {
+			_agentIndices.erase(index++);
+		}
+		else {
+			++index;
+		}
+	}
+	_numPositions.resize(numAgentIndices);
+}
@@ -0,0 +1,318 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+/// @file VisibilityCache.cpp
+/// @brief Implements the SteerLib::VisibilityCache class.
+
+#include <cmath>
+#include <algorithm>
+#include "simulation/VisibilityCache.h"
+#include "interfaces/ObstacleInterface.h"
+#include "interfaces/SpatialDataBaseInterface.h"
+#include "obstacles/BoxObstacle.h"
+#include "obstacles/OrientedBoxObstacle.h"
+#include "obstacles/CircleObstacle.h"
+
+using namespace SteerLib;
+using namespace Util;
+
+
+VisibilityCache::VisibilityCache()
+{
+	_spatialDatabase = NULL;
+	_obstacles = NULL;
+	_originX = _originZ = 0.0f;
+	_cellSizeX = _cellSizeZ = 1.0f;
+	_numCellsX = _numCellsZ = 0;
+	_maxNumTargets = DEFAULT_MAX_VISIBILITY_CACHE_TARGETS;
+	clear();
+}
+
+
+void VisibilityCache::init(SpatialDataBaseInterface * spatialDatabase, const std::set<ObstacleInterface*> * obstacles)
+{
+	_spatialDatabase = spatialDatabase;
+	_obstacles = obstacles;
+	if (_spatialDatabase != NULL) {
+		_originX = _spatialDatabase->getOriginX();
+		_originZ = _spatialDatabase->getOriginZ();
+		_cellSizeX = _spatialDatabase->getCellSizeX();
+		_cellSizeZ = _spatialDatabase->getCellSizeZ();
+		_numCellsX = _spatialDatabase->getNumCellsX();
+		_numCellsZ = _spatialDatabase->getNumCellsZ();
+	}
+	clear();
+}
+
+
+void VisibilityCache::clear()
+{
+	_targets.clear();
+	_numQueries = 0;
+	_numVisibleQueries = 0;
+	_numOccludedQueries = 0;
+	_numClassifiedCells = 0;
+	_numEvictedTargets = 0;
+}
+
+
+void VisibilityCache::setMaxNumTargets(unsigned int maxNumTargets)
+{
+	_maxNumTargets = maxNumTargets;
+	std::vector<unsigned char> unusedCells;
+	while (_targets.size() > _maxNumTargets) {
+		_evictLeastRecentlyQueriedTarget(unusedCells);
+	}
+}
+
+
+void VisibilityCache::invalidate()
+{
+	for (std::map<TargetKey, Target>::iterator target = _targets.begin(); target != _targets.end(); ++target) {
+		std::vector<unsigned int> & classified = target->second.classifiedCells;
+		for (size_t i = 0; i < classified.size(); i++) {
+			target->second.cells[classified[i]] = CELL_UNCLASSIFIED;
+		}
+		classified.clear();
+	}
+}
+
+
+void VisibilityCache::obstacleAdded(ObstacleInterface * obstacle)
+{
+	// a new obstacle cannot reveal the target to occluded cells.
+	_resetCells(obstacle, CELL_OCCLUDED);
+}
+
+
+void VisibilityCache::obstacleRemoved(ObstacleInterface * obstacle)
+{
+	// removing an obstacle cannot hide the target from visible cells.
+	_resetCells(obstacle, CELL_VISIBLE);
+}
+
+
+void VisibilityCache::_resetCells(ObstacleInterface * obstacle, unsigned char keptState)
+{
+	const AxisAlignedBox & bounds = obstacle->getBounds();
+	for (std::map<TargetKey, Target>::iterator target = _targets.begin(); target != _targets.end(); ++target) {
+		Point targetLocation(target->first.first, 0.0f, target->first.second);
+		std::vector<unsigned char> & cells = target->second.cells;
+		std::vector<unsigned int> & classified = target->second.classifiedCells;
+		// unclassified cells need no update, so only the classified ones are visited; the list is compacted in place.
+		size_t numStillClassified = 0;
+		for (size_t i = 0; i < classified.size(); i++) {
+			unsigned int index = classified[i];
+			if ((cells[index] != keptState) && _hullOverlapsBox(index / _numCellsZ, index % _numCellsZ, targetLocation, bounds)) {
+				cells[index] = CELL_UNCLASSIFIED;
+			}
+			else {
+				classified[numStillClassified++] = index;
+			}
+		}
+		classified.resize(numStillClassified);
+	}
+}
+
+
+std::map<VisibilityCache::TargetKey, VisibilityCache::Target>::iterator VisibilityCache::_addTarget(const TargetKey & key)
+{
+	std::vector<unsigned char> cells;
+	if (_targets.size() >= _maxNumTargets) {
+		_evictLeastRecentlyQueriedTarget(cells);
+	}
+	if (cells.empty()) {
+		cells.assign(_numCellsX * _numCellsZ, (unsigned char)CELL_UNCLASSIFIED);
+	}
+
+	std::map<TargetKey, Target>::iterator target = _targets.insert(std::make_pair(key, Target())).first;
+	target->second.cells.swap(cells);
+	target->second.lastQuery = _numQueries;
+	return target;
+}
+
+
+void VisibilityCache::_evictLeastRecentlyQueriedTarget(std::vector<unsigned char> & cells)
+{
+	// there are only a few targets, so a linear search is cheaper than keeping them sorted by query.
+	std::map<TargetKey, Target>::iterator oldest = _targets.begin();
+	for (std::map<TargetKey, Target>::iterator target = _targets.begin(); target != _targets.end(); ++target) {
+		if (target->second.lastQuery < oldest->second.lastQuery) {
+			oldest = target;
+		}
+	}
+
+	// unclassify only the cells that were classified, instead of filling a new array.
+	cells.swap(oldest->second.cells);
+	const std::vector<unsigned int> & classified = oldest->second.classifiedCells;
+	for (size_t i = 0; i < classified.size(); i++) {
+		cells[classified[i]] = CELL_UNCLASSIFIED;
+	}
+	_targets.erase(oldest);
+	_numEvictedTargets++;
+}
+
+
+VisibilityCache::Visibility VisibilityCache::getVisibility(const Point & position, float radius, const Point & target)
+{
+	if ((_spatialDatabase == NULL) || (_obstacles == NULL) || (_numCellsX == 0) || (_numCellsZ == 0) || (_maxNumTargets == 0)) {
+		return VISIBILITY_UNKNOWN;
+	}
+	_numQueries++;
+
+	// the cells that cover every point within radius of position; positions near the edge of the grid are not cached.
+	float fxmin = floorf((position.x - radius - _originX) / _cellSizeX);
+	float fxmax = floorf((position.x + radius - _originX) / _cellSizeX);
+	float fzmin = floorf((position.z - radius - _originZ) / _cellSizeZ);
+	float fzmax = floorf((position.z + radius - _originZ) / _cellSizeZ);
+	if ((fxmin < 0.0f) || (fzmin < 0.0f) || (fxmax >= (float)_numCellsX) || (fzmax >= (float)_numCellsZ)) {
+		return VISIBILITY_UNKNOWN;
+	}
+
+	TargetKey key(target.x, target.z);
+	std::map<TargetKey, Target>::iterator found = _targets.find(key);
+	if (found == _targets.end()) {
+		found = _addTarget(key);
+	}
+	Target & cachedTarget = found->second;
+	cachedTarget.lastQuery = _numQueries;
+
+	// all the cells must agree.
+	unsigned char state = _getCellState(cachedTarget, (unsigned int)fxmin, (unsigned int)fzmin, target);
+	if (state == CELL_PARTIALLY_VISIBLE) {
+		return VISIBILITY_UNKNOWN;
+	}
+	for (unsigned int ix = (unsigned int)fxmin; ix <= (unsigned int)fxmax; ix++) {
+		for (unsigned int iz = (unsigned int)fzmin; iz <= (unsigned int)fzmax; iz++) {
+			if (_getCellState(cachedTarget, ix, iz, target) != state) {
+				return VISIBILITY_UNKNOWN;
+			}
+		}
+	}
+
+	if (state == CELL_VISIBLE) {
+		_numVisibleQueries++;
+		return VISIBILITY_VISIBLE;
+	}
+	_numOccludedQueries++;
+	return VISIBILITY_OCCLUDED;
+}
+
+
+unsigned char VisibilityCache::_getCellState(Target & cachedTarget, unsigned int ix, unsigned int iz, const Point & target)
+{
+	unsigned int index = ix * _numCellsZ + iz;
+	unsigned char & cell = cachedTarget.cells[index];
+	if (cell != CELL_UNCLASSIFIED) {
+		return cell;
+	}
+	cachedTarget.classifiedCells.push_back(index);
+
+	// the bounds of the hull, to skip obstacles quickly.
+	float xmin = std::min(_originX + ix * _cellSizeX, target.x);
+	float xmax = std::max(_originX + (ix+1) * _cellSizeX, target.x);
+	float zmin = std::min(_originZ + iz * _cellSizeZ, target.z);
+	float zmax = std::max(_originZ + (iz+1) * _cellSizeZ, target.z);
+
+	cell = CELL_VISIBLE;
+	for (std::set<ObstacleInterface*>::const_iterator obstacle = _obstacles->begin(); obstacle != _obstacles->end(); ++obstacle) {
+		const AxisAlignedBox & b = (*obstacle)->getBounds();
+		if ((b.xmax + 0.01f < xmin) || (b.xmin - 0.01f > xmax) || (b.zmax + 0.01f < zmin) || (b.zmin - 0.01f > zmax)) {
+			continue;
+		}
+		if (_hullOverlapsBox(ix, iz, target, b)) {
+			if (_canOcclude(*obstacle) && _obstacleOccludesCell(*obstacle, ix, iz, target)) {
+				cell = CELL_OCCLUDED;
+				break;
+			}
+			cell = CELL_PARTIALLY_VISIBLE;
+		}
+	}
+	_numClassifiedCells++;
+	return cell;
+}
+
+
+bool VisibilityCache::_hullOverlapsBox(unsigned int ix, unsigned int iz, const Point & target, const AxisAlignedBox & box) const
+{
+	// separating axis test between two convex polygons: the hull of the cell corners and the target, and the box.  The candidate
+	// axes are x, z, and the normals of the lines from the target to each cell corner, which include the two edges of the hull
+	// that are not edges of the cell.  The box is grown a little, so that rays that graze it count as blocked.
+	const float margin = 0.001f;
+	float bxmin = box.xmin - margin, bxmax = box.xmax + margin;
+	float bzmin = box.zmin - margin, bzmax = box.zmax + margin;
+	float cellX[4], cellZ[4];
+	cellX[0] = cellX[1] = _originX + ix * _cellSizeX;
+	cellX[2] = cellX[3] = _originX + (ix+1) * _cellSizeX;
+	cellZ[0] = cellZ[2] = _originZ + iz * _cellSizeZ;
+	cellZ[1] = cellZ[3] = _originZ + (iz+1) * _cellSizeZ;
+
+	if ((bxmax < std::min(cellX[0], target.x)) || (bxmin > std::max(cellX[2], target.x))) return false;
+	if ((bzmax < std::min(cellZ[0], target.z)) || (bzmin > std::max(cellZ[1], target.z))) return false;
+
+	float boxX[4] = { bxmin, bxmin, bxmax, bxmax };
+	float boxZ[4] = { bzmin, bzmax, bzmin, bzmax };
+	for (unsigned int axis = 0; axis < 4; axis++) {
+		// the normal of the line from the target to this corner.
+		float nx = -(cellZ[axis] - target.z);
+		float nz = cellX[axis] - target.x;
+		if ((nx == 0.0f) && (nz == 0.0f)) continue;
+
+		float hullMin = nx * target.x + nz * target.z, hullMax = hullMin;
+		for (unsigned int i = 0; i < 4; i++) {
+			float d = nx * cellX[i] + nz * cellZ[i];
+			hullMin = std::min(hullMin, d);
+			hullMax = std::max(hullMax, d);
+		}
+		float boxMin = nx * boxX[0] + nz * boxZ[0], boxMax = boxMin;
+		for (unsigned int i = 1; i < 4; i++) {
+			float d = nx * boxX[i] + nz * boxZ[i];
+			boxMin = std::min(boxMin, d);
+			boxMax = std::max(boxMax, d);
+		}
+		if ((boxMax < hullMin) || (boxMin > hullMax)) return false;
+	}
+	return true;
+}
+
+
+bool VisibilityCache::_canOcclude(ObstacleInterface * obstacle) const
+{
+	// agents trace through the spatial database, which only finds obstacles inside the grid.
+	const AxisAlignedBox & b = obstacle->getBounds();
+	if ((b.xmin < _originX) || (b.xmax > _originX + _numCellsX * _cellSizeX) || (b.zmin < _originZ) || (b.zmax > _originZ + _numCellsZ * _cellSizeZ)) {
+		return false;
+	}
+	return (dynamic_cast<BoxObstacle*>(obstacle) != NULL) || (dynamic_cast<OrientedBoxObstacle*>(obstacle) != NULL) || (dynamic_cast<CircleObstacle*>(obstacle) != NULL);
+}
+
+
+bool VisibilityCache::_obstacleOccludesCell(ObstacleInterface * obstacle, unsigned int ix, unsigned int iz, const Point & target) const
+{
+	// a segment from a point of the cell to the target leaves the cell through some edge, inside the triangle of that edge and
+	// the target.  If the obstacle is convex and cuts both sides of the triangle that end at the target, it contains the chord
+	// between the two cuts, which separates the edge from the target, so the segment goes through the obstacle.  The corners are
+	// moved out a little so that segments from the cell cross the chord at an inner point.
+	const float margin = 0.01f;
+	float x0 = _originX + ix * _cellSizeX - margin, x1 = _originX + (ix+1) * _cellSizeX + margin;
+	float z0 = _originZ + iz * _cellSizeZ - margin, z1 = _originZ + (iz+1) * _cellSizeZ + margin;
+
+	// segments that start inside the obstacle are left to tracing.
+	const AxisAlignedBox & b = obstacle->getBounds();
+	if ((b.xmax >= x0) && (b.xmin <= x1) && (b.zmax >= z0) && (b.zmin <= z1)) {
+		return false;
+	}
+	Point corners[4] = { Point(x0, 0.0f, z0), Point(x0, 0.0f, z1), Point(x1, 0.0f, z0), Point(x1, 0.0f, z1) };
+	for (unsigned int i = 0; i < 4; i++) {
+		Ray r;
+		r.initWithUnitInterval(corners[i], target - corners[i]);
+		float t;
+		if (!obstacle->intersects(r, t)) {
+			return false;
+		}
+	}
+	return true;
+}
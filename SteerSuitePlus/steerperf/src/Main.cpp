@@ -0,0 +1,488 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+/// @file steerperf/src/Main.cpp
+/// @brief Entry point of SteerPerf, the headless performance suite.
+///
+/// %SteerPerf simulates every combination of a list of test cases, AI modules, and spatial databases
+/// without a GUI, and writes one JSON file with the cost of each run:
+///  - wall time of each simulation phase (setup, initialize, preprocess, simulate, postprocess, cleanup),
+///  - per-frame wall time (mean, median, 95th percentile, max),
+///  - total and max time of every span recorded by the Util::TraceProfiler (engine phases, modules, agent phases),
+///  - number and bytes of heap allocations during the simulation, and the peak resident set size.
+///
+/// Every run uses the same random seeds and the same number of frames, so the JSON files of two commits
+/// can be compared run by run.  On POSIX systems each run happens in its own child process, so that the
+/// peak memory and allocations of one run do not include the previous runs, and a crash only fails that run.
+///
+/// Example:
+///   steerperf -moduleSearchPath ../lib -testCasePath ../testcases -numFrames 300 -o perf.json
+///   steerperf -testcases forest,office-complex -ais sfAI,rvo2AI
+
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "SteerLib.h"
+#include "core/SteerSim.h"
+#include "core/CommandLineEngineDriver.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#endif
+
+using namespace std;
+using namespace Util;
+using namespace SteerLib;
+
+#define STEERPERF_FORMAT_VERSION 1
+#define DEFAULT_PERF_TEST_CASES "concentric-circles_500,bottleneck-evacuation,forest,office-complex"
+#define DEFAULT_PERF_AI_MODULES "simpleAI,sfAI,rvo2AI,pprAI"
+#define DEFAULT_PERF_SPATIAL_DATABASES "gridDatabase"
+#define DEFAULT_PERF_NUM_FRAMES 300
+#define DEFAULT_PERF_SEED 2
+
+
+//
+// Heap allocation counters; replacing the global operator new also counts the allocations of the dynamically loaded modules.
+//
+static std::atomic<unsigned long long> gNumAllocations(0);
+static std::atomic<unsigned long long> gNumAllocatedBytes(0);
+
+void * operator new(size_t size)
+{
+	gNumAllocations.fetch_add(1, std::memory_order_relaxed);
+	gNumAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	void * p = malloc((size > 0) ? size : 1);
+	if (p == NULL) throw std::bad_alloc();
+	return p;
+}
+
+void * operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void * p) throw()
+{
+	free(p);
+}
+
+void operator delete[](void * p) throw()
+{
+	free(p);
+}
+
+void operator delete(void * p, size_t) throw()
+{
+	free(p);
+}
+
+void operator delete[](void * p, size_t) throw()
+{
+	free(p);
+}
+
+
+/// Returns the peak resident set size of this process so far, in kilobytes.
+static unsigned long long getPeakResidentSetKilobytes()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return counters.PeakWorkingSetSize / 1024;
+	}
+	return 0;
+#else
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+#endif
+}
+
+
+/// Options shared by all runs of the performance suite.
+struct PerfSuiteOptions {
+	std::string moduleSearchPath;
+	std::string testCaseSearchPath;
+	unsigned int numFrames;
+	unsigned int seed;
+	bool forkEachRun;
+};
+
+
+/// A command-line engine driver that gives access to its engine, so that SteerPerf can time each phase and frame itself.
+class PerfEngineDriver : public CommandLineEngineDriver
+{
+public:
+	SteerLib::SimulationEngine * getEngine() { return _engine; }
+};
+
+
+/// Writes s as a JSON string.
+static void writeJSONString(std::ostream & out, const std::string & s)
+{
+	out << '"';
+	for (unsigned int i = 0; i < s.size(); i++) {
+		if ((s[i] == '"') || (s[i] == '\\')) {
+			out << '\\' << s[i];
+		}
+		else if (s[i] == '\n') {
+			out << "\\n";
+		}
+		else if ((unsigned char)s[i] >= 0x20) {
+			out << s[i];
+		}
+	}
+	out << '"';
+}
+
+
+/// Splits a comma-separated list into its non-empty items.
+static std::vector<std::string> splitList(const std::string & list)
+{
+	std::vector<std::string> items;
+	std::stringstream stream(list);
+	std::string item;
+	while (std::getline(stream, item, ',')) {
+		if (item != "") items.push_back(item);
+	}
+	return items;
+}
+
+
+/// Simulates one test case with one AI module and spatial database, and returns the JSON object that describes its cost.
+static std::string runPerfCase(const PerfSuiteOptions & opts, const std::string & testCase, const std::string & aiModule, const std::string & spatialDatabase)
+{
+	double secondsPerTick = 1.0 / (double)getHighResCounterFrequency();
+	std::map<std::string, double> phaseSeconds;
+	std::vector<double> frameMilliseconds;
+	std::map<std::string, TraceSpanTotals> spanTotals;
+	unsigned int numAgents = 0;
+
+	srand(opts.seed);
+
+	unsigned long long startAllocations = gNumAllocations;
+	unsigned long long startAllocatedBytes = gNumAllocatedBytes;
+	unsigned long long ticks = getHighResCounterValue();
+
+	// the same options steersim would use for "-commandline -testcase X -ai Y -numFrames N".
+	std::string numFramesString = toString(opts.numFrames);
+	std::vector<const char*> args;
+	args.push_back("steerperf");
+	args.push_back("-commandline");
+	args.push_back("-testcase");
+	args.push_back(testCase.c_str());
+	args.push_back("-ai");
+	args.push_back(aiModule.c_str());
+	args.push_back("-numFrames");
+	args.push_back(numFramesString.c_str());
+	if (opts.moduleSearchPath != "") {
+		args.push_back("-moduleSearchPath");
+		args.push_back(opts.moduleSearchPath.c_str());
+	}
+	if (opts.testCaseSearchPath != "") {
+		args.push_back("-testCasePath");
+		args.push_back(opts.testCaseSearchPath.c_str());
+	}
+	args.push_back(NULL);
+
+	SimulationOptions simulationOptions;
+	initializeOptionsFromCommandLine((int)args.size() - 1, const_cast<char**>(&args[0]), simulationOptions);
+	simulationOptions.spatialDatabaseOptions.name = spatialDatabase;
+
+	PerfEngineDriver driver;
+	driver.init(&simulationOptions);
+	SimulationEngine * engine = driver.getEngine();
+
+	unsigned long long now = getHighResCounterValue();
+	phaseSeconds["setup"] = (now - ticks) * secondsPerTick;
+	ticks = now;
+
+	TraceProfiler * traceProfiler = TraceProfiler::getInstance();
+	traceProfiler->collectSpanTotals(spanTotals);
+	spanTotals.clear();
+	traceProfiler->beginRecording();
+
+	engine->initializeSimulation();
+	now = getHighResCounterValue();
+	phaseSeconds["initializeSimulation"] = (now - ticks) * secondsPerTick;
+	ticks = now;
+
+	engine->preprocessSimulation();
+	now = getHighResCounterValue();
+	phaseSeconds["preprocessSimulation"] = (now - ticks) * secondsPerTick;
+	ticks = now;
+	numAgents = (unsigned int)engine->getAgents().size();
+
+	unsigned long long simulationStartTicks = ticks;
+	bool done = false;
+	while (!done) {
+		done = !engine->update(false);
+		now = getHighResCounterValue();
+		frameMilliseconds.push_back((now - ticks) * secondsPerTick * 1000.0);
+		ticks = now;
+		// collect every frame, so the ring buffers of the trace profiler never wrap.
+		traceProfiler->collectSpanTotals(spanTotals);
+	}
+	phaseSeconds["simulation"] = (ticks - simulationStartTicks) * secondsPerTick;
+
+	engine->postprocessSimulation();
+	now = getHighResCounterValue();
+	phaseSeconds["postprocessSimulation"] = (now - ticks) * secondsPerTick;
+	ticks = now;
+
+	engine->cleanupSimulation();
+	now = getHighResCounterValue();
+	phaseSeconds["cleanupSimulation"] = (now - ticks) * secondsPerTick;
+
+	traceProfiler->endRecording("");
+	traceProfiler->collectSpanTotals(spanTotals);
+
+	unsigned long long numAllocations = gNumAllocations - startAllocations;
+	unsigned long long numAllocatedBytes = gNumAllocatedBytes - startAllocatedBytes;
+	unsigned long long peakResidentSetKilobytes = getPeakResidentSetKilobytes();
+
+	driver.finish();
+
+	// per-frame statistics
+	std::vector<double> sortedFrames = frameMilliseconds;
+	std::sort(sortedFrames.begin(), sortedFrames.end());
+	double totalFrameMilliseconds = 0.0;
+	for (unsigned int i = 0; i < sortedFrames.size(); i++) {
+		totalFrameMilliseconds += sortedFrames[i];
+	}
+
+	std::ostringstream out;
+	out.precision(9);
+	out << "{\"testcase\":";
+	writeJSONString(out, testCase);
+	out << ",\"ai\":";
+	writeJSONString(out, aiModule);
+	out << ",\"spatialDatabase\":";
+	writeJSONString(out, spatialDatabase);
+	out << ",\"status\":\"ok\"";
+	out << ",\"numAgents\":" << numAgents;
+	out << ",\"numFrames\":" << frameMilliseconds.size();
+
+	out << ",\"phaseSeconds\":{";
+	for (std::map<std::string, double>::iterator phase = phaseSeconds.begin(); phase != phaseSeconds.end(); ++phase) {
+		if (phase != phaseSeconds.begin()) out << ",";
+		writeJSONString(out, phase->first);
+		out << ":" << phase->second;
+	}
+	out << "}";
+
+	out << ",\"frameMilliseconds\":{";
+	if (!sortedFrames.empty()) {
+		out << "\"mean\":" << totalFrameMilliseconds / sortedFrames.size();
+		out << ",\"median\":" << sortedFrames[sortedFrames.size() / 2];
+		out << ",\"p95\":" << sortedFrames[(sortedFrames.size() * 95) / 100];
+		out << ",\"min\":" << sortedFrames.front();
+		out << ",\"max\":" << sortedFrames.back();
+	}
+	out << "}";
+
+	out << ",\"spans\":{";
+	for (std::map<std::string, TraceSpanTotals>::iterator span = spanTotals.begin(); span != spanTotals.end(); ++span) {
+		if (span != spanTotals.begin()) out << ",";
+		writeJSONString(out, span->first);
+		out << ":{\"count\":" << span->second.numSpans;
+		out << ",\"totalMilliseconds\":" << span->second.totalTicks * secondsPerTick * 1000.0;
+		out << ",\"maxMilliseconds\":" << span->second.maxTicks * secondsPerTick * 1000.0 << "}";
+	}
+	out << "}";
+
+	out << ",\"allocations\":" << numAllocations;
+	out << ",\"allocatedBytes\":" << numAllocatedBytes;
+	out << ",\"peakResidentSetKilobytes\":" << peakResidentSetKilobytes;
+	out << "}";
+	return out.str();
+}
+
+
+/// Returns the JSON object of a run that failed.
+static std::string failedPerfCase(const std::string & testCase, const std::string & aiModule, const std::string & spatialDatabase, const std::string & errorMessage)
+{
+	std::ostringstream out;
+	out << "{\"testcase\":";
+	writeJSONString(out, testCase);
+	out << ",\"ai\":";
+	writeJSONString(out, aiModule);
+	out << ",\"spatialDatabase\":";
+	writeJSONString(out, spatialDatabase);
+	out << ",\"status\":\"failed\",\"error\":";
+	writeJSONString(out, errorMessage);
+	out << "}";
+	return out.str();
+}
+
+
+/// Runs one case, in a child process if requested, and never throws; failures are reported in the returned JSON object.
+static std::string runPerfCaseSafely(const PerfSuiteOptions & opts, const std::string & testCase, const std::string & aiModule, const std::string & spatialDatabase)
+{
+#ifndef _WIN32
+	if (opts.forkEachRun) {
+		int fds[2];
+		if (pipe(fds) != 0) {
+			return failedPerfCase(testCase, aiModule, spatialDatabase, "could not create a pipe to the child process");
+		}
+		std::cout.flush();
+		std::cerr.flush();
+		pid_t pid = fork();
+		if (pid < 0) {
+			close(fds[0]);
+			close(fds[1]);
+			return failedPerfCase(testCase, aiModule, spatialDatabase, "could not fork a child process");
+		}
+		if (pid == 0) {
+			close(fds[0]);
+			std::string result;
+			try {
+				result = runPerfCase(opts, testCase, aiModule, spatialDatabase);
+			}
+			catch (std::exception &e) {
+				result = failedPerfCase(testCase, aiModule, spatialDatabase, e.what());
+			}
+			size_t written = 0;
+			while (written < result.size()) {
+				ssize_t n = write(fds[1], result.c_str() + written, result.size() - written);
+				if (n <= 0) break;
+				written += n;
+			}
+			close(fds[1]);
+			std::cout.flush();
+			_exit(0);
+		}
+
+		close(fds[1]);
+		std::string result;
+		char buffer[4096];
+		ssize_t n;
+		while ((n = read(fds[0], buffer, sizeof(buffer))) > 0) {
+			result.append(buffer, n);
+		}
+		close(fds[0]);
+		int status = 0;
+		waitpid(pid, &status, 0);
+		if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0) || (result == "")) {
+			return failedPerfCase(testCase, aiModule, spatialDatabase, "the child process crashed");
+		}
+		return result;
+	}
+#endif
+
+	try {
+		return runPerfCase(opts, testCase, aiModule, spatialDatabase);
+	}
+	catch (std::exception &e) {
+		return failedPerfCase(testCase, aiModule, spatialDatabase, e.what());
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	try {
+		CommandLineParser * cp = new CommandLineParser();
+
+		PerfSuiteOptions opts;
+		opts.moduleSearchPath = "";
+		opts.testCaseSearchPath = "";
+		opts.numFrames = DEFAULT_PERF_NUM_FRAMES;
+		opts.seed = DEFAULT_PERF_SEED;
+		opts.forkEachRun = true;
+		bool noFork = false;
+		std::string testCaseList = DEFAULT_PERF_TEST_CASES;
+		std::string aiModuleList = DEFAULT_PERF_AI_MODULES;
+		std::string spatialDatabaseList = DEFAULT_PERF_SPATIAL_DATABASES;
+		std::string outputFilename = "steerperf.json";
+
+		cp->addOption("-testcases", &testCaseList, OPTION_DATA_TYPE_STRING);
+		cp->addOption("-testCases", &testCaseList, OPTION_DATA_TYPE_STRING);
+		cp->addOption("-ais", &aiModuleList, OPTION_DATA_TYPE_STRING);
+		cp->addOption("-databases", &spatialDatabaseList, OPTION_DATA_TYPE_STRING);
+		cp->addOption("-numframes", &opts.numFrames, OPTION_DATA_TYPE_UNSIGNED_INT);
+		cp->addOption("-numFrames", &opts.numFrames, OPTION_DATA_TYPE_UNSIGNED_INT);
+		cp->addOption("-seed", &opts.seed, OPTION_DATA_TYPE_UNSIGNED_INT);
+		cp->addOption("-modulesearchpath", &opts.moduleSearchPath, OPTION_DATA_TYPE_STRING);
+		cp->addOption("-moduleSearchPath", &opts.moduleSearchPath, OPTION_DATA_TYPE_STRING);
+		cp->addOption("-testcasepath", &opts.testCaseSearchPath, OPTION_DATA_TYPE_STRING);
+		cp->addOption("-testCasePath", &opts.testCaseSearchPath, OPTION_DATA_TYPE_STRING);
+		cp->addOption("-nofork", NULL, OPTION_DATA_TYPE_NO_DATA, 0, &noFork, true);
+		cp->addOption("-noFork", NULL, OPTION_DATA_TYPE_NO_DATA, 0, &noFork, true);
+		cp->addOption("-o", &outputFilename, OPTION_DATA_TYPE_STRING);
+
+		// the first arg will be ignored cause it is the exectuable binary itself.
+		cp->parse(argc, argv, true, true);
+		opts.forkEachRun = !noFork;
+
+		if (opts.numFrames == 0) {
+			throw GenericException("-numFrames must be at least 1, so that every run simulates the same number of frames.");
+		}
+
+		std::vector<std::string> testCases = splitList(testCaseList);
+		std::vector<std::string> aiModules = splitList(aiModuleList);
+		std::vector<std::string> spatialDatabases = splitList(spatialDatabaseList);
+
+		std::ofstream out(outputFilename.c_str());
+		if (!out.is_open()) {
+			throw GenericException("Could not open \"" + outputFilename + "\" to write the results.");
+		}
+
+		out << "{\"format\":\"steerperf\",\"version\":" << STEERPERF_FORMAT_VERSION;
+		out << ",\"numFrames\":" << opts.numFrames;
+		out << ",\"seed\":" << opts.seed;
+		out << ",\"runs\":[\n";
+
+		unsigned int numFailed = 0;
+		bool firstRun = true;
+		for (unsigned int t = 0; t < testCases.size(); t++) {
+			for (unsigned int a = 0; a < aiModules.size(); a++) {
+				for (unsigned int d = 0; d < spatialDatabases.size(); d++) {
+					std::cerr << "steerperf: " << testCases[t] << " / " << aiModules[a] << " / " << spatialDatabases[d] << "\n";
+					std::string result = runPerfCaseSafely(opts, testCases[t], aiModules[a], spatialDatabases[d]);
+					if (result.find("\"status\":\"failed\"") != std::string::npos) {
+						numFailed++;
+					}
+					if (!firstRun) out << ",\n";
+					out << result;
+					out.flush();
+					firstRun = false;
+				}
+			}
+		}
+
+		out << "\n]}\n";
+		out.close();
+
+		std::cerr << "steerperf: wrote " << outputFilename;
+		if (numFailed > 0) {
+			std::cerr << " (" << numFailed << " runs failed)";
+		}
+		std::cerr << "\n";
+
+		delete cp;
+		return (numFailed > 0) ? 1 : EXIT_SUCCESS;
+	}
+	catch (std::exception &e) {
+		std::cerr << "\nERROR: exception caught in main:\n" << e.what() << "\n";
+		exit(1);
+	}
+
+	return EXIT_SUCCESS;
+}
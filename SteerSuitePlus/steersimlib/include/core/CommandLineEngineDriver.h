@@ -25,6 +25,8 @@ public:
 	const char * getData();
 	LogData * getLogData();
 	void outputTestCase();
+	/// Merges new options into a loaded module and re-initializes it, so that the next run() uses them.
+	void reinitializeModule(const std::string & moduleName, const std::string & options);
 
 	/// @name The EngineControllerInterface
 	/// @brief The CommandLineEngineDriver does not support any of the engine controls.
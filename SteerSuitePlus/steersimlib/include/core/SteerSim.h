@@ -13,10 +13,20 @@
 #include "core/GLFWEngineDriver.h"
 #include "core/QtEngineDriver.h"
 #include "SimulationPlugin.h"
+#include "core/SteerSimSession.h"
 
 
 void STEERLIB_API initializeOptionsFromCommandLine( int argc, char **argv, SteerLib::SimulationOptions & simulationOptions );
 // const char * steersuite_init(int argc, char ** argv);
 LogData * init_steersuite(int argc, char ** argv);
 
+/// @name Persistent simulation sessions
+/// @brief C entry points around SteerSimSession; these return NULL (or -1) and print the error if an exception is thrown.
+//@{
+PLUGIN_API SteerSimSession * create_steersim_session(int argc, char ** argv);
+PLUGIN_API int reset_steersim_session(SteerSimSession * session, const char * moduleName, const char * options);
+PLUGIN_API LogData * run_steersim_session(SteerSimSession * session);
+PLUGIN_API void destroy_steersim_session(SteerSimSession * session);
+//@}
+
 
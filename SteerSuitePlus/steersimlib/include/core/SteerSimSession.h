@@ -0,0 +1,78 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+#ifndef __STEERSIM_SESSION_H__
+#define __STEERSIM_SESSION_H__
+
+/// @file SteerSimSession.h
+/// @brief Declares the SteerSimSession class
+
+#include <fstream>
+#include "SteerLib.h"
+#include "core/CommandLineEngineDriver.h"
+
+#ifdef _WIN32
+// on win32, there is an unfortunate conflict between exporting symbols for a
+// dynamic/shared library and STL code.  A good document describing the problem
+// in detail is http://www.unknownroad.com/rtfm/VisualStudio/warningC4251.html
+// the "least evil" solution is just to simply ignore this warning.
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+
+/**
+ * @brief Keeps a command-line simulation engine alive between simulations.
+ *
+ * init_steersim2() parses the command line, loads all modules, builds the spatial database and planning
+ * domain, simulates once, and destroys everything again.  For parameter-optimization loops that simulate the
+ * same test case thousands of times, a SteerSimSession does that setup only once in its constructor.  After that,
+ * reset() changes the options of individual modules (e.g. the parameters of the AI module) by re-initializing only
+ * those modules, and run() simulates the test case again.  Loaded modules, the parsed test case, the spatial database
+ * and the planning domain are re-used by every run.
+ *
+ * Only the command-line engine driver is supported; any other engine driver given on the command line is ignored.
+ */
+class STEERLIB_API SteerSimSession
+{
+public:
+	/// Parses the command line like steersim does, and initializes the engine and all requested modules.
+	SteerSimSession(int argc, char ** argv);
+	/// Finishes the engine and unloads all modules.
+	~SteerSimSession();
+
+	/// Merges options (in the same "name=value,name=value" form as the -module command-line option) into a loaded module, and re-initializes only that module.
+	void reset(const std::string & moduleName, const std::string & options);
+	/// Simulates the test case from the beginning, and returns the log data of the modules.  The log data is owned by the session, and is valid until the next call to run() or until the session is destroyed.
+	LogData * run();
+
+	/// Returns the number of simulations run so far.
+	unsigned int getNumRuns() { return _numRuns; }
+	/// Returns the options the session was initialized with; changes made by reset() are merged into these options.
+	const SteerLib::SimulationOptions & getSimulationOptions() { return _simulationOptions; }
+
+protected:
+	SteerLib::SimulationOptions _simulationOptions;
+	CommandLineEngineDriver * _driver;
+	LogData * _logData;
+	unsigned int _numRuns;
+
+	std::ofstream _coutRedirection;
+	std::ofstream _cerrRedirection;
+	std::ofstream _clogRedirection;
+	std::streambuf * _coutOriginalStreambuf;
+	std::streambuf * _cerrOriginalStreambuf;
+	std::streambuf * _clogOriginalStreambuf;
+
+private:
+	SteerSimSession(const SteerSimSession & );  // not implemented, not copyable
+	SteerSimSession& operator= (const SteerSimSession & );  // not implemented, not assignable
+};
+
+#ifdef _WIN32
+#pragma warning( pop )
+#endif
+
+#endif
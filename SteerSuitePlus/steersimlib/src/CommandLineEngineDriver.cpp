@@ -53,7 +53,20 @@ void CommandLineEngineDriver::init(SteerLib::SimulationOptions * options)
 
 
 //
-// run() - never returns, will end the program properly when appropriate
+// reinitializeModule() - only allowed between simulations, i.e. before or after run().
+//
+void CommandLineEngineDriver::reinitializeModule(const std::string & moduleName, const std::string & options)
+{
+	if (!_alreadyInitialized) {
+		throw GenericException("CommandLineEngineDriver::reinitializeModule() - the engine driver was not initialized.\n");
+	}
+
+	_engine->reinitializeModule(moduleName, options);
+}
+
+
+//
+// run() - simulates one test case from start to finish; the engine is ready for another run() afterwards.
 //
 void CommandLineEngineDriver::run()
 {
@@ -144,9 +157,14 @@ const char * CommandLineEngineDriver::getData()
 LogData * CommandLineEngineDriver::getLogData()
 {
 	ModuleInterface * moduleInterface = (_engine->getModule("scenario"));
-	LogData * lD = moduleInterface->getLogData();
 	ModuleInterface * aimoduleInterface = (_engine->getModule("sfAI")); // TODO support all steering algorithms
 
+	// without the scenario module, only the AI module has anything to report.
+	if (moduleInterface == NULL) {
+		return (aimoduleInterface != NULL) ? aimoduleInterface->getLogData() : new LogData();
+	}
+	LogData * lD = moduleInterface->getLogData();
+
 	// TODO use this properly instead.
 	std::vector<SteerLib::ModuleInterface*> modules = _engine-> getAllModules();
 
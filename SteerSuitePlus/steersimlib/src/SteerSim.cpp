@@ -364,6 +364,10 @@ void initializeOptionsFromCommandLine( int argc, char **argv, SimulationOptions
 	opts.addOption( "-startpaused", NULL, OPTION_DATA_TYPE_NO_DATA, 0, &simulationOptions.glfwEngineDriverOptions.pausedOnStart, true);
 	opts.addOption( "-saveFramesTo", &simulationOptions.engineOptions.frameDumpDirectory , OPTION_DATA_TYPE_STRING);
 	opts.addOption( "-saveframesto", &simulationOptions.engineOptions.frameDumpDirectory, OPTION_DATA_TYPE_STRING);
+	opts.addOption( "-traceFile", &simulationOptions.engineOptions.traceFilename, OPTION_DATA_TYPE_STRING);
+	opts.addOption( "-tracefile", &simulationOptions.engineOptions.traceFilename, OPTION_DATA_TYPE_STRING);
+	opts.addOption( "-trajectoryFile", &simulationOptions.engineOptions.trajectoryFilename, OPTION_DATA_TYPE_STRING);
+	opts.addOption( "-trajectoryfile", &simulationOptions.engineOptions.trajectoryFilename, OPTION_DATA_TYPE_STRING);
 	opts.addOption( "-blendingDemo", NULL, OPTION_DATA_TYPE_NO_DATA, 0, &simulationOptions.globalOptions.blendingDemo, true);
 	opts.addOption( "-parameterDemo", NULL, OPTION_DATA_TYPE_NO_DATA, 0, &simulationOptions.globalOptions.parameterDemo, true);
 	opts.addOption( "-noTweakBar", NULL, OPTION_DATA_TYPE_NO_DATA, 0, &simulationOptions.globalOptions.noTweakBar, true);
@@ -509,3 +513,42 @@ PLUGIN_API	LogData * init_steersim2(int argc, char ** argv)
 	return init_steersuite(argc, argv);
 }
 
+
+PLUGIN_API SteerSimSession * create_steersim_session(int argc, char ** argv)
+{
+	try {
+		return new SteerSimSession(argc, argv);
+	}
+	catch (std::exception &e) {
+		std::cerr << "\nERROR: exception caught in create_steersim_session:\n" << e.what() << "\n";
+		return NULL;
+	}
+}
+
+PLUGIN_API int reset_steersim_session(SteerSimSession * session, const char * moduleName, const char * options)
+{
+	try {
+		session->reset(moduleName, options);
+		return 0;
+	}
+	catch (std::exception &e) {
+		std::cerr << "\nERROR: exception caught in reset_steersim_session:\n" << e.what() << "\n";
+		return -1;
+	}
+}
+
+PLUGIN_API LogData * run_steersim_session(SteerSimSession * session)
+{
+	try {
+		return session->run();
+	}
+	catch (std::exception &e) {
+		std::cerr << "\nERROR: exception caught in run_steersim_session:\n" << e.what() << "\n";
+		return NULL;
+	}
+}
+
+PLUGIN_API void destroy_steersim_session(SteerSimSession * session)
+{
+	delete session;
+}
@@ -0,0 +1,104 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+
+/// @file SteerSimSession.cpp
+/// @brief Implements the SteerSimSession class.
+
+#include <iostream>
+#include "core/SteerSim.h"
+#include "core/SteerSimSession.h"
+
+using namespace std;
+using namespace SteerLib;
+using namespace Util;
+
+
+SteerSimSession::SteerSimSession(int argc, char ** argv)
+{
+	_driver = NULL;
+	_logData = NULL;
+	_numRuns = 0;
+
+	_coutOriginalStreambuf = std::cout.rdbuf();
+	_cerrOriginalStreambuf = std::cerr.rdbuf();
+	_clogOriginalStreambuf = std::clog.rdbuf();
+
+	initializeOptionsFromCommandLine( argc, argv, _simulationOptions );
+
+	if (_simulationOptions.globalOptions.engineDriver != "commandline") {
+		std::cerr << "WARNING: SteerSimSession only supports the command line engine driver, ignoring engine driver \"" << _simulationOptions.globalOptions.engineDriver << "\".\n";
+		_simulationOptions.globalOptions.engineDriver = "commandline";
+	}
+
+	// re-direct cout, cerr, and clog, if the user specified it through options.
+	if (_simulationOptions.globalOptions.coutRedirectionFilename != "") {
+		_coutRedirection.open(_simulationOptions.globalOptions.coutRedirectionFilename.c_str());
+		std::cout.rdbuf( _coutRedirection.rdbuf() );
+	}
+	if (_simulationOptions.globalOptions.cerrRedirectionFilename != "") {
+		_cerrRedirection.open(_simulationOptions.globalOptions.cerrRedirectionFilename.c_str());
+		std::cerr.rdbuf( _cerrRedirection.rdbuf() );
+	}
+	if (_simulationOptions.globalOptions.clogRedirectionFilename != "") {
+		_clogRedirection.open(_simulationOptions.globalOptions.clogRedirectionFilename.c_str());
+		std::clog.rdbuf( _clogRedirection.rdbuf() );
+	}
+
+	_driver = new CommandLineEngineDriver();
+	try {
+		_driver->init(&_simulationOptions);
+	}
+	catch (...) {
+		delete _driver;
+		_driver = NULL;
+		std::cout.rdbuf(_coutOriginalStreambuf);
+		std::cerr.rdbuf(_cerrOriginalStreambuf);
+		std::clog.rdbuf(_clogOriginalStreambuf);
+		throw;
+	}
+}
+
+
+SteerSimSession::~SteerSimSession()
+{
+	// the log objects and logger belong to the modules, only the LogData itself is ours.
+	if (_logData != NULL) {
+		_logData->release();
+		delete _logData;
+	}
+
+	if (_driver != NULL) {
+		_driver->finish();
+		delete _driver;
+	}
+
+	std::cout.rdbuf(_coutOriginalStreambuf);
+	std::cerr.rdbuf(_cerrOriginalStreambuf);
+	std::clog.rdbuf(_clogOriginalStreambuf);
+}
+
+
+void SteerSimSession::reset(const std::string & moduleName, const std::string & options)
+{
+	_driver->reinitializeModule(moduleName, options);
+}
+
+
+LogData * SteerSimSession::run()
+{
+	if (_logData != NULL) {
+		_logData->release();
+		delete _logData;
+		_logData = NULL;
+	}
+
+	// the driver leaves the engine ready for the next simulation when it is done.
+	_driver->run();
+	_numRuns++;
+
+	_logData = _driver->getLogData();
+	return _logData;
+}
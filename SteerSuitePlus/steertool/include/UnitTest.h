@@ -11,12 +11,33 @@
 /// @brief Declares unit tests for testing some SteerLib components.
 ///
 
+#include <mutex>
+#include <condition_variable>
 #include "SteerLib.h"
+#include "util/dmatrix.h"
 
+class SteerSimSession;
 
 /// Runs the specific unit test identified by its string name.
 void runUnitTest(const std::string & unitTestName);
 
+/// An engine controller that supports nothing, like the command-line engine driver; used by tests that drive a SimulationEngine themselves.
+class TestEngineController : public SteerLib::EngineControllerInterface
+{
+public:
+	bool isStartupControlSupported() { return false; }
+	bool isPausingControlSupported() { return false; }
+	bool isPaused() { return false; }
+	void loadSimulation() { }
+	void unloadSimulation() { }
+	void startSimulation() { }
+	void stopSimulation() { }
+	void pauseSimulation() { }
+	void unpauseSimulation() { }
+	void togglePausedState() { }
+	void pauseAndStepOneFrame() { }
+};
+
 
 /**
  * @brief Unit test for the SteerLib::ThreadedTaskManager
@@ -51,6 +72,180 @@ protected:
 	Util::ThreadedTaskManager * _taskManager;
 };
 
+/**
+ * @brief Unit test for the Util::TaskScheduler and Util::TaskGroup.
+ *
+ * Runs each test with 1 up to MAX_NUM_THREADS threads.  Checks that parallelFor() covers its range with the chunks given by
+ * getNumChunks() and getChunkSize(), that TaskGroup::wait() returns only after all tasks (including tasks spawned by tasks,
+ * and tasks that wait for their own groups) are done, and that the exception of the first failing task or chunk is re-thrown
+ * after all the others ran.
+ */
+class TaskSchedulerTest
+{
+public:
+	TaskSchedulerTest() { }
+	~TaskSchedulerTest() { }
+	void runTest();
+protected:
+	void _testParallelForChunks(Util::TaskScheduler & scheduler, size_t begin, size_t end, size_t grainSize);
+	void _testTaskGroupJoin(Util::TaskScheduler & scheduler);
+	void _testExceptions(Util::TaskScheduler & scheduler);
+
+	static const unsigned int MAX_NUM_THREADS = 8;
+	static const unsigned int NUM_TASKS = 2000;
+};
+
+/**
+ * @brief Unit test for the parallel steps of the particle filter and the Unscented Kalman Filter in BayesianFilter.h.
+ *
+ * Runs the filters without a scheduler and on schedulers with 1 up to MAX_NUM_THREADS threads, from the same particles
+ * and the same MTRand seed, and checks that all results are identical.  Also checks that the serial and the parallel
+ * resample() both pick the particles of the sequential low-variance comb.
+ */
+class BayesianFilterTest
+{
+public:
+	BayesianFilterTest() { }
+	~BayesianFilterTest() { }
+	void runTest();
+protected:
+	/// A thread-safe non-linear dynamics function x = f(x, u, m).
+	static Matrix _dynamics(const Matrix & x, const Matrix & u, const Matrix & m);
+	/// A thread-safe non-linear measurement function z = h(x, n), that is linear in n.
+	static Matrix _measurement(const Matrix & x, const Matrix & n);
+	/// The measurement function without noise, z = h(x) + n.
+	static Matrix _measurementWithoutNoise(const Matrix & x);
+
+	void _testParticleFilter(bool additiveNoise);
+	void _testUnscentedKalmanFilter();
+	void _testResample(const std::vector<double> & weights);
+
+	/// Returns the indices of the particles that the sequential low-variance comb with offset r picks.
+	std::vector<size_t> _sequentialComb(const std::vector<double> & weights, double r);
+	/// Throws if the matrices are not identical.
+	void _checkIdentical(const Matrix & expected, const Matrix & actual, const std::string & what);
+
+	static const unsigned int MAX_NUM_THREADS = 8;
+	static const unsigned int NUM_PARTICLES = 1001;
+	static const unsigned int NUM_STEPS = 5;
+	static const unsigned int SEED = 1234;
+};
+
+/**
+ * @brief Unit test for FixedMatrix and the FixedMatrix overloads in BayesianFilter.h.
+ *
+ * Computes the same operations and filter steps with FixedMatrix and with Matrix, from the same random
+ * inputs, and checks that the results are the same.
+ */
+class FixedMatrixTest
+{
+public:
+	FixedMatrixTest() { }
+	~FixedMatrixTest() { }
+	void runTest();
+protected:
+	void _testArithmetic();
+	void _testKalmanFilter();
+	void _testGaussian();
+
+	static const unsigned int NUM_REPEATS = 20;
+	static const unsigned int SEED = 4321;
+};
+
+/**
+ * @brief Unit test for the multi-threaded update of SteerLib::SimulationMetricsCollector.
+ *
+ * Records a crowded rec file with random agents and obstacles, then benchmarks it with one metrics thread
+ * and with 2 up to MAX_NUM_THREADS metrics threads at the same time, and checks after every frame that
+ * the metrics of every agent are bit-for-bit identical, and at the end that the scores are identical.
+ */
+class MetricsCollectorTest
+{
+public:
+	MetricsCollectorTest() { }
+	~MetricsCollectorTest() { }
+	void runTest();
+protected:
+	/// Writes a rec file in which the agents wander randomly around a few obstacles, so that they collide with each other and with the obstacles.
+	void _writeRecFile(const std::string & filename);
+
+	static const unsigned int MAX_NUM_THREADS = 8;
+	static const unsigned int NUM_AGENTS = 200;
+	static const unsigned int NUM_FRAMES = 150;
+	static const unsigned int SEED = 2468;
+};
+
+/**
+ * @brief Unit test for SteerSimSession.
+ *
+ * For each AI module, simulates a test case NUM_RUNS times with one session, re-initializing the AI module with reset()
+ * before the last run, and checks that every run records exactly the same frames as the first one.  For sfAI, also checks
+ * that a run after reset() with a changed parameter records the same frames as a new session given that parameter on the
+ * command line.  Uses the default module and test case search paths (i.e., run from build/bin).
+ */
+class SteerSimSessionTest
+{
+public:
+	SteerSimSessionTest() { }
+	~SteerSimSessionTest() { }
+	void runTest();
+protected:
+	/// The records of all agents in one frame of a recording.
+	typedef std::vector<SteerLib::RecFileAgentInfo> RecordedFrame;
+
+	/// Creates a session that records the test case simulated with the AI module to the test's rec file; moduleOptions (possibly empty) are given to the AI module.
+	SteerSimSession * _createSession(const std::string & aiModuleName, const std::string & moduleOptions);
+	/// Runs the session once and reads back the frames it recorded.
+	std::vector<RecordedFrame> _runAndReadRecording(SteerSimSession * session);
+	/// Returns true if the agents of all frames of the two recordings are identical.
+	bool _isSameRecording(const std::vector<RecordedFrame> & first, const std::vector<RecordedFrame> & second);
+
+	static const unsigned int NUM_RUNS = 5;
+	static const unsigned int NUM_FRAMES = 200;
+};
+
+/**
+ * @brief Unit test for SimulationEngine::saveCheckpoint() and SimulationEngine::restoreCheckpoint().
+ *
+ * Simulates a test case with pprAI for NUM_FRAMES frames without interruption.  Then simulates it again, saves a checkpoint at
+ * CHECKPOINT_FRAME, runs to the end, restores the checkpoint (rewind) and runs to the end again; then restores the same checkpoint
+ * into a new engine (fork) and runs it to the end.  Both must simulate exactly the same frames after the checkpoint as the first
+ * engine, and the rewound engine must stream exactly the same trajectories to its file, without the frames that were rewound.
+ * Uses the default module and test case search paths (i.e., run from build/bin).
+ */
+class CheckpointTest
+{
+public:
+	CheckpointTest() { }
+	~CheckpointTest() { }
+	void runTest();
+protected:
+	/// The state of one agent after a frame.
+	struct AgentFrame {
+		bool enabled;
+		Util::Point position;
+		Util::Vector forward;
+		Util::Vector velocity;
+	};
+	typedef std::vector<AgentFrame> Frame;
+
+	/// Creates an engine that simulates the test case with pprAI, streaming trajectories to trajectoryFilename, and loads the simulation.
+	SteerLib::SimulationEngine * _createEngine(SteerLib::SimulationOptions & options, const std::string & trajectoryFilename);
+	/// Updates the engine until it is done, or until it simulated lastFrame frames; appends the state of the agents after each frame to frames.
+	void _simulate(SteerLib::SimulationEngine * engine, unsigned int lastFrame, std::vector<Frame> & frames);
+	/// Reads back the trajectories the engine streamed to its file.
+	std::vector<SteerLib::TrajectorySink::PositionList> _readTrajectories(SteerLib::SimulationEngine * engine);
+	/// Unloads the simulation and destroys the engine.
+	void _destroyEngine(SteerLib::SimulationEngine * engine);
+	/// Throws an exception if the frames differ from the frames of the uninterrupted run that follow the checkpoint.
+	void _checkFrames(const std::string & name, const std::vector<Frame> & uninterrupted, const std::vector<Frame> & frames);
+
+	TestEngineController _controller;
+
+	static const unsigned int NUM_FRAMES = 200;
+	static const unsigned int CHECKPOINT_FRAME = 80;
+};
+
 /**
  * @brief Unit test for HighResCounter and PerformanceProfiler.
  *
@@ -136,4 +331,78 @@ protected:
 	Util::StateMachine _stateMachine;
 };
 
+
+/**
+ * @brief Unit test for the LogManager with several engines in one process.
+ *
+ * First checks that two loggers of the same name write to different files and that a destroyed logger's name can
+ * be used again.  Then, for each AI module, runs two SimulationEngines on two threads at the same time, using the
+ * default module and test case search paths (i.e., run from build/bin), and checks that each engine's module got
+ * its own log file.
+ */
+class LogManagerTest
+{
+public:
+	LogManagerTest() { }
+	~LogManagerTest() { }
+	void runTest();
+protected:
+	/// Simulates the test case with _aiModuleName; stores the name of the module's log file and any error at engineIndex.
+	void _runEngine(unsigned int engineIndex);
+
+	static const unsigned int NUM_ENGINES = 2;
+	static const unsigned int NUM_FRAMES = 50;
+
+	/// Holds the engines until all of them loaded their modules, so that their logs are open at the same time.
+	std::mutex _lock;
+	std::condition_variable _allEnginesLoaded;
+	unsigned int _numEnginesLoaded;
+
+	std::string _aiModuleName;
+	std::string _logFileNames[NUM_ENGINES];
+	std::string _errors[NUM_ENGINES];
+};
+
+/**
+ * @brief Unit test for the BinaryLogger and LogManager::readBinaryLog().
+ *
+ * Writes NUM_RECORDS log objects with a BINARY_WRITE logger, enough to fill the write buffer several times, and reads them
+ * back with LogManager::readBinaryLog(), checking the fields (names and types), the number of records, and every value.
+ * This is done once with fixed-size records (Integer, Float and LongLong fields) and once with a String field, which makes
+ * the records variable-sized.
+ */
+class BinaryLoggerTest
+{
+public:
+	BinaryLoggerTest() { }
+	~BinaryLoggerTest() { }
+	void runTest();
+protected:
+	/// Writes the records to a binary log, reads it back and checks it; the records include a String field if withStrings is true.
+	void _testRoundTrip(bool withStrings);
+
+	static const unsigned int NUM_RECORDS = 100000;
+};
+
+/**
+ * @brief Unit test for writing test cases scaled by the TestCaseScaler.
+ *
+ * Scales and tiles a test case with agent emitters and obstacles, writes it as an xml test case, reads it back with
+ * the TestCaseReader, and checks that the world bounds, the obstacles and every agent and agent emitter (name, radius,
+ * position and goal targets) were written.
+ */
+class TestCaseScalerTest
+{
+public:
+	TestCaseScalerTest() { }
+	~TestCaseScalerTest() { }
+	void runTest();
+protected:
+	/// Returns an error message if the agent (or agent emitter) that was read back differs from the one that was written.
+	std::string _compareAgents(const std::string & agentName, const SteerLib::AgentInitialConditions & written, const SteerLib::AgentInitialConditions & read);
+
+	static const unsigned int NUM_TILES_X = 3;
+	static const unsigned int NUM_TILES_Z = 2;
+};
+
 #endif
@@ -34,6 +34,20 @@ int main(int argc, char** argv)
 		endianFileNames[0] = "";
 		endianFileNames[1] = "";
 
+		std::string scaleFileNames[2];
+		scaleFileNames[0] = "";
+		scaleFileNames[1] = "";
+		float scaleFactor = 1.0f;
+
+		std::string binaryFileNames[2];
+		binaryFileNames[0] = "";
+		binaryFileNames[1] = "";
+		unsigned int tiles[2];
+		tiles[0] = 1;
+		tiles[1] = 1;
+		float tileSpacing = 0.0f;
+		unsigned int numAgents = 0;
+
 		CommandLineParser opts;
 		opts.addOption("-test",     &unitTestName, OPTION_DATA_TYPE_STRING);
 		opts.addOption("-unit",     &unitTestName, OPTION_DATA_TYPE_STRING);
@@ -46,6 +60,13 @@ int main(int argc, char** argv)
 		opts.addOption("-swapEndian", endianFileNames, OPTION_DATA_TYPE_STRING, 2);
 		opts.addOption("-testcasepath", &testCaseSearchPath, OPTION_DATA_TYPE_STRING);
 		opts.addOption("-testCasePath", &testCaseSearchPath, OPTION_DATA_TYPE_STRING);
+		opts.addOption("-tobinary", binaryFileNames, OPTION_DATA_TYPE_STRING, 2);
+		opts.addOption("-toBinary", binaryFileNames, OPTION_DATA_TYPE_STRING, 2);
+		opts.addOption("-scale", scaleFileNames, OPTION_DATA_TYPE_STRING, 2);
+		opts.addOption("-scaleFactor", &scaleFactor, OPTION_DATA_TYPE_FLOAT);
+		opts.addOption("-tiles", tiles, OPTION_DATA_TYPE_UNSIGNED_INT, 2);
+		opts.addOption("-tileSpacing", &tileSpacing, OPTION_DATA_TYPE_FLOAT);
+		opts.addOption("-numAgents", &numAgents, OPTION_DATA_TYPE_UNSIGNED_INT);
 
 		opts.parse(argc, argv, true, true);
 		
@@ -64,21 +85,21 @@ int main(int argc, char** argv)
 				std::cout << " Test case recorded: " << recFile.getTestCaseName() << "\n";
 				std::cout << "    Simulation time: " << recFile.getTotalElapsedTime() << "\n";
 				std::cout << "   Number of frames: " << recFile.getNumFrames() << "\n";
-				std::cout << "   Number of agents: " << recFile.getNumAgents() << "\n";
-				std::cout << "Number of obstacles: " << recFile.getNumObstacles() << "\n";
+				std::cout << "          Number of agents: " << recFile.getNumAgents() << "\n";
+				std::cout << "       Number of obstacles: " << recFile.getNumObstacles() << "\n";
 			}
-			else if (endsWith(infoFileName, ".xml")) {
+			else if (endsWith(infoFileName, ".xml") || SteerLib::TestCaseReader::isABinaryTestCase(infoFileName)) {
 				SteerLib::TestCaseReader testCase;
 				testCase.readTestCaseFromFile(infoFileName);
 				std::cout << "           filename: " << basename(infoFileName,"") << "\n";
 				std::cout << "            version: " << testCase.getVersion() << "\n";
 				std::cout << "     Test case name: " << testCase.getTestCaseName() << "\n";
 				std::cout << "        Description: " << testCase.getDescription() << "\n";
-				std::cout << "   Number of agents: " << testCase.getNumAgents() << "\n";
-				std::cout << "Number of obstacles: " << testCase.getNumObstacles() << "\n";
-				std::cout << "      X-axis bounds: " << testCase.getWorldBounds().xmin << " to " << testCase.getWorldBounds().xmax << "\n";
+				std::cout << "          Number of agents: " << testCase.getNumAgents() << "\n";
+				std::cout << "       Number of obstacles: " << testCase.getNumObstacles() << "\n";
+				std::cout << "             X-axis bounds: " << testCase.getWorldBounds().xmin << " to " << testCase.getWorldBounds().xmax << "\n";
 				std::cout << "      Y-axis bounds: " << testCase.getWorldBounds().ymin << " to " << testCase.getWorldBounds().ymax << "\n";
-				std::cout << "      Z-axis bounds: " << testCase.getWorldBounds().zmin << " to " << testCase.getWorldBounds().zmax << "\n";
+				std::cout << "             Z-axis bounds: " << testCase.getWorldBounds().zmin << " to " << testCase.getWorldBounds().zmax << "\n";
 			}
 			else {
 				throw GenericException("Specified file does not seem to be a valid rec file or test case.");
@@ -89,12 +110,46 @@ int main(int argc, char** argv)
 		else if (endianFileNames[0] != "") {
 			throw GenericException("Swapping endian-ness is not implemented yet.");
 		}
+		else if (binaryFileNames[0] != "") {
+			SteerLib::TestCaseReader testCase;
+			testCase.readTestCaseFromFile(binaryFileNames[0]);
+			SteerLib::TestCaseWriter writer;
+			writer.writeBinaryTestCaseToFile(binaryFileNames[1], testCase);
+			std::cout << "Wrote binary test case " << binaryFileNames[1] << " with " << testCase.getNumAgents() << " agents and " << testCase.getNumObstacles() << " obstacles.\n";
+		}
+		else if (scaleFileNames[0] != "") {
+			SteerLib::TestCaseReader testCase;
+			testCase.readTestCaseFromFile(scaleFileNames[0]);
+			if (numAgents > 0) {
+				SteerLib::TestCaseScaler::getTilesForNumAgents(testCase.getNumAgents(), numAgents, tiles[0], tiles[1]);
+			}
+
+			SteerLib::TestCaseScaler scaler;
+			scaler.scaleTestCase(testCase, scaleFactor, tiles[0], tiles[1], tileSpacing);
+
+			// TestCaseWriter adds the .xml extension itself.
+			std::string outputName = scaleFileNames[1];
+			if (endsWith(outputName, ".xml")) {
+				outputName = outputName.substr(0, outputName.size() - 4);
+			}
+			scaler.writeTestCaseToFile(outputName);
+
+			const Util::AxisAlignedBox & bounds = scaler.getWorldBounds();
+			std::cout << "          Number of agents: " << testCase.getNumAgents() << " -> " << scaler.getNumAgents() << "\n";
+			std::cout << "  Number of agent emitters: " << testCase.getNumAgentEmitters() << " -> " << scaler.getNumAgentEmitters() << "\n";
+			std::cout << "       Number of obstacles: " << testCase.getNumObstacles() << " -> " << scaler.getNumObstacles() << "\n";
+			std::cout << "             X-axis bounds: " << bounds.xmin << " to " << bounds.xmax << "\n";
+			std::cout << "             Z-axis bounds: " << bounds.zmin << " to " << bounds.zmax << "\n";
+		}
 		else {
 			throw GenericException(std::string("Please specify an action for SteerTool.\nPossible actions include:\n")
 				+ std::string("    -test <testName> - performs a hard-coded unit test\n")
 				+ std::string("    -validate <filename> - validates a recording against the corresponding XML test case\n")
 				+ std::string("    -info <filename> - outputs human-readable information of the recording or XML test case\n")
-				+ std::string("    -swapendian <inputFilename> <outputFilename> - changes the endian-ness of a rec file\n"));
+				+ std::string("    -swapendian <inputFilename> <outputFilename> - changes the endian-ness of a rec file\n")
+				+ std::string("    -tobinary <inputFilename> <outputFilename> - converts an XML test case to a binary test case that loads without parsing\n")
+				+ std::string("    -scale <inputFilename> <outputFilename> - writes a scaled and/or tiled copy of an XML test case;\n")
+				+ std::string("          use with -scaleFactor <factor>, -tiles <numX> <numZ>, -tileSpacing <meters>, or -numAgents <minimum number of agents>\n"));
 		}
 
 	}
@@ -9,8 +9,15 @@
 
 #include <algorithm>
 #include <cctype>
+#include <thread>
+#include <atomic>
+#include <cstring>
 
 #include "UnitTest.h"
+#include "LogManager.h"
+#include "BinaryLogger.h"
+#include "benchmarking/BayesianFilter.h"
+#include "core/SteerSimSession.h"
 
 using namespace SteerLib;
 using namespace Util;
@@ -26,6 +33,30 @@ void runUnitTest(const std::string & unitTestName)
 		ThreadPoolTest threadPoolTest;
 		threadPoolTest.runTest();
 	}
+	else if (caseInsensitiveTestName == "taskscheduler") {
+		TaskSchedulerTest taskSchedulerTest;
+		taskSchedulerTest.runTest();
+	}
+	else if (caseInsensitiveTestName == "bayesianfilter") {
+		BayesianFilterTest bayesianFilterTest;
+		bayesianFilterTest.runTest();
+	}
+	else if (caseInsensitiveTestName == "fixedmatrix") {
+		FixedMatrixTest fixedMatrixTest;
+		fixedMatrixTest.runTest();
+	}
+	else if (caseInsensitiveTestName == "metricscollector") {
+		MetricsCollectorTest metricsCollectorTest;
+		metricsCollectorTest.runTest();
+	}
+	else if (caseInsensitiveTestName == "steersimsession") {
+		SteerSimSessionTest steerSimSessionTest;
+		steerSimSessionTest.runTest();
+	}
+	else if (caseInsensitiveTestName == "checkpoint") {
+		CheckpointTest checkpointTest;
+		checkpointTest.runTest();
+	}
 	else if (caseInsensitiveTestName == "timing") {
 		TimingTest timingTest;
 		timingTest.runTest();
@@ -38,6 +69,18 @@ void runUnitTest(const std::string & unitTestName)
 		StateMachineTest FSMTest;
 		FSMTest.runTest();
 	}
+	else if (caseInsensitiveTestName == "logmanager") {
+		LogManagerTest logManagerTest;
+		logManagerTest.runTest();
+	}
+	else if (caseInsensitiveTestName == "binarylogger") {
+		BinaryLoggerTest binaryLoggerTest;
+		binaryLoggerTest.runTest();
+	}
+	else if (caseInsensitiveTestName == "testcasescaler") {
+		TestCaseScalerTest testCaseScalerTest;
+		testCaseScalerTest.runTest();
+	}
 	else {
 		throw GenericException("Unknown name for unit test, \"" + unitTestName + "\"");
 	}
@@ -246,6 +289,994 @@ void ThreadPoolTest::runTest()
 
 
 
+// toString() takes its argument by reference, so the constants need definitions.
+const unsigned int TaskSchedulerTest::MAX_NUM_THREADS;
+const unsigned int TaskSchedulerTest::NUM_TASKS;
+
+
+void TaskSchedulerTest::runTest()
+{
+	for (unsigned int numThreads = 1; numThreads <= MAX_NUM_THREADS; numThreads *= 2) {
+		std::cout << "Testing with " << numThreads << " threads...\n";
+		TaskScheduler scheduler(numThreads);
+		if (scheduler.getNumThreads() != numThreads) {
+			throw GenericException("FAILED: the scheduler has " + toString(scheduler.getNumThreads()) + " threads instead of " + toString(numThreads) + ".");
+		}
+
+		_testParallelForChunks(scheduler, 0, 0, 0);
+		_testParallelForChunks(scheduler, 0, 1, 0);
+		_testParallelForChunks(scheduler, 0, 10, 0);
+		_testParallelForChunks(scheduler, 0, 1000, 0);
+		_testParallelForChunks(scheduler, 5, 1005, 1);
+		_testParallelForChunks(scheduler, 5, 1005, 7);
+		_testParallelForChunks(scheduler, 5, 1005, 1000);
+		_testParallelForChunks(scheduler, 5, 1005, 5000);
+		_testParallelForChunks(scheduler, 100, 100000, 0);
+
+		_testTaskGroupJoin(scheduler);
+		_testExceptions(scheduler);
+	}
+
+	std::cout << "PASSED.\n";
+}
+
+
+void TaskSchedulerTest::_testParallelForChunks(TaskScheduler & scheduler, size_t begin, size_t end, size_t grainSize)
+{
+	std::string range = "[" + toString(begin) + ", " + toString(end) + ") with grain size " + toString(grainSize);
+	size_t numChunks = TaskScheduler::getNumChunks(begin, end, grainSize);
+	size_t chunkSize = TaskScheduler::getChunkSize(begin, end, grainSize);
+
+	// each chunk writes only to its own entries, so no locking is needed.
+	std::vector<size_t> chunkEnds(end - begin, 0);
+	std::vector<unsigned int> timesVisited(end - begin, 0);
+	scheduler.parallelFor(begin, end, grainSize, [&](size_t first, size_t last) {
+		chunkEnds[first - begin] = last;
+		for (size_t i = first; i < last; i++) {
+			timesVisited[i - begin]++;
+		}
+	});
+
+	for (size_t i = 0; i < timesVisited.size(); i++) {
+		if (timesVisited[i] != 1) {
+			throw GenericException("FAILED: parallelFor over " + range + " visited index " + toString(begin + i) + " " + toString(timesVisited[i]) + " times.");
+		}
+	}
+
+	// the chunks must be exactly the ones given by getNumChunks() and getChunkSize().
+	size_t chunksFound = 0;
+	size_t first = begin;
+	while (first < end) {
+		size_t expectedLast = std::min(first + chunkSize, end);
+		if (chunkEnds[first - begin] != expectedLast) {
+			throw GenericException("FAILED: parallelFor over " + range + " did not run the chunk [" + toString(first) + ", " + toString(expectedLast) + ").");
+		}
+		chunksFound++;
+		first = expectedLast;
+	}
+	if (chunksFound != numChunks) {
+		throw GenericException("FAILED: parallelFor over " + range + " ran " + toString(chunksFound) + " chunks, but getNumChunks() returns " + toString(numChunks) + ".");
+	}
+	if ((grainSize == 0) && (numChunks > DEFAULT_NUM_PARALLEL_FOR_CHUNKS)) {
+		throw GenericException("FAILED: parallelFor over " + range + " ran more than DEFAULT_NUM_PARALLEL_FOR_CHUNKS chunks.");
+	}
+}
+
+
+void TaskSchedulerTest::_testTaskGroupJoin(TaskScheduler & scheduler)
+{
+	std::atomic<unsigned int> numTasksDone(0);
+	std::vector<unsigned int> results(NUM_TASKS, 0);
+
+	TaskGroup group(scheduler);
+	for (unsigned int i = 0; i < NUM_TASKS; i++) {
+		group.run([&, i]() {
+			if (i % 2 == 0) {
+				// spawn a task into the same group; wait() must also wait for it.
+				group.run([&, i]() {
+					results[i] = i + 1;
+					numTasksDone++;
+				});
+			}
+			else {
+				// wait for a group of its own, while other tasks are still queued.
+				TaskGroup innerGroup(scheduler);
+				std::atomic<unsigned int> innerResult(0);
+				for (unsigned int j = 0; j < 4; j++) {
+					innerGroup.run([&innerResult]() { innerResult++; });
+				}
+				innerGroup.wait();
+				results[i] = i + innerResult;
+				numTasksDone++;
+			}
+		});
+	}
+	group.wait();
+
+	if (numTasksDone != NUM_TASKS) {
+		throw GenericException("FAILED: TaskGroup::wait() returned after " + toString(numTasksDone.load()) + " of " + toString(NUM_TASKS) + " tasks.");
+	}
+	for (unsigned int i = 0; i < NUM_TASKS; i++) {
+		unsigned int expected = (i % 2 == 0) ? (i + 1) : (i + 4);
+		if (results[i] != expected) {
+			throw GenericException("FAILED: task " + toString(i) + " computed " + toString(results[i]) + " instead of " + toString(expected) + ".");
+		}
+	}
+
+	// a group can be used again after wait().
+	group.run([&numTasksDone]() { numTasksDone++; });
+	group.wait();
+	if (numTasksDone != NUM_TASKS + 1) {
+		throw GenericException("FAILED: a task spawned after TaskGroup::wait() did not run.");
+	}
+}
+
+
+void TaskSchedulerTest::_testExceptions(TaskScheduler & scheduler)
+{
+	// several tasks throw; wait() re-throws the exception of the first one spawned, after all tasks ran.
+	{
+		std::atomic<unsigned int> numTasksRun(0);
+		TaskGroup group(scheduler);
+		for (unsigned int i = 0; i < NUM_TASKS; i++) {
+			group.run([&numTasksRun, i]() {
+				numTasksRun++;
+				if ((i == 37) || (i == 500) || (i == NUM_TASKS - 1)) {
+					throw GenericException("task " + toString(i));
+				}
+			});
+		}
+		std::string message;
+		try {
+			group.wait();
+		}
+		catch (std::exception & e) {
+			message = e.what();
+		}
+		if (message != "task 37") {
+			throw GenericException("FAILED: TaskGroup::wait() re-threw \"" + message + "\" instead of the exception of task 37.");
+		}
+		if (numTasksRun != NUM_TASKS) {
+			throw GenericException("FAILED: only " + toString(numTasksRun.load()) + " of " + toString(NUM_TASKS) + " tasks ran before TaskGroup::wait() re-threw an exception.");
+		}
+		// the exception is re-thrown only once.
+		group.wait();
+	}
+
+	// several chunks throw; parallelFor() re-throws the exception of the first chunk, after all chunks ran.
+	{
+		std::vector<unsigned int> timesVisited(NUM_TASKS, 0);
+		std::string message;
+		try {
+			scheduler.parallelFor(0, NUM_TASKS, 10, [&timesVisited](size_t first, size_t last) {
+				for (size_t i = first; i < last; i++) {
+					timesVisited[i]++;
+				}
+				if ((first == 100) || (first == 1000)) {
+					throw GenericException("chunk " + toString(first));
+				}
+			});
+		}
+		catch (std::exception & e) {
+			message = e.what();
+		}
+		if (message != "chunk 100") {
+			throw GenericException("FAILED: parallelFor() re-threw \"" + message + "\" instead of the exception of chunk 100.");
+		}
+		for (unsigned int i = 0; i < NUM_TASKS; i++) {
+			if (timesVisited[i] != 1) {
+				throw GenericException("FAILED: parallelFor() visited index " + toString(i) + " " + toString(timesVisited[i]) + " times when chunks threw exceptions.");
+			}
+		}
+	}
+}
+
+
+
+// toString() takes its argument by reference, so the constants need definitions.
+const unsigned int BayesianFilterTest::MAX_NUM_THREADS;
+const unsigned int BayesianFilterTest::NUM_PARTICLES;
+const unsigned int BayesianFilterTest::NUM_STEPS;
+const unsigned int BayesianFilterTest::SEED;
+
+
+void BayesianFilterTest::runTest()
+{
+	std::cout << "Test 1: particle filter...\n";
+	_testParticleFilter(false);
+	_testParticleFilter(true);
+
+	std::cout << "Test 2: unscented Kalman filter...\n";
+	_testUnscentedKalmanFilter();
+
+	std::cout << "Test 3: resampling...\n";
+	{
+		MTRand rng(SEED);
+		std::vector<double> weights(NUM_PARTICLES);
+		double sum = 0;
+		for (size_t i = 0; i < weights.size(); i++) {
+			weights[i] = rng.rand();
+			sum += weights[i];
+		}
+		for (size_t i = 0; i < weights.size(); i++) {
+			weights[i] /= sum;
+		}
+		_testResample(weights);
+
+		// most of the weight on a few particles, and many particles without weight.
+		for (size_t i = 0; i < weights.size(); i++) {
+			weights[i] = (i % 97 == 3) ? 0.5 : 0.0;
+		}
+		weights[NUM_PARTICLES - 1] = 0.25;
+		sum = 0;
+		for (size_t i = 0; i < weights.size(); i++) {
+			sum += weights[i];
+		}
+		for (size_t i = 0; i < weights.size(); i++) {
+			weights[i] /= sum;
+		}
+		_testResample(weights);
+	}
+
+	std::cout << "PASSED.\n";
+}
+
+
+Matrix BayesianFilterTest::_dynamics(const Matrix & x, const Matrix & u, const Matrix & m)
+{
+	Matrix y(x.numRows());
+	for (size_t i = 0; i < x.numRows(); i++) {
+		y[i] = x[i] + 0.05 * sin(x[i]) + u[i] + 0.1 * m[i];
+	}
+	return y;
+}
+
+
+Matrix BayesianFilterTest::_measurement(const Matrix & x, const Matrix & n)
+{
+	Matrix z(x.numRows());
+	for (size_t i = 0; i < x.numRows(); i++) {
+		z[i] = x[i] + 0.01 * x[i] * x[i] + 0.2 * n[i];
+	}
+	return z;
+}
+
+
+Matrix BayesianFilterTest::_measurementWithoutNoise(const Matrix & x)
+{
+	return _measurement(x, zeros(x.numRows()));
+}
+
+
+void BayesianFilterTest::_testParticleFilter(bool additiveNoise)
+{
+	const size_t xDim = 4;
+	std::string name = additiveNoise ? "particleFilter() with additive measurement noise" : "particleFilter()";
+
+	MTRand initRng(SEED + 1);
+	std::vector<Matrix> initialX(NUM_PARTICLES);
+	for (size_t i = 0; i < initialX.size(); i++) {
+		initialX[i] = Util::sampleGaussian(xDim, initRng);
+	}
+	std::vector<double> initialW(NUM_PARTICLES, 1.0 / NUM_PARTICLES);
+	Matrix u(xDim), N = 0.04 * m_identity(xDim);
+	for (size_t j = 0; j < xDim; j++) {
+		u[j] = 0.01 * j;
+	}
+
+	// numThreads == 0 is the reference, without a scheduler.
+	std::vector<Matrix> referenceX;
+	std::vector<double> referenceW;
+	for (unsigned int numThreads = 0; numThreads <= MAX_NUM_THREADS; numThreads = (numThreads == 0) ? 1 : numThreads * 2) {
+		TaskScheduler * scheduler = (numThreads == 0) ? NULL : new TaskScheduler(numThreads);
+		std::vector<Matrix> X = initialX;
+		std::vector<double> W = initialW;
+		MTRand rng(SEED);
+		for (unsigned int step = 0; step < NUM_STEPS; step++) {
+			Matrix z(xDim);
+			for (size_t j = 0; j < xDim; j++) {
+				z[j] = 0.1 * step + 0.2 * j;
+			}
+			if (additiveNoise) {
+				Util::particleFilter(X, W, u, z, xDim, _dynamics, _measurementWithoutNoise, N, scheduler, rng);
+			}
+			else {
+				Util::particleFilter(X, W, u, z, xDim, _dynamics, xDim, _measurement, scheduler, rng);
+			}
+		}
+		delete scheduler;
+
+		if (numThreads == 0) {
+			referenceX = X;
+			referenceW = W;
+			continue;
+		}
+		for (size_t i = 0; i < X.size(); i++) {
+			_checkIdentical(referenceX[i], X[i], name + " particle " + toString(i) + " with " + toString(numThreads) + " threads");
+			if (W[i] != referenceW[i]) {
+				throw GenericException("FAILED: " + name + " weight " + toString(i) + " with " + toString(numThreads) + " threads differs from the weight without a scheduler.");
+			}
+		}
+	}
+}
+
+
+void BayesianFilterTest::_testUnscentedKalmanFilter()
+{
+	// enough dimensions that the sigma points span several chunks.
+	const size_t xDim = 20;
+	MTRand initRng(SEED + 2);
+	Matrix initialXHat = Util::sampleGaussian(xDim, initRng);
+	Matrix initialSigma = m_identity(xDim);
+	Matrix u = zeros(xDim);
+	Matrix z = Util::sampleGaussian(xDim, initRng);
+
+	Matrix referenceXHat[3], referenceSigma[3];
+	for (unsigned int numThreads = 0; numThreads <= MAX_NUM_THREADS; numThreads = (numThreads == 0) ? 1 : numThreads * 2) {
+		TaskScheduler * scheduler = (numThreads == 0) ? NULL : new TaskScheduler(numThreads);
+		Matrix xHat[3], Sigma[3];
+		for (unsigned int k = 0; k < 3; k++) {
+			xHat[k] = initialXHat;
+			Sigma[k] = initialSigma;
+		}
+		Util::unscentedKalmanFilter(xHat[0], Sigma[0], u, z, xDim, _dynamics, xDim, _measurement, Util::DEFAULTALPHA, Util::DEFAULTBETA, Util::DEFAULTKAPPA, scheduler);
+		Util::ukfControlUpdate(xHat[1], Sigma[1], u, xDim, _dynamics, Util::DEFAULTALPHA, Util::DEFAULTBETA, Util::DEFAULTKAPPA, scheduler);
+		Util::ukfMeasurementUpdate(xHat[2], Sigma[2], z, xDim, _measurement, Util::DEFAULTALPHA, Util::DEFAULTBETA, Util::DEFAULTKAPPA, scheduler);
+		delete scheduler;
+
+		const char * names[3] = { "unscentedKalmanFilter()", "ukfControlUpdate()", "ukfMeasurementUpdate()" };
+		for (unsigned int k = 0; k < 3; k++) {
+			if (numThreads == 0) {
+				referenceXHat[k] = xHat[k];
+				referenceSigma[k] = Sigma[k];
+				continue;
+			}
+			_checkIdentical(referenceXHat[k], xHat[k], std::string(names[k]) + " mean with " + toString(numThreads) + " threads");
+			_checkIdentical(referenceSigma[k], Sigma[k], std::string(names[k]) + " variance with " + toString(numThreads) + " threads");
+		}
+	}
+}
+
+
+void BayesianFilterTest::_testResample(const std::vector<double> & weights)
+{
+	// particle i is the 1x1 matrix i, so the resampled particles tell which ones were picked.
+	std::vector<Matrix> initialX(weights.size());
+	for (size_t i = 0; i < initialX.size(); i++) {
+		initialX[i] = Matrix(1);
+		initialX[i][0] = (double)i;
+	}
+	double avW = 1.0 / weights.size();
+
+	// the serial version draws its offset with rand().
+	{
+		srand(SEED);
+		double r = Util::mrandom() * avW;
+		std::vector<size_t> expected = _sequentialComb(weights, r);
+		std::vector<Matrix> X = initialX;
+		std::vector<double> W = weights;
+		srand(SEED);
+		Util::resample(X, W);
+		for (size_t j = 0; j < X.size(); j++) {
+			if (X[j][0] != (double)expected[j]) {
+				throw GenericException("FAILED: the serial resample() picked particle " + toString(X[j][0]) + " instead of " + toString(expected[j]) + " for tooth " + toString(j) + ".");
+			}
+		}
+	}
+
+	// the parallel version draws its offset from the MTRand.
+	MTRand offsetRng(SEED);
+	std::vector<size_t> expected = _sequentialComb(weights, offsetRng.rand() * avW);
+	for (unsigned int numThreads = 0; numThreads <= MAX_NUM_THREADS; numThreads = (numThreads == 0) ? 1 : numThreads * 2) {
+		TaskScheduler * scheduler = (numThreads == 0) ? NULL : new TaskScheduler(numThreads);
+		std::vector<Matrix> X = initialX;
+		std::vector<double> W = weights;
+		MTRand rng(SEED);
+		Util::resample(X, W, scheduler, rng);
+		delete scheduler;
+
+		for (size_t j = 0; j < X.size(); j++) {
+			if (X[j][0] != (double)expected[j]) {
+				throw GenericException("FAILED: the parallel resample() with " + toString(numThreads) + " threads picked particle " + toString(X[j][0]) + " instead of " + toString(expected[j]) + " for tooth " + toString(j) + ".");
+			}
+			if (W[j] != avW) {
+				throw GenericException("FAILED: the parallel resample() did not reset the weights.");
+			}
+		}
+	}
+}
+
+
+std::vector<size_t> BayesianFilterTest::_sequentialComb(const std::vector<double> & weights, double r)
+{
+	std::vector<size_t> picked(weights.size());
+	double avW = 1.0 / weights.size();
+	size_t i = 0;
+	double c = weights[0];
+	for (size_t j = 0; j < weights.size(); j++) {
+		double U = r + j*avW;
+		// teeth that rounding leaves past the last running sum pick the last particle.
+		while (U > c && i + 1 < weights.size()) {
+			++i;
+			c += weights[i];
+		}
+		picked[j] = i;
+	}
+	return picked;
+}
+
+
+void BayesianFilterTest::_checkIdentical(const Matrix & expected, const Matrix & actual, const std::string & what)
+{
+	if ((expected.numRows() != actual.numRows()) || (expected.numColumns() != actual.numColumns())) {
+		throw GenericException("FAILED: " + what + " has the wrong size.");
+	}
+	for (size_t i = 0; i < expected.numRows(); i++) {
+		for (size_t j = 0; j < expected.numColumns(); j++) {
+			if (expected(i,j) != actual(i,j)) {
+				throw GenericException("FAILED: " + what + " differs from the result without a scheduler at (" + toString(i) + "," + toString(j) + "): " + toString(actual(i,j)) + " instead of " + toString(expected(i,j)) + ".");
+			}
+		}
+	}
+}
+
+
+
+/// Throws if a FixedMatrix does not hold the same values as the Matrix computed by the same operation.
+template <size_t R, size_t C>
+static void checkSameAsMatrix(const FixedMatrix<R,C> & fixed, const Matrix & expected, const std::string & what)
+{
+	if ((expected.numRows() != R) || (expected.numColumns() != C)) {
+		throw GenericException("FAILED: the Matrix result of " + what + " is " + toString(expected.numRows()) + "x" + toString(expected.numColumns()) + " instead of " + toString(R) + "x" + toString(C) + ".");
+	}
+	for (size_t i = 0; i < R; i++) {
+		for (size_t j = 0; j < C; j++) {
+			if (fixed(i,j) != expected(i,j)) {
+				throw GenericException("FAILED: " + what + " differs at (" + toString(i) + "," + toString(j) + "): FixedMatrix " + toString(fixed(i,j)) + ", Matrix " + toString(expected(i,j)) + ".");
+			}
+		}
+	}
+}
+
+/// Throws if two scalars computed from a FixedMatrix and from a Matrix differ.
+static void checkSameAsMatrix(double fixed, double expected, const std::string & what)
+{
+	if (fixed != expected) {
+		throw GenericException("FAILED: " + what + " differs: FixedMatrix " + toString(fixed) + ", Matrix " + toString(expected) + ".");
+	}
+}
+
+/// Returns a matrix with uniformly random elements in [-1, 1].
+template <size_t R, size_t C>
+static FixedMatrix<R,C> randomFixedMatrix(MTRand & rng)
+{
+	FixedMatrix<R,C> q;
+	for (size_t i = 0; i < R; i++) {
+		for (size_t j = 0; j < C; j++) {
+			q(i,j) = 2.0 * rng.rand() - 1.0;
+		}
+	}
+	return q;
+}
+
+/// Returns a random symmetric positive definite matrix, like a covariance matrix.
+template <size_t N>
+static FixedMatrix<N,N> randomCovariance(MTRand & rng)
+{
+	FixedMatrix<N,N> q = randomFixedMatrix<N,N>(rng);
+	return q*~q + 0.1*FixedMatrix<N,N>::identity();
+}
+
+
+// toString() takes its argument by reference, so the constants need definitions.
+const unsigned int FixedMatrixTest::NUM_REPEATS;
+const unsigned int FixedMatrixTest::SEED;
+
+
+void FixedMatrixTest::runTest()
+{
+	std::cout << "Test 1: arithmetic...\n";
+	_testArithmetic();
+
+	std::cout << "Test 2: Kalman filter...\n";
+	_testKalmanFilter();
+
+	std::cout << "Test 3: Gaussian sampling and densities...\n";
+	_testGaussian();
+
+	std::cout << "PASSED.\n";
+}
+
+
+void FixedMatrixTest::_testArithmetic()
+{
+	MTRand rng(SEED);
+	for (unsigned int repeat = 0; repeat < NUM_REPEATS; repeat++) {
+		FixedMatrix<4,4> A = randomFixedMatrix<4,4>(rng);
+		FixedMatrix<4,4> B = randomFixedMatrix<4,4>(rng);
+		FixedMatrix<4,2> C = randomFixedMatrix<4,2>(rng);
+		FixedMatrix<4,4> S = randomCovariance<4>(rng);
+		Matrix a = A.toMatrix(), b = B.toMatrix(), c = C.toMatrix(), s = S.toMatrix();
+
+		// conversions
+		Matrix big = zeros(8, 6);
+		C.insertInto(big, 3, 2);
+		checkSameAsMatrix(FixedMatrix<4,2>(big, 3, 2), c, "insertInto() and the constructor from a Matrix block");
+		checkSameAsMatrix(A.subMatrix<2,3>(1, 1), a.subMatrix(1, 1, 2, 3), "subMatrix()");
+
+		checkSameAsMatrix(A + B, a + b, "A + B");
+		checkSameAsMatrix(A - B, a - b, "A - B");
+		checkSameAsMatrix(-A, -a, "-A");
+		checkSameAsMatrix(A * B, a * b, "A * B");
+		checkSameAsMatrix(A * C, a * c, "A * C");
+		checkSameAsMatrix(A * 2.5, a * 2.5, "A * 2.5");
+		checkSameAsMatrix(A / 3.0, a / 3.0, "A / 3");
+		checkSameAsMatrix(~C, ~c, "~C");
+		checkSameAsMatrix(abs(A), abs(a), "abs(A)");
+		checkSameAsMatrix(S % C, s % c, "S % C");
+		checkSameAsMatrix(~C / S, ~c / s, "~C / S");
+		checkSameAsMatrix(!S, !s, "!S");
+		checkSameAsMatrix(det(S), det(s), "det(S)");
+		checkSameAsMatrix(tr(A), tr(a), "tr(A)");
+
+		FixedMatrix<4,4> accumulated = A;
+		Matrix accumulatedMatrix = a;
+		accumulated += B;
+		accumulatedMatrix += b;
+		accumulated -= S;
+		accumulatedMatrix -= s;
+		accumulated *= 0.5;
+		accumulatedMatrix *= 0.5;
+		checkSameAsMatrix(accumulated, accumulatedMatrix, "+=, -= and *=");
+
+		FixedMatrix<4,4> V, D;
+		Matrix v(4,4), d(4,4);
+		jacobi(S, V, D);
+		jacobi(s, v, d);
+		checkSameAsMatrix(V, v, "the eigenvectors of jacobi(S)");
+		checkSameAsMatrix(D, d, "the eigenvalues of jacobi(S)");
+	}
+}
+
+
+void FixedMatrixTest::_testKalmanFilter()
+{
+	MTRand rng(SEED + 1);
+	FixedMatrix<4,4> A = FixedMatrix<4,4>::identity() + 0.1 * randomFixedMatrix<4,4>(rng);
+	FixedMatrix<4,2> B = randomFixedMatrix<4,2>(rng);
+	FixedMatrix<4,4> M = 0.01 * randomCovariance<4>(rng);
+	FixedMatrix<2,4> H = randomFixedMatrix<2,4>(rng);
+	FixedMatrix<2,2> N = 0.1 * randomCovariance<2>(rng);
+	Matrix a = A.toMatrix(), b = B.toMatrix(), m = M.toMatrix(), h = H.toMatrix(), n = N.toMatrix();
+
+	// the full step, and the two separate steps
+	FixedMatrix<4,1> xHat = randomFixedMatrix<4,1>(rng), xHatSteps = xHat;
+	FixedMatrix<4,4> Sigma = randomCovariance<4>(rng), SigmaSteps = Sigma;
+	Matrix xHatMatrix = xHat.toMatrix(), SigmaMatrix = Sigma.toMatrix();
+	for (unsigned int step = 0; step < NUM_REPEATS; step++) {
+		FixedMatrix<2,1> u = randomFixedMatrix<2,1>(rng);
+		FixedMatrix<2,1> z = randomFixedMatrix<2,1>(rng);
+		std::string when = " after step " + toString(step);
+
+		Util::kalmanFilter(xHat, Sigma, u, z, A, B, M, H, N);
+		Util::kfControlUpdate(xHatSteps, SigmaSteps, u, A, B, M);
+		Util::kfMeasurementUpdate(xHatSteps, SigmaSteps, z, H, N);
+		Util::kalmanFilter(xHatMatrix, SigmaMatrix, u.toMatrix(), z.toMatrix(), a, b, m, h, n);
+
+		checkSameAsMatrix(xHat, xHatMatrix, "the mean of kalmanFilter()" + when);
+		checkSameAsMatrix(Sigma, SigmaMatrix, "the variance of kalmanFilter()" + when);
+		checkSameAsMatrix(xHatSteps, xHatMatrix, "the mean of kfControlUpdate() and kfMeasurementUpdate()" + when);
+		checkSameAsMatrix(SigmaSteps, SigmaMatrix, "the variance of kfControlUpdate() and kfMeasurementUpdate()" + when);
+	}
+}
+
+
+void FixedMatrixTest::_testGaussian()
+{
+	MTRand rng(SEED + 2);
+	for (unsigned int repeat = 0; repeat < NUM_REPEATS; repeat++) {
+		FixedMatrix<4,1> mean = randomFixedMatrix<4,1>(rng);
+		FixedMatrix<4,4> var = randomCovariance<4>(rng);
+		FixedMatrix<4,1> x = randomFixedMatrix<4,1>(rng);
+
+		checkSameAsMatrix(Util::pdf(var, x), Util::pdf(var.toMatrix(), x.toMatrix()), "pdf()");
+		checkSameAsMatrix(Util::logpdf(var, x), Util::logpdf(var.toMatrix(), x.toMatrix()), "logpdf()");
+
+		// both versions draw their random numbers with rand().
+		srand(SEED + repeat);
+		FixedMatrix<4,1> sample = Util::sampleGaussian(mean, var);
+		srand(SEED + repeat);
+		Matrix sampleMatrix = Util::sampleGaussian(mean.toMatrix(), var.toMatrix());
+		checkSameAsMatrix(sample, sampleMatrix, "sampleGaussian()");
+
+		srand(SEED + repeat);
+		FixedMatrix<4,1> standardSample = Util::sampleGaussian<4>();
+		srand(SEED + repeat);
+		checkSameAsMatrix(standardSample, Util::sampleGaussian(4), "sampleGaussian<4>()");
+	}
+}
+
+
+
+// toString() takes its argument by reference, so the constants need definitions.
+const unsigned int MetricsCollectorTest::MAX_NUM_THREADS;
+const unsigned int MetricsCollectorTest::NUM_FRAMES;
+
+
+void MetricsCollectorTest::runTest()
+{
+	const std::string recFilename = "metricsCollectorTest.rec";
+	_writeRecFile(recFilename);
+
+	// engines[0] updates the metrics on one thread, engines[i] on i+1 threads.
+	std::vector<BenchmarkTechniqueInterface*> techniques;
+	std::vector<BenchmarkEngine*> engines;
+	for (unsigned int i = 0; i < MAX_NUM_THREADS; i++) {
+		techniques.push_back(createBenchmarkTechnique("composite02"));
+		engines.push_back(new BenchmarkEngine(recFilename, techniques[i], i + 1));
+	}
+
+	std::cout << "Comparing the metrics of " << NUM_AGENTS << " agents with 1 to " << MAX_NUM_THREADS << " threads...\n";
+	unsigned int numCollisions = 0;
+	while (!engines[0]->isDone()) {
+		for (unsigned int i = 0; i < MAX_NUM_THREADS; i++) {
+			engines[i]->stepOneFrame();
+		}
+		for (unsigned int a = 0; a < NUM_AGENTS; a++) {
+			AgentMetricsCollector * expected = engines[0]->getAgentMetricsCollector(a);
+			for (unsigned int i = 1; i < MAX_NUM_THREADS; i++) {
+				AgentMetricsCollector * actual = engines[i]->getAgentMetricsCollector(a);
+				// AgentMetrics only holds floats and unsigned ints, so identical metrics have identical bytes.
+				if ((memcmp(expected->getCurrentMetrics(), actual->getCurrentMetrics(), sizeof(AgentMetrics)) != 0)
+					|| (expected->getNumTotalCollisions() != actual->getNumTotalCollisions())) {
+					throw GenericException("FAILED: with " + toString(i + 1) + " threads, the metrics of agent " + toString(a) + " differ at frame " + toString(engines[0]->currentFrameNumber()) + ".");
+				}
+			}
+		}
+	}
+	for (unsigned int a = 0; a < NUM_AGENTS; a++) {
+		numCollisions += (unsigned int)engines[0]->getAgentMetricsCollector(a)->getNumTotalCollisions();
+	}
+	std::cout << "  " << numCollisions << " collisions in " << engines[0]->currentFrameNumber() << " frames\n";
+	if (numCollisions == 0) {
+		throw GenericException("FAILED: the agents of the test rec file never collided.");
+	}
+
+	for (unsigned int i = 1; i < MAX_NUM_THREADS; i++) {
+		if (engines[i]->getTotalBenchmarkScore() != engines[0]->getTotalBenchmarkScore()) {
+			throw GenericException("FAILED: with " + toString(i + 1) + " threads, the total score is " + toString(engines[i]->getTotalBenchmarkScore()) + " instead of " + toString(engines[0]->getTotalBenchmarkScore()) + ".");
+		}
+	}
+
+	for (unsigned int i = 0; i < MAX_NUM_THREADS; i++) {
+		delete engines[i];
+		destroyBenchmarkTechnique(techniques[i]);
+	}
+	std::remove(recFilename.c_str());
+
+	std::cout << "PASSED.\n";
+}
+
+
+void MetricsCollectorTest::_writeRecFile(const std::string & filename)
+{
+	const float worldSize = 40.0f;
+	const float dt = 0.05f;
+	const float radius = 0.5f;
+
+	MTRand rng(SEED);
+	std::vector<Point> positions(NUM_AGENTS);
+	std::vector<Vector> velocities(NUM_AGENTS);
+	for (unsigned int a = 0; a < NUM_AGENTS; a++) {
+		positions[a] = Point((float)rng.rand(worldSize) - 0.5f*worldSize, 0.0f, (float)rng.rand(worldSize) - 0.5f*worldSize);
+		velocities[a] = Vector((float)rng.rand(2.0) - 1.0f, 0.0f, (float)rng.rand(2.0) - 1.0f);
+	}
+
+	RecFileWriter writer;
+	writer.startRecording(NUM_AGENTS, filename);
+	writer.addObstacleBoundingBox(-2.0f, 2.0f, 0.0f, 1.0f, -2.0f, 2.0f);
+	writer.addObstacleBoundingBox(-10.0f, -8.0f, 0.0f, 1.0f, 5.0f, 12.0f);
+	writer.addObstacleBoundingBox(6.0f, 12.0f, 0.0f, 1.0f, -9.0f, -7.0f);
+
+	for (unsigned int frame = 0; frame < NUM_FRAMES; frame++) {
+		writer.startFrame(frame * dt, (frame == 0) ? 0.0f : dt);
+		for (unsigned int a = 0; a < NUM_AGENTS; a++) {
+			if (frame > 0) {
+				// a damped random walk that bounces off the edges of the world.
+				velocities[a] = 0.9f * velocities[a] + Vector((float)rng.rand(1.0) - 0.5f, 0.0f, (float)rng.rand(1.0) - 0.5f);
+				positions[a] = positions[a] + dt * velocities[a];
+				if (fabsf(positions[a].x) > 0.5f*worldSize) velocities[a].x = -velocities[a].x;
+				if (fabsf(positions[a].z) > 0.5f*worldSize) velocities[a].z = -velocities[a].z;
+			}
+			Vector dir = (velocities[a].lengthSquared() > 0.0f) ? normalize(velocities[a]) : Vector(1.0f, 0.0f, 0.0f);
+			// agents that are disabled for a while are skipped by the metrics update.
+			bool enabled = ((a % 7) != 0) || ((frame / 20) % 2 == 0);
+			writer.setAgentInfoForCurrentFrame(a, positions[a], dir, Point(0.0f, 0.0f, 0.0f), radius, enabled);
+		}
+		writer.finishFrame();
+	}
+	writer.finishRecording();
+}
+
+
+// toString() takes its argument by reference, so the constants need definitions.
+const unsigned int SteerSimSessionTest::NUM_RUNS;
+const unsigned int SteerSimSessionTest::NUM_FRAMES;
+
+/// The test case simulated by SteerSimSessionTest; agents leave through the exits, so they are removed from the spatial database during each run.
+#define STEERSIM_SESSION_TEST_CASE "bottleneck-evacuationSmall.xml"
+#define STEERSIM_SESSION_TEST_REC_FILE "steerSimSessionTest.rec"
+
+
+void SteerSimSessionTest::runTest()
+{
+	const char * aiModuleNames[] = { "sfAI", "rvo2AI", "pprAI", "simpleAI" };
+	for (unsigned int m = 0; m < sizeof(aiModuleNames) / sizeof(aiModuleNames[0]); m++) {
+		std::string aiModuleName = aiModuleNames[m];
+		std::cout << "Test " << m+1 << ": " << NUM_RUNS << " runs of one session with " << aiModuleName << "...\n";
+
+		SteerSimSession * session = _createSession(aiModuleName, "");
+		std::vector<RecordedFrame> firstRun = _runAndReadRecording(session);
+		if (firstRun.size() != NUM_FRAMES + 1) {
+			delete session;
+			throw GenericException("FAILED: the first run with " + aiModuleName + " recorded " + toString(firstRun.size()) + " frames instead of " + toString(NUM_FRAMES+1) + ".");
+		}
+		for (unsigned int run = 1; run < NUM_RUNS; run++) {
+			if (run == NUM_RUNS - 1) {
+				// re-initializing the module with the options it already has must not change the results either.
+				session->reset(aiModuleName, "");
+			}
+			if (!_isSameRecording(firstRun, _runAndReadRecording(session))) {
+				delete session;
+				throw GenericException("FAILED: run " + toString(run+1) + " with " + aiModuleName + " did not record the same frames as the first run.");
+			}
+		}
+
+		if (aiModuleName == "sfAI") {
+			std::cout << "Test " << m+1 << "b: reset() with a different sf_agent_a...\n";
+			session->reset(aiModuleName, "sf_agent_a=50");
+			std::vector<RecordedFrame> resetRun = _runAndReadRecording(session);
+			delete session;
+
+			if (_isSameRecording(firstRun, resetRun)) {
+				throw GenericException("FAILED: changing sf_agent_a with reset() did not change the simulation.");
+			}
+			session = _createSession(aiModuleName, "sf_agent_a=50");
+			if (!_isSameRecording(resetRun, _runAndReadRecording(session))) {
+				delete session;
+				throw GenericException("FAILED: after reset(), sfAI did not record the same frames as a new session with the same options.");
+			}
+		}
+		delete session;
+	}
+
+	std::remove(STEERSIM_SESSION_TEST_REC_FILE);
+	std::cout << "PASSED.\n";
+}
+
+
+SteerSimSession * SteerSimSessionTest::_createSession(const std::string & aiModuleName, const std::string & moduleOptions)
+{
+	std::vector<std::string> args;
+	args.push_back("steertool");
+	args.push_back("-commandline");
+	args.push_back("-testcase");
+	args.push_back(STEERSIM_SESSION_TEST_CASE);
+	args.push_back("-ai");
+	args.push_back(aiModuleName);
+	args.push_back("-numFrames");
+	args.push_back(toString(NUM_FRAMES));
+	args.push_back("-storesimulation");
+	args.push_back(STEERSIM_SESSION_TEST_REC_FILE);
+	if (moduleOptions != "") {
+		args.push_back("-module");
+		args.push_back(aiModuleName + "," + moduleOptions);
+	}
+
+	std::vector<char*> argv;
+	for (unsigned int i = 0; i < args.size(); i++) {
+		argv.push_back(const_cast<char*>(args[i].c_str()));
+	}
+	return new SteerSimSession((int)argv.size(), &argv[0]);
+}
+
+
+std::vector<SteerSimSessionTest::RecordedFrame> SteerSimSessionTest::_runAndReadRecording(SteerSimSession * session)
+{
+	session->run();
+
+	// copy the frames, the next run overwrites the rec file.
+	RecFileReader reader(STEERSIM_SESSION_TEST_REC_FILE);
+	std::vector<RecordedFrame> frames(reader.getNumFrames());
+	for (unsigned int frame = 0; frame < frames.size(); frame++) {
+		RecFileFrameView view = reader.getFrameView(frame);
+		for (unsigned int a = 0; a < view.numAgents; a++) {
+			frames[frame].push_back(view[a]);
+		}
+	}
+	reader.close();
+	return frames;
+}
+
+
+bool SteerSimSessionTest::_isSameRecording(const std::vector<RecordedFrame> & first, const std::vector<RecordedFrame> & second)
+{
+	if (first.size() != second.size()) {
+		return false;
+	}
+	for (unsigned int frame = 0; frame < first.size(); frame++) {
+		if (first[frame].size() != second[frame].size()) {
+			return false;
+		}
+		// compare field by field, the padding bytes of the records are not initialized.
+		for (unsigned int a = 0; a < first[frame].size(); a++) {
+			const RecFileAgentInfo & x = first[frame][a];
+			const RecFileAgentInfo & y = second[frame][a];
+			if ((x.enabled != y.enabled) || (x.radius != y.radius)
+				|| (x.pos.x != y.pos.x) || (x.pos.y != y.pos.y) || (x.pos.z != y.pos.z)
+				|| (x.dir.x != y.dir.x) || (x.dir.y != y.dir.y) || (x.dir.z != y.dir.z)
+				|| (x.goal.x != y.goal.x) || (x.goal.y != y.goal.y) || (x.goal.z != y.goal.z)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+
+// toString() takes its argument by reference, so the constants need definitions.
+const unsigned int CheckpointTest::NUM_FRAMES;
+const unsigned int CheckpointTest::CHECKPOINT_FRAME;
+
+/// The test case simulated by CheckpointTest; agents leave through the exits, so they are disabled at different frames.
+#define CHECKPOINT_TEST_CASE "bottleneck-evacuationSmall.xml"
+
+
+void CheckpointTest::runTest()
+{
+	std::cout << "Test 1: " << NUM_FRAMES << " frames without a checkpoint...\n";
+	std::vector<Frame> uninterrupted;
+	std::vector<TrajectorySink::PositionList> uninterruptedTrajectories;
+	{
+		SimulationOptions options;
+		SimulationEngine * engine = _createEngine(options, "checkpointTest0.trj");
+		_simulate(engine, NUM_FRAMES, uninterrupted);
+		uninterruptedTrajectories = _readTrajectories(engine);
+		_destroyEngine(engine);
+	}
+	if (uninterrupted.size() <= CHECKPOINT_FRAME) {
+		throw GenericException("FAILED: the simulation ended after " + toString(uninterrupted.size()) + " frames, before the checkpoint at frame " + toString(CHECKPOINT_FRAME) + ".");
+	}
+
+	std::cout << "Test 2: rewind to frame " << CHECKPOINT_FRAME << " after running to the end...\n";
+	SimulationCheckpoint checkpoint;
+	{
+		// a csv file, to also cut off text records.
+		SimulationOptions options;
+		SimulationEngine * engine = _createEngine(options, "checkpointTest1.csv");
+		std::vector<Frame> ignored;
+		_simulate(engine, CHECKPOINT_FRAME, ignored);
+		engine->saveCheckpoint(checkpoint);
+		_simulate(engine, NUM_FRAMES, ignored);
+
+		std::vector<Frame> rewound;
+		engine->restoreCheckpoint(checkpoint);
+		_simulate(engine, NUM_FRAMES, rewound);
+		std::vector<TrajectorySink::PositionList> rewoundTrajectories = _readTrajectories(engine);
+		_destroyEngine(engine);
+
+		_checkFrames("the rewound simulation", uninterrupted, rewound);
+		if (rewoundTrajectories.size() != uninterruptedTrajectories.size()) {
+			throw GenericException("FAILED: the rewound simulation streamed the trajectories of " + toString(rewoundTrajectories.size()) + " agents instead of " + toString(uninterruptedTrajectories.size()) + ".");
+		}
+		for (unsigned int a = 0; a < rewoundTrajectories.size(); a++) {
+			if (rewoundTrajectories[a] != uninterruptedTrajectories[a]) {
+				throw GenericException("FAILED: the rewound simulation streamed a different trajectory for agent " + toString(a) + "; " +
+					toString(rewoundTrajectories[a].size()) + " positions instead of " + toString(uninterruptedTrajectories[a].size()) + ".");
+			}
+		}
+	}
+
+	std::cout << "Test 3: fork a new engine at frame " << CHECKPOINT_FRAME << "...\n";
+	{
+		SimulationOptions options;
+		SimulationEngine * engine = _createEngine(options, "checkpointTest2.trj");
+		std::vector<Frame> forked;
+		engine->restoreCheckpoint(checkpoint);
+		_simulate(engine, NUM_FRAMES, forked);
+		_destroyEngine(engine);
+
+		_checkFrames("the forked simulation", uninterrupted, forked);
+	}
+
+	std::remove("checkpointTest0.trj");
+	std::remove("checkpointTest1.csv");
+	std::remove("checkpointTest2.trj");
+	std::cout << "PASSED.\n";
+}
+
+
+SimulationEngine * CheckpointTest::_createEngine(SimulationOptions & options, const std::string & trajectoryFilename)
+{
+	options.moduleOptionsDatabase["testCasePlayer"]["testcase"] = CHECKPOINT_TEST_CASE;
+	options.moduleOptionsDatabase["testCasePlayer"]["ai"] = "pprAI";
+	options.engineOptions.startupModules.insert("testCasePlayer");
+	options.engineOptions.numFramesToSimulate = NUM_FRAMES;
+	options.engineOptions.trajectoryFilename = trajectoryFilename;
+
+	SimulationEngine * engine = new SimulationEngine();
+	engine->init(&options, &_controller);
+	engine->initializeSimulation();
+	engine->preprocessSimulation();
+	return engine;
+}
+
+
+void CheckpointTest::_simulate(SimulationEngine * engine, unsigned int lastFrame, std::vector<Frame> & frames)
+{
+	while ((unsigned int)engine->getNumFramesSimulated() < lastFrame) {
+		bool moreFrames = engine->update(false);
+
+		const std::vector<AgentInterface*> & agents = engine->getAgents();
+		frames.push_back(Frame(agents.size()));
+		for (unsigned int a = 0; a < agents.size(); a++) {
+			AgentFrame & agentFrame = frames.back()[a];
+			agentFrame.enabled = agents[a]->enabled();
+			agentFrame.position = agents[a]->position();
+			agentFrame.forward = agents[a]->forward();
+			agentFrame.velocity = agents[a]->velocity();
+		}
+
+		if (!moreFrames) {
+			break;
+		}
+	}
+}
+
+
+std::vector<TrajectorySink::PositionList> CheckpointTest::_readTrajectories(SimulationEngine * engine)
+{
+	const std::vector<AgentInterface*> & agents = engine->getAgents();
+	std::vector<TrajectorySink::PositionList> trajectories;
+	std::vector<TrajectorySink::PositionList> someTrajectories;
+	while (trajectories.size() < agents.size()) {
+		engine->getTrajectorySink()->readTrajectories(agents, trajectories.size(), someTrajectories);
+		trajectories.insert(trajectories.end(), someTrajectories.begin(), someTrajectories.end());
+	}
+	return trajectories;
+}
+
+
+void CheckpointTest::_destroyEngine(SimulationEngine * engine)
+{
+	engine->postprocessSimulation();
+	engine->cleanupSimulation();
+	engine->finish();
+	delete engine;
+}
+
+
+void CheckpointTest::_checkFrames(const std::string & name, const std::vector<Frame> & uninterrupted, const std::vector<Frame> & frames)
+{
+	if (frames.size() != uninterrupted.size() - CHECKPOINT_FRAME) {
+		throw GenericException("FAILED: " + name + " simulated " + toString(frames.size()) + " frames after the checkpoint instead of " + toString(uninterrupted.size() - CHECKPOINT_FRAME) + ".");
+	}
+	for (unsigned int f = 0; f < frames.size(); f++) {
+		const Frame & expected = uninterrupted[CHECKPOINT_FRAME + f];
+		if (frames[f].size() != expected.size()) {
+			throw GenericException("FAILED: " + name + " has " + toString(frames[f].size()) + " agents in frame " + toString(CHECKPOINT_FRAME + f + 1) + " instead of " + toString(expected.size()) + ".");
+		}
+		for (unsigned int a = 0; a < expected.size(); a++) {
+			const AgentFrame & x = frames[f][a];
+			const AgentFrame & y = expected[a];
+			if ((x.enabled != y.enabled) || !(x.position == y.position) || !(x.forward == y.forward) || !(x.velocity == y.velocity)) {
+				throw GenericException("FAILED: in frame " + toString(CHECKPOINT_FRAME + f + 1) + ", agent " + toString(a) + " of " + name + " differs from the simulation without a checkpoint.");
+			}
+		}
+	}
+}
+
+
 void TimingTest::runTest()
 {
 	unsigned long long ticksPerSecond = getHighResCounterFrequency();
@@ -700,3 +1731,293 @@ unsigned int StateMachineTest::TestFSMCallback::handleUnknownTransition(unsigned
 
 	return currentState;
 }
+
+
+
+void LogManagerTest::runTest()
+{
+	std::cout << "Test 1: loggers of the same name...\n";
+	{
+		LogManager * logManager = LogManager::getInstance();
+		Logger * first = logManager->createLogger("logManagerTest.log", LoggerType::BASIC_WRITE);
+		Logger * second = logManager->createLogger("logManagerTest.log", LoggerType::BASIC_WRITE);
+		if (first->getFileName() != "logManagerTest.log") {
+			throw GenericException("FAILED: the first logger writes to " + first->getFileName() + " instead of logManagerTest.log.");
+		}
+		if (second->getFileName() == first->getFileName()) {
+			throw GenericException("FAILED: two open loggers both write to " + first->getFileName() + ".");
+		}
+		std::cout << "  second logger writes to " << second->getFileName() << "\n";
+
+		logManager->destroyLogger(first);
+		Logger * third = logManager->createLogger("logManagerTest.log", LoggerType::BASIC_WRITE);
+		if (third->getFileName() != "logManagerTest.log") {
+			throw GenericException("FAILED: after destroying its logger, logManagerTest.log was not used again; the new logger writes to " + third->getFileName() + ".");
+		}
+		std::string secondFileName = second->getFileName();
+		logManager->destroyLogger(second);
+		logManager->destroyLogger(third);
+		std::remove("logManagerTest.log");
+		std::remove(secondFileName.c_str());
+	}
+
+	const char * aiModuleNames[] = { "sfAI", "rvo2AI", "pprAI", "simpleAI" };
+	for (unsigned int m = 0; m < sizeof(aiModuleNames) / sizeof(aiModuleNames[0]); m++) {
+		_aiModuleName = aiModuleNames[m];
+		std::cout << "Test " << m+2 << ": " << NUM_ENGINES << " engines with " << _aiModuleName << " on " << NUM_ENGINES << " threads...\n";
+
+		_numEnginesLoaded = 0;
+		std::vector<std::thread> threads;
+		for (unsigned int i = 0; i < NUM_ENGINES; i++) {
+			_logFileNames[i] = "";
+			_errors[i] = "";
+			threads.push_back(std::thread(&LogManagerTest::_runEngine, this, i));
+		}
+		for (unsigned int i = 0; i < NUM_ENGINES; i++) {
+			threads[i].join();
+		}
+
+		for (unsigned int i = 0; i < NUM_ENGINES; i++) {
+			if (_errors[i] != "") {
+				throw GenericException("FAILED: engine " + toString(i) + " with " + _aiModuleName + ": " + _errors[i]);
+			}
+			std::cout << "  engine " << i << " logged to " << _logFileNames[i] << "\n";
+			if (!isExistingFile(_logFileNames[i])) {
+				throw GenericException("FAILED: engine " + toString(i) + " with " + _aiModuleName + " did not write " + _logFileNames[i] + ".");
+			}
+			for (unsigned int j = 0; j < i; j++) {
+				if (_logFileNames[i] == _logFileNames[j]) {
+					throw GenericException("FAILED: engines " + toString(j) + " and " + toString(i) + " with " + _aiModuleName + " both logged to " + _logFileNames[i] + ".");
+				}
+			}
+		}
+		for (unsigned int i = 0; i < NUM_ENGINES; i++) {
+			std::remove(_logFileNames[i].c_str());
+		}
+	}
+
+	std::cout << "PASSED.\n";
+}
+
+
+void LogManagerTest::_runEngine(unsigned int engineIndex)
+{
+	bool loaded = false;
+	try {
+		SimulationOptions options;
+		options.moduleOptionsDatabase["testCasePlayer"]["testcase"] = "3-squeeze.xml";
+		options.moduleOptionsDatabase["testCasePlayer"]["ai"] = _aiModuleName;
+		// every engine asks for the same log file name, so the LogManager has to give each one its own file.
+		options.moduleOptionsDatabase[_aiModuleName]["ailogFileName"] = "logManagerTest_" + _aiModuleName + ".log";
+		options.engineOptions.startupModules.insert("testCasePlayer");
+		options.engineOptions.numFramesToSimulate = NUM_FRAMES;
+
+		TestEngineController controller;
+		SimulationEngine * engine = new SimulationEngine();
+		engine->init(&options, &controller);
+
+		LogData * logData = engine->getModule(_aiModuleName)->getLogData();
+		if (logData->getLogger() == NULL) {
+			logData->release();
+			delete logData;
+			throw GenericException("the " + _aiModuleName + " module did not open a log.");
+		}
+		_logFileNames[engineIndex] = logData->getLogger()->getFileName();
+		// the module still owns its logger and log objects.
+		logData->release();
+		delete logData;
+
+		{
+			std::unique_lock<std::mutex> lock(_lock);
+			loaded = true;
+			_numEnginesLoaded++;
+			_allEnginesLoaded.notify_all();
+			while (_numEnginesLoaded < NUM_ENGINES) {
+				_allEnginesLoaded.wait(lock);
+			}
+		}
+
+		engine->initializeSimulation();
+		engine->preprocessSimulation();
+		while (engine->update(false)) { }
+		engine->postprocessSimulation();
+		engine->cleanupSimulation();
+		engine->finish();
+		delete engine;
+	}
+	catch (std::exception & e) {
+		_errors[engineIndex] = e.what();
+		if (!loaded) {
+			// do not keep the other engines waiting.
+			std::lock_guard<std::mutex> lock(_lock);
+			_numEnginesLoaded++;
+			_allEnginesLoaded.notify_all();
+		}
+	}
+}
+
+
+
+// toString() takes its argument by reference, so the constants need definitions.
+const unsigned int BinaryLoggerTest::NUM_RECORDS;
+
+#define BINARY_LOGGER_TEST_LOG "binaryLoggerTest.log"
+
+
+void BinaryLoggerTest::runTest()
+{
+	std::cout << "Test 1: " << NUM_RECORDS << " records of Integer, Float and LongLong fields...\n";
+	_testRoundTrip(false);
+	std::cout << "Test 2: " << NUM_RECORDS << " records with a String field...\n";
+	_testRoundTrip(true);
+
+	std::remove(BINARY_LOGGER_TEST_LOG);
+	std::cout << "PASSED.\n";
+}
+
+
+void BinaryLoggerTest::_testRoundTrip(bool withStrings)
+{
+	const char * fieldNames[] = { "frame", "speed", "ticks", "name" };
+	DataType fieldTypes[] = { DataType::Integer, DataType::Float, DataType::LongLong, DataType::String };
+	unsigned int numFields = withStrings ? 4 : 3;
+
+	LogManager * logManager = LogManager::getInstance();
+	Logger * writer = logManager->createLogger(BINARY_LOGGER_TEST_LOG, LoggerType::BINARY_WRITE);
+	for (unsigned int f = 0; f < numFields; f++) {
+		writer->addDataField(fieldNames[f], fieldTypes[f]);
+	}
+	// values that need every bit of their type: negative integers, floats with fractions, and 64-bit integers.
+	for (unsigned int r = 0; r < NUM_RECORDS; r++) {
+		LogObject logObject;
+		logObject.addLogData((int)r * 7 - 1000);
+		logObject.addLogData((float)r * 0.25f - 3.5f);
+		logObject.addLogData((long long)r * 3000000007LL);
+		if (withStrings) {
+			DataItem name;
+			name.string = std::string(r % 5, (char)('a' + r % 26));
+			logObject.addLogDataItem(name);
+		}
+		writer->writeLogObject(logObject);
+	}
+	// closes the log, which writes the records still in the buffer.
+	logManager->destroyLogger(writer);
+
+	LogData * logData = logManager->readBinaryLog(BINARY_LOGGER_TEST_LOG);
+	Logger * reader = logData->getLogger();
+	std::string error;
+	if (reader->getNumberOfFields() != numFields) {
+		error = "the log has " + toString(reader->getNumberOfFields()) + " fields instead of " + toString(numFields) + ".";
+	}
+	for (unsigned int f = 0; (error == "") && (f < numFields); f++) {
+		if ((reader->getFieldName(f) != fieldNames[f]) || (reader->getFieldDataType(f) != fieldTypes[f])) {
+			error = "field " + toString(f) + " was read back as " + reader->getFieldName(f) + " of type " + toString((int)reader->getFieldDataType(f)) + ".";
+		}
+	}
+	size_t expectedRecordSize = withStrings ? 0 : sizeof(int) + sizeof(float) + sizeof(long long);
+	if ((error == "") && (dynamic_cast<BinaryLogger*>(reader)->getRecordSize() != expectedRecordSize)) {
+		error = "the record size is " + toString(dynamic_cast<BinaryLogger*>(reader)->getRecordSize()) + " instead of " + toString(expectedRecordSize) + ".";
+	}
+	if ((error == "") && (logData->size() != NUM_RECORDS)) {
+		error = "read " + toString(logData->size()) + " records instead of " + toString(NUM_RECORDS) + ".";
+	}
+	for (unsigned int r = 0; (error == "") && (r < NUM_RECORDS); r++) {
+		LogObject * logObject = logData->getLogDataAt(r);
+		if ((logObject->getRecordSize() != numFields) ||
+			(logObject->getLogData(0).integerData != (int)r * 7 - 1000) ||
+			(logObject->getLogData(1).floatData != (float)r * 0.25f - 3.5f) ||
+			(logObject->getLogData(2).longlongData != (long long)r * 3000000007LL) ||
+			(withStrings && (logObject->getLogData(3).string != std::string(r % 5, (char)('a' + r % 26))))) {
+			error = "record " + toString(r) + " was not read back as it was written.";
+		}
+	}
+	delete logData;
+
+	if (error != "") {
+		throw GenericException("FAILED: " + error);
+	}
+}
+
+
+
+//
+// TestCaseScalerTest
+//
+
+#define TEST_CASE_SCALER_TEST_CASE "simple-emitter.xml"
+#define TEST_CASE_SCALER_TEST_OUTPUT "testCaseScalerTest"
+
+// toString() takes its argument by reference, so the constants need definitions.
+const unsigned int TestCaseScalerTest::NUM_TILES_X;
+const unsigned int TestCaseScalerTest::NUM_TILES_Z;
+
+void TestCaseScalerTest::runTest()
+{
+	SimulationOptions options;
+	TestCaseReader testCase;
+	testCase.readTestCaseFromFile(options.engineOptions.testCaseSearchPath + TEST_CASE_SCALER_TEST_CASE);
+	if (testCase.getNumAgentEmitters() == 0) {
+		throw GenericException("FAILED: the test case " TEST_CASE_SCALER_TEST_CASE " has no agent emitters.");
+	}
+
+	std::cout << "Scaling " << TEST_CASE_SCALER_TEST_CASE << " by 1.5 into " << NUM_TILES_X << "x" << NUM_TILES_Z << " tiles...\n";
+	TestCaseScaler scaler;
+	scaler.scaleTestCase(testCase, 1.5f, NUM_TILES_X, NUM_TILES_Z, 4.0f);
+	scaler.writeTestCaseToFile(TEST_CASE_SCALER_TEST_OUTPUT);
+
+	std::cout << "Reading the scaled test case back...\n";
+	TestCaseReader scaledTestCase;
+	scaledTestCase.readTestCaseFromFile(TEST_CASE_SCALER_TEST_OUTPUT ".xml");
+	std::remove(TEST_CASE_SCALER_TEST_OUTPUT ".xml");
+
+	std::string error;
+	const AxisAlignedBox & bounds = scaler.getWorldBounds();
+	const AxisAlignedBox & readBounds = scaledTestCase.getWorldBounds();
+	if ((fabsf(bounds.xmin - readBounds.xmin) > 0.001f) || (fabsf(bounds.xmax - readBounds.xmax) > 0.001f) ||
+		(fabsf(bounds.zmin - readBounds.zmin) > 0.001f) || (fabsf(bounds.zmax - readBounds.zmax) > 0.001f)) {
+		error = "the world bounds were not read back as they were written.";
+	}
+	if ((error == "") && (scaledTestCase.getNumObstacles() != scaler.getNumObstacles())) {
+		error = "read " + toString(scaledTestCase.getNumObstacles()) + " obstacles instead of " + toString(scaler.getNumObstacles()) + ".";
+	}
+	if ((error == "") && (scaledTestCase.getNumAgents() != scaler.getNumAgents())) {
+		error = "read " + toString(scaledTestCase.getNumAgents()) + " agents instead of " + toString(scaler.getNumAgents()) + ".";
+	}
+	if ((error == "") && (scaledTestCase.getNumAgentEmitters() != scaler.getNumAgentEmitters())) {
+		error = "read " + toString(scaledTestCase.getNumAgentEmitters()) + " agent emitters instead of " + toString(scaler.getNumAgentEmitters()) + ".";
+	}
+	if ((error == "") && (scaler.getNumAgentEmitters() != testCase.getNumAgentEmitters() * NUM_TILES_X * NUM_TILES_Z)) {
+		error = "the scaler made " + toString(scaler.getNumAgentEmitters()) + " agent emitters from " + toString(testCase.getNumAgentEmitters()) + ".";
+	}
+	for (unsigned int i = 0; (error == "") && (i < scaler.getNumAgents()); i++) {
+		error = _compareAgents("agent " + toString(i), scaler.getAgentInitialConditions(i), scaledTestCase.getAgentInitialConditions(i));
+	}
+	for (unsigned int i = 0; (error == "") && (i < scaler.getNumAgentEmitters()); i++) {
+		error = _compareAgents("agent emitter " + toString(i), scaler.getAgentEmitterInitialConditions(i), scaledTestCase.getAgentEmitterInitialConditions(i));
+	}
+
+	if (error != "") {
+		throw GenericException("FAILED: " + error);
+	}
+	std::cout << "PASSED.\n";
+}
+
+
+std::string TestCaseScalerTest::_compareAgents(const std::string & agentName, const AgentInitialConditions & written, const AgentInitialConditions & read)
+{
+	// positions are written with %f, so they are compared with a small tolerance.
+	if ((read.name != written.name) || (fabsf(read.radius - written.radius) > 0.001f) ||
+		(fabsf(read.position.x - written.position.x) > 0.001f) || (fabsf(read.position.z - written.position.z) > 0.001f)) {
+		return agentName + " (" + written.name + ") was read back as " + read.name + " at " + toString(read.position) + " instead of " + toString(written.position) + ".";
+	}
+	if (read.goals.size() != written.goals.size()) {
+		return agentName + " has " + toString(read.goals.size()) + " goals instead of " + toString(written.goals.size()) + ".";
+	}
+	for (unsigned int g = 0; g < written.goals.size(); g++) {
+		if ((fabsf(read.goals[g].targetLocation.x - written.goals[g].targetLocation.x) > 0.001f) ||
+			(fabsf(read.goals[g].targetLocation.z - written.goals[g].targetLocation.z) > 0.001f)) {
+			return "goal " + toString(g) + " of " + agentName + " was read back at " + toString(read.goals[g].targetLocation) + ".";
+		}
+	}
+	return "";
+}
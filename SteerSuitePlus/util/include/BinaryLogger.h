@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+#ifndef __BINARY_LOGGER__
+#define __BINARY_LOGGER__
+
+#include <fstream>
+#include <vector>
+#include <string>
+#include "Logger.h"
+#include "UtilGlobals.h"
+
+/// The size of the write buffer of a BinaryLogger, unless another size is given.
+const size_t DEFAULT_BINARY_LOG_BUFFER_SIZE = 1 << 20;
+
+/**
+ * A Logger that writes and reads log objects in a compact binary format instead of text.
+ *
+ * The file starts with a schema header built from the fields given to addDataField():
+ *   - the magic bytes "SSBLOG" and a 16-bit version number,
+ *   - the number of fields, then for each field its DataType and its name (32-bit length, then the characters),
+ *   - the size in bytes of one record, or 0 if records have variable size because of String fields.
+ *
+ * Every log object is then written as one record: each field in order, as a little-endian 32-bit
+ * int (Integer), 32-bit IEEE float (Float), or 64-bit int (LongLong); a String is a 32-bit length
+ * followed by its characters.  Without String fields, all records have the same size.
+ *
+ * Records are collected in a large buffer and written to the file when the buffer is full, on
+ * flush(), or when the logger is closed or destroyed; unlike the text Logger, the file is not
+ * synced after every record.  The header is written with the first record, so all fields must be
+ * added before that.  Files can be read back with LogManager::readBinaryLog().
+ */
+class UTIL_API BinaryLogger : public Logger
+{
+public:
+	BinaryLogger (const std::string & fileName, LogMode logMode, size_t bufferSize = DEFAULT_BINARY_LOG_BUFFER_SIZE);
+	virtual ~BinaryLogger();
+
+	virtual void addDataField(const std::string &fieldName, DataType dataType);
+
+	/// Writes the schema header; called automatically before the first record is written.
+	virtual void writeMetaData ();
+	/// Reads the schema header; called automatically when the logger is opened in Read mode.
+	virtual void readMetaData ();
+
+	virtual void writeLogObject ( const LogObject & logObject );
+	/// Reads the next record into logObject; does nothing if hasMoreLogObjects() is false.
+	virtual void readNextLogObject ( LogObject & logObject);
+	/// Returns true if another record can be read.
+	bool hasMoreLogObjects ();
+
+	/// Returns the size in bytes of every record, or 0 if records have variable size because of String fields.
+	size_t getRecordSize () const;
+
+	/// Writes all buffered records to the file.
+	virtual void flush ();
+	virtual void closeLog ();
+
+protected:
+	void _writeUnsigned32 (unsigned int value);
+	void _writeUnsigned64 (unsigned long long value);
+	void _writeBytes (const char * bytes, size_t numBytes);
+	bool _readUnsigned32 (unsigned int & value);
+	bool _readUnsigned64 (unsigned long long & value);
+	bool _readBytes (char * bytes, size_t numBytes);
+
+	std::fstream _binaryStream;
+	LogMode _logMode;
+	bool _headerDone;
+	/// Set when a read fails, e.g. for a truncated file.
+	bool _readFailed;
+
+	std::vector<char> _buffer;
+	size_t _bufferUsed;
+};
+
+#endif
@@ -28,6 +28,8 @@ public:
 	Logger * getLogger() const;
 	size_t size();
 	void appendLogData(LogData * logD);
+	/// Forgets the logger and log objects without deleting them, for log data that is still owned by a module.
+	void release();
 
 private:
 	Logger * log;
@@ -9,14 +9,18 @@
 
 #include <iostream>
 #include <map>
+#include <mutex>
 #include "Logger.h"
+#include "LogData.h"
 #include "UtilGlobals.h"
 
 
 enum UTIL_API LoggerType 
 {
 	BASIC_READ,
-	BASIC_WRITE
+	BASIC_WRITE,
+	BINARY_READ, // see BinaryLogger
+	BINARY_WRITE
 	// add other loggers 
 };
 
@@ -25,15 +29,25 @@ class UTIL_API LogManager
 public:
 
 	static LogManager * getInstance (); // returns single static instance of LogManager 
+	/// Creates a logger for the file logName; if another logger of that name is still open (e.g. the same module in another engine), the new one uses a unique name like "sfAI-2.log" instead, see Logger::getFileName().
 	Logger * createLogger ( const std::string &logName, LoggerType loggerType = LoggerType::BASIC_WRITE);
+	/// Closes and deletes a logger returned by createLogger(), so that its name can be used again; does nothing if logger is NULL.
+	void destroyLogger ( Logger * logger );
+	/// Reads all log objects of a log written by a BINARY_WRITE logger; the caller owns the returned LogData (and its logger).
+	LogData * readBinaryLog ( const std::string &logName );
 
 private:
 
 	LogManager () {} // constructor is declared private to prevent instantiation 
+
+	/// Returns logName, or logName with a number inserted before its extension if a logger of that name is open; the caller holds _loggersLock.
+	std::string _getUnusedLogName ( const std::string &logName );
 	
 	static LogManager * _instance;
 
+	/// The open loggers, by file name.
 	std::map<std::string , Logger *> _loggers;
+	std::mutex _loggersLock; // modules of several engines may create loggers at the same time
 
 };
 
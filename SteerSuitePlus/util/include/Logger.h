@@ -38,14 +38,16 @@ public:
 	DataType getFieldDataType(unsigned int index) const; 
 	virtual std::string getFieldName(unsigned int index) const; 
 	virtual size_t getNumberOfFields () const; 
+	/// Returns the name of the file this logger reads or writes.
+	const std::string & getFileName () const { return _fileName; }
 
-	void writeMetaData ();
+	virtual void writeMetaData ();
 	std::string getMetaData ();
-	void readMetaData ();
+	virtual void readMetaData ();
 
 	virtual void writeLogObject ( const LogObject & logObject );
 	void writeLogObjectPretty ( const LogObject & logObject );
-	void readNextLogObject ( LogObject & logObject);
+	virtual void readNextLogObject ( LogObject & logObject);
 	std::string logObjectToString ( const LogObject & logObject );
 
 	std::string calcBufferSpace(std::string one, std::string two);
@@ -58,7 +60,13 @@ public:
 	}
 
 
-	void closeLog ();
+	/// Makes sure everything logged so far is written to the file.
+	virtual void flush ();
+	virtual void closeLog ();
+
+protected:
+	/// Only names the file, without opening the text stream; for loggers that write the file themselves.
+	explicit Logger (const std::string & fileName) : _fileName(fileName) {}
 
 private:
 
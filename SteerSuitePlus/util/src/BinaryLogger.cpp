@@ -0,0 +1,328 @@
+//
+// Copyright (c) 2009-2015 Glen Berseth, Mubbasir Kapadia, Shawn Singh, Petros Faloutsos, Glenn Reinman
+// See license.txt for complete license.
+//
+
+#include "BinaryLogger.h"
+#include <cstring>
+#include <iostream>
+
+static const char BINARY_LOG_MAGIC[6] = { 'S', 'S', 'B', 'L', 'O', 'G' };
+static const unsigned int BINARY_LOG_VERSION = 1;
+
+
+BinaryLogger::BinaryLogger (const std::string & fileName, LogMode logMode, size_t bufferSize) : Logger(fileName)
+{
+	_logMode = logMode;
+	_headerDone = false;
+	_readFailed = false;
+	_bufferUsed = 0;
+
+	if ( logMode == LogMode::Write)
+	{
+		_buffer.resize((bufferSize > 0) ? bufferSize : 1);
+		_binaryStream.open(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	}
+	else if ( logMode == LogMode::Read)
+	{
+		_binaryStream.open(fileName.c_str(), std::ios::in | std::ios::binary);
+	}
+
+	if (!_binaryStream.is_open())
+	{
+		std::cerr << "ERROR: could not open binary log file " << fileName << "\n";
+		_readFailed = true;
+	}
+	else if ( logMode == LogMode::Read)
+	{
+		readMetaData();
+	}
+}
+
+BinaryLogger::~BinaryLogger()
+{
+	closeLog();
+}
+
+void BinaryLogger::addDataField(const std::string &fieldName, DataType dataType)
+{
+	if (_headerDone && (_logMode == LogMode::Write))
+	{
+		std::cerr << "ERROR: field " << fieldName << " was added to a binary log after its header was written, and will not be logged.\n";
+		return;
+	}
+	Logger::addDataField(fieldName, dataType);
+}
+
+size_t BinaryLogger::getRecordSize () const
+{
+	size_t recordSize = 0;
+	for (unsigned int i=0; i < getNumberOfFields(); i++)
+	{
+		switch ( getFieldDataType(i) )
+		{
+		case DataType::Integer:
+		case DataType::Float:
+			recordSize += 4;
+			break;
+		case DataType::LongLong:
+			recordSize += 8;
+			break;
+		default:
+			return 0;
+		}
+	}
+	return recordSize;
+}
+
+void BinaryLogger::writeMetaData ()
+{
+	if (_headerDone || (_logMode != LogMode::Write))
+		return;
+	_headerDone = true;
+
+	_writeBytes(BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC));
+	char version[2] = { (char)(BINARY_LOG_VERSION & 0xff), (char)((BINARY_LOG_VERSION >> 8) & 0xff) };
+	_writeBytes(version, 2);
+
+	_writeUnsigned32((unsigned int)getNumberOfFields());
+	for (unsigned int i=0; i < getNumberOfFields(); i++)
+	{
+		std::string fieldName = getFieldName(i);
+		_writeUnsigned32((unsigned int)getFieldDataType(i));
+		_writeUnsigned32((unsigned int)fieldName.size());
+		_writeBytes(fieldName.c_str(), fieldName.size());
+	}
+	_writeUnsigned32((unsigned int)getRecordSize());
+}
+
+void BinaryLogger::readMetaData ()
+{
+	if (_headerDone || (_logMode != LogMode::Read))
+		return;
+	_headerDone = true;
+
+	char magic[sizeof(BINARY_LOG_MAGIC)];
+	unsigned char version[2];
+	if (!_readBytes(magic, sizeof(magic)) || (memcmp(magic, BINARY_LOG_MAGIC, sizeof(magic)) != 0) || !_readBytes((char*)version, 2))
+	{
+		std::cerr << "ERROR: not a binary log file\n";
+		_readFailed = true;
+		return;
+	}
+	if ((unsigned int)(version[0] | (version[1] << 8)) != BINARY_LOG_VERSION)
+	{
+		std::cerr << "ERROR: unsupported binary log version " << (version[0] | (version[1] << 8)) << "\n";
+		_readFailed = true;
+		return;
+	}
+
+	unsigned int numberOfFields = 0;
+	_readUnsigned32(numberOfFields);
+	for (unsigned int i=0; (i < numberOfFields) && !_readFailed; i++)
+	{
+		unsigned int dataTypeInt = 0;
+		unsigned int nameLength = 0;
+		_readUnsigned32(dataTypeInt);
+		_readUnsigned32(nameLength);
+		std::string fieldName(nameLength, ' ');
+		if (nameLength > 0)
+			_readBytes(&(fieldName[0]), nameLength);
+
+		if (dataTypeInt > (unsigned int)DataType::String)
+		{
+			std::cerr << "ERROR: unknown data type " << dataTypeInt << " in binary log header\n";
+			_readFailed = true;
+			return;
+		}
+		Logger::addDataField(fieldName, (DataType)dataTypeInt);
+	}
+
+	unsigned int recordSize = 0;
+	_readUnsigned32(recordSize);
+	if (!_readFailed && (recordSize != getRecordSize()))
+	{
+		std::cerr << "ERROR: the record size in the binary log header does not match its fields\n";
+		_readFailed = true;
+	}
+}
+
+void BinaryLogger::writeLogObject ( const LogObject & logObject )
+{
+	if ((_logMode != LogMode::Write) || !_binaryStream.is_open())
+		return;
+	if (logObject.getRecordSize() != getNumberOfFields())
+	{
+		std::cerr << "ERROR: log object has " << logObject.getRecordSize() << " items, but the binary log has " << getNumberOfFields() << " fields\n";
+		return;
+	}
+
+	writeMetaData();
+
+	for (unsigned int i=0; i < logObject.getRecordSize(); i++)
+	{
+		const DataItem & item = logObject.getLogData(i);
+		switch ( getFieldDataType(i) )
+		{
+		case DataType::Integer:
+			_writeUnsigned32((unsigned int)item.integerData);
+			break;
+		case DataType::Float:
+		{
+			unsigned int bits;
+			memcpy(&bits, &item.floatData, sizeof(bits));
+			_writeUnsigned32(bits);
+			break;
+		}
+		case DataType::LongLong:
+			_writeUnsigned64((unsigned long long)item.longlongData);
+			break;
+		case DataType::String:
+			_writeUnsigned32((unsigned int)item.string.size());
+			_writeBytes(item.string.c_str(), item.string.size());
+			break;
+		default:
+			std::cerr << "Unspecified data type for log object \n";
+			break;
+		}
+	}
+}
+
+bool BinaryLogger::hasMoreLogObjects ()
+{
+	if ((_logMode != LogMode::Read) || _readFailed)
+		return false;
+	return (_binaryStream.peek() != std::char_traits<char>::eof());
+}
+
+void BinaryLogger::readNextLogObject ( LogObject & logObject)
+{
+	if (!hasMoreLogObjects())
+		return;
+
+	for (unsigned int i=0; i < getNumberOfFields(); i++)
+	{
+		DataItem dataItem;
+		unsigned int value32 = 0;
+		unsigned long long value64 = 0;
+		switch ( getFieldDataType(i) )
+		{
+		case DataType::Integer:
+			_readUnsigned32(value32);
+			dataItem.integerData = (int)value32;
+			break;
+		case DataType::Float:
+			_readUnsigned32(value32);
+			memcpy(&dataItem.floatData, &value32, sizeof(value32));
+			break;
+		case DataType::LongLong:
+			_readUnsigned64(value64);
+			dataItem.longlongData = (long long)value64;
+			break;
+		case DataType::String:
+			_readUnsigned32(value32);
+			dataItem.string.resize(value32);
+			if (value32 > 0)
+				_readBytes(&(dataItem.string[0]), value32);
+			break;
+		default:
+			std::cerr << "Unspecified data type for log object \n";
+			break;
+		}
+
+		if (_readFailed)
+		{
+			std::cerr << "ERROR: binary log ends in the middle of a record\n";
+			return;
+		}
+		logObject.addLogDataItem(dataItem);
+	}
+}
+
+void BinaryLogger::flush ()
+{
+	if ((_bufferUsed > 0) && _binaryStream.is_open())
+	{
+		_binaryStream.write(&(_buffer[0]), _bufferUsed);
+		_binaryStream.flush();
+	}
+	_bufferUsed = 0;
+}
+
+void BinaryLogger::closeLog ()
+{
+	if (_logMode == LogMode::Write)
+	{
+		// a log without any records still gets its header, so that it can be read.
+		if (_binaryStream.is_open())
+			writeMetaData();
+		flush();
+	}
+	_binaryStream.close();
+}
+
+void BinaryLogger::_writeUnsigned32 (unsigned int value)
+{
+	char bytes[4];
+	for (unsigned int i=0; i < 4; i++)
+		bytes[i] = (char)((value >> (8*i)) & 0xff);
+	_writeBytes(bytes, 4);
+}
+
+void BinaryLogger::_writeUnsigned64 (unsigned long long value)
+{
+	char bytes[8];
+	for (unsigned int i=0; i < 8; i++)
+		bytes[i] = (char)((value >> (8*i)) & 0xff);
+	_writeBytes(bytes, 8);
+}
+
+void BinaryLogger::_writeBytes (const char * bytes, size_t numBytes)
+{
+	if (_bufferUsed + numBytes > _buffer.size())
+	{
+		flush();
+		if (numBytes > _buffer.size())
+		{
+			_binaryStream.write(bytes, numBytes);
+			return;
+		}
+	}
+	memcpy(&(_buffer[_bufferUsed]), bytes, numBytes);
+	_bufferUsed += numBytes;
+}
+
+bool BinaryLogger::_readUnsigned32 (unsigned int & value)
+{
+	unsigned char bytes[4];
+	if (!_readBytes((char*)bytes, 4))
+		return false;
+	value = 0;
+	for (unsigned int i=0; i < 4; i++)
+		value |= ((unsigned int)bytes[i]) << (8*i);
+	return true;
+}
+
+bool BinaryLogger::_readUnsigned64 (unsigned long long & value)
+{
+	unsigned char bytes[8];
+	if (!_readBytes((char*)bytes, 8))
+		return false;
+	value = 0;
+	for (unsigned int i=0; i < 8; i++)
+		value |= ((unsigned long long)bytes[i]) << (8*i);
+	return true;
+}
+
+bool BinaryLogger::_readBytes (char * bytes, size_t numBytes)
+{
+	if (_readFailed)
+		return false;
+	_binaryStream.read(bytes, numBytes);
+	if ((size_t)_binaryStream.gcount() != numBytes)
+	{
+		_readFailed = true;
+		return false;
+	}
+	return true;
+}
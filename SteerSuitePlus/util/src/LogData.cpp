@@ -16,8 +16,7 @@
 
 LogData::LogData()
 {
-	// TODO Auto-generated constructor stub
-
+	log = NULL;
 }
 
 LogData::~LogData()
@@ -30,6 +29,12 @@ LogData::~LogData()
 	logData.clear();
 }
 
+void LogData::release()
+{
+	this->log = NULL;
+	this->logData.clear();
+}
+
 void LogData::setLogger(Logger * log)
 {
 	this->log = log;
@@ -5,6 +5,8 @@
 
 #include "LogManager.h"
 #include "Logger.h"
+#include "BinaryLogger.h"
+#include <sstream>
 
 LogManager* LogManager::_instance = new LogManager();
 
@@ -15,19 +17,99 @@ LogManager * LogManager::getInstance ()
 
 Logger * LogManager::createLogger ( const std::string &logName, LoggerType loggerType)
 {
+	std::lock_guard<std::mutex> lock(_loggersLock);
+
+	// an open logger of the same name belongs to someone else; opening its file again would truncate it.
+	std::string fileName = _getUnusedLogName(logName);
+	Logger * logger = NULL;
+
 	switch (loggerType)
 	{
 	case LoggerType::BASIC_READ:
-		_loggers[logName] = new Logger(logName, LogMode::Read);
+		logger = new Logger(fileName, LogMode::Read);
 		break;
 	case LoggerType::BASIC_WRITE:
-		_loggers[logName] = new Logger(logName, LogMode::Write);
+		logger = new Logger(fileName, LogMode::Write);
+		break;
+	case LoggerType::BINARY_READ:
+		logger = new BinaryLogger(fileName, LogMode::Read);
+		break;
+	case LoggerType::BINARY_WRITE:
+		logger = new BinaryLogger(fileName, LogMode::Write);
 		break;
 	default:
 		std::cerr << "Specified log type not supported \n\n";
-		break;
+		return NULL;
+	}
+
+	_loggers[fileName] = logger;
+	return logger;
+
+}
+
+void LogManager::destroyLogger ( Logger * logger )
+{
+	if (logger == NULL)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_loggersLock);
+		std::map<std::string, Logger *>::iterator entry = _loggers.find(logger->getFileName());
+		if ((entry != _loggers.end()) && (entry->second == logger))
+		{
+			_loggers.erase(entry);
+		}
+	}
+
+	delete logger;
+}
+
+std::string LogManager::_getUnusedLogName ( const std::string &logName )
+{
+	if (_loggers.find(logName) == _loggers.end())
+	{
+		return logName;
+	}
+
+	// "sfAI.log" becomes "sfAI-2.log", "sfAI-3.log", ...
+	size_t extension = logName.find_last_of('.');
+	if ((extension == std::string::npos) || (logName.find_first_of("/\\", extension) != std::string::npos))
+	{
+		extension = logName.size();
 	}
 
-	return _loggers[logName];
+	for (unsigned int i = 2; ; i++)
+	{
+		std::ostringstream uniqueName;
+		uniqueName << logName.substr(0, extension) << "-" << i << logName.substr(extension);
+		if (_loggers.find(uniqueName.str()) == _loggers.end())
+		{
+			return uniqueName.str();
+		}
+	}
+}
+
+LogData * LogManager::readBinaryLog ( const std::string &logName )
+{
+	// the reader is not registered in _loggers, it belongs to the returned LogData.
+	BinaryLogger * reader = new BinaryLogger(logName, LogMode::Read);
+	LogData * logData = new LogData();
+	logData->setLogger(reader);
+
+	while (reader->hasMoreLogObjects())
+	{
+		LogObject * logObject = new LogObject();
+		reader->readNextLogObject(*logObject);
+		if (logObject->getRecordSize() != reader->getNumberOfFields())
+		{
+			// the log ended in the middle of a record
+			delete logObject;
+			break;
+		}
+		logData->addLogData(logObject);
+	}
 
+	return logData;
 }
@@ -213,6 +213,11 @@ void Logger::readNextLogObject ( LogObject & logObject)
 
 }
 
+void Logger::flush()
+{
+	_fileStream.flush();
+}
+
 void 
 Logger::closeLog()
 {